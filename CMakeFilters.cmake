@@ -132,3 +132,23 @@ if (HDF5_ENABLE_SZIP_SUPPORT)
     set (EXTERNAL_FILTERS "${EXTERNAL_FILTERS} ENCODE")
   endif ()
 endif ()
+
+#-----------------------------------------------------------------------------
+# Option for Zstandard support
+#-----------------------------------------------------------------------------
+option (HDF5_ENABLE_ZSTD_SUPPORT "Enable Zstandard Filter" OFF)
+if (HDF5_ENABLE_ZSTD_SUPPORT)
+  find_path (ZSTD_INCLUDE_DIR zstd.h)
+  find_library (ZSTD_LIBRARY NAMES zstd)
+  if (ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+    set (H5_HAVE_FILTER_ZSTD 1)
+    set (H5_HAVE_ZSTD_H 1)
+    set (EXTERNAL_FILTERS "${EXTERNAL_FILTERS} ZSTD")
+  else ()
+    message (FATAL_ERROR "Zstandard is Required for Zstandard support in HDF5")
+  endif ()
+  set (LINK_COMP_LIBS ${LINK_COMP_LIBS} ${ZSTD_LIBRARY})
+  set (LINK_COMP_SHARED_LIBS ${LINK_COMP_SHARED_LIBS} ${ZSTD_LIBRARY})
+  INCLUDE_DIRECTORIES (${ZSTD_INCLUDE_DIR})
+  message (STATUS "Filter ZSTD is ON")
+endif ()
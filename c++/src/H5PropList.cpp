@@ -154,6 +154,7 @@ PropList::PropList(const hid_t plist_id) : IdComponent()
         case H5I_ERROR_CLASS:
         case H5I_ERROR_MSG:
         case H5I_ERROR_STACK:
+        case H5I_EVENTSET:
         case H5I_NTYPES:
         case H5I_UNINIT:
         default:
@@ -31,6 +31,7 @@
 #include "H5Pprivate.h"         /* Property lists                           */
 #include "H5SLprivate.h"        /* Skip lists                               */
 #include "H5Tprivate.h"         /* Datatypes                                */
+#include "H5Zprivate.h"         /* Data filters                             */
 
 /****************/
 /* Local Macros */
@@ -294,6 +295,12 @@ H5_term_library(void)
         /* Try to organize these so the "higher" level components get shut
          * down before "lower" level components that they might rely on. -QAK
          */
+
+        /* Complete outstanding asynchronous operations first, so nothing
+         * is left running while the other interfaces shut down.
+         */
+        pending += DOWN(ES);
+
         pending += DOWN(L);
 
         /* Close the "top" of various interfaces (IDs, etc) but don't shut
@@ -491,6 +498,8 @@ H5garbage_collect(void)
     /* Call the garbage collection routines in the library */
     if(H5FL_garbage_coll()<0)
         HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "can't garbage collect objects")
+    if(H5Z_buf_garbage_coll() < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "can't garbage collect filter buffers")
 
 done:
     FUNC_LEAVE_API(ret_value)
@@ -543,6 +552,44 @@ done:
     FUNC_LEAVE_API(ret_value)
 }   /* end H5set_free_list_limits() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5get_free_list_sizes
+ *
+ * Purpose:	Gets the current size of the different kinds of free lists that
+ *	the library uses to manage memory.  The free list sizes can be set with
+ *	H5set_free_list_limits and garbage collected with H5garbage_collect.
+ *	These lists are global for the entire library, and the sizes include
+ *	the memory held in threads' caches of free blocks.
+ *
+ * Parameters:
+ *  size_t *reg_size;    OUT: The current size of all "regular" free list memory used
+ *  size_t *arr_size;    OUT: The current size of all "array" free list memory used
+ *  size_t *blk_size;    OUT: The current size of all "block" free list memory used
+ *  size_t *fac_size;    OUT: The current size of all "factory" free list memory used
+ *
+ * Return:	Success:	non-negative
+ *		Failure:	negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5get_free_list_sizes(size_t *reg_size, size_t *arr_size, size_t *blk_size,
+    size_t *fac_size)
+{
+    herr_t                  ret_value = SUCCEED;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE4("e", "*z*z*z*z", reg_size, arr_size, blk_size, fac_size);
+
+    /* Call the free list function to actually get the sizes */
+    if(H5FL_get_free_list_sizes(reg_size, arr_size, blk_size, fac_size) < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGET, FAIL, "can't get garbage collection sizes")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+}   /* end H5get_free_list_sizes() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5_debug_mask
@@ -42,6 +42,7 @@
 #include "H5Fpkg.h"		/* Files				*/
 #include "H5FDprivate.h"	/* File drivers				*/
 #include "H5MMprivate.h"	/* Memory management			*/
+#include "H5PBprivate.h"        /* Page buffer                          */
 
 
 #ifdef H5_HAVE_PARALLEL
@@ -951,6 +952,8 @@ H5C__collective_write(H5F_t *f)
         H5SL_node_t         *node;
         H5C_cache_entry_t   *entry_ptr;
         void                *base_buf;
+        H5PB_t              *page_buf;
+        herr_t              status;
         int                 i;
 
         /* Set new transfer mode */
@@ -1016,10 +1019,29 @@ H5C__collective_write(H5F_t *f)
         if(H5CX_set_mpi_coll_datatypes(btype, ftype) < 0)
             HGOTO_ERROR(H5E_CACHE, H5E_CANTSET, FAIL, "can't set MPI-I/O properties")
 
-        /* Write data */
-        if(H5F_block_write(f, H5FD_MEM_DEFAULT, (haddr_t)0, (size_t)1, base_buf) < 0)
+        /* Write data.  The page buffer is detached around the write, since
+         * the address & size passed down only make sense together with the
+         * MPI datatypes and would otherwise be applied to page 0.
+         */
+        page_buf = f->shared->page_buf;
+        f->shared->page_buf = NULL;
+        status = H5F_block_write(f, H5FD_MEM_DEFAULT, (haddr_t)0, (size_t)1, base_buf);
+        f->shared->page_buf = page_buf;
+        if(status < 0)
             HGOTO_ERROR(H5E_CACHE, H5E_CANTFLUSH, FAIL, "unable to write entries collectively")
 
+        /* Bring any pages holding the entries up to date */
+        if(page_buf) {
+            node = H5SL_first(cache_ptr->coll_write_list);
+            while(node) {
+                entry_ptr = (H5C_cache_entry_t *)H5SL_item(node);
+                if(entry_ptr->size <= page_buf->page_size)
+                    if(H5PB_update_entry(page_buf, entry_ptr->addr, entry_ptr->size, entry_ptr->image_ptr) < 0)
+                        HGOTO_ERROR(H5E_CACHE, H5E_CANTUPDATE, FAIL, "failed to update PB with metadata cache")
+                node = H5SL_next(node);
+            } /* end while */
+        } /* end if */
+
     } /* end if */
     else {
         MPI_Status mpi_stat;
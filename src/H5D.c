@@ -1130,3 +1130,45 @@ done:
     FUNC_LEAVE_API(ret_value);
 } /* H5Dget_chunk_storage_size() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Dget_chunk_cache_stats
+ *
+ * Purpose:     Retrieves the number of hits and misses in a chunked
+ *              dataset's raw data chunk cache since the dataset was
+ *              opened, for comparing the cache's settings and replacement
+ *              policies.
+ *
+ *              A chunk which isn't cached but is about to be completely
+ *              overwritten counts as a hit, since it doesn't need to be
+ *              read.  A chunk which doesn't exist in the file counts as
+ *              neither.  Either argument may be NULL.
+ *
+ * Return:	Non-negative on success, negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dget_chunk_cache_stats(hid_t dset_id, unsigned *nhits, unsigned *nmisses)
+{
+    H5D_t       *dset = NULL;
+    herr_t      ret_value = SUCCEED;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "i*Iu*Iu", dset_id, nhits, nmisses);
+
+    /* Check arguments */
+    if(NULL == (dset = (H5D_t *)H5I_object_verify(dset_id, H5I_DATASET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataset")
+    if(H5D_CHUNKED != dset->shared->layout.type)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a chunked dataset")
+
+    if(nhits)
+        *nhits = dset->shared->cache.chunk.stats.nhits;
+    if(nmisses)
+        *nmisses = dset->shared->cache.chunk.stats.nmisses;
+
+done:
+    FUNC_LEAVE_API(ret_value);
+} /* H5Dget_chunk_cache_stats() */
+
@@ -60,6 +60,7 @@
 #include "H5Iprivate.h"		/* IDs			  		*/
 #include "H5MMprivate.h"	/* Memory management			*/
 #include "H5MFprivate.h"        /* File memory management               */
+#include "H5TPprivate.h"        /* Thread pools                         */
 #include "H5VMprivate.h"	/* Vector and array functions		*/
 
 
@@ -112,6 +113,31 @@
 #define H5D_RDCC_NEWLY_DISABLED_FILTERS 0x02u   /* Filters have been disabled since
                                                  * the last flush */
 
+/* # of chunks to decode at a time, per filter thread, when reading */
+#define H5D_CHUNK_DECODE_BATCH_PER_THREAD 2
+
+/* # of dirty chunks to encode at a time, per filter thread, when flushing */
+#define H5D_CHUNK_ENCODE_BATCH_PER_THREAD 2
+
+/* Max. size of a single read of several chunks which bypass the cache */
+#define H5D_CHUNK_READ_COALESCE_MAX (4 * 1024 * 1024)
+
+/* Initial # of slots in the index of a cache using the 2Q policy (must be a
+ * power of two, the index grows from there as needed) */
+#define H5D_CHUNK_CACHE_2Q_NSLOTS_INIT 64
+
+/* Fraction of the cache which the 2Q policy's FIFO queue may use before its
+ * chunks are preempted ahead of the LRU queue's, as a divisor */
+#define H5D_CHUNK_CACHE_2Q_FIFO_DIV 4
+
+/* Max. # of ghost entries for the 2Q policy, as a divisor of the # of
+ * chunks which fit in the cache */
+#define H5D_CHUNK_CACHE_2Q_GHOST_DIV 2
+
+/* Marks a slot of the 2Q policy's index whose entry was removed, so that
+ * looking for a chunk probes past it */
+#define H5D_RDCC_TOMBSTONE (&H5D_rdcc_tombstone_g)
+
 
 /******************/
 /* Local Typedefs */
@@ -134,6 +160,12 @@ typedef struct H5D_rdcc_ent_t {
     struct H5D_rdcc_ent_t *prev;/*previous item in doubly-linked list	*/
     struct H5D_rdcc_ent_t *tmp_next;/*next item in temporary doubly-linked list */
     struct H5D_rdcc_ent_t *tmp_prev;/*previous item in temporary doubly-linked list */
+    hbool_t     evicting;       /*selected for preemption by H5D__chunk_cache_prune */
+    hbool_t     hot;            /*in the 2Q policy's LRU queue		*/
+    hbool_t     ghost;          /*only remembers a chunk recently preempted from the 2Q policy's FIFO queue */
+    uint8_t     *enc_chunk;     /*chunk already run through the filters, or NULL */
+    size_t      enc_nbytes;     /*size of encoded chunk			*/
+    unsigned    enc_filter_mask;/*excluded filters for encoded chunk	*/
 } H5D_rdcc_ent_t;
 typedef H5D_rdcc_ent_t *H5D_rdcc_ent_ptr_t; /* For free lists */
 
@@ -203,6 +235,43 @@ typedef struct H5D_chunk_it_ud4_t {
     uint32_t            *chunk_dim;             /* Chunk dimensions */
 } H5D_chunk_it_ud4_t;
 
+/* Info for a chunk whose filters are reversed on a worker thread */
+typedef struct H5D_chunk_decode_t {
+    const H5D_chunk_info_t *chunk_info; /* Chunk being decoded (NULL when reading ahead) */
+    hsize_t             scaled[H5O_LAYOUT_NDIMS]; /* Scaled coordinates of chunk, when reading ahead */
+    H5D_chunk_ud_t      udata;          /* Chunk's index info */
+    const H5O_pline_t   *pline;         /* I/O pipeline to reverse */
+    H5Z_EDC_t           err_detect;     /* Error detection info */
+    H5Z_cb_t            filter_cb;      /* I/O filter callback function */
+    unsigned            filter_mask;    /* Excluded filters */
+    size_t              nbytes;         /* # of bytes of data in buffer */
+    size_t              buf_alloc;      /* Size of buffer */
+    void                *buf;           /* Chunk buffer (NULL if decoding failed) */
+    size_t              lent_size;      /* Size of buffer to lend the filters (0 for none) */
+    hbool_t             filtered;       /* Whether the chunk's filters must be reversed */
+    H5TP_task_t         task;           /* Worker thread task */
+} H5D_chunk_decode_t;
+
+/* Info for a chunk which bypasses the cache, to read with others */
+typedef struct H5D_chunk_coalesce_t {
+    const H5D_chunk_info_t *chunk_info; /* Chunk selected */
+    haddr_t             addr;           /* Address of chunk in file */
+    hbool_t             done;           /* Whether the chunk was read with others */
+} H5D_chunk_coalesce_t;
+
+/* Info for a dirty chunk whose filters are applied on a worker thread */
+typedef struct H5D_chunk_encode_t {
+    H5D_rdcc_ent_t      *ent;           /* Cache entry being encoded */
+    const H5O_pline_t   *pline;         /* I/O pipeline to apply */
+    H5Z_EDC_t           err_detect;     /* Error detection info */
+    H5Z_cb_t            filter_cb;      /* I/O filter callback function */
+    unsigned            filter_mask;    /* Excluded filters */
+    size_t              nbytes;         /* # of bytes of data in buffer */
+    size_t              buf_alloc;      /* Size of buffer */
+    void                *buf;           /* Encoded chunk (NULL if encoding failed) */
+    H5TP_task_t         task;           /* Worker thread task */
+} H5D_chunk_encode_t;
+
 /* Callback info for iteration to format convert chunks */
 typedef struct H5D_chunk_it_ud5_t {
     H5D_chk_idx_info_t  *new_idx_info;          /* Dest. chunk index info object */
@@ -284,17 +353,46 @@ static herr_t H5D__chunk_file_cb(void *elem, const H5T_t *type, unsigned ndims,
 static herr_t H5D__chunk_mem_cb(void *elem, const H5T_t *type, unsigned ndims,
     const hsize_t *coords, void *fm);
 static unsigned H5D__chunk_hash_val(const H5D_shared_t *shared, const hsize_t *scaled);
+static unsigned H5D__chunk_cache_find(const H5D_shared_t *shared, const hsize_t *scaled);
+static herr_t H5D__chunk_cache_rehash(const H5D_t *dset, size_t nslots);
+static herr_t H5D__chunk_cache_new_slot(const H5D_t *dset, const hsize_t *scaled,
+    unsigned *idx);
+static void H5D__chunk_cache_ghost_remove(H5D_rdcc_t *rdcc, H5D_rdcc_ent_t *ghost);
+static H5D_rdcc_ent_t *H5D__chunk_cache_select_2q(const H5D_rdcc_t *rdcc,
+    size_t nbytes_cold);
 static herr_t H5D__chunk_flush_entry(const H5D_t *dset, H5D_rdcc_ent_t *ent,
     hbool_t reset);
 static herr_t H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
     hbool_t flush);
 static hbool_t H5D__chunk_is_partial_edge_chunk(unsigned dset_ndims,
     const uint32_t *chunk_dims, const hsize_t *chunk_scaled, const hsize_t *dset_dims);
+static herr_t H5D__chunk_filters_unlocked(const H5D_t *dset, hbool_t *unlocked);
+static herr_t H5D__chunk_get_filter_pool(const H5D_t *dset, H5TP_t **tp);
+static herr_t H5D__chunk_read_ahead(const H5D_io_info_t *io_info,
+    const H5D_chunk_map_t *fm);
+static int H5D__chunk_coalesce_cmp(const void *_chunk1, const void *_chunk2);
+static herr_t H5D__chunk_read_coalesced(H5D_io_info_t *io_info,
+    const H5D_type_info_t *type_info, const H5D_chunk_map_t *fm,
+    hbool_t unlocked, H5D_chunk_coalesce_t **coalesced, size_t *ncoalesced);
+static herr_t H5D__chunk_decode_cb(void *_dec);
+static herr_t H5D__chunk_decode_batch(const H5D_io_info_t *io_info,
+    const H5D_chunk_map_t *fm, H5SL_node_t **chunk_node, H5TP_t *tp,
+    hbool_t unlocked, H5D_chunk_decode_t *batch, size_t max_nbatch, size_t *nbatch);
+static herr_t H5D__chunk_encode_cb(void *_enc);
+static herr_t H5D__chunk_encode_batch(const H5D_t *dset, H5TP_t *tp,
+    H5D_rdcc_ent_t **ents, size_t nents);
+static H5D_rdcc_ent_t *H5D__chunk_cache_next_live(H5D_rdcc_ent_t *ent);
+static herr_t H5D__chunk_cache_evict_group(const H5D_t *dset, H5TP_t *tp,
+    H5D_rdcc_ent_t **ents, size_t nents);
 static void *H5D__chunk_lock(const H5D_io_info_t *io_info,
     H5D_chunk_ud_t *udata, hbool_t relax, hbool_t prev_unfilt_chunk);
 static herr_t H5D__chunk_unlock(const H5D_io_info_t *io_info,
     const H5D_chunk_ud_t *udata, hbool_t dirty, void *chunk, uint32_t naccessed);
-static herr_t H5D__chunk_cache_prune(const H5D_t *dset, size_t size);
+static herr_t H5D__chunk_cache_prune(const H5D_t *dset, size_t size,
+    size_t total);
+static herr_t H5D__chunk_cache_prune_shared(const H5D_t *dset, size_t size);
+static herr_t H5D__chunk_cache_share(H5F_t *f, const H5D_t *dset);
+static void H5D__chunk_cache_unshare(const H5D_t *dset);
 static herr_t H5D__chunk_prune_fill(H5D_chunk_it_ud1_t *udata, hbool_t new_unfilt_chunk);
 #ifdef H5_HAVE_PARALLEL
 static herr_t H5D__chunk_collective_fill(const H5D_t *dset, 
@@ -351,12 +449,18 @@ const H5D_layout_ops_t H5D_LOPS_NONEXISTENT[1] = {{
     NULL
 }};
 
+/* Tombstone for the slots of the 2Q policy's index */
+static H5D_rdcc_ent_t H5D_rdcc_tombstone_g;
+
 /* Declare a free list to manage the H5F_rdcc_ent_ptr_t sequence information */
 H5FL_SEQ_DEFINE_STATIC(H5D_rdcc_ent_ptr_t);
 
 /* Declare a free list to manage H5D_rdcc_ent_t objects */
 H5FL_DEFINE_STATIC(H5D_rdcc_ent_t);
 
+/* Declare a free list to manage H5D_rdcc_shared_t objects */
+H5FL_DEFINE_STATIC(H5D_rdcc_shared_t);
+
 /* Declare a free list to manage the H5D_chunk_info_t struct */
 H5FL_DEFINE(H5D_chunk_info_t);
 
@@ -927,10 +1031,27 @@ H5D__chunk_init(H5F_t *f, const H5D_t *dset, hid_t dapl_id)
     if(rdcc->w0 < 0)
         rdcc->w0 = H5F_RDCC_W0(f);
 
+    if(H5P_get(dapl, H5D_ACS_DATA_CACHE_POLICY_NAME, &rdcc->policy) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET,FAIL, "can't get data cache policy")
+
+    if(H5P_get(dapl, H5D_ACS_DATA_CACHE_READ_AHEAD_NAME, &rdcc->read_ahead) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET,FAIL, "can't get data cache read-ahead window")
+
+    if(H5P_get(dapl, H5D_ACS_CHUNK_READ_GAP_NAME, &rdcc->read_gap) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET,FAIL, "can't get chunk read gap")
+
+    /* A dataset can't cache more than the budget shared by all the datasets */
+    if(H5F_RDCC_SHARED_NBYTES(f) > 0 && rdcc->nbytes_max > H5F_RDCC_SHARED_NBYTES(f))
+        rdcc->nbytes_max = H5F_RDCC_SHARED_NBYTES(f);
+
     /* If nbytes_max or nslots is 0, set them both to 0 and avoid allocating space */
     if(!rdcc->nbytes_max || !rdcc->nslots)
-        rdcc->nbytes_max = rdcc->nslots = 0;
+        rdcc->nbytes_max = rdcc->nslots = rdcc->read_ahead = 0;
     else {
+        /* The 2Q policy's index starts small and grows as needed */
+        if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy)
+            rdcc->nslots = H5D_CHUNK_CACHE_2Q_NSLOTS_INIT;
+
         rdcc->slot = H5FL_SEQ_CALLOC(H5D_rdcc_ent_ptr_t, rdcc->nslots);
         if(NULL == rdcc->slot)
             HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed")
@@ -976,10 +1097,110 @@ H5D__chunk_init(H5F_t *f, const H5D_t *dset, hid_t dapl_id)
     if(H5D__chunk_set_info(dset) < 0)
         HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "unable to set # of chunks for dataset")
 
+    /* Use the file's shared chunk cache budget, if there is one */
+    if(rdcc->nslots > 0 && H5F_RDCC_SHARED_NBYTES(f) > 0)
+        if(H5D__chunk_cache_share(f, dset) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't use shared chunk cache budget")
+
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_init() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_share
+ *
+ * Purpose:	Add the dataset's chunk cache to the list of caches using
+ *		the file's shared budget, setting the budget up if this is
+ *		the first one.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_share(H5F_t *f, const H5D_t *dset)
+{
+    H5D_rdcc_t	*rdcc = &(dset->shared->cache.chunk);   /* Dataset's chunk cache */
+    H5D_rdcc_shared_t *shared;          /* File's shared budget */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(f);
+    HDassert(dset);
+    HDassert(NULL == rdcc->shared);
+
+    if(NULL == (shared = H5F_RDCC_SHARED(f))) {
+        if(NULL == (shared = H5FL_CALLOC(H5D_rdcc_shared_t)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for shared chunk cache budget")
+        shared->nbytes_max = H5F_RDCC_SHARED_NBYTES(f);
+        if(H5F_SET_RDCC_SHARED(f, shared) < 0) {
+            shared = H5FL_FREE(H5D_rdcc_shared_t, shared);
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set shared chunk cache budget")
+        } /* end if */
+    } /* end if */
+
+    /* Link into the list of caches */
+    rdcc->shared = shared;
+    rdcc->dset = dset;
+    rdcc->shared_prev = NULL;
+    rdcc->shared_next = shared->head;
+    if(shared->head)
+        shared->head->shared_prev = rdcc;
+    shared->head = rdcc;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_share() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_unshare
+ *
+ * Purpose:	Remove the dataset's (empty) chunk cache from the list of
+ *		caches using the file's shared budget, releasing the budget
+ *		if this was the last one.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5D__chunk_cache_unshare(const H5D_t *dset)
+{
+    H5D_rdcc_t	*rdcc = &(dset->shared->cache.chunk);   /* Dataset's chunk cache */
+    H5D_rdcc_shared_t *shared = rdcc->shared;   /* File's shared budget */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Sanity check */
+    HDassert(shared);
+    HDassert(0 == rdcc->nbytes_used);
+
+    /* Unlink from the list of caches */
+    if(rdcc->shared_prev)
+        rdcc->shared_prev->shared_next = rdcc->shared_next;
+    else
+        shared->head = rdcc->shared_next;
+    if(rdcc->shared_next)
+        rdcc->shared_next->shared_prev = rdcc->shared_prev;
+    rdcc->shared_next = rdcc->shared_prev = NULL;
+    rdcc->shared = NULL;
+    rdcc->dset = NULL;
+
+    /* Release the budget once no datasets are using it */
+    if(NULL == shared->head) {
+        HDassert(0 == shared->nbytes_used);
+        HDassert(shared == H5F_RDCC_SHARED(dset->oloc.file));
+        (void)H5F_SET_RDCC_SHARED(dset->oloc.file, NULL);
+        shared = H5FL_FREE(H5D_rdcc_shared_t, shared);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5D__chunk_cache_unshare() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5D__chunk_is_space_alloc
@@ -1315,7 +1536,9 @@ done:
  *
  * Purpose:	Allocate space for a chunk in memory.  This routine allocates
  *              memory space for non-filtered chunks from a block free list
- *              and uses malloc()/free() for filtered chunks.
+ *              and takes filtered chunks from the filter buffer pool, so
+ *              the filters can hand them back and forth without calling
+ *              malloc()/free() for each chunk.
  *
  * Return:	Pointer to memory for chunk on success/NULL on failure
  *
@@ -1334,7 +1557,7 @@ H5D__chunk_mem_alloc(size_t size, const H5O_pline_t *pline)
     HDassert(size);
 
     if(pline && pline->nused)
-        ret_value = H5MM_malloc(size);
+        ret_value = H5Z_buf_malloc(size);
     else
         ret_value = H5FL_BLK_MALLOC(chunk, size);
 
@@ -1345,9 +1568,9 @@ H5D__chunk_mem_alloc(size_t size, const H5O_pline_t *pline)
 /*-------------------------------------------------------------------------
  * Function:	H5D__chunk_mem_xfree
  *
- * Purpose:	Free space for a chunk in memory.  This routine allocates
- *              memory space for non-filtered chunks from a block free list
- *              and uses malloc()/free() for filtered chunks.
+ * Purpose:	Free space for a chunk in memory.  This routine frees
+ *              memory space for non-filtered chunks to a block free list
+ *              and returns filtered chunks to the filter buffer pool.
  *
  * Return:	NULL (never fails)
  *
@@ -1363,7 +1586,7 @@ H5D__chunk_mem_xfree(void *chk, const H5O_pline_t *pline)
 
     if(chk) {
         if(pline && pline->nused)
-            H5MM_xfree(chk);
+            H5Z_buf_free(chk);
         else
             chk = H5FL_BLK_FREE(chunk, chk);
     } /* end if */
@@ -1377,7 +1600,7 @@ H5D__chunk_mem_xfree(void *chk, const H5O_pline_t *pline)
  *
  * Purpose:     Reallocate space for a chunk in memory.  This routine allocates
  *              memory space for non-filtered chunks from a block free list
- *              and uses malloc()/free() for filtered chunks.
+ *              and from the filter buffer pool for filtered chunks.
  *
  * Return:      Pointer to memory for chunk on success/NULL on failure
  *
@@ -1397,7 +1620,7 @@ H5D__chunk_mem_realloc(void *chk, size_t size, const H5O_pline_t *pline)
     HDassert(pline);
 
     if(pline->nused > 0)
-        ret_value = H5MM_realloc(chk, size);
+        ret_value = H5Z_buf_realloc(chk, size);
     else
         ret_value = H5FL_BLK_REALLOC(chunk, chk, size);
 
@@ -2139,6 +2362,16 @@ H5D__chunk_read(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
     hbool_t     cpt_dirty;              /* Temporary placeholder for compact storage "dirty" flag */
     uint32_t    src_accessed_bytes = 0; /* Total accessed size in a chunk */
     hbool_t     skip_missing_chunks = FALSE;    /* Whether to skip missing chunks */
+    H5TP_t      *filter_pool = NULL;    /* Worker threads for decoding chunks */
+    hbool_t     unlocked = FALSE;       /* Whether chunks are read without the library lock */
+    H5D_chunk_decode_t *batch = NULL;   /* Chunks decoded on worker threads */
+    size_t      max_nbatch = 0;         /* Max. # of chunks to decode at a time */
+    size_t      nbatch = 0;             /* # of chunks in batch */
+    size_t      batch_idx = 0;          /* Next chunk in batch to use */
+    H5SL_node_t *batch_end = NULL;      /* Node after the last chunk considered for the batch */
+    H5D_chunk_coalesce_t *coalesced = NULL; /* Chunks already read together with others */
+    size_t      ncoalesced = 0;         /* # of chunks read together with others */
+    size_t      coalesced_idx = 0;      /* Next chunk read together with others */
     herr_t	ret_value = SUCCEED;	/*return value		*/
 
     FUNC_ENTER_STATIC
@@ -2187,8 +2420,36 @@ H5D__chunk_read(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
             skip_missing_chunks = TRUE;
     }
 
+    /* Check whether chunks should be read and decoded without the library
+     * lock, which needs filters that can run on any thread */
+#ifdef H5F_HAVE_CONCURRENT_READS
+    if(H5F_concurrent_reads(io_info->dset->oloc.file)) {
+        if(H5D__chunk_filters_unlocked(io_info->dset, &unlocked) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't check dataset's filters")
+    } /* end if */
+#endif /* H5F_HAVE_CONCURRENT_READS */
+
+    /* Check whether filtered chunks should be decoded on worker threads */
+    if(!fm->use_single || unlocked) {
+        if(!fm->use_single && H5D__chunk_get_filter_pool(io_info->dset, &filter_pool) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get filter thread pool")
+        if(filter_pool || unlocked) {
+            /* Allocate space for the batch of chunks to decode */
+            max_nbatch = (filter_pool ? H5TP_get_nthreads(filter_pool) : 1) * H5D_CHUNK_DECODE_BATCH_PER_THREAD;
+            if(NULL == (batch = (H5D_chunk_decode_t *)H5MM_calloc(max_nbatch * sizeof(H5D_chunk_decode_t))))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk decode batch")
+        } /* end if */
+    } /* end if */
+
+    /* Read the chunks which bypass the cache and are close together in
+     * the file with single reads, if there are no filters */
+    if(!fm->use_single && 0 == io_info->dset->shared->dcpl_cache.pline.nused)
+        if(H5D__chunk_read_coalesced(io_info, type_info, fm, unlocked, &coalesced, &ncoalesced) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "unable to read chunks together")
+
     /* Iterate through nodes in chunk skip list */
     chunk_node = H5D_CHUNK_GET_FIRST_NODE(fm);
+    batch_end = chunk_node;
     while(chunk_node) {
         H5D_chunk_info_t *chunk_info;   /* Chunk information */
         H5D_chunk_ud_t udata;		/* Chunk index pass-through	*/
@@ -2196,9 +2457,38 @@ H5D__chunk_read(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
         /* Get the actual chunk information from the skip list node */
         chunk_info = H5D_CHUNK_GET_NODE_INFO(fm, chunk_node);
 
+        /* Decode the next group of chunks (on the worker threads, or
+         * without the library lock) */
+        if(batch && chunk_node == batch_end) {
+            HDassert(batch_idx == nbatch);
+            if(H5D__chunk_decode_batch(io_info, fm, &batch_end, filter_pool, unlocked, batch, max_nbatch, &nbatch) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't decode chunks")
+            batch_idx = 0;
+        } /* end if */
+
+        /* Skip chunks which were already read together with others */
+        if(coalesced_idx < ncoalesced && coalesced[coalesced_idx].chunk_info == chunk_info) {
+            coalesced_idx++;
+            chunk_node = H5D_CHUNK_GET_NEXT_NODE(fm, chunk_node);
+            continue;
+        } /* end if */
+
         /* Get the info for the chunk in the file */
-        if(H5D__chunk_lookup(io_info->dset, chunk_info->scaled, &udata) < 0)
-            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+        if(batch_idx < nbatch && batch[batch_idx].chunk_info == chunk_info) {
+            /* Use the info from when the chunk was decoded (the chunk isn't
+             * cached, so the info is still current) and hand over the chunk
+             * buffer, if decoding succeeded.
+             */
+            udata = batch[batch_idx].udata;
+            if(batch[batch_idx].buf)
+                udata.filter_mask = batch[batch_idx].filter_mask;
+            udata.decoded_chunk = batch[batch_idx].buf;
+            batch[batch_idx].buf = NULL;
+            batch_idx++;
+        } /* end if */
+        else
+            if(H5D__chunk_lookup(io_info->dset, chunk_info->scaled, &udata) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
 
         /* Sanity check */
         HDassert((H5F_addr_defined(udata.chunk_block.offset) && udata.chunk_block.length > 0) || 
@@ -2235,6 +2525,10 @@ H5D__chunk_read(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
                 chk_io_info = &cpt_io_info;
             } /* end if */
             else if(H5F_addr_defined(udata.chunk_block.offset)) {
+                /* Drop a chunk read ahead of time, if it wasn't needed */
+                if(udata.decoded_chunk)
+                    udata.decoded_chunk = H5D__chunk_mem_xfree(udata.decoded_chunk, &(io_info->dset->shared->dcpl_cache.pline));
+
                 /* Set up the storage address information for this chunk */
                 ctg_store.contig.dset_addr = udata.chunk_block.offset;
 
@@ -2260,156 +2554,1098 @@ H5D__chunk_read(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
         chunk_node = H5D_CHUNK_GET_NEXT_NODE(fm, chunk_node);
     } /* end while */
 
+    /* Load the chunks the next reads are likely to select */
+    if(io_info->dset->shared->cache.chunk.read_ahead > 0)
+        if(H5D__chunk_read_ahead(io_info, fm) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "unable to read chunks ahead")
+
 done:
+    /* Release any decoded chunks which weren't used */
+    if(batch) {
+        for(; batch_idx < nbatch; batch_idx++)
+            if(batch[batch_idx].buf)
+                batch[batch_idx].buf = H5D__chunk_mem_xfree(batch[batch_idx].buf, batch[batch_idx].pline);
+        batch = (H5D_chunk_decode_t *)H5MM_xfree(batch);
+    } /* end if */
+    if(coalesced)
+        coalesced = (H5D_chunk_coalesce_t *)H5MM_xfree(coalesced);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* H5D__chunk_read() */
 
-
+
 /*-------------------------------------------------------------------------
- * Function:	H5D__chunk_write
+ * Function:	H5D__chunk_coalesce_cmp
  *
- * Purpose:	Writes to a chunked dataset.
+ * Purpose:	Compare two chunks to read together by their addresses in
+ *              the file, for sorting with HDqsort().
  *
- * Return:	Non-negative on success/Negative on failure
+ * Return:	Negative, zero or positive as the first chunk's address is
+ *              less than, equal to or greater than the second's
  *
- * Programmer:	Raymond Lu
- *		Thursday, April 10, 2003
+ *-------------------------------------------------------------------------
+ */
+static int
+H5D__chunk_coalesce_cmp(const void *_chunk1, const void *_chunk2)
+{
+    const H5D_chunk_coalesce_t *chunk1 = *(const H5D_chunk_coalesce_t * const *)_chunk1;
+    const H5D_chunk_coalesce_t *chunk2 = *(const H5D_chunk_coalesce_t * const *)_chunk2;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    FUNC_LEAVE_NOAPI(H5F_addr_cmp(chunk1->addr, chunk2->addr))
+} /* end H5D__chunk_coalesce_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_read_coalesced
+ *
+ * Purpose:	Read the selected chunks of a dataset without filters
+ *              which bypass the chunk cache, when they're close together
+ *              in the file, with as few reads as possible.
+ *
+ *              The chunks are sorted by address and each run of chunks
+ *              no more than the dataset's read gap apart is read into a
+ *              buffer with one read (up to H5D_CHUNK_READ_COALESCE_MAX
+ *              bytes), then the selected elements are copied from there
+ *              as though the chunks were cached.  Runs which overlap
+ *              changes in the dataset's sieve buffer are left alone.
+ *
+ *              When UNLOCKED is set, the file allows concurrent reads and
+ *              each run is read with the library lock released, so runs
+ *              of a single chunk are read this way too.
+ *
+ *              On return, *COALESCED holds the chunks which were read, in
+ *              selection order, for the caller to skip (or is NULL).
+ *
+ * Return:	Non-negative on success/Negative on failure
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-H5D__chunk_write(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
-    hsize_t H5_ATTR_UNUSED nelmts, const H5S_t H5_ATTR_UNUSED *file_space, const H5S_t H5_ATTR_UNUSED *mem_space,
-    H5D_chunk_map_t *fm)
+H5D__chunk_read_coalesced(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
+    const H5D_chunk_map_t *fm, hbool_t unlocked, H5D_chunk_coalesce_t **coalesced,
+    size_t *ncoalesced)
 {
-    H5SL_node_t *chunk_node;            /* Current node in chunk skip list */
-    H5D_io_info_t ctg_io_info;          /* Contiguous I/O info object */
-    H5D_storage_t ctg_store;            /* Chunk storage information as contiguous dataset */
+    const H5D_t *dset = io_info->dset;  /* Local pointer to the dataset info */
+    const H5D_rdcdc_t *sieve = &(dset->shared->cache.contig); /* Dataset's sieve buffer */
+    H5D_io_info_t chk_io_info;          /* I/O info object for checking chunks */
+    H5D_storage_t chk_store;            /* Chunk storage information for checking chunks */
     H5D_io_info_t cpt_io_info;          /* Compact I/O info object */
     H5D_storage_t cpt_store;            /* Chunk storage information as compact dataset */
     hbool_t     cpt_dirty;              /* Temporary placeholder for compact storage "dirty" flag */
-    uint32_t    dst_accessed_bytes = 0; /* Total accessed size in a chunk */
-    herr_t	ret_value = SUCCEED;	/* Return value		*/
+    H5D_chunk_coalesce_t *chunks = NULL;    /* Chunks bypassing the cache, in selection order */
+    H5D_chunk_coalesce_t **sorted = NULL;   /* Chunks bypassing the cache, in file order */
+    unsigned char *buf = NULL;          /* Buffer for chunks read together */
+    size_t      buf_size = 0;           /* Size of buffer */
+    size_t      chunk_size;             /* Size of a chunk */
+    size_t      max_nchunks;            /* # of chunks selected */
+    size_t      min_run = unlocked ? 1 : 2; /* Min. # of chunks to read together */
+    size_t      nchunks = 0;            /* # of chunks bypassing the cache */
+    H5SL_node_t *chunk_node;            /* Current node in chunk skip list */
+    size_t      u, v, w;                /* Local index variables */
+    herr_t      ret_value = SUCCEED;    /* Return value */
 
     FUNC_ENTER_STATIC
 
-    /* Sanity check */
+    /* Sanity checks */
     HDassert(io_info);
-    HDassert(io_info->u.wbuf);
     HDassert(type_info);
     HDassert(fm);
+    HDassert(!fm->use_single);
+    HDassert(0 == dset->shared->dcpl_cache.pline.nused);
+    HDassert(coalesced);
+    HDassert(ncoalesced);
+
+    *coalesced = NULL;
+    *ncoalesced = 0;
+
+    /* Check whether two chunks can be read together at all */
+    H5_CHECKED_ASSIGN(chunk_size, size_t, dset->shared->layout.u.chunk.size, uint32_t);
+    max_nchunks = H5SL_count(fm->sel_chunks);
+    if(max_nchunks < min_run || (!unlocked && chunk_size > H5D_CHUNK_READ_COALESCE_MAX / 2))
+        HGOTO_DONE(SUCCEED)
 
-    /* Set up contiguous I/O info object */
-    HDmemcpy(&ctg_io_info, io_info, sizeof(ctg_io_info));
-    ctg_io_info.store = &ctg_store;
-    ctg_io_info.layout_ops = *H5D_LOPS_CONTIG;
+    /* Set up I/O info object, for checking which chunks are cacheable
+     * without changing the caller's */
+    HDmemcpy(&chk_io_info, io_info, sizeof(chk_io_info));
+    chk_io_info.store = &chk_store;
+
+    /* Find the selected chunks which are in the file and bypass the cache */
+    if(NULL == (chunks = (H5D_chunk_coalesce_t *)H5MM_malloc(max_nchunks * sizeof(H5D_chunk_coalesce_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk list")
+    for(chunk_node = H5SL_first(fm->sel_chunks); chunk_node; chunk_node = H5SL_next(chunk_node)) {
+        H5D_chunk_info_t *chunk_info = (H5D_chunk_info_t *)H5SL_item(chunk_node);
+        H5D_chunk_ud_t udata;           /* Chunk index pass-through */
+        htri_t cacheable;               /* Whether the chunk is cacheable */
 
-    /* Initialize temporary contiguous storage info */
-    H5_CHECKED_ASSIGN(ctg_store.contig.dset_size, hsize_t, io_info->dset->shared->layout.u.chunk.size, uint32_t);
+        if(H5D__chunk_lookup(dset, chunk_info->scaled, &udata) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+        if(UINT_MAX != udata.idx_hint || !H5F_addr_defined(udata.chunk_block.offset))
+            continue;
+        chk_store.chunk.scaled = chunk_info->scaled;
+        if((cacheable = H5D__chunk_cacheable(&chk_io_info, udata.chunk_block.offset, FALSE)) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't tell if chunk is cacheable")
+        if(cacheable)
+            continue;
 
-    /* Set up compact I/O info object */
+        chunks[nchunks].chunk_info = chunk_info;
+        chunks[nchunks].addr = udata.chunk_block.offset;
+        chunks[nchunks].done = FALSE;
+        nchunks++;
+    } /* end for */
+    if(nchunks < min_run)
+        HGOTO_DONE(SUCCEED)
+
+    /* Sort the chunks by address */
+    if(NULL == (sorted = (H5D_chunk_coalesce_t **)H5MM_malloc(nchunks * sizeof(H5D_chunk_coalesce_t *))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk list")
+    for(u = 0; u < nchunks; u++)
+        sorted[u] = &chunks[u];
+    HDqsort(sorted, nchunks, sizeof(H5D_chunk_coalesce_t *), H5D__chunk_coalesce_cmp);
+
+    /* Set up compact I/O info object, for copying from the buffer */
     HDmemcpy(&cpt_io_info, io_info, sizeof(cpt_io_info));
     cpt_io_info.store = &cpt_store;
     cpt_io_info.layout_ops = *H5D_LOPS_COMPACT;
-
-    /* Initialize temporary compact storage info */
     cpt_store.compact.dirty = &cpt_dirty;
 
-    /* Iterate through nodes in chunk skip list */
-    chunk_node = H5D_CHUNK_GET_FIRST_NODE(fm);
-    while(chunk_node) {
-        H5D_chunk_info_t *chunk_info;   /* Chunk information */
-	H5D_chk_idx_info_t idx_info;    /* Chunked index info */
-        H5D_io_info_t *chk_io_info;     /* Pointer to I/O info object for this chunk */
-        void *chunk;                    /* Pointer to locked chunk buffer */
-        H5D_chunk_ud_t udata;		/* Index pass-through	*/
-        htri_t cacheable;               /* Whether the chunk is cacheable */
-        hbool_t need_insert = FALSE;    /* Whether the chunk needs to be inserted into the index */
+    /* Read each run of chunks which are close enough together */
+    for(u = 0; u < nchunks; u = v) {
+        haddr_t end = sorted[u]->addr + chunk_size;     /* End of the run in the file */
+        size_t len;                     /* Length of the run in the file */
 
-        /* Get the actual chunk information from the skip list node */
-        chunk_info = H5D_CHUNK_GET_NODE_INFO(fm, chunk_node);
+        for(v = u + 1; v < nchunks; v++) {
+            if(H5F_addr_gt(sorted[v]->addr, end + dset->shared->cache.chunk.read_gap)
+                    || (sorted[v]->addr + chunk_size) - sorted[u]->addr > H5D_CHUNK_READ_COALESCE_MAX)
+                break;
+            end = sorted[v]->addr + chunk_size;
+        } /* end for */
+        if(v - u < min_run)
+            continue;
+        len = (size_t)(end - sorted[u]->addr);
 
-        /* Look up the chunk */
-        if(H5D__chunk_lookup(io_info->dset, chunk_info->scaled, &udata) < 0)
-            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+        /* Leave the chunks alone if the sieve buffer holds changes to them */
+        if(sieve->sieve_buf && sieve->sieve_dirty
+                && H5F_addr_overlap(sorted[u]->addr, len, sieve->sieve_loc, sieve->sieve_size))
+            continue;
 
-        /* Sanity check */
-        HDassert((H5F_addr_defined(udata.chunk_block.offset) && udata.chunk_block.length > 0) || 
-                (!H5F_addr_defined(udata.chunk_block.offset) && udata.chunk_block.length == 0));
+        /* Read the run */
+        if(len > buf_size) {
+            buf = (unsigned char *)H5MM_xfree(buf);
+            if(NULL == (buf = (unsigned char *)H5MM_malloc(len)))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunks")
+            buf_size = len;
+        } /* end if */
+#ifdef H5F_HAVE_CONCURRENT_READS
+        if(unlocked) {
+            unsigned lock_count = 0;    /* # of times API lock was held */
+            herr_t read_ret;            /* Result of reading */
+
+            if(H5TS_mutex_unlock_all(&H5_g.init_lock, &lock_count))
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTUNLOCK, FAIL, "can't release API lock")
+            H5E_pause_stack();
+            read_ret = H5F_block_read_concurrent(dset->oloc.file, sorted[u]->addr, len, buf);
+            H5E_resume_stack();
+            if(H5TS_mutex_relock(&H5_g.init_lock, lock_count))
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTLOCK, FAIL, "can't re-acquire API lock")
+
+            /* Leave the chunks to be read (and the error reported) later */
+            if(read_ret < 0)
+                continue;
+        } /* end if */
+        else
+#endif /* H5F_HAVE_CONCURRENT_READS */
+        if(H5F_block_read(dset->oloc.file, H5FD_MEM_DRAW, sorted[u]->addr, len, buf) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunks")
 
-	/* Set chunk's [scaled] coordinates */
-	io_info->store->chunk.scaled = chunk_info->scaled;
+        /* Copy the selected elements from each chunk */
+        for(w = u; w < v; w++) {
+            const H5D_chunk_info_t *chunk_info = sorted[w]->chunk_info;
 
-        /* Determine if we should use the chunk cache */
-        if((cacheable = H5D__chunk_cacheable(io_info, udata.chunk_block.offset, TRUE)) < 0)
-            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't tell if chunk is cacheable")
-        if(cacheable) {
-            /* Load the chunk into cache.  But if the whole chunk is written,
-             * simply allocate space instead of load the chunk. */
-            hbool_t entire_chunk = TRUE;       /* Whether whole chunk is selected */
+            cpt_store.compact.buf = buf + (sorted[w]->addr - sorted[u]->addr);
+            if((io_info->io_ops.single_read)(&cpt_io_info, type_info,
+                    (hsize_t)chunk_info->chunk_points, chunk_info->fspace, chunk_info->mspace) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "chunked read failed")
+            sorted[w]->done = TRUE;
+        } /* end for */
+    } /* end for */
 
-            /* Compute # of bytes accessed in chunk */
-            H5_CHECK_OVERFLOW(type_info->dst_type_size, /*From:*/ size_t, /*To:*/ uint32_t);
-            dst_accessed_bytes = chunk_info->chunk_points * (uint32_t)type_info->dst_type_size;
+    /* Return the chunks which were read, in selection order */
+    for(u = v = 0; u < nchunks; u++)
+        if(chunks[u].done)
+            chunks[v++] = chunks[u];
+    if(v > 0) {
+        *coalesced = chunks;
+        *ncoalesced = v;
+        chunks = NULL;
+    } /* end if */
 
-            /* Determine if we will access all the data in the chunk */
-            if(dst_accessed_bytes != ctg_store.contig.dset_size ||
-                    (chunk_info->chunk_points * type_info->src_type_size) != ctg_store.contig.dset_size ||
-		    fm->fsel_type == H5S_SEL_POINTS)
-                entire_chunk = FALSE;
+done:
+    if(buf)
+        buf = (unsigned char *)H5MM_xfree(buf);
+    if(sorted)
+        sorted = (H5D_chunk_coalesce_t **)H5MM_xfree(sorted);
+    if(chunks)
+        chunks = (H5D_chunk_coalesce_t *)H5MM_xfree(chunks);
 
-            /* Lock the chunk into the cache */
-            if(NULL == (chunk = H5D__chunk_lock(io_info, &udata, entire_chunk, FALSE)))
-                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunk")
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_read_coalesced() */
 
-            /* Set up the storage buffer information for this chunk */
-            cpt_store.compact.buf = chunk;
 
-            /* Point I/O info at main I/O info for this chunk */
-            chk_io_info = &cpt_io_info;
-        } /* end if */
-        else {
-            /* If the chunk hasn't been allocated on disk, do so now. */
-            if(!H5F_addr_defined(udata.chunk_block.offset)) {
-                /* Compose chunked index info struct */
-                idx_info.f = io_info->dset->oloc.file;
-                idx_info.pline = &(io_info->dset->shared->dcpl_cache.pline);
-                idx_info.layout = &(io_info->dset->shared->layout.u.chunk);
-                idx_info.storage = &(io_info->dset->shared->layout.storage.u.chunk);
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_decode_cb
+ *
+ * Purpose:	Reverse the I/O pipeline on a chunk, on a worker thread.
+ *
+ * Note:	This runs without the library lock, so it mustn't touch
+ *              anything but the chunk's buffer and read-only state.  The
+ *              filters' errors are dropped: from the worker's error stack
+ *              after the task, and callers which run this themselves
+ *              pause their error stack.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_decode_cb(void *_dec)
+{
+    H5D_chunk_decode_t *dec = (H5D_chunk_decode_t *)_dec;     /* Chunk to decode */
+    void *lent_buf = NULL;              /* Buffer lent to the filters */
+    herr_t ret_value = SUCCEED;         /* Return value */
 
-                /* Set up the size of chunk for user data */
-                udata.chunk_block.length = io_info->dset->shared->layout.u.chunk.size;
+    FUNC_ENTER_STATIC_NOERR
 
-                /* Allocate the chunk */
-		if(H5D__chunk_file_alloc(&idx_info, NULL, &udata.chunk_block, &need_insert, chunk_info->scaled) < 0)
-		    HGOTO_ERROR(H5E_DATASET, H5E_CANTINSERT, FAIL, "unable to insert/resize chunk on chunk level")
+    HDassert(dec);
+    HDassert(dec->buf);
 
-                /* Make sure the address of the chunk is returned. */
-                if(!H5F_addr_defined(udata.chunk_block.offset))
-                    HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "chunk address isn't defined")
+    /* (The filters just allocate their own if this fails) */
+    if(dec->lent_size > 0)
+        lent_buf = H5D__chunk_mem_alloc(dec->lent_size, dec->pline);
 
-                /* Cache the new chunk information */
-                H5D__chunk_cinfo_cache_update(&io_info->dset->shared->cache.chunk.last, &udata);
-            } /* end if */
+    ret_value = H5Z_pipeline_lend(dec->pline, H5Z_FLAG_REVERSE, &(dec->filter_mask),
+            dec->err_detect, dec->filter_cb, &(dec->nbytes), &(dec->buf_alloc), &(dec->buf),
+            &lent_buf, dec->lent_size);
 
-            /* Set up the storage address information for this chunk */
-            ctg_store.contig.dset_addr = udata.chunk_block.offset;
+    if(lent_buf)
+        lent_buf = H5D__chunk_mem_xfree(lent_buf, dec->pline);
 
-            /* No chunk cached */
-            chunk = NULL;
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_decode_cb() */
 
-            /* Point I/O info at temporary I/O info for this chunk */
-            chk_io_info = &ctg_io_info;
-        } /* end else */
 
-        /* Perform the actual write operation */
-        if((io_info->io_ops.single_write)(chk_io_info, type_info,
-                (hsize_t)chunk_info->chunk_points, chunk_info->fspace, chunk_info->mspace) < 0)
-            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "chunked write failed")
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_decode_batch
+ *
+ * Purpose:	Look up the next MAX_NBATCH selected chunks, starting at
+ *              *CHUNK_NODE.  Those which are filtered, in the file and not
+ *              in the chunk cache are read from the file here, then have
+ *              their filters reversed on the worker threads in TP.
+ *
+ *              When UNLOCKED is set, the file allows concurrent reads and
+ *              the library lock is released while the chunks are read
+ *              and decoded (on the calling thread if TP is NULL), so that
+ *              other threads can use the library meanwhile.  Unfiltered
+ *              chunks which are going to be cached are read that way too.
+ *
+ *              On return, BATCH holds the decoded chunks in selection
+ *              order and *CHUNK_NODE is the first node which wasn't
+ *              looked at.  A chunk which failed to decode is left with a
+ *              NULL buffer, so that it's read again by H5D__chunk_lock()
+ *              and the failure is reported from there.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_decode_batch(const H5D_io_info_t *io_info, const H5D_chunk_map_t *fm,
+    H5SL_node_t **chunk_node, H5TP_t *tp, hbool_t unlocked, H5D_chunk_decode_t *batch,
+    size_t max_nbatch, size_t *nbatch)
+{
+    const H5D_t *dset = io_info->dset;  /* Local pointer to the dataset info */
+    const H5O_pline_t *pline = &(dset->shared->dcpl_cache.pline); /* I/O pipeline info */
+    const H5O_layout_t *layout = &(dset->shared->layout); /* Dataset layout */
+    H5Z_EDC_t err_detect;               /* Error detection info */
+    H5Z_cb_t filter_cb;                 /* I/O filter callback function */
+    size_t lent_size = 0;               /* Size of buffer to lend the filters */
+    size_t nscanned;                    /* # of chunks looked at */
+    size_t nsubmitted = 0;              /* # of chunks given to the workers */
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
 
-	/* Release the cache lock on the chunk, or insert chunk into index. */
-	if(chunk) {
-	    if(H5D__chunk_unlock(io_info, &udata, TRUE, chunk, dst_accessed_bytes) < 0)
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(io_info);
+    HDassert(fm);
+    HDassert(chunk_node && *chunk_node);
+    HDassert(tp || unlocked);
+    HDassert(batch);
+    HDassert(max_nbatch > 0);
+    HDassert(nbatch);
+#ifndef H5F_HAVE_CONCURRENT_READS
+    HDassert(!unlocked);
+#endif /* H5F_HAVE_CONCURRENT_READS */
+
+    /* Retrieve filter settings from API context */
+    if(H5CX_get_err_detect(&err_detect) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get error detection info")
+    if(H5CX_get_filter_cb(&filter_cb) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function")
+
+    /* Lend the filters chunk buffers to uncompress into (only deflate borrows them) */
+    if(H5Z_filter_in_pline(pline, H5Z_FILTER_DEFLATE) > 0)
+        H5_CHECKED_ASSIGN(lent_size, size_t, layout->u.chunk.size, uint32_t);
+
+    /* Find (and, with the lock held, read) the raw chunks that need decoding */
+    *nbatch = 0;
+    for(nscanned = 0; nscanned < max_nbatch && *chunk_node; nscanned++) {
+        H5D_chunk_info_t *chunk_info = H5D_CHUNK_GET_NODE_INFO(fm, *chunk_node);
+        H5D_chunk_decode_t *dec = &batch[*nbatch];
+        hbool_t use_chunk = FALSE;      /* Whether to read the chunk here */
+
+        /* Get the info for the chunk in the file */
+        if(H5D__chunk_lookup(dset, chunk_info->scaled, &dec->udata) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+
+        /* Only decode filtered chunks which must be read from the file, and
+         * read unfiltered ones which will be cached when the lock is
+         * released for reading */
+        if(UINT_MAX == dec->udata.idx_hint && H5F_addr_defined(dec->udata.chunk_block.offset)) {
+            if(pline->nused)
+                use_chunk = !((layout->u.chunk.flags & H5O_LAYOUT_CHUNK_DONT_FILTER_PARTIAL_BOUND_CHUNKS)
+                    && H5D__chunk_is_partial_edge_chunk(dset->shared->ndims,
+                        layout->u.chunk.dim, chunk_info->scaled, dset->shared->curr_dims));
+            else if(unlocked) {
+                htri_t cacheable;       /* Whether the chunk is cacheable */
+
+                io_info->store->chunk.scaled = chunk_info->scaled;
+                if((cacheable = H5D__chunk_cacheable(io_info, dec->udata.chunk_block.offset, FALSE)) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't tell if chunk is cacheable")
+                use_chunk = (hbool_t)cacheable;
+            } /* end if */
+        } /* end if */
+
+        if(use_chunk) {
+            dec->chunk_info = chunk_info;
+            dec->pline = pline;
+            dec->err_detect = err_detect;
+            dec->filter_cb = filter_cb;
+            dec->filter_mask = dec->udata.filter_mask;
+            dec->filtered = (hbool_t)(pline->nused > 0);
+            dec->task.status = SUCCEED;
+            dec->task.done = TRUE;
+            H5_CHECKED_ASSIGN(dec->nbytes, size_t, dec->udata.chunk_block.length, hsize_t);
+            dec->buf_alloc = dec->nbytes;
+            dec->lent_size = lent_size;
+
+            if(NULL == (dec->buf = H5D__chunk_mem_alloc(dec->nbytes, pline)))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for raw data chunk")
+            (*nbatch)++;
+            if(!unlocked && H5F_block_read(dset->oloc.file, H5FD_MEM_DRAW, dec->udata.chunk_block.offset, dec->nbytes, dec->buf) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunk")
+        } /* end if */
+
+        *chunk_node = H5D_CHUNK_GET_NEXT_NODE(fm, *chunk_node);
+    } /* end for */
+
+#ifdef H5F_HAVE_CONCURRENT_READS
+    if(unlocked && *nbatch > 0) {
+        unsigned lock_count = 0;        /* # of times API lock was held */
+
+        /* Read and decode the chunks without the library lock.  Nothing
+         * here may push errors (or touch other shared state): failures are
+         * only recorded in the chunks' status.
+         */
+        if(H5TS_mutex_unlock_all(&H5_g.init_lock, &lock_count))
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTUNLOCK, FAIL, "can't release API lock")
+        H5E_pause_stack();
+
+        for(u = 0; u < *nbatch; u++) {
+            H5D_chunk_decode_t *dec = &batch[u];
+
+            if(H5F_block_read_concurrent(dset->oloc.file, dec->udata.chunk_block.offset, dec->nbytes, dec->buf) < 0)
+                dec->task.status = FAIL;
+            else if(dec->filtered) {
+                if(tp && H5TP_submit(tp, &dec->task, H5D__chunk_decode_cb, dec) >= 0)
+                    nsubmitted = u + 1;
+                else
+                    dec->task.status = H5D__chunk_decode_cb(dec);
+            } /* end if */
+        } /* end for */
+        /* (Chunks which weren't given to the workers are already done) */
+        for(u = 0; u < nsubmitted; u++)
+            if(H5TP_task_wait(tp, &batch[u].task) < 0)
+                batch[u].task.status = FAIL;
+        nsubmitted = 0;
+
+        H5E_resume_stack();
+        if(H5TS_mutex_relock(&H5_g.init_lock, lock_count))
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTLOCK, FAIL, "can't re-acquire API lock")
+    } /* end if */
+    else
+#endif /* H5F_HAVE_CONCURRENT_READS */
+    /* Reverse the filters on the chunks */
+    for(nsubmitted = 0; nsubmitted < *nbatch; nsubmitted++)
+        if(H5TP_submit(tp, &batch[nsubmitted].task, H5D__chunk_decode_cb, &batch[nsubmitted]) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't queue chunk for decoding")
+
+done:
+    /* Wait for the workers, even on failure, since they use the batch */
+    if(nsubmitted > 0 && H5TP_wait(tp) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't wait for chunk decoding")
+
+    /* Drop the buffers of chunks which failed to decode, or all of them on error */
+    for(u = 0; u < *nbatch; u++)
+        if(batch[u].buf && (ret_value < 0 || batch[u].task.status < 0))
+            batch[u].buf = H5D__chunk_mem_xfree(batch[u].buf, pline);
+    if(ret_value < 0)
+        *nbatch = 0;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_decode_batch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_read_ahead
+ *
+ * Purpose:	Record the chunks selected by a read and, when the reads of
+ *              the dataset are moving forward through its chunks, load
+ *              the chunks the next reads are likely to select into the
+ *              chunk cache.
+ *
+ *              Reads are sequential when a read starts after the first
+ *              chunk of the previous one, but no further than the chunk
+ *              following its last one.  The chunks following the read's
+ *              last chunk are loaded then.  Reads are strided when a read
+ *              starts the same # of chunks after the previous one as that
+ *              one did after the read before it (reads which start at the
+ *              same chunk as the previous one are ignored).  The chunks
+ *              of the next reads, assumed to span as many chunks as this
+ *              one, are loaded then.
+ *
+ *              Up to the read-ahead window's # of chunks are looked at,
+ *              skipping those which are cached already or don't exist in
+ *              the file.  The chunks loaded take up no more than half the
+ *              cache (the FIFO queue's quarter with the 2Q policy), so
+ *              they stay cached until they're read.  The chunks are read
+ *              here, and filtered ones decoded on the file's filter
+ *              threads, if it has them.  A chunk which fails to be read
+ *              or decoded isn't loaded, so that the failure is reported
+ *              if and when it's read.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_read_ahead(const H5D_io_info_t *io_info, const H5D_chunk_map_t *fm)
+{
+    const H5D_t *dset = io_info->dset;  /* Local pointer to the dataset info */
+    H5D_rdcc_t *rdcc = &(dset->shared->cache.chunk);    /* Raw data chunk cache */
+    const H5O_pline_t *pline = &(dset->shared->dcpl_cache.pline); /* I/O pipeline info */
+    const H5O_layout_t *layout = &(dset->shared->layout); /* Dataset layout */
+    H5D_io_info_t ra_io_info;           /* I/O info for loading chunks */
+    H5D_storage_t ra_store;             /* Chunk storage information for loading chunks */
+    H5TP_t *filter_pool = NULL;         /* Worker threads for decoding chunks */
+    H5D_chunk_decode_t *batch = NULL;   /* Chunks to load */
+    H5Z_EDC_t err_detect;               /* Error detection info */
+    H5Z_cb_t filter_cb;                 /* I/O filter callback function */
+    size_t lent_size = 0;               /* Size of buffer to lend the filters */
+    hsize_t first, last;                /* First & last chunks selected by the read */
+    hsize_t span;                       /* # of chunks spanned by the read */
+    hsize_t stride = 0;                 /* # of chunks between reads, or 0 for sequential reads */
+    size_t max_nbatch;                  /* Max. # of chunks to load */
+    size_t nbatch = 0;                  /* # of chunks to load */
+    size_t nsubmitted = 0;              /* # of chunks given to the workers */
+    size_t u, v;                        /* Local index variables */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(io_info);
+    HDassert(fm);
+    HDassert(rdcc->read_ahead > 0);
+
+    /* Get the range of chunks selected by the read */
+    if(fm->use_single)
+        first = last = fm->single_chunk_info->index;
+    else {
+        H5SL_node_t *node;              /* Skip list node */
+
+        if(NULL == (node = H5SL_first(fm->sel_chunks)))
+            HGOTO_DONE(SUCCEED)
+        first = ((const H5D_chunk_info_t *)H5SL_item(node))->index;
+        last = ((const H5D_chunk_info_t *)H5SL_item(H5SL_last(fm->sel_chunks)))->index;
+    } /* end else */
+    span = (last - first) + 1;
+
+    /* Compare the read with the previous ones */
+    if(!rdcc->ra_valid) {
+        rdcc->ra_valid = TRUE;
+        rdcc->ra_first = first;
+        rdcc->ra_last = last;
+        rdcc->ra_stride = 0;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+    if(first == rdcc->ra_first) {
+        rdcc->ra_last = last;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+    if(first > rdcc->ra_first && first <= rdcc->ra_last + 1)
+        max_nbatch = rdcc->read_ahead;
+    else if(first > rdcc->ra_last + 1 && first - rdcc->ra_first == rdcc->ra_stride) {
+        max_nbatch = rdcc->read_ahead;
+        if(span < rdcc->ra_stride)
+            stride = rdcc->ra_stride;
+    } /* end if */
+    else
+        max_nbatch = 0;
+    rdcc->ra_stride = first > rdcc->ra_first ? first - rdcc->ra_first : 0;
+    rdcc->ra_first = first;
+    rdcc->ra_last = last;
+
+    /* Limit the chunks loaded to the part of the cache they can stay in */
+    H5_CHECK_OVERFLOW(layout->u.chunk.size, uint32_t, size_t);
+    if((size_t)layout->u.chunk.size > 0)
+        max_nbatch = MIN(max_nbatch, (rdcc->nbytes_max /
+                (H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy ? H5D_CHUNK_CACHE_2Q_FIFO_DIV : 2))
+                / (size_t)layout->u.chunk.size);
+    if(0 == max_nbatch)
+        HGOTO_DONE(SUCCEED)
+
+#ifdef H5_HAVE_PARALLEL
+    /* Don't read ahead independently of the other processes */
+    if(io_info->using_mpi_vfd)
+        HGOTO_DONE(SUCCEED)
+#endif /* H5_HAVE_PARALLEL */
+
+    /* Set up for decoding filtered chunks */
+    if(pline->nused) {
+        if(H5D__chunk_get_filter_pool(dset, &filter_pool) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get filter thread pool")
+        if(H5CX_get_err_detect(&err_detect) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get error detection info")
+        if(H5CX_get_filter_cb(&filter_cb) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function")
+
+        /* Lend the filters chunk buffers to uncompress into (only deflate borrows them) */
+        if(H5Z_filter_in_pline(pline, H5Z_FILTER_DEFLATE) > 0)
+            H5_CHECKED_ASSIGN(lent_size, size_t, layout->u.chunk.size, uint32_t);
+    } /* end if */
+
+    if(NULL == (batch = (H5D_chunk_decode_t *)H5MM_calloc(max_nbatch * sizeof(H5D_chunk_decode_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk read-ahead")
+
+    /* Find the chunks to load and read them */
+    for(u = 0; u < rdcc->read_ahead && nbatch < max_nbatch; u++) {
+        H5D_chunk_decode_t *dec = &batch[nbatch];
+        hsize_t idx;                    /* Index of chunk */
+        herr_t status;                  /* Status from reading chunk */
+
+        /* Get the chunk's index and scaled coordinates */
+        if(0 == stride)
+            idx = last + 1 + u;
+        else
+            idx = first + (1 + u / span) * stride + u % span;
+        if(idx >= layout->u.chunk.nchunks)
+            break;
+        if(H5VM_array_calc_pre(idx, dset->shared->ndims, layout->u.chunk.down_chunks, dec->scaled) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't compute chunk coordinates")
+        dec->scaled[dset->shared->ndims] = 0;
+
+        /* Get the info for the chunk in the file */
+        if(H5D__chunk_lookup(dset, dec->scaled, &dec->udata) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+
+        /* Skip chunks which are cached or don't exist */
+        if(UINT_MAX != dec->udata.idx_hint || !H5F_addr_defined(dec->udata.chunk_block.offset))
+            continue;
+
+        /* Decode filtered chunks, except partial edge chunks which aren't filtered */
+        if(pline->nused && !((layout->u.chunk.flags & H5O_LAYOUT_CHUNK_DONT_FILTER_PARTIAL_BOUND_CHUNKS)
+                && H5D__chunk_is_partial_edge_chunk(dset->shared->ndims,
+                    layout->u.chunk.dim, dec->scaled, dset->shared->curr_dims))) {
+            dec->pline = pline;
+            dec->err_detect = err_detect;
+            dec->filter_cb = filter_cb;
+            dec->lent_size = lent_size;
+        } /* end if */
+        dec->filter_mask = dec->udata.filter_mask;
+        H5_CHECKED_ASSIGN(dec->nbytes, size_t, dec->udata.chunk_block.length, hsize_t);
+        dec->buf_alloc = dec->nbytes;
+
+        /* Read the chunk.  A chunk which can't be read is just skipped,
+         * like one which fails to decode, and its errors aren't kept.
+         */
+        if(NULL == (dec->buf = H5D__chunk_mem_alloc(dec->nbytes, pline)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for raw data chunk")
+        H5E_pause_stack();
+        status = H5F_block_read(dset->oloc.file, H5FD_MEM_DRAW, dec->udata.chunk_block.offset, dec->nbytes, dec->buf);
+        H5E_resume_stack();
+        if(status < 0) {
+            dec->buf = H5D__chunk_mem_xfree(dec->buf, pline);
+            HDmemset(dec, 0, sizeof(*dec));
+            continue;
+        } /* end if */
+        nbatch++;
+    } /* end for */
+
+    /* Reverse the filters on the chunks read, on the worker threads if
+     * possible.  A chunk which fails to decode is just dropped, so the
+     * errors the filters push aren't kept on the caller's error stack.
+     */
+    for(u = 0; u < nbatch; u++)
+        if(batch[u].pline) {
+            if(filter_pool) {
+                if(H5TP_submit(filter_pool, &batch[u].task, H5D__chunk_decode_cb, &batch[u]) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't queue chunk for decoding")
+                nsubmitted = u + 1;
+            } /* end if */
+            else {
+                H5E_pause_stack();
+                batch[u].task.status = H5D__chunk_decode_cb(&batch[u]);
+                H5E_resume_stack();
+            } /* end else */
+        } /* end if */
+    if(nsubmitted > 0) {
+        nsubmitted = 0;
+        if(H5TP_wait(filter_pool) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't wait for chunk decoding")
+    } /* end if */
+
+    /* Drop the chunks which failed to decode */
+    for(u = v = 0; u < nbatch; u++)
+        if(batch[u].task.status < 0)
+            batch[u].buf = H5D__chunk_mem_xfree(batch[u].buf, pline);
+        else {
+            if(u != v) {
+                batch[v] = batch[u];
+                batch[v].udata.common.scaled = batch[v].scaled;
+            } /* end if */
+            v++;
+        } /* end else */
+    nbatch = v;
+
+    /* Load the chunks into the cache */
+    HDmemcpy(&ra_io_info, io_info, sizeof(ra_io_info));
+    ra_io_info.store = &ra_store;
+    for(u = 0; u < nbatch; u++) {
+        H5D_chunk_ud_t udata = batch[u].udata;  /* Chunk index pass-through */
+        void *chunk;                    /* Pointer to locked chunk buffer */
+
+        udata.filter_mask = batch[u].filter_mask;
+        udata.decoded_chunk = batch[u].buf;
+        batch[u].buf = NULL;
+        ra_store.chunk.scaled = batch[u].scaled;
+
+        if(NULL == (chunk = H5D__chunk_lock(&ra_io_info, &udata, FALSE, FALSE)))
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunk")
+        if(H5D__chunk_unlock(&ra_io_info, &udata, FALSE, chunk, (uint32_t)0) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to unlock raw data chunk")
+        rdcc->stats.nread_ahead++;
+    } /* end for */
+
+done:
+    /* Wait for the workers on failure, since they use the batch */
+    if(nsubmitted > 0 && H5TP_wait(filter_pool) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't wait for chunk decoding")
+
+    /* Release any chunks which weren't loaded */
+    if(batch) {
+        for(u = 0; u < nbatch; u++)
+            if(batch[u].buf)
+                batch[u].buf = H5D__chunk_mem_xfree(batch[u].buf, pline);
+        batch = (H5D_chunk_decode_t *)H5MM_xfree(batch);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_read_ahead() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_filters_unlocked
+ *
+ * Purpose:	Check whether the dataset's filters can be run without the
+ *              library lock (on worker threads, or while it's released).
+ *              That's when all the filters are the library's own and
+ *              there's no application filter callback, since application
+ *              filters, plugins and callbacks may rely on the lock.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_filters_unlocked(const H5D_t *dset, hbool_t *unlocked)
+{
+    const H5O_pline_t *pline = &(dset->shared->dcpl_cache.pline); /* I/O pipeline info */
+    H5Z_cb_t filter_cb;                 /* I/O filter callback function */
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(dset);
+    HDassert(unlocked);
+
+    *unlocked = FALSE;
+
+    if(pline->nused) {
+        if(H5CX_get_filter_cb(&filter_cb) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function")
+        if(filter_cb.func)
+            HGOTO_DONE(SUCCEED)
+        for(u = 0; u < pline->nused; u++)
+            if(!H5Z_filter_unlocked(pline->filter[u].id))
+                HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+    *unlocked = TRUE;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_filters_unlocked() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_get_filter_pool
+ *
+ * Purpose:	Get the thread pool for running the dataset's filters on
+ *              worker threads, if they should be.  That's when the file
+ *              was opened with more than one filter thread and the
+ *              filters can run without the library lock.
+ *
+ *              *TP is set to NULL when the filters should be run on the
+ *              calling thread.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_get_filter_pool(const H5D_t *dset, H5TP_t **tp)
+{
+    hbool_t unlocked;                   /* Whether the filters can run on worker threads */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(dset);
+    HDassert(tp);
+
+    *tp = NULL;
+
+    if(0 == dset->shared->dcpl_cache.pline.nused || H5F_FILTER_NTHREADS(dset->oloc.file) <= 1)
+        HGOTO_DONE(SUCCEED)
+
+    if(H5D__chunk_filters_unlocked(dset, &unlocked) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't check dataset's filters")
+    if(!unlocked)
+        HGOTO_DONE(SUCCEED)
+
+    if(NULL == (*tp = H5F_get_filter_pool(dset->oloc.file)))
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't get filter thread pool")
+
+    /* A pool without worker threads (in builds which can't start them)
+     * gains nothing over filtering chunks the usual way */
+    if(0 == H5TP_get_nthreads(*tp))
+        *tp = NULL;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_get_filter_pool() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_encode_cb
+ *
+ * Purpose:	Apply the I/O pipeline to a copy of a dirty chunk, on a
+ *              worker thread.
+ *
+ * Note:	This runs without the library lock, so it mustn't touch
+ *              anything but its own buffer and read-only state.  The
+ *              filters' errors are dropped from the worker's error stack
+ *              after the task.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_encode_cb(void *_enc)
+{
+    H5D_chunk_encode_t *enc = (H5D_chunk_encode_t *)_enc;     /* Chunk to encode */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(enc);
+    HDassert(enc->ent && enc->ent->chunk);
+    HDassert(NULL == enc->buf);
+
+    /* Copy the chunk, since the cache keeps the unfiltered data */
+    if(NULL == (enc->buf = H5Z_buf_malloc(enc->buf_alloc)))
+        HGOTO_DONE(FAIL)
+    HDmemcpy(enc->buf, enc->ent->chunk, enc->buf_alloc);
+
+    if(H5Z_pipeline_lend(enc->pline, 0, &(enc->filter_mask), enc->err_detect,
+            enc->filter_cb, &(enc->nbytes), &(enc->buf_alloc), &(enc->buf),
+            NULL, (size_t)0) < 0) {
+        enc->buf = H5Z_buf_free(enc->buf);
+        HGOTO_DONE(FAIL)
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_encode_cb() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_encode_batch
+ *
+ * Purpose:	Apply the filters to the dirty chunks of the NENTS cache
+ *              entries in ENTS on the worker threads in TP, ahead of
+ *              H5D__chunk_flush_entry() writing them.
+ *
+ *              Each chunk which is encoded is left in its entry's
+ *              ENC_CHUNK field, to be picked up when the entry is
+ *              flushed.  File space is still allocated when each entry
+ *              is flushed, so the file layout doesn't depend on the order
+ *              the workers finish in.  A chunk which failed to encode is
+ *              encoded again when it's flushed, and the failure is
+ *              reported from there.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_encode_batch(const H5D_t *dset, H5TP_t *tp, H5D_rdcc_ent_t **ents,
+    size_t nents)
+{
+    const H5O_pline_t *pline = &(dset->shared->dcpl_cache.pline); /* I/O pipeline info */
+    H5D_chunk_encode_t *batch = NULL;   /* Chunks to encode */
+    H5Z_EDC_t err_detect;               /* Error detection info */
+    H5Z_cb_t filter_cb;                 /* I/O filter callback function */
+    size_t nbatch = 0;                  /* # of chunks to encode */
+    size_t nsubmitted = 0;              /* # of chunks given to the workers */
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(dset);
+    HDassert(tp);
+    HDassert(ents);
+
+    /* Retrieve filter settings from API context */
+    if(H5CX_get_err_detect(&err_detect) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get error detection info")
+    if(H5CX_get_filter_cb(&filter_cb) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function")
+
+    if(NULL == (batch = (H5D_chunk_encode_t *)H5MM_calloc(nents * sizeof(H5D_chunk_encode_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk encode batch")
+
+    /* Pick out the dirty chunks that will be filtered when they're flushed */
+    for(u = 0; u < nents; u++) {
+        H5D_rdcc_ent_t *ent = ents[u];
+
+        HDassert(NULL == ent->enc_chunk);
+        if(ent->dirty && ent->chunk && !(ent->edge_chunk_state & H5D_RDCC_DISABLE_FILTERS)) {
+            H5D_chunk_encode_t *enc = &batch[nbatch++];
+
+            enc->ent = ent;
+            enc->pline = pline;
+            enc->err_detect = err_detect;
+            enc->filter_cb = filter_cb;
+            enc->filter_mask = 0;
+            enc->nbytes = dset->shared->layout.u.chunk.size;
+            enc->buf_alloc = enc->nbytes;
+        } /* end if */
+    } /* end for */
+
+    /* Apply the filters to the chunks */
+    for(nsubmitted = 0; nsubmitted < nbatch; nsubmitted++)
+        if(H5TP_submit(tp, &batch[nsubmitted].task, H5D__chunk_encode_cb, &batch[nsubmitted]) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't queue chunk for encoding")
+
+done:
+    /* Wait for the workers, even on failure, since they use the batch */
+    if(nsubmitted > 0 && H5TP_wait(tp) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't wait for chunk encoding")
+
+    /* Hand the encoded chunks to their entries, or drop them all on error */
+    if(batch) {
+        for(u = 0; u < nsubmitted; u++)
+            if(batch[u].buf) {
+                if(ret_value < 0)
+                    batch[u].buf = H5Z_buf_free(batch[u].buf);
+                else {
+                    batch[u].ent->enc_chunk = (uint8_t *)batch[u].buf;
+                    batch[u].ent->enc_nbytes = batch[u].nbytes;
+                    batch[u].ent->enc_filter_mask = batch[u].filter_mask;
+                } /* end else */
+            } /* end if */
+        batch = (H5D_chunk_encode_t *)H5MM_xfree(batch);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_encode_batch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_write
+ *
+ * Purpose:	Writes to a chunked dataset.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ * Programmer:	Raymond Lu
+ *		Thursday, April 10, 2003
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_write(H5D_io_info_t *io_info, const H5D_type_info_t *type_info,
+    hsize_t H5_ATTR_UNUSED nelmts, const H5S_t H5_ATTR_UNUSED *file_space, const H5S_t H5_ATTR_UNUSED *mem_space,
+    H5D_chunk_map_t *fm)
+{
+    H5SL_node_t *chunk_node;            /* Current node in chunk skip list */
+    H5D_io_info_t ctg_io_info;          /* Contiguous I/O info object */
+    H5D_storage_t ctg_store;            /* Chunk storage information as contiguous dataset */
+    H5D_io_info_t cpt_io_info;          /* Compact I/O info object */
+    H5D_storage_t cpt_store;            /* Chunk storage information as compact dataset */
+    hbool_t     cpt_dirty;              /* Temporary placeholder for compact storage "dirty" flag */
+    uint32_t    dst_accessed_bytes = 0; /* Total accessed size in a chunk */
+    herr_t	ret_value = SUCCEED;	/* Return value		*/
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(io_info);
+    HDassert(io_info->u.wbuf);
+    HDassert(type_info);
+    HDassert(fm);
+
+    /* Set up contiguous I/O info object */
+    HDmemcpy(&ctg_io_info, io_info, sizeof(ctg_io_info));
+    ctg_io_info.store = &ctg_store;
+    ctg_io_info.layout_ops = *H5D_LOPS_CONTIG;
+
+    /* Initialize temporary contiguous storage info */
+    H5_CHECKED_ASSIGN(ctg_store.contig.dset_size, hsize_t, io_info->dset->shared->layout.u.chunk.size, uint32_t);
+
+    /* Set up compact I/O info object */
+    HDmemcpy(&cpt_io_info, io_info, sizeof(cpt_io_info));
+    cpt_io_info.store = &cpt_store;
+    cpt_io_info.layout_ops = *H5D_LOPS_COMPACT;
+
+    /* Initialize temporary compact storage info */
+    cpt_store.compact.dirty = &cpt_dirty;
+
+    /* Iterate through nodes in chunk skip list */
+    chunk_node = H5D_CHUNK_GET_FIRST_NODE(fm);
+    while(chunk_node) {
+        H5D_chunk_info_t *chunk_info;   /* Chunk information */
+	H5D_chk_idx_info_t idx_info;    /* Chunked index info */
+        H5D_io_info_t *chk_io_info;     /* Pointer to I/O info object for this chunk */
+        void *chunk;                    /* Pointer to locked chunk buffer */
+        H5D_chunk_ud_t udata;		/* Index pass-through	*/
+        htri_t cacheable;               /* Whether the chunk is cacheable */
+        hbool_t need_insert = FALSE;    /* Whether the chunk needs to be inserted into the index */
+
+        /* Get the actual chunk information from the skip list node */
+        chunk_info = H5D_CHUNK_GET_NODE_INFO(fm, chunk_node);
+
+        /* Look up the chunk */
+        if(H5D__chunk_lookup(io_info->dset, chunk_info->scaled, &udata) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+
+        /* Sanity check */
+        HDassert((H5F_addr_defined(udata.chunk_block.offset) && udata.chunk_block.length > 0) || 
+                (!H5F_addr_defined(udata.chunk_block.offset) && udata.chunk_block.length == 0));
+
+	/* Set chunk's [scaled] coordinates */
+	io_info->store->chunk.scaled = chunk_info->scaled;
+
+        /* Determine if we should use the chunk cache */
+        if((cacheable = H5D__chunk_cacheable(io_info, udata.chunk_block.offset, TRUE)) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't tell if chunk is cacheable")
+        if(cacheable) {
+            /* Load the chunk into cache.  But if the whole chunk is written,
+             * simply allocate space instead of load the chunk. */
+            hbool_t entire_chunk = TRUE;       /* Whether whole chunk is selected */
+
+            /* Compute # of bytes accessed in chunk */
+            H5_CHECK_OVERFLOW(type_info->dst_type_size, /*From:*/ size_t, /*To:*/ uint32_t);
+            dst_accessed_bytes = chunk_info->chunk_points * (uint32_t)type_info->dst_type_size;
+
+            /* Determine if we will access all the data in the chunk */
+            if(dst_accessed_bytes != ctg_store.contig.dset_size ||
+                    (chunk_info->chunk_points * type_info->src_type_size) != ctg_store.contig.dset_size ||
+		    fm->fsel_type == H5S_SEL_POINTS)
+                entire_chunk = FALSE;
+
+            /* Lock the chunk into the cache */
+            if(NULL == (chunk = H5D__chunk_lock(io_info, &udata, entire_chunk, FALSE)))
+                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read raw data chunk")
+
+            /* Set up the storage buffer information for this chunk */
+            cpt_store.compact.buf = chunk;
+
+            /* Point I/O info at main I/O info for this chunk */
+            chk_io_info = &cpt_io_info;
+        } /* end if */
+        else {
+            /* If the chunk hasn't been allocated on disk, do so now. */
+            if(!H5F_addr_defined(udata.chunk_block.offset)) {
+                /* Compose chunked index info struct */
+                idx_info.f = io_info->dset->oloc.file;
+                idx_info.pline = &(io_info->dset->shared->dcpl_cache.pline);
+                idx_info.layout = &(io_info->dset->shared->layout.u.chunk);
+                idx_info.storage = &(io_info->dset->shared->layout.storage.u.chunk);
+
+                /* Set up the size of chunk for user data */
+                udata.chunk_block.length = io_info->dset->shared->layout.u.chunk.size;
+
+                /* Allocate the chunk */
+		if(H5D__chunk_file_alloc(&idx_info, NULL, &udata.chunk_block, &need_insert, chunk_info->scaled) < 0)
+		    HGOTO_ERROR(H5E_DATASET, H5E_CANTINSERT, FAIL, "unable to insert/resize chunk on chunk level")
+
+                /* Make sure the address of the chunk is returned. */
+                if(!H5F_addr_defined(udata.chunk_block.offset))
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "chunk address isn't defined")
+
+                /* Cache the new chunk information */
+                H5D__chunk_cinfo_cache_update(&io_info->dset->shared->cache.chunk.last, &udata);
+            } /* end if */
+
+            /* Set up the storage address information for this chunk */
+            ctg_store.contig.dset_addr = udata.chunk_block.offset;
+
+            /* No chunk cached */
+            chunk = NULL;
+
+            /* Point I/O info at temporary I/O info for this chunk */
+            chk_io_info = &ctg_io_info;
+        } /* end else */
+
+        /* Perform the actual write operation */
+        if((io_info->io_ops.single_write)(chk_io_info, type_info,
+                (hsize_t)chunk_info->chunk_points, chunk_info->fspace, chunk_info->mspace) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "chunked write failed")
+
+	/* Release the cache lock on the chunk, or insert chunk into index. */
+	if(chunk) {
+	    if(H5D__chunk_unlock(io_info, &udata, TRUE, chunk, dst_accessed_bytes) < 0)
 		HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to unlock raw data chunk")
 	} /* end if */
 	else {
@@ -2444,7 +3680,11 @@ static herr_t
 H5D__chunk_flush(H5D_t *dset)
 {
     H5D_rdcc_t *rdcc = &(dset->shared->cache.chunk);
-    H5D_rdcc_ent_t	*ent, *next;
+    H5D_rdcc_ent_t	*ent;
+    H5D_rdcc_ent_t	*one_ent;       /* Group of entries, without worker threads */
+    H5D_rdcc_ent_t	**ents = &one_ent;      /* Group of dirty entries to flush together */
+    size_t		max_nents = 1;  /* Max. # of entries in a group */
+    H5TP_t		*filter_pool = NULL;    /* Worker threads for encoding chunks */
     unsigned		nerrors = 0;    /* Count of any errors encountered when flushing chunks */
     herr_t ret_value = SUCCEED;         /* Return value */
 
@@ -2453,16 +3693,44 @@ H5D__chunk_flush(H5D_t *dset)
     /* Sanity check */
     HDassert(dset);
 
-    /* Loop over all entries in the chunk cache */
-    for(ent = rdcc->head; ent; ent = next) {
-	next = ent->next;
-        if(H5D__chunk_flush_entry(dset, ent, FALSE) < 0)
-            nerrors++;
-    } /* end for */
+    /* Check whether dirty chunks should be encoded on worker threads */
+    if(rdcc->head) {
+        if(H5D__chunk_get_filter_pool(dset, &filter_pool) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get filter thread pool")
+        if(filter_pool) {
+            max_nents = H5TP_get_nthreads(filter_pool) * H5D_CHUNK_ENCODE_BATCH_PER_THREAD;
+            if(NULL == (ents = (H5D_rdcc_ent_t **)H5MM_malloc(max_nents * sizeof(H5D_rdcc_ent_t *))))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk encode batch")
+        } /* end if */
+    } /* end if */
+
+    /* Loop over all dirty entries in the chunk cache, a group at a time */
+    ent = rdcc->head;
+    while(ent) {
+        size_t nents = 0;               /* # of entries in group */
+        size_t u;                       /* Local index variable */
+
+        for(; ent && nents < max_nents; ent = ent->next)
+            if(ent->dirty)
+                ents[nents++] = ent;
+
+        /* Encode the group's chunks on the worker threads */
+        if(filter_pool && nents > 1)
+            if(H5D__chunk_encode_batch(dset, filter_pool, ents, nents) < 0)
+                nerrors++;
+
+        /* Write the group's chunks, in cache order */
+        for(u = 0; u < nents; u++)
+            if(H5D__chunk_flush_entry(dset, ents[u], FALSE) < 0)
+                nerrors++;
+    } /* end while */
     if(nerrors)
 	HGOTO_ERROR(H5E_DATASET, H5E_CANTFLUSH, FAIL, "unable to flush one or more raw data chunks")
 
 done:
+    if(ents != &one_ent)
+        H5MM_xfree(ents);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_flush() */
 
@@ -2558,6 +3826,14 @@ H5D__chunk_dest(H5D_t *dset)
     if(nerrors)
         HDONE_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to flush one or more raw data chunks")
 
+    /* Release the 2Q policy's ghost entries */
+    while(rdcc->ghost_head)
+        H5D__chunk_cache_ghost_remove(rdcc, rdcc->ghost_head);
+
+    /* Stop using the file's shared budget */
+    if(rdcc->shared)
+        H5D__chunk_cache_unshare(dset);
+
     /* Release cache structures */
     if(rdcc->slot)
         rdcc->slot = H5FL_SEQ_FREE(H5D_rdcc_ent_ptr_t, rdcc->slot);
@@ -2716,114 +3992,319 @@ H5D__chunk_cinfo_cache_found(const H5D_chunk_cached_t *last, H5D_chunk_ud_t *uda
         udata->chunk_idx = last->chunk_idx;
         udata->filter_mask = last->filter_mask;
 
-        /* Indicate that the data was found */
-        HGOTO_DONE(TRUE)
-    } /* end if */
+        /* Indicate that the data was found */
+        HGOTO_DONE(TRUE)
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5D__chunk_cinfo_cache_found() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_create
+ *
+ * Purpose:	Creates a new chunked storage index and initializes the
+ *		layout information with information about the storage.  The
+ *		layout info should be immediately written to the object header.
+ *
+ * Return:	Non-negative on success (with the layout information initialized
+ *		and ready to write to an object header). Negative on failure.
+ *
+ * Programmer:	Quincey Koziol
+ *		Thursday, May 22, 2008
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5D__chunk_create(const H5D_t *dset /*in,out*/)
+{
+    H5D_chk_idx_info_t idx_info;        /* Chunked index info */
+    H5O_storage_chunk_t *sc = &(dset->shared->layout.storage.u.chunk);
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check args */
+    HDassert(dset);
+    HDassert(H5D_CHUNKED == dset->shared->layout.type);
+    HDassert(dset->shared->layout.u.chunk.ndims > 0 && dset->shared->layout.u.chunk.ndims <= H5O_LAYOUT_NDIMS);
+    H5D_CHUNK_STORAGE_INDEX_CHK(sc);
+
+#ifndef NDEBUG
+{
+    unsigned u;                         /* Local index variable */
+
+    for(u = 0; u < dset->shared->layout.u.chunk.ndims; u++)
+	HDassert(dset->shared->layout.u.chunk.dim[u] > 0);
+}
+#endif
+
+    /* Compose chunked index info struct */
+    idx_info.f = dset->oloc.file;
+    idx_info.pline = &dset->shared->dcpl_cache.pline;
+    idx_info.layout = &dset->shared->layout.u.chunk;
+    idx_info.storage = &dset->shared->layout.storage.u.chunk;
+
+    /* Create the index for the chunks */
+    if((dset->shared->layout.storage.u.chunk.ops->create)(&idx_info) < 0)
+	HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't create chunk index")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_create() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_hash_val
+ *
+ * Purpose:	To calculate an index based on the dataset's scaled coordinates and
+ *		sizes of the faster dimensions.
+ *
+ *		For the 2Q policy, it's the chunk's "home" slot in the
+ *		policy's index instead, which doesn't depend on the dataset's
+ *		dimensions.
+ *
+ * Return:	Hash value index
+ *
+ * Programmer:	Vailin Choi; Nov 2014
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+H5D__chunk_hash_val(const H5D_shared_t *shared, const hsize_t *scaled)
+{
+    hsize_t val;        /* Intermediate value */
+    unsigned ndims = shared->ndims;      /* Rank of dataset */
+    unsigned ret = 0;   /* Value to return */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Sanity check */
+    HDassert(shared);
+    HDassert(scaled);
+
+    /* Hash all the coordinates into the 2Q policy's index, which has a
+     *  power of two number of slots
+     */
+    if(H5D_CHUNK_CACHE_POLICY_2Q == shared->cache.chunk.policy)
+        ret = (unsigned)(H5_checksum_lookup3(scaled, ndims * sizeof(hsize_t), 0)
+                & (shared->cache.chunk.nslots - 1));
+    else {
+        /* If the fastest changing dimension doesn't have enough entropy, use
+         *  other dimensions too
+         */
+        if(ndims > 1 && shared->cache.chunk.scaled_dims[ndims - 1] <= shared->cache.chunk.nslots) {
+            unsigned u;          /* Local index variable */
+
+            val = scaled[0];
+            for(u = 1; u < ndims; u++) {
+                val <<= shared->cache.chunk.scaled_encode_bits[u];
+                val ^= scaled[u];
+            } /* end for */
+        } /* end if */
+        else
+            val = scaled[ndims - 1];
+
+        /* Modulo value against the number of array slots */
+        ret = (unsigned)(val % shared->cache.chunk.nslots);
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI(ret)
+} /* H5D__chunk_hash_val() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_find
+ *
+ * Purpose:	Find the slot in the dataset's chunk cache holding the entry
+ *		for a chunk.  With the 2Q policy, the entry may be a ghost
+ *		entry, and the slots following the chunk's home slot are
+ *		probed until an empty one.
+ *
+ * Return:	Index of the slot, or UINT_MAX if the chunk isn't there
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+H5D__chunk_cache_find(const H5D_shared_t *shared, const hsize_t *scaled)
+{
+    const H5D_rdcc_t *rdcc = &(shared->cache.chunk);   /* Dataset's chunk cache */
+    H5D_rdcc_ent_t *ent;        /* Cache entry */
+    unsigned idx;               /* Index of slot */
+    unsigned ret_value = UINT_MAX;      /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Sanity check */
+    HDassert(rdcc->nslots > 0);
+    HDassert(scaled);
+
+    idx = H5D__chunk_hash_val(shared, scaled);
+    while(NULL != (ent = rdcc->slot[idx])) {
+        if(ent != H5D_RDCC_TOMBSTONE) {
+            unsigned u;                 /* Counter */
+
+            /* Check if the cache entry is the correct chunk */
+            for(u = 0; u < shared->ndims; u++)
+                if(scaled[u] != ent->scaled[u])
+                    break;
+            if(u == shared->ndims) {
+                ret_value = idx;
+                break;
+            } /* end if */
+        } /* end if */
+
+        /* Only the 2Q policy's index stores chunks outside their home slot */
+        if(H5D_CHUNK_CACHE_POLICY_2Q != rdcc->policy)
+            break;
+        idx = (unsigned)((idx + 1) & (rdcc->nslots - 1));
+    } /* end while */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_find() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_rehash
+ *
+ * Purpose:	Rebuild the 2Q policy's index for the dataset's chunk cache
+ *		with NSLOTS slots, dropping the tombstones.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_rehash(const H5D_t *dset, size_t nslots)
+{
+    H5D_rdcc_t *rdcc = &(dset->shared->cache.chunk);   /* Dataset's chunk cache */
+    H5D_rdcc_ent_t **slot;      /* New slots */
+    H5D_rdcc_ent_t *ent;        /* Cache entry */
+    unsigned u;                 /* Local index variable */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy);
+    HDassert(nslots > 0 && 0 == (nslots & (nslots - 1)));
+    HDassert(nslots <= UINT_MAX);
+    HDassert(!rdcc->tmp_head);
+
+    if(NULL == (slot = H5FL_SEQ_CALLOC(H5D_rdcc_ent_ptr_t, nslots)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk cache index")
+    rdcc->slot = H5FL_SEQ_FREE(H5D_rdcc_ent_ptr_t, rdcc->slot);
+    rdcc->slot = slot;
+    rdcc->nslots = nslots;
+    rdcc->nslots_full = 0;
+
+    /* Re-insert the cached chunks, then the ghost entries */
+    for(u = 0; u < 2; u++)
+        for(ent = (u ? rdcc->ghost_head : rdcc->head); ent; ent = ent->next) {
+            unsigned idx = H5D__chunk_hash_val(dset->shared, ent->scaled);
+
+            while(slot[idx])
+                idx = (unsigned)((idx + 1) & (nslots - 1));
+            slot[idx] = ent;
+            ent->idx = idx;
+            rdcc->nslots_full++;
+        } /* end for */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* H5D__chunk_cinfo_cache_found() */
+} /* end H5D__chunk_cache_rehash() */
+
 
-
 /*-------------------------------------------------------------------------
- * Function:	H5D__chunk_create
+ * Function:	H5D__chunk_cache_new_slot
  *
- * Purpose:	Creates a new chunked storage index and initializes the
- *		layout information with information about the storage.  The
- *		layout info should be immediately written to the object header.
- *
- * Return:	Non-negative on success (with the layout information initialized
- *		and ready to write to an object header). Negative on failure.
+ * Purpose:	Find a slot in the 2Q policy's index for a chunk which isn't
+ *		in it, growing the index first if it's getting full.
  *
- * Programmer:	Quincey Koziol
- *		Thursday, May 22, 2008
+ * Return:	Non-negative on success/Negative on failure
  *
  *-------------------------------------------------------------------------
  */
-herr_t
-H5D__chunk_create(const H5D_t *dset /*in,out*/)
-{
-    H5D_chk_idx_info_t idx_info;        /* Chunked index info */
-    H5O_storage_chunk_t *sc = &(dset->shared->layout.storage.u.chunk);
-    herr_t ret_value = SUCCEED;         /* Return value */
-
-    FUNC_ENTER_PACKAGE
-
-    /* Check args */
-    HDassert(dset);
-    HDassert(H5D_CHUNKED == dset->shared->layout.type);
-    HDassert(dset->shared->layout.u.chunk.ndims > 0 && dset->shared->layout.u.chunk.ndims <= H5O_LAYOUT_NDIMS);
-    H5D_CHUNK_STORAGE_INDEX_CHK(sc);
-
-#ifndef NDEBUG
+static herr_t
+H5D__chunk_cache_new_slot(const H5D_t *dset, const hsize_t *scaled, unsigned *idx)
 {
-    unsigned u;                         /* Local index variable */
+    H5D_rdcc_t *rdcc = &(dset->shared->cache.chunk);   /* Dataset's chunk cache */
+    unsigned u;                 /* Index of slot */
+    herr_t ret_value = SUCCEED; /* Return value */
 
-    for(u = 0; u < dset->shared->layout.u.chunk.ndims; u++)
-	HDassert(dset->shared->layout.u.chunk.dim[u] > 0);
-}
-#endif
+    FUNC_ENTER_STATIC
 
-    /* Compose chunked index info struct */
-    idx_info.f = dset->oloc.file;
-    idx_info.pline = &dset->shared->dcpl_cache.pline;
-    idx_info.layout = &dset->shared->layout.u.chunk;
-    idx_info.storage = &dset->shared->layout.storage.u.chunk;
+    /* Sanity checks */
+    HDassert(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy);
+    HDassert(UINT_MAX == H5D__chunk_cache_find(dset->shared, scaled));
+    HDassert(idx);
+
+    /* Keep the index at most 3/4 full, tombstones included.  Rebuild it
+     * when it gets there, at a size which leaves it at most half full. */
+    if((rdcc->nslots_full + 1) * 4 > rdcc->nslots * 3) {
+        size_t nslots = rdcc->nslots;   /* New # of slots */
+
+        while(((size_t)rdcc->nused + rdcc->nghosts + 1) * 2 > nslots)
+            nslots *= 2;
+        if(nslots > UINT_MAX)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTRESIZE, FAIL, "chunk cache index is too large")
+        if(H5D__chunk_cache_rehash(dset, nslots) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTRESIZE, FAIL, "can't rebuild chunk cache index")
+    } /* end if */
 
-    /* Create the index for the chunks */
-    if((dset->shared->layout.storage.u.chunk.ops->create)(&idx_info) < 0)
-	HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't create chunk index")
+    /* Use the first empty slot or tombstone from the chunk's home slot */
+    u = H5D__chunk_hash_val(dset->shared, scaled);
+    while(rdcc->slot[u] && rdcc->slot[u] != H5D_RDCC_TOMBSTONE)
+        u = (unsigned)((u + 1) & (rdcc->nslots - 1));
+    if(NULL == rdcc->slot[u])
+        rdcc->nslots_full++;
+    *idx = u;
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5D__chunk_create() */
+} /* end H5D__chunk_cache_new_slot() */
+
 
-
 /*-------------------------------------------------------------------------
- * Function:	H5D__chunk_hash_val
- *
- * Purpose:	To calculate an index based on the dataset's scaled coordinates and
- *		sizes of the faster dimensions.
+ * Function:	H5D__chunk_cache_ghost_remove
  *
- * Return:	Hash value index
+ * Purpose:	Remove a ghost entry from the 2Q policy's index.
  *
- * Programmer:	Vailin Choi; Nov 2014
+ * Return:	void
  *
  *-------------------------------------------------------------------------
  */
-static unsigned
-H5D__chunk_hash_val(const H5D_shared_t *shared, const hsize_t *scaled)
+static void
+H5D__chunk_cache_ghost_remove(H5D_rdcc_t *rdcc, H5D_rdcc_ent_t *ghost)
 {
-    hsize_t val;        /* Intermediate value */
-    unsigned ndims = shared->ndims;      /* Rank of dataset */
-    unsigned ret = 0;   /* Value to return */
-
     FUNC_ENTER_STATIC_NOERR
 
-    /* Sanity check */
-    HDassert(shared);
-    HDassert(scaled);
+    /* Sanity checks */
+    HDassert(ghost);
+    HDassert(ghost->ghost);
+    HDassert(rdcc->slot[ghost->idx] == ghost);
+    HDassert(rdcc->nghosts > 0);
 
-    /* If the fastest changing dimension doesn't have enough entropy, use
-     *  other dimensions too
-     */
-    if(ndims > 1 && shared->cache.chunk.scaled_dims[ndims - 1] <= shared->cache.chunk.nslots) {
-        unsigned u;          /* Local index variable */
+    /* Leave a tombstone, so probing for other chunks continues past it */
+    rdcc->slot[ghost->idx] = H5D_RDCC_TOMBSTONE;
 
-        val = scaled[0];
-        for(u = 1; u < ndims; u++) {
-            val <<= shared->cache.chunk.scaled_encode_bits[u];
-            val ^= scaled[u];
-        } /* end for */
-    } /* end if */
+    /* Unlink from list of ghost entries */
+    if(ghost->prev)
+        ghost->prev->next = ghost->next;
+    else
+        rdcc->ghost_head = ghost->next;
+    if(ghost->next)
+        ghost->next->prev = ghost->prev;
     else
-        val = scaled[ndims - 1];
+        rdcc->ghost_tail = ghost->prev;
+    rdcc->nghosts--;
 
-    /* Modulo value against the number of array slots */
-    ret = (unsigned)(val % shared->cache.chunk.nslots);
+    /* Free */
+    ghost = H5FL_FREE(H5D_rdcc_ent_t, ghost);
 
-    FUNC_LEAVE_NOAPI(ret)
-} /* H5D__chunk_hash_val() */
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5D__chunk_cache_ghost_remove() */
 
 
 /*-------------------------------------------------------------------------
@@ -2868,26 +4349,13 @@ H5D__chunk_lookup(const H5D_t *dset, const hsize_t *scaled,
     udata->chunk_block.length = 0;
     udata->filter_mask = 0;
     udata->new_unfilt_chunk = FALSE;
+    udata->decoded_chunk = NULL;
 
-    /* Check for chunk in cache */
+    /* Check for chunk in cache (ghost entries don't count) */
     if(dset->shared->cache.chunk.nslots > 0) {
-        /* Determine the chunk's location in the hash table */
-        idx = H5D__chunk_hash_val(dset->shared, scaled);
-
-        /* Get the chunk cache entry for that location */
-        ent = dset->shared->cache.chunk.slot[idx];
-        if(ent) {
-            unsigned u;                  /* Counter */
-
-            /* Speculatively set the 'found' flag */
-            found = TRUE;
-
-            /* Verify that the cache entry is the correct chunk */
-            for(u = 0; u < dset->shared->ndims; u++)
-                if(scaled[u] != ent->scaled[u]) {
-                    found = FALSE;
-                    break;
-                } /* end if */
+        if(UINT_MAX != (idx = H5D__chunk_cache_find(dset->shared, scaled))) {
+            ent = dset->shared->cache.chunk.slot[idx];
+            found = !ent->ghost;
         } /* end if */
     } /* end if */
 
@@ -3028,42 +4496,59 @@ H5D__chunk_flush_entry(const H5D_t *dset, H5D_rdcc_ent_t *ent, hbool_t reset)
         /* Should the chunk be filtered before writing it to disk? */
         if(dset->shared->dcpl_cache.pline.nused
                 && !(ent->edge_chunk_state & H5D_RDCC_DISABLE_FILTERS)) {
-            H5Z_EDC_t err_detect;       /* Error detection info */
-            H5Z_cb_t filter_cb;         /* I/O filter callback function */
-            size_t alloc = udata.chunk_block.length;        /* Bytes allocated for BUF	*/
             size_t nbytes;              /* Chunk size (in bytes) */
 
-            /* Retrieve filter settings from API context */
-            if(H5CX_get_err_detect(&err_detect) < 0)
-                HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get error detection info")
-            if(H5CX_get_filter_cb(&filter_cb) < 0)
-                HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function")
-
-            if(!reset) {
+            if(ent->enc_chunk) {
                 /*
-                 * Copy the chunk to a new buffer before running it through
-                 * the pipeline because we'll want to save the original buffer
-                 * for later.
+                 * The filters were already applied to a copy of the chunk
+                 * on a worker thread, so just take that.  (As below, when
+                 * resetting the entry must be reset even if the write
+                 * fails.)
                  */
-                if(NULL == (buf = H5MM_malloc(alloc)))
-                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for pipeline")
-                HDmemcpy(buf, ent->chunk, alloc);
+                buf = ent->enc_chunk;
+                nbytes = ent->enc_nbytes;
+                udata.filter_mask = ent->enc_filter_mask;
+                ent->enc_chunk = NULL;
+                if(reset)
+                    point_of_no_return = TRUE;
             } /* end if */
             else {
-                /*
-                 * If we are resetting and something goes wrong after this
-                 * point then it's too late to recover because we may have
-                 * destroyed the original data by calling H5Z_pipeline().
-                 * The only safe option is to continue with the reset
-                 * even if we can't write the data to disk.
-                 */
-                point_of_no_return = TRUE;
-                ent->chunk = NULL;
+                H5Z_EDC_t err_detect;       /* Error detection info */
+                H5Z_cb_t filter_cb;         /* I/O filter callback function */
+                size_t alloc = udata.chunk_block.length;        /* Bytes allocated for BUF	*/
+
+                /* Retrieve filter settings from API context */
+                if(H5CX_get_err_detect(&err_detect) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get error detection info")
+                if(H5CX_get_filter_cb(&filter_cb) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get I/O filter callback function")
+
+                if(!reset) {
+                    /*
+                     * Copy the chunk to a new buffer before running it through
+                     * the pipeline because we'll want to save the original buffer
+                     * for later.
+                     */
+                    if(NULL == (buf = H5Z_buf_malloc(alloc)))
+                        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for pipeline")
+                    HDmemcpy(buf, ent->chunk, alloc);
+                } /* end if */
+                else {
+                    /*
+                     * If we are resetting and something goes wrong after this
+                     * point then it's too late to recover because we may have
+                     * destroyed the original data by calling H5Z_pipeline().
+                     * The only safe option is to continue with the reset
+                     * even if we can't write the data to disk.
+                     */
+                    point_of_no_return = TRUE;
+                    ent->chunk = NULL;
+                } /* end else */
+                H5_CHECKED_ASSIGN(nbytes, size_t, udata.chunk_block.length, hsize_t);
+                if(H5Z_pipeline_lend(&(dset->shared->dcpl_cache.pline), 0, &(udata.filter_mask),
+                        err_detect, filter_cb, &nbytes, &alloc, &buf, NULL, (size_t)0) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "output pipeline failed")
             } /* end else */
-            H5_CHECKED_ASSIGN(nbytes, size_t, udata.chunk_block.length, hsize_t);
-            if(H5Z_pipeline(&(dset->shared->dcpl_cache.pline), 0, &(udata.filter_mask),
-                    err_detect, filter_cb, &nbytes, &alloc, &buf) < 0)
-                HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "output pipeline failed")
 #if H5_SIZEOF_SIZE_T > 4
             /* Check for the chunk expanding too much to encode in a 32-bit value */
             if(nbytes > ((size_t)0xffffffff))
@@ -3151,7 +4636,11 @@ H5D__chunk_flush_entry(const H5D_t *dset, H5D_rdcc_ent_t *ent, hbool_t reset)
 done:
     /* Free the temp buffer only if it's different than the entry chunk */
     if(buf != ent->chunk)
-        H5MM_xfree(buf);
+        H5Z_buf_free(buf);
+
+    /* Drop an encoded chunk which wasn't used */
+    if(ent->enc_chunk)
+        ent->enc_chunk = (uint8_t *)H5Z_buf_free(ent->enc_chunk);
 
     /*
      * If we reached the point of no return then we have no choice but to
@@ -3187,6 +4676,7 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
     hbool_t flush)
 {
     H5D_rdcc_t *rdcc = &(dset->shared->cache.chunk);
+    hbool_t     ghost = FALSE;          /* Whether the entry becomes a ghost entry */
     herr_t      ret_value = SUCCEED;       /* Return value */
 
     FUNC_ENTER_STATIC
@@ -3195,6 +4685,7 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
     HDassert(dset);
     HDassert(ent);
     HDassert(!ent->locked);
+    HDassert(!ent->ghost);
     HDassert(ent->idx < rdcc->nslots);
 
     if(flush) {
@@ -3211,6 +4702,8 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
     } /* end else */
 
     /* Unlink from list */
+    if(rdcc->hot_head == ent)
+        rdcc->hot_head = ent->next;
     if(ent->prev)
         ent->prev->next = ent->next;
     else
@@ -3220,6 +4713,8 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
     else
         rdcc->tail = ent->prev;
     ent->prev = ent->next = NULL;
+    if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy && !ent->hot)
+        rdcc->nbytes_cold -= dset->shared->layout.u.chunk.size;
 
     /* Unlink from temporary list */
     if(ent->tmp_prev) {
@@ -3231,30 +4726,176 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
         } /* end if */
         ent->tmp_prev = NULL;
     } /* end if */
+    else if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy) {
+        /* A chunk preempted from the 2Q policy's FIFO queue is remembered
+         * by turning its entry into a ghost entry, in the same slot.
+         * Otherwise, leave a tombstone so probing for other chunks
+         * continues past the slot. */
+        if(ent->evicting && !ent->hot)
+            ghost = TRUE;
+        else
+            rdcc->slot[ent->idx] = H5D_RDCC_TOMBSTONE;
+    } /* end if */
     else
         /* Only clear hash table slot if the chunk was not on the temporary list
          */
         rdcc->slot[ent->idx] = NULL;
 
     /* Remove from cache */
-    HDassert(rdcc->slot[ent->idx] != ent);
-    ent->idx = UINT_MAX;
+    HDassert(ghost || rdcc->slot[ent->idx] != ent);
     rdcc->nbytes_used -= dset->shared->layout.u.chunk.size;
+    if(rdcc->shared)
+        rdcc->shared->nbytes_used -= dset->shared->layout.u.chunk.size;
     --rdcc->nused;
 
-    /* Free */
-    ent = H5FL_FREE(H5D_rdcc_ent_t, ent);
+    if(ghost) {
+        size_t max_nghosts;     /* Max. # of ghost entries */
+
+        /* Release the chunk, if flushing failed before doing so */
+        if(ent->chunk != NULL)
+            ent->chunk = (uint8_t *)H5D__chunk_mem_xfree(ent->chunk,
+                    ((ent->edge_chunk_state & H5D_RDCC_DISABLE_FILTERS) ? NULL
+                    : &(dset->shared->dcpl_cache.pline)));
+        ent->evicting = FALSE;
+        ent->ghost = TRUE;
+
+        /* Add it to the list of ghost entries, dropping the oldest one if
+         * there are too many */
+        if(rdcc->ghost_tail) {
+            rdcc->ghost_tail->next = ent;
+            ent->prev = rdcc->ghost_tail;
+            rdcc->ghost_tail = ent;
+        } /* end if */
+        else
+            rdcc->ghost_head = rdcc->ghost_tail = ent;
+        rdcc->nghosts++;
+        max_nghosts = MAX(1, (rdcc->nbytes_max / dset->shared->layout.u.chunk.size) / H5D_CHUNK_CACHE_2Q_GHOST_DIV);
+        if(rdcc->nghosts > max_nghosts)
+            H5D__chunk_cache_ghost_remove(rdcc, rdcc->ghost_head);
+    } /* end if */
+    else {
+        /* Free */
+        ent->idx = UINT_MAX;
+        ent = H5FL_FREE(H5D_rdcc_ent_t, ent);
+    } /* end else */
 
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_cache_evict() */
 
 
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_next_live
+ *
+ * Purpose:	Skip over entries already selected for preemption by
+ *		H5D__chunk_cache_prune(), starting with ENT.
+ *
+ * Return:	The first entry at or after ENT which isn't being
+ *		preempted, or NULL.
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5D_rdcc_ent_t *
+H5D__chunk_cache_next_live(H5D_rdcc_ent_t *ent)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    while(ent && ent->evicting)
+        ent = ent->next;
+
+    FUNC_LEAVE_NOAPI(ent)
+} /* end H5D__chunk_cache_next_live() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_evict_group
+ *
+ * Purpose:	Preempt the NENTS entries in ENTS from the cache, in order,
+ *		flushing them to disk if necessary.  When TP isn't NULL,
+ *		the entries' dirty chunks are encoded together on its
+ *		worker threads first.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_evict_group(const H5D_t *dset, H5TP_t *tp,
+    H5D_rdcc_ent_t **ents, size_t nents)
+{
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Encode the dirty chunks on the worker threads */
+    if(tp && nents > 1)
+        if(H5D__chunk_encode_batch(dset, tp, ents, nents) < 0)
+            HDONE_ERROR(H5E_DATASET, H5E_CANTFILTER, FAIL, "can't encode chunks")
+
+    /* Preempt the entries, even if encoding failed */
+    for(u = 0; u < nents; u++)
+        if(H5D__chunk_cache_evict(dset, ents[u], TRUE) < 0)
+            HDONE_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to preempt raw data cache entry")
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_evict_group() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_select_2q
+ *
+ * Purpose:	Select the next entry to preempt from a cache using the 2Q
+ *		policy: the oldest chunk in the FIFO queue if the queue is
+ *		using more than its share of the cache, which is NBYTES_COLD
+ *		bytes after the entries already selected are gone, or else
+ *		the least recently used chunk in the LRU queue.  When the
+ *		queue chosen has nothing to preempt, the other one is used.
+ *
+ * Return:	The entry to preempt, or NULL if all the entries are locked
+ *		or already selected.
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5D_rdcc_ent_t *
+H5D__chunk_cache_select_2q(const H5D_rdcc_t *rdcc, size_t nbytes_cold)
+{
+    H5D_rdcc_ent_t *cold;       /* Oldest chunk in the FIFO queue which can be preempted */
+    H5D_rdcc_ent_t *hot;        /* LRU chunk in the LRU queue which can be preempted */
+    H5D_rdcc_ent_t *ret_value = NULL;   /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Sanity check */
+    HDassert(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy);
+
+    for(cold = rdcc->head; cold != rdcc->hot_head && (cold->locked || cold->evicting); cold = cold->next)
+        ;
+    if(cold == rdcc->hot_head)
+        cold = NULL;
+    for(hot = rdcc->hot_head; hot && (hot->locked || hot->evicting); hot = hot->next)
+        ;
+
+    if(cold && (NULL == hot || nbytes_cold > rdcc->nbytes_max / H5D_CHUNK_CACHE_2Q_FIFO_DIV))
+        ret_value = cold;
+    else
+        ret_value = hot;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_select_2q() */
+
+
 /*-------------------------------------------------------------------------
  * Function:	H5D__chunk_cache_prune
  *
  * Purpose:	Prune the cache by preempting some things until the cache has
- *		room for something which is SIZE bytes.  Only unlocked
- *		entries are considered for preemption.
+ *		room for something which is SIZE bytes, without going over
+ *		TOTAL bytes.  Only unlocked entries are considered for
+ *		preemption, in the order of the cache's replacement policy.
+ *
+ *		When the dataset's filters run on worker threads, entries
+ *		are selected a group at a time and the group's dirty
+ *		chunks are encoded together before the entries are
+ *		preempted, in the order they were selected.
  *
  * Return:	Non-negative on success/Negative on failure
  *
@@ -3264,97 +4905,242 @@ H5D__chunk_cache_evict(const H5D_t *dset, H5D_rdcc_ent_t *ent,
  *-------------------------------------------------------------------------
  */
 static herr_t
-H5D__chunk_cache_prune(const H5D_t *dset, size_t size)
+H5D__chunk_cache_prune(const H5D_t *dset, size_t size, size_t total)
 {
     const H5D_rdcc_t	*rdcc = &(dset->shared->cache.chunk);
-    size_t		total = rdcc->nbytes_max;
+    size_t		nbytes_used = rdcc->nbytes_used; /*bytes used once victims are gone */
     const int		nmeth = 2;	/*number of methods		*/
     int		        w[1];		/*weighting as an interval	*/
     H5D_rdcc_ent_t	*p[2], *cur;	/*list pointers			*/
     H5D_rdcc_ent_t	*n[2];		/*list next pointers		*/
+    H5D_rdcc_ent_t	*one_victim;	/*group of victims, without worker threads */
+    H5D_rdcc_ent_t	**victims = &one_victim;	/*entries selected for preemption */
+    size_t		max_nvictims = 1;	/*max. # of victims in a group */
+    size_t		nvictims = 0;	/*# of victims in current group	*/
+    H5TP_t		*filter_pool = NULL;	/*worker threads for encoding chunks */
     int		nerrors = 0;            /* Accumulated error count during preemptions */
     herr_t      ret_value = SUCCEED;       /* Return value */
 
     FUNC_ENTER_STATIC
 
-    /*
-     * Preemption is accomplished by having multiple pointers (currently two)
-     * slide down the list beginning at the head. Pointer p(N+1) will start
-     * traversing the list when pointer pN reaches wN percent of the original
-     * list.  In other words, preemption method N gets to consider entries in
-     * approximate least recently used order w0 percent before method N+1
-     * where 100% means tha method N will run to completion before method N+1
-     * begins.  The pointers participating in the list traversal are each
-     * given a chance at preemption before any of the pointers are advanced.
-     */
-    w[0] = (int)(rdcc->nused * rdcc->w0);
-    p[0] = rdcc->head;
-    p[1] = NULL;
-
-    while((p[0] || p[1]) && (rdcc->nbytes_used + size) > total) {
-        int i;          /* Local index variable */
-
-	/* Introduce new pointers */
-	for(i = 0; i < nmeth - 1; i++)
-            if(0 == w[i])
-                p[i + 1] = rdcc->head;
-
-	/* Compute next value for each pointer */
-	for(i = 0; i < nmeth; i++)
-            n[i] = p[i] ? p[i]->next : NULL;
-
-	/* Give each method a chance */
-	for(i = 0; i < nmeth && (rdcc->nbytes_used + size) > total; i++) {
-	    if(0 == i && p[0] && !p[0]->locked &&
-                    ((0 == p[0]->rd_count && 0 == p[0]->wr_count) ||
-                     (0 == p[0]->rd_count && dset->shared->layout.u.chunk.size == p[0]->wr_count) ||
-                     (dset->shared->layout.u.chunk.size == p[0]->rd_count && 0 == p[0]->wr_count))) {
-		/*
-		 * Method 0: Preempt entries that have been completely written
-		 * and/or completely read but not entries that are partially
-		 * written or partially read.
-		 */
-		cur = p[0];
-	    } else if(1 == i && p[1] && !p[1]->locked) {
-		/*
-		 * Method 1: Preempt the entry without regard to
-		 * considerations other than being locked.  This is the last
-		 * resort preemption.
-		 */
-		cur = p[1];
-	    } else {
-		/* Nothing to preempt at this point */
-		cur = NULL;
-	    }
-
-	    if(cur) {
-                int j;          /* Local index variable */
-
-		for(j = 0; j < nmeth; j++) {
-		    if(p[j] == cur)
-                        p[j] = NULL;
-		    if(n[j] == cur)
-                        n[j] = cur->next;
-		} /* end for */
-		if(H5D__chunk_cache_evict(dset, cur, TRUE) < 0)
+    /* Check whether dirty chunks should be encoded on worker threads */
+    if((nbytes_used + size) > total) {
+        if(H5D__chunk_get_filter_pool(dset, &filter_pool) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get filter thread pool")
+        if(filter_pool) {
+            max_nvictims = H5TP_get_nthreads(filter_pool) * H5D_CHUNK_ENCODE_BATCH_PER_THREAD;
+            if(NULL == (victims = (H5D_rdcc_ent_t **)H5MM_malloc(max_nvictims * sizeof(H5D_rdcc_ent_t *))))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed for chunk encode batch")
+        } /* end if */
+    } /* end if */
+
+    if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy) {
+        size_t nbytes_cold = rdcc->nbytes_cold; /* FIFO queue's bytes once victims are gone */
+
+        /*
+         * Preempt chunks from the FIFO queue while it's using more than its
+         * share of the cache, and from the LRU queue otherwise, in the
+         * queues' orders.
+         */
+        while((nbytes_used + size) > total && NULL != (cur = H5D__chunk_cache_select_2q(rdcc, nbytes_cold))) {
+            if(!cur->hot)
+                nbytes_cold -= dset->shared->layout.u.chunk.size;
+            cur->evicting = TRUE;
+            victims[nvictims++] = cur;
+            nbytes_used -= dset->shared->layout.u.chunk.size;
+
+            /* Preempt the victims once there's a full group of them */
+            if(nvictims == max_nvictims) {
+                if(H5D__chunk_cache_evict_group(dset, filter_pool, victims, nvictims) < 0)
                     nerrors++;
-	    } /* end if */
-	} /* end for */
+                nvictims = 0;
+            } /* end if */
+        } /* end while */
+    } /* end if */
+    else {
+        /*
+         * Preemption is accomplished by having multiple pointers (currently two)
+         * slide down the list beginning at the head. Pointer p(N+1) will start
+         * traversing the list when pointer pN reaches wN percent of the original
+         * list.  In other words, preemption method N gets to consider entries in
+         * approximate least recently used order w0 percent before method N+1
+         * where 100% means tha method N will run to completion before method N+1
+         * begins.  The pointers participating in the list traversal are each
+         * given a chance at preemption before any of the pointers are advanced.
+         *
+         * Entries which have been selected but not yet preempted are marked as
+         * "evicting" and skipped, as if they were already gone.
+         */
+        w[0] = (int)(rdcc->nused * rdcc->w0);
+        p[0] = rdcc->head;
+        p[1] = NULL;
+
+        while((p[0] || p[1]) && (nbytes_used + size) > total) {
+            int i;          /* Local index variable */
+
+            /* Introduce new pointers */
+            for(i = 0; i < nmeth - 1; i++)
+                if(0 == w[i])
+                    p[i + 1] = H5D__chunk_cache_next_live(rdcc->head);
+
+            /* Compute next value for each pointer */
+            for(i = 0; i < nmeth; i++)
+                n[i] = p[i] ? H5D__chunk_cache_next_live(p[i]->next) : NULL;
+
+            /* Give each method a chance */
+            for(i = 0; i < nmeth && (nbytes_used + size) > total; i++) {
+                if(0 == i && p[0] && !p[0]->locked &&
+                        ((0 == p[0]->rd_count && 0 == p[0]->wr_count) ||
+                         (0 == p[0]->rd_count && dset->shared->layout.u.chunk.size == p[0]->wr_count) ||
+                         (dset->shared->layout.u.chunk.size == p[0]->rd_count && 0 == p[0]->wr_count))) {
+                    /*
+                     * Method 0: Preempt entries that have been completely written
+                     * and/or completely read but not entries that are partially
+                     * written or partially read.
+                     */
+                    cur = p[0];
+                } else if(1 == i && p[1] && !p[1]->locked) {
+                    /*
+                     * Method 1: Preempt the entry without regard to
+                     * considerations other than being locked.  This is the last
+                     * resort preemption.
+                     */
+                    cur = p[1];
+                } else {
+                    /* Nothing to preempt at this point */
+                    cur = NULL;
+                }
+
+                if(cur) {
+                    int j;          /* Local index variable */
+
+                    for(j = 0; j < nmeth; j++) {
+                        if(p[j] == cur)
+                            p[j] = NULL;
+                        if(n[j] == cur)
+                            n[j] = H5D__chunk_cache_next_live(cur->next);
+                    } /* end for */
+                    cur->evicting = TRUE;
+                    victims[nvictims++] = cur;
+                    nbytes_used -= dset->shared->layout.u.chunk.size;
+
+                    /* Preempt the victims once there's a full group of them */
+                    if(nvictims == max_nvictims) {
+                        if(H5D__chunk_cache_evict_group(dset, filter_pool, victims, nvictims) < 0)
+                            nerrors++;
+                        nvictims = 0;
+                    } /* end if */
+                } /* end if */
+            } /* end for */
 
-	/* Advance pointers */
-	for(i = 0; i < nmeth; i++)
-            p[i] = n[i];
-	for(i = 0; i < nmeth - 1; i++)
-            w[i] -= 1;
-    } /* end while */
+            /* Advance pointers */
+            for(i = 0; i < nmeth; i++)
+                p[i] = n[i];
+            for(i = 0; i < nmeth - 1; i++)
+                w[i] -= 1;
+        } /* end while */
+    } /* end else */
+
+    /* Preempt the last group of victims */
+    if(nvictims > 0)
+        if(H5D__chunk_cache_evict_group(dset, filter_pool, victims, nvictims) < 0)
+            nerrors++;
 
     if(nerrors)
 	HGOTO_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to preempt one or more raw data cache entry")
 
 done:
+    if(victims != &one_victim)
+        H5MM_xfree(victims);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_cache_prune() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__chunk_cache_prune_shared
+ *
+ * Purpose:	Preempt chunks from the caches using the file's shared
+ *		budget until there's room in it for something which is
+ *		SIZE bytes, cached by DSET.
+ *
+ *		To keep things fair, chunks are preempted from whichever
+ *		dataset is caching the most at the time (DSET itself on a tie),
+ *		using that dataset's own preemption policy.  A dataset which
+ *		can't give up enough, because its chunks are locked or no
+ *		handle for it is available, is passed over.  Another
+ *		dataset's dirty chunks are flushed as when it's closed.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__chunk_cache_prune_shared(const H5D_t *dset, size_t size)
+{
+    H5D_rdcc_shared_t	*shared = dset->shared->cache.chunk.shared;
+    int		nerrors = 0;            /* Accumulated error count during preemptions */
+    herr_t      ret_value = SUCCEED;       /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(shared);
+
+    /* Start a new pass */
+    shared->gen++;
+
+    while((shared->nbytes_used + size) > shared->nbytes_max) {
+        H5D_rdcc_t *victim = NULL;      /* Cache to preempt chunks from */
+        H5D_rdcc_t *rdcc;               /* Cache being considered */
+        size_t need = (shared->nbytes_used + size) - shared->nbytes_max;   /* Bytes to preempt */
+        size_t nbytes_used;             /* Victim's bytes cached, beforehand */
+        int nused;                      /* Victim's # of chunks cached, beforehand */
+
+        /* Pick the dataset caching the most, preferring this dataset
+         * on a tie */
+        for(rdcc = shared->head; rdcc; rdcc = rdcc->shared_next)
+            if(rdcc->dset && rdcc->nbytes_used > 0 && rdcc->shared_gen != shared->gen
+                    && (NULL == victim || rdcc->nbytes_used > victim->nbytes_used
+                        || (rdcc->nbytes_used == victim->nbytes_used && rdcc == &dset->shared->cache.chunk)))
+                victim = rdcc;
+        if(NULL == victim)
+            break;
+
+        /* Preempt as much as is needed, or as much as the victim has */
+        nbytes_used = victim->nbytes_used;
+        nused = victim->nused;
+        if(victim == &dset->shared->cache.chunk) {
+            if(H5D__chunk_cache_prune(victim->dset, MIN(need, nbytes_used), nbytes_used) < 0)
+                nerrors++;
+        } /* end if */
+        else {
+            /* Flush another dataset's chunks the way closing it would: in
+             * a context of its own, with the default transfer properties,
+             * and tagged with its object header address */
+            if(H5CX_push() < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set API context")
+            H5_BEGIN_TAG(victim->dset->oloc.addr)
+            if(H5D__chunk_cache_prune(victim->dset, MIN(need, nbytes_used), nbytes_used) < 0)
+                nerrors++;
+            H5_END_TAG
+            if(H5CX_pop() < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTRESET, FAIL, "can't reset API context")
+        } /* end else */
+        victim->stats.nshared += (unsigned)(nused - victim->nused);
+
+        /* Don't try the victim again if it couldn't give up enough */
+        if((nbytes_used - victim->nbytes_used) < need)
+            victim->shared_gen = shared->gen;
+    } /* end while */
+
+    if(nerrors)
+	HGOTO_ERROR(H5E_IO, H5E_CANTFLUSH, FAIL, "unable to preempt one or more raw data cache entry")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__chunk_cache_prune_shared() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5D__chunk_lock
@@ -3398,6 +5184,7 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
     H5D_rdcc_ent_t	*ent;		        /*cache entry		*/
     size_t		chunk_size;		/*size of a chunk	*/
     hbool_t             disable_filters = FALSE; /* Whether to disable filters (when adding to cache) */
+    void		*decoded_chunk = udata->decoded_chunk; /* Chunk already read & decoded by caller */
     void		*chunk = NULL;		/*the file chunk	*/
     void		*ret_value = NULL;	/* Return value         */
 
@@ -3410,6 +5197,11 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
     HDassert(dset);
     HDassert(!(udata->new_unfilt_chunk && prev_unfilt_chunk));
     HDassert(!rdcc->tmp_head);
+    HDassert(!decoded_chunk || (UINT_MAX == udata->idx_hint && !relax
+            && !udata->new_unfilt_chunk && !prev_unfilt_chunk));
+
+    /* Take ownership of any decoded chunk passed in */
+    udata->decoded_chunk = NULL;
 
     /* Get the chunk's size */
     HDassert(layout->u.chunk.size > 0);
@@ -3499,12 +5291,32 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
             } /* end else */
         } /* end if */
 
+        if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy) {
+            /*
+             * With the 2Q policy, a chunk in the LRU queue moves to the end
+             * of the list, while a chunk in the FIFO queue stays where it
+             * is.
+             */
+            if(ent->hot && ent->next) {
+                if(rdcc->hot_head == ent)
+                    rdcc->hot_head = ent->next;
+                ent->next->prev = ent->prev;
+                if(ent->prev)
+                    ent->prev->next = ent->next;
+                else
+                    rdcc->head = ent->next;
+                rdcc->tail->next = ent;
+                ent->prev = rdcc->tail;
+                ent->next = NULL;
+                rdcc->tail = ent;
+            } /* end if */
+        } /* end if */
         /*
          * If the chunk is not at the beginning of the cache; move it backward
          * by one slot.  This is how we implement the LRU preemption
          * algorithm.
          */
-        if(ent->next) {
+        else if(ent->next) {
             if(ent->next->next)
                 ent->next->next->prev = ent;
             else
@@ -3582,8 +5394,16 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
              *      or an init if it isn't.
              */
 
+            /* Check if the chunk was already read & decoded */
+            if(decoded_chunk) {
+                chunk = decoded_chunk;
+                decoded_chunk = NULL;
+
+                /* Increment # of cache misses */
+                rdcc->stats.nmisses++;
+            } /* end if */
             /* Check if the chunk exists on disk */
-            if(H5F_addr_defined(chunk_addr)) {
+            else if(H5F_addr_defined(chunk_addr)) {
                 size_t my_chunk_alloc = chunk_alloc;	/* Allocated buffer size */
                 size_t buf_alloc = chunk_alloc;	        /* [Re-]allocated buffer size */
 
@@ -3597,6 +5417,8 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
                 if(old_pline && old_pline->nused) {
                     H5Z_EDC_t err_detect;       /* Error detection info */
                     H5Z_cb_t filter_cb;         /* I/O filter callback function */
+                    void *lent_chunk = NULL;    /* Buffer lent to the filters */
+                    herr_t status;              /* Status from pipeline */
 
                     /* Retrieve filter settings from API context */
                     if(H5CX_get_err_detect(&err_detect) < 0)
@@ -3604,8 +5426,18 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
                     if(H5CX_get_filter_cb(&filter_cb) < 0)
                         HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, NULL, "can't get I/O filter callback function")
 
-                    if(H5Z_pipeline(old_pline, H5Z_FLAG_REVERSE, &(udata->filter_mask),
-                            err_detect, filter_cb, &my_chunk_alloc, &buf_alloc, &chunk) < 0)
+                    /* Lend the chunk's buffer to the filters to uncompress
+                     * into (only deflate borrows it), unless the chunk is
+                     * about to lose its filters and be copied anyway */
+                    if(!udata->new_unfilt_chunk && H5Z_filter_in_pline(old_pline, H5Z_FILTER_DEFLATE) > 0)
+                        if(NULL == (lent_chunk = H5D__chunk_mem_alloc(chunk_size, old_pline)))
+                            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for raw data chunk")
+
+                    status = H5Z_pipeline_lend(old_pline, H5Z_FLAG_REVERSE, &(udata->filter_mask),
+                            err_detect, filter_cb, &my_chunk_alloc, &buf_alloc, &chunk, &lent_chunk, chunk_size);
+                    if(lent_chunk)
+                        lent_chunk = H5D__chunk_mem_xfree(lent_chunk, old_pline);
+                    if(status < 0)
                         HGOTO_ERROR(H5E_DATASET, H5E_CANTFILTER, NULL, "data pipeline read failed")
 
                     /* Reallocate chunk if necessary */
@@ -3671,19 +5503,51 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
 
         /* See if the chunk can be cached */
         if(rdcc->nslots > 0 && chunk_size <= rdcc->nbytes_max) {
-            /* Calculate the index */
-            udata->idx_hint = H5D__chunk_hash_val(io_info->dset->shared, udata->common.scaled);
+            hbool_t hot = FALSE;        /* Whether the chunk goes in the 2Q policy's LRU queue */
+
+            if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy) {
+                unsigned ghost_idx;     /* Index of chunk's ghost entry, if any */
+
+                /* A chunk accessed again after being preempted from the
+                 * FIFO queue, while its ghost entry is still around, goes
+                 * in the LRU queue */
+                if(UINT_MAX != (ghost_idx = H5D__chunk_cache_find(io_info->dset->shared, udata->common.scaled))) {
+                    HDassert(rdcc->slot[ghost_idx]->ghost);
+                    H5D__chunk_cache_ghost_remove(rdcc, rdcc->slot[ghost_idx]);
+                    rdcc->stats.nghost_hits++;
+                    hot = TRUE;
+                } /* end if */
+
+                /* There are no collisions, the slot is found once there's room */
+                ent = NULL;
+            } /* end if */
+            else {
+                /* Calculate the index */
+                udata->idx_hint = H5D__chunk_hash_val(io_info->dset->shared, udata->common.scaled);
+                ent = rdcc->slot[udata->idx_hint];
+            } /* end else */
 
             /* Add the chunk to the cache only if the slot is not already locked */
-            ent = rdcc->slot[udata->idx_hint];
             if(!ent || !ent->locked) {
                 /* Preempt enough things from the cache to make room */
                 if(ent) {
                     if(H5D__chunk_cache_evict(io_info->dset, ent, TRUE) < 0)
                         HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to preempt chunk from cache")
                 } /* end if */
-                if(H5D__chunk_cache_prune(io_info->dset, chunk_size) < 0)
+                if(H5D__chunk_cache_prune(io_info->dset, chunk_size, rdcc->nbytes_max) < 0)
                     HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to preempt chunk(s) from cache")
+                if(rdcc->shared) {
+                    /* (Re)register this handle for preempting the dataset's chunks */
+                    if(NULL == rdcc->dset)
+                        rdcc->dset = io_info->dset;
+
+                    /* Make room within the budget shared by the file's datasets */
+                    if(H5D__chunk_cache_prune_shared(io_info->dset, chunk_size) < 0)
+                        HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to preempt chunk(s) from shared cache")
+                } /* end if */
+                if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy)
+                    if(H5D__chunk_cache_new_slot(io_info->dset, udata->common.scaled, &udata->idx_hint) < 0)
+                        HGOTO_ERROR(H5E_IO, H5E_CANTINIT, NULL, "unable to find slot for chunk in cache")
 
                 /* Create a new entry */
                 if(NULL == (ent = H5FL_CALLOC(H5D_rdcc_ent_t)))
@@ -3703,20 +5567,40 @@ H5D__chunk_lock(const H5D_io_info_t *io_info, H5D_chunk_ud_t *udata,
                 ent->chunk = (uint8_t *)chunk;
 
                 /* Add it to the cache */
-                HDassert(NULL == rdcc->slot[udata->idx_hint]);
+                HDassert(NULL == rdcc->slot[udata->idx_hint] || H5D_RDCC_TOMBSTONE == rdcc->slot[udata->idx_hint]);
                 rdcc->slot[udata->idx_hint] = ent;
                 ent->idx = udata->idx_hint;
                 rdcc->nbytes_used += chunk_size;
+                if(rdcc->shared)
+                    rdcc->shared->nbytes_used += chunk_size;
                 rdcc->nused++;
 
-                /* Add it to the linked list */
-                if(rdcc->tail) {
-                    rdcc->tail->next = ent;
-                    ent->prev = rdcc->tail;
-                    rdcc->tail = ent;
+                /* Add it to the linked list.  With the 2Q policy, a chunk
+                 * going in the FIFO queue goes before the LRU queue's chunks */
+                ent->hot = hot;
+                if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy && !hot) {
+                    rdcc->nbytes_cold += chunk_size;
+                    if(rdcc->hot_head) {
+                        ent->next = rdcc->hot_head;
+                        ent->prev = rdcc->hot_head->prev;
+                        if(ent->prev)
+                            ent->prev->next = ent;
+                        else
+                            rdcc->head = ent;
+                        rdcc->hot_head->prev = ent;
+                    } /* end if */
+                } /* end if */
+                if(NULL == ent->next) {
+                    if(rdcc->tail) {
+                        rdcc->tail->next = ent;
+                        ent->prev = rdcc->tail;
+                        rdcc->tail = ent;
+                    } /* end if */
+                    else
+                        rdcc->head = rdcc->tail = ent;
+                    if(hot && NULL == rdcc->hot_head)
+                        rdcc->hot_head = ent;
                 } /* end if */
-                else
-                    rdcc->head = rdcc->tail = ent;
                 ent->tmp_next = NULL;
                 ent->tmp_prev = NULL;
 
@@ -3756,6 +5640,10 @@ done:
         if(chunk)
             chunk = H5D__chunk_mem_xfree(chunk, pline);
 
+    /* Release a decoded chunk which wasn't used */
+    if(decoded_chunk)
+        decoded_chunk = H5D__chunk_mem_xfree(decoded_chunk, pline);
+
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5D__chunk_lock() */
 
@@ -5467,6 +7355,13 @@ H5D__chunk_update_cache(H5D_t *dset)
     /* Check the rank */
     HDassert((dset->shared->layout.u.chunk.ndims - 1) > 1);
 
+    /* Chunk indices depend on the dimensions, so forget the last reads */
+    rdcc->ra_valid = FALSE;
+
+    /* The 2Q policy's index doesn't depend on the dataset's dimensions */
+    if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy)
+        HGOTO_DONE(SUCCEED)
+
     /* Add temporary entry list to rdcc */
     (void)HDmemset(&tmp_head, 0, sizeof(tmp_head));
     rdcc->tmp_head = &tmp_head;
@@ -5641,28 +7536,14 @@ H5D__chunk_copy_cb(const H5D_chunk_rec_t *chunk_rec, void *_udata)
     else {
         H5D_rdcc_ent_t *ent = NULL;    /* Cache entry */
         unsigned idx;                   /* Index of chunk in cache, if present */
-        unsigned u;                     /* Counter */
         H5D_shared_t *shared_fo = (H5D_shared_t *)udata->cpy_info->shared_fo;
 
-        /* See if the written chunk is in the chunk cache */
-        if(shared_fo && shared_fo->cache.chunk.nslots > 0) {
-            /* Determine the chunk's location in the hash table */
-            idx = H5D__chunk_hash_val(shared_fo, chunk_rec->scaled);
-
-            /* Get the chunk cache entry for that location */
-            ent = shared_fo->cache.chunk.slot[idx];
-            if(ent) {
-                /* Speculatively set the 'found' flag */
-                udata->chunk_in_cache = TRUE;
-
-                /* Verify that the cache entry is the correct chunk */
-                for(u = 0; u < shared_fo->ndims; u++)
-                    if(chunk_rec->scaled[u] != ent->scaled[u]) {
-                        udata->chunk_in_cache = FALSE;
-                        break;
-                    } /* end if */
+        /* See if the written chunk is in the chunk cache (ghost entries don't count) */
+        if(shared_fo && shared_fo->cache.chunk.nslots > 0)
+            if(UINT_MAX != (idx = H5D__chunk_cache_find(shared_fo, chunk_rec->scaled))) {
+                ent = shared_fo->cache.chunk.slot[idx];
+                udata->chunk_in_cache = !ent->ghost;
             } /* end if */
-        } /* end if */
 
         if(udata->chunk_in_cache) {
             HDassert(H5F_addr_defined(chunk_rec->chunk_addr));
@@ -6282,10 +8163,10 @@ H5D__chunk_stats(const H5D_t *dset, hbool_t headers)
 
     if (headers) {
         fprintf(H5DEBUG(AC), "H5D: raw data cache statistics\n");
-        fprintf(H5DEBUG(AC), "   %-18s %8s %8s %8s %8s+%-8s\n",
-            "Layer", "Hits", "Misses", "MissRate", "Inits", "Flushes");
-        fprintf(H5DEBUG(AC), "   %-18s %8s %8s %8s %8s-%-8s\n",
-            "-----", "----", "------", "--------", "-----", "-------");
+        fprintf(H5DEBUG(AC), "   %-18s %8s %8s %8s %8s+%-8s %8s\n",
+            "Layer", "Hits", "Misses", "MissRate", "Inits", "Flushes", "Shared");
+        fprintf(H5DEBUG(AC), "   %-18s %8s %8s %8s %8s-%-8s %8s\n",
+            "-----", "----", "------", "--------", "-----", "-------", "------");
     }
 
 #ifdef H5AC_DEBUG
@@ -6305,9 +8186,17 @@ H5D__chunk_stats(const H5D_t *dset, hbool_t headers)
             sprintf(ascii, "%7.2f%%", miss_rate);
         }
 
-        fprintf(H5DEBUG(AC), "   %-18s %8u %8u %7s %8d+%-9ld\n",
-            "raw data chunks", rdcc->stats.nhits, rdcc->stats.nmisses, ascii,
-            rdcc->stats.ninits, (long)(rdcc->stats.nflushes)-(long)(rdcc->stats.ninits));
+        fprintf(H5DEBUG(AC), "   %-18s %8u %8u %7s %8d+%-9ld %8u\n",
+            (H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy ? "raw data chunks 2Q" : "raw data chunks"),
+            rdcc->stats.nhits, rdcc->stats.nmisses, ascii,
+            rdcc->stats.ninits, (long)(rdcc->stats.nflushes)-(long)(rdcc->stats.ninits),
+            rdcc->stats.nshared);
+        if(H5D_CHUNK_CACHE_POLICY_2Q == rdcc->policy)
+            fprintf(H5DEBUG(AC), "   %-18s %8u\n", "ghost hits",
+                rdcc->stats.nghost_hits);
+        if(rdcc->read_ahead > 0)
+            fprintf(H5DEBUG(AC), "   %-18s %8u\n", "read ahead",
+                rdcc->stats.nread_ahead);
     }
 
 done:
@@ -1038,6 +1038,15 @@ H5D__create(H5F_t *file, hid_t type_id, const H5S_t *space, hid_t dcpl_id,
         if(H5P_get(dc_plist, H5O_CRT_PIPELINE_NAME, pline) < 0)
             HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, NULL, "can't retrieve pipeline filter")
         pline_copied = TRUE;
+#ifdef H5_HAVE_FILTER_ZSTD
+        /* Load the zstd filters' dictionaries and record their keys */
+        if(H5Z_filter_in_pline(pline, H5Z_FILTER_ZSTD)) {
+            if(H5D__zstd_dicts_load(file, pline, TRUE) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, NULL, "unable to load zstd dictionaries")
+            if(H5P_set(dc_plist, H5O_CRT_PIPELINE_NAME, pline) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, NULL, "can't set pipeline filter")
+        } /* end if */
+#endif /* H5_HAVE_FILTER_ZSTD */
         layout = &new_dset->shared->layout;
         if(H5P_get(dc_plist, H5D_CRT_LAYOUT_NAME, layout) < 0)
             HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, NULL, "can't retrieve layout")
@@ -1664,6 +1673,19 @@ H5D_close(H5D_t *dataset)
     dataset->shared->fo_count--;
     if(dataset->shared->fo_count == 0) {
 
+#ifdef H5F_HAVE_CONCURRENT_READS
+        /* Wait for a read which released the library lock to finish */
+        if(dataset->shared->read_lock) {
+            if(H5TS_mutex_lock_yield(dataset->shared->read_lock, &H5_g.init_lock) ||
+                    H5TS_mutex_unlock(dataset->shared->read_lock))
+                HDONE_ERROR(H5E_DATASET, H5E_CANTLOCK, FAIL, "can't wait for reads of dataset")
+            else if(H5TS_mutex_teardown(dataset->shared->read_lock))
+                HDONE_ERROR(H5E_DATASET, H5E_CANTRELEASE, FAIL, "can't release dataset read lock")
+            HDfree(dataset->shared->read_lock);
+            dataset->shared->read_lock = NULL;
+        } /* end if */
+#endif /* H5F_HAVE_CONCURRENT_READS */
+
         /* Flush the dataset's information.  Continue to close even if it fails. */
         if(H5D__flush_real(dataset) < 0)
             HDONE_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "unable to flush cached dataset info")
@@ -1805,6 +1827,14 @@ H5D_close(H5D_t *dataset)
         dataset->shared = H5FL_FREE(H5D_shared_t, dataset->shared);
     } /* end if */
     else {
+        /* Stop using this handle to preempt the dataset's cached chunks on
+         * behalf of other datasets sharing the file's chunk cache budget
+         * (another handle takes over the next time one locks a chunk)
+         */
+        if(H5D_CHUNKED == dataset->shared->layout.type
+                && dataset->shared->cache.chunk.dset == dataset)
+            dataset->shared->cache.chunk.dset = NULL;
+
         /* Decrement the ref. count for this object in the top file */
         if(H5FO_top_decr(dataset->oloc.file, dataset->oloc.addr) < 0)
             HGOTO_ERROR(H5E_DATASET, H5E_CANTRELEASE, FAIL, "can't decrement count for object")
@@ -3376,6 +3406,12 @@ H5D_get_access_plist(const H5D_t *dset)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set data cache byte size")
         if(H5P_set(new_plist, H5D_ACS_PREEMPT_READ_CHUNKS_NAME, &(dset->shared->cache.chunk.w0)) < 0)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set preempt read chunks")
+        if(H5P_set(new_plist, H5D_ACS_DATA_CACHE_POLICY_NAME, &(dset->shared->cache.chunk.policy)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set data cache policy")
+        if(H5P_set(new_plist, H5D_ACS_DATA_CACHE_READ_AHEAD_NAME, &(dset->shared->cache.chunk.read_ahead)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set data cache read-ahead window")
+        if(H5P_set(new_plist, H5D_ACS_CHUNK_READ_GAP_NAME, &(dset->shared->cache.chunk.read_gap)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set chunk read gap")
         if(H5P_set(new_plist, H5D_ACS_APPEND_FLUSH_NAME, &dset->shared->append_flush) < 0)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set append flush property")
     } /* end if */
@@ -3539,3 +3575,97 @@ done:
     FUNC_LEAVE_NOAPI_VOL(ret_value)
 } /* end H5D__refresh() */
 
+
+#ifdef H5_HAVE_FILTER_ZSTD
+
+/*-------------------------------------------------------------------------
+ * Function:    H5D__zstd_dicts_load
+ *
+ * Purpose:     Loads the dictionaries that the zstd filters in a dataset's
+ *              I/O pipeline refer to into the zstd filter, reading each
+ *              one from the dictionary dataset in file F.  When SET_KEYS
+ *              is true (the dataset is being created), the dictionaries'
+ *              keys are stored in the filters' parameters; otherwise
+ *              dictionaries already loaded are skipped and the others
+ *              are checked against the keys stored.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5D__zstd_dicts_load(H5F_t *f, H5O_pline_t *pline, hbool_t set_keys)
+{
+    H5D_t *dict = NULL;                 /* Dictionary dataset */
+    void *buf = NULL;                   /* Dictionary contents */
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Sanity checks */
+    HDassert(f);
+    HDassert(pline);
+
+    for(u = 0; u < pline->nused; u++) {
+        H5Z_filter_info_t *filter = &pline->filter[u];  /* Filter to check */
+        H5G_loc_t loc;                  /* Dictionary's location */
+        H5O_loc_t oloc;                 /* Dictionary's object location */
+        H5G_name_t path;                /* Dictionary's path */
+        H5O_type_t obj_type;            /* Type of object referred to */
+        hssize_t npoints;               /* Number of bytes in dictionary */
+        size_t size;                    /* Size of dictionary */
+        unsigned key;                   /* Dictionary's key */
+
+        if(filter->id != H5Z_FILTER_ZSTD || filter->cd_nelmts != H5Z_ZSTD_TOTAL_NPARMS)
+            continue;
+        if(!set_keys && H5Z_zstd_dict_loaded(filter->cd_values[H5Z_ZSTD_PARM_DICT_KEY]))
+            continue;
+
+        /* Locate the dictionary dataset */
+        H5O_loc_reset(&oloc);
+        oloc.file = f;
+        oloc.addr = ((haddr_t)filter->cd_values[H5Z_ZSTD_PARM_DICT_HI] << 32) |
+                (haddr_t)filter->cd_values[H5Z_ZSTD_PARM_DICT_LO];
+        if(H5O_obj_type(&oloc, &obj_type) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_NOTFOUND, FAIL, "can't find zstd dictionary")
+        if(obj_type != H5O_TYPE_DATASET)
+            HGOTO_ERROR(H5E_DATASET, H5E_BADTYPE, FAIL, "zstd dictionary isn't a dataset")
+        H5G_name_reset(&path);
+        loc.oloc = &oloc;
+        loc.path = &path;
+
+        /* Read the dictionary */
+        if(NULL == (dict = H5D_open(&loc, H5P_DATASET_ACCESS_DEFAULT)))
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTOPENOBJ, FAIL, "unable to open zstd dictionary")
+        if(H5T_get_size(dict->shared->type) != 1)
+            HGOTO_ERROR(H5E_DATASET, H5E_BADTYPE, FAIL, "zstd dictionary's datatype isn't one byte")
+        if((npoints = H5S_GET_EXTENT_NPOINTS(dict->shared->space)) <= 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_BADVALUE, FAIL, "zstd dictionary is empty")
+        size = (size_t)npoints;
+        if(NULL == (buf = H5MM_malloc(size)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate zstd dictionary")
+        if(H5D__read(dict, dict->shared->type_id, dict->shared->space, dict->shared->space, buf) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "unable to read zstd dictionary")
+        if(H5D_close(dict) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CLOSEERROR, FAIL, "unable to close zstd dictionary")
+        dict = NULL;
+
+        /* Hand it to the filter */
+        if(H5Z_zstd_dict_load(buf, size, &key) < 0)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTLOAD, FAIL, "unable to load zstd dictionary")
+        buf = H5MM_xfree(buf);
+        if(set_keys)
+            filter->cd_values[H5Z_ZSTD_PARM_DICT_KEY] = key;
+        else if(filter->cd_values[H5Z_ZSTD_PARM_DICT_KEY] != key)
+            HGOTO_ERROR(H5E_PLINE, H5E_BADVALUE, FAIL, "zstd dictionary has changed since the dataset was created")
+    } /* end for */
+
+done:
+    if(dict && H5D_close(dict) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CLOSEERROR, FAIL, "unable to close zstd dictionary")
+    H5MM_xfree(buf);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__zstd_dicts_load() */
+#endif /* H5_HAVE_FILTER_ZSTD */
@@ -25,10 +25,12 @@
 #include "H5CXprivate.h"        /* API Contexts                         */
 #include "H5Dpkg.h"		/* Dataset functions			*/
 #include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5ESprivate.h"        /* Event sets                           */
 #include "H5FLprivate.h"	/* Free Lists                           */
 #include "H5Iprivate.h"		/* IDs			  		*/
 #include "H5MMprivate.h"        /* Memory management                    */
 #include "H5Sprivate.h"		/* Dataspace			  	*/
+#include "H5VMprivate.h"	/* Vector and array functions		*/
 
 #ifdef H5_HAVE_PARALLEL
 /* Remove this if H5R_DATASET_REGION is no longer used in this file */
@@ -40,11 +42,69 @@
 /* Local Macros */
 /****************/
 
+/* Initial number of blocks allocated for a multi-dataset vector request */
+#define H5D_MULTI_VEC_NBLOCKS   64
+
 
 /******************/
 /* Local Typedefs */
 /******************/
 
+/* One dataset's part of a multi-dataset transfer */
+typedef struct H5D_multi_io_t {
+    H5D_t *dset;                /* Dataset to transfer */
+    hid_t mem_type_id;          /* Memory datatype ID */
+    const H5S_t *mem_space;     /* Memory dataspace (NULL for H5S_ALL) */
+    const H5S_t *file_space;    /* File dataspace (NULL for H5S_ALL) */
+    const H5S_t *sel_mem_space; /* Memory dataspace, with H5S_ALL resolved */
+    const H5S_t *sel_file_space; /* File dataspace, with H5S_ALL resolved */
+    size_t nelmts;              /* Number of elements to transfer */
+    size_t type_size;           /* Size of the dataset's datatype */
+    hbool_t conv_noop;          /* Whether the elements need no conversion */
+    hbool_t planned;            /* Whether the transfer has been considered for vector I/O */
+    hbool_t vector;             /* Whether the transfer is done with vector I/O */
+    haddr_t addr;               /* Address of dataset's storage, for ordering */
+    size_t idx;                 /* Position of dataset in caller's arrays */
+} H5D_multi_io_t;
+
+/* A selection's sequences, handed out a piece at a time */
+typedef struct H5D_multi_seq_t {
+    const H5S_t *space;         /* Dataspace */
+    unsigned flags;             /* Flags for generating sequences */
+    H5S_sel_iter_t iter;        /* Selection iterator */
+    hbool_t iter_init;          /* Whether the iterator has been initialized */
+    size_t nelmts;              /* Number of elements not yet in sequences */
+    hsize_t *off;               /* Sequence offsets, in bytes */
+    size_t *len;                /* Sequence lengths, in bytes */
+    size_t nseq;                /* Number of sequences in the arrays */
+    size_t curr_seq;            /* Current sequence */
+} H5D_multi_seq_t;
+
+/* The raw data blocks of a multi-dataset transfer, for one vector request */
+typedef struct H5D_multi_vec_t {
+    size_t nused;               /* Number of blocks */
+    size_t nalloc;              /* Number of blocks allocated */
+    haddr_t *addrs;             /* Address of each block in the file */
+    size_t *sizes;              /* Size of each block */
+    size_t *idx;                /* Caller's buffer for each block */
+    hsize_t *mem_off;           /* Offset of each block in the caller's buffer */
+} H5D_multi_vec_t;
+
+/* An asynchronous dataset read or write.  References are held on the IDs,
+ * and the dataspaces and transfer properties are copied, so the
+ * application may close or change them after inserting the operation.
+ */
+typedef struct H5D_async_io_t {
+    hid_t dset_id;              /* Dataset ID */
+    hid_t mem_type_id;          /* Memory datatype ID */
+    H5S_t *mem_space;           /* Memory dataspace (NULL for H5S_ALL) */
+    H5S_t *file_space;          /* File dataspace (NULL for H5S_ALL) */
+    hid_t dxpl_id;              /* Dataset transfer property list ID */
+    void *rbuf;                 /* Application buffer to read into */
+    const void *wbuf;           /* Application buffer to write from */
+    hbool_t do_write;           /* Whether to write, rather than read */
+} H5D_async_io_t;
+
 
 /********************/
 /* Local Prototypes */
@@ -61,6 +121,27 @@ static herr_t H5D__ioinfo_adjust(H5D_io_info_t *io_info, const H5D_t *dset,
     const H5S_t *file_space, const H5S_t *mem_space, const H5D_type_info_t *type_info);
 #endif /* H5_HAVE_PARALLEL */
 static herr_t H5D__typeinfo_term(const H5D_type_info_t *type_info);
+static herr_t H5D__multi_io_init(size_t count, const hid_t dset_id[],
+    const hid_t mem_type_id[], const hid_t mem_space_id[],
+    const hid_t file_space_id[], const void *const buf[], hbool_t do_write,
+    H5D_multi_io_t **multi_io);
+static int H5D__multi_io_cmp(const void *_io1, const void *_io2);
+static herr_t H5D__multi_io_vector(size_t count, H5D_multi_io_t multi_io[],
+    void *rbuf[], const void *wbuf[]);
+static htri_t H5D__multi_io_gather(H5D_multi_io_t *io, hbool_t do_write,
+    H5D_multi_vec_t *vec);
+static herr_t H5D__multi_io_add(H5D_multi_vec_t *vec, H5D_multi_seq_t *mem_seq,
+    size_t idx, haddr_t addr, size_t len);
+static herr_t H5D__multi_seq_init(H5D_multi_seq_t *seq, const H5S_t *space,
+    unsigned flags, size_t nelmts, size_t elmt_size);
+static herr_t H5D__multi_seq_next(H5D_multi_seq_t *seq, size_t max_len,
+    hsize_t *off, size_t *len);
+static herr_t H5D__multi_seq_term(H5D_multi_seq_t *seq);
+static herr_t H5D__io_async(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
+    hid_t file_space_id, hid_t dxpl_id, void *rbuf, const void *wbuf,
+    hbool_t do_write, hid_t es_id);
+static herr_t H5D__io_async_exec(void *_aio);
+static herr_t H5D__io_async_free(void *_aio);
 
 
 /*********************/
@@ -78,6 +159,12 @@ H5FL_BLK_DEFINE(type_conv);
 /* Declare a free list to manage the H5D_chunk_map_t struct */
 H5FL_DEFINE(H5D_chunk_map_t);
 
+/* Declare extern free list to manage sequences of size_t */
+H5FL_SEQ_EXTERN(size_t);
+
+/* Declare extern free list to manage sequences of hsize_t */
+H5FL_SEQ_EXTERN(hsize_t);
+
 
 
 /*-------------------------------------------------------------------------
@@ -202,6 +289,82 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Dread() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Dread_multi
+ *
+ * Purpose:     Reads (part of) COUNT datasets from the file into
+ *              application memory.  Element U of each array argument
+ *              describes the transfer for DSET_ID[U] exactly as the
+ *              corresponding argument to H5Dread() does, and the data for
+ *              that dataset is read into BUF[U].  All the transfers use
+ *              the properties in DXPL_ID.
+ *
+ *              The arguments for every dataset, including the datatype
+ *              conversions and the number of elements selected, are
+ *              checked before any data is read.  Contiguous and
+ *              unfiltered chunked data which needs no conversion is read
+ *              with one vector read per file; the other datasets are then
+ *              read in order of their location in the file.  If a read
+ *              fails, the datasets after it are not read.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dread_multi(size_t count, const hid_t dset_id[], const hid_t mem_type_id[],
+    const hid_t mem_space_id[], const hid_t file_space_id[], hid_t dxpl_id,
+    void *buf[]/*out*/)
+{
+    H5D_multi_io_t *multi_io = NULL;            /* Per-dataset transfer info, in file order */
+    size_t          u;                          /* Local index variable */
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE7("e", "z*i*i*i*iix", count, dset_id, mem_type_id, mem_space_id,
+             file_space_id, dxpl_id, buf);
+
+    /* Check arguments */
+    if (0 == count)
+        HGOTO_DONE(SUCCEED)
+    if (!dset_id || !mem_type_id || !mem_space_id || !file_space_id)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "ID arrays cannot be NULL")
+    if (!buf)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "buf cannot be NULL")
+
+    /* Get the default dataset transfer property list if the user didn't provide one */
+    if (H5P_DEFAULT == dxpl_id)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+    else
+        if (TRUE != H5P_isa_class(dxpl_id, H5P_DATASET_XFER))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not xfer parms")
+
+    /* Set DXPL for operation */
+    H5CX_set_dxpl(dxpl_id);
+
+    /* Check the arguments for every dataset, and put the datasets in file order */
+    if (H5D__multi_io_init(count, dset_id, mem_type_id, mem_space_id, file_space_id,
+            (const void *const *)buf, FALSE, &multi_io) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't set up multi-dataset read")
+
+    /* Read the datasets which need no conversion with vector reads */
+    if (H5D__multi_io_vector(count, multi_io, buf, NULL) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "can't read data")
+
+    /* Read the other datasets */
+    for (u = 0; u < count; u++)
+        if (!multi_io[u].vector && H5D__read(multi_io[u].dset, multi_io[u].mem_type_id,
+                multi_io[u].mem_space, multi_io[u].file_space, buf[multi_io[u].idx]/*out*/) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "can't read data")
+
+done:
+    if (multi_io)
+        multi_io = (H5D_multi_io_t *)H5MM_xfree(multi_io);
+
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Dread_multi() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5Dread_chunk
@@ -339,6 +502,144 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Dwrite() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Dwrite_multi
+ *
+ * Purpose:     Writes (part of) COUNT datasets from application memory to
+ *              the file.  Element U of each array argument describes the
+ *              transfer for DSET_ID[U] exactly as the corresponding
+ *              argument to H5Dwrite() does, and the data for that dataset
+ *              is taken from BUF[U].  All the transfers use the properties
+ *              in DXPL_ID.
+ *
+ *              The arguments for every dataset, including the datatype
+ *              conversions and the number of elements selected, are
+ *              checked before any data is written.  Contiguous and
+ *              unfiltered chunked data which needs no conversion is
+ *              written with one vector write per file; the other datasets
+ *              are then written in order of their location in the file.
+ *              If a write fails, the datasets after it are not written.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dwrite_multi(size_t count, const hid_t dset_id[], const hid_t mem_type_id[],
+    const hid_t mem_space_id[], const hid_t file_space_id[], hid_t dxpl_id,
+    const void *buf[])
+{
+    H5D_multi_io_t *multi_io = NULL;            /* Per-dataset transfer info, in file order */
+    size_t          u;                          /* Local index variable */
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE7("e", "z*i*i*i*ii**x", count, dset_id, mem_type_id, mem_space_id,
+             file_space_id, dxpl_id, buf);
+
+    /* Check arguments */
+    if (0 == count)
+        HGOTO_DONE(SUCCEED)
+    if (!dset_id || !mem_type_id || !mem_space_id || !file_space_id)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "ID arrays cannot be NULL")
+    if (!buf)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "buf cannot be NULL")
+
+    /* Get the default dataset transfer property list if the user didn't provide one */
+    if (H5P_DEFAULT == dxpl_id)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+    else
+        if (TRUE != H5P_isa_class(dxpl_id, H5P_DATASET_XFER))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not xfer parms")
+
+    /* Set DXPL for operation */
+    H5CX_set_dxpl(dxpl_id);
+
+    /* Check the arguments for every dataset, and put the datasets in file order */
+    if (H5D__multi_io_init(count, dset_id, mem_type_id, mem_space_id, file_space_id,
+            (const void *const *)buf, TRUE, &multi_io) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't set up multi-dataset write")
+
+    /* Write the datasets which need no conversion with vector writes */
+    if (H5D__multi_io_vector(count, multi_io, NULL, buf) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "can't write data")
+
+    /* Write the other datasets */
+    for (u = 0; u < count; u++)
+        if (!multi_io[u].vector && H5D__write(multi_io[u].dset, multi_io[u].mem_type_id,
+                multi_io[u].mem_space, multi_io[u].file_space, buf[multi_io[u].idx]) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "can't write data")
+
+done:
+    if (multi_io)
+        multi_io = (H5D_multi_io_t *)H5MM_xfree(multi_io);
+
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Dwrite_multi() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Dread_async
+ *
+ * Purpose:     Inserts a read of (part of) a dataset in the event set
+ *              ES_ID and returns without waiting for it.  The arguments
+ *              are as for H5Dread().  BUF must not be used until
+ *              H5ESwait() has been called on the event set; read errors
+ *              are reported by H5ESwait() too.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dread_async(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
+    hid_t file_space_id, hid_t dxpl_id, void *buf/*out*/, hid_t es_id)
+{
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE7("e", "iiiiixi", dset_id, mem_type_id, mem_space_id, file_space_id,
+             dxpl_id, buf, es_id);
+
+    if (H5D__io_async(dset_id, mem_type_id, mem_space_id, file_space_id, dxpl_id, buf, NULL, FALSE, es_id) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "can't insert asynchronous read")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Dread_async() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Dwrite_async
+ *
+ * Purpose:     Inserts a write of (part of) a dataset in the event set
+ *              ES_ID and returns without waiting for it.  The arguments
+ *              are as for H5Dwrite().  BUF must not be changed until
+ *              H5ESwait() has been called on the event set; write errors
+ *              are reported by H5ESwait() too.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Dwrite_async(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
+    hid_t file_space_id, hid_t dxpl_id, const void *buf, hid_t es_id)
+{
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE7("e", "iiiii*xi", dset_id, mem_type_id, mem_space_id, file_space_id,
+             dxpl_id, buf, es_id);
+
+    if (H5D__io_async(dset_id, mem_type_id, mem_space_id, file_space_id, dxpl_id, NULL, buf, TRUE, es_id) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "can't insert asynchronous write")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Dwrite_async() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5Dwrite_chunk
@@ -446,6 +747,9 @@ H5D__read(H5D_t *dataset, hid_t mem_type_id, const H5S_t *mem_space,
     hssize_t	snelmts;                /*total number of elmts	(signed) */
     hsize_t	nelmts;                 /*total number of elmts	*/
     hbool_t     io_op_init = FALSE;     /* Whether the I/O op has been initialized */
+#ifdef H5F_HAVE_CONCURRENT_READS
+    hbool_t     read_locked = FALSE;    /* Whether the dataset's read lock is held */
+#endif /* H5F_HAVE_CONCURRENT_READS */
     char        fake_char;              /* Temporary variable for NULL buffer pointers */
     herr_t	ret_value = SUCCEED;	/* Return value	*/
 
@@ -585,6 +889,28 @@ H5D__read(H5D_t *dataset, hid_t mem_type_id, const H5S_t *mem_space,
     if(NULL == (fm = H5FL_CALLOC(H5D_chunk_map_t)))
         HGOTO_ERROR(H5E_DATASET, H5E_CANTALLOC, FAIL, "can't allocate chunk map")
 
+#ifdef H5F_HAVE_CONCURRENT_READS
+    /* Chunked reads from read-only files release the library lock while
+     * chunks are read and decoded, so hold the dataset's read lock: the
+     * chunk map is shared by all I/O on the dataset.  Other threads can
+     * still use the library (and read other datasets) in the meantime.
+     */
+    if(H5D_CHUNKED == dataset->shared->layout.type && H5F_concurrent_reads(dataset->oloc.file)) {
+        if(NULL == dataset->shared->read_lock) {
+            if(NULL == (dataset->shared->read_lock = (H5TS_mutex_t *)HDmalloc(sizeof(H5TS_mutex_t))))
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTALLOC, FAIL, "can't allocate dataset read lock")
+            if(H5TS_mutex_setup(dataset->shared->read_lock)) {
+                HDfree(dataset->shared->read_lock);
+                dataset->shared->read_lock = NULL;
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't initialize dataset read lock")
+            } /* end if */
+        } /* end if */
+        if(H5TS_mutex_lock_yield(dataset->shared->read_lock, &H5_g.init_lock))
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTLOCK, FAIL, "can't lock dataset for reading")
+        read_locked = TRUE;
+    } /* end if */
+#endif /* H5F_HAVE_CONCURRENT_READS */
+
     /* Call storage method's I/O initialization routine */
     if(io_info.layout_ops.io_init && (*io_info.layout_ops.io_init)(&io_info, &type_info, nelmts, file_space, mem_space, fm) < 0)
         HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't initialize I/O info")
@@ -606,6 +932,10 @@ done:
         HDONE_ERROR(H5E_DATASET, H5E_CANTCLOSEOBJ, FAIL, "unable to shut down I/O op info")
     if(fm)
         fm = H5FL_FREE(H5D_chunk_map_t, fm);
+#ifdef H5F_HAVE_CONCURRENT_READS
+    if(read_locked && H5TS_mutex_unlock(dataset->shared->read_lock))
+        HDONE_ERROR(H5E_DATASET, H5E_CANTUNLOCK, FAIL, "can't unlock dataset after reading")
+#endif /* H5F_HAVE_CONCURRENT_READS */
 
     /* Shut down datatype info for operation */
     if(type_info_init && H5D__typeinfo_term(&type_info) < 0)
@@ -1281,3 +1611,831 @@ H5D__typeinfo_term(const H5D_type_info_t *type_info)
     FUNC_LEAVE_NOAPI(SUCCEED)
 } /* end H5D__typeinfo_term() */
 
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_io_init
+ *
+ * Purpose:	Checks the arguments for a multi-dataset transfer and builds
+ *		the list of per-dataset transfers, sorted by the location of
+ *		each dataset's storage in the file.  Everything H5D__read or
+ *		H5D__write would reject is checked here, so that a bad
+ *		argument for one dataset fails the call before any data
+ *		is transferred.  The caller must free *MULTI_IO with
+ *		H5MM_xfree().
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__multi_io_init(size_t count, const hid_t dset_id[], const hid_t mem_type_id[],
+    const hid_t mem_space_id[], const hid_t file_space_id[], const void *const buf[],
+    hbool_t do_write, H5D_multi_io_t **multi_io)
+{
+    H5D_multi_io_t *io = NULL;          /* Per-dataset transfer info */
+    H5Z_data_xform_t *data_transform;   /* Data transform info */
+    hbool_t xform_noop;                 /* Whether the data transform is a no-op */
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(count > 0);
+    HDassert(buf);
+    HDassert(multi_io);
+
+    /* Retrieve info from API context */
+    if (H5CX_get_data_transform(&data_transform) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get data transform info")
+    xform_noop = H5Z_xform_noop(data_transform);
+
+    if (NULL == (io = (H5D_multi_io_t *)H5MM_calloc(count * sizeof(H5D_multi_io_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate multi-dataset transfer info")
+
+    for (u = 0; u < count; u++) {
+        H5D_t *dset;
+        const H5T_t *mem_type;          /* Memory datatype */
+        H5T_path_t *tpath;              /* Datatype conversion path */
+        hssize_t snelmts;               /* Number of elements selected */
+
+        /* Get dataset pointer and ensure it's associated with a file */
+        if (NULL == (dset = (H5D_t *)H5I_object_verify(dset_id[u], H5I_DATASET)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "dset_id is not a dataset ID")
+        if (NULL == dset->oloc.file)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "dataset is not associated with a file")
+
+        /* Check that the elements can be converted */
+        if (NULL == (mem_type = (const H5T_t *)H5I_object_verify(mem_type_id[u], H5I_DATATYPE)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "mem_type_id is not a datatype ID")
+        if (H5T_patch_vlen_file(dset->shared->type, dset->oloc.file) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTOPENOBJ, FAIL, "can't patch VL datatype file pointer")
+        if (NULL == (tpath = do_write ? H5T_path_find(mem_type, dset->shared->type) :
+                H5T_path_find(dset->shared->type, mem_type)))
+            HGOTO_ERROR(H5E_DATASET, H5E_UNSUPPORTED, FAIL, "unable to convert between src and dest datatype")
+
+        /* Get validated dataspace pointers */
+        if (H5S_get_validated_dataspace(mem_space_id[u], &io[u].mem_space) < 0)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "could not get a validated dataspace from mem_space_id")
+        if (H5S_get_validated_dataspace(file_space_id[u], &io[u].file_space) < 0)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "could not get a validated dataspace from file_space_id")
+        io[u].sel_file_space = io[u].file_space ? io[u].file_space : dset->shared->space;
+        io[u].sel_mem_space = io[u].mem_space ? io[u].mem_space : io[u].sel_file_space;
+
+        /* Make certain that the number of elements in each selection is the same */
+        if ((snelmts = H5S_GET_SELECT_NPOINTS(io[u].sel_mem_space)) < 0)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "memory dataspace has invalid selection")
+        if ((hsize_t)snelmts != (hsize_t)H5S_GET_SELECT_NPOINTS(io[u].sel_file_space))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "src and dest dataspaces have different number of elements selected")
+        H5_CHECKED_ASSIGN(io[u].nelmts, size_t, snelmts, hssize_t);
+        if (io[u].nelmts > 0 && NULL == buf[u])
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "no buffer for a dataset with elements selected")
+
+        /* Make sure that both selections have their extents set */
+        if (!(H5S_has_extent(io[u].sel_file_space)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "file dataspace does not have extent set")
+        if (!(H5S_has_extent(io[u].sel_mem_space)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "memory dataspace does not have extent set")
+
+        if (do_write) {
+            /* Check if we are allowed to write to this file */
+            if (0 == (H5F_INTENT(dset->oloc.file) & H5F_ACC_RDWR))
+                HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "no write intent on file")
+
+            /* All filters in the DCPL must have encoding enabled. */
+            if (!dset->shared->checked_filters) {
+                if (H5Z_can_apply(dset->shared->dcpl_id, dset->shared->type_id) < 0)
+                    HGOTO_ERROR(H5E_PLINE, H5E_CANAPPLY, FAIL, "can't apply filters")
+
+                dset->shared->checked_filters = TRUE;
+            } /* end if */
+        } /* end if */
+
+#ifdef H5_HAVE_PARALLEL
+        /* Collective access is not permissible without a MPI based VFD */
+        if (!(H5F_HAS_FEATURE(dset->oloc.file, H5FD_FEAT_HAS_MPI))) {
+            H5FD_mpio_xfer_t io_xfer_mode;      /* MPI I/O transfer mode */
+
+            if (H5CX_get_io_xfer_mode(&io_xfer_mode) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get MPI-I/O transfer mode")
+            if (io_xfer_mode == H5FD_MPIO_COLLECTIVE)
+                HGOTO_ERROR(H5E_DATASET, H5E_UNSUPPORTED, FAIL, "collective access for MPI-based drivers only")
+        } /* end if */
+#endif /* H5_HAVE_PARALLEL */
+
+        io[u].dset = dset;
+        io[u].mem_type_id = mem_type_id[u];
+        io[u].type_size = H5T_get_size(dset->shared->type);
+        io[u].conv_noop = (hbool_t)(H5T_path_noop(tpath) && xform_noop);
+        io[u].idx = u;
+
+        /* Order datasets by their raw data, or by their object header when
+         * the raw data isn't kept in a separate block
+         */
+        switch (dset->shared->layout.type) {
+            case H5D_CONTIGUOUS:
+                io[u].addr = dset->shared->layout.storage.u.contig.addr;
+                break;
+
+            case H5D_CHUNKED:
+                io[u].addr = dset->shared->layout.storage.u.chunk.idx_addr;
+                break;
+
+            case H5D_COMPACT:
+            case H5D_VIRTUAL:
+            case H5D_LAYOUT_ERROR:
+            case H5D_NLAYOUTS:
+            default:
+                io[u].addr = dset->oloc.addr;
+                break;
+        } /* end switch */
+    } /* end for */
+
+    /* Sort the transfers into file order */
+    if (count > 1)
+        HDqsort(io, count, sizeof(H5D_multi_io_t), H5D__multi_io_cmp);
+
+    /* Pass the list back to the caller */
+    *multi_io = io;
+    io = NULL;
+
+done:
+    if (io)
+        io = (H5D_multi_io_t *)H5MM_xfree(io);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_io_init() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_io_cmp
+ *
+ * Purpose:	Compares two multi-dataset transfers by file address, for
+ *		qsort.  Datasets without storage sort last, and ties keep
+ *		the caller's order.
+ *
+ * Return:	-1, 0 or 1, as for qsort
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5D__multi_io_cmp(const void *_io1, const void *_io2)
+{
+    const H5D_multi_io_t *io1 = (const H5D_multi_io_t *)_io1;
+    const H5D_multi_io_t *io2 = (const H5D_multi_io_t *)_io2;
+    hbool_t def1, def2;                 /* Whether each address is defined */
+    int ret_value = 0;                  /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    def1 = H5F_addr_defined(io1->addr);
+    def2 = H5F_addr_defined(io2->addr);
+    if (def1 != def2)
+        ret_value = def1 ? -1 : 1;
+    else if (def1 && H5F_addr_ne(io1->addr, io2->addr))
+        ret_value = H5F_addr_lt(io1->addr, io2->addr) ? -1 : 1;
+    else if (io1->idx != io2->idx)
+        ret_value = io1->idx < io2->idx ? -1 : 1;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_io_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_io_vector
+ *
+ * Purpose:	Transfers the datasets of a multi-dataset transfer which
+ *		can go straight between the file and the application's
+ *		buffers, with one vector request for each file.  These are
+ *		contiguous datasets and unfiltered chunked datasets whose
+ *		elements need no conversion, and whose data is allocated
+ *		and not held in the chunk cache.  The transfers which are
+ *		done have their 'vector' flag set; the caller transfers
+ *		the rest.  Exactly one of RBUF and WBUF is non-NULL.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__multi_io_vector(size_t count, H5D_multi_io_t multi_io[], void *rbuf[],
+    const void *wbuf[])
+{
+    H5D_multi_vec_t vec;                /* Blocks for a vector request */
+    void **rbufs = NULL;                /* Buffers for a vector read */
+    const void **wbufs = NULL;          /* Buffers for a vector write */
+    size_t nbufs = 0;                   /* Number of buffers allocated */
+    hbool_t do_write = (hbool_t)(wbuf != NULL);     /* Whether to write, rather than read */
+    size_t u, v;                        /* Local index variables */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(multi_io);
+    HDassert((NULL == rbuf) != (NULL == wbuf));
+
+    HDmemset(&vec, 0, sizeof(vec));
+
+    /* Gather the blocks in each file, and transfer them with one request */
+    for (u = 0; u < count; u++) {
+        H5F_t *f = multi_io[u].dset->oloc.file;        /* File for this request */
+
+        if (multi_io[u].planned)
+            continue;
+
+        vec.nused = 0;
+        for (v = u; v < count; v++) {
+            htri_t gathered;            /* Whether the transfer was gathered */
+
+            if (multi_io[v].planned || multi_io[v].dset->oloc.file != f)
+                continue;
+            multi_io[v].planned = TRUE;
+
+            /* Datasets named more than once are left to the ordinary I/O
+             * path, so that their transfers happen in the caller's order.
+             * (The sort puts them next to each other.)
+             */
+            if ((v > 0 && multi_io[v - 1].dset->shared == multi_io[v].dset->shared)
+                    || (v + 1 < count && multi_io[v + 1].dset->shared == multi_io[v].dset->shared))
+                continue;
+
+            if ((gathered = H5D__multi_io_gather(&multi_io[v], do_write, &vec)) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTGATHER, FAIL, "can't gather blocks for vector I/O")
+            multi_io[v].vector = (hbool_t)gathered;
+        } /* end for */
+
+        if (0 == vec.nused)
+            continue;
+
+        /* Make room for the buffer pointers */
+        if (vec.nused > nbufs) {
+            if (do_write) {
+                const void **tmp_bufs;
+
+                if (NULL == (tmp_bufs = (const void **)H5MM_realloc(wbufs, vec.nused * sizeof(void *))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector buffer array")
+                wbufs = tmp_bufs;
+            } /* end if */
+            else {
+                void **tmp_bufs;
+
+                if (NULL == (tmp_bufs = (void **)H5MM_realloc(rbufs, vec.nused * sizeof(void *))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector buffer array")
+                rbufs = tmp_bufs;
+            } /* end else */
+            nbufs = vec.nused;
+        } /* end if */
+
+        /* Transfer the blocks */
+        if (do_write) {
+            for (v = 0; v < vec.nused; v++)
+                wbufs[v] = (const uint8_t *)wbuf[vec.idx[v]] + vec.mem_off[v];
+            if (H5F_block_write_vector(f, vec.nused, vec.addrs, vec.sizes, wbufs) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "vector write failed")
+        } /* end if */
+        else {
+            for (v = 0; v < vec.nused; v++)
+                rbufs[v] = (uint8_t *)rbuf[vec.idx[v]] + vec.mem_off[v];
+            if (H5F_block_read_vector(f, vec.nused, vec.addrs, vec.sizes, rbufs) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "vector read failed")
+        } /* end else */
+    } /* end for */
+
+done:
+    vec.addrs = (haddr_t *)H5MM_xfree(vec.addrs);
+    vec.sizes = (size_t *)H5MM_xfree(vec.sizes);
+    vec.idx = (size_t *)H5MM_xfree(vec.idx);
+    vec.mem_off = (hsize_t *)H5MM_xfree(vec.mem_off);
+    rbufs = (void **)H5MM_xfree(rbufs);
+    wbufs = (const void **)H5MM_xfree(wbufs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_io_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_io_gather
+ *
+ * Purpose:	Adds the blocks of the file and of the application's buffer
+ *		for one dataset's transfer to VEC, if the transfer can be
+ *		done with vector I/O.
+ *
+ * Return:	TRUE if the blocks were added, FALSE if the transfer must
+ *		go through H5D__read/H5D__write, negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static htri_t
+H5D__multi_io_gather(H5D_multi_io_t *io, hbool_t do_write, H5D_multi_vec_t *vec)
+{
+    H5D_t *dset = io->dset;             /* Dataset */
+    const H5O_layout_t *layout = &dset->shared->layout;    /* Dataset's layout */
+    H5D_multi_seq_t file_seq;           /* File selection's sequences */
+    H5D_multi_seq_t mem_seq;            /* Memory selection's sequences */
+    hsize_t dims[H5O_LAYOUT_NDIMS];     /* File dataspace dimensions */
+    hsize_t coords[H5O_LAYOUT_NDIMS];   /* Coordinates of an element */
+    hsize_t scaled[H5O_LAYOUT_NDIMS];   /* Scaled coordinates of the current chunk */
+    hsize_t down_chunk[H5O_LAYOUT_NDIMS]; /* Number of elements "down" each dimension of a chunk */
+    haddr_t chunk_addr = HADDR_UNDEF;   /* Address of the current chunk */
+    hbool_t have_chunk = FALSE;         /* Whether the current chunk has been looked up */
+    unsigned rank = 0;                  /* Rank of the dataset */
+    size_t nused = vec->nused;          /* Number of blocks before this dataset's */
+    size_t nbytes;                      /* Number of bytes not yet gathered */
+    unsigned d;                         /* Local index variable */
+    htri_t ret_value = TRUE;            /* Return value */
+
+    FUNC_ENTER_STATIC_TAG(dset->oloc.addr)
+
+    HDmemset(&file_seq, 0, sizeof(file_seq));
+    HDmemset(&mem_seq, 0, sizeof(mem_seq));
+
+    /* Only elements which need no conversion, kept in blocks of the file,
+     * can go straight between the file and the application's buffer
+     */
+    if (!io->conv_noop || 0 == io->nelmts || dset->shared->dcpl_cache.efl.nused > 0
+            || !(*layout->ops->is_space_alloc)(&layout->storage))
+        HGOTO_DONE(FALSE)
+#ifdef H5_HAVE_PARALLEL
+    if (H5F_HAS_FEATURE(dset->oloc.file, H5FD_FEAT_HAS_MPI))
+        HGOTO_DONE(FALSE)
+#endif /* H5_HAVE_PARALLEL */
+
+    if (H5D_CONTIGUOUS == layout->type) {
+        /* Write out the sieve buffer, and drop it if it's about to go stale */
+        if (H5D__flush_sieve_buf(dset) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "can't flush sieve buffer")
+        if (do_write) {
+            dset->shared->cache.contig.sieve_loc = HADDR_UNDEF;
+            dset->shared->cache.contig.sieve_size = 0;
+        } /* end if */
+    } /* end if */
+    else if (H5D_CHUNKED == layout->type) {
+        int sndims;                     /* Rank of the file dataspace */
+
+        /* Filtered chunks must go through the pipeline */
+        if (dset->shared->dcpl_cache.pline.nused > 0)
+            HGOTO_DONE(FALSE)
+#ifdef H5F_HAVE_CONCURRENT_READS
+        /* Chunk lookups in a file read concurrently need the dataset's read lock */
+        if (H5F_concurrent_reads(dset->oloc.file))
+            HGOTO_DONE(FALSE)
+#endif /* H5F_HAVE_CONCURRENT_READS */
+
+        if ((sndims = H5S_get_simple_extent_dims(io->sel_file_space, dims, NULL)) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get file dataspace dimensions")
+        rank = (unsigned)sndims;
+        if (0 == rank || rank + 1 != layout->u.chunk.ndims)
+            HGOTO_DONE(FALSE)
+
+        /* Compute the element strides within a chunk */
+        down_chunk[rank - 1] = 1;
+        for (d = rank - 1; d > 0; d--)
+            down_chunk[d - 1] = down_chunk[d] * layout->u.chunk.dim[d];
+        HDmemset(scaled, 0, sizeof(scaled));
+    } /* end if */
+    else
+        HGOTO_DONE(FALSE)
+
+    /* Set up the selections' sequences */
+    if (H5D__multi_seq_init(&file_seq, io->sel_file_space, H5S_GET_SEQ_LIST_SORTED, io->nelmts, io->type_size) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't initialize file selection sequences")
+    if (H5D__multi_seq_init(&mem_seq, io->sel_mem_space, 0, io->nelmts, io->type_size) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "can't initialize memory selection sequences")
+
+    /* Map each sequence of the file selection to blocks of the file, and
+     * pair them with the memory selection
+     */
+    nbytes = io->nelmts * io->type_size;
+    while (nbytes > 0) {
+        hsize_t off;                    /* Offset of sequence in dataset */
+        size_t len;                     /* Length of sequence */
+
+        if (H5D__multi_seq_next(&file_seq, nbytes, &off, &len) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get file selection sequence")
+        nbytes -= len;
+
+        if (H5D_CONTIGUOUS == layout->type) {
+            if (H5D__multi_io_add(vec, &mem_seq, io->idx, layout->storage.u.contig.addr + off, len) < 0)
+                HGOTO_ERROR(H5E_DATASET, H5E_CANTINSERT, FAIL, "can't add block for vector I/O")
+        } /* end if */
+        else {
+            hsize_t elmt = off / io->type_size;     /* Index of first element */
+            size_t nelmts = len / io->type_size;    /* Number of elements */
+
+            /* Split the sequence where it crosses into another chunk */
+            while (nelmts > 0) {
+                hsize_t chunk_off = 0;  /* Element offset within chunk */
+                hsize_t run;            /* Number of elements in this chunk */
+                hbool_t same_chunk = have_chunk;    /* Whether the chunk is the current one */
+
+                if (H5VM_array_calc(elmt, rank, dims, coords) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't compute element coordinates")
+                run = MIN3((hsize_t)nelmts, dims[rank - 1] - coords[rank - 1],
+                        layout->u.chunk.dim[rank - 1] - (coords[rank - 1] % layout->u.chunk.dim[rank - 1]));
+                for (d = 0; d < rank; d++) {
+                    hsize_t chunk_scaled = coords[d] / layout->u.chunk.dim[d];
+
+                    if (chunk_scaled != scaled[d])
+                        same_chunk = FALSE;
+                    scaled[d] = chunk_scaled;
+                    chunk_off += (coords[d] % layout->u.chunk.dim[d]) * down_chunk[d];
+                } /* end for */
+
+                if (!same_chunk) {
+                    H5D_chunk_ud_t udata;       /* Chunk index pass-through */
+
+                    if (H5D__chunk_lookup(dset, scaled, &udata) < 0)
+                        HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+
+                    /* Chunks in the cache may be newer than the file, and
+                     * chunks without storage hold fill values or need
+                     * allocating
+                     */
+                    if (UINT_MAX != udata.idx_hint || !H5F_addr_defined(udata.chunk_block.offset))
+                        HGOTO_DONE(FALSE)
+                    chunk_addr = udata.chunk_block.offset;
+                    have_chunk = TRUE;
+                } /* end if */
+
+                if (H5D__multi_io_add(vec, &mem_seq, io->idx, chunk_addr + chunk_off * io->type_size,
+                        (size_t)run * io->type_size) < 0)
+                    HGOTO_ERROR(H5E_DATASET, H5E_CANTINSERT, FAIL, "can't add block for vector I/O")
+                elmt += run;
+                nelmts -= (size_t)run;
+            } /* end while */
+        } /* end else */
+    } /* end while */
+
+done:
+    /* Drop this dataset's blocks, if it isn't transferred with vector I/O */
+    if (ret_value != TRUE)
+        vec->nused = nused;
+
+    if (H5D__multi_seq_term(&file_seq) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTRELEASE, FAIL, "can't release file selection sequences")
+    if (H5D__multi_seq_term(&mem_seq) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTRELEASE, FAIL, "can't release memory selection sequences")
+
+    FUNC_LEAVE_NOAPI_TAG(ret_value)
+} /* end H5D__multi_io_gather() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_io_add
+ *
+ * Purpose:	Adds a block of LEN bytes at ADDR in the file to VEC,
+ *		paired with the next LEN bytes of the memory selection.
+ *		The block is split where the memory selection isn't
+ *		contiguous, and merged with the previous block where both
+ *		follow on from it.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__multi_io_add(H5D_multi_vec_t *vec, H5D_multi_seq_t *mem_seq, size_t idx,
+    haddr_t addr, size_t len)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(vec);
+    HDassert(mem_seq);
+
+    while (len > 0) {
+        hsize_t mem_off;                /* Offset of piece in buffer */
+        size_t mem_len;                 /* Length of piece */
+        size_t last = vec->nused - 1;   /* Index of previous block */
+
+        if (H5D__multi_seq_next(mem_seq, len, &mem_off, &mem_len) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't get memory selection sequence")
+
+        if (vec->nused > 0 && vec->idx[last] == idx
+                && H5F_addr_eq(vec->addrs[last] + vec->sizes[last], addr)
+                && vec->mem_off[last] + vec->sizes[last] == mem_off)
+            vec->sizes[last] += mem_len;
+        else {
+            /* Make room for another block */
+            if (vec->nused == vec->nalloc) {
+                size_t nalloc = MAX(H5D_MULTI_VEC_NBLOCKS, 2 * vec->nalloc);
+                void *tmp;
+
+                if (NULL == (tmp = H5MM_realloc(vec->addrs, nalloc * sizeof(haddr_t))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector I/O blocks")
+                vec->addrs = (haddr_t *)tmp;
+                if (NULL == (tmp = H5MM_realloc(vec->sizes, nalloc * sizeof(size_t))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector I/O blocks")
+                vec->sizes = (size_t *)tmp;
+                if (NULL == (tmp = H5MM_realloc(vec->idx, nalloc * sizeof(size_t))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector I/O blocks")
+                vec->idx = (size_t *)tmp;
+                if (NULL == (tmp = H5MM_realloc(vec->mem_off, nalloc * sizeof(hsize_t))))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector I/O blocks")
+                vec->mem_off = (hsize_t *)tmp;
+                vec->nalloc = nalloc;
+            } /* end if */
+
+            vec->addrs[vec->nused] = addr;
+            vec->sizes[vec->nused] = mem_len;
+            vec->idx[vec->nused] = idx;
+            vec->mem_off[vec->nused] = mem_off;
+            vec->nused++;
+        } /* end else */
+
+        addr += mem_len;
+        len -= mem_len;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_io_add() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_seq_init
+ *
+ * Purpose:	Sets up the sequences of NELMTS elements of ELMT_SIZE bytes
+ *		selected in SPACE, generated with FLAGS.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__multi_seq_init(H5D_multi_seq_t *seq, const H5S_t *space, unsigned flags,
+    size_t nelmts, size_t elmt_size)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(seq);
+    HDassert(space);
+
+    seq->space = space;
+    seq->flags = flags;
+    seq->nelmts = nelmts;
+    seq->nseq = seq->curr_seq = 0;
+    if (NULL == (seq->off = H5FL_SEQ_MALLOC(hsize_t, (size_t)H5D_IO_VECTOR_SIZE)))
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTALLOC, FAIL, "can't allocate I/O offset vector array")
+    if (NULL == (seq->len = H5FL_SEQ_MALLOC(size_t, (size_t)H5D_IO_VECTOR_SIZE)))
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTALLOC, FAIL, "can't allocate I/O length vector array")
+    if (H5S_select_iter_init(&seq->iter, space, elmt_size) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "unable to initialize selection iterator")
+    seq->iter_init = TRUE;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_seq_init() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_seq_next
+ *
+ * Purpose:	Takes up to MAX_LEN bytes from the start of the next
+ *		sequence in SEQ, generating more sequences as needed.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__multi_seq_next(H5D_multi_seq_t *seq, size_t max_len, hsize_t *off, size_t *len)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(seq);
+    HDassert(max_len > 0);
+    HDassert(off);
+    HDassert(len);
+
+    /* Get more sequences, if they've all been used */
+    if (seq->curr_seq == seq->nseq) {
+        size_t nelem;                   /* Number of elements in sequences */
+
+        if (0 == seq->nelmts)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_BADRANGE, FAIL, "no more elements in selection")
+        if (H5S_SELECT_GET_SEQ_LIST(seq->space, seq->flags, &seq->iter, (size_t)H5D_IO_VECTOR_SIZE,
+                seq->nelmts, &seq->nseq, &nelem, seq->off, seq->len) < 0)
+            HGOTO_ERROR(H5E_DATASPACE, H5E_UNSUPPORTED, FAIL, "sequence length generation failed")
+        HDassert(seq->nseq > 0);
+        seq->nelmts -= nelem;
+        seq->curr_seq = 0;
+    } /* end if */
+
+    /* Take the start of the current sequence */
+    *off = seq->off[seq->curr_seq];
+    *len = MIN(max_len, seq->len[seq->curr_seq]);
+    seq->off[seq->curr_seq] += *len;
+    seq->len[seq->curr_seq] -= *len;
+    if (0 == seq->len[seq->curr_seq])
+        seq->curr_seq++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_seq_next() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__multi_seq_term
+ *
+ * Purpose:	Releases the resources of SEQ.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__multi_seq_term(H5D_multi_seq_t *seq)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(seq);
+
+    if (seq->iter_init && H5S_SELECT_ITER_RELEASE(&seq->iter) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTRELEASE, FAIL, "unable to release selection iterator")
+    seq->iter_init = FALSE;
+
+done:
+    if (seq->off)
+        seq->off = H5FL_SEQ_FREE(hsize_t, seq->off);
+    if (seq->len)
+        seq->len = H5FL_SEQ_FREE(size_t, seq->len);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__multi_seq_term() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__io_async
+ *
+ * Purpose:	Checks the arguments for an asynchronous dataset read or
+ *		write and inserts the operation in an event set.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__io_async(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
+    hid_t file_space_id, hid_t dxpl_id, void *rbuf, const void *wbuf,
+    hbool_t do_write, hid_t es_id)
+{
+    H5D_t          *dset;                       /* Dataset */
+    const H5S_t    *mem_space = NULL;           /* Memory dataspace */
+    const H5S_t    *file_space = NULL;          /* File dataspace */
+    H5D_async_io_t *aio = NULL;                 /* Asynchronous operation */
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Get dataset pointer and ensure it's associated with a file */
+    if (NULL == (dset = (H5D_t *)H5I_object_verify(dset_id, H5I_DATASET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "dset_id is not a dataset ID")
+    if (NULL == dset->oloc.file)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "dataset is not associated with a file")
+    if (NULL == H5I_object_verify(mem_type_id, H5I_DATATYPE))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "mem_type_id is not a datatype ID")
+
+    /* Get validated dataspace pointers */
+    if (H5S_get_validated_dataspace(mem_space_id, &mem_space) < 0)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "could not get a validated dataspace from mem_space_id")
+    if (H5S_get_validated_dataspace(file_space_id, &file_space) < 0)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "could not get a validated dataspace from file_space_id")
+
+    /* Get the default dataset transfer property list if the user didn't provide one */
+    if (H5P_DEFAULT == dxpl_id)
+        dxpl_id = H5P_DATASET_XFER_DEFAULT;
+    else
+        if (TRUE != H5P_isa_class(dxpl_id, H5P_DATASET_XFER))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not xfer parms")
+
+    /* Set up the operation, holding on to everything it uses */
+    if (NULL == (aio = (H5D_async_io_t *)H5MM_calloc(sizeof(H5D_async_io_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate asynchronous operation")
+    aio->dset_id = H5I_INVALID_HID;
+    aio->mem_type_id = H5I_INVALID_HID;
+    aio->dxpl_id = H5I_INVALID_HID;
+    aio->rbuf = rbuf;
+    aio->wbuf = wbuf;
+    aio->do_write = do_write;
+    if (H5I_inc_ref(dset_id, FALSE) < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINC, FAIL, "can't increment dataset ID's reference count")
+    aio->dset_id = dset_id;
+    if (H5I_inc_ref(mem_type_id, FALSE) < 0)
+        HGOTO_ERROR(H5E_DATATYPE, H5E_CANTINC, FAIL, "can't increment datatype ID's reference count")
+    aio->mem_type_id = mem_type_id;
+    if (mem_space && NULL == (aio->mem_space = H5S_copy(mem_space, FALSE, TRUE)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCOPY, FAIL, "can't copy memory dataspace")
+    if (file_space && NULL == (aio->file_space = H5S_copy(file_space, FALSE, TRUE)))
+        HGOTO_ERROR(H5E_DATASPACE, H5E_CANTCOPY, FAIL, "can't copy file dataspace")
+    if (H5P_DATASET_XFER_DEFAULT == dxpl_id) {
+        if (H5I_inc_ref(dxpl_id, FALSE) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTINC, FAIL, "can't increment property list ID's reference count")
+        aio->dxpl_id = dxpl_id;
+    } /* end if */
+    else {
+        H5P_genplist_t *plist;                  /* Transfer property list */
+
+        if (NULL == (plist = (H5P_genplist_t *)H5I_object(dxpl_id)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a property list")
+        if ((aio->dxpl_id = H5P_copy_plist(plist, FALSE)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTCOPY, FAIL, "can't copy transfer property list")
+    } /* end else */
+
+    /* Insert the operation.  The event set releases it from here on. */
+    ret_value = H5ES_insert(es_id, do_write ? "H5Dwrite_async" : "H5Dread_async",
+            H5D__io_async_exec, H5D__io_async_free, aio);
+    aio = NULL;
+    if (ret_value < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTINSERT, FAIL, "can't insert operation in event set")
+
+done:
+    if (aio && H5D__io_async_free(aio) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTFREE, FAIL, "can't release asynchronous operation")
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__io_async() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__io_async_exec
+ *
+ * Purpose:	Performs an asynchronous dataset read or write, for the
+ *		event set it was inserted in.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__io_async_exec(void *_aio)
+{
+    H5D_async_io_t *aio = (H5D_async_io_t *)_aio;  /* Asynchronous operation */
+    H5D_t          *dset;                       /* Dataset */
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(aio);
+
+    if (NULL == (dset = (H5D_t *)H5I_object(aio->dset_id)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataset")
+
+    /* Set DXPL for operation */
+    H5CX_set_dxpl(aio->dxpl_id);
+
+    if (aio->do_write) {
+        if (H5D__write(dset, aio->mem_type_id, aio->mem_space, aio->file_space, aio->wbuf) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_WRITEERROR, FAIL, "can't write data")
+    } /* end if */
+    else
+        if (H5D__read(dset, aio->mem_type_id, aio->mem_space, aio->file_space, aio->rbuf) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_READERROR, FAIL, "can't read data")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__io_async_exec() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5D__io_async_free
+ *
+ * Purpose:	Releases an asynchronous dataset read or write and what it
+ *		holds on to.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5D__io_async_free(void *_aio)
+{
+    H5D_async_io_t *aio = (H5D_async_io_t *)_aio;  /* Asynchronous operation */
+    herr_t          ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(aio);
+
+    if (aio->dset_id >= 0 && H5I_dec_ref(aio->dset_id) < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTDEC, FAIL, "can't decrement dataset ID's reference count")
+    if (aio->mem_type_id >= 0 && H5I_dec_ref(aio->mem_type_id) < 0)
+        HDONE_ERROR(H5E_DATATYPE, H5E_CANTDEC, FAIL, "can't decrement datatype ID's reference count")
+    if (aio->mem_space && H5S_close(aio->mem_space) < 0)
+        HDONE_ERROR(H5E_DATASPACE, H5E_CANTRELEASE, FAIL, "can't close memory dataspace")
+    if (aio->file_space && H5S_close(aio->file_space) < 0)
+        HDONE_ERROR(H5E_DATASPACE, H5E_CANTRELEASE, FAIL, "can't close file dataspace")
+    if (aio->dxpl_id >= 0 && H5I_dec_ref(aio->dxpl_id) < 0)
+        HDONE_ERROR(H5E_PLIST, H5E_CANTDEC, FAIL, "can't decrement property list ID's reference count")
+    aio = (H5D_async_io_t *)H5MM_xfree(aio);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5D__io_async_free() */
+
@@ -620,6 +620,12 @@ H5D__layout_oh_read(H5D_t *dataset, hid_t dapl_id, H5P_genplist_t *plist)
         if(NULL == H5O_msg_read(&(dataset->oloc), H5O_PLINE_ID, &dataset->shared->dcpl_cache.pline))
             HGOTO_ERROR(H5E_DATASET, H5E_CANTGET, FAIL, "can't retrieve message")
 
+#ifdef H5_HAVE_FILTER_ZSTD
+        /* Load any dictionaries the zstd filters need */
+        if(H5D__zstd_dicts_load(dataset->oloc.file, &dataset->shared->dcpl_cache.pline, FALSE) < 0)
+            HGOTO_ERROR(H5E_DATASET, H5E_CANTINIT, FAIL, "unable to load zstd dictionaries")
+#endif /* H5_HAVE_FILTER_ZSTD */
+
         /* Set the I/O pipeline info in the property list */
         if(H5P_set(plist, H5O_CRT_PIPELINE_NAME, &dataset->shared->dcpl_cache.pline) < 0)
             HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set pipeline")
@@ -271,6 +271,9 @@ typedef struct H5D_chunk_ud_t {
     unsigned    filter_mask;            /* Excluded filters */
     hbool_t     new_unfilt_chunk;       /* Whether the chunk just became unfiltered */
     hsize_t     chunk_idx;              /* Chunk index for EA, FA indexing */
+
+    /* Downward (for H5D__chunk_lock) */
+    void        *decoded_chunk;         /* Chunk already read (& passed back through the I/O pipeline, if filtered), if non-NULL */
 } H5D_chunk_ud_t;
 
 /* Typedef for "generic" chunk callbacks */
@@ -387,16 +390,23 @@ typedef struct H5D_virtual_held_file_t {
 
 /* The raw data chunk cache */
 struct H5D_rdcc_ent_t;  /* Forward declaration of struct used below */
+struct H5D_rdcc_shared_t;  /* Forward declaration of struct used below */
 typedef struct H5D_rdcc_t {
     struct {
         unsigned    ninits;    /* Number of chunk creations        */
         unsigned    nhits;     /* Number of cache hits            */
         unsigned    nmisses;   /* Number of cache misses        */
         unsigned    nflushes;  /* Number of cache flushes        */
+        unsigned    nshared;   /* Number of chunks preempted for the shared budget */
+        unsigned    nghost_hits; /* Number of misses on chunks recently preempted from the FIFO queue (2Q) */
+        unsigned    nread_ahead; /* Number of chunks loaded ahead of being read */
     } stats;
     size_t        nbytes_max;  /* Maximum cached raw data in bytes    */
     size_t        nslots;      /* Number of chunk slots allocated    */
     double        w0;          /* Chunk preemption policy          */
+    H5D_chunk_cache_policy_t policy; /* Chunk replacement policy    */
+    size_t        read_ahead;  /* Max. # of chunks to read ahead    */
+    size_t        read_gap;    /* Max. gap between uncached chunks read together, in bytes */
     struct H5D_rdcc_ent_t *head; /* Head of doubly linked list        */
     struct H5D_rdcc_ent_t *tail; /* Tail of doubly linked list        */
     struct H5D_rdcc_ent_t *tmp_head; /* Head of temporary doubly linked list.  Chunks on this list are not in the hash table (slot).  The head entry is a sentinel (does not refer to an actual chunk). */
@@ -404,6 +414,25 @@ typedef struct H5D_rdcc_t {
     int           nused;        /* Number of chunk slots in use        */
     H5D_chunk_cached_t last;    /* Cached copy of last chunk information */
     struct H5D_rdcc_ent_t **slot; /* Chunk slots, each points to a chunk*/
+
+    /* Information for the 2Q policy.  The list of chunks holds the FIFO
+     * queue (A1in), oldest first, followed by the LRU queue (Am).  The
+     * slots are an open addressing hash table, which also holds "ghost"
+     * entries for the chunks recently preempted from the FIFO queue (A1out).
+     */
+    struct H5D_rdcc_ent_t *hot_head; /* First chunk in the LRU queue */
+    size_t        nbytes_cold;  /* Cached raw data in the FIFO queue, in bytes */
+    struct H5D_rdcc_ent_t *ghost_head; /* Oldest ghost entry */
+    struct H5D_rdcc_ent_t *ghost_tail; /* Newest ghost entry */
+    size_t        nghosts;      /* Number of ghost entries */
+    size_t        nslots_full;  /* Number of slots which aren't empty, including ones left by removed entries */
+
+    /* Chunks selected by the last reads, for detecting access patterns to read ahead */
+    hbool_t       ra_valid;     /* Whether the chunks of a read have been recorded */
+    hsize_t       ra_first;     /* Index of the first chunk selected by the last read */
+    hsize_t       ra_last;      /* Index of the last chunk selected by the last read */
+    hsize_t       ra_stride;    /* # of chunks between the first chunks of the last two reads which started at different chunks */
+
     H5SL_t        *sel_chunks;    /* Skip list containing information for each chunk selected */
     H5S_t         *single_space;  /* Dataspace for single element I/O on chunks */
     H5D_chunk_info_t    *single_chunk_info;  /* Pointer to single chunk's info */
@@ -412,8 +441,23 @@ typedef struct H5D_rdcc_t {
     hsize_t             scaled_dims[H5S_MAX_RANK];          /* The scaled dim sizes */
     hsize_t             scaled_power2up[H5S_MAX_RANK];      /* The scaled dim sizes, rounded up to next power of 2 */
     unsigned            scaled_encode_bits[H5S_MAX_RANK];   /* The number of bits needed to encode the scaled dim sizes */
+
+    /* Budget shared with the other datasets in the file, if enabled */
+    struct H5D_rdcc_shared_t *shared;   /* Shared budget (or NULL) */
+    const struct H5D_t  *dset;          /* An open handle for the dataset, for preempting its chunks on behalf of other datasets (or NULL) */
+    struct H5D_rdcc_t   *shared_next;   /* Next cache using the shared budget */
+    struct H5D_rdcc_t   *shared_prev;   /* Previous cache using the shared budget */
+    unsigned            shared_gen;     /* Last preemption pass that gave up on this cache */
 } H5D_rdcc_t;
 
+/* The raw data chunk cache budget shared by all the datasets in a file */
+typedef struct H5D_rdcc_shared_t {
+    size_t        nbytes_max;   /* Maximum cached raw data in bytes, for all datasets */
+    size_t        nbytes_used;  /* Current cached raw data in bytes, for all datasets */
+    H5D_rdcc_t    *head;        /* List of datasets' caches using the budget */
+    unsigned      gen;          /* Current preemption pass */
+} H5D_rdcc_shared_t;
+
 /* The raw data contiguous data cache */
 typedef struct H5D_rdcdc_t {
     unsigned char *sieve_buf;   /* Buffer to hold data sieve buffer */
@@ -459,6 +503,9 @@ typedef struct H5D_shared_t {
     H5D_append_flush_t   append_flush;   /* Append flush property information */
     char                *extfile_prefix; /* expanded external file prefix */
     char                *vds_prefix;     /* expanded vds prefix */
+#ifdef H5F_HAVE_CONCURRENT_READS
+    H5TS_mutex_t        *read_lock;      /* Serializes reads which release the library lock */
+#endif /* H5F_HAVE_CONCURRENT_READS */
 } H5D_shared_t;
 
 struct H5D_t {
@@ -578,6 +625,9 @@ H5_DLL herr_t H5D__flush(H5D_t *dset, hid_t dset_id);
 H5_DLL hid_t H5D__get_create_plist(const H5D_t *dset);
 H5_DLL herr_t H5D__mark(const H5D_t *dataset, unsigned flags);
 H5_DLL herr_t H5D__refresh(hid_t dset_id, H5D_t *dataset);
+#ifdef H5_HAVE_FILTER_ZSTD
+H5_DLL herr_t H5D__zstd_dicts_load(H5F_t *f, H5O_pline_t *pline, hbool_t set_keys);
+#endif /* H5_HAVE_FILTER_ZSTD */
 
 /* To convert a dataset's chunk indexing type to v1 B-tree */
 H5_DLL herr_t H5D__format_convert(H5D_t *dataset);
@@ -758,6 +808,8 @@ H5_DLL herr_t H5D__layout_compact_dirty_test(hid_t did, hbool_t *dirty);
 H5_DLL herr_t H5D__layout_idx_type_test(hid_t did, H5D_chunk_index_t *idx_type);
 H5_DLL herr_t H5D__layout_type_test(hid_t did, H5D_layout_t *layout_type);
 H5_DLL herr_t H5D__current_cache_size_test(hid_t did, size_t *nbytes_used, int *nused);
+H5_DLL herr_t H5D__shared_cache_size_test(hid_t did, size_t *nbytes_used, unsigned *nshared);
+H5_DLL herr_t H5D__chunk_addr_test(hid_t did, const hsize_t *scaled, haddr_t *addr);
 #endif /* H5D_TESTING */
 
 #endif /*_H5Dpkg_H*/
@@ -50,6 +50,9 @@
 #define H5D_ACS_DATA_CACHE_NUM_SLOTS_NAME   "rdcc_nslots"    /* Size of raw data chunk cache(slots) */
 #define H5D_ACS_DATA_CACHE_BYTE_SIZE_NAME   "rdcc_nbytes"    /* Size of raw data chunk cache(bytes) */
 #define H5D_ACS_PREEMPT_READ_CHUNKS_NAME    "rdcc_w0"        /* Preemption read chunks first */
+#define H5D_ACS_DATA_CACHE_POLICY_NAME      "rdcc_policy"    /* Raw data chunk cache replacement policy */
+#define H5D_ACS_DATA_CACHE_READ_AHEAD_NAME  "rdcc_read_ahead" /* Raw data chunk cache read-ahead window (chunks) */
+#define H5D_ACS_CHUNK_READ_GAP_NAME         "chunk_read_gap" /* Max. gap between uncached chunks read together (bytes) */
 #define H5D_ACS_VDS_VIEW_NAME               "vds_view"       /* VDS view option */
 #define H5D_ACS_VDS_PRINTF_GAP_NAME         "vds_printf_gap" /* VDS printf gap size */
 #define H5D_ACS_VDS_PREFIX_NAME             "vds_prefix"     /* VDS file prefix */
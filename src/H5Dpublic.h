@@ -101,6 +101,14 @@ typedef enum H5D_vds_view_t {
     H5D_VDS_LAST_AVAILABLE      = 1
 } H5D_vds_view_t;
 
+/* Values for the chunk cache replacement policy */
+typedef enum H5D_chunk_cache_policy_t {
+    H5D_CHUNK_CACHE_POLICY_ERROR = -1,
+    H5D_CHUNK_CACHE_POLICY_LRU  = 0,    /* Hashed slots, LRU adjusted by w0 (default) */
+    H5D_CHUNK_CACHE_POLICY_2Q   = 1,    /* Resizable hash index, 2Q replacement */
+    H5D_CHUNK_CACHE_POLICY_NTYPES       /* This one must be last! */
+} H5D_chunk_cache_policy_t;
+
 /* Callback for H5Pset_append_flush() in a dataset access property list */
 typedef herr_t (*H5D_append_cb_t)(hid_t dataset_id, hsize_t *cur_dims, void *op_data);
 
@@ -141,11 +149,22 @@ H5_DLL hid_t H5Dget_create_plist(hid_t dset_id);
 H5_DLL hid_t H5Dget_access_plist(hid_t dset_id);
 H5_DLL hsize_t H5Dget_storage_size(hid_t dset_id);
 H5_DLL herr_t H5Dget_chunk_storage_size(hid_t dset_id, const hsize_t *offset, hsize_t *chunk_bytes);
+H5_DLL herr_t H5Dget_chunk_cache_stats(hid_t dset_id, unsigned *nhits, unsigned *nmisses);
 H5_DLL haddr_t H5Dget_offset(hid_t dset_id);
 H5_DLL herr_t H5Dread(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
 			hid_t file_space_id, hid_t plist_id, void *buf/*out*/);
 H5_DLL herr_t H5Dwrite(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
 			 hid_t file_space_id, hid_t plist_id, const void *buf);
+H5_DLL herr_t H5Dread_multi(size_t count, const hid_t dset_id[],
+            const hid_t mem_type_id[], const hid_t mem_space_id[],
+            const hid_t file_space_id[], hid_t dxpl_id, void *buf[]/*out*/);
+H5_DLL herr_t H5Dwrite_multi(size_t count, const hid_t dset_id[],
+            const hid_t mem_type_id[], const hid_t mem_space_id[],
+            const hid_t file_space_id[], hid_t dxpl_id, const void *buf[]);
+H5_DLL herr_t H5Dread_async(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
+            hid_t file_space_id, hid_t dxpl_id, void *buf/*out*/, hid_t es_id);
+H5_DLL herr_t H5Dwrite_async(hid_t dset_id, hid_t mem_type_id, hid_t mem_space_id,
+            hid_t file_space_id, hid_t dxpl_id, const void *buf, hid_t es_id);
 H5_DLL herr_t H5Dwrite_chunk(hid_t dset_id, hid_t dxpl_id, uint32_t filters, 
             const hsize_t *offset, size_t data_size, const void *buf);
 H5_DLL herr_t H5Dread_chunk(hid_t dset_id, hid_t dxpl_id,
@@ -29,6 +29,7 @@
 /* Headers */
 /***********/
 #include "H5private.h"		/* Generic Functions			*/
+#include "H5CXprivate.h"        /* API Contexts                         */
 #include "H5Dpkg.h"		/* Datasets 				*/
 #include "H5Eprivate.h"		/* Error handling		  	*/
 #include "H5Iprivate.h"		/* IDs			  		*/
@@ -308,3 +309,116 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* H5D__current_cache_size_test() */
 
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5D__shared_cache_size_test
+ PURPOSE
+    Determine the current use of the chunk cache budget shared by all the
+    datasets in the dataset's file
+ USAGE
+    herr_t H5D__shared_cache_size_test(did, nbytes_used, nshared)
+        hid_t did;              IN: Dataset to query
+        size_t *nbytes_used;    OUT: Bytes cached by all the datasets
+        unsigned *nshared;      OUT: # of chunks preempted from this
+                                     dataset for the shared budget
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Checks the shared chunk cache budget of a chunked dataset's file.
+    NBYTES_USED is set to 0 if the file has no shared budget.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    DO NOT USE THIS FUNCTION FOR ANYTHING EXCEPT TESTING
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+herr_t
+H5D__shared_cache_size_test(hid_t did, size_t *nbytes_used, unsigned *nshared)
+{
+    H5D_t	*dset;          /* Pointer to dataset to query */
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check args */
+    if(NULL == (dset = (H5D_t *)H5I_object_verify(did, H5I_DATASET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataset")
+    HDassert(dset->shared->layout.type == H5D_CHUNKED);
+
+    if(nbytes_used)
+        *nbytes_used = dset->shared->cache.chunk.shared ?
+                dset->shared->cache.chunk.shared->nbytes_used : 0;
+
+    if(nshared)
+        *nshared = dset->shared->cache.chunk.stats.nshared;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* H5D__shared_cache_size_test() */
+
+
+/*--------------------------------------------------------------------------
+ NAME
+    H5D__chunk_addr_test
+ PURPOSE
+    Determine the address of one of a chunked dataset's chunks in the file
+ USAGE
+    herr_t H5D__chunk_addr_test(did, scaled, addr)
+        hid_t did;              IN: Dataset to query
+        const hsize_t *scaled;  IN: Scaled coordinates of chunk
+        haddr_t *addr;          OUT: Address of chunk
+ RETURNS
+    Non-negative on success, negative on failure
+ DESCRIPTION
+    Looks up the chunk in the dataset's chunk index.  ADDR is set to
+    HADDR_UNDEF if the chunk hasn't been allocated.
+ GLOBAL VARIABLES
+ COMMENTS, BUGS, ASSUMPTIONS
+    DO NOT USE THIS FUNCTION FOR ANYTHING EXCEPT TESTING
+ EXAMPLES
+ REVISION LOG
+--------------------------------------------------------------------------*/
+herr_t
+H5D__chunk_addr_test(hid_t did, const hsize_t *scaled, haddr_t *addr)
+{
+    H5D_t	*dset;          /* Pointer to dataset to query */
+    hsize_t     my_scaled[H5O_LAYOUT_NDIMS];    /* Scaled coordinates of chunk */
+    H5D_chunk_ud_t udata;       /* Chunk index pass-through */
+    hbool_t     api_ctx_pushed = FALSE;         /* Whether API context pushed */
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Check args */
+    if(NULL == (dset = (H5D_t *)H5I_object_verify(did, H5I_DATASET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataset")
+    HDassert(dset->shared->layout.type == H5D_CHUNKED);
+    HDassert(scaled);
+    HDassert(addr);
+
+    /* Set API context */
+    if(H5CX_push() < 0)
+        HGOTO_ERROR(H5E_DATASET, H5E_CANTSET, FAIL, "can't set API context")
+    api_ctx_pushed = TRUE;
+
+    /* Set metadata tag in API context */
+    H5_BEGIN_TAG(dset->oloc.addr);
+
+    /* Look up the chunk */
+    HDmemcpy(my_scaled, scaled, dset->shared->ndims * sizeof(hsize_t));
+    my_scaled[dset->shared->ndims] = 0;
+    if(H5D__chunk_lookup(dset, my_scaled, &udata) < 0)
+        HGOTO_ERROR_TAG(H5E_DATASET, H5E_CANTGET, FAIL, "error looking up chunk address")
+    *addr = udata.chunk_block.offset;
+
+    /* Reset metadata tag in API context */
+    H5_END_TAG
+
+done:
+    if(api_ctx_pushed && H5CX_pop() < 0)
+        HDONE_ERROR(H5E_DATASET, H5E_CANTRESET, FAIL, "can't reset API context")
+
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* H5D__chunk_addr_test() */
+
@@ -86,9 +86,7 @@ static ssize_t H5E_get_class_name(const H5E_cls_t *cls, char *name, size_t size)
 static int H5E_close_msg_cb(void *obj_ptr, hid_t obj_id, void *udata);
 static herr_t  H5E_close_msg(H5E_msg_t *err);
 static H5E_msg_t *H5E_create_msg(H5E_cls_t *cls, H5E_type_t msg_type, const char *msg);
-static H5E_t  *H5E_get_current_stack(void);
 static herr_t  H5E_set_current_stack(H5E_t *estack);
-static herr_t  H5E_close_stack(H5E_t *err_stack);
 static ssize_t H5E_get_num(const H5E_t *err_stack);
 
 
@@ -377,6 +375,7 @@ H5E_get_stack(void)
 
         /* Set the thread-specific info */
         estack->nused = 0;
+        estack->paused = 0;
         H5E_set_default_auto(estack);
 
         /* (It's not necessary to release this in this API, it is
@@ -955,7 +954,8 @@ done:
 /*-------------------------------------------------------------------------
  * Function:	H5E_get_current_stack
  *
- * Purpose:	Private function to register an error stack.
+ * Purpose:	Private function to copy the current error stack, leaving
+ *              it empty.
  *
  * Return:	Non-negative value as class ID on success/Negative on failure
  *
@@ -964,7 +964,7 @@ done:
  *
  *-------------------------------------------------------------------------
  */
-static H5E_t *
+H5E_t *
 H5E_get_current_stack(void)
 {
     H5E_t	*current_stack;         /* Pointer to the current error stack */
@@ -1191,7 +1191,7 @@ done:
  *
  *-------------------------------------------------------------------------
  */
-static herr_t
+herr_t
 H5E_close_stack(H5E_t *estack)
 {
     FUNC_ENTER_NOAPI_NOINIT_NOERR
@@ -0,0 +1,574 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5ES.c
+ *
+ * Purpose:		Event sets: groups of asynchronous operations which
+ *			an application can wait on together.
+ *
+ *			Operations are performed in the order they were
+ *			inserted, across all event sets, so an operation never
+ *			runs before one it might depend on.  In thread-safe
+ *			builds with worker threads available they are performed
+ *			by a single background thread, which holds the global
+ *			API lock while it works, so the application can compute
+ *			while its I/O proceeds.  Otherwise each operation is
+ *			performed when it is inserted.  Either way, an
+ *			operation's failure is reported by H5ESwait().
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+#include "H5ESmodule.h"         /* This source code file is part of the H5ES module */
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"          /* Generic Functions                    */
+#include "H5CXprivate.h"        /* API Contexts                         */
+#include "H5Eprivate.h"         /* Error handling                       */
+#include "H5ESprivate.h"        /* Event sets                           */
+#include "H5FLprivate.h"        /* Free Lists                           */
+#include "H5Iprivate.h"         /* IDs                                  */
+#include "H5TPprivate.h"        /* Thread pools                         */
+
+
+/****************/
+/* Local Macros */
+/****************/
+
+/* Whether operations are performed by a background thread */
+#if defined(H5_HAVE_THREADSAFE) && defined(H5TP_HAVE_THREADS)
+#define H5ES_HAVE_THREAD
+#define H5ES_NTHREADS   1
+#else /* defined(H5_HAVE_THREADSAFE) && defined(H5TP_HAVE_THREADS) */
+#define H5ES_NTHREADS   0
+#endif /* defined(H5_HAVE_THREADSAFE) && defined(H5TP_HAVE_THREADS) */
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+/* An operation in an event set */
+typedef struct H5ES_op_t {
+    H5TP_task_t task;                   /* Thread pool task for operation */
+    const char *api_name;               /* API routine which inserted operation */
+    H5ES_exec_func_t exec;              /* Callback to perform operation */
+    H5ES_free_func_t free_func;         /* Callback to release operation's data */
+    void *op_data;                      /* Operation's data */
+    H5E_t *err_stack;                   /* Errors from operation, if it failed */
+    struct H5ES_op_t *next;             /* Next operation in event set */
+} H5ES_op_t;
+
+/* An event set */
+typedef struct H5ES_t {
+    H5ES_op_t *head;                    /* First operation, in insertion order */
+    H5ES_op_t *tail;                    /* Last operation */
+    size_t count;                       /* # of operations in event set */
+} H5ES_t;
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+static herr_t H5ES__op_exec(void *_op);
+static herr_t H5ES__wait(H5ES_t *es, size_t *num_failed);
+static herr_t H5ES__close_cb(H5ES_t *es);
+
+
+/*********************/
+/* Package Variables */
+/*********************/
+
+/* Package initialization variable */
+hbool_t H5_PKG_INIT_VAR = FALSE;
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Event set ID class */
+static const H5I_class_t H5I_EVENTSET_CLS[1] = {{
+    H5I_EVENTSET,               /* ID class value */
+    0,                          /* Class flags */
+    0,                          /* # of reserved IDs for class */
+    (H5I_free_t)H5ES__close_cb  /* Callback routine for closing objects of this class */
+}};
+
+/* Declare free lists to manage event sets and their operations */
+H5FL_DEFINE_STATIC(H5ES_t);
+H5FL_DEFINE_STATIC(H5ES_op_t);
+
+/* Thread pool which performs the operations, created on first use */
+static H5TP_t *H5ES_pool_g = NULL;
+
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ES__init_package
+ *
+ * Purpose:     Initializes the event set interface.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5ES__init_package(void)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    /* Initialize the atom group for the event set IDs */
+    if(H5I_register_type(H5I_EVENTSET_CLS) < 0)
+        HGOTO_ERROR(H5E_ATOM, H5E_CANTINIT, FAIL, "unable to initialize ID group")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5ES__init_package() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ES_term_package
+ *
+ * Purpose:     Terminates the event set interface, once every operation
+ *              in an open event set has completed.
+ *
+ * Return:      Success:    Positive if anything was done that might
+ *                          affect other interfaces; zero otherwise.
+ *              Failure:    Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+int
+H5ES_term_package(void)
+{
+    int n = 0;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(H5_PKG_INIT_VAR) {
+        if(H5I_nmembers(H5I_EVENTSET) > 0) {
+            /* Close the open event sets, completing their operations */
+            (void)H5I_clear_type(H5I_EVENTSET, FALSE, FALSE);
+            n++; /*H5I*/
+        } /* end if */
+        else {
+            /* Stop the worker thread, which is idle now */
+            if(H5ES_pool_g) {
+                (void)H5TP_close(H5ES_pool_g);
+                H5ES_pool_g = NULL;
+                n++;
+            } /* end if */
+
+            /* Destroy the event set ID group */
+            n += (H5I_dec_type_ref(H5I_EVENTSET) > 0);
+
+            /* Mark closed */
+            if(0 == n)
+                H5_PKG_INIT_VAR = FALSE;
+        } /* end else */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(n)
+} /* end H5ES_term_package() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5EScreate
+ *
+ * Purpose:     Creates an event set, for asynchronous operations such as
+ *              H5Dwrite_async() to be inserted in.
+ *
+ * Return:      Success:    ID of the new event set
+ *              Failure:    H5I_INVALID_HID
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5EScreate(void)
+{
+    H5ES_t *es = NULL;                  /* New event set */
+    hid_t ret_value = H5I_INVALID_HID;  /* Return value */
+
+    FUNC_ENTER_API(H5I_INVALID_HID)
+    H5TRACE0("i","");
+
+    if(NULL == (es = H5FL_CALLOC(H5ES_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, H5I_INVALID_HID, "can't allocate event set")
+
+    if((ret_value = H5I_register(H5I_EVENTSET, es, TRUE)) < 0)
+        HGOTO_ERROR(H5E_ATOM, H5E_CANTREGISTER, H5I_INVALID_HID, "unable to register event set")
+
+done:
+    if(ret_value < 0 && es)
+        es = H5FL_FREE(H5ES_t, es);
+
+    FUNC_LEAVE_API(ret_value)
+} /* end H5EScreate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ESget_count
+ *
+ * Purpose:     Retrieves the number of operations in an event set which
+ *              haven't been waited for yet, whether or not they have
+ *              completed.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5ESget_count(hid_t es_id, size_t *count/*out*/)
+{
+    H5ES_t *es;                         /* Event set */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", es_id, count);
+
+    if(NULL == (es = (H5ES_t *)H5I_object_verify(es_id, H5I_EVENTSET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not an event set ID")
+
+    if(count)
+        *count = es->count;
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5ESget_count() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ESwait
+ *
+ * Purpose:     Waits for every operation in an event set to complete, and
+ *              removes them from the set.  The number of operations that
+ *              failed is returned in NUM_FAILED, if it's non-NULL; the
+ *              call fails if any did.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5ESwait(hid_t es_id, size_t *num_failed/*out*/)
+{
+    H5ES_t *es;                         /* Event set */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", es_id, num_failed);
+
+    if(NULL == (es = (H5ES_t *)H5I_object_verify(es_id, H5I_EVENTSET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not an event set ID")
+
+    if(H5ES__wait(es, num_failed) < 0)
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTWAIT, FAIL, "operations in event set failed")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5ESwait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ESclose
+ *
+ * Purpose:     Waits for the operations in an event set to complete and
+ *              closes it.  The event set is closed even if an operation
+ *              failed, but the call fails.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5ESclose(hid_t es_id)
+{
+    H5ES_t *es;                         /* Event set */
+    herr_t wait_status;                 /* Status of operations in set */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE1("e", "i", es_id);
+
+    if(NULL == (es = (H5ES_t *)H5I_object_verify(es_id, H5I_EVENTSET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not an event set ID")
+
+    /* Complete the operations, then close the set whatever their outcome */
+    wait_status = H5ES__wait(es, NULL);
+    if(H5I_dec_app_ref(es_id) < 0)
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTCLOSEOBJ, FAIL, "unable to close event set")
+    if(wait_status < 0)
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTWAIT, FAIL, "operations in event set failed")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5ESclose() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ES_insert
+ *
+ * Purpose:     Inserts an operation in an event set and starts it.  EXEC
+ *              is called with OP_DATA to perform the operation and then
+ *              FREE_FUNC to release OP_DATA, after every operation
+ *              inserted before it has completed.  API_NAME names the
+ *              routine that inserted the operation, for error reports.
+ *
+ *              OP_DATA belongs to the event set from here on: if the
+ *              operation can't be inserted, FREE_FUNC is called before
+ *              returning.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5ES_insert(hid_t es_id, const char *api_name, H5ES_exec_func_t exec,
+    H5ES_free_func_t free_func, void *op_data)
+{
+    H5ES_t *es;                         /* Event set */
+    H5ES_op_t *op = NULL;               /* New operation */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(api_name);
+    HDassert(exec);
+    HDassert(free_func);
+
+    if(NULL == (es = (H5ES_t *)H5I_object_verify(es_id, H5I_EVENTSET)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not an event set ID")
+
+    /* Start the worker thread, the first time through */
+    if(NULL == H5ES_pool_g)
+        if(NULL == (H5ES_pool_g = H5TP_create(H5ES_NTHREADS)))
+            HGOTO_ERROR(H5E_EVENTSET, H5E_CANTINIT, FAIL, "can't create thread pool for event sets")
+
+    if(NULL == (op = H5FL_MALLOC(H5ES_op_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate event set operation")
+    op->api_name = api_name;
+    op->exec = exec;
+    op->free_func = free_func;
+    op->op_data = op_data;
+    op->err_stack = NULL;
+    op->next = NULL;
+
+    /* Start the operation.  From here on, it releases its own data. */
+    if(H5TP_submit(H5ES_pool_g, &op->task, H5ES__op_exec, op) < 0)
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTINSERT, FAIL, "can't start operation")
+    op_data = NULL;
+
+    /* Append the operation to the event set */
+    if(es->tail)
+        es->tail->next = op;
+    else
+        es->head = op;
+    es->tail = op;
+    es->count++;
+    op = NULL;
+
+done:
+    if(ret_value < 0) {
+        if(op)
+            op = H5FL_FREE(H5ES_op_t, op);
+        if(op_data && (free_func)(op_data) < 0)
+            HDONE_ERROR(H5E_EVENTSET, H5E_CANTFREE, FAIL, "can't release operation data")
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5ES_insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ES__op_exec
+ *
+ * Purpose:     Thread pool callback which performs an operation and
+ *              releases its data, holding the API lock and in an API
+ *              context of its own, as an API routine would.  Errors are
+ *              reported through the return value, and the errors pushed
+ *              are kept with the operation, for H5ES__wait() to pass on
+ *              to the thread that waits for it.  The error stack is left
+ *              empty.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5ES__op_exec(void *_op)
+{
+    H5ES_op_t *op = (H5ES_op_t *)_op;   /* Operation to perform */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(op);
+
+    H5_API_LOCK
+
+    if(H5CX_push() < 0)
+        ret_value = FAIL;
+    else {
+        if((op->exec)(op->op_data) < 0)
+            ret_value = FAIL;
+        if((op->free_func)(op->op_data) < 0)
+            ret_value = FAIL;
+        op->op_data = NULL;
+
+        (void)H5CX_pop();
+    } /* end else */
+
+    /* Failures are reported to whoever waits for the operation */
+    if(ret_value < 0)
+        op->err_stack = H5E_get_current_stack();
+    (void)H5E_clear_stack(NULL);
+
+    H5_API_UNLOCK
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5ES__op_exec() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ES__wait
+ *
+ * Purpose:     Waits for the operations in an event set to complete and
+ *              removes them from the set.  The number that failed is
+ *              returned in NUM_FAILED, if it's non-NULL, and the errors
+ *              from the failed operations are appended to the caller's
+ *              error stack.
+ *
+ *              In thread-safe builds, the API lock is released while
+ *              waiting so the worker thread can take it.
+ *
+ * Return:      SUCCEED/FAIL (including when an operation failed)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5ES__wait(H5ES_t *es, size_t *num_failed)
+{
+    H5ES_op_t *op;                      /* Operation in event set */
+    const char *failed_name = NULL;     /* Routine for first failed operation */
+    size_t nfailed = 0;                 /* # of failed operations */
+    hbool_t wait_failed = FALSE;        /* Whether waiting for an operation failed */
+#ifdef H5ES_HAVE_THREAD
+    unsigned lock_count = 0;            /* # of times API lock was held */
+#endif /* H5ES_HAVE_THREAD */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(es);
+
+    if(NULL == es->head)
+        HGOTO_DONE(SUCCEED)
+
+#ifdef H5ES_HAVE_THREAD
+    if(H5TS_mutex_unlock_all(&H5_g.init_lock, &lock_count))
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTUNLOCK, FAIL, "can't release API lock")
+#endif /* H5ES_HAVE_THREAD */
+
+    for(op = es->head; op; op = op->next)
+        if(H5TP_task_wait(H5ES_pool_g, &op->task) < 0) {
+            wait_failed = TRUE;
+            break;
+        } /* end if */
+
+#ifdef H5ES_HAVE_THREAD
+    if(H5TS_mutex_relock(&H5_g.init_lock, lock_count))
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTLOCK, FAIL, "can't re-acquire API lock")
+#endif /* H5ES_HAVE_THREAD */
+
+    /* Leave the operations in place if they might still be running */
+    if(wait_failed)
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTWAIT, FAIL, "can't wait for operation")
+
+    /* Remove the completed operations, counting the failures */
+    while(es->head) {
+        op = es->head;
+        es->head = op->next;
+        if(op->task.status < 0) {
+            if(0 == nfailed)
+                failed_name = op->api_name;
+            nfailed++;
+        } /* end if */
+        if(op->err_stack) {
+            if(H5E_append_stack(NULL, op->err_stack) < 0)
+                HDONE_ERROR(H5E_EVENTSET, H5E_CANTSET, FAIL, "can't report operation's errors")
+            (void)H5E_close_stack(op->err_stack);
+        } /* end if */
+        op = H5FL_FREE(H5ES_op_t, op);
+    } /* end while */
+    es->tail = NULL;
+    es->count = 0;
+
+    if(nfailed > 0)
+        HGOTO_ERROR(H5E_EVENTSET, H5E_CANTOPERATE, FAIL, "%lu asynchronous operation(s) failed, the first from %s", (unsigned long)nfailed, failed_name)
+
+done:
+    if(num_failed)
+        *num_failed = nfailed;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5ES__wait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5ES__close_cb
+ *
+ * Purpose:     Called when the last reference to an event set is
+ *              released: completes its operations and frees it.  The
+ *              outcome of the operations is ignored here, as H5ESclose()
+ *              reports it.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5ES__close_cb(H5ES_t *es)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(es);
+
+    /* Operations left in the set may still be running and can't be freed */
+    if(H5ES__wait(es, NULL) < 0)
+        (void)H5E_clear_stack(NULL);
+
+    if(NULL == es->head)
+        es = H5FL_FREE(H5ES_t, es);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5ES__close_cb() */
+
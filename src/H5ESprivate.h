@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/*
+ * This file contains private information about the H5ES module
+ */
+#ifndef _H5ESprivate_H
+#define _H5ESprivate_H
+
+/* Include package's public header */
+#include "H5ESpublic.h"
+
+/* Private headers needed by this file */
+#include "H5private.h"          /* Generic Functions                    */
+
+
+/**************************/
+/* Library Private Macros */
+/**************************/
+
+
+/****************************/
+/* Library Private Typedefs */
+/****************************/
+
+/* Callbacks for an operation in an event set.  The 'exec' callback performs
+ * the operation, inside an API context of its own.  The 'free' callback
+ * releases the operation's data, and is made exactly once, whether or not
+ * the operation was performed.
+ */
+typedef herr_t (*H5ES_exec_func_t)(void *op_data);
+typedef herr_t (*H5ES_free_func_t)(void *op_data);
+
+
+/*****************************/
+/* Library-private Variables */
+/*****************************/
+
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+H5_DLL herr_t H5ES_insert(hid_t es_id, const char *api_name,
+    H5ES_exec_func_t exec, H5ES_free_func_t free_func, void *op_data);
+
+#endif /* _H5ESprivate_H */
+
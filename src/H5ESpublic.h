@@ -0,0 +1,56 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+/*
+ * This file contains public declarations for the H5ES (event set) module.
+ */
+#ifndef _H5ESpublic_H
+#define _H5ESpublic_H
+
+/* Public headers needed by this file */
+#include "H5public.h"
+#include "H5Ipublic.h"
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+
+/*******************/
+/* Public Typedefs */
+/*******************/
+
+
+/********************/
+/* Public Variables */
+/********************/
+
+
+/*********************/
+/* Public Prototypes */
+/*********************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+H5_DLL hid_t H5EScreate(void);
+H5_DLL herr_t H5ESget_count(hid_t es_id, size_t *count/*out*/);
+H5_DLL herr_t H5ESwait(hid_t es_id, size_t *num_failed/*out*/);
+H5_DLL herr_t H5ESclose(hid_t es_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _H5ESpublic_H */
+
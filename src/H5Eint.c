@@ -813,10 +813,14 @@ H5E__push_stack(H5E_t *estack, const char *file, const char *func, unsigned line
     if(!desc)
         desc = "No description given";
 
+    /* Drop the error while the stack is paused */
+    HDassert(estack);
+    if(estack->paused)
+        HGOTO_DONE(SUCCEED)
+
     /*
      * Push the error if there's room.  Otherwise just forget it.
      */
-    HDassert(estack);
 
     if(estack->nused < H5E_NSLOTS) {
         /* Increment the IDs to indicate that they are used in this stack */
@@ -925,9 +929,10 @@ H5E_clear_stack(H5E_t *estack)
     	if(NULL == (estack = H5E_get_my_stack())) /*lint !e506 !e774 Make lint 'constant value Boolean' in non-threaded case */
             HGOTO_ERROR(H5E_ERROR, H5E_CANTGET, FAIL, "can't get current error stack")
 
-    /* Empty the error stack */
+    /* Empty the error stack, unless it's paused: the errors on it were
+     * pushed before it was, and aren't for the code running now to drop */
     HDassert(estack);
-    if(estack->nused)
+    if(estack->nused && !estack->paused)
         if(H5E_clear_entries(estack, estack->nused) < 0)
             HGOTO_ERROR(H5E_ERROR, H5E_CANTSET, FAIL, "can't clear error stack")
 
@@ -935,6 +940,108 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5E_clear_stack() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5E_append_stack
+ *
+ * Purpose:	Private function to push copies of the errors in SRC_STACK
+ *              onto DST_STACK (the current error stack when it's NULL),
+ *              as far as there's room.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5E_append_stack(H5E_t *dst_stack, const H5E_t *src_stack)
+{
+    unsigned u;                 /* Local index variable */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity check */
+    HDassert(src_stack);
+
+    /* Check for 'default' error stack */
+    if(dst_stack == NULL)
+    	if(NULL == (dst_stack = H5E_get_my_stack())) /*lint !e506 !e774 Make lint 'constant value Boolean' in non-threaded case */
+            HGOTO_ERROR(H5E_ERROR, H5E_CANTGET, FAIL, "can't get current error stack")
+
+    for(u = 0; u < src_stack->nused; u++) {
+        const H5E_error2_t *error = &(src_stack->slot[u]);  /* Error to copy */
+
+        if(H5E__push_stack(dst_stack, error->file_name, error->func_name, error->line,
+                error->cls_id, error->maj_num, error->min_num, error->desc) < 0)
+            HGOTO_ERROR(H5E_ERROR, H5E_CANTSET, FAIL, "can't append error to stack")
+    } /* end for */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5E_append_stack() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5E_pause_stack
+ *
+ * Purpose:	Stop recording errors on the calling thread's error stack,
+ *              until the matching call to H5E_resume_stack().  Errors
+ *              pushed in between are dropped, and clearing the stack
+ *              leaves it alone.
+ *
+ *              This is for code which a thread runs after releasing the
+ *              library lock, so that its error stack isn't changed until
+ *              it holds the lock again.  Such code must report failures
+ *              through its return value, for the caller to push an error
+ *              once it holds the lock again.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5E_pause_stack(void)
+{
+    H5E_t *estack;                      /* Current error stack */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(NULL == (estack = H5E_get_my_stack())) /*lint !e506 !e774 Make lint 'constant value Boolean' in non-threaded case */
+        HGOTO_DONE(FAIL)
+    estack->paused++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5E_pause_stack() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5E_resume_stack
+ *
+ * Purpose:	Undo a call to H5E_pause_stack().
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5E_resume_stack(void)
+{
+    H5E_t *estack;                      /* Current error stack */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(NULL == (estack = H5E_get_my_stack())) /*lint !e506 !e774 Make lint 'constant value Boolean' in non-threaded case */
+        HGOTO_DONE(FAIL)
+    HDassert(estack->paused > 0);
+    estack->paused--;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5E_resume_stack() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5E_pop
@@ -27,6 +27,7 @@
 #include "H5CXprivate.h"        /* API Contexts                         */
 #include "H5Dprivate.h"         /* Datasets                             */
 #include "H5Eprivate.h"         /* Error handling                       */
+#include "H5ESprivate.h"        /* Event sets                           */
 #include "H5Fpkg.h"             /* File access                          */
 #include "H5FDprivate.h"        /* File drivers                         */
 #include "H5Gprivate.h"         /* Groups                               */
@@ -45,6 +46,12 @@
 /* Local Typedefs */
 /******************/
 
+/* An asynchronous flush.  A reference is held on the object's ID. */
+typedef struct H5F_async_flush_t {
+    hid_t object_id;            /* ID of object in file to flush */
+    H5F_scope_t scope;          /* Scope of flush */
+} H5F_async_flush_t;
+
 
 /********************/
 /* Package Typedefs */
@@ -54,6 +61,11 @@
 /********************/
 /* Local Prototypes */
 /********************/
+static herr_t H5F__flush_api_common(hid_t object_id, H5F_scope_t scope);
+static herr_t H5F__flush_async_exec(void *_op);
+static herr_t H5F__flush_async_free(void *_op);
+static herr_t H5F__close_async_exec(void *_op);
+static herr_t H5F__close_async_free(void *_op);
 
 
 /*********************/
@@ -536,13 +548,86 @@ done:
 herr_t
 H5Fflush(hid_t object_id, H5F_scope_t scope)
 {
-    H5F_t      *f = NULL;              /* File to flush */
-    H5O_loc_t  *oloc = NULL;           /* Object location for ID */
     herr_t      ret_value = SUCCEED;   /* Return value */
 
     FUNC_ENTER_API(FAIL)
     H5TRACE2("e", "iFs", object_id, scope);
 
+    if(H5F__flush_api_common(object_id, scope) < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTFLUSH, FAIL, "unable to flush file")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Fflush() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Fflush_async
+ *
+ * Purpose:  Inserts a flush of the file containing OBJECT_ID, as for
+ *           H5Fflush(), in the event set ES_ID and returns without
+ *           waiting for it.  The flush is performed after every
+ *           asynchronous operation inserted before it.
+ *
+ * Return:   Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Fflush_async(hid_t object_id, H5F_scope_t scope, hid_t es_id)
+{
+    H5F_async_flush_t *op = NULL;      /* Asynchronous operation */
+    H5I_type_t  obj_type;              /* Type of object */
+    herr_t      ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "iFsi", object_id, scope, es_id);
+
+    /* Check arguments */
+    obj_type = H5I_get_type(object_id);
+    if(H5I_FILE != obj_type && H5I_GROUP != obj_type && H5I_DATATYPE != obj_type
+            && H5I_DATASET != obj_type && H5I_ATTR != obj_type)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file or file object")
+
+    /* Set up the operation, holding on to the object */
+    if(NULL == (op = (H5F_async_flush_t *)H5MM_malloc(sizeof(H5F_async_flush_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate asynchronous operation")
+    if(H5I_inc_ref(object_id, FALSE) < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTINC, FAIL, "can't increment object ID's reference count")
+    op->object_id = object_id;
+    op->scope = scope;
+
+    /* Insert the operation.  The event set releases it from here on. */
+    ret_value = H5ES_insert(es_id, "H5Fflush_async", H5F__flush_async_exec, H5F__flush_async_free, op);
+    op = NULL;
+    if(ret_value < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTINSERT, FAIL, "can't insert operation in event set")
+
+done:
+    if(op)
+        op = (H5F_async_flush_t *)H5MM_xfree(op);
+
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Fflush_async() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F__flush_api_common
+ *
+ * Purpose:  Flushes the file containing OBJECT_ID, for H5Fflush() and
+ *           H5Fflush_async().
+ *
+ * Return:   Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5F__flush_api_common(hid_t object_id, H5F_scope_t scope)
+{
+    H5F_t      *f = NULL;              /* File to flush */
+    H5O_loc_t  *oloc = NULL;           /* Object location for ID */
+    herr_t      ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_STATIC
+
     switch(H5I_get_type(object_id)) {
         case H5I_FILE:
             if(NULL == (f = (H5F_t *)H5I_object(object_id)))
@@ -599,6 +684,7 @@ H5Fflush(hid_t object_id, H5F_scope_t scope)
         case H5I_ERROR_CLASS:
         case H5I_ERROR_MSG:
         case H5I_ERROR_STACK:
+        case H5I_EVENTSET:
         case H5I_NTYPES:
         default:
             HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file or file object")
@@ -633,8 +719,57 @@ H5Fflush(hid_t object_id, H5F_scope_t scope)
     } /* end if */
 
 done:
-    FUNC_LEAVE_API(ret_value)
-} /* end H5Fflush() */
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F__flush_api_common() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F__flush_async_exec
+ *
+ * Purpose:  Performs an asynchronous flush, for the event set it was
+ *           inserted in.
+ *
+ * Return:   Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5F__flush_async_exec(void *_op)
+{
+    H5F_async_flush_t *op = (H5F_async_flush_t *)_op;  /* Asynchronous operation */
+    herr_t      ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(H5F__flush_api_common(op->object_id, op->scope) < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTFLUSH, FAIL, "unable to flush file")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F__flush_async_exec() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F__flush_async_free
+ *
+ * Purpose:  Releases an asynchronous flush and the object it holds.
+ *
+ * Return:   Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5F__flush_async_free(void *_op)
+{
+    H5F_async_flush_t *op = (H5F_async_flush_t *)_op;  /* Asynchronous operation */
+    herr_t      ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(H5I_dec_ref(op->object_id) < 0)
+        HDONE_ERROR(H5E_FILE, H5E_CANTDEC, FAIL, "can't decrement object ID's reference count")
+    op = (H5F_async_flush_t *)H5MM_xfree(op);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F__flush_async_free() */
 
 
 /*-------------------------------------------------------------------------
@@ -671,6 +806,95 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Fclose() */
 
+
+/*-------------------------------------------------------------------------
+ * Function: H5Fclose_async
+ *
+ * Purpose:  Inserts a close of FILE_ID, as for H5Fclose(), in the event
+ *           set ES_ID and returns without waiting for it.  The file is
+ *           closed after every asynchronous operation inserted before
+ *           it, and FILE_ID must not be used once this is called.
+ *
+ * Return:   Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Fclose_async(hid_t file_id, hid_t es_id)
+{
+    hid_t      *op = NULL;             /* Asynchronous operation */
+    herr_t      ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ii", file_id, es_id);
+
+    /* Check arguments */
+    if(H5I_FILE != H5I_get_type(file_id))
+        HGOTO_ERROR(H5E_FILE, H5E_BADTYPE, FAIL, "not a file ID")
+
+    /* Set up the operation */
+    if(NULL == (op = (hid_t *)H5MM_malloc(sizeof(hid_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate asynchronous operation")
+    *op = file_id;
+
+    /* Insert the operation.  The event set releases it from here on. */
+    ret_value = H5ES_insert(es_id, "H5Fclose_async", H5F__close_async_exec, H5F__close_async_free, op);
+    op = NULL;
+    if(ret_value < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTINSERT, FAIL, "can't insert operation in event set")
+
+done:
+    if(op)
+        op = (hid_t *)H5MM_xfree(op);
+
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Fclose_async() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F__close_async_exec
+ *
+ * Purpose:  Performs an asynchronous file close, for the event set it
+ *           was inserted in.
+ *
+ * Return:   Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5F__close_async_exec(void *_op)
+{
+    hid_t       file_id = *(hid_t *)_op;    /* File to close */
+    herr_t      ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(H5I_FILE != H5I_get_type(file_id))
+        HGOTO_ERROR(H5E_FILE, H5E_BADTYPE, FAIL, "not a file ID")
+    if(H5F__close(file_id) < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTCLOSEFILE, FAIL, "closing file ID failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F__close_async_exec() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F__close_async_free
+ *
+ * Purpose:  Releases an asynchronous file close.
+ *
+ * Return:   SUCCEED
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5F__close_async_free(void *_op)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    H5MM_xfree(_op);
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5F__close_async_free() */
+
 
 /*-------------------------------------------------------------------------
  * Function: H5Freopen
@@ -0,0 +1,1820 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: Implements a file driver which is layered over another driver,
+ *          the way the family and multi drivers are layered over the
+ *          drivers of their members, and keeps a cache of blocks of the
+ *          file in a local directory (normally on a local SSD), so that a
+ *          file on a slow or distant file system that is read again and
+ *          again is read mostly from local disk.
+ *
+ *          The file's address space is divided into blocks of a fixed
+ *          size.  Metadata and raw data blocks are kept in two separate
+ *          pools, each with its own size limit and least-recently-used
+ *          list, so that reading a lot of raw data doesn't evict the
+ *          metadata (and either can be left uncached by giving its pool
+ *          a zero size).  Reads of blocks that aren't in the cache are
+ *          passed to the underlying driver, several consecutive blocks at
+ *          a time; writes are passed to the underlying driver and update
+ *          the blocks in the cache.
+ *
+ *          For each file, two files are kept in the cache directory,
+ *          named after a hash of the file's name: the cached blocks, in a
+ *          slot per block, and an index of the slots with the identity of
+ *          the file (its size, modification time and i-node number) when
+ *          the index was written.  The index is written when the file is
+ *          flushed or closed and removed before any slot it describes is
+ *          changed, so a process that dies can't leave an index that
+ *          describes the wrong blocks; a file whose identity has changed
+ *          since its index was written starts with an empty cache.  The
+ *          cache files are locked while in use, and a file opened while
+ *          another process is using its cache isn't cached.
+ */
+
+#include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
+
+
+#include "H5private.h"      /* Generic Functions        */
+#include "H5Eprivate.h"     /* Error handling           */
+#include "H5Fprivate.h"     /* File access              */
+#include "H5FDprivate.h"    /* File drivers             */
+#include "H5FDblkcache.h"   /* Block cache file driver  */
+#include "H5FDmulti.h"      /* Usage-partitioned file family */
+#include "H5FLprivate.h"    /* Free Lists               */
+#include "H5Iprivate.h"     /* IDs                      */
+#include "H5MMprivate.h"    /* Memory management        */
+#include "H5Pprivate.h"     /* Property lists           */
+#include "H5SLprivate.h"    /* Skip lists               */
+
+/* The driver identification number, initialized at runtime */
+static hid_t H5FD_BLKCACHE_g = 0;
+
+/* The pools of cache blocks, and the pool for blocks of memory type T */
+#define H5FD_BLKCACHE_META      0
+#define H5FD_BLKCACHE_RAW       1
+#define H5FD_BLKCACHE_NPOOLS    2
+#define H5FD_BLKCACHE_POOL(T)   (H5FD_MEM_DRAW == (T) ? H5FD_BLKCACHE_RAW : H5FD_BLKCACHE_META)
+
+/* Most blocks missing from the cache that are read from the underlying
+ * file with one request */
+#define H5FD_BLKCACHE_MAX_RUN   16
+
+/* Names of the files kept in the cache directory for each file */
+#define H5FD_BLKCACHE_DATA_NAME_FORMAT  "%s/%08lx%08lx.blk"
+#define H5FD_BLKCACHE_INDEX_NAME_FORMAT "%s/%08lx%08lx.idx"
+
+/* Index file signature and version, and the sizes of its parts: the
+ * header (signature, version, block size, slots in each pool, file
+ * identity and length of the file name), each entry (pool, slot, block
+ * address and number of bytes cached), and the checksum at the end.
+ */
+#define H5FD_BLKCACHE_INDEX_MAGIC       "HDF5BLKC"
+#define H5FD_BLKCACHE_INDEX_MAGIC_LEN   8
+#define H5FD_BLKCACHE_INDEX_VERSION     1
+#define H5FD_BLKCACHE_INDEX_HDR_SIZE    (H5FD_BLKCACHE_INDEX_MAGIC_LEN + 4 + 8 + 4 + 4 + 8 + 8 + 8 + 4)
+#define H5FD_BLKCACHE_INDEX_ENT_SIZE    (1 + 4 + 8 + 8)
+#define H5FD_BLKCACHE_INDEX_CKSUM_SIZE  4
+
+/* Driver-specific file access properties */
+typedef struct H5FD_blkcache_fapl_t {
+    char        cache_dir[H5FD_BLKCACHE_MAX_DIR_LEN + 1]; /* Cache directory */
+    size_t      block_size;     /* Size of cache blocks                 */
+    hsize_t     cache_size[H5FD_BLKCACHE_NPOOLS]; /* Size of each pool  */
+    hid_t       back_fapl_id;   /* File access properties of the file cached */
+} H5FD_blkcache_fapl_t;
+
+/* A cache slot, and the block in it when it's in use */
+typedef struct H5FD_blkcache_ent_t {
+    haddr_t     addr;           /* Address of block                     */
+    size_t      len;            /* Bytes of block cached, 0 if unused   */
+    struct H5FD_blkcache_ent_t *prev;   /* More recently used block     */
+    struct H5FD_blkcache_ent_t *next;   /* Less recently used block     */
+} H5FD_blkcache_ent_t;
+
+/* A pool of cache slots, holding the blocks of one kind of data */
+typedef struct H5FD_blkcache_pool_t {
+    unsigned    nslots;         /* Number of slots                      */
+    unsigned    first_slot;     /* Slot number of first slot in cache file */
+    H5FD_blkcache_ent_t *ents;  /* Slots                                */
+    H5SL_t      *index;         /* Slots in use, by block address       */
+    H5FD_blkcache_ent_t *head;  /* Most recently used block             */
+    H5FD_blkcache_ent_t *tail;  /* Least recently used block            */
+    unsigned    nfree;          /* Number of unused slots               */
+    unsigned    *free;          /* Stack of unused slots                */
+} H5FD_blkcache_pool_t;
+
+/* The description of a file belonging to this driver.  'data_fd' is -1
+ * when the file isn't being cached.
+ */
+typedef struct H5FD_blkcache_t {
+    H5FD_t      pub;            /* public stuff, must be first          */
+    H5FD_t      *back;          /* The file cached                      */
+    H5FD_blkcache_fapl_t fa;    /* File access properties               */
+    haddr_t     eoa;            /* end of allocated region              */
+    char        *name;          /* Name of the file cached              */
+    int         data_fd;        /* Cached blocks file descriptor        */
+    char        *data_name;     /* Cached blocks file name              */
+    char        *index_name;    /* Index file name                      */
+    hbool_t     index_valid;    /* Whether the index file describes the cache */
+    H5FD_blkcache_pool_t pool[H5FD_BLKCACHE_NPOOLS]; /* Pools of slots  */
+    unsigned char *buf;         /* Blocks read from the file cached     */
+} H5FD_blkcache_t;
+
+/* Prototypes */
+static herr_t H5FD_blkcache_term(void);
+static void *H5FD_blkcache_fapl_get(H5FD_t *_file);
+static void *H5FD_blkcache_fapl_copy(const void *_old_fa);
+static herr_t H5FD_blkcache_fapl_free(void *_fa);
+static hsize_t H5FD_blkcache_sb_size(H5FD_t *_file);
+static herr_t H5FD_blkcache_sb_encode(H5FD_t *_file, char *name/*out*/,
+            unsigned char *buf/*out*/);
+static herr_t H5FD_blkcache_sb_decode(H5FD_t *_file, const char *name,
+            const unsigned char *buf);
+static H5FD_t *H5FD_blkcache_open(const char *name, unsigned flags, hid_t fapl_id,
+            haddr_t maxaddr);
+static herr_t H5FD_blkcache_close(H5FD_t *_file);
+static int H5FD_blkcache_cmp(const H5FD_t *_f1, const H5FD_t *_f2);
+static herr_t H5FD_blkcache_query(const H5FD_t *_f1, unsigned long *flags);
+static haddr_t H5FD_blkcache_get_eoa(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t H5FD_blkcache_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr);
+static haddr_t H5FD_blkcache_get_eof(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD_blkcache_get_handle(H5FD_t *_file, hid_t fapl, void** file_handle);
+static herr_t H5FD_blkcache_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, void *buf);
+static herr_t H5FD_blkcache_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, const void *buf);
+static herr_t H5FD_blkcache_flush(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
+static herr_t H5FD_blkcache_truncate(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
+static herr_t H5FD_blkcache_lock(H5FD_t *_file, hbool_t rw);
+static herr_t H5FD_blkcache_unlock(H5FD_t *_file);
+
+static herr_t H5FD__blkcache_setup(H5FD_blkcache_t *file);
+static void H5FD__blkcache_disable(H5FD_blkcache_t *file);
+static herr_t H5FD__blkcache_pio(int fd, hbool_t write, HDoff_t off,
+    size_t size, void *buf);
+static void H5FD__blkcache_identity(const H5FD_blkcache_t *file, haddr_t eof,
+    uint64_t identity[3]);
+static hbool_t H5FD__blkcache_load_index(H5FD_blkcache_t *file);
+static herr_t H5FD__blkcache_save_index(H5FD_blkcache_t *file, haddr_t eof);
+static herr_t H5FD__blkcache_invalidate_index(H5FD_blkcache_t *file);
+static H5FD_blkcache_ent_t *H5FD__blkcache_find(H5FD_blkcache_t *file,
+    haddr_t addr, H5FD_blkcache_pool_t **pool);
+static void H5FD__blkcache_touch(H5FD_blkcache_pool_t *pool,
+    H5FD_blkcache_ent_t *ent);
+static void H5FD__blkcache_evict(H5FD_blkcache_pool_t *pool,
+    H5FD_blkcache_ent_t *ent);
+static herr_t H5FD__blkcache_insert(H5FD_blkcache_t *file,
+    H5FD_blkcache_pool_t *pool, haddr_t addr, size_t len, const unsigned char *data);
+
+static const H5FD_class_t H5FD_blkcache_g = {
+    "blkcache",                 /* name                 */
+    HADDR_MAX,                  /* maxaddr              */
+    H5F_CLOSE_WEAK,             /* fc_degree            */
+    H5FD_blkcache_term,         /* terminate            */
+    H5FD_blkcache_sb_size,      /* sb_size              */
+    H5FD_blkcache_sb_encode,    /* sb_encode            */
+    H5FD_blkcache_sb_decode,    /* sb_decode            */
+    sizeof(H5FD_blkcache_fapl_t), /* fapl_size          */
+    H5FD_blkcache_fapl_get,     /* fapl_get             */
+    H5FD_blkcache_fapl_copy,    /* fapl_copy            */
+    H5FD_blkcache_fapl_free,    /* fapl_free            */
+    0,                          /* dxpl_size            */
+    NULL,                       /* dxpl_copy            */
+    NULL,                       /* dxpl_free            */
+    H5FD_blkcache_open,         /* open                 */
+    H5FD_blkcache_close,        /* close                */
+    H5FD_blkcache_cmp,          /* cmp                  */
+    H5FD_blkcache_query,        /* query                */
+    NULL,                       /* get_type_map         */
+    NULL,                       /* alloc                */
+    NULL,                       /* free                 */
+    H5FD_blkcache_get_eoa,      /* get_eoa              */
+    H5FD_blkcache_set_eoa,      /* set_eoa              */
+    H5FD_blkcache_get_eof,      /* get_eof              */
+    H5FD_blkcache_get_handle,   /* get_handle           */
+    H5FD_blkcache_read,         /* read                 */
+    H5FD_blkcache_write,        /* write                */
+    NULL,                       /* read_vector          */
+    NULL,                       /* write_vector         */
+    H5FD_blkcache_flush,        /* flush                */
+    H5FD_blkcache_truncate,     /* truncate             */
+    H5FD_blkcache_lock,         /* lock                 */
+    H5FD_blkcache_unlock,       /* unlock               */
+    H5FD_FLMAP_DICHOTOMY        /* fl_map               */
+};
+
+/* Declare a free list to manage the H5FD_blkcache_t struct */
+H5FL_DEFINE_STATIC(H5FD_blkcache_t);
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__init_package
+ *
+ * Purpose:     Initializes any interface-specific data or routines.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__init_package(void)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_STATIC
+
+    if(H5FD_blkcache_init() < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to initialize block cache VFD")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5FD__init_package() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_init
+ *
+ * Purpose:     Initialize this driver by registering the driver with the
+ *              library.
+ *
+ * Return:      Success:    The driver ID for the block cache driver.
+ *              Failure:    Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5FD_blkcache_init(void)
+{
+    hid_t ret_value = H5I_INVALID_HID;          /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    if(H5I_VFL != H5I_get_type(H5FD_BLKCACHE_g))
+        H5FD_BLKCACHE_g = H5FD_register(&H5FD_blkcache_g, sizeof(H5FD_class_t), FALSE);
+
+    /* Set return value */
+    ret_value = H5FD_BLKCACHE_g;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_init() */
+
+
+/*---------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_term
+ *
+ * Purpose:     Shut down the VFD
+ *
+ * Returns:     SUCCEED (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_term(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Reset VFL ID */
+    H5FD_BLKCACHE_g = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_blkcache_term() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_blkcache
+ *
+ * Purpose:     Sets the file access property list FAPL_ID to use the
+ *              block cache driver, caching blocks of BLOCK_SIZE bytes
+ *              (zero selects the default) in the directory CACHE_DIR.  Up
+ *              to META_CACHE_SIZE bytes of metadata blocks and
+ *              RAW_CACHE_SIZE bytes of raw data blocks are cached; either
+ *              may be zero to not cache that kind of data.  The file is
+ *              opened with the file access property list BACK_FAPL_ID,
+ *              which may use any driver other than the multi driver.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_blkcache(hid_t fapl_id, const char *cache_dir, size_t block_size,
+    hsize_t meta_cache_size, hsize_t raw_cache_size, hid_t back_fapl_id)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    H5FD_blkcache_fapl_t fa;    /* Driver properties */
+    herr_t ret_value;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE6("e", "i*szhhi", fapl_id, cache_dir, block_size, meta_cache_size,
+             raw_cache_size, back_fapl_id);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(!cache_dir || !*cache_dir)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "no cache directory")
+    if(HDstrlen(cache_dir) > H5FD_BLKCACHE_MAX_DIR_LEN)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "cache directory name too long")
+    if(block_size > SIZET_MAX / H5FD_BLKCACHE_MAX_RUN)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "block size too large")
+    if(H5P_DEFAULT == back_fapl_id)
+        back_fapl_id = H5P_FILE_ACCESS_DEFAULT;
+    else {
+        H5P_genplist_t *back_plist;     /* Underlying property list pointer */
+
+        if(NULL == (back_plist = H5P_object_verify(back_fapl_id, H5P_FILE_ACCESS)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access list")
+
+        /* (The multi driver keeps an end of allocated space for each type
+         * of data, which can't be passed through this driver) */
+        if(H5FD_MULTI == H5P_peek_driver(back_plist))
+            HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, FAIL, "can't cache files of the multi driver")
+    } /* end else */
+
+    HDmemset(&fa, 0, sizeof(fa));
+    HDstrcpy(fa.cache_dir, cache_dir);
+    fa.block_size = block_size ? block_size : H5FD_BLKCACHE_BLOCK_SIZE_DEF;
+    fa.cache_size[H5FD_BLKCACHE_META] = meta_cache_size;
+    fa.cache_size[H5FD_BLKCACHE_RAW] = raw_cache_size;
+    fa.back_fapl_id = back_fapl_id;
+
+    ret_value = H5P_set_driver(plist, H5FD_BLKCACHE, &fa);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_blkcache() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_fapl_blkcache
+ *
+ * Purpose:     Returns information about the block cache file access
+ *              property list though the function arguments.  At most
+ *              DIR_SIZE bytes of the cache directory name, including the
+ *              null terminator, are returned in CACHE_DIR.  The file
+ *              access property list returned in BACK_FAPL_ID must be
+ *              closed by the caller.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_fapl_blkcache(hid_t fapl_id, size_t dir_size, char *cache_dir/*out*/,
+    size_t *block_size/*out*/, hsize_t *meta_cache_size/*out*/,
+    hsize_t *raw_cache_size/*out*/, hid_t *back_fapl_id/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    const H5FD_blkcache_fapl_t *fa;
+    herr_t      ret_value = SUCCEED;       /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE7("e", "izxxxxx", fapl_id, dir_size, cache_dir, block_size,
+             meta_cache_size, raw_cache_size, back_fapl_id);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access list")
+    if(H5FD_BLKCACHE != H5P_peek_driver(plist))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "incorrect VFL driver")
+    if(NULL == (fa = (const H5FD_blkcache_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "bad VFL driver info")
+
+    if(cache_dir && dir_size > 0) {
+        HDstrncpy(cache_dir, fa->cache_dir, dir_size);
+        cache_dir[dir_size - 1] = '\0';
+    } /* end if */
+    if(block_size)
+        *block_size = fa->block_size;
+    if(meta_cache_size)
+        *meta_cache_size = fa->cache_size[H5FD_BLKCACHE_META];
+    if(raw_cache_size)
+        *raw_cache_size = fa->cache_size[H5FD_BLKCACHE_RAW];
+    if(back_fapl_id) {
+        if(NULL == (plist = (H5P_genplist_t *)H5I_object(fa->back_fapl_id)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access list")
+        *back_fapl_id = H5P_copy_plist(plist, TRUE);
+    } /* end if */
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_fapl_blkcache() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_fapl_get
+ *
+ * Purpose:     Gets a file access property list which could be used to
+ *              create an identical file.
+ *
+ * Return:      Success:    Ptr to new file access property list value.
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_blkcache_fapl_get(H5FD_t *_file)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    void *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(NULL == (ret_value = H5FD_blkcache_fapl_copy(&(file->fa))))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTCOPY, NULL, "can't copy driver info")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_fapl_get() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_fapl_copy
+ *
+ * Purpose:     Copies the block cache-specific file access properties.
+ *
+ * Return:      Success:    Ptr to a new property list value
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_blkcache_fapl_copy(const void *_old_fa)
+{
+    const H5FD_blkcache_fapl_t *old_fa = (const H5FD_blkcache_fapl_t *)_old_fa;
+    H5FD_blkcache_fapl_t *new_fa = NULL;
+    H5P_genplist_t *plist;      /* Property list pointer */
+    void *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(NULL == (new_fa = (H5FD_blkcache_fapl_t *)H5MM_malloc(sizeof(H5FD_blkcache_fapl_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
+
+    /* Copy the fields of the structure */
+    HDmemcpy(new_fa, old_fa, sizeof(H5FD_blkcache_fapl_t));
+
+    /* Deep copy the property list of the file cached */
+    if(old_fa->back_fapl_id == H5P_FILE_ACCESS_DEFAULT) {
+        if(H5I_inc_ref(new_fa->back_fapl_id, FALSE) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINC, NULL, "unable to increment ref count on VFL driver")
+    } /* end if */
+    else {
+        if(NULL == (plist = (H5P_genplist_t *)H5I_object(old_fa->back_fapl_id)))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, NULL, "not a file access property list")
+        if((new_fa->back_fapl_id = H5P_copy_plist(plist, FALSE)) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTCOPY, NULL, "can't copy file access property list")
+    } /* end else */
+
+    /* Set return value */
+    ret_value = new_fa;
+
+done:
+    if(NULL == ret_value)
+        H5MM_xfree(new_fa);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_fapl_copy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_fapl_free
+ *
+ * Purpose:     Frees the block cache-specific file access properties.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_fapl_free(void *_fa)
+{
+    H5FD_blkcache_fapl_t *fa = (H5FD_blkcache_fapl_t *)_fa;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5I_dec_ref(fa->back_fapl_id) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDEC, FAIL, "can't close driver ID")
+    H5MM_xfree(fa);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_fapl_free() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_sb_size
+ *
+ * Purpose:     Returns the size of the underlying driver's information
+ *              in the superblock.  This driver stores none of its own,
+ *              so a file written through it can be opened without it.
+ *
+ * Return:      Success:    The super block driver data size.
+ *              Failure:    never fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static hsize_t
+H5FD_blkcache_sb_size(H5FD_t *_file)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    hsize_t ret_value = 0;      /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    ret_value = H5FD_sb_size(file->back);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_sb_size() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_sb_encode
+ *
+ * Purpose:     Encodes the underlying driver's superblock information.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_sb_encode(H5FD_t *_file, char *name/*out*/,
+    unsigned char *buf/*out*/)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_sb_encode(file->back, name, buf) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTENCODE, FAIL, "unable to encode driver information")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_sb_encode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_sb_decode
+ *
+ * Purpose:     Checks and decodes the underlying driver's superblock
+ *              information.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_sb_decode(H5FD_t *_file, const char *name,
+    const unsigned char *buf)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_sb_load(file->back, name, buf) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDECODE, FAIL, "unable to decode driver information")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_sb_decode() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_open
+ *
+ * Purpose:     Opens the file NAME with the underlying driver and sets up
+ *              its cache.
+ *
+ * Return:      Success:    A pointer to a new file data structure.  The
+ *                          public fields will be initialized by the
+ *                          caller, which is always H5FD_open().
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+H5FD_blkcache_open(const char *name, unsigned flags, hid_t fapl_id,
+    haddr_t H5_ATTR_UNUSED maxaddr)
+{
+    H5FD_blkcache_t *file = NULL;       /* block cache VFD info */
+    H5P_genplist_t  *plist;             /* Property list pointer */
+    const H5FD_blkcache_fapl_t *fa;     /* Driver properties */
+    H5FD_t          *ret_value = NULL;  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Check arguments */
+    if(!name || !*name)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "invalid file name")
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, NULL, "not a file access property list")
+    if(NULL == (fa = (const H5FD_blkcache_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, NULL, "bad VFL driver info")
+
+    /* Create the new file struct */
+    if(NULL == (file = H5FL_CALLOC(H5FD_blkcache_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to allocate file struct")
+    file->data_fd = -1;
+    file->fa.back_fapl_id = H5I_INVALID_HID;
+
+    /* Keep a copy of the properties, for H5Fget_access_plist() */
+    HDmemcpy(&file->fa, fa, sizeof(H5FD_blkcache_fapl_t));
+    if(fa->back_fapl_id == H5P_FILE_ACCESS_DEFAULT) {
+        if(H5I_inc_ref(fa->back_fapl_id, FALSE) < 0) {
+            file->fa.back_fapl_id = H5I_INVALID_HID;
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINC, NULL, "unable to increment ref count on VFL driver")
+        } /* end if */
+    } /* end if */
+    else {
+        if(NULL == (plist = (H5P_genplist_t *)H5I_object(fa->back_fapl_id))) {
+            file->fa.back_fapl_id = H5I_INVALID_HID;
+            HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, NULL, "not a file access property list")
+        } /* end if */
+        if((file->fa.back_fapl_id = H5P_copy_plist(plist, FALSE)) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTCOPY, NULL, "can't copy file access property list")
+    } /* end else */
+    if(NULL == (file->name = H5MM_xstrdup(name)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to copy file name")
+
+    /* Open the file with the underlying driver */
+    if(NULL == (file->back = H5FD_open(name, flags, file->fa.back_fapl_id, HADDR_UNDEF)))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTOPENFILE, NULL, "unable to open file cached")
+
+    /* Set up the cache, if there's room for any blocks in it */
+    if(file->fa.cache_size[H5FD_BLKCACHE_META] >= file->fa.block_size
+            || file->fa.cache_size[H5FD_BLKCACHE_RAW] >= file->fa.block_size)
+        if(H5FD__blkcache_setup(file) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, NULL, "unable to set up block cache")
+
+    /* Set return value */
+    ret_value = (H5FD_t *)file;
+
+done:
+    if(NULL == ret_value && file) {
+        H5FD__blkcache_disable(file);
+        if(file->back && H5FD_close(file->back) < 0)
+            HDONE_ERROR(H5E_VFL, H5E_CANTCLOSEFILE, NULL, "unable to close file cached")
+        if(file->fa.back_fapl_id >= 0 && H5I_dec_ref(file->fa.back_fapl_id) < 0)
+            HDONE_ERROR(H5E_VFL, H5E_CANTDEC, NULL, "can't close driver ID")
+        H5MM_xfree(file->name);
+        file = H5FL_FREE(H5FD_blkcache_t, file);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_setup
+ *
+ * Purpose:     Opens and locks the cache files for a file and creates
+ *              its pools of slots, with the blocks in the index file if
+ *              it is still valid.  If another process has the cache files
+ *              locked, the file isn't cached.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__blkcache_setup(H5FD_blkcache_t *file)
+{
+    size_t      name_len;               /* Length of file name */
+    size_t      path_len;               /* Length of cache file names */
+    uint32_t    hash_hi, hash_lo;       /* Hash of file name */
+    hsize_t     nslots;                 /* Number of slots in a pool */
+    unsigned    first_slot = 0;         /* First slot of a pool */
+    unsigned    u, v;                   /* Local index variables */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Name the cache files after a hash of the file's name */
+    name_len = HDstrlen(file->name);
+    hash_hi = H5_checksum_lookup3(file->name, name_len, 0);
+    hash_lo = H5_checksum_lookup3(file->name, name_len, hash_hi);
+    path_len = HDstrlen(file->fa.cache_dir) + 32;
+    if(NULL == (file->data_name = (char *)H5MM_malloc(path_len)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate cache file name")
+    if(NULL == (file->index_name = (char *)H5MM_malloc(path_len)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate cache file name")
+    HDsnprintf(file->data_name, path_len, H5FD_BLKCACHE_DATA_NAME_FORMAT, file->fa.cache_dir, (unsigned long)hash_hi, (unsigned long)hash_lo);
+    HDsnprintf(file->index_name, path_len, H5FD_BLKCACHE_INDEX_NAME_FORMAT, file->fa.cache_dir, (unsigned long)hash_hi, (unsigned long)hash_lo);
+
+    /* Open the cached blocks file */
+    if((file->data_fd = HDopen(file->data_name, O_RDWR | O_CREAT, H5_POSIX_CREATE_MODE_RW)) < 0)
+        HSYS_GOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, FAIL, "unable to open cache file")
+
+#ifdef H5_HAVE_FLOCK
+    /* Another process is using the cache */
+    if(HDflock(file->data_fd, LOCK_EX | LOCK_NB) < 0) {
+        if(EWOULDBLOCK != errno)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_CANTLOCK, FAIL, "unable to lock cache file")
+        HDclose(file->data_fd);
+        file->data_fd = -1;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+#endif /* H5_HAVE_FLOCK */
+
+    /* Create the pools, all slots unused */
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++) {
+        H5FD_blkcache_pool_t *pool = &file->pool[u];
+
+        nslots = file->fa.cache_size[u] / file->fa.block_size;
+        if(nslots > (hsize_t)(UINT_MAX - first_slot))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "too many cache blocks")
+        pool->nslots = (unsigned)nslots;
+        pool->first_slot = first_slot;
+        first_slot += pool->nslots;
+        if(0 == pool->nslots)
+            continue;
+
+        if(NULL == (pool->ents = (H5FD_blkcache_ent_t *)H5MM_calloc(pool->nslots * sizeof(H5FD_blkcache_ent_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate cache slots")
+        if(NULL == (pool->free = (unsigned *)H5MM_malloc(pool->nslots * sizeof(unsigned))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate cache slots")
+        if(NULL == (pool->index = H5SL_create(H5SL_TYPE_HADDR, NULL)))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTCREATE, FAIL, "unable to create cache index")
+
+        /* Use the lowest slots first */
+        for(v = 0; v < pool->nslots; v++)
+            pool->free[v] = pool->nslots - v - 1;
+        pool->nfree = pool->nslots;
+    } /* end for */
+
+    if(NULL == (file->buf = (unsigned char *)H5MM_malloc(H5FD_BLKCACHE_MAX_RUN * file->fa.block_size)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate block buffer")
+
+    /* Get the blocks cached when the file was last used, or remove an
+     * index that doesn't describe the slots that are about to be reused */
+    if(!(file->index_valid = H5FD__blkcache_load_index(file)))
+        HDunlink(file->index_name);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_setup() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_disable
+ *
+ * Purpose:     Stops caching a file, releasing its pools and closing its
+ *              cache files.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__blkcache_disable(H5FD_blkcache_t *file)
+{
+    unsigned    u;                      /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++) {
+        H5FD_blkcache_pool_t *pool = &file->pool[u];
+
+        if(pool->index)
+            H5SL_close(pool->index);
+        H5MM_xfree(pool->ents);
+        H5MM_xfree(pool->free);
+        HDmemset(pool, 0, sizeof(*pool));
+    } /* end for */
+
+    if(file->data_fd >= 0) {
+        HDclose(file->data_fd);
+        file->data_fd = -1;
+    } /* end if */
+    file->data_name = (char *)H5MM_xfree(file->data_name);
+    file->index_name = (char *)H5MM_xfree(file->index_name);
+    file->buf = (unsigned char *)H5MM_xfree(file->buf);
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__blkcache_disable() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_pio
+ *
+ * Purpose:     Reads or writes SIZE bytes at offset OFF of a cache file.
+ *
+ * Return:      SUCCEED/FAIL, with errno set on failure.  Reading past
+ *              the end of the cache file fails.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__blkcache_pio(int fd, hbool_t write, HDoff_t off, size_t size, void *_buf)
+{
+    unsigned char *buf = (unsigned char *)_buf;
+    h5_posix_io_ret_t nio;              /* Bytes read or written */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    while(size > 0) {
+        h5_posix_io_t bytes_in = (h5_posix_io_t)MIN(size, H5_POSIX_MAX_IO_BYTES);
+
+        do {
+#if defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE)
+            if(write)
+                nio = HDpwrite(fd, buf, bytes_in, off);
+            else
+                nio = HDpread(fd, buf, bytes_in, off);
+#else /* defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE) */
+            if(HDlseek(fd, off, SEEK_SET) < 0)
+                nio = -1;
+            else if(write)
+                nio = HDwrite(fd, buf, bytes_in);
+            else
+                nio = HDread(fd, buf, bytes_in);
+#endif /* defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE) */
+        } while(-1 == nio && EINTR == errno);
+
+        if(nio <= 0) {
+            if(0 == nio)
+                errno = EIO;
+            HGOTO_DONE(FAIL)
+        } /* end if */
+
+        size -= (size_t)nio;
+        off += (HDoff_t)nio;
+        buf += nio;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_pio() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_identity
+ *
+ * Purpose:     Gets the identity of the file cached: its size EOF, and
+ *              the modification time and i-node number of the file it
+ *              was opened with, if there is one by that name.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__blkcache_identity(const H5FD_blkcache_t *file, haddr_t eof,
+    uint64_t identity[3])
+{
+    h5_stat_t   sb;                     /* Status of file */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    identity[0] = (uint64_t)eof;
+    identity[1] = 0;
+    identity[2] = 0;
+    if(0 == HDstat(file->name, &sb)) {
+        identity[1] = (uint64_t)sb.st_mtime;
+        identity[2] = (uint64_t)sb.st_ino;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__blkcache_identity() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_load_index
+ *
+ * Purpose:     Reads the index file, and puts the blocks it describes in
+ *              the pools if it was written with the same block size and
+ *              pool sizes, for a file with the same name and identity as
+ *              the file cached.
+ *
+ * Return:      TRUE if the blocks were loaded, FALSE if the index file
+ *              is missing or doesn't match the file (failures only mean
+ *              the cache starts empty, so none are reported).
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+H5FD__blkcache_load_index(H5FD_blkcache_t *file)
+{
+    unsigned char *image = NULL;        /* Index file contents */
+    const unsigned char *p;             /* Pointer into index */
+    h5_stat_t   sb;                     /* Status of index file */
+    size_t      size;                   /* Size of index file */
+    size_t      name_len;               /* Length of file name */
+    uint64_t    identity[3];            /* Identity of file cached */
+    uint64_t    val64;                  /* Decoded value */
+    uint32_t    val32;                  /* Decoded value */
+    uint32_t    cksum;                  /* Stored checksum */
+    uint32_t    nents;                  /* Number of blocks in index */
+    int         fd = -1;                /* Index file descriptor */
+    unsigned    u;                      /* Local index variable */
+    hbool_t     ret_value = FALSE;      /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if((fd = HDopen(file->index_name, O_RDONLY, H5_POSIX_CREATE_MODE_RW)) < 0)
+        HGOTO_DONE(FALSE)
+    if(HDfstat(fd, &sb) < 0 || sb.st_size < (HDoff_t)(H5FD_BLKCACHE_INDEX_HDR_SIZE + H5FD_BLKCACHE_INDEX_CKSUM_SIZE)
+            || (hsize_t)sb.st_size > (hsize_t)SIZET_MAX)
+        HGOTO_DONE(FALSE)
+    size = (size_t)sb.st_size;
+    if(NULL == (image = (unsigned char *)H5MM_malloc(size)))
+        HGOTO_DONE(FALSE)
+    if(H5FD__blkcache_pio(fd, FALSE, (HDoff_t)0, size, image) < 0)
+        HGOTO_DONE(FALSE)
+
+    /* Check the checksum, then the header */
+    p = image + size - H5FD_BLKCACHE_INDEX_CKSUM_SIZE;
+    UINT32DECODE(p, cksum);
+    if(cksum != H5_checksum_metadata(image, size - H5FD_BLKCACHE_INDEX_CKSUM_SIZE, 0))
+        HGOTO_DONE(FALSE)
+    p = image;
+    if(HDmemcmp(p, H5FD_BLKCACHE_INDEX_MAGIC, (size_t)H5FD_BLKCACHE_INDEX_MAGIC_LEN))
+        HGOTO_DONE(FALSE)
+    p += H5FD_BLKCACHE_INDEX_MAGIC_LEN;
+    UINT32DECODE(p, val32);
+    if(H5FD_BLKCACHE_INDEX_VERSION != val32)
+        HGOTO_DONE(FALSE)
+    UINT64DECODE(p, val64);
+    if(val64 != (uint64_t)file->fa.block_size)
+        HGOTO_DONE(FALSE)
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++) {
+        UINT32DECODE(p, val32);
+        if(val32 != file->pool[u].nslots)
+            HGOTO_DONE(FALSE)
+    } /* end for */
+    H5FD__blkcache_identity(file, H5FD_get_eof(file->back, H5FD_MEM_DEFAULT), identity);
+    for(u = 0; u < 3; u++) {
+        UINT64DECODE(p, val64);
+        if(val64 != identity[u])
+            HGOTO_DONE(FALSE)
+    } /* end for */
+    UINT32DECODE(p, val32);
+    name_len = HDstrlen(file->name);
+    if(val32 != name_len || (size_t)(p - image) + name_len + 4 + H5FD_BLKCACHE_INDEX_CKSUM_SIZE > size
+            || HDmemcmp(p, file->name, name_len))
+        HGOTO_DONE(FALSE)
+    p += name_len;
+    UINT32DECODE(p, nents);
+    if((size_t)(p - image) + (size_t)nents * H5FD_BLKCACHE_INDEX_ENT_SIZE + H5FD_BLKCACHE_INDEX_CKSUM_SIZE != size)
+        HGOTO_DONE(FALSE)
+
+    /* Put the blocks in the pools, most recently used first */
+    for(u = 0; u < nents; u++) {
+        H5FD_blkcache_pool_t *pool;
+        H5FD_blkcache_ent_t *ent;
+        unsigned    v;
+
+        if(*p >= H5FD_BLKCACHE_NPOOLS)
+            break;
+        pool = &file->pool[*p++];
+        UINT32DECODE(p, val32);
+        if(val32 >= pool->nslots || pool->ents[val32].len)
+            break;
+        ent = &pool->ents[val32];
+        UINT64DECODE(p, ent->addr);
+        UINT64DECODE(p, val64);
+        if(0 == val64 || val64 > file->fa.block_size || ent->addr % file->fa.block_size
+                || H5SL_search(file->pool[H5FD_BLKCACHE_META].index, &ent->addr)
+                || H5SL_search(file->pool[H5FD_BLKCACHE_RAW].index, &ent->addr)
+                || H5SL_insert(pool->index, ent, &ent->addr) < 0)
+            break;
+        ent->len = (size_t)val64;
+
+        /* Append to LRU list */
+        ent->prev = pool->tail;
+        ent->next = NULL;
+        if(pool->tail)
+            pool->tail->next = ent;
+        else
+            pool->head = ent;
+        pool->tail = ent;
+
+        /* Take the slot off the free stack */
+        for(v = 0; v < pool->nfree; v++)
+            if(pool->free[v] == val32) {
+                pool->free[v] = pool->free[--pool->nfree];
+                break;
+            } /* end if */
+    } /* end for */
+
+    ret_value = (u == nents);
+
+done:
+    if(fd >= 0)
+        HDclose(fd);
+    H5MM_xfree(image);
+
+    /* Discard a partly loaded index */
+    if(!ret_value)
+        for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++) {
+            H5FD_blkcache_pool_t *pool = &file->pool[u];
+
+            while(pool->head)
+                H5FD__blkcache_evict(pool, pool->head);
+        } /* end for */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_load_index() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_save_index
+ *
+ * Purpose:     Writes the index file, after making sure the cached blocks
+ *              it describes are on disk.  EOF is the size of the file
+ *              cached.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__blkcache_save_index(H5FD_blkcache_t *file, haddr_t eof)
+{
+    unsigned char *image = NULL;        /* Index file contents */
+    unsigned char *p;                   /* Pointer into index */
+    size_t      size;                   /* Size of index file */
+    size_t      name_len;               /* Length of file name */
+    uint64_t    identity[3];            /* Identity of file cached */
+    uint32_t    cksum;                  /* Checksum */
+    size_t      nents = 0;              /* Number of blocks in index */
+    int         fd = -1;                /* Index file descriptor */
+    unsigned    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(file->data_fd >= 0);
+
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++)
+        nents += file->pool[u].nslots - file->pool[u].nfree;
+    name_len = HDstrlen(file->name);
+    size = H5FD_BLKCACHE_INDEX_HDR_SIZE + name_len + 4 + nents * H5FD_BLKCACHE_INDEX_ENT_SIZE + H5FD_BLKCACHE_INDEX_CKSUM_SIZE;
+    if(NULL == (image = (unsigned char *)H5MM_malloc(size)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate cache index")
+
+    /* Encode the header */
+    p = image;
+    HDmemcpy(p, H5FD_BLKCACHE_INDEX_MAGIC, (size_t)H5FD_BLKCACHE_INDEX_MAGIC_LEN);
+    p += H5FD_BLKCACHE_INDEX_MAGIC_LEN;
+    UINT32ENCODE(p, H5FD_BLKCACHE_INDEX_VERSION);
+    UINT64ENCODE(p, (uint64_t)file->fa.block_size);
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++)
+        UINT32ENCODE(p, file->pool[u].nslots);
+    H5FD__blkcache_identity(file, eof, identity);
+    for(u = 0; u < 3; u++)
+        UINT64ENCODE(p, identity[u]);
+    UINT32ENCODE(p, name_len);
+    HDmemcpy(p, file->name, name_len);
+    p += name_len;
+    UINT32ENCODE(p, nents);
+
+    /* Encode the blocks, most recently used first */
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++) {
+        H5FD_blkcache_pool_t *pool = &file->pool[u];
+        H5FD_blkcache_ent_t *ent;
+
+        for(ent = pool->head; ent; ent = ent->next) {
+            *p++ = (unsigned char)u;
+            UINT32ENCODE(p, (uint32_t)(ent - pool->ents));
+            UINT64ENCODE(p, ent->addr);
+            UINT64ENCODE(p, (uint64_t)ent->len);
+        } /* end for */
+    } /* end for */
+
+    cksum = H5_checksum_metadata(image, (size_t)(p - image), 0);
+    UINT32ENCODE(p, cksum);
+    HDassert((size_t)(p - image) == size);
+
+    /* Write the index once the blocks are on disk */
+    if(HDfsync(file->data_fd) < 0)
+        HSYS_GOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "unable to sync cache file")
+    if((fd = HDopen(file->index_name, O_WRONLY | O_CREAT | O_TRUNC, H5_POSIX_CREATE_MODE_RW)) < 0)
+        HSYS_GOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, FAIL, "unable to open cache index file")
+    if(H5FD__blkcache_pio(fd, TRUE, (HDoff_t)0, size, image) < 0)
+        HSYS_GOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "unable to write cache index file")
+
+    file->index_valid = TRUE;
+
+done:
+    if(fd >= 0 && HDclose(fd) < 0)
+        HSYS_DONE_ERROR(H5E_FILE, H5E_CANTCLOSEFILE, FAIL, "unable to close cache index file")
+    H5MM_xfree(image);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_save_index() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_invalidate_index
+ *
+ * Purpose:     Removes the index file, if it describes the cache, before
+ *              a cache slot is changed.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__blkcache_invalidate_index(H5FD_blkcache_t *file)
+{
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(file->index_valid) {
+        if(HDunlink(file->index_name) < 0 && ENOENT != errno)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_CANTDELETE, FAIL, "unable to remove cache index file")
+        file->index_valid = FALSE;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_invalidate_index() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_find
+ *
+ * Purpose:     Looks for the block at ADDR in both pools.
+ *
+ * Return:      The block's slot and its pool, in POOL, or NULL if the
+ *              block isn't cached.
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_blkcache_ent_t *
+H5FD__blkcache_find(H5FD_blkcache_t *file, haddr_t addr,
+    H5FD_blkcache_pool_t **pool)
+{
+    unsigned    u;                      /* Local index variable */
+    H5FD_blkcache_ent_t *ret_value = NULL;  /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++)
+        if(file->pool[u].index && NULL != (ret_value = (H5FD_blkcache_ent_t *)H5SL_search(file->pool[u].index, &addr))) {
+            *pool = &file->pool[u];
+            break;
+        } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_find() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_touch
+ *
+ * Purpose:     Makes ENT the most recently used block in POOL.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__blkcache_touch(H5FD_blkcache_pool_t *pool, H5FD_blkcache_ent_t *ent)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    if(pool->head != ent) {
+        /* Unlink */
+        ent->prev->next = ent->next;
+        if(ent->next)
+            ent->next->prev = ent->prev;
+        else
+            pool->tail = ent->prev;
+
+        /* Put at head */
+        ent->prev = NULL;
+        ent->next = pool->head;
+        pool->head->prev = ent;
+        pool->head = ent;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__blkcache_touch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_evict
+ *
+ * Purpose:     Removes the block in ENT from POOL, freeing its slot.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__blkcache_evict(H5FD_blkcache_pool_t *pool, H5FD_blkcache_ent_t *ent)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    H5SL_remove(pool->index, &ent->addr);
+    if(ent->prev)
+        ent->prev->next = ent->next;
+    else
+        pool->head = ent->next;
+    if(ent->next)
+        ent->next->prev = ent->prev;
+    else
+        pool->tail = ent->prev;
+    ent->prev = ent->next = NULL;
+    ent->len = 0;
+    pool->free[pool->nfree++] = (unsigned)(ent - pool->ents);
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__blkcache_evict() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__blkcache_insert
+ *
+ * Purpose:     Caches LEN bytes of DATA as the block at ADDR.  A block
+ *              already in either pool is replaced in place; otherwise the
+ *              block goes in POOL, evicting its least recently used block
+ *              if it's full.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__blkcache_insert(H5FD_blkcache_t *file, H5FD_blkcache_pool_t *pool,
+    haddr_t addr, size_t len, const unsigned char *data)
+{
+    H5FD_blkcache_pool_t *ent_pool = NULL;  /* Pool block is in */
+    H5FD_blkcache_ent_t *ent;           /* Block's slot */
+    unsigned    slot;                   /* Slot number in cache file */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(pool->nslots > 0);
+    HDassert(len > 0 && len <= file->fa.block_size);
+
+    if(H5FD__blkcache_invalidate_index(file) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTDELETE, FAIL, "unable to invalidate cache index")
+
+    /* Find a slot for the block */
+    if(NULL == (ent = H5FD__blkcache_find(file, addr, &ent_pool))) {
+        if(0 == pool->nfree)
+            H5FD__blkcache_evict(pool, pool->tail);
+        ent = &pool->ents[pool->free[--pool->nfree]];
+        ent->addr = addr;
+        if(H5SL_insert(pool->index, ent, &ent->addr) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINSERT, FAIL, "can't insert block in cache index")
+        ent->prev = NULL;
+        ent->next = pool->head;
+        if(pool->head)
+            pool->head->prev = ent;
+        else
+            pool->tail = ent;
+        pool->head = ent;
+        ent_pool = pool;
+    } /* end if */
+    else
+        H5FD__blkcache_touch(ent_pool, ent);
+
+    /* Write the block to its slot */
+    slot = ent_pool->first_slot + (unsigned)(ent - ent_pool->ents);
+    ent->len = 0;
+    if(H5FD__blkcache_pio(file->data_fd, TRUE, (HDoff_t)slot * (HDoff_t)file->fa.block_size, len, (void *)data) < 0) {
+        H5FD__blkcache_evict(ent_pool, ent);
+        HSYS_GOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "unable to write cache file")
+    } /* end if */
+    ent->len = len;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__blkcache_insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_close
+ *
+ * Purpose:     Closes the file cached, then writes the index of its cache
+ *              and closes the cache files.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_close(H5FD_t *_file)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    haddr_t     eof;                    /* Size of file cached */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Close the file cached, then record its identity in the index.  A
+     * cache that can't be saved is only a cache that starts empty the
+     * next time, so that's not an error; any stale index was removed
+     * when the cache was changed.
+     */
+    eof = H5FD_get_eof(file->back, H5FD_MEM_DEFAULT);
+    if(H5FD_close(file->back) < 0)
+        HDONE_ERROR(H5E_VFL, H5E_CANTCLOSEFILE, FAIL, "unable to close file cached")
+    else if(file->data_fd >= 0 && HADDR_UNDEF != eof) {
+        H5E_BEGIN_TRY {
+            H5FD__blkcache_save_index(file, eof);
+        } H5E_END_TRY;
+    } /* end if */
+
+    H5FD__blkcache_disable(file);
+    if(H5I_dec_ref(file->fa.back_fapl_id) < 0)
+        HDONE_ERROR(H5E_VFL, H5E_CANTDEC, FAIL, "can't close driver ID")
+    H5MM_xfree(file->name);
+    file = H5FL_FREE(H5FD_blkcache_t, file);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_cmp
+ *
+ * Purpose:     Compares two files belonging to this driver by comparing
+ *              the files cached.
+ *
+ * Return:      Success:    A value like strcmp()
+ *              Failure:    never fails (arguments were checked by the
+ *                          caller).
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD_blkcache_cmp(const H5FD_t *_f1, const H5FD_t *_f2)
+{
+    const H5FD_blkcache_t *f1 = (const H5FD_blkcache_t *)_f1;
+    const H5FD_blkcache_t *f2 = (const H5FD_blkcache_t *)_f2;
+    int ret_value = 0;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    ret_value = H5FD_cmp(f1->back, f2->back);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_query
+ *
+ * Purpose:     Set the flags that this VFL driver is capable of supporting.
+ *              (listed in H5FDpublic.h)  For an open file, these are the
+ *              underlying driver's flags that don't depend on the file
+ *              handle or image it uses.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_query(const H5FD_t *_file, unsigned long *flags /* out */)
+{
+    const H5FD_blkcache_t *file = (const H5FD_blkcache_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Set the VFL feature flags that this driver supports */
+    if(flags) {
+        if(file)
+            *flags = file->back->feature_flags & (H5FD_FEAT_AGGREGATE_METADATA
+                                                 | H5FD_FEAT_ACCUMULATE_METADATA
+                                                 | H5FD_FEAT_DATA_SIEVE
+                                                 | H5FD_FEAT_AGGREGATE_SMALLDATA
+                                                 | H5FD_FEAT_IGNORE_DRVRINFO
+                                                 | H5FD_FEAT_DIRTY_DRVRINFO_LOAD);
+        else {
+            *flags = 0;
+            *flags |= H5FD_FEAT_AGGREGATE_METADATA; /* OK to aggregate metadata allocations */
+            *flags |= H5FD_FEAT_ACCUMULATE_METADATA; /* OK to accumulate metadata for faster writes */
+            *flags |= H5FD_FEAT_DATA_SIEVE;       /* OK to perform data sieving for faster raw data reads & writes */
+            *flags |= H5FD_FEAT_AGGREGATE_SMALLDATA; /* OK to aggregate "small" raw data allocations */
+        } /* end else */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_blkcache_query() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_get_eoa
+ *
+ * Purpose:     Gets the end-of-address marker for the file. The EOA marker
+ *              is the first address past the last byte allocated in the
+ *              format address space.
+ *
+ * Return:      The end-of-address marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_blkcache_get_eoa(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_blkcache_t *file = (const H5FD_blkcache_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eoa)
+} /* end H5FD_blkcache_get_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_set_eoa
+ *
+ * Purpose:     Set the end-of-address marker for the file, and for the
+ *              file cached.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_set_eoa(file->back, type, addr) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to set eoa of file cached")
+    file->eoa = addr;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_set_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_get_eof
+ *
+ * Purpose:     Returns the end-of-file marker of the file cached.
+ *
+ * Return:      Success:    The end-of-file marker.
+ *              Failure:    HADDR_UNDEF
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_blkcache_get_eof(const H5FD_t *_file, H5FD_mem_t type)
+{
+    const H5FD_blkcache_t *file = (const H5FD_blkcache_t *)_file;
+    haddr_t ret_value = HADDR_UNDEF;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(HADDR_UNDEF == (ret_value = H5FD_get_eof(file->back, type)))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTGET, HADDR_UNDEF, "unable to get eof of file cached")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_get_eof() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_get_handle
+ *
+ * Purpose:     Returns the file handle of the file cached.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_get_handle(H5FD_t *_file, hid_t fapl, void **file_handle)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_get_vfd_handle(file->back, fapl, file_handle) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "unable to get handle of file cached")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_get_handle() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_read
+ *
+ * Purpose:     Reads SIZE bytes of data from FILE beginning at address
+ *              ADDR into buffer BUF.  Blocks in the cache are read from
+ *              it; each run of consecutive blocks that aren't is read from
+ *              the file cached with one request and put in the pool for
+ *              the kind of data read.  Requests for data that isn't
+ *              cached, or too large to fit in its pool, go straight to the
+ *              file cached.
+ *
+ * Return:      SUCCEED/FAIL (a failure to read or write the cache
+ *              files only stops the file being cached)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_read(H5FD_t *_file, H5FD_mem_t type, hid_t H5_ATTR_UNUSED dxpl_id,
+    haddr_t addr, size_t size, void *_buf/*out*/)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    H5FD_blkcache_pool_t *pool = &file->pool[H5FD_BLKCACHE_POOL(type)];
+    unsigned char *buf = (unsigned char *)_buf;
+    size_t      block_size = file->fa.block_size;
+    haddr_t     end = addr + size;      /* End of request */
+    haddr_t     blk;                    /* Current block number */
+    haddr_t     last;                   /* Last block of request */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->pub.cls);
+    HDassert(buf);
+
+    if(0 == size)
+        HGOTO_DONE(SUCCEED)
+
+    /* Uncached requests */
+    last = (end - 1) / block_size;
+    if(file->data_fd < 0 || (last - addr / block_size) >= pool->nslots) {
+        if(H5FD_read(file->back, type, addr, size, buf) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "read of file cached failed")
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+    blk = addr / block_size;
+    while(blk <= last) {
+        H5FD_blkcache_pool_t *ent_pool = NULL;  /* Pool block is in */
+        H5FD_blkcache_ent_t *ent;       /* Block's slot */
+        haddr_t     blk_addr = blk * block_size;
+        haddr_t     lo = MAX(addr, blk_addr);       /* Start of request in block */
+        haddr_t     hi = MIN(end, blk_addr + block_size); /* End of request in block */
+        size_t      nrun;               /* Blocks in run of missing blocks */
+        size_t      run_len;            /* Bytes read for run */
+        size_t      u;                  /* Local index variable */
+
+        /* Read a cached block */
+        if(NULL != (ent = H5FD__blkcache_find(file, blk_addr, &ent_pool)) && ent->len >= (size_t)(hi - blk_addr)) {
+            unsigned slot = ent_pool->first_slot + (unsigned)(ent - ent_pool->ents);
+
+            if(H5FD__blkcache_pio(file->data_fd, FALSE, (HDoff_t)slot * (HDoff_t)block_size + (HDoff_t)(lo - blk_addr), (size_t)(hi - lo), buf + (lo - addr)) < 0) {
+                /* Stop caching, and read the rest from the file cached */
+                H5FD__blkcache_disable(file);
+                if(H5FD_read(file->back, type, lo, (size_t)(end - lo), buf + (lo - addr)) < 0)
+                    HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "read of file cached failed")
+                HGOTO_DONE(SUCCEED)
+            } /* end if */
+            H5FD__blkcache_touch(ent_pool, ent);
+            blk++;
+            continue;
+        } /* end if */
+
+        /* Find the run of missing blocks starting with this one */
+        for(nrun = 1; nrun < H5FD_BLKCACHE_MAX_RUN && blk + nrun <= last; nrun++) {
+            ent = H5FD__blkcache_find(file, (blk + nrun) * block_size, &ent_pool);
+            if(ent && ent->len >= (size_t)(MIN(end, (blk + nrun + 1) * block_size) - (blk + nrun) * block_size))
+                break;
+        } /* end for */
+
+        /* Read the run from the file cached, up to the end of allocated space */
+        HDassert(file->eoa >= end);
+        run_len = (size_t)(MIN(file->eoa, (blk + nrun) * block_size) - blk_addr);
+        if(H5FD_read(file->back, type, blk_addr, run_len, file->buf) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "read of file cached failed")
+
+        /* Cache the blocks and copy out the parts requested */
+        for(u = 0; u < nrun; u++, blk++) {
+            size_t blk_off = u * block_size;    /* Offset of block in run */
+
+            blk_addr = blk * block_size;
+            lo = MAX(addr, blk_addr);
+            hi = MIN(end, blk_addr + block_size);
+            HDmemcpy(buf + (lo - addr), file->buf + blk_off + (lo - blk_addr), (size_t)(hi - lo));
+            if(H5FD__blkcache_insert(file, pool, blk_addr, MIN(block_size, run_len - blk_off), file->buf + blk_off) < 0) {
+                /* Stop caching, and read the rest from the file cached */
+                H5E_clear_stack(NULL);
+                H5FD__blkcache_disable(file);
+                if(hi < end && H5FD_read(file->back, type, hi, (size_t)(end - hi), buf + (hi - addr)) < 0)
+                    HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "read of file cached failed")
+                HGOTO_DONE(SUCCEED)
+            } /* end if */
+        } /* end for */
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_read() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_write
+ *
+ * Purpose:     Writes SIZE bytes of data to FILE beginning at address
+ *              ADDR from buffer BUF, to the file cached and to the blocks
+ *              it touches that are in the cache.  A cached block that
+ *              would be left with a hole in it is dropped instead.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_write(H5FD_t *_file, H5FD_mem_t type, hid_t H5_ATTR_UNUSED dxpl_id,
+    haddr_t addr, size_t size, const void *_buf)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    const unsigned char *buf = (const unsigned char *)_buf;
+    size_t      block_size = file->fa.block_size;
+    haddr_t     end = addr + size;      /* End of request */
+    haddr_t     blk;                    /* Current block number */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->pub.cls);
+    HDassert(buf);
+
+    if(H5FD_write(file->back, type, addr, size, buf) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "write to file cached failed")
+
+    if(file->data_fd < 0 || 0 == size)
+        HGOTO_DONE(SUCCEED)
+
+    /* Update the cached blocks */
+    for(blk = addr / block_size; blk <= (end - 1) / block_size; blk++) {
+        H5FD_blkcache_pool_t *ent_pool = NULL;  /* Pool block is in */
+        H5FD_blkcache_ent_t *ent;       /* Block's slot */
+        haddr_t     blk_addr = blk * block_size;
+        haddr_t     lo = MAX(addr, blk_addr);       /* Start of request in block */
+        haddr_t     hi = MIN(end, blk_addr + block_size); /* End of request in block */
+        unsigned    slot;
+
+        if(NULL == (ent = H5FD__blkcache_find(file, blk_addr, &ent_pool)))
+            continue;
+        if(H5FD__blkcache_invalidate_index(file) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTDELETE, FAIL, "unable to invalidate cache index")
+        if((size_t)(lo - blk_addr) > ent->len) {
+            H5FD__blkcache_evict(ent_pool, ent);
+            continue;
+        } /* end if */
+
+        slot = ent_pool->first_slot + (unsigned)(ent - ent_pool->ents);
+        if(H5FD__blkcache_pio(file->data_fd, TRUE, (HDoff_t)slot * (HDoff_t)block_size + (HDoff_t)(lo - blk_addr), (size_t)(hi - lo), (void *)(buf + (lo - addr))) < 0) {
+            /* Stop caching (the index is gone, so the slot can't be used again) */
+            H5FD__blkcache_disable(file);
+            HGOTO_DONE(SUCCEED)
+        } /* end if */
+        ent->len = MAX(ent->len, (size_t)(hi - blk_addr));
+    } /* end for */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_write() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_flush
+ *
+ * Purpose:     Flushes the file cached, and writes the index of the cache
+ *              so a process that is restarted after this finds it.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_flush(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, hbool_t closing)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_flush(file->back, closing) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTFLUSH, FAIL, "unable to flush file cached")
+
+    /* (The index is written when the file is closed) */
+    if(!closing && file->data_fd >= 0)
+        if(H5FD__blkcache_save_index(file, H5FD_get_eof(file->back, H5FD_MEM_DEFAULT)) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_CANTFLUSH, FAIL, "unable to write cache index")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_flush() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_truncate
+ *
+ * Purpose:     Truncates the file cached, and drops the parts of cached
+ *              blocks past its new end.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_truncate(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, hbool_t closing)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    haddr_t     eof;                    /* New end of file */
+    unsigned    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_truncate(file->back, closing) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTUPDATE, FAIL, "unable to truncate file cached")
+
+    if(file->data_fd < 0)
+        HGOTO_DONE(SUCCEED)
+    if(HADDR_UNDEF == (eof = H5FD_get_eof(file->back, H5FD_MEM_DEFAULT)))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTGET, FAIL, "unable to get eof of file cached")
+
+    for(u = 0; u < H5FD_BLKCACHE_NPOOLS; u++) {
+        H5FD_blkcache_pool_t *pool = &file->pool[u];
+        H5FD_blkcache_ent_t *ent, *next;
+
+        for(ent = pool->head; ent; ent = next) {
+            next = ent->next;
+            if(ent->addr + ent->len > eof) {
+                if(H5FD__blkcache_invalidate_index(file) < 0)
+                    HGOTO_ERROR(H5E_VFL, H5E_CANTDELETE, FAIL, "unable to invalidate cache index")
+                if(ent->addr >= eof)
+                    H5FD__blkcache_evict(pool, ent);
+                else
+                    ent->len = (size_t)(eof - ent->addr);
+            } /* end if */
+        } /* end for */
+    } /* end for */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_truncate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_lock
+ *
+ * Purpose:     Locks the file cached.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_lock(H5FD_t *_file, hbool_t rw)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_lock(file->back, rw) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTLOCK, FAIL, "unable to lock file cached")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_lock() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_blkcache_unlock
+ *
+ * Purpose:     Unlocks the file cached.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_blkcache_unlock(H5FD_t *_file)
+{
+    H5FD_blkcache_t *file = (H5FD_blkcache_t *)_file;
+    herr_t ret_value = SUCCEED;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_unlock(file->back) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTUNLOCK, FAIL, "unable to unlock file cached")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_blkcache_unlock() */
+
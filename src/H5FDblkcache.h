@@ -0,0 +1,45 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The public header file for the block cache driver, which
+ *              keeps a persistent cache of blocks of a file in a local
+ *              directory and passes I/O through to another driver.
+ */
+#ifndef H5FDblkcache_H
+#define H5FDblkcache_H
+
+#define H5FD_BLKCACHE	(H5FD_blkcache_init())
+
+/* Default cache block size, and longest cache directory name */
+#define H5FD_BLKCACHE_BLOCK_SIZE_DEF    (64 * 1024)
+#define H5FD_BLKCACHE_MAX_DIR_LEN       1024
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+H5_DLL hid_t H5FD_blkcache_init(void);
+H5_DLL herr_t H5Pset_fapl_blkcache(hid_t fapl_id, const char *cache_dir,
+    size_t block_size, hsize_t meta_cache_size, hsize_t raw_cache_size,
+    hid_t back_fapl_id);
+H5_DLL herr_t H5Pget_fapl_blkcache(hid_t fapl_id, size_t dir_size,
+    char *cache_dir/*out*/, size_t *block_size/*out*/,
+    hsize_t *meta_cache_size/*out*/, hsize_t *raw_cache_size/*out*/,
+    hid_t *back_fapl_id/*out*/);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -101,6 +101,18 @@ static herr_t H5FD_family_read(H5FD_t *_file, H5FD_mem_t type, hid_t dxpl_id, ha
 			       size_t size, void *_buf/*out*/);
 static herr_t H5FD_family_write(H5FD_t *_file, H5FD_mem_t type, hid_t dxpl_id, haddr_t addr,
 				size_t size, const void *_buf);
+static herr_t H5FD_family_read_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *bufs[]/*out*/);
+static herr_t H5FD_family_write_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    const void *bufs[]);
+static herr_t H5FD_family_vector_io(H5FD_family_t *file, hid_t dxpl_id,
+    size_t count, const H5FD_mem_t types[], const haddr_t addrs[],
+    const size_t sizes[], void *rbufs[], const void *wbufs[]);
+static herr_t H5FD_family_vector_memb_io(H5FD_t *memb, hid_t dxpl_id,
+    size_t count, const H5FD_mem_t types[], const haddr_t addrs[],
+    const size_t sizes[], void *rbufs[], const void *wbufs[]);
 static herr_t H5FD_family_flush(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
 static herr_t H5FD_family_truncate(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
 static herr_t H5FD_family_lock(H5FD_t *_file, hbool_t rw);
@@ -135,6 +147,8 @@ static const H5FD_class_t H5FD_family_g = {
     H5FD_family_get_handle,                     /*get_handle            */
     H5FD_family_read,				/*read			*/
     H5FD_family_write,				/*write			*/
+    H5FD_family_read_vector,			/*read_vector		*/
+    H5FD_family_write_vector,			/*write_vector		*/
     H5FD_family_flush,				/*flush			*/
     H5FD_family_truncate,			/*truncate		*/
     H5FD_family_lock,                           /*lock                  */
@@ -1251,6 +1265,214 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 }
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_family_read_vector
+ *
+ * Purpose:     Performs COUNT reads from FILE, splitting each one across
+ *              the members it spans.  Consecutive pieces that fall in the
+ *              same member are passed to that member as one vector read.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_family_read_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *bufs[]/*out*/)
+{
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_family_vector_io((H5FD_family_t *)_file, dxpl_id, count, types, addrs, sizes, bufs, NULL) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "member file vector read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_family_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_family_write_vector
+ *
+ * Purpose:     Performs COUNT writes to FILE, splitting each one across
+ *              the members it spans.  Consecutive pieces that fall in the
+ *              same member are passed to that member as one vector write.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_family_write_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    const void *bufs[])
+{
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_family_vector_io((H5FD_family_t *)_file, dxpl_id, count, types, addrs, sizes, NULL, bufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "member file vector write failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_family_write_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_family_vector_memb_io
+ *
+ * Purpose:     Performs a vector read (RBUFS non-NULL) or write (WBUFS
+ *              non-NULL) of COUNT pieces on one member file.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_family_vector_memb_io(H5FD_t *memb, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *rbufs[], const void *wbufs[])
+{
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(rbufs) {
+        if(H5FDread_vector(memb, dxpl_id, count, types, addrs, sizes, rbufs) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "member file vector read failed")
+    } /* end if */
+    else
+        if(H5FDwrite_vector(memb, dxpl_id, count, types, addrs, sizes, wbufs) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "member file vector write failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_family_vector_memb_io() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_family_vector_io
+ *
+ * Purpose:     Common code for vector reads (RBUFS non-NULL) and writes
+ *              (WBUFS non-NULL).  Each request is split at member
+ *              boundaries, and each run of consecutive pieces in the same
+ *              member is dispatched with one vector I/O call on that
+ *              member.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_family_vector_io(H5FD_family_t *file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *rbufs[], const void *wbufs[])
+{
+    H5FD_mem_t  *memb_types = NULL;     /* Memory types of pieces */
+    haddr_t     *memb_addrs = NULL;     /* Member addresses of pieces */
+    size_t      *memb_sizes = NULL;     /* Sizes of pieces */
+    void        **memb_rbufs = NULL;    /* Read buffers for pieces */
+    const void  **memb_wbufs = NULL;    /* Write buffers for pieces */
+    size_t      npieces = 0;            /* Number of pieces */
+    size_t      n = 0;                  /* Current piece */
+    size_t      run_start = 0;          /* First piece in current run */
+    unsigned    run_memb = 0;           /* Member for current run */
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+    HDassert((rbufs != NULL) != (wbufs != NULL));
+
+    /* Count the pieces the requests are split into */
+    for(u = 0; u < count; u++)
+        if(sizes[u] > 0)
+            npieces += (size_t)(((addrs[u] + sizes[u] - 1) / file->memb_size) - (addrs[u] / file->memb_size)) + 1;
+    if(0 == npieces)
+        HGOTO_DONE(SUCCEED)
+
+    /* Allocate the member requests */
+    if(NULL == (memb_types = (H5FD_mem_t *)H5MM_malloc(npieces * sizeof(H5FD_mem_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate member request array")
+    if(NULL == (memb_addrs = (haddr_t *)H5MM_malloc(npieces * sizeof(haddr_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate member request array")
+    if(NULL == (memb_sizes = (size_t *)H5MM_malloc(npieces * sizeof(size_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate member request array")
+    if(rbufs) {
+        if(NULL == (memb_rbufs = (void **)H5MM_malloc(npieces * sizeof(void *))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate member request array")
+    } /* end if */
+    else
+        if(NULL == (memb_wbufs = (const void **)H5MM_malloc(npieces * sizeof(void *))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to allocate member request array")
+
+    /* Split the requests, dispatching each run of pieces in one member */
+    for(u = 0; u < count; u++) {
+        haddr_t     addr = addrs[u];    /* Current address in request */
+        size_t      size = sizes[u];    /* Bytes left in request */
+        size_t      off = 0;            /* Offset of piece in request's buffer */
+
+        while(size > 0) {
+            unsigned    memb;           /* Member for piece */
+            haddr_t     sub;            /* Address of piece in member */
+            size_t      req;            /* Size of piece */
+            hsize_t     tempreq;        /* Bytes left in member */
+
+            H5_CHECKED_ASSIGN(memb, unsigned, addr / file->memb_size, hsize_t);
+            HDassert(memb < file->nmembs);
+            sub = addr % file->memb_size;
+
+            /* Don't overflow size_t on platforms where it's 32 bits */
+            tempreq = file->memb_size - sub;
+            if(tempreq > SIZET_MAX)
+                tempreq = SIZET_MAX;
+            req = MIN(size, (size_t)tempreq);
+
+            /* Dispatch the current run when the member changes */
+            if(n > run_start && memb != run_memb) {
+                if(H5FD_family_vector_memb_io(file->memb[run_memb], dxpl_id, n - run_start, memb_types + run_start, memb_addrs + run_start, memb_sizes + run_start, memb_rbufs ? memb_rbufs + run_start : NULL, memb_wbufs ? memb_wbufs + run_start : NULL) < 0)
+                    HGOTO_ERROR(H5E_IO, H5E_CANTOPERATE, FAIL, "member file vector I/O failed")
+                run_start = n;
+            } /* end if */
+            run_memb = memb;
+
+            /* Add the piece */
+            HDassert(n < npieces);
+            memb_types[n] = types[u];
+            memb_addrs[n] = sub;
+            memb_sizes[n] = req;
+            if(rbufs)
+                memb_rbufs[n] = (unsigned char *)rbufs[u] + off;
+            else
+                memb_wbufs[n] = (const unsigned char *)wbufs[u] + off;
+            n++;
+
+            addr += req;
+            off += req;
+            size -= req;
+        } /* end while */
+    } /* end for */
+    HDassert(n == npieces);
+
+    /* Dispatch the last run */
+    if(H5FD_family_vector_memb_io(file->memb[run_memb], dxpl_id, n - run_start, memb_types + run_start, memb_addrs + run_start, memb_sizes + run_start, memb_rbufs ? memb_rbufs + run_start : NULL, memb_wbufs ? memb_wbufs + run_start : NULL) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_CANTOPERATE, FAIL, "member file vector I/O failed")
+
+done:
+    H5MM_xfree(memb_types);
+    H5MM_xfree(memb_addrs);
+    H5MM_xfree(memb_sizes);
+    H5MM_xfree(memb_rbufs);
+    H5MM_xfree(memb_wbufs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_family_vector_io() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5FD_family_flush
@@ -0,0 +1,1599 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: A read-only file driver which reads a file from a web server or
+ *          an object store with HTTP/1.1 range requests, so that a file
+ *          can be read without copying it to local disk first.  The file
+ *          name is the file's URL, "http://host[:port]/path".
+ *
+ *          Opening a file takes a round trip to the server, and so does
+ *          each read that isn't satisfied locally, so the driver works
+ *          hard to make few requests.  The file's address space is
+ *          divided into blocks, and blocks read are kept in a cache in
+ *          memory, with the least recently used blocks evicted when it's
+ *          full; the small reads of metadata made while opening a file
+ *          and its objects mostly hit blocks already read.  The blocks
+ *          missing for a read (or for all the reads in a vector read) are
+ *          requested together, with blocks that are missing and close to
+ *          each other merged into a single range request, gaps included.
+ *          The requests for a read are spread over several persistent
+ *          connections to the server, which run concurrently on worker
+ *          threads.  Reads larger than the cache go straight to the
+ *          caller's buffer and aren't cached.
+ *
+ *          Only plain HTTP is spoken (no TLS), and responses must carry a
+ *          Content-Length (chunked transfer coding isn't supported).
+ */
+
+#include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
+
+
+#include "H5private.h"      /* Generic Functions        */
+#include "H5Eprivate.h"     /* Error handling           */
+#include "H5Fprivate.h"     /* File access              */
+#include "H5FDprivate.h"    /* File drivers             */
+#include "H5FDhttp.h"       /* HTTP file driver         */
+#include "H5FLprivate.h"    /* Free Lists               */
+#include "H5Iprivate.h"     /* IDs                      */
+#include "H5MMprivate.h"    /* Memory management        */
+#include "H5Pprivate.h"     /* Property lists           */
+#include "H5SLprivate.h"    /* Skip lists               */
+#include "H5TPprivate.h"    /* Thread pools             */
+
+#if defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H)
+
+#include <sys/socket.h>
+#include <netdb.h>
+
+/* The driver identification number, initialized at runtime */
+static hid_t H5FD_HTTP_g = 0;
+
+/* Largest response header, and how long to wait for the server (in
+ * seconds) before giving up on a request */
+#define H5FD_HTTP_HDR_MAX       8192
+#define H5FD_HTTP_TIMEOUT       60
+
+/* Flags for send(): don't raise SIGPIPE when the server has closed the
+ * connection (where the system can't do that per-socket) */
+#ifdef MSG_NOSIGNAL
+#define H5FD_HTTP_SEND_FLAGS    MSG_NOSIGNAL
+#else
+#define H5FD_HTTP_SEND_FLAGS    0
+#endif
+
+/*
+ * These macros check for overflow of various quantities.  These macros
+ * assume that HDoff_t is signed and haddr_t and size_t are unsigned.
+ *
+ * ADDR_OVERFLOW:   Checks whether a file address of type `haddr_t'
+ *                  is too large to be represented by the second argument
+ *                  of the file seek function.
+ *
+ * SIZE_OVERFLOW:   Checks whether a buffer size of type `hsize_t' is too
+ *                  large to be represented by the `size_t' type.
+ *
+ * REGION_OVERFLOW: Checks whether an address and size pair describe data
+ *                  which can be addressed entirely by the second
+ *                  argument of the file seek function.
+ */
+#define MAXADDR (((haddr_t)1<<(8*sizeof(HDoff_t)-1))-1)
+#define ADDR_OVERFLOW(A)    (HADDR_UNDEF==(A) || ((A) & ~(haddr_t)MAXADDR))
+#define SIZE_OVERFLOW(Z)    ((Z) & ~(hsize_t)MAXADDR)
+#define REGION_OVERFLOW(A,Z)    (ADDR_OVERFLOW(A) || SIZE_OVERFLOW(Z) ||    \
+                                 HADDR_UNDEF==(A)+(Z) ||                    \
+                                (HDoff_t)((A)+(Z))<(HDoff_t)(A))
+
+/* Driver-specific file access properties */
+typedef struct H5FD_http_fapl_t {
+    size_t      block_size;     /* Size of blocks cached                */
+    size_t      cache_size;     /* Size of block cache                  */
+    size_t      max_gap;        /* Largest gap between blocks merged    */
+    unsigned    nconns;         /* Number of connections to server      */
+} H5FD_http_fapl_t;
+
+/* A range of the file requested with one GET.  A range is either some
+ * whole blocks (the last one possibly cut short by the end of the file),
+ * read into the driver's buffer to be copied out and cached, or part of
+ * a large read, read straight into the caller's buffer.
+ */
+typedef struct H5FD_http_range_t {
+    haddr_t     addr;           /* Address of range                     */
+    size_t      len;            /* Length of range                      */
+    unsigned char *buf;         /* Buffer for range                     */
+    unsigned    conn;           /* Connection requesting range          */
+} H5FD_http_range_t;
+
+/* Forward declaration */
+struct H5FD_http_t;
+
+/* A connection to the server, and the task which makes its requests for
+ * a read.  The task requests the ranges assigned to its connection.
+ */
+typedef struct H5FD_http_conn_t {
+    H5TP_task_t task;           /* Worker thread task                   */
+    struct H5FD_http_t *file;   /* File the connection belongs to       */
+    unsigned    idx;            /* Index of connection                  */
+    int         sock;           /* Socket, -1 if not connected          */
+    size_t      nranges;        /* Number of ranges for read            */
+    H5FD_http_range_t *ranges;  /* Ranges for read, for all connections */
+    int         err;            /* errno from a failure, else 0         */
+    int         status;         /* HTTP status of a failed request, else 0 */
+    char        hdr[H5FD_HTTP_HDR_MAX + 1]; /* Response header          */
+} H5FD_http_conn_t;
+
+/* A block cache slot, and the block in it when it's in use */
+typedef struct H5FD_http_blk_t {
+    haddr_t     addr;           /* Address of block                     */
+    struct H5FD_http_blk_t *prev;   /* More recently used block         */
+    struct H5FD_http_blk_t *next;   /* Less recently used block         */
+} H5FD_http_blk_t;
+
+/* The description of a file belonging to this driver.  The 'eof' is the
+ * size of the file on the server when it was opened.
+ */
+typedef struct H5FD_http_t {
+    H5FD_t      pub;            /* public stuff, must be first          */
+    H5FD_http_fapl_t fa;        /* File access properties               */
+    char        *url;           /* URL of file                          */
+    char        *host;          /* Host (and port) for Host header      */
+    char        *path;          /* Path of file on server               */
+    struct addrinfo *ai;        /* Addresses of server                  */
+    haddr_t     eoa;            /* end of allocated region              */
+    haddr_t     eof;            /* end of file                          */
+    H5FD_http_conn_t *conns;    /* Connections to server                */
+    H5TP_t      *tp;            /* worker threads, or NULL              */
+
+    /* Block cache */
+    unsigned    nslots;         /* Number of slots                      */
+    H5FD_http_blk_t *blks;      /* Slots                                */
+    unsigned char *data;        /* Contents of slots                    */
+    H5SL_t      *index;         /* Slots in use, by block address       */
+    H5FD_http_blk_t *head;      /* Most recently used block             */
+    H5FD_http_blk_t *tail;      /* Least recently used block            */
+    unsigned    nfree;          /* Number of unused slots               */
+    unsigned    *free;          /* Stack of unused slots                */
+} H5FD_http_t;
+
+/* Prototypes */
+static herr_t H5FD_http_term(void);
+static void *H5FD_http_fapl_get(H5FD_t *_file);
+static H5FD_t *H5FD_http_open(const char *name, unsigned flags, hid_t fapl_id,
+            haddr_t maxaddr);
+static herr_t H5FD_http_close(H5FD_t *_file);
+static int H5FD_http_cmp(const H5FD_t *_f1, const H5FD_t *_f2);
+static herr_t H5FD_http_query(const H5FD_t *_f1, unsigned long *flags);
+static haddr_t H5FD_http_get_eoa(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t H5FD_http_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr);
+static haddr_t H5FD_http_get_eof(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t H5FD_http_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, void *buf);
+static herr_t H5FD_http_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, const void *buf);
+static herr_t H5FD_http_read_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+            const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+            void *bufs[]);
+
+static char *H5FD__http_strndup(const char *s, size_t n);
+static herr_t H5FD__http_parse_url(H5FD_http_t *file, const char *url);
+static herr_t H5FD__http_connect(H5FD_http_conn_t *conn);
+static void H5FD__http_disconnect(H5FD_http_conn_t *conn);
+static herr_t H5FD__http_request(H5FD_http_conn_t *conn, haddr_t addr,
+    size_t len, unsigned char *buf, haddr_t *size);
+static herr_t H5FD__http_conn_cb(void *_conn);
+static int H5FD__http_cmp_haddr(const void *_a, const void *_b);
+static H5FD_http_blk_t *H5FD__http_find(const H5FD_http_t *file, haddr_t addr);
+static void H5FD__http_touch(H5FD_http_t *file, H5FD_http_blk_t *blk);
+static void H5FD__http_insert(H5FD_http_t *file, haddr_t addr, size_t len,
+    const unsigned char *data);
+static herr_t H5FD__http_fetch(H5FD_http_t *file, size_t count,
+    const haddr_t addrs[], const size_t sizes[], void *bufs[]);
+
+static const H5FD_class_t H5FD_http_g = {
+    "http",                     /* name                 */
+    MAXADDR,                    /* maxaddr              */
+    H5F_CLOSE_WEAK,             /* fc_degree            */
+    H5FD_http_term,             /* terminate            */
+    NULL,                       /* sb_size              */
+    NULL,                       /* sb_encode            */
+    NULL,                       /* sb_decode            */
+    sizeof(H5FD_http_fapl_t),   /* fapl_size            */
+    H5FD_http_fapl_get,         /* fapl_get             */
+    NULL,                       /* fapl_copy            */
+    NULL,                       /* fapl_free            */
+    0,                          /* dxpl_size            */
+    NULL,                       /* dxpl_copy            */
+    NULL,                       /* dxpl_free            */
+    H5FD_http_open,             /* open                 */
+    H5FD_http_close,            /* close                */
+    H5FD_http_cmp,              /* cmp                  */
+    H5FD_http_query,            /* query                */
+    NULL,                       /* get_type_map         */
+    NULL,                       /* alloc                */
+    NULL,                       /* free                 */
+    H5FD_http_get_eoa,          /* get_eoa              */
+    H5FD_http_set_eoa,          /* set_eoa              */
+    H5FD_http_get_eof,          /* get_eof              */
+    NULL,                       /* get_handle           */
+    H5FD_http_read,             /* read                 */
+    H5FD_http_write,            /* write                */
+    H5FD_http_read_vector,      /* read_vector          */
+    NULL,                       /* write_vector         */
+    NULL,                       /* flush                */
+    NULL,                       /* truncate             */
+    NULL,                       /* lock                 */
+    NULL,                       /* unlock               */
+    H5FD_FLMAP_DICHOTOMY        /* fl_map               */
+};
+
+/* Declare a free list to manage the H5FD_http_t struct */
+H5FL_DEFINE_STATIC(H5FD_http_t);
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__init_package
+ *
+ * Purpose:     Initializes any interface-specific data or routines.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__init_package(void)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_STATIC
+
+    if(H5FD_http_init() < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to initialize HTTP VFD")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5FD__init_package() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_init
+ *
+ * Purpose:     Initialize this driver by registering the driver with the
+ *              library.
+ *
+ * Return:      Success:    The driver ID for the HTTP driver.
+ *              Failure:    Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5FD_http_init(void)
+{
+    hid_t ret_value = H5I_INVALID_HID;          /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    if(H5I_VFL != H5I_get_type(H5FD_HTTP_g))
+        H5FD_HTTP_g = H5FD_register(&H5FD_http_g, sizeof(H5FD_class_t), FALSE);
+
+    /* Set return value */
+    ret_value = H5FD_HTTP_g;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_init() */
+
+
+/*---------------------------------------------------------------------------
+ * Function:    H5FD_http_term
+ *
+ * Purpose:     Shut down the VFD
+ *
+ * Returns:     SUCCEED (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_term(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Reset VFL ID */
+    H5FD_HTTP_g = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_http_term() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_http
+ *
+ * Purpose:     Modify the file access property list to use the H5FD_HTTP
+ *              driver defined in this source file.  Blocks of BLOCK_SIZE
+ *              bytes are read and cached, in a cache of CACHE_SIZE bytes
+ *              (zero disables the cache).  Missing blocks separated by
+ *              fewer than MAX_GAP bytes are requested together.  Up to
+ *              NCONNS connections to the server are made for each file.
+ *              A BLOCK_SIZE or NCONNS of zero selects the default.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_http(hid_t fapl_id, size_t block_size, size_t cache_size,
+    size_t max_gap, unsigned nconns)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    H5FD_http_fapl_t fa;        /* Driver properties */
+    herr_t ret_value;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE5("e", "izzzIu", fapl_id, block_size, cache_size, max_gap, nconns);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(nconns > H5FD_HTTP_MAX_CONNS)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "too many connections")
+
+    HDmemset(&fa, 0, sizeof(fa));
+    fa.block_size = block_size ? block_size : H5FD_HTTP_BLOCK_SIZE_DEF;
+    fa.cache_size = cache_size;
+    fa.max_gap = max_gap;
+    fa.nconns = nconns ? nconns : H5FD_HTTP_NCONNS_DEF;
+
+    ret_value = H5P_set_driver(plist, H5FD_HTTP, &fa);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_http() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_fapl_http
+ *
+ * Purpose:     Returns information about the HTTP file access property
+ *              list though the function arguments.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_fapl_http(hid_t fapl_id, size_t *block_size/*out*/, size_t *cache_size/*out*/,
+    size_t *max_gap/*out*/, unsigned *nconns/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    const H5FD_http_fapl_t *fa;
+    herr_t      ret_value = SUCCEED;       /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE5("e", "ixxxx", fapl_id, block_size, cache_size, max_gap, nconns);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access list")
+    if(H5FD_HTTP != H5P_peek_driver(plist))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "incorrect VFL driver")
+    if(NULL == (fa = (const H5FD_http_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "bad VFL driver info")
+
+    if(block_size)
+        *block_size = fa->block_size;
+    if(cache_size)
+        *cache_size = fa->cache_size;
+    if(max_gap)
+        *max_gap = fa->max_gap;
+    if(nconns)
+        *nconns = fa->nconns;
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_fapl_http() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_fapl_get
+ *
+ * Purpose:     Gets a file access property list which could be used to
+ *              open an identical file.
+ *
+ * Return:      Success:    Ptr to new file access property list value.
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_http_fapl_get(H5FD_t *_file)
+{
+    H5FD_http_t *file = (H5FD_http_t *)_file;
+    H5FD_http_fapl_t *fa = NULL;
+    void *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(NULL == (fa = (H5FD_http_fapl_t *)H5MM_malloc(sizeof(H5FD_http_fapl_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
+    HDmemcpy(fa, &file->fa, sizeof(H5FD_http_fapl_t));
+
+    /* Set return value */
+    ret_value = fa;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_fapl_get() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_strndup
+ *
+ * Purpose:     Copies the first N characters of S into a new string.
+ *
+ * Return:      Success:    The new string.
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static char *
+H5FD__http_strndup(const char *s, size_t n)
+{
+    char        *ret_value = NULL;      /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(NULL == (ret_value = (char *)H5MM_malloc(n + 1)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "memory allocation failed")
+    HDmemcpy(ret_value, s, n);
+    ret_value[n] = '\0';
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_strndup() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_parse_url
+ *
+ * Purpose:     Splits the URL of a file into the server's host and port
+ *              and the path of the file on the server, and looks up the
+ *              server's addresses.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__http_parse_url(H5FD_http_t *file, const char *url)
+{
+    const char  *authority;             /* Host and port in URL */
+    const char  *path;                  /* Path in URL */
+    const char  *host_end;              /* End of host name */
+    char        *node = NULL;           /* Host name, for lookup */
+    char        *port = NULL;           /* Port, for lookup */
+    struct addrinfo hints;              /* Lookup hints */
+    int         gai_ret;                /* getaddrinfo() return value */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(HDstrncasecmp(url, "http://", (size_t)7))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "not an http:// URL")
+    authority = url + 7;
+    if(NULL == (path = HDstrchr(authority, '/')))
+        path = authority + HDstrlen(authority);
+    if(path == authority)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "no host in URL")
+
+    /* The host, which may be a bracketed IPv6 address, and the port */
+    if('[' == *authority) {
+        if(NULL == (host_end = HDstrchr(authority, ']')) || host_end > path)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "bad host in URL")
+        if(NULL == (node = H5FD__http_strndup(authority + 1, (size_t)(host_end - authority - 1))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to copy host name")
+        host_end++;
+    } /* end if */
+    else {
+        for(host_end = authority; host_end < path && ':' != *host_end; host_end++)
+            ;
+        if(NULL == (node = H5FD__http_strndup(authority, (size_t)(host_end - authority))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to copy host name")
+    } /* end else */
+    if(host_end < path) {
+        if(':' != *host_end || host_end + 1 == path)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "bad port in URL")
+        if(NULL == (port = H5FD__http_strndup(host_end + 1, (size_t)(path - host_end - 1))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to copy port")
+    } /* end if */
+
+    if(NULL == (file->host = H5FD__http_strndup(authority, (size_t)(path - authority))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to copy host name")
+    if(NULL == (file->path = H5MM_xstrdup(*path ? path : "/")))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to copy path")
+
+    HDmemset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if(0 != (gai_ret = getaddrinfo(node, port ? port : "80", &hints, &file->ai)))
+        HGOTO_ERROR(H5E_VFL, H5E_CANTOPENFILE, FAIL, "unable to look up host: host = '%s', error message = '%s'", node, gai_strerror(gai_ret))
+
+done:
+    H5MM_xfree(node);
+    H5MM_xfree(port);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_parse_url() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_connect
+ *
+ * Purpose:     Connects a connection to the server, trying each of its
+ *              addresses.  Runs on worker threads, so errors are only
+ *              recorded in the connection.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__http_connect(H5FD_http_conn_t *conn)
+{
+    const struct addrinfo *ai;          /* Address of server */
+    struct timeval timeout;             /* Timeout for requests */
+    herr_t      ret_value = FAIL;       /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(conn->sock < 0);
+
+    conn->err = ECONNREFUSED;
+    for(ai = conn->file->ai; ai; ai = ai->ai_next) {
+        if((conn->sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0) {
+            conn->err = errno;
+            continue;
+        } /* end if */
+        if(0 == connect(conn->sock, ai->ai_addr, ai->ai_addrlen)) {
+            conn->err = 0;
+            break;
+        } /* end if */
+        conn->err = errno;
+        HDclose(conn->sock);
+        conn->sock = -1;
+    } /* end for */
+
+    if(conn->sock >= 0) {
+        /* Don't wait forever for a server that has gone away */
+        timeout.tv_sec = H5FD_HTTP_TIMEOUT;
+        timeout.tv_usec = 0;
+        setsockopt(conn->sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, (socklen_t)sizeof(timeout));
+        setsockopt(conn->sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, (socklen_t)sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+        {
+            int one = 1;
+
+            setsockopt(conn->sock, SOL_SOCKET, SO_NOSIGPIPE, &one, (socklen_t)sizeof(one));
+        }
+#endif /* SO_NOSIGPIPE */
+        ret_value = SUCCEED;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_connect() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_disconnect
+ *
+ * Purpose:     Closes a connection to the server, if it's open.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__http_disconnect(H5FD_http_conn_t *conn)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    if(conn->sock >= 0) {
+        HDclose(conn->sock);
+        conn->sock = -1;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__http_disconnect() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_request
+ *
+ * Purpose:     Requests LEN bytes of the file at ADDR from the server
+ *              over a connection, and reads them into BUF.  With a NULL
+ *              BUF, asks for the size of the file instead (with a HEAD
+ *              request) and returns it in SIZE.
+ *
+ *              A connection that the server closed while it was idle is
+ *              reconnected, and the request sent again, once.  Runs on
+ *              worker threads, so errors are only recorded in the
+ *              connection: errno in 'err', or an unexpected HTTP status
+ *              in 'status' (-1 for a response that can't be used).
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__http_request(H5FD_http_conn_t *conn, haddr_t addr, size_t len,
+    unsigned char *buf, haddr_t *size)
+{
+    const H5FD_http_t *file = conn->file;   /* File for connection */
+    char        *req = NULL;            /* Request */
+    size_t      req_len;                /* Length of request */
+    size_t      hdr_len;                /* Bytes of response received */
+    char        *body;                  /* Start of body in header buffer */
+    char        *line;                  /* Header line */
+    int         status;                 /* HTTP status */
+    hbool_t     have_length = FALSE;    /* Whether response has a length */
+    hbool_t     have_range = FALSE;     /* Whether response has a range */
+    hbool_t     keep_alive = TRUE;      /* Whether connection stays open */
+    unsigned long long length = 0;      /* Content-Length */
+    unsigned long long range_start = 0; /* Start of Content-Range */
+    unsigned long long range_end = 0;   /* End of Content-Range */
+    size_t      nbody;                  /* Bytes of body in header buffer */
+    unsigned    attempt;                /* Times request sent */
+    herr_t      ret_value = FAIL;       /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    conn->err = 0;
+    conn->status = 0;
+
+    /* Build the request */
+    req_len = HDstrlen(file->path) + HDstrlen(file->host) + 128;
+    if(NULL == (req = (char *)HDmalloc(req_len))) {
+        conn->err = ENOMEM;
+        HGOTO_DONE(FAIL)
+    } /* end if */
+    if(buf)
+        HDsnprintf(req, req_len, "GET %s HTTP/1.1\r\nHost: %s\r\nRange: bytes=%llu-%llu\r\n\r\n",
+                file->path, file->host, (unsigned long long)addr, (unsigned long long)(addr + len - 1));
+    else
+        HDsnprintf(req, req_len, "HEAD %s HTTP/1.1\r\nHost: %s\r\n\r\n", file->path, file->host);
+    req_len = HDstrlen(req);
+
+    for(attempt = 0; ; attempt++) {
+        hbool_t     reused = (conn->sock >= 0);     /* Whether connection was used before */
+        size_t      nsent;          /* Bytes of request sent */
+        ssize_t     n;              /* Bytes sent or received */
+
+        if(!reused && H5FD__http_connect(conn) < 0)
+            HGOTO_DONE(FAIL)
+
+        /* Send the request */
+        for(nsent = 0; nsent < req_len; nsent += (size_t)n)
+            if((n = send(conn->sock, req + nsent, req_len - nsent, H5FD_HTTP_SEND_FLAGS)) < 0) {
+                if(EINTR == errno) {
+                    n = 0;
+                    continue;
+                } /* end if */
+                break;
+            } /* end if */
+
+        /* Receive the response header */
+        hdr_len = 0;
+        body = NULL;
+        if(nsent == req_len)
+            while(NULL == body && hdr_len < H5FD_HTTP_HDR_MAX) {
+                if((n = recv(conn->sock, conn->hdr + hdr_len, H5FD_HTTP_HDR_MAX - hdr_len, 0)) <= 0) {
+                    if(n < 0 && EINTR == errno)
+                        continue;
+                    break;
+                } /* end if */
+                hdr_len += (size_t)n;
+                conn->hdr[hdr_len] = '\0';
+                body = HDstrstr(conn->hdr, "\r\n\r\n");
+            } /* end while */
+        if(body)
+            break;
+
+        /* The server closed an idle connection: try once more on a new
+         * one */
+        conn->err = (n < 0) ? errno : ECONNRESET;
+        H5FD__http_disconnect(conn);
+        if(!reused || 0 != hdr_len || attempt > 0) {
+            if(hdr_len >= H5FD_HTTP_HDR_MAX) {
+                conn->err = 0;
+                conn->status = -1;
+            } /* end if */
+            HGOTO_DONE(FAIL)
+        } /* end if */
+        conn->err = 0;
+    } /* end for */
+    *body = '\0';
+    body += 4;
+    nbody = hdr_len - (size_t)(body - conn->hdr);
+
+    /* Parse the status line and the headers we need */
+    if(HDstrncmp(conn->hdr, "HTTP/1.", (size_t)7) || NULL == (line = HDstrchr(conn->hdr, ' '))) {
+        conn->status = -1;
+        HGOTO_DONE(FAIL)
+    } /* end if */
+    status = HDatoi(line + 1);
+    if(HDstrncmp(conn->hdr, "HTTP/1.0", (size_t)8) == 0)
+        keep_alive = FALSE;
+    for(line = HDstrstr(conn->hdr, "\r\n"); line; line = HDstrstr(line, "\r\n")) {
+        line += 2;
+        if(!HDstrncasecmp(line, "Content-Length:", (size_t)15)) {
+            length = HDstrtoull(line + 15, NULL, 10);
+            have_length = TRUE;
+        } /* end if */
+        else if(!HDstrncasecmp(line, "Content-Range:", (size_t)14)) {
+            char *p = line + 14;
+
+            while(' ' == *p)
+                p++;
+            if(!HDstrncasecmp(p, "bytes ", (size_t)6)) {
+                range_start = HDstrtoull(p + 6, &p, 10);
+                if('-' == *p) {
+                    range_end = HDstrtoull(p + 1, NULL, 10);
+                    have_range = TRUE;
+                } /* end if */
+            } /* end if */
+        } /* end if */
+        else if(!HDstrncasecmp(line, "Connection:", (size_t)11)) {
+            if(HDstrstr(line, "close") || HDstrstr(line, "Close"))
+                keep_alive = FALSE;
+        } /* end if */
+        else if(!HDstrncasecmp(line, "Transfer-Encoding:", (size_t)18)) {
+            /* Chunked responses aren't supported */
+            conn->status = -1;
+            H5FD__http_disconnect(conn);
+            HGOTO_DONE(FAIL)
+        } /* end if */
+    } /* end for */
+
+    if(NULL == buf) {
+        /* A HEAD request: the size of the file */
+        if(200 != status || !have_length) {
+            conn->status = (200 != status) ? status : -1;
+            H5FD__http_disconnect(conn);
+            HGOTO_DONE(FAIL)
+        } /* end if */
+        *size = (haddr_t)length;
+    } /* end if */
+    else {
+        unsigned char *p = buf;         /* Where body goes */
+        size_t      left = len;         /* Bytes of body still to receive */
+
+        /* The requested range, or all of a file that is just that big */
+        if(!have_length || length != (unsigned long long)len
+                || (206 == status && (!have_range || range_start != (unsigned long long)addr
+                        || range_end != (unsigned long long)(addr + len - 1)))
+                || (200 == status && 0 != addr)
+                || (206 != status && 200 != status)) {
+            conn->status = (206 != status && 200 != status) ? status : -1;
+            H5FD__http_disconnect(conn);
+            HGOTO_DONE(FAIL)
+        } /* end if */
+
+        /* Receive the body, starting with any that came with the header */
+        if(nbody > left) {
+            conn->status = -1;
+            H5FD__http_disconnect(conn);
+            HGOTO_DONE(FAIL)
+        } /* end if */
+        HDmemcpy(p, body, nbody);
+        p += nbody;
+        left -= nbody;
+        while(left > 0) {
+            ssize_t n = recv(conn->sock, p, MIN(left, (size_t)H5_POSIX_MAX_IO_BYTES), 0);
+
+            if(n <= 0) {
+                if(n < 0 && EINTR == errno)
+                    continue;
+                conn->err = (n < 0) ? errno : ECONNRESET;
+                H5FD__http_disconnect(conn);
+                HGOTO_DONE(FAIL)
+            } /* end if */
+            p += n;
+            left -= (size_t)n;
+        } /* end while */
+    } /* end else */
+
+    if(!keep_alive)
+        H5FD__http_disconnect(conn);
+    ret_value = SUCCEED;
+
+done:
+    if(req)
+        HDfree(req);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_request() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_conn_cb
+ *
+ * Purpose:     Requests the ranges of a read assigned to a connection.
+ *              Runs on a worker thread, so errors are only recorded in the
+ *              connection, for the caller to report.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__http_conn_cb(void *_conn)
+{
+    H5FD_http_conn_t *conn = (H5FD_http_conn_t *)_conn;     /* Task */
+    size_t      r;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(r = 0; r < conn->nranges; r++) {
+        const H5FD_http_range_t *range = &conn->ranges[r];
+
+        if(range->conn == conn->idx && H5FD__http_request(conn, range->addr, range->len, range->buf, NULL) < 0)
+            HGOTO_DONE(FAIL)
+    } /* end for */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_conn_cb() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_open
+ *
+ * Purpose:     Opens the file at the URL NAME, which must be opened
+ *              read-only, and finds its size.
+ *
+ * Return:      Success:    A pointer to a new file data structure.  The
+ *                          public fields will be initialized by the
+ *                          caller, which is always H5FD_open().
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+H5FD_http_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
+{
+    H5FD_http_t     *file = NULL;       /* HTTP VFD info */
+    H5P_genplist_t  *plist;             /* Property list pointer */
+    const H5FD_http_fapl_t *fa;         /* Driver properties */
+    unsigned        u;                  /* Local index variable */
+    H5FD_t          *ret_value = NULL;  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Sanity check on file offsets */
+    HDcompile_assert(sizeof(HDoff_t) >= sizeof(size_t));
+
+    /* Check arguments */
+    if(!name || !*name)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "invalid file name")
+    if(0 == maxaddr || HADDR_UNDEF == maxaddr)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADRANGE, NULL, "bogus maxaddr")
+    if(ADDR_OVERFLOW(maxaddr))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, NULL, "bogus maxaddr")
+    if(flags & (H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC))
+        HGOTO_ERROR(H5E_ARGS, H5E_UNSUPPORTED, NULL, "the HTTP driver is read-only")
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, NULL, "not a file access property list")
+    if(NULL == (fa = (const H5FD_http_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, NULL, "bad VFL driver info")
+
+    /* Create the new file struct */
+    if(NULL == (file = H5FL_CALLOC(H5FD_http_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to allocate file struct")
+    HDmemcpy(&file->fa, fa, sizeof(H5FD_http_fapl_t));
+    if(NULL == (file->url = H5MM_xstrdup(name)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to copy URL")
+    if(H5FD__http_parse_url(file, name) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTOPENFILE, NULL, "unable to open URL")
+
+    /* Set up the connections, and ask for the file's size on the first */
+    if(NULL == (file->conns = (H5FD_http_conn_t *)H5MM_calloc(file->fa.nconns * sizeof(H5FD_http_conn_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate connections")
+    for(u = 0; u < file->fa.nconns; u++) {
+        file->conns[u].file = file;
+        file->conns[u].idx = u;
+        file->conns[u].sock = -1;
+    } /* end for */
+    if(H5FD__http_request(&file->conns[0], (haddr_t)0, (size_t)0, NULL, &file->eof) < 0) {
+        if(file->conns[0].err)
+            HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to open file: url = '%s', errno = %d, error message = '%s'", name, file->conns[0].err, HDstrerror(file->conns[0].err))
+        else
+            HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to open file: url = '%s', HTTP status = %d", name, file->conns[0].status)
+    } /* end if */
+    if(file->fa.nconns > 1)
+        if(NULL == (file->tp = H5TP_create(file->fa.nconns)))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, NULL, "unable to create worker threads")
+
+    /* Set up the block cache */
+    if(file->fa.cache_size / file->fa.block_size > 0) {
+        file->nslots = (unsigned)MIN(file->fa.cache_size / file->fa.block_size, UINT_MAX);
+        if(NULL == (file->blks = (H5FD_http_blk_t *)H5MM_calloc(file->nslots * sizeof(H5FD_http_blk_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate block cache")
+        if(NULL == (file->data = (unsigned char *)H5MM_malloc((size_t)file->nslots * file->fa.block_size)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate block cache")
+        if(NULL == (file->free = (unsigned *)H5MM_malloc(file->nslots * sizeof(unsigned))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate block cache")
+        if(NULL == (file->index = H5SL_create(H5SL_TYPE_HADDR, NULL)))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTCREATE, NULL, "unable to create block cache index")
+        for(u = 0; u < file->nslots; u++)
+            file->free[u] = file->nslots - u - 1;
+        file->nfree = file->nslots;
+    } /* end if */
+
+    /* Set return value */
+    ret_value = (H5FD_t*)file;
+
+done:
+    if(NULL == ret_value && file)
+        H5FD_http_close((H5FD_t *)file);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_close
+ *
+ * Purpose:     Closes the connections to the server and frees the block
+ *              cache.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_close(H5FD_t *_file)
+{
+    H5FD_http_t *file = (H5FD_http_t *)_file;
+    unsigned    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    if(file->tp && H5TP_close(file->tp) < 0)
+        HDONE_ERROR(H5E_VFL, H5E_CANTCLOSEOBJ, FAIL, "unable to shut down worker threads")
+    if(file->conns) {
+        for(u = 0; u < file->fa.nconns; u++)
+            H5FD__http_disconnect(&file->conns[u]);
+        H5MM_xfree(file->conns);
+    } /* end if */
+    if(file->index)
+        H5SL_close(file->index);
+    H5MM_xfree(file->blks);
+    H5MM_xfree(file->data);
+    H5MM_xfree(file->free);
+    if(file->ai)
+        freeaddrinfo(file->ai);
+    H5MM_xfree(file->url);
+    H5MM_xfree(file->host);
+    H5MM_xfree(file->path);
+    file = H5FL_FREE(H5FD_http_t, file);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_cmp
+ *
+ * Purpose:     Compares two files belonging to this driver by their URLs.
+ *
+ * Return:      Success:    A value like strcmp()
+ *              Failure:    never fails (arguments were checked by the
+ *                          caller).
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD_http_cmp(const H5FD_t *_f1, const H5FD_t *_f2)
+{
+    const H5FD_http_t *f1 = (const H5FD_http_t *)_f1;
+    const H5FD_http_t *f2 = (const H5FD_http_t *)_f2;
+    int ret_value = 0;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    ret_value = HDstrcmp(f1->url, f2->url);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_query
+ *
+ * Purpose:     Set the flags that this VFL driver is capable of supporting.
+ *              (listed in H5FDpublic.h)
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_query(const H5FD_t H5_ATTR_UNUSED *_file, unsigned long *flags /* out */)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Set the VFL feature flags that this driver supports */
+    if(flags) {
+        *flags = 0;
+        *flags |= H5FD_FEAT_AGGREGATE_METADATA; /* OK to aggregate metadata allocations */
+        *flags |= H5FD_FEAT_ACCUMULATE_METADATA; /* OK to accumulate metadata for faster writes */
+        *flags |= H5FD_FEAT_DATA_SIEVE;       /* OK to perform data sieving for faster raw data reads & writes */
+        *flags |= H5FD_FEAT_AGGREGATE_SMALLDATA; /* OK to aggregate "small" raw data allocations */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_http_query() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_get_eoa
+ *
+ * Purpose:     Gets the end-of-address marker for the file. The EOA marker
+ *              is the first address past the last byte allocated in the
+ *              format address space.
+ *
+ * Return:      The end-of-address marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_http_get_eoa(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_http_t *file = (const H5FD_http_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eoa)
+} /* end H5FD_http_get_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_set_eoa
+ *
+ * Purpose:     Set the end-of-address marker for the file. This function is
+ *              called shortly after an existing HDF5 file is opened in order
+ *              to tell the driver where the end of the HDF5 data is located.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_set_eoa(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, haddr_t addr)
+{
+    H5FD_http_t *file = (H5FD_http_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    file->eoa = addr;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_http_set_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_get_eof
+ *
+ * Purpose:     Returns the end-of-file marker, which is the size of the
+ *              file on the server when it was opened.
+ *
+ * Return:      The end-of-file marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_http_get_eof(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_http_t *file = (const H5FD_http_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eof)
+} /* end H5FD_http_get_eof() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_cmp_haddr
+ *
+ * Purpose:     Compares two addresses, for sorting.
+ *
+ * Return:      A value like strcmp()
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD__http_cmp_haddr(const void *_a, const void *_b)
+{
+    haddr_t     a = *(const haddr_t *)_a;
+    haddr_t     b = *(const haddr_t *)_b;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    FUNC_LEAVE_NOAPI(a < b ? -1 : (a > b ? 1 : 0))
+} /* end H5FD__http_cmp_haddr() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_find
+ *
+ * Purpose:     Looks for the block at ADDR in the block cache.
+ *
+ * Return:      The block's slot, or NULL if the block isn't cached.
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_http_blk_t *
+H5FD__http_find(const H5FD_http_t *file, haddr_t addr)
+{
+    H5FD_http_blk_t *ret_value = NULL;  /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(file->index)
+        ret_value = (H5FD_http_blk_t *)H5SL_search(file->index, &addr);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_find() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_touch
+ *
+ * Purpose:     Makes BLK the most recently used block in the cache.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__http_touch(H5FD_http_t *file, H5FD_http_blk_t *blk)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    if(file->head != blk) {
+        /* Unlink */
+        blk->prev->next = blk->next;
+        if(blk->next)
+            blk->next->prev = blk->prev;
+        else
+            file->tail = blk->prev;
+
+        /* Put at head */
+        blk->prev = NULL;
+        blk->next = file->head;
+        file->head->prev = blk;
+        file->head = blk;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__http_touch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_insert
+ *
+ * Purpose:     Caches LEN bytes of DATA as the block at ADDR, evicting the
+ *              least recently used block if the cache is full.  A block
+ *              already cached is only made the most recently used, since
+ *              the file doesn't change.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD__http_insert(H5FD_http_t *file, haddr_t addr, size_t len,
+    const unsigned char *data)
+{
+    H5FD_http_blk_t *blk;               /* Block's slot */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(file->nslots > 0);
+    HDassert(len <= file->fa.block_size);
+
+    if(NULL != (blk = H5FD__http_find(file, addr)))
+        H5FD__http_touch(file, blk);
+    else {
+        /* Evict the least recently used block if there's no free slot */
+        if(0 == file->nfree) {
+            blk = file->tail;
+            H5SL_remove(file->index, &blk->addr);
+            file->tail = blk->prev;
+            if(file->tail)
+                file->tail->next = NULL;
+            else
+                file->head = NULL;
+            file->free[file->nfree++] = (unsigned)(blk - file->blks);
+        } /* end if */
+
+        blk = &file->blks[file->free[--file->nfree]];
+        blk->addr = addr;
+        HDmemcpy(file->data + (size_t)(blk - file->blks) * file->fa.block_size, data, len);
+        if(H5SL_insert(file->index, blk, &blk->addr) < 0) {
+            /* (Only fails when out of memory: just don't cache the block) */
+            H5E_clear_stack(NULL);
+            file->free[file->nfree++] = (unsigned)(blk - file->blks);
+        } /* end if */
+        else {
+            blk->prev = NULL;
+            blk->next = file->head;
+            if(file->head)
+                file->head->prev = blk;
+            else
+                file->tail = blk;
+            file->head = blk;
+        } /* end else */
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD__http_insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__http_fetch
+ *
+ * Purpose:     Reads COUNT requests.  Requests larger than the block
+ *              cache are read straight into their buffers; the blocks of
+ *              the others that aren't cached are requested from the
+ *              server, those closer together than the largest gap merged
+ *              into one range, and copied out and cached.  The ranges are
+ *              spread over the connections, and requested concurrently
+ *              when there are worker threads.  Parts of requests past the
+ *              end of the file are filled with zeros.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__http_fetch(H5FD_http_t *file, size_t count, const haddr_t addrs[],
+    const size_t sizes[], void *bufs[])
+{
+    size_t      bs = file->fa.block_size;   /* Block size */
+    haddr_t     eof = file->eof;        /* End of file */
+    haddr_t     *missing = NULL;        /* Addresses of missing blocks */
+    size_t      nmissing = 0;           /* # of missing blocks */
+    size_t      max_missing = 0;        /* Size of missing block array */
+    H5FD_http_range_t *ranges = NULL;   /* Ranges to request */
+    size_t      nranges = 0;            /* # of ranges */
+    size_t      nblock_ranges = 0;      /* # of ranges of blocks */
+    size_t      max_ranges;             /* Size of range array */
+    unsigned char *range_buf = NULL;    /* Buffer for ranges of blocks */
+    size_t      range_buf_size = 0;     /* Size of range buffer */
+    haddr_t     gap_blocks;             /* Most missing blocks between blocks merged */
+    haddr_t     span;                   /* Blocks in all ranges */
+    haddr_t     per_conn;               /* Most blocks in one range */
+    hbool_t     submitted = FALSE;      /* Whether tasks were submitted */
+    unsigned    nconns;                 /* # of connections used */
+    size_t      r, i;                   /* Local index variables */
+    unsigned    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Find the blocks that aren't cached, and count the large requests'
+     * ranges */
+    max_ranges = 0;
+    for(r = 0; r < count; r++) {
+        haddr_t     end = addrs[r] + sizes[r];  /* End of request */
+        haddr_t     b;                          /* Block address */
+
+        if(0 == sizes[r] || addrs[r] >= eof)
+            continue;
+        if(sizes[r] > (size_t)file->nslots * bs) {
+            max_ranges += file->fa.nconns;
+            continue;
+        } /* end if */
+        for(b = (addrs[r] / bs) * bs; b < end && b < eof; b += bs)
+            if(NULL == H5FD__http_find(file, b)) {
+                if(nmissing == max_missing) {
+                    haddr_t *tmp;
+
+                    max_missing = MAX(2 * max_missing, 64);
+                    if(NULL == (tmp = (haddr_t *)H5MM_realloc(missing, max_missing * sizeof(haddr_t))))
+                        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate block list")
+                    missing = tmp;
+                } /* end if */
+                missing[nmissing++] = b;
+            } /* end if */
+    } /* end for */
+    if(nmissing > 0) {
+        HDqsort(missing, nmissing, sizeof(haddr_t), H5FD__http_cmp_haddr);
+        for(i = 1, r = 1; i < nmissing; i++)
+            if(missing[i] != missing[r - 1])
+                missing[r++] = missing[i];
+        nmissing = r;
+    } /* end if */
+    max_ranges += nmissing;
+    if(0 == max_ranges)
+        HGOTO_DONE(SUCCEED)
+    if(NULL == (ranges = (H5FD_http_range_t *)H5MM_calloc(max_ranges * sizeof(H5FD_http_range_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate range list")
+
+    /* Merge the missing blocks into ranges: first find how many blocks
+     * the ranges cover, gaps included, then cut them so that each
+     * connection gets about the same number of blocks
+     */
+    gap_blocks = file->fa.max_gap / bs;
+    span = 0;
+    for(i = 0; i < nmissing; i++)
+        if(i > 0 && (missing[i] - missing[i - 1]) / bs - 1 <= gap_blocks)
+            span += (missing[i] - missing[i - 1]) / bs;
+        else
+            span++;
+    per_conn = (span + file->fa.nconns - 1) / file->fa.nconns;
+    for(i = 0; i < nmissing; i++) {
+        H5FD_http_range_t *range = nranges ? &ranges[nranges - 1] : NULL;
+
+        if(range && (missing[i] - range->addr) / bs < per_conn
+                && (missing[i] - (range->addr + range->len)) / bs <= gap_blocks)
+            range->len = (size_t)(missing[i] + bs - range->addr);
+        else {
+            range = &ranges[nranges++];
+            range->addr = missing[i];
+            range->len = bs;
+        } /* end else */
+    } /* end for */
+    nblock_ranges = nranges;
+
+    /* Cut the last range of blocks short at the end of the file, and make
+     * room for all the ranges of blocks */
+    for(i = 0; i < nblock_ranges; i++) {
+        if(ranges[i].addr + ranges[i].len > eof)
+            ranges[i].len = (size_t)(eof - ranges[i].addr);
+        range_buf_size += ranges[i].len;
+    } /* end for */
+    if(range_buf_size > 0 && NULL == (range_buf = (unsigned char *)H5MM_malloc(range_buf_size)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate range buffer")
+    for(i = 0, r = 0; i < nblock_ranges; i++) {
+        ranges[i].buf = range_buf + r;
+        r += ranges[i].len;
+    } /* end for */
+
+    /* Large requests are cut into a range for each connection */
+    for(r = 0; r < count; r++) {
+        size_t      len;                /* Bytes of request in the file */
+        size_t      piece;              /* Bytes of request per range */
+        size_t      off;                /* Offset of range in request */
+
+        if(0 == sizes[r] || addrs[r] >= eof || sizes[r] <= (size_t)file->nslots * bs)
+            continue;
+        len = (size_t)(MIN(addrs[r] + sizes[r], eof) - addrs[r]);
+        piece = (len + file->fa.nconns - 1) / file->fa.nconns;
+        for(off = 0; off < len; off += piece) {
+            H5FD_http_range_t *range = &ranges[nranges++];
+
+            range->addr = addrs[r] + off;
+            range->len = MIN(piece, len - off);
+            range->buf = (unsigned char *)bufs[r] + off;
+        } /* end for */
+    } /* end for */
+
+    /* Spread the ranges over the connections, and request them */
+    nconns = (unsigned)MIN(nranges, file->fa.nconns);
+    for(i = 0; i < nranges; i++)
+        ranges[i].conn = (unsigned)(i % nconns);
+    for(u = 0; u < nconns; u++) {
+        H5FD_http_conn_t *conn = &file->conns[u];
+
+        conn->nranges = nranges;
+        conn->ranges = ranges;
+        conn->err = 0;
+        conn->status = 0;
+        if(file->tp && nconns > 1) {
+            if(H5TP_submit(file->tp, &conn->task, H5FD__http_conn_cb, conn) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to submit HTTP requests")
+            submitted = TRUE;
+        } /* end if */
+        else if(H5FD__http_conn_cb(conn) < 0)
+            break;
+    } /* end for */
+
+done:
+    /* Wait for the tasks that were submitted, even after an error, since
+     * they use the caller's buffers
+     */
+    if(submitted && H5TP_wait(file->tp) < 0)
+        HDONE_ERROR(H5E_VFL, H5E_CANTWAIT, FAIL, "unable to wait for HTTP requests")
+
+    /* Report the first failure */
+    if(ranges && ret_value >= 0)
+        for(u = 0; u < MIN(nranges, file->fa.nconns); u++) {
+            const H5FD_http_conn_t *conn = &file->conns[u];
+
+            if(conn->err) {
+                HDONE_ERROR(H5E_IO, H5E_READERROR, FAIL, "HTTP request failed: url = '%s', errno = %d, error message = '%s'", file->url, conn->err, HDstrerror(conn->err))
+                break;
+            } /* end if */
+            if(conn->status) {
+                HDONE_ERROR(H5E_IO, H5E_READERROR, FAIL, "HTTP request failed: url = '%s', HTTP status = %d", file->url, conn->status)
+                break;
+            } /* end if */
+        } /* end for */
+
+    if(ret_value >= 0) {
+        /* Copy out the parts of the requests in blocks, from the ranges
+         * just requested or the cache, and zero the parts past the end
+         * of the file
+         */
+        for(r = 0; r < count; r++) {
+            unsigned char *buf = (unsigned char *)bufs[r];  /* Request buffer */
+            haddr_t     addr = addrs[r];                    /* Request address */
+            haddr_t     end = addr + sizes[r];              /* End of request */
+            haddr_t     b;                                  /* Block address */
+
+            if(0 == sizes[r])
+                continue;
+            if(end > eof)
+                HDmemset(buf + (MAX(addr, eof) - addr), 0, (size_t)(end - MAX(addr, eof)));
+            if(addr >= eof || sizes[r] > (size_t)file->nslots * bs)
+                continue;
+            for(b = (addr / bs) * bs; b < end && b < eof; b += bs) {
+                haddr_t     lo = MAX(addr, b);              /* Start of piece */
+                haddr_t     hi = MIN(MIN(end, b + bs), eof);    /* End of piece */
+                const unsigned char *src = NULL;            /* Block contents */
+                size_t      lo_i = 0, hi_i = nblock_ranges; /* Binary search bounds */
+
+                /* Look in the ranges of blocks */
+                while(lo_i < hi_i) {
+                    size_t mid = (lo_i + hi_i) / 2;
+
+                    if(b < ranges[mid].addr)
+                        hi_i = mid;
+                    else if(b >= ranges[mid].addr + ranges[mid].len)
+                        lo_i = mid + 1;
+                    else {
+                        src = ranges[mid].buf + (b - ranges[mid].addr);
+                        break;
+                    } /* end else */
+                } /* end while */
+
+                /* Otherwise it's in the cache */
+                if(NULL == src) {
+                    H5FD_http_blk_t *blk = H5FD__http_find(file, b);
+
+                    HDassert(blk);
+                    H5FD__http_touch(file, blk);
+                    src = file->data + (size_t)(blk - file->blks) * bs;
+                } /* end if */
+
+                HDmemcpy(buf + (lo - addr), src + (lo - b), (size_t)(hi - lo));
+            } /* end for */
+        } /* end for */
+
+        /* Cache the blocks requested */
+        if(file->nslots > 0)
+            for(i = 0; i < nblock_ranges; i++) {
+                size_t off;                 /* Offset of block in range */
+
+                for(off = 0; off < ranges[i].len; off += bs)
+                    H5FD__http_insert(file, ranges[i].addr + off, MIN(bs, ranges[i].len - off), ranges[i].buf + off);
+            } /* end for */
+    } /* end if */
+
+    H5MM_xfree(missing);
+    H5MM_xfree(ranges);
+    H5MM_xfree(range_buf);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__http_fetch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_read
+ *
+ * Purpose:     Reads SIZE bytes of data from FILE beginning at address ADDR
+ *              into buffer BUF.
+ *
+ * Return:      Success:    SUCCEED. Result is stored in caller-supplied
+ *                          buffer BUF.
+ *              Failure:    FAIL, Contents of buffer BUF are undefined.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id,
+    haddr_t addr, size_t size, void *buf /*out*/)
+{
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(buf);
+
+    /* Check for overflow conditions */
+    if(!H5F_addr_defined(addr))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addr)
+    if(REGION_OVERFLOW(addr, size))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addr, (unsigned long long)size)
+
+    if(H5FD__http_fetch((H5FD_http_t *)_file, (size_t)1, &addr, &size, &buf) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_read() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_write
+ *
+ * Purpose:     Fails: the driver is read-only.
+ *
+ * Return:      FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_write(H5FD_t H5_ATTR_UNUSED *_file, H5FD_mem_t H5_ATTR_UNUSED type,
+    hid_t H5_ATTR_UNUSED dxpl_id, haddr_t H5_ATTR_UNUSED addr,
+    size_t H5_ATTR_UNUSED size, const void H5_ATTR_UNUSED *buf)
+{
+    herr_t      ret_value = FAIL;           /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "the HTTP driver is read-only")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_write() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_http_read_vector
+ *
+ * Purpose:     Performs COUNT reads from FILE, with the blocks missing for
+ *              all of them requested together.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_http_read_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], void *bufs[])
+{
+    size_t      r;                          /* Local index variable */
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Check for overflow conditions */
+    for(r = 0; r < count; r++) {
+        if(!H5F_addr_defined(addrs[r]))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addrs[r])
+        if(REGION_OVERFLOW(addrs[r], sizes[r]))
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addrs[r], (unsigned long long)sizes[r])
+    } /* end for */
+
+    if(H5FD__http_fetch((H5FD_http_t *)_file, count, addrs, sizes, bufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file vector read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_http_read_vector() */
+
+#endif /* defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) */
+
@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The public header file for the read-only HTTP driver, which
+ *              reads a file from a web server or object store with HTTP
+ *              range requests.
+ */
+#ifndef H5FDhttp_H
+#define H5FDhttp_H
+
+#if defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H)
+#       define H5FD_HTTP	(H5FD_http_init())
+#else
+#       define H5FD_HTTP        (-1)
+#endif /* defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) */
+
+#if defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H)
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Defaults for the size of the blocks cached and requested, the size of
+ * the block cache, the largest gap between blocks requested together and
+ * the number of connections to the server, and the most connections.
+ * Application can set them through the function H5Pset_fapl_http.
+ */
+#define H5FD_HTTP_BLOCK_SIZE_DEF        (64 * 1024)
+#define H5FD_HTTP_CACHE_SIZE_DEF        (16 * 1024 * 1024)
+#define H5FD_HTTP_MAX_GAP_DEF           (256 * 1024)
+#define H5FD_HTTP_NCONNS_DEF            4
+#define H5FD_HTTP_MAX_CONNS             64
+
+H5_DLL hid_t H5FD_http_init(void);
+H5_DLL herr_t H5Pset_fapl_http(hid_t fapl_id, size_t block_size,
+			size_t cache_size, size_t max_gap, unsigned nconns);
+H5_DLL herr_t H5Pget_fapl_http(hid_t fapl_id, size_t *block_size/*out*/,
+			size_t *cache_size/*out*/, size_t *max_gap/*out*/,
+			unsigned *nconns/*out*/);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) */
+
+#endif
+
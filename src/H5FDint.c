@@ -38,6 +38,7 @@
 #include "H5Fprivate.h"         /* File access				*/
 #include "H5FDpkg.h"		/* File Drivers				*/
 #include "H5Iprivate.h"		/* IDs			  		*/
+#include "H5MMprivate.h"        /* Memory management                    */
 
 
 /****************/
@@ -58,6 +59,9 @@
 /********************/
 /* Local Prototypes */
 /********************/
+static herr_t H5FD__vector_addrs(const H5FD_t *file, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    hbool_t check_eoa, haddr_t **abs_addrs);
 
 
 /*********************/
@@ -261,6 +265,177 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FD_write() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__vector_addrs
+ *
+ * Purpose:     Checks the requests in a vector I/O operation against the
+ *              file's EOA (if CHECK_EOA is set) and converts their relative
+ *              addresses to absolute ones.
+ *
+ *              *ABS_ADDRS is set to NULL when the file has no base address,
+ *              since the addresses are already absolute.  Otherwise it is
+ *              set to a new array, which the caller must free.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__vector_addrs(const H5FD_t *file, size_t count, const H5FD_mem_t types[],
+    const haddr_t addrs[], const size_t sizes[], hbool_t check_eoa,
+    haddr_t **abs_addrs)
+{
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity checks */
+    HDassert(file && file->cls);
+    HDassert(abs_addrs);
+
+    *abs_addrs = NULL;
+
+    if(check_eoa)
+        for(u = 0; u < count; u++) {
+            haddr_t     eoa;            /* EOA for request's memory type */
+
+            if(HADDR_UNDEF == (eoa = (file->cls->get_eoa)(file, types[u])))
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "driver get_eoa request failed")
+            if((addrs[u] + file->base_addr + sizes[u]) > eoa)
+                HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu, eoa = %llu", (unsigned long long)(addrs[u] + file->base_addr), (unsigned long long)sizes[u], (unsigned long long)eoa)
+        } /* end for */
+
+    if(file->base_addr > 0) {
+        if(NULL == (*abs_addrs = (haddr_t *)H5MM_malloc(count * sizeof(haddr_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "can't allocate address array")
+        for(u = 0; u < count; u++)
+            (*abs_addrs)[u] = addrs[u] + file->base_addr;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__vector_addrs() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_read_vector
+ *
+ * Purpose:     Private version of H5FDread_vector()
+ *
+ *              Drivers without a 'read_vector' callback have the requests
+ *              dispatched to their 'read' callback one at a time.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_read_vector(H5FD_t *file, size_t count, const H5FD_mem_t types[],
+    const haddr_t addrs[], const size_t sizes[], void *bufs[]/*out*/)
+{
+    hid_t       dxpl_id;                /* DXPL for operation */
+    haddr_t     *abs_addrs = NULL;      /* Absolute addresses, if different */
+    const haddr_t *io_addrs;            /* Addresses passed to driver */
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(file && file->cls);
+    HDassert(0 == count || (types && addrs && sizes && bufs));
+
+    /* Get proper DXPL for I/O */
+    dxpl_id = H5CX_get_dxpl();
+
+    /* The no-op case */
+    if(0 == count)
+        HGOTO_DONE(SUCCEED)
+
+    /* Check the requests and get their absolute addresses.  (As with
+     * H5FD_read, SWMR readers may read past the EOA.)
+     */
+    if(H5FD__vector_addrs(file, count, types, addrs, sizes, !(file->access_flags & H5F_ACC_SWMR_READ), &abs_addrs) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "invalid vector I/O request")
+    io_addrs = abs_addrs ? abs_addrs : addrs;
+
+    /* Dispatch to driver */
+    if(file->cls->read_vector) {
+        if((file->cls->read_vector)(file, dxpl_id, count, types, io_addrs, sizes, bufs) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "driver vector read request failed")
+    } /* end if */
+    else
+        for(u = 0; u < count; u++)
+            if((file->cls->read)(file, types[u], dxpl_id, io_addrs[u], sizes[u], bufs[u]) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_READERROR, FAIL, "driver read request failed")
+
+done:
+    if(abs_addrs)
+        abs_addrs = (haddr_t *)H5MM_xfree(abs_addrs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_write_vector
+ *
+ * Purpose:     Private version of H5FDwrite_vector()
+ *
+ *              Drivers without a 'write_vector' callback have the requests
+ *              dispatched to their 'write' callback one at a time.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FD_write_vector(H5FD_t *file, size_t count, const H5FD_mem_t types[],
+    const haddr_t addrs[], const size_t sizes[], const void *bufs[])
+{
+    hid_t       dxpl_id;                /* DXPL for operation */
+    haddr_t     *abs_addrs = NULL;      /* Absolute addresses, if different */
+    const haddr_t *io_addrs;            /* Addresses passed to driver */
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(file && file->cls);
+    HDassert(0 == count || (types && addrs && sizes && bufs));
+
+    /* Get proper DXPL for I/O */
+    dxpl_id = H5CX_get_dxpl();
+
+    /* The no-op case */
+    if(0 == count)
+        HGOTO_DONE(SUCCEED)
+
+    /* Check the requests and get their absolute addresses */
+    if(H5FD__vector_addrs(file, count, types, addrs, sizes, TRUE, &abs_addrs) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_BADVALUE, FAIL, "invalid vector I/O request")
+    io_addrs = abs_addrs ? abs_addrs : addrs;
+
+    /* Dispatch to driver */
+    if(file->cls->write_vector) {
+        if((file->cls->write_vector)(file, dxpl_id, count, types, io_addrs, sizes, bufs) < 0)
+            HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "driver vector write request failed")
+    } /* end if */
+    else
+        for(u = 0; u < count; u++)
+            if((file->cls->write)(file, types[u], dxpl_id, io_addrs[u], sizes[u], bufs[u]) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_WRITEERROR, FAIL, "driver write request failed")
+
+done:
+    if(abs_addrs)
+        abs_addrs = (haddr_t *)H5MM_xfree(abs_addrs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_write_vector() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5FD_set_eoa
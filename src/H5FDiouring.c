@@ -0,0 +1,1397 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: A POSIX file driver for Linux that keeps many requests in flight
+ *          at once with io_uring.  Vector reads and writes queue every
+ *          request in the vector on the file's submission ring (up to the
+ *          queue depth at a time) and wait for all of them to complete
+ *          before returning, so fast devices see a deep queue instead of
+ *          one request at a time.  Single reads and writes gain nothing
+ *          from the ring and use pread() and pwrite().
+ *
+ *          Requests that fit can optionally go through buffers registered
+ *          with the kernel, which saves mapping the caller's pages for
+ *          each request at the cost of a copy.
+ *
+ *          Where the kernel doesn't support io_uring (or it's disabled),
+ *          files are opened without a ring and vector requests are done
+ *          one at a time with pread() and pwrite().
+ */
+
+#include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
+
+
+#include "H5private.h"      /* Generic Functions        */
+#include "H5Eprivate.h"     /* Error handling           */
+#include "H5Fprivate.h"     /* File access              */
+#include "H5FDprivate.h"    /* File drivers             */
+#include "H5FDiouring.h"    /* io_uring file driver     */
+#include "H5FLprivate.h"    /* Free Lists               */
+#include "H5Iprivate.h"     /* IDs                      */
+#include "H5MMprivate.h"    /* Memory management        */
+#include "H5Pprivate.h"     /* Property lists           */
+
+#ifdef H5_HAVE_LINUX_IO_URING_H
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+/* The ring is set up with the io_uring system calls directly.  It needs
+ * their numbers from the system headers, and mmap() to share the ring with
+ * the kernel; without them, every file is opened without a ring.
+ */
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+        defined(__NR_io_uring_register) && defined(H5_HAVE_MMAP)
+#define H5FD_IOURING_HAVE_RING
+#endif
+
+/* The driver identification number, initialized at runtime */
+static hid_t H5FD_IOURING_g = 0;
+
+/* Driver-specific file access properties */
+typedef struct H5FD_iouring_fapl_t {
+    unsigned    queue_depth;    /* Submission queue entries          */
+    size_t      reg_buf_size;   /* Total size of registered buffers  */
+} H5FD_iouring_fapl_t;
+
+/* An operation in flight on the ring.  There's one per submission queue
+ * entry, and, when buffers are registered, a slot of the registered
+ * buffers for each one.
+ */
+typedef struct H5FD_iouring_op_t {
+    size_t          req;        /* index of request in vector       */
+    size_t          len;        /* # of bytes submitted             */
+    hbool_t         fixed;      /* whether the registered slot is used */
+    struct iovec    iov;        /* buffer, when the slot isn't used */
+} H5FD_iouring_op_t;
+
+/* The description of a file belonging to this driver.  The 'eoa' and 'eof'
+ * determine the amount of hdf5 address space in use and the high-water mark
+ * of the file (the current size of the underlying filesystem file).
+ *
+ * When 'ring_fd' isn't negative, the file has a submission ring of
+ * 'entries' entries, and its submission queue, completion queue and
+ * submission queue entries are mapped from the kernel.  The ring's
+ * operations are in 'ops'; 'free_ops' is a stack of the 'nfree' operations
+ * not in flight.  When 'slot_size' isn't zero, operation 'u' uses bytes
+ * [u * slot_size, (u + 1) * slot_size) of the registered buffer 'reg_buf'.
+ */
+typedef struct H5FD_iouring_t {
+    H5FD_t          pub;    /* public stuff, must be first      */
+    int             fd;     /* the filesystem file descriptor   */
+    haddr_t         eoa;    /* end of allocated region          */
+    haddr_t         eof;    /* end of file; current file size   */
+    H5FD_iouring_fapl_t fa; /* driver-specific file access properties */
+    char            filename[H5FD_MAX_FILENAME_LEN];    /* Copy of file name from open operation */
+
+    /* On most systems the combination of device and i-node number uniquely
+     * identify a file.
+     */
+    dev_t           device;     /* file device number   */
+    ino_t           inode;      /* file i-node number   */
+
+    /* Submission ring */
+    int             ring_fd;    /* io_uring file descriptor, or -1  */
+    unsigned        entries;    /* # of submission queue entries    */
+    void            *sq_ring;   /* mapped submission queue          */
+    size_t          sq_ring_size;
+    void            *cq_ring;   /* mapped completion queue          */
+    size_t          cq_ring_size;
+    struct io_uring_sqe *sqes;  /* mapped submission queue entries  */
+    size_t          sqes_size;
+    unsigned        *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned        *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+    H5FD_iouring_op_t *ops;     /* operations, one per entry        */
+    unsigned        *free_ops;  /* stack of operations not in flight */
+    unsigned        nfree;      /* # of operations not in flight    */
+    unsigned char   *reg_buf;   /* registered buffers               */
+    size_t          slot_size;  /* size of each operation's slot    */
+} H5FD_iouring_t;
+
+/*
+ * These macros check for overflow of various quantities.  These macros
+ * assume that HDoff_t is signed and haddr_t and size_t are unsigned.
+ *
+ * ADDR_OVERFLOW:   Checks whether a file address of type `haddr_t'
+ *                  is too large to be represented by the second argument
+ *                  of the file seek function.
+ *
+ * SIZE_OVERFLOW:   Checks whether a buffer size of type `hsize_t' is too
+ *                  large to be represented by the `size_t' type.
+ *
+ * REGION_OVERFLOW: Checks whether an address and size pair describe data
+ *                  which can be addressed entirely by the second
+ *                  argument of the file seek function.
+ */
+#define MAXADDR (((haddr_t)1<<(8*sizeof(HDoff_t)-1))-1)
+#define ADDR_OVERFLOW(A)    (HADDR_UNDEF==(A) || ((A) & ~(haddr_t)MAXADDR))
+#define SIZE_OVERFLOW(Z)    ((Z) & ~(hsize_t)MAXADDR)
+#define REGION_OVERFLOW(A,Z)    (ADDR_OVERFLOW(A) || SIZE_OVERFLOW(Z) ||    \
+                                 HADDR_UNDEF==(A)+(Z) ||                    \
+                                (HDoff_t)((A)+(Z))<(HDoff_t)(A))
+
+/* Largest single operation submitted to the ring (the length field is 32
+ * bits); larger requests are submitted in pieces.
+ */
+#define H5FD_IOURING_MAX_IO     ((size_t)1 << 30)
+
+/* Alignment of the registered buffers */
+#define H5FD_IOURING_REG_ALIGN  4096
+
+/* The head and tail indices of the rings are shared with the kernel */
+#define H5FD_IOURING_LOAD_ACQUIRE(P)        __atomic_load_n(P, __ATOMIC_ACQUIRE)
+#define H5FD_IOURING_STORE_RELEASE(P, V)    __atomic_store_n(P, V, __ATOMIC_RELEASE)
+
+/* Prototypes */
+static herr_t H5FD_iouring_term(void);
+static void *H5FD_iouring_fapl_get(H5FD_t *file);
+static void *H5FD_iouring_fapl_copy(const void *_old_fa);
+static H5FD_t *H5FD_iouring_open(const char *name, unsigned flags, hid_t fapl_id,
+            haddr_t maxaddr);
+static herr_t H5FD_iouring_close(H5FD_t *_file);
+static int H5FD_iouring_cmp(const H5FD_t *_f1, const H5FD_t *_f2);
+static herr_t H5FD_iouring_query(const H5FD_t *_f1, unsigned long *flags);
+static haddr_t H5FD_iouring_get_eoa(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t H5FD_iouring_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr);
+static haddr_t H5FD_iouring_get_eof(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD_iouring_get_handle(H5FD_t *_file, hid_t fapl, void** file_handle);
+static herr_t H5FD_iouring_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, void *buf);
+static herr_t H5FD_iouring_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, const void *buf);
+static herr_t H5FD_iouring_read_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *bufs[]);
+static herr_t H5FD_iouring_write_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    const void *bufs[]);
+static herr_t H5FD_iouring_vector_io(H5FD_iouring_t *file, size_t count,
+    const haddr_t addrs[], const size_t sizes[], void *rbufs[],
+    const void *wbufs[]);
+#ifdef H5FD_IOURING_HAVE_RING
+static herr_t H5FD_iouring_ring_init(H5FD_iouring_t *file);
+static void H5FD_iouring_ring_term(H5FD_iouring_t *file);
+#endif /* H5FD_IOURING_HAVE_RING */
+static herr_t H5FD_iouring_truncate(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
+static herr_t H5FD_iouring_lock(H5FD_t *_file, hbool_t rw);
+static herr_t H5FD_iouring_unlock(H5FD_t *_file);
+
+static const H5FD_class_t H5FD_iouring_g = {
+    "iouring",                  /* name                 */
+    MAXADDR,                    /* maxaddr              */
+    H5F_CLOSE_WEAK,             /* fc_degree            */
+    H5FD_iouring_term,          /* terminate            */
+    NULL,                       /* sb_size              */
+    NULL,                       /* sb_encode            */
+    NULL,                       /* sb_decode            */
+    sizeof(H5FD_iouring_fapl_t), /* fapl_size           */
+    H5FD_iouring_fapl_get,      /* fapl_get             */
+    H5FD_iouring_fapl_copy,     /* fapl_copy            */
+    NULL,                       /* fapl_free            */
+    0,                          /* dxpl_size            */
+    NULL,                       /* dxpl_copy            */
+    NULL,                       /* dxpl_free            */
+    H5FD_iouring_open,          /* open                 */
+    H5FD_iouring_close,         /* close                */
+    H5FD_iouring_cmp,           /* cmp                  */
+    H5FD_iouring_query,         /* query                */
+    NULL,                       /* get_type_map         */
+    NULL,                       /* alloc                */
+    NULL,                       /* free                 */
+    H5FD_iouring_get_eoa,       /* get_eoa              */
+    H5FD_iouring_set_eoa,       /* set_eoa              */
+    H5FD_iouring_get_eof,       /* get_eof              */
+    H5FD_iouring_get_handle,    /* get_handle           */
+    H5FD_iouring_read,          /* read                 */
+    H5FD_iouring_write,         /* write                */
+    H5FD_iouring_read_vector,   /* read_vector          */
+    H5FD_iouring_write_vector,  /* write_vector         */
+    NULL,                       /* flush                */
+    H5FD_iouring_truncate,      /* truncate             */
+    H5FD_iouring_lock,          /* lock                 */
+    H5FD_iouring_unlock,        /* unlock               */
+    H5FD_FLMAP_DICHOTOMY        /* fl_map               */
+};
+
+/* Declare a free list to manage the H5FD_iouring_t struct */
+H5FL_DEFINE_STATIC(H5FD_iouring_t);
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__init_package
+ *
+ * Purpose:     Initializes any interface-specific data or routines.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__init_package(void)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_STATIC
+
+    if(H5FD_iouring_init() < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to initialize io_uring VFD")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5FD__init_package() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_init
+ *
+ * Purpose:     Initialize this driver by registering the driver with the
+ *              library.
+ *
+ * Return:      Success:    The driver ID for the io_uring driver.
+ *              Failure:    Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5FD_iouring_init(void)
+{
+    hid_t ret_value = H5I_INVALID_HID;          /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    if(H5I_VFL != H5I_get_type(H5FD_IOURING_g))
+        H5FD_IOURING_g = H5FD_register(&H5FD_iouring_g, sizeof(H5FD_class_t), FALSE);
+
+    /* Set return value */
+    ret_value = H5FD_IOURING_g;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_init() */
+
+
+/*---------------------------------------------------------------------------
+ * Function:    H5FD_iouring_term
+ *
+ * Purpose:     Shut down the VFD
+ *
+ * Returns:     SUCCEED (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_term(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Reset VFL ID */
+    H5FD_IOURING_g = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_iouring_term() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_iouring
+ *
+ * Purpose:     Modify the file access property list to use the H5FD_IOURING
+ *              driver defined in this source file.  QUEUE_DEPTH is the
+ *              number of requests each file keeps in flight (zero for the
+ *              default).  If REG_BUF_SIZE isn't zero, that many bytes of
+ *              buffers are registered with the kernel for each file and
+ *              divided between the queue entries; requests that fit in an
+ *              entry's part are copied through it.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_iouring(hid_t fapl_id, unsigned queue_depth, size_t reg_buf_size)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    H5FD_iouring_fapl_t fa;     /* Driver properties */
+    herr_t ret_value;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "iIuz", fapl_id, queue_depth, reg_buf_size);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(queue_depth > H5FD_IOURING_QUEUE_DEPTH_MAX)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "queue depth too large")
+
+    HDmemset(&fa, 0, sizeof(fa));
+    fa.queue_depth = queue_depth ? queue_depth : H5FD_IOURING_QUEUE_DEPTH_DEF;
+    fa.reg_buf_size = reg_buf_size;
+
+    ret_value = H5P_set_driver(plist, H5FD_IOURING, &fa);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_iouring() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_fapl_iouring
+ *
+ * Purpose:     Returns information about the io_uring file access property
+ *              list though the function arguments.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_fapl_iouring(hid_t fapl_id, unsigned *queue_depth/*out*/,
+    size_t *reg_buf_size/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    const H5FD_iouring_fapl_t *fa;  /* Driver properties */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "ixx", fapl_id, queue_depth, reg_buf_size);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(H5FD_IOURING != H5P_peek_driver(plist))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "incorrect VFL driver")
+    if(NULL == (fa = (const H5FD_iouring_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "bad VFL driver info")
+
+    if(queue_depth)
+        *queue_depth = fa->queue_depth;
+    if(reg_buf_size)
+        *reg_buf_size = fa->reg_buf_size;
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_fapl_iouring() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_fapl_get
+ *
+ * Purpose:     Returns a file access property list which indicates how the
+ *              specified file is being accessed. The return list could be
+ *              used to access another file the same way.
+ *
+ * Return:      Success:    Ptr to new file access property list with all
+ *                          members copied from the file struct.
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_iouring_fapl_get(H5FD_t *_file)
+{
+    H5FD_iouring_t  *file = (H5FD_iouring_t *)_file;
+    void *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Set return value */
+    ret_value = H5FD_iouring_fapl_copy(&(file->fa));
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_fapl_get() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_fapl_copy
+ *
+ * Purpose:     Copies the io_uring-specific file access properties.
+ *
+ * Return:      Success:    Ptr to a new property list
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_iouring_fapl_copy(const void *_old_fa)
+{
+    const H5FD_iouring_fapl_t *old_fa = (const H5FD_iouring_fapl_t *)_old_fa;
+    H5FD_iouring_fapl_t *new_fa = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(NULL != (new_fa = (H5FD_iouring_fapl_t *)H5MM_malloc(sizeof(H5FD_iouring_fapl_t))))
+        *new_fa = *old_fa;
+
+    FUNC_LEAVE_NOAPI(new_fa)
+} /* end H5FD_iouring_fapl_copy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_open
+ *
+ * Purpose:     Create and/or opens a file as an HDF5 file, and sets up
+ *              its submission ring if the kernel supports io_uring.
+ *
+ * Return:      Success:    A pointer to a new file data structure. The
+ *                          public fields will be initialized by the
+ *                          caller, which is always H5FD_open().
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+H5FD_iouring_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
+{
+    H5FD_iouring_t  *file       = NULL;     /* io_uring VFD info        */
+    int             fd          = -1;       /* File descriptor          */
+    int             o_flags;                /* Flags for open() call    */
+    H5P_genplist_t  *plist;                 /* Property list pointer    */
+    const H5FD_iouring_fapl_t *fa;          /* Driver properties        */
+    H5FD_iouring_fapl_t default_fa;         /* Default driver properties */
+    h5_stat_t       sb;
+    H5FD_t          *ret_value = NULL;          /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Sanity check on file offsets */
+    HDcompile_assert(sizeof(HDoff_t) >= sizeof(size_t));
+
+    /* Check arguments */
+    if(!name || !*name)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "invalid file name")
+    if(0 == maxaddr || HADDR_UNDEF == maxaddr)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADRANGE, NULL, "bogus maxaddr")
+    if(ADDR_OVERFLOW(maxaddr))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, NULL, "bogus maxaddr")
+
+    /* Get the driver specific information */
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_VFL, H5E_BADTYPE, NULL, "not a file access property list")
+    if(NULL == (fa = (const H5FD_iouring_fapl_t *)H5P_peek_driver_info(plist))) {
+        default_fa.queue_depth = H5FD_IOURING_QUEUE_DEPTH_DEF;
+        default_fa.reg_buf_size = 0;
+        fa = &default_fa;
+    } /* end if */
+
+    /* Build the open flags */
+    o_flags = (H5F_ACC_RDWR & flags) ? O_RDWR : O_RDONLY;
+    if(H5F_ACC_TRUNC & flags)
+        o_flags |= O_TRUNC;
+    if(H5F_ACC_CREAT & flags)
+        o_flags |= O_CREAT;
+    if(H5F_ACC_EXCL & flags)
+        o_flags |= O_EXCL;
+
+    /* Open the file */
+    if((fd = HDopen(name, o_flags, H5_POSIX_CREATE_MODE_RW)) < 0) {
+        int myerrno = errno;
+        HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to open file: name = '%s', errno = %d, error message = '%s', flags = %x, o_flags = %x", name, myerrno, HDstrerror(myerrno), flags, (unsigned)o_flags);
+    } /* end if */
+
+    if(HDfstat(fd, &sb) < 0)
+        HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, NULL, "unable to fstat file")
+
+    /* Create the new file struct */
+    if(NULL == (file = H5FL_CALLOC(H5FD_iouring_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to allocate file struct")
+
+    file->fd = fd;
+    H5_CHECKED_ASSIGN(file->eof, haddr_t, sb.st_size, h5_stat_size_t);
+    file->fa = *fa;
+    file->device = sb.st_dev;
+    file->inode = sb.st_ino;
+    file->ring_fd = -1;
+
+    /* Retain a copy of the name used to open the file, for possible error reporting */
+    HDstrncpy(file->filename, name, sizeof(file->filename));
+    file->filename[sizeof(file->filename) - 1] = '\0';
+
+#ifdef H5FD_IOURING_HAVE_RING
+    /* Set up the submission ring */
+    if(H5FD_iouring_ring_init(file) < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, NULL, "unable to set up submission ring")
+#endif /* H5FD_IOURING_HAVE_RING */
+
+    /* Set return value */
+    ret_value = (H5FD_t*)file;
+
+done:
+    if(NULL == ret_value) {
+        if(fd >= 0)
+            HDclose(fd);
+        if(file) {
+#ifdef H5FD_IOURING_HAVE_RING
+            H5FD_iouring_ring_term(file);
+#endif /* H5FD_IOURING_HAVE_RING */
+            file = H5FL_FREE(H5FD_iouring_t, file);
+        } /* end if */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_open() */
+
+#ifdef H5FD_IOURING_HAVE_RING
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_ring_init
+ *
+ * Purpose:     Sets up FILE's submission ring, with the queue depth and
+ *              registered buffers from its properties.  If the kernel
+ *              refuses to set up a ring, the file is left without one; if
+ *              it refuses to register the buffers, the ring doesn't use
+ *              them.  Neither is an error.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_ring_init(H5FD_iouring_t *file)
+{
+    struct io_uring_params  params;         /* Ring setup parameters */
+    unsigned char   *sq_ptr;                /* Mapped submission queue */
+    unsigned char   *cq_ptr;                /* Mapped completion queue */
+    void            *sqes;                  /* Mapped queue entries */
+    unsigned        u;                      /* Local index variable */
+    herr_t          ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->ring_fd < 0);
+
+    /* Create the ring, if io_uring is available */
+    HDmemset(&params, 0, sizeof(params));
+    if((file->ring_fd = (int)syscall(__NR_io_uring_setup, file->fa.queue_depth, &params)) < 0) {
+        file->ring_fd = -1;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+    /* Map the queues and the submission queue entries */
+    file->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    file->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+        file->sq_ring_size = file->cq_ring_size = MAX(file->sq_ring_size, file->cq_ring_size);
+    if(MAP_FAILED == (sq_ptr = (unsigned char *)HDmmap(NULL, file->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file->ring_fd, (HDoff_t)IORING_OFF_SQ_RING))) {
+        H5FD_iouring_ring_term(file);
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+    file->sq_ring = sq_ptr;
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+        cq_ptr = sq_ptr;
+    else {
+        if(MAP_FAILED == (cq_ptr = (unsigned char *)HDmmap(NULL, file->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file->ring_fd, (HDoff_t)IORING_OFF_CQ_RING))) {
+            H5FD_iouring_ring_term(file);
+            HGOTO_DONE(SUCCEED)
+        } /* end if */
+        file->cq_ring = cq_ptr;
+    } /* end else */
+    file->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    if(MAP_FAILED == (sqes = HDmmap(NULL, file->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file->ring_fd, (HDoff_t)IORING_OFF_SQES))) {
+        H5FD_iouring_ring_term(file);
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+    file->sqes = (struct io_uring_sqe *)sqes;
+
+    file->sq_head = (unsigned *)(sq_ptr + params.sq_off.head);
+    file->sq_tail = (unsigned *)(sq_ptr + params.sq_off.tail);
+    file->sq_mask = (unsigned *)(sq_ptr + params.sq_off.ring_mask);
+    file->sq_array = (unsigned *)(sq_ptr + params.sq_off.array);
+    file->cq_head = (unsigned *)(cq_ptr + params.cq_off.head);
+    file->cq_tail = (unsigned *)(cq_ptr + params.cq_off.tail);
+    file->cq_mask = (unsigned *)(cq_ptr + params.cq_off.ring_mask);
+    file->cqes = (struct io_uring_cqe *)(cq_ptr + params.cq_off.cqes);
+    file->entries = params.sq_entries;
+
+    /* Set up the operations */
+    if(NULL == (file->ops = (H5FD_iouring_op_t *)H5MM_calloc(file->entries * sizeof(H5FD_iouring_op_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate ring operations")
+    if(NULL == (file->free_ops = (unsigned *)H5MM_malloc(file->entries * sizeof(unsigned))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate ring operations")
+    for(u = 0; u < file->entries; u++)
+        file->free_ops[u] = file->entries - u - 1;
+    file->nfree = file->entries;
+
+    /* Register the buffers, if they were asked for */
+    if(file->fa.reg_buf_size >= file->entries) {
+        struct iovec    reg_iov;    /* Registered buffer */
+
+        file->slot_size = file->fa.reg_buf_size / file->entries;
+        if(0 != HDposix_memalign((void **)&file->reg_buf, H5FD_IOURING_REG_ALIGN, file->slot_size * file->entries))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate registered buffers")
+        reg_iov.iov_base = file->reg_buf;
+        reg_iov.iov_len = file->slot_size * file->entries;
+        if(syscall(__NR_io_uring_register, file->ring_fd, IORING_REGISTER_BUFFERS, &reg_iov, 1) < 0) {
+            HDfree(file->reg_buf);
+            file->reg_buf = NULL;
+            file->slot_size = 0;
+        } /* end if */
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_ring_init() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_ring_term
+ *
+ * Purpose:     Releases FILE's submission ring, if it has one.  Nothing
+ *              may be in flight.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FD_iouring_ring_term(H5FD_iouring_t *file)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(file);
+    HDassert(file->nfree == file->entries);
+
+    if(file->sqes)
+        HDmunmap(file->sqes, file->sqes_size);
+    if(file->cq_ring)
+        HDmunmap(file->cq_ring, file->cq_ring_size);
+    if(file->sq_ring)
+        HDmunmap(file->sq_ring, file->sq_ring_size);
+    if(file->ring_fd >= 0)
+        HDclose(file->ring_fd);
+    if(file->reg_buf)
+        HDfree(file->reg_buf);
+    file->ops = (H5FD_iouring_op_t *)H5MM_xfree(file->ops);
+    file->free_ops = (unsigned *)H5MM_xfree(file->free_ops);
+
+    file->sqes = NULL;
+    file->cq_ring = NULL;
+    file->sq_ring = NULL;
+    file->ring_fd = -1;
+    file->reg_buf = NULL;
+    file->slot_size = 0;
+    file->entries = file->nfree = 0;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FD_iouring_ring_term() */
+#endif /* H5FD_IOURING_HAVE_RING */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_close
+ *
+ * Purpose:     Closes an HDF5 file.
+ *
+ * Return:      Success:    SUCCEED
+ *              Failure:    FAIL, file not closed.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_close(H5FD_t *_file)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file;
+    herr_t      ret_value = SUCCEED;                /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Sanity check */
+    HDassert(file);
+
+#ifdef H5FD_IOURING_HAVE_RING
+    /* Release the submission ring */
+    H5FD_iouring_ring_term(file);
+#endif /* H5FD_IOURING_HAVE_RING */
+
+    /* Close the underlying file */
+    if(HDclose(file->fd) < 0)
+        HSYS_GOTO_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to close file")
+
+    /* Release the file info */
+    file = H5FL_FREE(H5FD_iouring_t, file);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_cmp
+ *
+ * Purpose:     Compares two files belonging to this driver using an
+ *              arbitrary (but consistent) ordering.
+ *
+ * Return:      Success:    A value like strcmp()
+ *              Failure:    never fails (arguments were checked by the
+ *                          caller).
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD_iouring_cmp(const H5FD_t *_f1, const H5FD_t *_f2)
+{
+    const H5FD_iouring_t    *f1 = (const H5FD_iouring_t *)_f1;
+    const H5FD_iouring_t    *f2 = (const H5FD_iouring_t *)_f2;
+    int ret_value = 0;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+#ifdef H5_DEV_T_IS_SCALAR
+    if(f1->device < f2->device) HGOTO_DONE(-1)
+    if(f1->device > f2->device) HGOTO_DONE(1)
+#else /* H5_DEV_T_IS_SCALAR */
+    /* If dev_t isn't a scalar value on this system, just use memcmp to
+     * determine if the values are the same or not.  The actual return value
+     * shouldn't really matter...
+     */
+    if(HDmemcmp(&(f1->device),&(f2->device),sizeof(dev_t)) < 0) HGOTO_DONE(-1)
+    if(HDmemcmp(&(f1->device),&(f2->device),sizeof(dev_t)) > 0) HGOTO_DONE(1)
+#endif /* H5_DEV_T_IS_SCALAR */
+    if(f1->inode < f2->inode) HGOTO_DONE(-1)
+    if(f1->inode > f2->inode) HGOTO_DONE(1)
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_query
+ *
+ * Purpose:     Set the flags that this VFL driver is capable of supporting.
+ *              (listed in H5FDpublic.h)
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_query(const H5FD_t H5_ATTR_UNUSED *_file, unsigned long *flags /* out */)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Set the VFL feature flags that this driver supports */
+    if(flags) {
+        *flags = 0;
+        *flags |= H5FD_FEAT_AGGREGATE_METADATA;     /* OK to aggregate metadata allocations                             */
+        *flags |= H5FD_FEAT_ACCUMULATE_METADATA;    /* OK to accumulate metadata for faster writes                      */
+        *flags |= H5FD_FEAT_DATA_SIEVE;             /* OK to perform data sieving for faster raw data reads & writes    */
+        *flags |= H5FD_FEAT_AGGREGATE_SMALLDATA;    /* OK to aggregate "small" raw data allocations                     */
+        *flags |= H5FD_FEAT_POSIX_COMPAT_HANDLE;    /* get_handle callback returns a POSIX file descriptor              */
+        *flags |= H5FD_FEAT_DEFAULT_VFD_COMPATIBLE; /* VFD creates a file which can be opened with the default VFD      */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_iouring_query() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_get_eoa
+ *
+ * Purpose:     Gets the end-of-address marker for the file. The EOA marker
+ *              is the first address past the last byte allocated in the
+ *              format address space.
+ *
+ * Return:      The end-of-address marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_iouring_get_eoa(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_iouring_t    *file = (const H5FD_iouring_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eoa)
+} /* end H5FD_iouring_get_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_set_eoa
+ *
+ * Purpose:     Set the end-of-address marker for the file. This function is
+ *              called shortly after an existing HDF5 file is opened in order
+ *              to tell the driver where the end of the HDF5 data is located.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_set_eoa(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, haddr_t addr)
+{
+    H5FD_iouring_t  *file = (H5FD_iouring_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    file->eoa = addr;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_iouring_set_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_get_eof
+ *
+ * Purpose:     Returns the end-of-file marker, which is the greater of
+ *              either the filesystem end-of-file or the HDF5 end-of-address
+ *              markers.
+ *
+ * Return:      End of file address, the first address past the end of the
+ *              "file", either the filesystem file or the HDF5 file.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_iouring_get_eof(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_iouring_t    *file = (const H5FD_iouring_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eof)
+} /* end H5FD_iouring_get_eof() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:       H5FD_iouring_get_handle
+ *
+ * Purpose:        Returns the file handle of io_uring file driver.
+ *
+ * Returns:        SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_get_handle(H5FD_t *_file, hid_t H5_ATTR_UNUSED fapl, void **file_handle)
+{
+    H5FD_iouring_t      *file = (H5FD_iouring_t *)_file;
+    herr_t              ret_value = SUCCEED;
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(!file_handle)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "file handle not valid")
+
+    *file_handle = &(file->fd);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_get_handle() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_read
+ *
+ * Purpose:     Reads SIZE bytes of data from FILE beginning at address ADDR
+ *              into buffer BUF, with pread().
+ *
+ * Return:      Success:    SUCCEED. Result is stored in caller-supplied
+ *                          buffer BUF.
+ *              Failure:    FAIL, Contents of buffer BUF are undefined.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id,
+    haddr_t addr, size_t size, void *buf /*out*/)
+{
+    H5FD_iouring_t  *file       = (H5FD_iouring_t *)_file;
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->pub.cls);
+    HDassert(buf);
+
+    /* Check for overflow conditions */
+    if(!H5F_addr_defined(addr))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addr)
+    if(REGION_OVERFLOW(addr, size))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu", (unsigned long long)addr)
+
+    /* Read data, being careful of interrupted system calls, partial results,
+     * and the end of the file.
+     */
+    while(size > 0) {
+        h5_posix_io_t       bytes_in        = 0;    /* # of bytes to read       */
+        h5_posix_io_ret_t   bytes_read      = -1;   /* # of bytes actually read */
+
+        /* Trying to read more bytes than the return type can handle is
+         * undefined behavior in POSIX.
+         */
+        if(size > H5_POSIX_MAX_IO_BYTES)
+            bytes_in = H5_POSIX_MAX_IO_BYTES;
+        else
+            bytes_in = (h5_posix_io_t)size;
+
+        do {
+            bytes_read = HDpread(file->fd, buf, bytes_in, (HDoff_t)addr);
+        } while(-1 == bytes_read && EINTR == errno);
+
+        if(-1 == bytes_read) { /* error */
+            int myerrno = errno;
+            time_t mytime = HDtime(NULL);
+
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file read failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', buf = %p, total read size = %llu, bytes this sub-read = %llu, bytes actually read = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), buf, (unsigned long long)size, (unsigned long long)bytes_in, (unsigned long long)bytes_read, (unsigned long long)addr);
+        } /* end if */
+
+        if(0 == bytes_read) {
+            /* end of file but not end of format address space */
+            HDmemset(buf, 0, size);
+            break;
+        } /* end if */
+
+        HDassert(bytes_read >= 0);
+        HDassert((size_t)bytes_read <= size);
+
+        size -= (size_t)bytes_read;
+        addr += (haddr_t)bytes_read;
+        buf = (char *)buf + bytes_read;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_read() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_write
+ *
+ * Purpose:     Writes SIZE bytes of data to FILE beginning at address ADDR
+ *              from buffer BUF, with pwrite().
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_write(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id,
+                haddr_t addr, size_t size, const void *buf)
+{
+    H5FD_iouring_t  *file       = (H5FD_iouring_t *)_file;
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->pub.cls);
+    HDassert(buf);
+
+    /* Check for overflow conditions */
+    if(!H5F_addr_defined(addr))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addr)
+    if(REGION_OVERFLOW(addr, size))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addr, (unsigned long long)size)
+
+    /* Write the data, being careful of interrupted system calls and partial
+     * results
+     */
+    while(size > 0) {
+        h5_posix_io_t       bytes_in        = 0;    /* # of bytes to write  */
+        h5_posix_io_ret_t   bytes_wrote     = -1;   /* # of bytes written   */
+
+        /* Trying to write more bytes than the return type can handle is
+         * undefined behavior in POSIX.
+         */
+        if(size > H5_POSIX_MAX_IO_BYTES)
+            bytes_in = H5_POSIX_MAX_IO_BYTES;
+        else
+            bytes_in = (h5_posix_io_t)size;
+
+        do {
+            bytes_wrote = HDpwrite(file->fd, buf, bytes_in, (HDoff_t)addr);
+        } while(-1 == bytes_wrote && EINTR == errno);
+
+        if(-1 == bytes_wrote) { /* error */
+            int myerrno = errno;
+            time_t mytime = HDtime(NULL);
+
+            HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "file write failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', buf = %p, total write size = %llu, bytes this sub-write = %llu, bytes actually written = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), buf, (unsigned long long)size, (unsigned long long)bytes_in, (unsigned long long)bytes_wrote, (unsigned long long)addr);
+        } /* end if */
+
+        HDassert(bytes_wrote > 0);
+        HDassert((size_t)bytes_wrote <= size);
+
+        size -= (size_t)bytes_wrote;
+        addr += (haddr_t)bytes_wrote;
+        buf = (const char *)buf + bytes_wrote;
+    } /* end while */
+
+    /* Update eof */
+    if(addr > file->eof)
+        file->eof = addr;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_write() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_read_vector
+ *
+ * Purpose:     Performs COUNT reads from FILE, all in flight together on
+ *              the file's submission ring.  Parts of requests past the end
+ *              of the file are filled with zeros.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_read_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], void *bufs[])
+{
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_iouring_vector_io((H5FD_iouring_t *)_file, count, addrs, sizes, bufs, NULL) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "vector read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_write_vector
+ *
+ * Purpose:     Performs COUNT writes to FILE, all in flight together on
+ *              the file's submission ring.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_write_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], const void *bufs[])
+{
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_iouring_vector_io((H5FD_iouring_t *)_file, count, addrs, sizes, NULL, bufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "vector write failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_write_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_vector_io
+ *
+ * Purpose:     Common code for vector reads (RBUFS non-NULL) and writes
+ *              (WBUFS non-NULL).
+ *
+ *              Every request is queued on the submission ring, as long as
+ *              there are free entries, and the ring is submitted and
+ *              waited on until all of them have completed.  Requests
+ *              larger than H5FD_IOURING_MAX_IO, and partial results, are
+ *              continued with further operations.  After an error, no new
+ *              operations are queued, but the ones in flight are waited
+ *              for before returning, since they use the caller's buffers.
+ *
+ *              Without a ring, the requests are done one at a time.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_vector_io(H5FD_iouring_t *file, size_t count, const haddr_t addrs[],
+    const size_t sizes[], void *rbufs[], const void *wbufs[])
+{
+#ifdef H5FD_IOURING_HAVE_RING
+    size_t          *done = NULL;           /* # of bytes done for each request */
+    size_t          *resubmit = NULL;       /* Requests to continue */
+    size_t          nresubmit = 0;          /* # of requests to continue */
+    size_t          next = 0;               /* Next request not started */
+    unsigned        ninflight = 0;          /* # of operations in flight */
+    int             err = 0;                /* errno from first failure */
+#endif /* H5FD_IOURING_HAVE_RING */
+    size_t          u;                      /* Local index variable */
+    herr_t          ret_value   = SUCCEED;  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->pub.cls);
+    HDassert((rbufs != NULL) != (wbufs != NULL));
+
+    /* Check for overflow conditions */
+    for(u = 0; u < count; u++) {
+        if(!H5F_addr_defined(addrs[u]))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addrs[u])
+        if(REGION_OVERFLOW(addrs[u], sizes[u]))
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addrs[u], (unsigned long long)sizes[u])
+    } /* end for */
+
+    /* Without a ring, do the requests one at a time */
+    if(file->ring_fd < 0) {
+        for(u = 0; u < count; u++) {
+            if(rbufs) {
+                if(H5FD_iouring_read((H5FD_t *)file, H5FD_MEM_DRAW, H5P_DEFAULT, addrs[u], sizes[u], rbufs[u]) < 0)
+                    HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file read failed")
+            } /* end if */
+            else {
+                if(H5FD_iouring_write((H5FD_t *)file, H5FD_MEM_DRAW, H5P_DEFAULT, addrs[u], sizes[u], wbufs[u]) < 0)
+                    HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "file write failed")
+            } /* end else */
+        } /* end for */
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+#ifdef H5FD_IOURING_HAVE_RING
+    if(NULL == (done = (size_t *)H5MM_calloc(count * sizeof(size_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate request progress")
+    if(NULL == (resubmit = (size_t *)H5MM_malloc(count * sizeof(size_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate request progress")
+
+    while(ninflight > 0 || (0 == err && (nresubmit > 0 || next < count))) {
+        unsigned    sq_tail = *file->sq_tail;   /* Local copy of submission tail */
+        unsigned    cq_head;                    /* Next completion to reap */
+        unsigned    to_submit;                  /* # of queued entries for kernel */
+
+        /* Queue operations on free entries, until there's an error */
+        while(0 == err && file->nfree > 0 && (nresubmit > 0 || next < count)) {
+            H5FD_iouring_op_t   *op;            /* Operation to queue */
+            struct io_uring_sqe *sqe;           /* Submission queue entry */
+            unsigned            op_idx;         /* Index of operation */
+            unsigned            sqe_idx;        /* Index of queue entry */
+            size_t              req;            /* Request index */
+
+            if(nresubmit > 0)
+                req = resubmit[--nresubmit];
+            else {
+                req = next++;
+                if(0 == sizes[req])
+                    continue;
+            } /* end else */
+
+            op_idx = file->free_ops[--file->nfree];
+            op = &file->ops[op_idx];
+            op->req = req;
+            op->len = MIN(sizes[req] - done[req], H5FD_IOURING_MAX_IO);
+            op->fixed = (hbool_t)(op->len <= file->slot_size);
+
+            sqe_idx = sq_tail & *file->sq_mask;
+            sqe = &file->sqes[sqe_idx];
+            HDmemset(sqe, 0, sizeof(*sqe));
+            sqe->fd = file->fd;
+            sqe->off = (__u64)(addrs[req] + done[req]);
+            sqe->user_data = (__u64)op_idx;
+            if(op->fixed) {
+                unsigned char *slot = file->reg_buf + (size_t)op_idx * file->slot_size;
+
+                if(wbufs)
+                    HDmemcpy(slot, (const unsigned char *)wbufs[req] + done[req], op->len);
+                sqe->opcode = (__u8)(rbufs ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED);
+                sqe->addr = (__u64)(uintptr_t)slot;
+                sqe->len = (__u32)op->len;
+                sqe->buf_index = 0;
+            } /* end if */
+            else {
+                op->iov.iov_base = rbufs ? (unsigned char *)rbufs[req] + done[req] :
+                        (unsigned char *)((uintptr_t)wbufs[req]) + done[req];
+                op->iov.iov_len = op->len;
+                sqe->opcode = (__u8)(rbufs ? IORING_OP_READV : IORING_OP_WRITEV);
+                sqe->addr = (__u64)(uintptr_t)&op->iov;
+                sqe->len = 1;
+            } /* end else */
+            file->sq_array[sqe_idx] = sqe_idx;
+            sq_tail++;
+            ninflight++;
+        } /* end while */
+        H5FD_IOURING_STORE_RELEASE(file->sq_tail, sq_tail);
+
+        /* Nothing left to wait for (only empty requests) */
+        if(0 == ninflight)
+            break;
+
+        /* Submit the queued entries and wait for at least one completion */
+        to_submit = sq_tail - H5FD_IOURING_LOAD_ACQUIRE(file->sq_head);
+        if(syscall(__NR_io_uring_enter, file->ring_fd, to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0
+                && EINTR != errno && EAGAIN != errno && EBUSY != errno) {
+            int myerrno = errno;
+
+            HGOTO_ERROR(H5E_IO, rbufs ? H5E_READERROR : H5E_WRITEERROR, FAIL, "unable to submit to ring: filename = '%s', errno = %d, error message = '%s'", file->filename, myerrno, HDstrerror(myerrno))
+        } /* end if */
+
+        /* Reap the completions */
+        cq_head = *file->cq_head;
+        while(cq_head != H5FD_IOURING_LOAD_ACQUIRE(file->cq_tail)) {
+            const struct io_uring_cqe *cqe = &file->cqes[cq_head & *file->cq_mask];
+            unsigned            op_idx = (unsigned)cqe->user_data;
+            H5FD_iouring_op_t   *op = &file->ops[op_idx];
+            size_t              req = op->req;
+            int                 res = cqe->res;
+
+            HDassert(op_idx < file->entries);
+
+            if(res < 0) {
+                if(-EINTR == res || -EAGAIN == res)
+                    resubmit[nresubmit++] = req;
+                else if(0 == err)
+                    err = -res;
+            } /* end if */
+            else if(0 == res) {
+                if(rbufs) {
+                    /* end of file but not end of format address space */
+                    HDmemset((unsigned char *)rbufs[req] + done[req], 0, sizes[req] - done[req]);
+                    done[req] = sizes[req];
+                } /* end if */
+                else if(0 == err)
+                    err = EIO;
+            } /* end if */
+            else {
+                HDassert((size_t)res <= op->len);
+
+                if(rbufs && op->fixed)
+                    HDmemcpy((unsigned char *)rbufs[req] + done[req], file->reg_buf + (size_t)op_idx * file->slot_size, (size_t)res);
+                done[req] += (size_t)res;
+                if(done[req] < sizes[req])
+                    resubmit[nresubmit++] = req;
+                else if(wbufs && addrs[req] + sizes[req] > file->eof)
+                    file->eof = addrs[req] + sizes[req];
+            } /* end else */
+
+            file->free_ops[file->nfree++] = op_idx;
+            ninflight--;
+            cq_head++;
+        } /* end while */
+        H5FD_IOURING_STORE_RELEASE(file->cq_head, cq_head);
+    } /* end while */
+
+    if(err) {
+        time_t mytime = HDtime(NULL);
+
+        HGOTO_ERROR(H5E_IO, rbufs ? H5E_READERROR : H5E_WRITEERROR, FAIL, "file vector %s failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', requests = %llu", rbufs ? "read" : "write", HDctime(&mytime), file->filename, file->fd, err, HDstrerror(err), (unsigned long long)count)
+    } /* end if */
+#endif /* H5FD_IOURING_HAVE_RING */
+
+done:
+#ifdef H5FD_IOURING_HAVE_RING
+    H5MM_xfree(done);
+    H5MM_xfree(resubmit);
+#endif /* H5FD_IOURING_HAVE_RING */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_vector_io() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_truncate
+ *
+ * Purpose:     Makes sure that the true file size is the same as
+ *              the end-of-allocation.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_truncate(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, hbool_t H5_ATTR_UNUSED closing)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file;
+    herr_t ret_value = SUCCEED;                 /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    /* Extend the file to make sure it's large enough */
+    if(!H5F_addr_eq(file->eoa, file->eof)) {
+        if(-1 == HDftruncate(file->fd, (HDoff_t)file->eoa))
+            HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to extend file properly")
+
+        /* Update the eof value */
+        file->eof = file->eoa;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_truncate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_lock
+ *
+ * Purpose:     To place an advisory lock on a file.
+ *		The lock type to apply depends on the parameter "rw":
+ *			TRUE--opens for write: an exclusive lock
+ *			FALSE--opens for read: a shared lock
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_lock(H5FD_t *_file, hbool_t rw)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file; /* VFD file struct  */
+    int lock_flags;                             /* file locking flags       */
+    herr_t ret_value = SUCCEED;                 /* Return value             */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    /* Set exclusive or shared lock based on rw status */
+    lock_flags = rw ? LOCK_EX : LOCK_SH;
+
+    /* Place a non-blocking lock on the file */
+    if(HDflock(file->fd, lock_flags | LOCK_NB) < 0) {
+        if(ENOSYS == errno)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "file locking disabled on this file system (use HDF5_USE_FILE_LOCKING environment variable to override)")
+        else
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "unable to lock file")
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_lock() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_iouring_unlock
+ *
+ * Purpose:     To remove the existing lock on the file
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_iouring_unlock(H5FD_t *_file)
+{
+    H5FD_iouring_t *file = (H5FD_iouring_t *)_file; /* VFD file struct  */
+    herr_t ret_value = SUCCEED;                 /* Return value             */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    if(HDflock(file->fd, LOCK_UN) < 0) {
+        if(ENOSYS == errno)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "file locking disabled on this file system (use HDF5_USE_FILE_LOCKING environment variable to override)")
+        else
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "unable to unlock file")
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_iouring_unlock() */
+
+#endif /* H5_HAVE_LINUX_IO_URING_H */
+
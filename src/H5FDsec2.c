@@ -39,6 +39,11 @@
 /* The driver identification number, initialized at runtime */
 static hid_t H5FD_SEC2_g = 0;
 
+/* Driver-specific file access properties */
+typedef struct H5FD_sec2_fapl_t {
+    hbool_t         direct_read;    /* Read read-only files with O_DIRECT */
+} H5FD_sec2_fapl_t;
+
 /* The description of a file belonging to this driver. The 'eoa' and 'eof'
  * determine the amount of hdf5 address space in use and the high-water mark
  * of the file (the current size of the underlying filesystem file). The
@@ -48,7 +53,12 @@ static hid_t H5FD_SEC2_g = 0;
  * the current operation is the same as the previous operation.  When opening
  * a file the 'eof' will be set to the current file size, `eoa' will be set
  * to zero, 'pos' will be set to H5F_ADDR_UNDEF (as it is when an error
- * occurs), and 'op' will be set to H5F_OP_UNKNOWN.
+ * occurs), and 'op' will be set to H5F_OP_UNKNOWN.  ('pos' and 'op' aren't
+ * used where pread() and pwrite() are available, since they don't use or
+ * move the file position.)
+ *
+ * When 'direct_read' is set, the file was opened read-only with O_DIRECT
+ * and every read goes through the aligned 'bounce' buffer.
  */
 typedef struct H5FD_sec2_t {
     H5FD_t          pub;    /* public stuff, must be first      */
@@ -57,6 +67,8 @@ typedef struct H5FD_sec2_t {
     haddr_t         eof;    /* end of file; current file size   */
     haddr_t         pos;    /* current file I/O position        */
     H5FD_file_op_t  op;     /* last operation                   */
+    hbool_t         direct_read;    /* whether reads bypass the OS cache */
+    unsigned char   *bounce;        /* aligned buffer for direct reads  */
     char            filename[H5FD_MAX_FILENAME_LEN];    /* Copy of file name from open operation */
 #ifndef H5_HAVE_WIN32_API
     /* On most systems the combination of device and i-node number uniquely
@@ -120,6 +132,37 @@ typedef struct H5FD_sec2_t {
                                  HADDR_UNDEF==(A)+(Z) ||                    \
                                 (HDoff_t)((A)+(Z))<(HDoff_t)(A))
 
+/* Reads and writes use pread() and pwrite(), where available, so they don't
+ * need a seek first and don't depend on the file position.
+ */
+#if defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE)
+#define H5FD_SEC2_HAVE_PIO
+#endif /* H5_HAVE_PREAD && H5_HAVE_PWRITE */
+
+/* Direct reads (with O_DIRECT) need positional I/O.  They go through a
+ * bounce buffer of H5FD_SEC2_BOUNCE_SIZE bytes, at offsets and in sizes that
+ * are multiples of H5FD_SEC2_DIRECT_ALIGN, which must be a multiple of the
+ * file system's block size.
+ */
+#if defined(H5FD_SEC2_HAVE_PIO) && defined(O_DIRECT)
+#define H5FD_SEC2_HAVE_DIRECT_READ
+#define H5FD_SEC2_DIRECT_ALIGN  4096
+#define H5FD_SEC2_BOUNCE_SIZE   (1024 * 1024)
+#endif /* H5FD_SEC2_HAVE_PIO && O_DIRECT */
+
+/* Vector I/O is done with preadv() and pwritev(), where available.  Runs of
+ * requests that are adjacent in the file are transferred with one call,
+ * using up to H5FD_SEC2_MAX_IOV buffers.
+ */
+#if defined(H5_HAVE_PREADV) && defined(H5_HAVE_PWRITEV)
+#define H5FD_SEC2_HAVE_VECTOR_IO
+#if defined(IOV_MAX) && IOV_MAX < 64
+#define H5FD_SEC2_MAX_IOV   IOV_MAX
+#else
+#define H5FD_SEC2_MAX_IOV   64
+#endif
+#endif /* H5_HAVE_PREADV && H5_HAVE_PWRITEV */
+
 /* Prototypes */
 static herr_t H5FD_sec2_term(void);
 static H5FD_t *H5FD_sec2_open(const char *name, unsigned flags, hid_t fapl_id,
@@ -135,6 +178,21 @@ static herr_t H5FD_sec2_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, hadd
             size_t size, void *buf);
 static herr_t H5FD_sec2_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
             size_t size, const void *buf);
+#ifdef H5FD_SEC2_HAVE_DIRECT_READ
+static herr_t H5FD_sec2_read_direct(H5FD_sec2_t *file, haddr_t addr,
+    size_t size, void *buf);
+#endif /* H5FD_SEC2_HAVE_DIRECT_READ */
+#ifdef H5FD_SEC2_HAVE_VECTOR_IO
+static herr_t H5FD_sec2_read_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *bufs[]);
+static herr_t H5FD_sec2_write_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    const void *bufs[]);
+static herr_t H5FD_sec2_vector_io(H5FD_sec2_t *file, size_t count,
+    const haddr_t addrs[], const size_t sizes[], void *rbufs[],
+    const void *wbufs[]);
+#endif /* H5FD_SEC2_HAVE_VECTOR_IO */
 static herr_t H5FD_sec2_truncate(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
 static herr_t H5FD_sec2_lock(H5FD_t *_file, hbool_t rw);
 static herr_t H5FD_sec2_unlock(H5FD_t *_file);
@@ -147,7 +205,7 @@ static const H5FD_class_t H5FD_sec2_g = {
     NULL,                       /* sb_size              */
     NULL,                       /* sb_encode            */
     NULL,                       /* sb_decode            */
-    0,                          /* fapl_size            */
+    sizeof(H5FD_sec2_fapl_t),   /* fapl_size            */
     NULL,                       /* fapl_get             */
     NULL,                       /* fapl_copy            */
     NULL,                       /* fapl_free            */
@@ -167,6 +225,13 @@ static const H5FD_class_t H5FD_sec2_g = {
     H5FD_sec2_get_handle,       /* get_handle           */
     H5FD_sec2_read,             /* read                 */
     H5FD_sec2_write,            /* write                */
+#ifdef H5FD_SEC2_HAVE_VECTOR_IO
+    H5FD_sec2_read_vector,      /* read_vector          */
+    H5FD_sec2_write_vector,     /* write_vector         */
+#else /* H5FD_SEC2_HAVE_VECTOR_IO */
+    NULL,                       /* read_vector          */
+    NULL,                       /* write_vector         */
+#endif /* H5FD_SEC2_HAVE_VECTOR_IO */
     NULL,                       /* flush                */
     H5FD_sec2_truncate,         /* truncate             */
     H5FD_sec2_lock,             /* lock                 */
@@ -290,6 +355,83 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Pset_fapl_sec2() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_sec2_direct_read
+ *
+ * Purpose:     Modify the file access property list to use the H5FD_SEC2
+ *              driver, and set whether files opened read-only with it
+ *              should be read with O_DIRECT, bypassing the operating
+ *              system's page cache.  Reads are then done in aligned
+ *              blocks through a buffer owned by the driver.
+ *
+ *              Where O_DIRECT isn't available, or the file system refuses
+ *              it, files are read normally.  Files opened for writing are
+ *              never opened with O_DIRECT.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_sec2_direct_read(hid_t fapl_id, hbool_t direct_read)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    H5FD_sec2_fapl_t fa;        /* Driver properties */
+    herr_t ret_value;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ib", fapl_id, direct_read);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+
+    HDmemset(&fa, 0, sizeof(fa));
+    fa.direct_read = direct_read;
+
+    ret_value = H5P_set_driver(plist, H5FD_SEC2, &fa);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_sec2_direct_read() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_fapl_sec2_direct_read
+ *
+ * Purpose:     Retrieve whether a file access property list that uses the
+ *              H5FD_SEC2 driver asks for read-only files to be read with
+ *              O_DIRECT.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_fapl_sec2_direct_read(hid_t fapl_id, hbool_t *direct_read/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    const H5FD_sec2_fapl_t *fa; /* Driver properties */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", fapl_id, direct_read);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(H5FD_SEC2 != H5P_peek_driver(plist))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "incorrect VFL driver")
+
+    /* Lists set up with H5Pset_fapl_sec2() have no driver info */
+    if(direct_read) {
+        fa = (const H5FD_sec2_fapl_t *)H5P_peek_driver_info(plist);
+        *direct_read = fa ? fa->direct_read : FALSE;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_fapl_sec2_direct_read() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5FD_sec2_open
@@ -312,6 +454,7 @@ H5FD_sec2_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
     H5FD_sec2_t     *file       = NULL;     /* sec2 VFD info            */
     int             fd          = -1;       /* File descriptor          */
     int             o_flags;                /* Flags for open() call    */
+    hbool_t         direct_read = FALSE;    /* Whether to use O_DIRECT  */
 #ifdef H5_HAVE_WIN32_API
     struct _BY_HANDLE_FILE_INFORMATION fileinfo;
 #endif
@@ -340,8 +483,29 @@ H5FD_sec2_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
     if(H5F_ACC_EXCL & flags)
         o_flags |= O_EXCL;
 
+#ifdef H5FD_SEC2_HAVE_DIRECT_READ
+    /* Check whether a read-only file should be read with O_DIRECT */
+    if(H5P_FILE_ACCESS_DEFAULT != fapl_id && !(H5F_ACC_RDWR & flags)) {
+        H5P_genplist_t          *plist;     /* Property list pointer */
+        const H5FD_sec2_fapl_t  *fa;        /* Driver properties */
+
+        if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+            HGOTO_ERROR(H5E_VFL, H5E_BADTYPE, NULL, "not a file access property list")
+        if(H5FD_SEC2_g == H5P_peek_driver(plist)
+                && NULL != (fa = (const H5FD_sec2_fapl_t *)H5P_peek_driver_info(plist)))
+            direct_read = fa->direct_read;
+    } /* end if */
+
     /* Open the file */
-    if((fd = HDopen(name, o_flags, H5_POSIX_CREATE_MODE_RW)) < 0) {
+    if(direct_read) {
+        /* Fall back to normal reads if the file system refuses O_DIRECT */
+        if((fd = HDopen(name, o_flags | O_DIRECT, H5_POSIX_CREATE_MODE_RW)) < 0 && EINVAL == errno)
+            direct_read = FALSE;
+    } /* end if */
+    if(!direct_read)
+#endif /* H5FD_SEC2_HAVE_DIRECT_READ */
+        fd = HDopen(name, o_flags, H5_POSIX_CREATE_MODE_RW);
+    if(fd < 0) {
         int myerrno = errno;
         HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to open file: name = '%s', errno = %d, error message = '%s', flags = %x, o_flags = %x", name, myerrno, HDstrerror(myerrno), flags, (unsigned)o_flags);
     } /* end if */
@@ -357,6 +521,13 @@ H5FD_sec2_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
     H5_CHECKED_ASSIGN(file->eof, haddr_t, sb.st_size, h5_stat_size_t);
     file->pos = HADDR_UNDEF;
     file->op = OP_UNKNOWN;
+#ifdef H5FD_SEC2_HAVE_DIRECT_READ
+    if(direct_read) {
+        if(0 != HDposix_memalign((void **)&file->bounce, H5FD_SEC2_DIRECT_ALIGN, H5FD_SEC2_BOUNCE_SIZE))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate direct read buffer")
+        file->direct_read = TRUE;
+    } /* end if */
+#endif /* H5FD_SEC2_HAVE_DIRECT_READ */
 #ifdef H5_HAVE_WIN32_API
     file->hFile = (HANDLE)_get_osfhandle(fd);
     if(INVALID_HANDLE_VALUE == file->hFile)
@@ -402,8 +573,11 @@ done:
     if(NULL == ret_value) {
         if(fd >= 0)
             HDclose(fd);
-        if(file)
+        if(file) {
+            if(file->bounce)
+                HDfree(file->bounce);
             file = H5FL_FREE(H5FD_sec2_t, file);
+        } /* end if */
     } /* end if */
 
     FUNC_LEAVE_NOAPI(ret_value)
@@ -439,6 +613,8 @@ H5FD_sec2_close(H5FD_t *_file)
         HSYS_GOTO_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to close file")
 
     /* Release the file info */
+    if(file->bounce)
+        HDfree(file->bounce);
     file = H5FL_FREE(H5FD_sec2_t, file);
 
 done:
@@ -534,6 +710,13 @@ H5FD_sec2_query(const H5FD_t *_file, unsigned long *flags /* out */)
         /* Check for flags that are set by h5repart */
         if(file && file->fam_to_sec2)
             *flags |= H5FD_FEAT_IGNORE_DRVRINFO; /* Ignore the driver info when file is opened (which eliminates it) */
+
+#ifdef H5FD_SEC2_HAVE_PIO
+        /* Positional reads don't share the file position, but direct reads
+         * share the bounce buffer */
+        if(file && !file->direct_read)
+            *flags |= H5FD_FEAT_CONCURRENT_READ;    /* Reads may be issued from several threads at once */
+#endif /* H5FD_SEC2_HAVE_PIO */
     } /* end if */
 
     FUNC_LEAVE_NOAPI(SUCCEED)
@@ -682,11 +865,22 @@ H5FD_sec2_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUS
     if(REGION_OVERFLOW(addr, size))
         HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu", (unsigned long long)addr)
 
+#ifdef H5FD_SEC2_HAVE_DIRECT_READ
+    /* Files opened with O_DIRECT are read through the bounce buffer */
+    if(file->direct_read) {
+        if(H5FD_sec2_read_direct(file, addr, size, buf) < 0)
+            HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "direct read failed")
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+#endif /* H5FD_SEC2_HAVE_DIRECT_READ */
+
+#ifndef H5FD_SEC2_HAVE_PIO
     /* Seek to the correct location */
     if(addr != file->pos || OP_READ != file->op) {
         if(HDlseek(file->fd, (HDoff_t)addr, SEEK_SET) < 0)
             HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to seek to proper position")
     } /* end if */
+#endif /* H5FD_SEC2_HAVE_PIO */
 
     /* Read data, being careful of interrupted system calls, partial results,
      * and the end of the file.
@@ -705,13 +899,21 @@ H5FD_sec2_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUS
             bytes_in = (h5_posix_io_t)size;
 
         do {
+#ifdef H5FD_SEC2_HAVE_PIO
+            bytes_read = HDpread(file->fd, buf, bytes_in, (HDoff_t)addr);
+#else /* H5FD_SEC2_HAVE_PIO */
             bytes_read = HDread(file->fd, buf, bytes_in);
+#endif /* H5FD_SEC2_HAVE_PIO */
         } while(-1 == bytes_read && EINTR == errno);
         
         if(-1 == bytes_read) { /* error */
             int myerrno = errno;
             time_t mytime = HDtime(NULL);
+#ifdef H5FD_SEC2_HAVE_PIO
+            HDoff_t myoffset = (HDoff_t)addr;
+#else /* H5FD_SEC2_HAVE_PIO */
             HDoff_t myoffset = HDlseek(file->fd, (HDoff_t)0, SEEK_CUR);
+#endif /* H5FD_SEC2_HAVE_PIO */
 
             HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file read failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', buf = %p, total read size = %llu, bytes this sub-read = %llu, bytes actually read = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), buf, (unsigned long long)size, (unsigned long long)bytes_in, (unsigned long long)bytes_read, (unsigned long long)myoffset);
         } /* end if */
@@ -730,9 +932,11 @@ H5FD_sec2_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUS
         buf = (char *)buf + bytes_read;
     } /* end while */
 
+#ifndef H5FD_SEC2_HAVE_PIO
     /* Update current position */
     file->pos = addr;
     file->op = OP_READ;
+#endif /* H5FD_SEC2_HAVE_PIO */
 
 done:
     if(ret_value < 0) {
@@ -777,11 +981,13 @@ H5FD_sec2_write(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNU
     if(REGION_OVERFLOW(addr, size))
         HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addr, (unsigned long long)size)
 
+#ifndef H5FD_SEC2_HAVE_PIO
     /* Seek to the correct location */
     if(addr != file->pos || OP_WRITE != file->op) {
         if(HDlseek(file->fd, (HDoff_t)addr, SEEK_SET) < 0)
             HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to seek to proper position")
     } /* end if */
+#endif /* H5FD_SEC2_HAVE_PIO */
 
     /* Write the data, being careful of interrupted system calls and partial
      * results
@@ -800,13 +1006,21 @@ H5FD_sec2_write(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNU
             bytes_in = (h5_posix_io_t)size;
 
         do {
+#ifdef H5FD_SEC2_HAVE_PIO
+            bytes_wrote = HDpwrite(file->fd, buf, bytes_in, (HDoff_t)addr);
+#else /* H5FD_SEC2_HAVE_PIO */
             bytes_wrote = HDwrite(file->fd, buf, bytes_in);
+#endif /* H5FD_SEC2_HAVE_PIO */
         } while(-1 == bytes_wrote && EINTR == errno);
         
         if(-1 == bytes_wrote) { /* error */
             int myerrno = errno;
             time_t mytime = HDtime(NULL);
+#ifdef H5FD_SEC2_HAVE_PIO
+            HDoff_t myoffset = (HDoff_t)addr;
+#else /* H5FD_SEC2_HAVE_PIO */
             HDoff_t myoffset = HDlseek(file->fd, (HDoff_t)0, SEEK_CUR);
+#endif /* H5FD_SEC2_HAVE_PIO */
 
             HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "file write failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', buf = %p, total write size = %llu, bytes this sub-write = %llu, bytes actually written = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), buf, (unsigned long long)size, (unsigned long long)bytes_in, (unsigned long long)bytes_wrote, (unsigned long long)myoffset);
         } /* end if */
@@ -819,11 +1033,17 @@ H5FD_sec2_write(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNU
         buf = (const char *)buf + bytes_wrote;
     } /* end while */
 
+#ifdef H5FD_SEC2_HAVE_PIO
+    /* Update eof */
+    if(addr > file->eof)
+        file->eof = addr;
+#else /* H5FD_SEC2_HAVE_PIO */
     /* Update current position and eof */
     file->pos = addr;
     file->op = OP_WRITE;
     if(file->pos > file->eof)
         file->eof = file->pos;
+#endif /* H5FD_SEC2_HAVE_PIO */
 
 done:
     if(ret_value < 0) {
@@ -835,6 +1055,296 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FD_sec2_write() */
 
+#ifdef H5FD_SEC2_HAVE_DIRECT_READ
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_sec2_read_direct
+ *
+ * Purpose:     Reads SIZE bytes from a file opened with O_DIRECT,
+ *              beginning at address ADDR, into BUF.  The enclosing
+ *              aligned blocks are read into the bounce buffer with
+ *              pread(), up to H5FD_SEC2_BOUNCE_SIZE bytes at a time, and
+ *              the requested bytes copied out.  Bytes past the end of the
+ *              file are filled with zeros.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_sec2_read_direct(H5FD_sec2_t *file, haddr_t addr, size_t size, void *buf)
+{
+    unsigned char   *dest = (unsigned char *)buf;   /* Next byte to fill */
+    herr_t          ret_value   = SUCCEED;          /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->direct_read && file->bounce);
+    HDassert(buf);
+
+    while(size > 0) {
+        haddr_t             block_addr;     /* Aligned address to read from */
+        size_t              skip;           /* Leading bytes not requested */
+        size_t              nbytes;         /* # of requested bytes in this pass */
+        size_t              bytes_in;       /* # of bytes to read (aligned) */
+        size_t              bytes_valid = 0;    /* # of bytes read from file */
+        h5_posix_io_ret_t   bytes_read;     /* # of bytes actually read */
+
+        /* Align the start of the read down and its size up */
+        block_addr = addr - (addr % H5FD_SEC2_DIRECT_ALIGN);
+        skip = (size_t)(addr - block_addr);
+        nbytes = MIN(size, H5FD_SEC2_BOUNCE_SIZE - skip);
+        bytes_in = ((skip + nbytes + H5FD_SEC2_DIRECT_ALIGN - 1) / H5FD_SEC2_DIRECT_ALIGN) * H5FD_SEC2_DIRECT_ALIGN;
+
+        /* Fill the bounce buffer, stopping at the end of the file */
+        while(bytes_valid < bytes_in) {
+            do {
+                bytes_read = HDpread(file->fd, file->bounce + bytes_valid, (h5_posix_io_t)(bytes_in - bytes_valid), (HDoff_t)(block_addr + bytes_valid));
+            } while(-1 == bytes_read && EINTR == errno);
+
+            if(-1 == bytes_read) { /* error */
+                int myerrno = errno;
+                time_t mytime = HDtime(NULL);
+
+                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file read failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', total read size = %llu, bytes this sub-read = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), (unsigned long long)size, (unsigned long long)(bytes_in - bytes_valid), (unsigned long long)(block_addr + bytes_valid));
+            } /* end if */
+
+            bytes_valid += (size_t)bytes_read;
+
+            /* A short read that isn't block-aligned is the end of the file */
+            if(0 == bytes_read || 0 != bytes_valid % H5FD_SEC2_DIRECT_ALIGN)
+                break;
+        } /* end while */
+
+        /* Copy out the requested bytes, zero-filling past the end of the file */
+        if(bytes_valid > skip) {
+            size_t ncopy = MIN(nbytes, bytes_valid - skip);
+
+            HDmemcpy(dest, file->bounce + skip, ncopy);
+            if(ncopy < nbytes)
+                HDmemset(dest + ncopy, 0, nbytes - ncopy);
+        } /* end if */
+        else
+            HDmemset(dest, 0, nbytes);
+
+        /* Nothing more to read past the end of the file */
+        if(bytes_valid < bytes_in) {
+            if(size > nbytes)
+                HDmemset(dest + nbytes, 0, size - nbytes);
+            break;
+        } /* end if */
+
+        size -= nbytes;
+        addr += nbytes;
+        dest += nbytes;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_sec2_read_direct() */
+#endif /* H5FD_SEC2_HAVE_DIRECT_READ */
+
+#ifdef H5FD_SEC2_HAVE_VECTOR_IO
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_sec2_read_vector
+ *
+ * Purpose:     Performs COUNT reads from FILE with preadv().  Parts of
+ *              requests past the end of the file are filled with zeros.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_sec2_read_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], void *bufs[])
+{
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_sec2_vector_io((H5FD_sec2_t *)_file, count, addrs, sizes, bufs, NULL) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "vector read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_sec2_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_sec2_write_vector
+ *
+ * Purpose:     Performs COUNT writes to FILE with pwritev().
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_sec2_write_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], const void *bufs[])
+{
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD_sec2_vector_io((H5FD_sec2_t *)_file, count, addrs, sizes, NULL, bufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "vector write failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_sec2_write_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_sec2_vector_io
+ *
+ * Purpose:     Common code for vector reads (RBUFS non-NULL) and writes
+ *              (WBUFS non-NULL).  Each run of requests that are adjacent
+ *              in the file is transferred with one preadv() or pwritev()
+ *              call (repeated on partial results and interrupted system
+ *              calls).
+ *
+ *              preadv() and pwritev() don't move the file offset, so the
+ *              last I/O position used by the 'read' and 'write' callbacks
+ *              stays valid.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+/* (struct iovec has no const buffer pointer, even for writes) */
+H5_GCC_DIAG_OFF(cast-qual)
+static herr_t
+H5FD_sec2_vector_io(H5FD_sec2_t *file, size_t count, const haddr_t addrs[],
+    const size_t sizes[], void *rbufs[], const void *wbufs[])
+{
+    struct iovec    iov[H5FD_SEC2_MAX_IOV];                 /* I/O vector for current run */
+    size_t          u = 0;                                  /* Local index variable */
+    herr_t          ret_value   = SUCCEED;                  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file && file->pub.cls);
+    HDassert((rbufs != NULL) != (wbufs != NULL));
+
+    /* Check for overflow conditions */
+    for(u = 0; u < count; u++) {
+        if(!H5F_addr_defined(addrs[u]))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addrs[u])
+        if(REGION_OVERFLOW(addrs[u], sizes[u]))
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addrs[u], (unsigned long long)sizes[u])
+    } /* end for */
+
+#ifdef H5FD_SEC2_HAVE_DIRECT_READ
+    /* Files opened with O_DIRECT are read through the bounce buffer, one
+     * request at a time.
+     */
+    if(rbufs && file->direct_read) {
+        for(u = 0; u < count; u++)
+            if(H5FD_sec2_read_direct(file, addrs[u], sizes[u], rbufs[u]) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "direct read failed")
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+#endif /* H5FD_SEC2_HAVE_DIRECT_READ */
+
+    u = 0;
+    while(u < count) {
+        struct iovec    *curr_iov = iov;    /* First buffer not yet transferred */
+        int             niov = 0;           /* # of buffers in run */
+        haddr_t         addr = addrs[u];    /* Address of next byte to transfer */
+        size_t          total = 0;          /* # of bytes left in run */
+
+        /* Gather the run of adjacent requests, keeping the total within
+         * what a single call can transfer.  (A single larger request is
+         * transferred in pieces below.)
+         */
+        do {
+            iov[niov].iov_base = rbufs ? rbufs[u] : (void *)wbufs[u];
+            iov[niov].iov_len = sizes[u];
+            total += sizes[u];
+            niov++;
+            u++;
+        } while(u < count && niov < H5FD_SEC2_MAX_IOV
+                && H5F_addr_eq(addrs[u], addrs[u - 1] + sizes[u - 1])
+                && total <= (size_t)H5_POSIX_MAX_IO_BYTES
+                && sizes[u] <= (size_t)H5_POSIX_MAX_IO_BYTES - total);
+
+        while(total > 0) {
+            h5_posix_io_ret_t   bytes_done = -1;    /* # of bytes actually transferred */
+            int                 niov_in = niov;     /* # of buffers this call */
+
+            /* Trying to transfer more bytes than the return type can handle
+             * is undefined behavior in POSIX.
+             */
+            if(1 == niov && total > (size_t)H5_POSIX_MAX_IO_BYTES)
+                curr_iov->iov_len = H5_POSIX_MAX_IO_BYTES;
+
+            do {
+                if(rbufs)
+                    bytes_done = HDpreadv(file->fd, curr_iov, niov_in, (HDoff_t)addr);
+                else
+                    bytes_done = HDpwritev(file->fd, curr_iov, niov_in, (HDoff_t)addr);
+            } while(-1 == bytes_done && EINTR == errno);
+
+            if(1 == niov && total > (size_t)H5_POSIX_MAX_IO_BYTES)
+                curr_iov->iov_len = total;
+
+            if(-1 == bytes_done) { /* error */
+                int myerrno = errno;
+                time_t mytime = HDtime(NULL);
+
+                if(rbufs)
+                    HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file vector read failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', buffers = %d, bytes left in run = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), niov, (unsigned long long)total, (unsigned long long)addr)
+                else
+                    HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "file vector write failed: time = %s, filename = '%s', file descriptor = %d, errno = %d, error message = '%s', buffers = %d, bytes left in run = %llu, offset = %llu", HDctime(&mytime), file->filename, file->fd, myerrno, HDstrerror(myerrno), niov, (unsigned long long)total, (unsigned long long)addr)
+            } /* end if */
+
+            if(0 == bytes_done) {
+                HDassert(rbufs);
+
+                /* end of file but not end of format address space */
+                for(; niov > 0; niov--, curr_iov++)
+                    HDmemset(curr_iov->iov_base, 0, curr_iov->iov_len);
+                break;
+            } /* end if */
+
+            HDassert(bytes_done > 0);
+            HDassert((size_t)bytes_done <= total);
+
+            total -= (size_t)bytes_done;
+            addr += (haddr_t)bytes_done;
+
+            /* Skip past the buffers (and part of a buffer) transferred */
+            while(bytes_done > 0) {
+                if((size_t)bytes_done >= curr_iov->iov_len) {
+                    bytes_done -= (h5_posix_io_ret_t)curr_iov->iov_len;
+                    curr_iov++;
+                    niov--;
+                } /* end if */
+                else {
+                    curr_iov->iov_base = (unsigned char *)curr_iov->iov_base + bytes_done;
+                    curr_iov->iov_len -= (size_t)bytes_done;
+                    bytes_done = 0;
+                } /* end else */
+            } /* end while */
+        } /* end while */
+
+        /* Update eof */
+        if(wbufs && addr > file->eof)
+            file->eof = addr;
+    } /* end while */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_sec2_vector_io() */
+H5_GCC_DIAG_ON(cast-qual)
+
+#endif /* H5FD_SEC2_HAVE_VECTOR_IO */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5FD_sec2_truncate
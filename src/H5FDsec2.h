@@ -28,6 +28,8 @@ extern "C" {
 
 H5_DLL hid_t H5FD_sec2_init(void);
 H5_DLL herr_t H5Pset_fapl_sec2(hid_t fapl_id);
+H5_DLL herr_t H5Pset_fapl_sec2_direct_read(hid_t fapl_id, hbool_t direct_read);
+H5_DLL herr_t H5Pget_fapl_sec2_direct_read(hid_t fapl_id, hbool_t *direct_read/*out*/);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,1303 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: Implements a file driver which stripes the HDF5 address space
+ *          round-robin over a number of subfiles, so that large requests
+ *          are spread over several inodes (and, on a parallel file
+ *          system, over their separate locks and storage targets).
+ *
+ *          The address space is divided into stripes of a fixed size;
+ *          stripe S is stored in subfile S % N at offset (S / N) * stripe
+ *          size, where N is the number of subfiles.  Like the family
+ *          driver's members, the subfiles may have holes, and the end of
+ *          the file is the highest address stored in any of them.
+ *
+ *          The name the file is opened with is a small text file holding
+ *          the stripe size and number of subfiles (see H5FDsubfiling.h),
+ *          which is written when the file is created and read when it's
+ *          opened again, so that a file is always opened with the layout
+ *          it was written with.  It is also the file that is locked.
+ *
+ *          Requests that touch more than one subfile are done with one
+ *          task per subfile, run concurrently on a pool of worker threads
+ *          if the file access properties ask for one.  h5repart can fuse
+ *          the subfiles back into a single file.
+ */
+
+#include "H5FDdrvr_module.h" /* This source code file is part of the H5FD driver module */
+
+
+#include "H5private.h"      /* Generic Functions        */
+#include "H5Eprivate.h"     /* Error handling           */
+#include "H5Fprivate.h"     /* File access              */
+#include "H5FDprivate.h"    /* File drivers             */
+#include "H5FDsubfiling.h"  /* Subfiling file driver    */
+#include "H5FLprivate.h"    /* Free Lists               */
+#include "H5Iprivate.h"     /* IDs                      */
+#include "H5MMprivate.h"    /* Memory management        */
+#include "H5Pprivate.h"     /* Property lists           */
+#include "H5TPprivate.h"    /* Thread pools             */
+
+/* The driver identification number, initialized at runtime */
+static hid_t H5FD_SUBFILING_g = 0;
+
+/* Size of the buffer for the configuration file's contents */
+#define H5FD_SUBFILING_CONFIG_BUF_SIZE  256
+
+/* Driver-specific file access properties */
+typedef struct H5FD_subfiling_fapl_t {
+    unsigned    nsubfiles;      /* Number of subfiles                   */
+    hsize_t     stripe_size;    /* Size of each stripe                  */
+    unsigned    nthreads;       /* Number of worker threads (0 = none)  */
+} H5FD_subfiling_fapl_t;
+
+/* Forward declaration */
+struct H5FD_subfiling_t;
+
+/* The I/O for one subfile in a request, done by a task.  The task does
+ * the parts of each of the COUNT requests in the subfile.
+ */
+typedef struct H5FD_subfiling_io_t {
+    H5TP_task_t task;               /* Worker thread task               */
+    struct H5FD_subfiling_t *file;  /* File the subfile belongs to      */
+    unsigned    subfile;            /* Index of subfile                 */
+    hbool_t     write;              /* Whether requests are writes      */
+    size_t      count;              /* Number of requests               */
+    const haddr_t *addrs;           /* Request addresses                */
+    const size_t *sizes;            /* Request sizes                    */
+    void        **bufs;             /* Request buffers                  */
+    int         err;                /* errno from a failure, else 0     */
+} H5FD_subfiling_io_t;
+
+/* The description of a file belonging to this driver.  The 'eoa' and 'eof'
+ * are the amount of HDF5 address space in use and the highest address
+ * stored in any subfile.
+ */
+typedef struct H5FD_subfiling_t {
+    H5FD_t      pub;            /* public stuff, must be first          */
+    int         fd;             /* configuration file descriptor        */
+    haddr_t     eoa;            /* end of allocated region              */
+    haddr_t     eof;            /* end of file                          */
+    H5FD_subfiling_fapl_t fa;   /* layout and threads in use            */
+    int         *subfile_fds;   /* subfile descriptors                  */
+    H5FD_subfiling_io_t *io;    /* per-subfile I/O tasks                */
+    H5TP_t      *tp;            /* worker threads, or NULL              */
+    char        filename[H5FD_MAX_FILENAME_LEN];    /* Copy of file name from open operation */
+
+    /* On most systems the combination of device and i-node number uniquely
+     * identify a file; the configuration file's are used.
+     */
+    dev_t       device;         /* file device number   */
+    ino_t       inode;          /* file i-node number   */
+} H5FD_subfiling_t;
+
+/*
+ * These macros check for overflow of various quantities.  These macros
+ * assume that HDoff_t is signed and haddr_t and size_t are unsigned.
+ *
+ * ADDR_OVERFLOW:   Checks whether a file address of type `haddr_t'
+ *                  is too large to be represented by the second argument
+ *                  of the file seek function.
+ *
+ * SIZE_OVERFLOW:   Checks whether a buffer size of type `hsize_t' is too
+ *                  large to be represented by the `size_t' type.
+ *
+ * REGION_OVERFLOW: Checks whether an address and size pair describe data
+ *                  which can be addressed entirely by the second
+ *                  argument of the file seek function.
+ */
+#define MAXADDR (((haddr_t)1<<(8*sizeof(HDoff_t)-1))-1)
+#define ADDR_OVERFLOW(A)    (HADDR_UNDEF==(A) || ((A) & ~(haddr_t)MAXADDR))
+#define SIZE_OVERFLOW(Z)    ((Z) & ~(hsize_t)MAXADDR)
+#define REGION_OVERFLOW(A,Z)    (ADDR_OVERFLOW(A) || SIZE_OVERFLOW(Z) ||    \
+                                 HADDR_UNDEF==(A)+(Z) ||                    \
+                                (HDoff_t)((A)+(Z))<(HDoff_t)(A))
+
+/* Prototypes */
+static herr_t H5FD_subfiling_term(void);
+static void *H5FD_subfiling_fapl_get(H5FD_t *_file);
+static void *H5FD_subfiling_fapl_copy(const void *_old_fa);
+static H5FD_t *H5FD_subfiling_open(const char *name, unsigned flags, hid_t fapl_id,
+            haddr_t maxaddr);
+static herr_t H5FD_subfiling_close(H5FD_t *_file);
+static int H5FD_subfiling_cmp(const H5FD_t *_f1, const H5FD_t *_f2);
+static herr_t H5FD_subfiling_query(const H5FD_t *_f1, unsigned long *flags);
+static haddr_t H5FD_subfiling_get_eoa(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t H5FD_subfiling_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr);
+static haddr_t H5FD_subfiling_get_eof(const H5FD_t *_file, H5FD_mem_t type);
+static herr_t  H5FD_subfiling_get_handle(H5FD_t *_file, hid_t fapl, void** file_handle);
+static herr_t H5FD_subfiling_read(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, void *buf);
+static herr_t H5FD_subfiling_write(H5FD_t *_file, H5FD_mem_t type, hid_t fapl_id, haddr_t addr,
+            size_t size, const void *buf);
+static herr_t H5FD_subfiling_read_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    void *bufs[]);
+static herr_t H5FD_subfiling_write_vector(H5FD_t *_file, hid_t dxpl_id, size_t count,
+    const H5FD_mem_t types[], const haddr_t addrs[], const size_t sizes[],
+    const void *bufs[]);
+static herr_t H5FD_subfiling_truncate(H5FD_t *_file, hid_t dxpl_id, hbool_t closing);
+static herr_t H5FD_subfiling_lock(H5FD_t *_file, hbool_t rw);
+static herr_t H5FD_subfiling_unlock(H5FD_t *_file);
+
+static herr_t H5FD__subfiling_config(H5FD_subfiling_t *file, hbool_t create);
+static herr_t H5FD__subfiling_io(H5FD_subfiling_t *file, hbool_t write,
+    size_t count, const haddr_t addrs[], const size_t sizes[], void *bufs[]);
+static herr_t H5FD__subfiling_io_cb(void *_io);
+static haddr_t H5FD__subfiling_subfile_eof(const H5FD_subfiling_t *file,
+    unsigned subfile, haddr_t eoa);
+
+static const H5FD_class_t H5FD_subfiling_g = {
+    "subfiling",                /* name                 */
+    MAXADDR,                    /* maxaddr              */
+    H5F_CLOSE_WEAK,             /* fc_degree            */
+    H5FD_subfiling_term,        /* terminate            */
+    NULL,                       /* sb_size              */
+    NULL,                       /* sb_encode            */
+    NULL,                       /* sb_decode            */
+    sizeof(H5FD_subfiling_fapl_t), /* fapl_size         */
+    H5FD_subfiling_fapl_get,    /* fapl_get             */
+    H5FD_subfiling_fapl_copy,   /* fapl_copy            */
+    NULL,                       /* fapl_free            */
+    0,                          /* dxpl_size            */
+    NULL,                       /* dxpl_copy            */
+    NULL,                       /* dxpl_free            */
+    H5FD_subfiling_open,        /* open                 */
+    H5FD_subfiling_close,       /* close                */
+    H5FD_subfiling_cmp,         /* cmp                  */
+    H5FD_subfiling_query,       /* query                */
+    NULL,                       /* get_type_map         */
+    NULL,                       /* alloc                */
+    NULL,                       /* free                 */
+    H5FD_subfiling_get_eoa,     /* get_eoa              */
+    H5FD_subfiling_set_eoa,     /* set_eoa              */
+    H5FD_subfiling_get_eof,     /* get_eof              */
+    H5FD_subfiling_get_handle,  /* get_handle           */
+    H5FD_subfiling_read,        /* read                 */
+    H5FD_subfiling_write,       /* write                */
+    H5FD_subfiling_read_vector, /* read_vector          */
+    H5FD_subfiling_write_vector, /* write_vector        */
+    NULL,                       /* flush                */
+    H5FD_subfiling_truncate,    /* truncate             */
+    H5FD_subfiling_lock,        /* lock                 */
+    H5FD_subfiling_unlock,      /* unlock               */
+    H5FD_FLMAP_DICHOTOMY        /* fl_map               */
+};
+
+/* Declare a free list to manage the H5FD_subfiling_t struct */
+H5FL_DEFINE_STATIC(H5FD_subfiling_t);
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__init_package
+ *
+ * Purpose:     Initializes any interface-specific data or routines.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__init_package(void)
+{
+    herr_t ret_value = SUCCEED;
+
+    FUNC_ENTER_STATIC
+
+    if(H5FD_subfiling_init() < 0)
+        HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to initialize subfiling VFD")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* H5FD__init_package() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_init
+ *
+ * Purpose:     Initialize this driver by registering the driver with the
+ *              library.
+ *
+ * Return:      Success:    The driver ID for the subfiling driver.
+ *              Failure:    Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+hid_t
+H5FD_subfiling_init(void)
+{
+    hid_t ret_value = H5I_INVALID_HID;          /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    if(H5I_VFL != H5I_get_type(H5FD_SUBFILING_g))
+        H5FD_SUBFILING_g = H5FD_register(&H5FD_subfiling_g, sizeof(H5FD_class_t), FALSE);
+
+    /* Set return value */
+    ret_value = H5FD_SUBFILING_g;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_init() */
+
+
+/*---------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_term
+ *
+ * Purpose:     Shut down the VFD
+ *
+ * Returns:     SUCCEED (Can't fail)
+ *
+ *---------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_term(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Reset VFL ID */
+    H5FD_SUBFILING_g = 0;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_subfiling_term() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_fapl_subfiling
+ *
+ * Purpose:     Sets the file access property list FAPL_ID to use the
+ *              subfiling driver.  New files have their address space
+ *              striped over NSUBFILES subfiles in stripes of STRIPE_SIZE
+ *              bytes (zero for either selects the default); existing files
+ *              are opened with the layout they were created with.
+ *              Requests that touch several subfiles are done on NTHREADS
+ *              worker threads, or on the calling thread if NTHREADS is
+ *              zero.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_fapl_subfiling(hid_t fapl_id, unsigned nsubfiles, hsize_t stripe_size,
+    unsigned nthreads)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    H5FD_subfiling_fapl_t fa;   /* Driver properties */
+    herr_t ret_value;
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE4("e", "iIuhIu", fapl_id, nsubfiles, stripe_size, nthreads);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(nsubfiles > H5FD_SUBFILING_MAX_SUBFILES)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "too many subfiles")
+    if(stripe_size > (hsize_t)MAXADDR)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "stripe size too large")
+
+    HDmemset(&fa, 0, sizeof(fa));
+    fa.nsubfiles = nsubfiles ? nsubfiles : H5FD_SUBFILING_NSUBFILES_DEF;
+    fa.stripe_size = stripe_size ? stripe_size : H5FD_SUBFILING_STRIPE_SIZE_DEF;
+    fa.nthreads = nthreads;
+
+    ret_value = H5P_set_driver(plist, H5FD_SUBFILING, &fa);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_fapl_subfiling() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_fapl_subfiling
+ *
+ * Purpose:     Returns information about the subfiling file access
+ *              property list though the function arguments.  For the
+ *              access property list of an open file, these are the
+ *              file's layout.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_fapl_subfiling(hid_t fapl_id, unsigned *nsubfiles/*out*/,
+    hsize_t *stripe_size/*out*/, unsigned *nthreads/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    const H5FD_subfiling_fapl_t *fa;    /* Driver properties */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE4("e", "ixxx", fapl_id, nsubfiles, stripe_size, nthreads);
+
+    if(NULL == (plist = H5P_object_verify(fapl_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a file access property list")
+    if(H5FD_SUBFILING != H5P_peek_driver(plist))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "incorrect VFL driver")
+    if(NULL == (fa = (const H5FD_subfiling_fapl_t *)H5P_peek_driver_info(plist)))
+        HGOTO_ERROR(H5E_PLIST, H5E_BADVALUE, FAIL, "bad VFL driver info")
+
+    if(nsubfiles)
+        *nsubfiles = fa->nsubfiles;
+    if(stripe_size)
+        *stripe_size = fa->stripe_size;
+    if(nthreads)
+        *nthreads = fa->nthreads;
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_fapl_subfiling() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_fapl_get
+ *
+ * Purpose:     Returns a file access property list which indicates how the
+ *              specified file is being accessed. The return list could be
+ *              used to access another file the same way.
+ *
+ * Return:      Success:    Ptr to new file access property list with all
+ *                          members copied from the file struct.
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_subfiling_fapl_get(H5FD_t *_file)
+{
+    H5FD_subfiling_t *file = (H5FD_subfiling_t *)_file;
+    void *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Set return value */
+    ret_value = H5FD_subfiling_fapl_copy(&(file->fa));
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_fapl_get() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_fapl_copy
+ *
+ * Purpose:     Copies the subfiling-specific file access properties.
+ *
+ * Return:      Success:    Ptr to a new property list
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FD_subfiling_fapl_copy(const void *_old_fa)
+{
+    const H5FD_subfiling_fapl_t *old_fa = (const H5FD_subfiling_fapl_t *)_old_fa;
+    H5FD_subfiling_fapl_t *new_fa = NULL;   /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(NULL != (new_fa = (H5FD_subfiling_fapl_t *)H5MM_malloc(sizeof(H5FD_subfiling_fapl_t))))
+        *new_fa = *old_fa;
+
+    FUNC_LEAVE_NOAPI(new_fa)
+} /* end H5FD_subfiling_fapl_copy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__subfiling_config
+ *
+ * Purpose:     If CREATE is set, writes FILE's layout to its (empty)
+ *              configuration file; otherwise reads the layout from the
+ *              configuration file into FILE.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__subfiling_config(H5FD_subfiling_t *file, hbool_t create)
+{
+    char        buf[H5FD_SUBFILING_CONFIG_BUF_SIZE];    /* Configuration text */
+    unsigned long long stripe_size;     /* Stripe size from file */
+    unsigned    nsubfiles;              /* Number of subfiles from file */
+    h5_posix_io_ret_t nio;              /* I/O return value */
+    int         len;                    /* Length of configuration text */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(file);
+
+    if(create) {
+        len = HDsnprintf(buf, sizeof(buf), H5FD_SUBFILING_CONFIG_FORMAT,
+                (unsigned long long)file->fa.stripe_size, file->fa.nsubfiles);
+        HDassert(len > 0 && (size_t)len < sizeof(buf));
+        if(HDlseek(file->fd, (HDoff_t)0, SEEK_SET) < 0)
+            HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to seek to start of configuration file")
+        do {
+            nio = HDwrite(file->fd, buf, (size_t)len);
+        } while(-1 == nio && EINTR == errno);
+        if(nio != (h5_posix_io_ret_t)len)
+            HSYS_GOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "unable to write configuration file")
+    } /* end if */
+    else {
+        if(HDlseek(file->fd, (HDoff_t)0, SEEK_SET) < 0)
+            HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to seek to start of configuration file")
+        do {
+            nio = HDread(file->fd, buf, sizeof(buf) - 1);
+        } while(-1 == nio && EINTR == errno);
+        if(nio < 0)
+            HSYS_GOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "unable to read configuration file")
+        buf[nio] = '\0';
+
+        if(2 != sscanf(buf, H5FD_SUBFILING_CONFIG_FORMAT, &stripe_size, &nsubfiles))
+            HGOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "not a subfiling configuration file: name = '%s'", file->filename)
+        if(0 == stripe_size || stripe_size > (unsigned long long)MAXADDR)
+            HGOTO_ERROR(H5E_FILE, H5E_BADVALUE, FAIL, "bad stripe size in configuration file: %llu", stripe_size)
+        if(0 == nsubfiles || nsubfiles > H5FD_SUBFILING_MAX_SUBFILES)
+            HGOTO_ERROR(H5E_FILE, H5E_BADVALUE, FAIL, "bad number of subfiles in configuration file: %u", nsubfiles)
+
+        file->fa.stripe_size = (hsize_t)stripe_size;
+        file->fa.nsubfiles = nsubfiles;
+    } /* end else */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__subfiling_config() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__subfiling_subfile_eof
+ *
+ * Purpose:     Returns the size of subfile SUBFILE when the file's address
+ *              space ends at EOA.
+ *
+ * Return:      The subfile size (can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD__subfiling_subfile_eof(const H5FD_subfiling_t *file, unsigned subfile,
+    haddr_t eoa)
+{
+    hsize_t     stripe_size = file->fa.stripe_size;     /* Stripe size */
+    hsize_t     n = file->fa.nsubfiles;                 /* Number of subfiles */
+    hsize_t     nfull = eoa / stripe_size;  /* Number of whole stripes */
+    hsize_t     rem = eoa % stripe_size;    /* Bytes in partial stripe */
+    haddr_t     ret_value;                  /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Whole stripes in the subfile */
+    ret_value = (nfull / n + ((nfull % n) > subfile ? 1 : 0)) * stripe_size;
+
+    /* The partial stripe at the end of the address space */
+    if(rem > 0 && (nfull % n) == subfile)
+        ret_value += rem;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__subfiling_subfile_eof() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_open
+ *
+ * Purpose:     Create and/or opens a striped file as an HDF5 file.  A new
+ *              (or truncated) file gets its layout from the file access
+ *              properties, which is recorded in the configuration file
+ *              NAME; otherwise the layout is read from the configuration
+ *              file.  All the subfiles are opened.
+ *
+ * Return:      Success:    A pointer to a new file data structure. The
+ *                          public fields will be initialized by the
+ *                          caller, which is always H5FD_open().
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FD_t *
+H5FD_subfiling_open(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
+{
+    H5FD_subfiling_t *file      = NULL;     /* subfiling VFD info       */
+    int             fd          = -1;       /* File descriptor          */
+    int             o_flags;                /* Flags for open() call    */
+    int             sub_flags;              /* Flags for subfiles       */
+    H5P_genplist_t  *plist;                 /* Property list pointer    */
+    const H5FD_subfiling_fapl_t *fa;        /* Driver properties        */
+    H5FD_subfiling_fapl_t default_fa;       /* Default driver properties */
+    char            *sub_name = NULL;       /* Name of a subfile        */
+    size_t          sub_name_len;           /* Size of subfile name buffer */
+    h5_stat_t       sb;
+    unsigned        u;                      /* Local index variable     */
+    H5FD_t          *ret_value = NULL;      /* Return value             */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Sanity check on file offsets */
+    HDcompile_assert(sizeof(HDoff_t) >= sizeof(size_t));
+
+    /* Check arguments */
+    if(!name || !*name)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, NULL, "invalid file name")
+    if(0 == maxaddr || HADDR_UNDEF == maxaddr)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADRANGE, NULL, "bogus maxaddr")
+    if(ADDR_OVERFLOW(maxaddr))
+        HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, NULL, "bogus maxaddr")
+
+    /* Get the driver specific information */
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(fapl_id)))
+        HGOTO_ERROR(H5E_VFL, H5E_BADTYPE, NULL, "not a file access property list")
+    if(NULL == (fa = (const H5FD_subfiling_fapl_t *)H5P_peek_driver_info(plist))) {
+        default_fa.nsubfiles = H5FD_SUBFILING_NSUBFILES_DEF;
+        default_fa.stripe_size = H5FD_SUBFILING_STRIPE_SIZE_DEF;
+        default_fa.nthreads = 0;
+        fa = &default_fa;
+    } /* end if */
+
+    /* Build the open flags */
+    o_flags = (H5F_ACC_RDWR & flags) ? O_RDWR : O_RDONLY;
+    if(H5F_ACC_TRUNC & flags)
+        o_flags |= O_TRUNC;
+    if(H5F_ACC_CREAT & flags)
+        o_flags |= O_CREAT;
+    if(H5F_ACC_EXCL & flags)
+        o_flags |= O_EXCL;
+
+    /* Open the configuration file */
+    if((fd = HDopen(name, o_flags, H5_POSIX_CREATE_MODE_RW)) < 0) {
+        int myerrno = errno;
+        HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to open file: name = '%s', errno = %d, error message = '%s', flags = %x, o_flags = %x", name, myerrno, HDstrerror(myerrno), flags, (unsigned)o_flags);
+    } /* end if */
+
+    if(HDfstat(fd, &sb) < 0)
+        HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, NULL, "unable to fstat file")
+
+    /* Create the new file struct */
+    if(NULL == (file = H5FL_CALLOC(H5FD_subfiling_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "unable to allocate file struct")
+
+    file->fd = fd;
+    fd = -1;
+    file->fa = *fa;
+    file->device = sb.st_dev;
+    file->inode = sb.st_ino;
+
+    /* Retain a copy of the name used to open the file, for possible error reporting */
+    HDstrncpy(file->filename, name, sizeof(file->filename));
+    file->filename[sizeof(file->filename) - 1] = '\0';
+
+    /* Record the layout of a new file, or read the layout of an existing
+     * one.  The subfiles of a new file are truncated.
+     */
+    sub_flags = o_flags & ~O_EXCL;
+    if(0 == sb.st_size && (H5F_ACC_RDWR & flags)) {
+        if(H5FD__subfiling_config(file, TRUE) < 0)
+            HGOTO_ERROR(H5E_FILE, H5E_CANTINIT, NULL, "unable to write subfiling configuration")
+        sub_flags |= O_CREAT | O_TRUNC;
+    } /* end if */
+    else if(H5FD__subfiling_config(file, FALSE) < 0)
+        HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to read subfiling configuration")
+
+    /* Open the subfiles */
+    if(NULL == (file->subfile_fds = (int *)H5MM_malloc(file->fa.nsubfiles * sizeof(int))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate subfile descriptors")
+    for(u = 0; u < file->fa.nsubfiles; u++)
+        file->subfile_fds[u] = -1;
+    sub_name_len = HDstrlen(name) + 32;
+    if(NULL == (sub_name = (char *)H5MM_malloc(sub_name_len)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate subfile name")
+    file->eof = 0;
+    for(u = 0; u < file->fa.nsubfiles; u++) {
+        HDsnprintf(sub_name, sub_name_len, H5FD_SUBFILING_NAME_FORMAT, name, u);
+        if((file->subfile_fds[u] = HDopen(sub_name, sub_flags, H5_POSIX_CREATE_MODE_RW)) < 0) {
+            int myerrno = errno;
+            HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "unable to open subfile: name = '%s', errno = %d, error message = '%s'", sub_name, myerrno, HDstrerror(myerrno));
+        } /* end if */
+
+        /* The end of file is the highest address in any subfile */
+        if(HDfstat(file->subfile_fds[u], &sb) < 0)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, NULL, "unable to fstat subfile")
+        if(sb.st_size > 0) {
+            hsize_t sub_size = (hsize_t)sb.st_size;     /* Size of subfile */
+            hsize_t last = (sub_size - 1) / file->fa.stripe_size;  /* Last stripe in subfile */
+            haddr_t sub_eof;                            /* Last address in subfile */
+
+            sub_eof = (last * file->fa.nsubfiles + u) * file->fa.stripe_size +
+                    (sub_size - last * file->fa.stripe_size);
+            file->eof = MAX(file->eof, sub_eof);
+        } /* end if */
+    } /* end for */
+
+    /* Set up the per-subfile tasks and the worker threads */
+    if(NULL == (file->io = (H5FD_subfiling_io_t *)H5MM_calloc(file->fa.nsubfiles * sizeof(H5FD_subfiling_io_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, NULL, "unable to allocate subfile tasks")
+    for(u = 0; u < file->fa.nsubfiles; u++) {
+        file->io[u].file = file;
+        file->io[u].subfile = u;
+    } /* end for */
+    if(file->fa.nthreads > 1 && file->fa.nsubfiles > 1)
+        if(NULL == (file->tp = H5TP_create(MIN(file->fa.nthreads, file->fa.nsubfiles))))
+            HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, NULL, "unable to create worker threads")
+
+    /* Set return value */
+    ret_value = (H5FD_t*)file;
+
+done:
+    H5MM_xfree(sub_name);
+    if(NULL == ret_value) {
+        if(fd >= 0)
+            HDclose(fd);
+        if(file) {
+            if(file->tp)
+                H5TP_close(file->tp);
+            if(file->subfile_fds)
+                for(u = 0; u < file->fa.nsubfiles; u++)
+                    if(file->subfile_fds[u] >= 0)
+                        HDclose(file->subfile_fds[u]);
+            H5MM_xfree(file->subfile_fds);
+            H5MM_xfree(file->io);
+            HDclose(file->fd);
+            file = H5FL_FREE(H5FD_subfiling_t, file);
+        } /* end if */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_open() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_close
+ *
+ * Purpose:     Closes an HDF5 file, its subfiles and its worker threads.
+ *
+ * Return:      Success:    SUCCEED
+ *              Failure:    FAIL, file not closed.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_close(H5FD_t *_file)
+{
+    H5FD_subfiling_t *file = (H5FD_subfiling_t *)_file;
+    unsigned    u;                          /* Local index variable */
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    /* Sanity check */
+    HDassert(file);
+
+    /* Stop the worker threads */
+    if(file->tp && H5TP_close(file->tp) < 0)
+        HDONE_ERROR(H5E_VFL, H5E_CANTCLOSEOBJ, FAIL, "unable to stop worker threads")
+
+    /* Close the subfiles and the configuration file */
+    for(u = 0; u < file->fa.nsubfiles; u++)
+        if(HDclose(file->subfile_fds[u]) < 0)
+            HSYS_DONE_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to close subfile")
+    if(HDclose(file->fd) < 0)
+        HSYS_DONE_ERROR(H5E_IO, H5E_CANTCLOSEFILE, FAIL, "unable to close file")
+
+    /* Release the file info */
+    H5MM_xfree(file->subfile_fds);
+    H5MM_xfree(file->io);
+    file = H5FL_FREE(H5FD_subfiling_t, file);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_close() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_cmp
+ *
+ * Purpose:     Compares two files belonging to this driver using an
+ *              arbitrary (but consistent) ordering.
+ *
+ * Return:      Success:    A value like strcmp()
+ *              Failure:    never fails (arguments were checked by the
+ *                          caller).
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+H5FD_subfiling_cmp(const H5FD_t *_f1, const H5FD_t *_f2)
+{
+    const H5FD_subfiling_t  *f1 = (const H5FD_subfiling_t *)_f1;
+    const H5FD_subfiling_t  *f2 = (const H5FD_subfiling_t *)_f2;
+    int ret_value = 0;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+#ifdef H5_DEV_T_IS_SCALAR
+    if(f1->device < f2->device) HGOTO_DONE(-1)
+    if(f1->device > f2->device) HGOTO_DONE(1)
+#else /* H5_DEV_T_IS_SCALAR */
+    /* If dev_t isn't a scalar value on this system, just use memcmp to
+     * determine if the values are the same or not.  The actual return value
+     * shouldn't really matter...
+     */
+    if(HDmemcmp(&(f1->device),&(f2->device),sizeof(dev_t)) < 0) HGOTO_DONE(-1)
+    if(HDmemcmp(&(f1->device),&(f2->device),sizeof(dev_t)) > 0) HGOTO_DONE(1)
+#endif /* H5_DEV_T_IS_SCALAR */
+    if(f1->inode < f2->inode) HGOTO_DONE(-1)
+    if(f1->inode > f2->inode) HGOTO_DONE(1)
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_cmp() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_query
+ *
+ * Purpose:     Set the flags that this VFL driver is capable of supporting.
+ *              (listed in H5FDpublic.h)
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_query(const H5FD_t H5_ATTR_UNUSED *_file, unsigned long *flags /* out */)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Set the VFL feature flags that this driver supports */
+    if(flags) {
+        *flags = 0;
+        *flags |= H5FD_FEAT_AGGREGATE_METADATA;     /* OK to aggregate metadata allocations                             */
+        *flags |= H5FD_FEAT_ACCUMULATE_METADATA;    /* OK to accumulate metadata for faster writes                      */
+        *flags |= H5FD_FEAT_DATA_SIEVE;             /* OK to perform data sieving for faster raw data reads & writes    */
+        *flags |= H5FD_FEAT_AGGREGATE_SMALLDATA;    /* OK to aggregate "small" raw data allocations                     */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_subfiling_query() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_get_eoa
+ *
+ * Purpose:     Gets the end-of-address marker for the file. The EOA marker
+ *              is the first address past the last byte allocated in the
+ *              format address space.
+ *
+ * Return:      The end-of-address marker.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_subfiling_get_eoa(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_subfiling_t  *file = (const H5FD_subfiling_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eoa)
+} /* end H5FD_subfiling_get_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_set_eoa
+ *
+ * Purpose:     Set the end-of-address marker for the file. This function is
+ *              called shortly after an existing HDF5 file is opened in order
+ *              to tell the driver where the end of the HDF5 data is located.
+ *
+ * Return:      SUCCEED (Can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_set_eoa(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, haddr_t addr)
+{
+    H5FD_subfiling_t    *file = (H5FD_subfiling_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    file->eoa = addr;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5FD_subfiling_set_eoa() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_get_eof
+ *
+ * Purpose:     Returns the end-of-file marker, the first address past the
+ *              highest address stored in any of the subfiles.
+ *
+ * Return:      End of file address.
+ *
+ *-------------------------------------------------------------------------
+ */
+static haddr_t
+H5FD_subfiling_get_eof(const H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type)
+{
+    const H5FD_subfiling_t  *file = (const H5FD_subfiling_t *)_file;
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    FUNC_LEAVE_NOAPI(file->eof)
+} /* end H5FD_subfiling_get_eof() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:       H5FD_subfiling_get_handle
+ *
+ * Purpose:        Returns the file handle of the subfiling driver's
+ *                 configuration file.
+ *
+ * Returns:        SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_get_handle(H5FD_t *_file, hid_t H5_ATTR_UNUSED fapl, void **file_handle)
+{
+    H5FD_subfiling_t    *file = (H5FD_subfiling_t *)_file;
+    herr_t              ret_value = SUCCEED;
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(!file_handle)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "file handle not valid")
+
+    *file_handle = &(file->fd);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_get_handle() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__subfiling_io_cb
+ *
+ * Purpose:     Does the parts of a task's requests which are stored in the
+ *              task's subfile.  Parts of reads past the end of the subfile
+ *              are filled with zeros.  Runs on a worker thread, so errors
+ *              are only recorded in the task, for the caller to report.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__subfiling_io_cb(void *_io)
+{
+    H5FD_subfiling_io_t *io = (H5FD_subfiling_io_t *)_io;  /* Task */
+    const H5FD_subfiling_t *file = io->file;    /* File for task */
+    hsize_t     stripe_size = file->fa.stripe_size;     /* Stripe size */
+    hsize_t     n = file->fa.nsubfiles;                 /* Number of subfiles */
+    int         fd = file->subfile_fds[io->subfile];    /* Subfile descriptor */
+    size_t      r;                          /* Local index variable */
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    io->err = 0;
+    for(r = 0; r < io->count && 0 == io->err; r++) {
+        haddr_t     addr = io->addrs[r];            /* Request address */
+        haddr_t     end = addr + io->sizes[r];      /* End of request */
+        hsize_t     first, last, s;                 /* Stripe indices */
+
+        if(0 == io->sizes[r])
+            continue;
+
+        /* The first stripe of the request in this subfile */
+        first = addr / stripe_size;
+        last = (end - 1) / stripe_size;
+        s = first + (io->subfile + n - first % n) % n;
+
+        for(/* s */; s <= last && 0 == io->err; s += n) {
+            haddr_t     start = MAX(addr, s * stripe_size);         /* Start of piece */
+            size_t      size = (size_t)(MIN(end, (s + 1) * stripe_size) - start);   /* Size of piece */
+            HDoff_t     off = (HDoff_t)((s / n) * stripe_size + (start - s * stripe_size));  /* Offset in subfile */
+            unsigned char *buf = (unsigned char *)io->bufs[r] + (start - addr);     /* Piece buffer */
+
+            while(size > 0) {
+                h5_posix_io_t       bytes_in;   /* # of bytes to transfer */
+                h5_posix_io_ret_t   nio;        /* # of bytes transferred */
+
+                bytes_in = (h5_posix_io_t)MIN(size, H5_POSIX_MAX_IO_BYTES);
+                do {
+#if defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE)
+                    if(io->write)
+                        nio = HDpwrite(fd, buf, bytes_in, off);
+                    else
+                        nio = HDpread(fd, buf, bytes_in, off);
+#else /* defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE) */
+                    /* Only this task uses the subfile's descriptor */
+                    if(HDlseek(fd, off, SEEK_SET) < 0)
+                        nio = -1;
+                    else if(io->write)
+                        nio = HDwrite(fd, buf, bytes_in);
+                    else
+                        nio = HDread(fd, buf, bytes_in);
+#endif /* defined(H5_HAVE_PREAD) && defined(H5_HAVE_PWRITE) */
+                } while(-1 == nio && EINTR == errno);
+
+                if(nio < 0) {
+                    io->err = errno;
+                    break;
+                } /* end if */
+                if(0 == nio) {
+                    if(io->write) {
+                        io->err = EIO;
+                        break;
+                    } /* end if */
+
+                    /* end of subfile but not end of format address space */
+                    HDmemset(buf, 0, size);
+                    break;
+                } /* end if */
+
+                size -= (size_t)nio;
+                off += (HDoff_t)nio;
+                buf += nio;
+            } /* end while */
+        } /* end for */
+    } /* end for */
+
+    if(io->err)
+        ret_value = FAIL;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__subfiling_io_cb() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD__subfiling_io
+ *
+ * Purpose:     Reads or writes COUNT requests, with one task for each
+ *              subfile that the requests touch.  With worker threads, the
+ *              tasks run concurrently; otherwise one after another.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD__subfiling_io(H5FD_subfiling_t *file, hbool_t write, size_t count,
+    const haddr_t addrs[], const size_t sizes[], void *bufs[])
+{
+    hsize_t     stripe_size = file->fa.stripe_size;     /* Stripe size */
+    unsigned    n = file->fa.nsubfiles;                 /* Number of subfiles */
+    hbool_t     *touched = NULL;        /* Subfiles touched by requests */
+    unsigned    ntouched = 0;           /* # of subfiles touched */
+    hbool_t     submitted = FALSE;      /* Whether tasks were submitted */
+    size_t      r;                      /* Local index variable */
+    unsigned    u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(file);
+
+    /* Check for overflow conditions */
+    for(r = 0; r < count; r++) {
+        if(!H5F_addr_defined(addrs[r]))
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "addr undefined, addr = %llu", (unsigned long long)addrs[r])
+        if(REGION_OVERFLOW(addrs[r], sizes[r]))
+            HGOTO_ERROR(H5E_ARGS, H5E_OVERFLOW, FAIL, "addr overflow, addr = %llu, size = %llu", (unsigned long long)addrs[r], (unsigned long long)sizes[r])
+    } /* end for */
+
+    /* Find the subfiles touched by the requests */
+    if(NULL == (touched = (hbool_t *)H5MM_calloc(n * sizeof(hbool_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTALLOC, FAIL, "unable to allocate subfile flags")
+    for(r = 0; r < count && ntouched < n; r++) {
+        hsize_t first, last, s;         /* Stripe indices */
+
+        if(0 == sizes[r])
+            continue;
+        first = addrs[r] / stripe_size;
+        last = (addrs[r] + sizes[r] - 1) / stripe_size;
+        for(s = first; s <= last && s < first + n; s++)
+            if(!touched[s % n]) {
+                touched[s % n] = TRUE;
+                ntouched++;
+            } /* end if */
+    } /* end for */
+
+    /* Set up the tasks, and run them */
+    for(u = 0; u < n; u++) {
+        H5FD_subfiling_io_t *io = &file->io[u];
+
+        if(!touched[u])
+            continue;
+
+        io->write = write;
+        io->count = count;
+        io->addrs = addrs;
+        io->sizes = sizes;
+        io->bufs = bufs;
+        io->err = 0;
+        if(file->tp && ntouched > 1) {
+            if(H5TP_submit(file->tp, &io->task, H5FD__subfiling_io_cb, io) < 0)
+                HGOTO_ERROR(H5E_VFL, H5E_CANTINIT, FAIL, "unable to submit subfile I/O")
+            submitted = TRUE;
+        } /* end if */
+        else
+            H5FD__subfiling_io_cb(io);
+    } /* end for */
+
+done:
+    /* Wait for the tasks that were submitted, even after an error, since
+     * they use the caller's buffers
+     */
+    if(submitted && H5TP_wait(file->tp) < 0)
+        HDONE_ERROR(H5E_VFL, H5E_CANTWAIT, FAIL, "unable to wait for subfile I/O")
+
+    /* Report the first failure */
+    if(touched && ret_value >= 0)
+        for(u = 0; u < n; u++)
+            if(touched[u] && file->io[u].err) {
+                int myerrno = file->io[u].err;
+
+                if(write)
+                    HDONE_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "subfile write failed: filename = '%s', subfile = %u, errno = %d, error message = '%s'", file->filename, u, myerrno, HDstrerror(myerrno))
+                else
+                    HDONE_ERROR(H5E_IO, H5E_READERROR, FAIL, "subfile read failed: filename = '%s', subfile = %u, errno = %d, error message = '%s'", file->filename, u, myerrno, HDstrerror(myerrno))
+                break;
+            } /* end if */
+
+    /* Update eof after writes */
+    if(write && ret_value >= 0)
+        for(r = 0; r < count; r++)
+            if(sizes[r] > 0 && addrs[r] + sizes[r] > file->eof)
+                file->eof = addrs[r] + sizes[r];
+
+    H5MM_xfree(touched);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD__subfiling_io() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_read
+ *
+ * Purpose:     Reads SIZE bytes of data from FILE beginning at address ADDR
+ *              into buffer BUF.
+ *
+ * Return:      Success:    SUCCEED. Result is stored in caller-supplied
+ *                          buffer BUF.
+ *              Failure:    FAIL, Contents of buffer BUF are undefined.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_read(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id,
+    haddr_t addr, size_t size, void *buf /*out*/)
+{
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(buf);
+
+    if(H5FD__subfiling_io((H5FD_subfiling_t *)_file, FALSE, (size_t)1, &addr, &size, &buf) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "file read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_read() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_write
+ *
+ * Purpose:     Writes SIZE bytes of data to FILE beginning at address ADDR
+ *              from buffer BUF.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_write(H5FD_t *_file, H5FD_mem_t H5_ATTR_UNUSED type, hid_t H5_ATTR_UNUSED dxpl_id,
+    haddr_t addr, size_t size, const void *buf)
+{
+    void        *wbuf = (void *)((uintptr_t)buf);   /* Unconst buffer; only read from */
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(buf);
+
+    if(H5FD__subfiling_io((H5FD_subfiling_t *)_file, TRUE, (size_t)1, &addr, &size, &wbuf) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "file write failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_write() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_read_vector
+ *
+ * Purpose:     Performs COUNT reads from FILE, with the parts in each
+ *              subfile done by one task.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_read_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], void *bufs[])
+{
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD__subfiling_io((H5FD_subfiling_t *)_file, FALSE, count, addrs, sizes, bufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "vector read failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_write_vector
+ *
+ * Purpose:     Performs COUNT writes to FILE, with the parts in each
+ *              subfile done by one task.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_write_vector(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, size_t count,
+    const H5FD_mem_t H5_ATTR_UNUSED types[], const haddr_t addrs[],
+    const size_t sizes[], const void *bufs[])
+{
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    if(H5FD__subfiling_io((H5FD_subfiling_t *)_file, TRUE, count, addrs, sizes, (void **)((uintptr_t)bufs)) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "vector write failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_write_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_truncate
+ *
+ * Purpose:     Makes sure that the true file size is the same as the
+ *              end-of-allocation, by setting each subfile to the size it
+ *              has for that address space.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_truncate(H5FD_t *_file, hid_t H5_ATTR_UNUSED dxpl_id, hbool_t H5_ATTR_UNUSED closing)
+{
+    H5FD_subfiling_t *file = (H5FD_subfiling_t *)_file;
+    unsigned    u;                          /* Local index variable */
+    herr_t      ret_value = SUCCEED;        /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    if(!H5F_addr_eq(file->eoa, file->eof)) {
+        for(u = 0; u < file->fa.nsubfiles; u++)
+            if(-1 == HDftruncate(file->subfile_fds[u], (HDoff_t)H5FD__subfiling_subfile_eof(file, u, file->eoa)))
+                HSYS_GOTO_ERROR(H5E_IO, H5E_SEEKERROR, FAIL, "unable to extend subfile properly")
+
+        /* Update the eof value */
+        file->eof = file->eoa;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_truncate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_lock
+ *
+ * Purpose:     To place an advisory lock on the configuration file.
+ *		The lock type to apply depends on the parameter "rw":
+ *			TRUE--opens for write: an exclusive lock
+ *			FALSE--opens for read: a shared lock
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_lock(H5FD_t *_file, hbool_t rw)
+{
+    H5FD_subfiling_t *file = (H5FD_subfiling_t *)_file;    /* VFD file struct */
+    int lock_flags;                             /* file locking flags       */
+    herr_t ret_value = SUCCEED;                 /* Return value             */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    /* Set exclusive or shared lock based on rw status */
+    lock_flags = rw ? LOCK_EX : LOCK_SH;
+
+    /* Place a non-blocking lock on the file */
+    if(HDflock(file->fd, lock_flags | LOCK_NB) < 0) {
+        if(ENOSYS == errno)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "file locking disabled on this file system (use HDF5_USE_FILE_LOCKING environment variable to override)")
+        else
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "unable to lock file")
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_lock() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5FD_subfiling_unlock
+ *
+ * Purpose:     To remove the existing lock on the configuration file
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FD_subfiling_unlock(H5FD_t *_file)
+{
+    H5FD_subfiling_t *file = (H5FD_subfiling_t *)_file;    /* VFD file struct */
+    herr_t ret_value = SUCCEED;                 /* Return value             */
+
+    FUNC_ENTER_NOAPI_NOINIT
+
+    HDassert(file);
+
+    if(HDflock(file->fd, LOCK_UN) < 0) {
+        if(ENOSYS == errno)
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "file locking disabled on this file system (use HDF5_USE_FILE_LOCKING environment variable to override)")
+        else
+            HSYS_GOTO_ERROR(H5E_FILE, H5E_BADFILE, FAIL, "unable to unlock file")
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FD_subfiling_unlock() */
+
@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The public header file for the subfiling driver, which
+ *              stripes the HDF5 address space over several subfiles.
+ */
+#ifndef H5FDsubfiling_H
+#define H5FDsubfiling_H
+
+#define H5FD_SUBFILING	(H5FD_subfiling_init())
+
+/* Defaults and limits for H5Pset_fapl_subfiling */
+#define H5FD_SUBFILING_STRIPE_SIZE_DEF  (1024 * 1024)
+#define H5FD_SUBFILING_NSUBFILES_DEF    4
+#define H5FD_SUBFILING_MAX_SUBFILES     1024
+
+/* The file named when the file is opened is a small text configuration
+ * file, in this format, with the stripe size and the number of subfiles.
+ * Subfile I of file NAME is named as by the format
+ * H5FD_SUBFILING_NAME_FORMAT, with NAME and I as arguments.  Stripe S
+ * of the address space is in subfile S % N, at offset (S / N) * stripe
+ * size, for N subfiles.
+ */
+#define H5FD_SUBFILING_CONFIG_FORMAT    "HDF5 subfiling configuration\nstripe_size %llu\nsubfile_count %u\n"
+#define H5FD_SUBFILING_NAME_FORMAT      "%s.subfile.%u"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+H5_DLL hid_t H5FD_subfiling_init(void);
+H5_DLL herr_t H5Pset_fapl_subfiling(hid_t fapl_id, unsigned nsubfiles,
+			  hsize_t stripe_size, unsigned nthreads);
+H5_DLL herr_t H5Pget_fapl_subfiling(hid_t fapl_id, unsigned *nsubfiles/*out*/,
+			  hsize_t *stripe_size/*out*/, unsigned *nthreads/*out*/);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -21,8 +21,16 @@
  *      of block is allocated and freed repeatedly in a loop, while writing out
  *      chunked data for example, but the blocks may also be of different sizes
  *      from different datasets and an attempt is made to optimize access to
- *      the proper free list of blocks by using these priority queues to
- *      move frequently accessed free lists to the head of the queue.
+ *      the proper free list of blocks by indexing the free lists of each
+ *      queue by block size.
+ *
+ *      In threadsafe builds, each thread keeps a small cache (a "magazine")
+ *      of blocks for each regular, array and block free list it uses, so
+ *      most allocations and frees don't touch the global free lists, which
+ *      are protected by a mutex.  Memory in the threads' caches is counted
+ *      against the global free list limits (as of each thread's last trip
+ *      to the global lists), and garbage collection or exceeding a limit
+ *      makes every thread return its cached blocks to the global lists.
  */
 
 #include "H5FLmodule.h"         /* This source code file is part of the H5FL module */
@@ -129,13 +137,122 @@ static H5FL_fac_gc_list_t H5FL_fac_gc_head={0,NULL};
 static H5FL_track_t *H5FL_out_head_g = NULL;
 #endif /* H5FL_TRACK */
 
+/* Initial number of buckets in the size index of a block free list */
+#define H5FL_BLK_INDEX_INIT     16
+
+/* Bucket in a block free list's index (of N buckets, a power of 2) for blocks of size S */
+#define H5FL_BLK_HASH(S, N)     (((S) ^ ((S) >> 3) ^ ((S) >> 10)) & ((N) - 1))
+
+/* Per-thread caches need thread-local storage and aren't used while
+ * allocations are being tracked.  Without them, the free lists are only
+ * used with the library lock held, as before.
+ */
+#if defined(H5_HAVE_THREADSAFE) && !defined(H5_HAVE_WIN_THREADS) && !defined(H5FL_TRACK)
+#define H5FL_HAVE_THREAD_CACHE
+#endif
+
+#ifdef H5FL_HAVE_THREAD_CACHE
+
+/* Limits on the blocks held in threads' caches */
+#define H5FL_TC_MAG_SIZE    16              /* Blocks in each magazine */
+#define H5FL_TC_MAG_MEM     (64 * 1024)     /* Memory in each magazine */
+#define H5FL_TC_MEM         (256 * 1024)    /* Memory in a thread's cache */
+
+/* Kinds of free lists with magazines in threads' caches */
+typedef enum H5FL_tc_kind_t {
+    H5FL_TC_REG = 0,            /* "Regular" free list */
+    H5FL_TC_ARR,                /* "Array" free list */
+    H5FL_TC_BLK,                /* "Block" free list */
+    H5FL_TC_NKINDS              /* Number of kinds (must be last) */
+} H5FL_tc_kind_t;
+
+/* A thread's cache of blocks for one free list */
+typedef struct H5FL_tc_mag_t {
+    H5FL_tc_kind_t kind;        /* Kind of free list */
+    void *head;                 /* The free list the blocks belong to */
+    unsigned nblocks;           /* Number of blocks in the magazine */
+    size_t mem;                 /* Memory in the magazine's blocks */
+    void *blocks[H5FL_TC_MAG_SIZE];     /* Blocks (array & block lists: their headers) */
+    size_t keys[H5FL_TC_MAG_SIZE];      /* Array lists: # of elements, block lists: size */
+    size_t mems[H5FL_TC_MAG_SIZE];      /* Memory in each block */
+} H5FL_tc_mag_t;
+
+/* A thread's cache of blocks */
+typedef struct H5FL_tc_t {
+    size_t nmags;               /* Size of the magazine array */
+    H5FL_tc_mag_t **mags;       /* Magazines, indexed by the free lists' "tc_index" */
+    size_t mem[H5FL_TC_NKINDS];         /* Memory cached, by kind of free list */
+    size_t published[H5FL_TC_NKINDS];  /* Memory cached, as last counted globally */
+    size_t total_mem;           /* Memory cached in all magazines */
+    unsigned epoch;             /* Garbage collection epoch the cache is up to date with */
+    hbool_t flushing;           /* Whether the cache is being flushed */
+    struct H5FL_tc_t *next;     /* Next thread's cache */
+    struct H5FL_tc_t *prev;     /* Previous thread's cache */
+} H5FL_tc_t;
+
+/* Mutex protecting the global free lists, and the key for threads' caches */
+static pthread_once_t H5FL_tc_once_g = PTHREAD_ONCE_INIT;
+static pthread_mutex_t H5FL_mutex_g;
+static pthread_key_t H5FL_tc_key_g;
+static hbool_t H5FL_tc_key_valid_g = FALSE;
+
+/* Caches of all the threads, and the memory they held when last counted */
+static H5FL_tc_t *H5FL_tc_head_g = NULL;
+static size_t H5FL_tc_mem_g[H5FL_TC_NKINDS] = {0, 0, 0};
+
+/* Number of free lists given magazines so far */
+static unsigned H5FL_tc_nlists_g = 0;
+
+/* Bumped to make every thread flush its cache before using it again */
+static volatile unsigned H5FL_tc_epoch_g = 0;
+
+/* Stands in for the cache of a thread whose cache is being destroyed */
+static H5FL_tc_t H5FL_tc_dead_g;
+
+#define H5FL_LOCK           H5FL__lock();
+#define H5FL_UNLOCK         (void)pthread_mutex_unlock(&H5FL_mutex_g);
+#define H5FL_TC_MEM_KIND(K) (H5FL_tc_mem_g[K])
+#define H5FL_TC_RECLAIM     H5FL__tc_reclaim();
+
+#else /* H5FL_HAVE_THREAD_CACHE */
+#define H5FL_LOCK
+#define H5FL_UNLOCK
+#define H5FL_TC_MEM_KIND(K) ((size_t)0)
+#define H5FL_TC_RECLAIM
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
 /* Forward declarations of local static functions */
+#ifdef H5FL_HAVE_THREAD_CACHE
+static void H5FL__tc_once(void);
+static void H5FL__lock(void);
+static void H5FL__tc_destroy(void *_tc);
+static H5FL_tc_t *H5FL__tc_get(void);
+static H5FL_tc_mag_t *H5FL__tc_mag(H5FL_tc_t *tc, H5FL_tc_kind_t kind, void *head,
+    unsigned tc_index);
+static void H5FL__tc_publish(H5FL_tc_t *tc);
+static herr_t H5FL__tc_flush_mag(H5FL_tc_t *tc, H5FL_tc_mag_t *mag);
+static herr_t H5FL__tc_check_mag(const H5FL_tc_mag_t *mag);
+static herr_t H5FL__tc_flush(H5FL_tc_t *tc);
+static void H5FL__tc_reclaim(void);
+static void *H5FL__tc_take(H5FL_tc_kind_t kind, void *head, unsigned tc_index,
+    size_t key, size_t list_lim);
+static htri_t H5FL__tc_keep(H5FL_tc_kind_t kind, void *head, unsigned tc_index,
+    void *block, size_t key, size_t mem, size_t list_lim);
+static hbool_t H5FL__tc_avail(H5FL_tc_kind_t kind, unsigned tc_index, size_t key);
+static void H5FL__tc_term(void);
+#endif /* H5FL_HAVE_THREAD_CACHE */
+static void H5FL__reg_push(H5FL_reg_head_t *head, void *obj);
+static herr_t H5FL__reg_check(H5FL_reg_head_t *head);
 static herr_t H5FL__reg_gc(void);
 static herr_t H5FL__reg_gc_list(H5FL_reg_head_t *head);
 static int H5FL__reg_term(void);
+static void H5FL__arr_push(H5FL_arr_head_t *head, H5FL_arr_list_t *temp);
+static herr_t H5FL__arr_check(H5FL_arr_head_t *head);
 static herr_t H5FL__arr_gc(void);
 static herr_t H5FL__arr_gc_list(H5FL_arr_head_t *head);
 static int H5FL__arr_term(void);
+static herr_t H5FL__blk_push(H5FL_blk_head_t *head, H5FL_blk_list_t *temp);
+static herr_t H5FL__blk_check(H5FL_blk_head_t *head);
 static herr_t H5FL__blk_gc(void);
 static herr_t H5FL__blk_gc_list(H5FL_blk_head_t *head);
 static int H5FL__blk_term(void);
@@ -180,6 +297,15 @@ H5FL_term_package(void)
     FUNC_ENTER_NOAPI_NOINIT_NOERR
 
     if(H5_PKG_INIT_VAR) {
+        /* Report on the free lists, if requested */
+        if(H5DEBUG(MM))
+            (void)H5FL_print_stats(H5DEBUG(MM));
+
+#ifdef H5FL_HAVE_THREAD_CACHE
+        /* Return the blocks in all threads' caches to the free lists */
+        H5FL__tc_term();
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
         /* Garbage collect any nodes on the free lists */
         (void)H5FL_garbage_coll();
 
@@ -254,6 +380,616 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_malloc() */
 
+
+#ifdef H5FL_HAVE_THREAD_CACHE
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_once
+ *
+ * Purpose:	Creates the mutex protecting the global free lists and the
+ *      key for threads' caches.  Called once, by whichever thread uses the
+ *      free lists first.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__tc_once(void)
+{
+    pthread_mutexattr_t attr;       /* Mutex attributes */
+
+    /* The free list routines call each other (and garbage collection) with
+     * the mutex held, so it's recursive */
+    (void)pthread_mutexattr_init(&attr);
+    (void)pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    (void)pthread_mutex_init(&H5FL_mutex_g, &attr);
+    (void)pthread_mutexattr_destroy(&attr);
+
+    /* Without a key, threads just use the global free lists */
+    if(0 == pthread_key_create(&H5FL_tc_key_g, H5FL__tc_destroy))
+        H5FL_tc_key_valid_g = TRUE;
+} /* end H5FL__tc_once() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__lock
+ *
+ * Purpose:	Locks the global free lists.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__lock(void)
+{
+    (void)pthread_once(&H5FL_tc_once_g, H5FL__tc_once);
+    (void)pthread_mutex_lock(&H5FL_mutex_g);
+} /* end H5FL__lock() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_destroy
+ *
+ * Purpose:	Returns the blocks in an exiting thread's cache to the global
+ *      free lists and releases the cache.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__tc_destroy(void *_tc)
+{
+    H5FL_tc_t *tc = (H5FL_tc_t *)_tc;   /* The thread's cache */
+    size_t u;                           /* Local index variable */
+
+    if(tc == &H5FL_tc_dead_g)
+        return;
+
+    /* Don't let the free list routines give the thread a new cache while
+     * this one is flushed */
+    (void)H5TS_set_thread_local_value(H5FL_tc_key_g, &H5FL_tc_dead_g);
+
+    H5FL_LOCK
+    (void)H5FL__tc_flush(tc);
+    H5FL__tc_publish(tc);
+    if(tc->prev)
+        tc->prev->next = tc->next;
+    else
+        H5FL_tc_head_g = tc->next;
+    if(tc->next)
+        tc->next->prev = tc->prev;
+    H5FL_UNLOCK
+
+    for(u = 0; u < tc->nmags; u++)
+        H5MM_xfree(tc->mags[u]);
+    H5MM_xfree(tc->mags);
+    H5MM_xfree(tc);
+} /* end H5FL__tc_destroy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_get
+ *
+ * Purpose:	Gets the calling thread's cache, creating it if needed.  If
+ *      the caches have been told to return their blocks since the thread
+ *      last used its cache, the cache is flushed first.
+ *
+ * Return:	Success:	The thread's cache
+ *		Failure:	NULL (the global free lists should be used)
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FL_tc_t *
+H5FL__tc_get(void)
+{
+    H5FL_tc_t *tc;              /* The thread's cache */
+    H5FL_tc_t *ret_value = NULL;    /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    (void)pthread_once(&H5FL_tc_once_g, H5FL__tc_once);
+    if(!H5FL_tc_key_valid_g)
+        HGOTO_DONE(NULL)
+
+    if(NULL == (tc = (H5FL_tc_t *)H5TS_get_thread_local_value(H5FL_tc_key_g))) {
+        if(NULL == (tc = (H5FL_tc_t *)H5MM_calloc(sizeof(H5FL_tc_t))))
+            HGOTO_DONE(NULL)
+        if(H5TS_set_thread_local_value(H5FL_tc_key_g, tc)) {
+            H5MM_xfree(tc);
+            HGOTO_DONE(NULL)
+        } /* end if */
+
+        /* Add the cache to the list of caches */
+        H5FL_LOCK
+        tc->epoch = H5FL_tc_epoch_g;
+        tc->next = H5FL_tc_head_g;
+        if(tc->next)
+            tc->next->prev = tc;
+        H5FL_tc_head_g = tc;
+        H5FL_UNLOCK
+    } /* end if */
+    else if(tc == &H5FL_tc_dead_g)
+        HGOTO_DONE(NULL)
+    else if(tc->epoch != H5FL_tc_epoch_g && !tc->flushing) {
+        H5FL_LOCK
+        (void)H5FL__tc_flush(tc);
+        H5FL_UNLOCK
+    } /* end if */
+
+    ret_value = tc;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_get() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_mag
+ *
+ * Purpose:	Gets the magazine for a free list in a thread's cache,
+ *      creating it if needed.
+ *
+ * Return:	Success:	The magazine
+ *		Failure:	NULL (the global free list should be used)
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5FL_tc_mag_t *
+H5FL__tc_mag(H5FL_tc_t *tc, H5FL_tc_kind_t kind, void *head, unsigned tc_index)
+{
+    H5FL_tc_mag_t *mag;         /* The list's magazine */
+    H5FL_tc_mag_t *ret_value = NULL;    /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Lists get an index when they're initialized */
+    if(0 == tc_index)
+        HGOTO_DONE(NULL)
+
+    /* Extend the array of magazines, if needed */
+    if(tc_index >= tc->nmags) {
+        H5FL_tc_mag_t **new_mags;   /* New array of magazines */
+        size_t new_nmags = MAX(2 * tc->nmags, (size_t)tc_index + 1);
+
+        if(NULL == (new_mags = (H5FL_tc_mag_t **)H5MM_realloc(tc->mags, new_nmags * sizeof(H5FL_tc_mag_t *))))
+            HGOTO_DONE(NULL)
+        HDmemset(new_mags + tc->nmags, 0, (new_nmags - tc->nmags) * sizeof(H5FL_tc_mag_t *));
+        tc->mags = new_mags;
+        tc->nmags = new_nmags;
+    } /* end if */
+
+    if(NULL == (mag = tc->mags[tc_index])) {
+        if(NULL == (mag = (H5FL_tc_mag_t *)H5MM_calloc(sizeof(H5FL_tc_mag_t))))
+            HGOTO_DONE(NULL)
+        mag->kind = kind;
+        mag->head = head;
+        tc->mags[tc_index] = mag;
+    } /* end if */
+    HDassert(mag->kind == kind && mag->head == head);
+
+    ret_value = mag;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_mag() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_publish
+ *
+ * Purpose:	Updates the global count of the memory in threads' caches
+ *      with a thread's cache.  The global free lists must be locked.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__tc_publish(H5FL_tc_t *tc)
+{
+    unsigned u;                 /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(u = 0; u < H5FL_TC_NKINDS; u++) {
+        H5FL_tc_mem_g[u] -= tc->published[u];
+        H5FL_tc_mem_g[u] += tc->mem[u];
+        tc->published[u] = tc->mem[u];
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FL__tc_publish() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_flush_mag
+ *
+ * Purpose:	Moves the blocks in a magazine to the magazine's global free
+ *      list, without applying the free list limits.  The global free lists
+ *      must be locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__tc_flush_mag(H5FL_tc_t *tc, H5FL_tc_mag_t *mag)
+{
+    unsigned nblocks = mag->nblocks;    /* Number of blocks to flush */
+    unsigned u;                 /* Local index variable */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Empty the magazine first, in case the list routines look at it */
+    mag->nblocks = 0;
+    tc->mem[mag->kind] -= mag->mem;
+    tc->total_mem -= mag->mem;
+    mag->mem = 0;
+
+    for(u = 0; u < nblocks; u++)
+        switch(mag->kind) {
+            case H5FL_TC_REG:
+                H5FL__reg_push((H5FL_reg_head_t *)mag->head, mag->blocks[u]);
+                break;
+
+            case H5FL_TC_ARR:
+                H5FL__arr_push((H5FL_arr_head_t *)mag->head, (H5FL_arr_list_t *)mag->blocks[u]);
+                break;
+
+            case H5FL_TC_BLK:
+            case H5FL_TC_NKINDS:
+            default:
+                HDassert(mag->kind == H5FL_TC_BLK);
+                /* (The block is released if it can't be put on a list) */
+                if(H5FL__blk_push((H5FL_blk_head_t *)mag->head, (H5FL_blk_list_t *)mag->blocks[u]) < 0)
+                    ret_value = FAIL;
+                break;
+        } /* end switch */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_flush_mag() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_check_mag
+ *
+ * Purpose:	Applies the free list limits to a magazine's global free
+ *      list.  The global free lists must be locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__tc_check_mag(const H5FL_tc_mag_t *mag)
+{
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    switch(mag->kind) {
+        case H5FL_TC_REG:
+            ret_value = H5FL__reg_check((H5FL_reg_head_t *)mag->head);
+            break;
+
+        case H5FL_TC_ARR:
+            ret_value = H5FL__arr_check((H5FL_arr_head_t *)mag->head);
+            break;
+
+        case H5FL_TC_BLK:
+        case H5FL_TC_NKINDS:
+        default:
+            ret_value = H5FL__blk_check((H5FL_blk_head_t *)mag->head);
+            break;
+    } /* end switch */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_check_mag() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_flush
+ *
+ * Purpose:	Returns all the blocks in a thread's cache to the global free
+ *      lists, then applies the free list limits to those lists.  The
+ *      global free lists must be locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__tc_flush(H5FL_tc_t *tc)
+{
+    size_t u;                   /* Local index variable */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Garbage collection triggered by the limits mustn't flush the cache again */
+    tc->flushing = TRUE;
+    tc->epoch = H5FL_tc_epoch_g;
+
+    for(u = 0; u < tc->nmags; u++)
+        if(tc->mags[u] && tc->mags[u]->nblocks > 0)
+            if(H5FL__tc_flush_mag(tc, tc->mags[u]) < 0)
+                ret_value = FAIL;
+    H5FL__tc_publish(tc);
+
+    for(u = 0; u < tc->nmags; u++)
+        if(tc->mags[u] && H5FL__tc_check_mag(tc->mags[u]) < 0)
+            ret_value = FAIL;
+
+    tc->flushing = FALSE;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_flush() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_reclaim
+ *
+ * Purpose:	Makes every thread return the blocks in its cache to the
+ *      global free lists: the calling thread now and the others the next
+ *      time they use their caches.  The global free lists must be locked.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__tc_reclaim(void)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    H5FL_tc_epoch_g++;
+
+    if(H5FL_tc_key_valid_g) {
+        H5FL_tc_t *tc = (H5FL_tc_t *)H5TS_get_thread_local_value(H5FL_tc_key_g);
+
+        if(tc && tc != &H5FL_tc_dead_g && !tc->flushing)
+            (void)H5FL__tc_flush(tc);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FL__tc_reclaim() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_take
+ *
+ * Purpose:	Takes a block for a free list from the calling thread's
+ *      cache.  For array and block free lists, the block must have KEY
+ *      elements or bytes.  Empty magazines of regular free lists are
+ *      refilled from the global list.
+ *
+ * Return:	Success:	The block (array & block lists: its header)
+ *		Failure:	NULL (no block is cached)
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5FL__tc_take(H5FL_tc_kind_t kind, void *head, unsigned tc_index, size_t key,
+    size_t list_lim)
+{
+    H5FL_tc_t *tc;              /* The thread's cache */
+    H5FL_tc_mag_t *mag;         /* The list's magazine */
+    unsigned u;                 /* Local index variable */
+    void *ret_value = NULL;     /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(NULL == (tc = H5FL__tc_get()) || NULL == (mag = H5FL__tc_mag(tc, kind, head, tc_index)))
+        HGOTO_DONE(NULL)
+
+    /* Refill an empty magazine of a regular free list from the global list,
+     * so that the thread locks the list once for several blocks */
+    if(0 == mag->nblocks && H5FL_TC_REG == kind) {
+        H5FL_reg_head_t *reg_head = (H5FL_reg_head_t *)head;
+        size_t mem_lim = MIN(H5FL_TC_MAG_MEM, list_lim);
+
+        H5FL_LOCK
+        while(reg_head->list != NULL && mag->nblocks < H5FL_TC_MAG_SIZE / 2
+                && mag->mem + reg_head->size <= mem_lim
+                && tc->total_mem + reg_head->size <= H5FL_TC_MEM) {
+            mag->blocks[mag->nblocks] = reg_head->list;
+            mag->mems[mag->nblocks] = reg_head->size;
+            mag->nblocks++;
+            reg_head->list = reg_head->list->next;
+            reg_head->onlist--;
+            H5FL_reg_gc_head.mem_freed -= reg_head->size;
+
+            mag->mem += reg_head->size;
+            tc->mem[kind] += reg_head->size;
+            tc->total_mem += reg_head->size;
+        } /* end while */
+        H5FL__tc_publish(tc);
+        H5FL_UNLOCK
+    } /* end if */
+
+    /* Look for a block, most recently cached first */
+    for(u = mag->nblocks; u > 0; u--)
+        if(H5FL_TC_REG == kind || mag->keys[u - 1] == key)
+            break;
+
+    if(u > 0) {
+        size_t mem = mag->mems[u - 1];
+
+        ret_value = mag->blocks[u - 1];
+
+        /* Move the last block into the slot */
+        mag->nblocks--;
+        mag->blocks[u - 1] = mag->blocks[mag->nblocks];
+        mag->keys[u - 1] = mag->keys[mag->nblocks];
+        mag->mems[u - 1] = mag->mems[mag->nblocks];
+
+        mag->mem -= mem;
+        tc->mem[kind] -= mem;
+        tc->total_mem -= mem;
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_take() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_keep
+ *
+ * Purpose:	Keeps a freed block in the calling thread's cache, if there's
+ *      room.  A full magazine is emptied onto the global list first.
+ *
+ * Return:	Success:	TRUE if the block was cached, FALSE if it
+ *                              should go on the global list
+ *		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static htri_t
+H5FL__tc_keep(H5FL_tc_kind_t kind, void *head, unsigned tc_index, void *block,
+    size_t key, size_t mem, size_t list_lim)
+{
+    H5FL_tc_t *tc;              /* The thread's cache */
+    H5FL_tc_mag_t *mag;         /* The list's magazine */
+    size_t mem_lim = MIN(H5FL_TC_MAG_MEM, list_lim);    /* Limit on memory in the magazine */
+    htri_t ret_value = FALSE;   /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    if(mem > mem_lim)
+        HGOTO_DONE(FALSE)
+    if(NULL == (tc = H5FL__tc_get()) || NULL == (mag = H5FL__tc_mag(tc, kind, head, tc_index)))
+        HGOTO_DONE(FALSE)
+
+    /* Make room in the magazine */
+    if(mag->nblocks == H5FL_TC_MAG_SIZE || mag->mem + mem > mem_lim) {
+        herr_t status;
+
+        H5FL_LOCK
+        status = H5FL__tc_flush_mag(tc, mag);
+        H5FL__tc_publish(tc);
+        if(status >= 0)
+            status = H5FL__tc_check_mag(mag);
+        H5FL_UNLOCK
+
+        if(status < 0)
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "can't return cached blocks to free list")
+    } /* end if */
+    if(tc->total_mem + mem > H5FL_TC_MEM)
+        HGOTO_DONE(FALSE)
+
+    mag->blocks[mag->nblocks] = block;
+    mag->keys[mag->nblocks] = key;
+    mag->mems[mag->nblocks] = mem;
+    mag->nblocks++;
+
+    mag->mem += mem;
+    tc->mem[kind] += mem;
+    tc->total_mem += mem;
+
+    ret_value = TRUE;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_keep() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_avail
+ *
+ * Purpose:	Checks whether the calling thread's cache has a block with
+ *      KEY elements or bytes for a free list.
+ *
+ * Return:	TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+H5FL__tc_avail(H5FL_tc_kind_t kind, unsigned tc_index, size_t key)
+{
+    H5FL_tc_t *tc;              /* The thread's cache */
+    H5FL_tc_mag_t *mag;         /* The list's magazine */
+    unsigned u;                 /* Local index variable */
+    hbool_t ret_value = FALSE;  /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(H5FL_tc_key_valid_g && tc_index > 0
+            && NULL != (tc = (H5FL_tc_t *)H5TS_get_thread_local_value(H5FL_tc_key_g))
+            && tc != &H5FL_tc_dead_g && tc->epoch == H5FL_tc_epoch_g
+            && tc_index < tc->nmags && NULL != (mag = tc->mags[tc_index])) {
+        HDassert(mag->kind == kind);
+        for(u = 0; u < mag->nblocks; u++)
+            if(H5FL_TC_REG == kind || mag->keys[u] == key)
+                HGOTO_DONE(TRUE)
+    } /* end if */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__tc_avail() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__tc_term
+ *
+ * Purpose:	Returns the blocks in every thread's cache to the global free
+ *      lists, when the library is closing (and no other threads are using
+ *      it), and releases the calling thread's cache.  Other threads' caches
+ *      are released when those threads exit.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__tc_term(void)
+{
+    H5FL_tc_t *tc;              /* A thread's cache */
+    size_t u;                   /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(H5FL_tc_key_valid_g) {
+        H5FL_LOCK
+        for(tc = H5FL_tc_head_g; tc; tc = tc->next)
+            if(!tc->flushing)
+                (void)H5FL__tc_flush(tc);
+
+        /* Unlink the calling thread's cache */
+        tc = (H5FL_tc_t *)H5TS_get_thread_local_value(H5FL_tc_key_g);
+        if(tc && tc != &H5FL_tc_dead_g) {
+            if(tc->prev)
+                tc->prev->next = tc->next;
+            else
+                H5FL_tc_head_g = tc->next;
+            if(tc->next)
+                tc->next->prev = tc->prev;
+        } /* end if */
+        else
+            tc = NULL;
+        H5FL_UNLOCK
+
+        /* Release it */
+        if(tc) {
+            (void)H5TS_set_thread_local_value(H5FL_tc_key_g, NULL);
+            for(u = 0; u < tc->nmags; u++)
+                H5MM_xfree(tc->mags[u]);
+            H5MM_xfree(tc->mags);
+            H5MM_xfree(tc);
+        } /* end if */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5FL__tc_term() */
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5FL_reg_init
@@ -279,6 +1015,12 @@ H5FL_reg_init(H5FL_reg_head_t *head)
 
     FUNC_ENTER_NOAPI_NOINIT
 
+    H5FL_LOCK
+
+    /* Check if another thread initialized the list first */
+    if(head->init)
+        HGOTO_DONE(SUCCEED)
+
     /* Allocate a new garbage collection node */
     if(NULL == (new_node = (H5FL_reg_gc_node_t *)H5MM_malloc(sizeof(H5FL_reg_gc_node_t))))
         HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed")
@@ -290,9 +1032,6 @@ H5FL_reg_init(H5FL_reg_head_t *head)
     new_node->next=H5FL_reg_gc_head.first;
     H5FL_reg_gc_head.first=new_node;
 
-    /* Indicate that the free list is initialized */
-    head->init = TRUE;
-
     /* Make certain that the space allocated is large enough to store a free list pointer (eventually) */
     if(head->size<sizeof(H5FL_reg_node_t))
         head->size=sizeof(H5FL_reg_node_t);
@@ -302,7 +1041,18 @@ H5FL_reg_init(H5FL_reg_head_t *head)
     head->size += sizeof(H5FL_track_t);
 #endif /* H5FL_TRACK */
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Give the list a magazine in threads' caches (kept if the list is re-initialized) */
+    if(0 == head->tc_index)
+        head->tc_index = ++H5FL_tc_nlists_g;
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
+    /* Indicate that the free list is initialized */
+    head->init = TRUE;
+
 done:
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_reg_init() */
 
@@ -324,6 +1074,7 @@ done:
 void *
 H5FL_reg_free(H5FL_reg_head_t *head, void *obj)
 {
+    herr_t status;              /* Status from checking the limits */
     void *ret_value=NULL;       /* Return value */
 
     /* NOINIT OK here because this must be called after H5FL_reg_malloc/calloc
@@ -364,6 +1115,42 @@ H5FL_reg_free(H5FL_reg_head_t *head, void *obj)
     /* Make certain that the free list is initialized */
     HDassert(head->init);
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Keep the block in the thread's cache, if there's room */
+    if((status = H5FL__tc_keep(H5FL_TC_REG, head, head->tc_index, obj, (size_t)0, head->size, H5FL_reg_lst_mem_lim)) < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+    if(status > 0)
+        HGOTO_DONE(NULL)
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
+    /* Put the block on the global list & check the limits on free list memory */
+    H5FL_LOCK
+    H5FL__reg_push(head, obj);
+    status = H5FL__reg_check(head);
+    H5FL_UNLOCK
+    if(status < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* end H5FL_reg_free() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__reg_push
+ *
+ * Purpose:	Puts an object on its global free list.  The global free lists
+ *      must be locked.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__reg_push(H5FL_reg_head_t *head, void *obj)
+{
+    FUNC_ENTER_STATIC_NOERR
+
     /* Link into the free list */
     ((H5FL_reg_node_t *)obj)->next=head->list;
 
@@ -373,23 +1160,51 @@ H5FL_reg_free(H5FL_reg_head_t *head, void *obj)
     /* Increment the number of blocks on free list */
     head->onlist++;
 
-    /* Increment the amount of "regular" freed memory globally */
-    H5FL_reg_gc_head.mem_freed+=head->size;
+    /* Increment the amount of "regular" freed memory globally */
+    H5FL_reg_gc_head.mem_freed+=head->size;
+
+    FUNC_LEAVE_NOAPI_VOID
+}   /* end H5FL__reg_push() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__reg_check
+ *
+ * Purpose:	Garbage collects a "regular" free list, or all of them, if
+ *      they hold more memory than their limits.  The global free lists must
+ *      be locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__reg_check(H5FL_reg_head_t *head)
+{
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_STATIC
 
     /* Check for exceeding free list memory use limits */
     /* First check this particular list */
     if(head->onlist * head->size > H5FL_reg_lst_mem_lim)
         if(H5FL__reg_gc_list(head) < 0)
-            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection failed during free")
+
+    /* Then check the global amount memory on regular free lists, including
+     * what's in threads' caches */
+    if(H5FL_reg_gc_head.mem_freed + H5FL_TC_MEM_KIND(H5FL_TC_REG) > H5FL_reg_glb_mem_lim) {
+        /* Have the threads return the blocks in their caches too */
+        H5FL_TC_RECLAIM
 
-    /* Then check the global amount memory on regular free lists */
-    if(H5FL_reg_gc_head.mem_freed>H5FL_reg_glb_mem_lim)
         if(H5FL__reg_gc() < 0)
-            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection failed during free")
+    } /* end if */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-}   /* end H5FL_reg_free() */
+}   /* end H5FL__reg_check() */
 
 
 /*-------------------------------------------------------------------------
@@ -422,28 +1237,38 @@ H5FL_reg_malloc(H5FL_reg_head_t *head H5FL_TRACK_PARAMS)
         if(H5FL_reg_init(head)<0)
             HGOTO_ERROR(H5E_RESOURCE, H5E_CANTINIT, NULL, "can't initialize 'regular' blocks")
 
-    /* Check for nodes available on the free list first */
-    if(head->list!=NULL) {
-        /* Get a pointer to the block on the free list */
-        ret_value=(void *)(head->list);
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Check the thread's cache first */
+    ret_value = H5FL__tc_take(H5FL_TC_REG, head, head->tc_index, (size_t)0, H5FL_reg_lst_mem_lim);
+#endif /* H5FL_HAVE_THREAD_CACHE */
 
-        /* Remove node from free list */
-        head->list=head->list->next;
+    if(NULL == ret_value) {
+        H5FL_LOCK
 
-        /* Decrement the number of blocks & memory on free list */
-        head->onlist--;
+        /* Check for nodes available on the free list first */
+        if(head->list!=NULL) {
+            /* Get a pointer to the block on the free list */
+            ret_value=(void *)(head->list);
 
-        /* Decrement the amount of global "regular" free list memory in use */
-        H5FL_reg_gc_head.mem_freed-=(head->size);
-    } /* end if */
-    /* Otherwise allocate a node */
-    else {
-        if (NULL==(ret_value = H5FL_malloc(head->size)))
-            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
+            /* Remove node from free list */
+            head->list=head->list->next;
 
-        /* Increment the number of blocks allocated in list */
-        head->allocated++;
-    } /* end else */
+            /* Decrement the number of blocks & memory on free list */
+            head->onlist--;
+
+            /* Decrement the amount of global "regular" free list memory in use */
+            H5FL_reg_gc_head.mem_freed-=(head->size);
+        } /* end if */
+        /* Otherwise allocate a node */
+        else if(NULL != (ret_value = H5FL_malloc(head->size)))
+            /* Increment the number of blocks allocated in list */
+            head->allocated++;
+
+        H5FL_UNLOCK
+
+        if(NULL == ret_value)
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
+    } /* end if */
 
 #ifdef H5FL_TRACK
     /* Copy allocation location information */
@@ -672,10 +1497,9 @@ printf("%s: head->name = %s, head->allocated = %d\n", FUNC, H5FL_reg_gc_head.fir
 /*-------------------------------------------------------------------------
  * Function:	H5FL_blk_find_list
  *
- * Purpose:	Finds the free list for blocks of a given size.  Also moves that
- *      free list node to the head of the priority queue (if it isn't there
- *      already).  This routine does not manage the actual free list, it just
- *      works with the priority queue.
+ * Purpose:	Finds the free list for blocks of a given size, using the
+ *      queue's index of free lists by block size.  This routine does not
+ *      manage the actual free list, it just works with the priority queue.
  *
  * Return:	Success:	valid pointer to the free list node
  *
@@ -684,49 +1508,20 @@ printf("%s: head->name = %s, head->allocated = %d\n", FUNC, H5FL_reg_gc_head.fir
  * Programmer:	Quincey Koziol
  *		Thursday, March  23, 2000
  *
- * Modifications:
- *
  *-------------------------------------------------------------------------
  */
 static H5FL_blk_node_t *
-H5FL_blk_find_list(H5FL_blk_node_t **head, size_t size)
+H5FL_blk_find_list(const H5FL_blk_head_t *head, size_t size)
 {
     H5FL_blk_node_t *temp = NULL;  /* Temp. pointer to node in the native list */
 
     FUNC_ENTER_NOAPI_NOINIT_NOERR
 
-    /* Find the correct free list */
-    temp=*head;
-
-    /* Check if the node is at the head of the list */
-    if(temp && temp->size!=size) {
-        temp=temp->next;
-
-        while(temp!=NULL) {
-            /* Check if we found the correct node */
-            if(temp->size==size) {
-                /* Take the node found out of it's current position */
-                if(temp->next==NULL) {
-                    temp->prev->next=NULL;
-                } /* end if */
-                else {
-                    temp->prev->next=temp->next;
-                    temp->next->prev=temp->prev;
-                } /* end else */
-
-                /* Move the found node to the head of the list */
-                temp->prev=NULL;
-                temp->next=*head;
-                (*head)->prev=temp;
-                *head=temp;
-
-                /* Get out */
+    /* Find the correct free list in its index bucket */
+    if(head->index)
+        for(temp = head->index[H5FL_BLK_HASH(size, head->index_size)]; temp != NULL; temp = temp->hash_next)
+            if(temp->size == size)
                 break;
-            } /* end if */
-
-            temp=temp->next;
-        } /* end while */
-    } /* end if */
 
     FUNC_LEAVE_NOAPI(temp)
 } /* end H5FL_blk_find_list() */
@@ -736,7 +1531,8 @@ H5FL_blk_find_list(H5FL_blk_node_t **head, size_t size)
  * Function:	H5FL_blk_create_list
  *
  * Purpose:	Creates a new free list for blocks of the given size at the
- *      head of the priority queue.
+ *      head of the priority queue and adds it to the queue's index,
+ *      doubling the index when it has as many free lists as buckets.
  *
  * Return:	Success:	valid pointer to the free list node
  *
@@ -745,18 +1541,41 @@ H5FL_blk_find_list(H5FL_blk_node_t **head, size_t size)
  * Programmer:	Quincey Koziol
  *		Thursday, March  23, 2000
  *
- * Modifications:
- *
  *-------------------------------------------------------------------------
  */
 static H5FL_blk_node_t *
-H5FL_blk_create_list(H5FL_blk_node_t **head, size_t size)
+H5FL_blk_create_list(H5FL_blk_head_t *head, size_t size)
 {
     H5FL_blk_node_t *temp;  /* Temp. pointer to node in the list */
+    size_t bucket;          /* Index bucket for the new list */
     H5FL_blk_node_t *ret_value = NULL;          /* Return value */
 
     FUNC_ENTER_NOAPI_NOINIT
 
+    /* Create or grow the index */
+    if(head->nlists >= head->index_size) {
+        H5FL_blk_node_t **new_index;    /* New array of index buckets */
+        size_t new_size = head->index_size ? 2 * head->index_size : H5FL_BLK_INDEX_INIT;
+
+        if(NULL == (new_index = (H5FL_blk_node_t **)H5MM_calloc(new_size * sizeof(H5FL_blk_node_t *)))) {
+            /* Longer chains in the old index will do */
+            if(NULL == head->index)
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for free list index")
+        } /* end if */
+        else {
+            /* Re-hash the free lists into the new index */
+            for(temp = head->head; temp != NULL; temp = temp->next) {
+                bucket = H5FL_BLK_HASH(temp->size, new_size);
+                temp->hash_next = new_index[bucket];
+                new_index[bucket] = temp;
+            } /* end for */
+
+            H5MM_xfree(head->index);
+            head->index = new_index;
+            head->index_size = new_size;
+        } /* end else */
+    } /* end if */
+
     /* Allocate room for the new free list node */
     if(NULL==(temp=H5FL_MALLOC(H5FL_blk_node_t)))
         HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for chunk info")
@@ -766,17 +1585,23 @@ H5FL_blk_create_list(H5FL_blk_node_t **head, size_t size)
     temp->list=NULL;
 
     /* Attach to head of priority queue */
-    if(*head==NULL) {
-        *head=temp;
+    if(head->head==NULL) {
+        head->head=temp;
         temp->next=temp->prev=NULL;
     } /* end if */
     else {
-        temp->next=*head;
-        (*head)->prev=temp;
+        temp->next=head->head;
+        head->head->prev=temp;
         temp->prev=NULL;
-        *head=temp;
+        head->head=temp;
     } /* end else */
 
+    /* Add to the index */
+    bucket = H5FL_BLK_HASH(size, head->index_size);
+    temp->hash_next = head->index[bucket];
+    head->index[bucket] = temp;
+    head->nlists++;
+
     ret_value=temp;
 
 done:
@@ -808,6 +1633,12 @@ H5FL_blk_init(H5FL_blk_head_t *head)
 
     FUNC_ENTER_NOAPI_NOINIT
 
+    H5FL_LOCK
+
+    /* Check if another thread initialized the PQ first */
+    if(head->init)
+        HGOTO_DONE(SUCCEED)
+
     /* Allocate a new garbage collection node */
     if(NULL == (new_node = (H5FL_blk_gc_node_t *)H5MM_malloc(sizeof(H5FL_blk_gc_node_t))))
         HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed")
@@ -819,10 +1650,18 @@ H5FL_blk_init(H5FL_blk_head_t *head)
     new_node->next=H5FL_blk_gc_head.first;
     H5FL_blk_gc_head.first=new_node;
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Give the PQ a magazine in threads' caches (kept if the PQ is re-initialized) */
+    if(0 == head->tc_index)
+        head->tc_index = ++H5FL_tc_nlists_g;
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
     /* Indicate that the PQ is initialized */
     head->init = TRUE;
 
 done:
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_blk_init() */
 
@@ -854,12 +1693,24 @@ H5FL_blk_free_block_avail(H5FL_blk_head_t *head, size_t size)
     /* Double check parameters */
     HDassert(head);
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Check the thread's cache first */
+    if(H5FL__tc_avail(H5FL_TC_BLK, head->tc_index, size))
+        HGOTO_DONE(TRUE)
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
     /* check if there is a free list for blocks of this size */
     /* and if there are any blocks available on the list */
-    if((free_list = H5FL_blk_find_list(&(head->head), size)) != NULL && free_list->list != NULL)
+    H5FL_LOCK
+    if((free_list = H5FL_blk_find_list(head, size)) != NULL && free_list->list != NULL)
         ret_value = TRUE;
     else
         ret_value = FALSE;
+    H5FL_UNLOCK
+
+#ifdef H5FL_HAVE_THREAD_CACHE
+done:
+#endif /* H5FL_HAVE_THREAD_CACHE */
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5FL_blk_free_block_avail() */
 
@@ -886,7 +1737,7 @@ void *
 H5FL_blk_malloc(H5FL_blk_head_t *head, size_t size H5FL_TRACK_PARAMS)
 {
     H5FL_blk_node_t *free_list; /* The free list of nodes of correct size */
-    H5FL_blk_list_t *temp;      /* Temp. ptr to the new native list allocated */
+    H5FL_blk_list_t *temp = NULL;   /* Temp. ptr to the new native list allocated */
     void *ret_value = NULL;     /* Pointer to the block to return to the user */
 
     FUNC_ENTER_NOAPI(NULL)
@@ -900,30 +1751,39 @@ H5FL_blk_malloc(H5FL_blk_head_t *head, size_t size H5FL_TRACK_PARAMS)
         if(H5FL_blk_init(head)<0)
             HGOTO_ERROR(H5E_RESOURCE, H5E_CANTINIT, NULL, "can't initialize 'block' list")
 
-    /* check if there is a free list for blocks of this size */
-    /* and if there are any blocks available on the list */
-    if((free_list=H5FL_blk_find_list(&(head->head),size))!=NULL && free_list->list!=NULL) {
-        /* Remove the first node from the free list */
-        temp=free_list->list;
-        free_list->list=free_list->list->next;
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Check the thread's cache first */
+    temp = (H5FL_blk_list_t *)H5FL__tc_take(H5FL_TC_BLK, head, head->tc_index, size, H5FL_blk_lst_mem_lim);
+#endif /* H5FL_HAVE_THREAD_CACHE */
 
-        /* Decrement the number of blocks & memory used on free list */
-        head->onlist--;
-        head->list_mem-=size;
+    if(NULL == temp) {
+        H5FL_LOCK
 
-        /* Decrement the amount of global "block" free list memory in use */
-        H5FL_blk_gc_head.mem_freed-=size;
+        /* check if there is a free list for blocks of this size */
+        /* and if there are any blocks available on the list */
+        if((free_list=H5FL_blk_find_list(head,size))!=NULL && free_list->list!=NULL) {
+            /* Remove the first node from the free list */
+            temp=free_list->list;
+            free_list->list=free_list->list->next;
 
-    } /* end if */
-    /* No free list available, or there are no nodes on the list, allocate a new node to give to the user */
-    else {
-        /* Allocate new node, with room for the page info header and the actual page data */
-        if(NULL == (temp = (H5FL_blk_list_t *)H5FL_malloc(sizeof(H5FL_blk_list_t) + H5FL_TRACK_SIZE + size)))
-            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for chunk")
+            /* Decrement the number of blocks & memory used on free list */
+            head->onlist--;
+            head->list_mem-=size;
 
-        /* Increment the number of blocks allocated */
-        head->allocated++;
-    } /* end else */
+            /* Decrement the amount of global "block" free list memory in use */
+            H5FL_blk_gc_head.mem_freed-=size;
+        } /* end if */
+        /* No free list available, or there are no nodes on the list, allocate a new node to give to the user */
+        /* (with room for the page info header and the actual page data) */
+        else if(NULL != (temp = (H5FL_blk_list_t *)H5FL_malloc(sizeof(H5FL_blk_list_t) + H5FL_TRACK_SIZE + size)))
+            /* Increment the number of blocks allocated */
+            head->allocated++;
+
+        H5FL_UNLOCK
+
+        if(NULL == temp)
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for chunk")
+    } /* end if */
 
     /* Initialize the block allocated */
     temp->size=size;
@@ -1018,9 +1878,9 @@ done:
 void *
 H5FL_blk_free(H5FL_blk_head_t *head, void *block)
 {
-    H5FL_blk_node_t *free_list;      /* The free list of nodes of correct size */
     H5FL_blk_list_t *temp;      /* Temp. ptr to the new free list node allocated */
     size_t free_size;           /* Size of the block freed */
+    herr_t status;              /* Status from putting the block on its list */
     void *ret_value=NULL;       /* Return value */
 
     /* NOINIT OK here because this must be called after H5FL_blk_malloc/calloc
@@ -1062,20 +1922,63 @@ H5FL_blk_free(H5FL_blk_head_t *head, void *block)
 
 #ifdef H5FL_DEBUG
     HDmemset(temp,255,free_size + sizeof(H5FL_blk_list_t) + H5FL_TRACK_SIZE);
+    temp->size = free_size;
 #endif /* H5FL_DEBUG */
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Keep the block in the thread's cache, if there's room */
+    if((status = H5FL__tc_keep(H5FL_TC_BLK, head, head->tc_index, temp, free_size, free_size, H5FL_blk_lst_mem_lim)) < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+    if(status > 0)
+        HGOTO_DONE(NULL)
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
+    /* Put the block on the global list & check the limits on free list memory */
+    H5FL_LOCK
+    if((status = H5FL__blk_push(head, temp)) >= 0)
+        status = H5FL__blk_check(head);
+    H5FL_UNLOCK
+    if(status < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL_blk_free() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__blk_push
+ *
+ * Purpose:	Puts a block on the free list for its size, creating the list
+ *      if needed.  If the list can't be created, the block is released
+ *      instead.  The global free lists must be locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__blk_push(H5FL_blk_head_t *head, H5FL_blk_list_t *temp)
+{
+    H5FL_blk_node_t *free_list;      /* The free list of nodes of correct size */
+    size_t free_size = temp->size;  /* Size of the block freed */
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_STATIC
+
     /* check if there is a free list for native blocks of this size */
-    if((free_list=H5FL_blk_find_list(&(head->head),free_size))==NULL) {
+    if((free_list=H5FL_blk_find_list(head,free_size))==NULL)
         /* No free list available, create a new list node and insert it to the queue */
-        free_list=H5FL_blk_create_list(&(head->head),free_size);
-        HDassert(free_list);
-    } /* end if */
+        if(NULL == (free_list=H5FL_blk_create_list(head,free_size))) {
+            head->allocated--;
+            H5MM_free(temp);
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTCREATE, FAIL, "can't create free list for block")
+        } /* end if */
 
     /* Prepend the free'd native block to the front of the free list */
-    if(free_list!=NULL) {
-        temp->next=free_list->list; /* Overwrites the size field in union */
-        free_list->list=temp;
-    } /* end if */
+    temp->next=free_list->list; /* Overwrites the size field in union */
+    free_list->list=temp;
 
     /* Increment the number of blocks on free list */
     head->onlist++;
@@ -1084,20 +1987,49 @@ H5FL_blk_free(H5FL_blk_head_t *head, void *block)
     /* Increment the amount of "block" freed memory globally */
     H5FL_blk_gc_head.mem_freed += free_size;
 
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5FL__blk_push() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__blk_check
+ *
+ * Purpose:	Garbage collects a priority queue, or all of them, if they
+ *      hold more memory than their limits.  The global free lists must be
+ *      locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__blk_check(H5FL_blk_head_t *head)
+{
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_STATIC
+
     /* Check for exceeding free list memory use limits */
     /* First check this particular list */
     if(head->list_mem > H5FL_blk_lst_mem_lim)
         if(H5FL__blk_gc_list(head) < 0)
-            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection failed during free")
+
+    /* Then check the global amount memory on block free lists, including
+     * what's in threads' caches */
+    if(H5FL_blk_gc_head.mem_freed + H5FL_TC_MEM_KIND(H5FL_TC_BLK) > H5FL_blk_glb_mem_lim) {
+        /* Have the threads return the blocks in their caches too */
+        H5FL_TC_RECLAIM
 
-    /* Then check the global amount memory on block free lists */
-    if(H5FL_blk_gc_head.mem_freed > H5FL_blk_glb_mem_lim)
         if(H5FL__blk_gc() < 0)
-            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection failed during free")
+    } /* end if */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-} /* end H5FL_blk_free() */
+} /* end H5FL__blk_check() */
 
 
 /*-------------------------------------------------------------------------
@@ -1231,6 +2163,11 @@ H5FL__blk_gc_list(H5FL_blk_head_t *head)
     head->head = NULL;
     head->onlist = 0;
 
+    /* Empty the index */
+    if(head->index)
+        HDmemset(head->index, 0, head->index_size * sizeof(H5FL_blk_node_t *));
+    head->nlists = 0;
+
     /* Double check that all the memory on this list is recycled */
     HDassert(0 == head->list_mem);
 
@@ -1323,6 +2260,10 @@ printf("%s: head->name = %s, head->allocated = %d\n", FUNC, H5FL_blk_gc_head.fir
         } /* end if */
         /* No allocations left open for list, get rid of it */
         else {
+            /* Free the index of free lists */
+            H5FL_blk_gc_head.first->pq->index = (H5FL_blk_node_t **)H5MM_xfree(H5FL_blk_gc_head.first->pq->index);
+            H5FL_blk_gc_head.first->pq->index_size = 0;
+
             /* Reset the "initialized" flag, in case we restart this list somehow (I don't know how..) */
             H5FL_blk_gc_head.first->pq->init = FALSE;
 
@@ -1365,6 +2306,12 @@ H5FL_arr_init(H5FL_arr_head_t *head)
 
     FUNC_ENTER_NOAPI_NOINIT
 
+    H5FL_LOCK
+
+    /* Check if another thread initialized the list first */
+    if(head->init)
+        HGOTO_DONE(SUCCEED)
+
     /* Allocate a new garbage collection node */
     if(NULL == (new_node = (H5FL_gc_arr_node_t *)H5MM_malloc(sizeof(H5FL_gc_arr_node_t))))
         HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "memory allocation failed")
@@ -1384,10 +2331,18 @@ H5FL_arr_init(H5FL_arr_head_t *head)
     for(u = 0; u < (size_t)head->maxelem; u++)
         head->list_arr[u].size = head->base_size + (head->elem_size * u);
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Give the list a magazine in threads' caches (kept if the list is re-initialized) */
+    if(0 == head->tc_index)
+        head->tc_index = ++H5FL_tc_nlists_g;
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
     /* Indicate that the free list is initialized */
     head->init = TRUE;
 
 done:
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_arr_init() */
 
@@ -1411,8 +2366,8 @@ void *
 H5FL_arr_free(H5FL_arr_head_t *head, void *obj)
 {
     H5FL_arr_list_t *temp;  /* Temp. ptr to the new free list node allocated */
-    size_t mem_size;        /* Size of memory being freed */
     size_t free_nelem;      /* Number of elements in node being free'd */
+    herr_t status;          /* Status from checking the limits */
     void *ret_value=NULL;   /* Return value */
 
     /* NOINIT OK here because this must be called after H5FL_arr_malloc/calloc
@@ -1438,6 +2393,48 @@ H5FL_arr_free(H5FL_arr_head_t *head, void *obj)
     /* Double-check that there is enough room for arrays of this size */
     HDassert((int)free_nelem<=head->maxelem);
 
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Keep the block in the thread's cache, if there's room */
+    if((status = H5FL__tc_keep(H5FL_TC_ARR, head, head->tc_index, temp, free_nelem, head->list_arr[free_nelem].size, H5FL_arr_lst_mem_lim)) < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+    if(status > 0)
+        HGOTO_DONE(NULL)
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
+    /* Put the block on the global list & check the limits on free list memory */
+    H5FL_LOCK
+    H5FL__arr_push(head, temp);
+    status = H5FL__arr_check(head);
+    H5FL_UNLOCK
+    if(status < 0)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* end H5FL_arr_free() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__arr_push
+ *
+ * Purpose:	Puts an array on the global free list for its number of
+ *      elements.  The global free lists must be locked.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5FL__arr_push(H5FL_arr_head_t *head, H5FL_arr_list_t *temp)
+{
+    size_t mem_size;        /* Size of memory being freed */
+    size_t free_nelem;      /* Number of elements in node being free'd */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Get the number of elements */
+    free_nelem=temp->nelem;
+
     /* Link into the free list */
     temp->next=head->list_arr[free_nelem].list;
 
@@ -1454,20 +2451,48 @@ H5FL_arr_free(H5FL_arr_head_t *head, void *obj)
     /* Increment the amount of "array" freed memory globally */
     H5FL_arr_gc_head.mem_freed+=mem_size;
 
+    FUNC_LEAVE_NOAPI_VOID
+}   /* end H5FL__arr_push() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL__arr_check
+ *
+ * Purpose:	Garbage collects an "array" free list, or all of them, if
+ *      they hold more memory than their limits.  The global free lists must
+ *      be locked.
+ *
+ * Return:	Success:	Non-negative
+ * 		Failure:	Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5FL__arr_check(H5FL_arr_head_t *head)
+{
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_STATIC
+
     /* Check for exceeding free list memory use limits */
     /* First check this particular list */
     if(head->list_mem > H5FL_arr_lst_mem_lim)
         if(H5FL__arr_gc_list(head) < 0)
-            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection failed during free")
+
+    /* Then check the global amount memory on array free lists, including
+     * what's in threads' caches */
+    if(H5FL_arr_gc_head.mem_freed + H5FL_TC_MEM_KIND(H5FL_TC_ARR) > H5FL_arr_glb_mem_lim) {
+        /* Have the threads return the blocks in their caches too */
+        H5FL_TC_RECLAIM
 
-    /* Then check the global amount memory on array free lists */
-    if(H5FL_arr_gc_head.mem_freed > H5FL_arr_glb_mem_lim)
         if(H5FL__arr_gc() < 0)
-            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection failed during free")
+    } /* end if */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-}   /* end H5FL_arr_free() */
+}   /* end H5FL__arr_check() */
 
 
 /*-------------------------------------------------------------------------
@@ -1488,7 +2513,7 @@ done:
 void *
 H5FL_arr_malloc(H5FL_arr_head_t *head, size_t elem)
 {
-    H5FL_arr_list_t *new_obj;   /* Pointer to the new free list node allocated */
+    H5FL_arr_list_t *new_obj = NULL;    /* Pointer to the new free list node allocated */
     size_t mem_size;            /* Size of memory block being recycled */
     void *ret_value = NULL;     /* Pointer to the block to return */
 
@@ -1509,30 +2534,39 @@ H5FL_arr_malloc(H5FL_arr_head_t *head, size_t elem)
     /* Get the set of the memory block */
     mem_size=head->list_arr[elem].size;
 
-    /* Check for nodes available on the free list first */
-    if(head->list_arr[elem].list!=NULL) {
-        /* Get a pointer to the block on the free list */
-        new_obj=head->list_arr[elem].list;
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Check the thread's cache first */
+    new_obj = (H5FL_arr_list_t *)H5FL__tc_take(H5FL_TC_ARR, head, head->tc_index, elem, H5FL_arr_lst_mem_lim);
+#endif /* H5FL_HAVE_THREAD_CACHE */
 
-        /* Remove node from free list */
-        head->list_arr[elem].list=head->list_arr[elem].list->next;
+    if(NULL == new_obj) {
+        H5FL_LOCK
 
-        /* Decrement the number of blocks & memory used on free list */
-        head->list_arr[elem].onlist--;
-        head->list_mem-=mem_size;
+        /* Check for nodes available on the free list first */
+        if(head->list_arr[elem].list!=NULL) {
+            /* Get a pointer to the block on the free list */
+            new_obj=head->list_arr[elem].list;
 
-        /* Decrement the amount of global "array" free list memory in use */
-        H5FL_arr_gc_head.mem_freed-=mem_size;
+            /* Remove node from free list */
+            head->list_arr[elem].list=head->list_arr[elem].list->next;
 
-    } /* end if */
-    /* Otherwise allocate a node */
-    else {
-        if(NULL == (new_obj = (H5FL_arr_list_t *)H5FL_malloc(sizeof(H5FL_arr_list_t)+mem_size)))
-            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
+            /* Decrement the number of blocks & memory used on free list */
+            head->list_arr[elem].onlist--;
+            head->list_mem-=mem_size;
 
-        /* Increment the number of blocks allocated in list */
-        head->allocated++;
-    } /* end else */
+            /* Decrement the amount of global "array" free list memory in use */
+            H5FL_arr_gc_head.mem_freed-=mem_size;
+        } /* end if */
+        /* Otherwise allocate a node */
+        else if(NULL != (new_obj = (H5FL_arr_list_t *)H5FL_malloc(sizeof(H5FL_arr_list_t)+mem_size)))
+            /* Increment the number of blocks allocated in list */
+            head->allocated++;
+
+        H5FL_UNLOCK
+
+        if(NULL == new_obj)
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
+    } /* end if */
 
     /* Initialize the new object */
     new_obj->nelem=elem;
@@ -1989,11 +3023,13 @@ H5FL_fac_init(size_t size)
     new_node->list = factory;
 
     /* Link in to the garbage collection list */
+    H5FL_LOCK
     new_node->next = H5FL_fac_gc_head.first;
     H5FL_fac_gc_head.first = new_node;
     if(new_node->next)
         new_node->next->list->prev_gc=new_node;
     /* The new factory's prev_gc field will be set to NULL */
+    H5FL_UNLOCK
 
     /* Make certain that the space allocated is large enough to store a free list pointer (eventually) */
     if(factory->size < sizeof(H5FL_fac_node_t))
@@ -2081,6 +3117,8 @@ H5FL_fac_free(H5FL_fac_head_t *head, void *obj)
     /* Make certain that the free list is initialized */
     HDassert(head->init);
 
+    H5FL_LOCK
+
     /* Link into the free list */
     ((H5FL_fac_node_t *)obj)->next = head->list;
 
@@ -2105,6 +3143,8 @@ H5FL_fac_free(H5FL_fac_head_t *head, void *obj)
             HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, NULL, "garbage collection failed during free")
 
 done:
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_fac_free() */
 
@@ -2139,6 +3179,8 @@ H5FL_fac_malloc(H5FL_fac_head_t *head H5FL_TRACK_PARAMS)
     HDassert(head);
     HDassert(head->init);
 
+    H5FL_LOCK
+
     /* Check for nodes available on the free list first */
     if(head->list!=NULL) {
         /* Get a pointer to the block on the free list */
@@ -2154,13 +3196,14 @@ H5FL_fac_malloc(H5FL_fac_head_t *head H5FL_TRACK_PARAMS)
         H5FL_fac_gc_head.mem_freed-=(head->size);
     } /* end if */
     /* Otherwise allocate a node */
-    else {
-        if (NULL==(ret_value = H5FL_malloc(head->size)))
-            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
-
+    else if(NULL != (ret_value = H5FL_malloc(head->size)))
         /* Increment the number of blocks allocated in list */
         head->allocated++;
-    } /* end else */
+
+    H5FL_UNLOCK
+
+    if(NULL == ret_value)
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed")
 
 #ifdef H5FL_TRACK
     /* Copy allocation location information */
@@ -2348,6 +3391,8 @@ H5FL_fac_term(H5FL_fac_head_t *factory)
     /* Sanity check */
     HDassert(factory);
 
+    H5FL_LOCK
+
     /* Garbage collect all the blocks in the factory's free list */
     if(H5FL__fac_gc_list(factory) < 0)
         HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "garbage collection of factory failed")
@@ -2379,6 +3424,8 @@ H5FL_fac_term(H5FL_fac_head_t *factory)
     factory = H5FL_FREE(H5FL_fac_head_t, factory);
 
 done:
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_fac_term() */
 
@@ -2449,6 +3496,12 @@ H5FL_garbage_coll(void)
 
     FUNC_ENTER_NOAPI(FAIL)
 
+    H5FL_LOCK
+
+    /* Have the threads return the blocks in their caches: this thread's now
+     * and the others' the next time they use the free lists */
+    H5FL_TC_RECLAIM
+
     /* Garbage collect the free lists for array objects */
     if(H5FL__arr_gc() < 0)
         HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "can't garbage collect array objects")
@@ -2466,6 +3519,8 @@ H5FL_garbage_coll(void)
         HGOTO_ERROR(H5E_RESOURCE, H5E_CANTGC, FAIL, "can't garbage collect factory objects")
 
 done:
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_garbage_coll() */
 
@@ -2510,6 +3565,8 @@ H5FL_set_free_list_limits(int reg_global_lim, int reg_list_lim, int arr_global_l
 
     FUNC_ENTER_NOAPI_NOERR
 
+    H5FL_LOCK
+
     /* Set the limit variables */
     /* limit on all regular free lists */
     H5FL_reg_glb_mem_lim = (reg_global_lim == -1 ? UINT_MAX : (size_t)reg_global_lim);
@@ -2528,6 +3585,135 @@ H5FL_set_free_list_limits(int reg_global_lim, int reg_list_lim, int arr_global_l
     /* limit on each factory free list */
     H5FL_fac_lst_mem_lim = (fac_list_lim == -1 ? UINT_MAX : (size_t)fac_list_lim);
 
+    /* Have the threads' caches start over under the new limits */
+    H5FL_TC_RECLAIM
+
+    H5FL_UNLOCK
+
     FUNC_LEAVE_NOAPI(ret_value)
 }   /* end H5FL_set_free_list_limits() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL_get_free_list_sizes
+ *
+ * Purpose:	Gets the current size of the different kinds of free lists.
+ *      These lists are global for the entire library.  The size returned
+ *      includes nodes that are freed and awaiting garbage collection /
+ *      reallocation, including those held in threads' caches.
+ *
+ * Parameters:
+ *  size_t *reg_size;    OUT: The current size of all "regular" free list memory used
+ *  size_t *arr_size;    OUT: The current size of all "array" free list memory used
+ *  size_t *blk_size;    OUT: The current size of all "block" free list memory used
+ *  size_t *fac_size;    OUT: The current size of all "factory" free list memory used
+ *
+ * Return:	Success:	non-negative
+ *		Failure:	negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FL_get_free_list_sizes(size_t *reg_size, size_t *arr_size, size_t *blk_size,
+    size_t *fac_size)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI_NOERR
+
+    H5FL_LOCK
+
+#ifdef H5FL_HAVE_THREAD_CACHE
+    /* Count what's in the calling thread's cache as of now */
+    if(H5FL_tc_key_valid_g) {
+        H5FL_tc_t *tc = (H5FL_tc_t *)H5TS_get_thread_local_value(H5FL_tc_key_g);
+
+        if(tc && tc != &H5FL_tc_dead_g)
+            H5FL__tc_publish(tc);
+    } /* end if */
+#endif /* H5FL_HAVE_THREAD_CACHE */
+
+    if(reg_size)
+        *reg_size = H5FL_reg_gc_head.mem_freed + H5FL_TC_MEM_KIND(H5FL_TC_REG);
+    if(arr_size)
+        *arr_size = H5FL_arr_gc_head.mem_freed + H5FL_TC_MEM_KIND(H5FL_TC_ARR);
+    if(blk_size)
+        *blk_size = H5FL_blk_gc_head.mem_freed + H5FL_TC_MEM_KIND(H5FL_TC_BLK);
+    if(fac_size)
+        *fac_size = H5FL_fac_gc_head.mem_freed;
+
+    H5FL_UNLOCK
+
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* end H5FL_get_free_list_sizes() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5FL_print_stats
+ *
+ * Purpose:	Prints the number of blocks allocated by each free list and
+ *      the number of blocks and bytes on it, with the totals for each kind
+ *      of free list, including the memory held in threads' caches.
+ *
+ * Return:	Success:	non-negative
+ *		Failure:	negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5FL_print_stats(FILE *stream)
+{
+    H5FL_reg_gc_node_t *reg_node;   /* Node on list of "regular" free lists */
+    H5FL_gc_arr_node_t *arr_node;   /* Node on list of "array" free lists */
+    H5FL_blk_gc_node_t *blk_node;   /* Node on list of "block" free lists */
+    H5FL_fac_gc_node_t *fac_node;   /* Node on list of factories */
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_NOAPI_NOERR
+
+    HDassert(stream);
+
+    H5FL_LOCK
+
+    HDfprintf(stream, "H5FL: free list statistics\n");
+    HDfprintf(stream, "   %-32s %12s %12s %12s\n", "Free list", "Allocated", "On list", "Bytes");
+
+    for(reg_node = H5FL_reg_gc_head.first; reg_node; reg_node = reg_node->next)
+        HDfprintf(stream, "   %-32s %12u %12u %12Zu\n", reg_node->list->name,
+            reg_node->list->allocated, reg_node->list->onlist,
+            reg_node->list->onlist * reg_node->list->size);
+    HDfprintf(stream, "   Regular:  %Zu bytes on lists, %Zu in threads' caches\n",
+        H5FL_reg_gc_head.mem_freed, H5FL_TC_MEM_KIND(H5FL_TC_REG));
+
+    for(arr_node = H5FL_arr_gc_head.first; arr_node; arr_node = arr_node->next) {
+        unsigned onlist = 0;        /* Number of arrays on the free lists */
+        int u;                      /* Local index variable */
+
+        for(u = 0; u < arr_node->list->maxelem; u++)
+            onlist += arr_node->list->list_arr[u].onlist;
+        HDfprintf(stream, "   %-32s %12u %12u %12Zu\n", arr_node->list->name,
+            arr_node->list->allocated, onlist, arr_node->list->list_mem);
+    } /* end for */
+    HDfprintf(stream, "   Array:    %Zu bytes on lists, %Zu in threads' caches\n",
+        H5FL_arr_gc_head.mem_freed, H5FL_TC_MEM_KIND(H5FL_TC_ARR));
+
+    for(blk_node = H5FL_blk_gc_head.first; blk_node; blk_node = blk_node->next)
+        HDfprintf(stream, "   %-32s %12u %12u %12Zu\n", blk_node->pq->name,
+            blk_node->pq->allocated, blk_node->pq->onlist, blk_node->pq->list_mem);
+    HDfprintf(stream, "   Block:    %Zu bytes on lists, %Zu in threads' caches\n",
+        H5FL_blk_gc_head.mem_freed, H5FL_TC_MEM_KIND(H5FL_TC_BLK));
+
+    for(fac_node = H5FL_fac_gc_head.first; fac_node; fac_node = fac_node->next) {
+        char name[32];              /* Description of the factory */
+
+        HDsnprintf(name, sizeof(name), "factory of %lu byte blocks", (unsigned long)fac_node->list->size);
+        HDfprintf(stream, "   %-32s %12u %12u %12Zu\n", name, fac_node->list->allocated,
+            fac_node->list->onlist, fac_node->list->onlist * fac_node->list->size);
+    } /* end for */
+    HDfprintf(stream, "   Factory:  %Zu bytes on lists\n", H5FL_fac_gc_head.mem_freed);
+
+    H5FL_UNLOCK
+
+    FUNC_LEAVE_NOAPI(ret_value)
+}   /* end H5FL_print_stats() */
+
@@ -101,6 +101,7 @@ typedef struct H5FL_reg_head_t {
     const char *name;   /* Name of the type */
     size_t size;        /* Size of the blocks in the list */
     H5FL_reg_node_t *list;  /* List of free blocks */
+    unsigned tc_index;  /* Index of the list's magazine in per-thread caches */
 } H5FL_reg_head_t;
 
 /*
@@ -160,6 +161,7 @@ typedef struct H5FL_blk_node_t {
     H5FL_blk_list_t *list;      /* List of free blocks */
     struct H5FL_blk_node_t *next;    /* Pointer to next free list in queue */
     struct H5FL_blk_node_t *prev;    /* Pointer to previous free list in queue */
+    struct H5FL_blk_node_t *hash_next;   /* Pointer to next free list in the same index bucket */
 } H5FL_blk_node_t;
 
 /* Data structure for priority queue of native block free lists */
@@ -170,6 +172,10 @@ typedef struct H5FL_blk_head_t {
     size_t list_mem;    /* Amount of memory in block on free list */
     const char *name;   /* Name of the type */
     H5FL_blk_node_t *head;  /* Pointer to first free list in queue */
+    H5FL_blk_node_t **index;    /* Hash index of the free lists, by block size */
+    size_t index_size;  /* Number of buckets in the index */
+    size_t nlists;      /* Number of free lists in the queue */
+    unsigned tc_index;  /* Index of the list's magazine in per-thread caches */
 } H5FL_blk_head_t;
 
 /*
@@ -243,6 +249,7 @@ typedef struct H5FL_arr_head_t {
     size_t base_size;      /* Size of the "base" object in the list */
     size_t elem_size;      /* Size of the array elements in the list */
     H5FL_arr_node_t *list_arr;  /* Array of lists of free blocks */
+    unsigned tc_index;     /* Index of the list's magazine in per-thread caches */
 } H5FL_arr_head_t;
 
 /*
@@ -423,6 +430,9 @@ H5_DLL herr_t H5FL_garbage_coll(void);
 H5_DLL herr_t H5FL_set_free_list_limits(int reg_global_lim, int reg_list_lim,
     int arr_global_lim, int arr_list_lim, int blk_global_lim, int blk_list_lim,
     int fac_global_lim, int fac_list_lim);
+H5_DLL herr_t H5FL_get_free_list_sizes(size_t *reg_size, size_t *arr_size,
+    size_t *blk_size, size_t *fac_size);
+H5_DLL herr_t H5FL_print_stats(FILE *stream);
 H5_DLL int   H5FL_term_interface(void);
 
 #endif
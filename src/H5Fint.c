@@ -161,6 +161,10 @@ H5F_get_access_plist(H5F_t *f, hbool_t app_ref)
         HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set metadata cache size")
     if(H5P_set(new_plist, H5F_ACS_SIEVE_BUF_SIZE_NAME, &(f->shared->sieve_buf_size)) < 0)
         HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't sieve buffer size")
+    if(H5P_set(new_plist, H5F_ACS_FILTER_NTHREADS_NAME, &(f->shared->filter_nthreads)) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set # of filter threads")
+    if(H5P_set(new_plist, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_NAME, &(f->shared->rdcc_shared_nbytes)) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set shared data cache byte size")
     if(H5P_set(new_plist, H5F_ACS_SDATA_BLOCK_SIZE_NAME, &(f->shared->sdata_aggr.alloc_size)) < 0)
         HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set 'small data' cache size")
     if(H5P_set(new_plist, H5F_ACS_LIBVER_LOW_BOUND_NAME, &f->shared->low_bound) < 0)
@@ -183,6 +187,12 @@ H5F_get_access_plist(H5F_t *f, hbool_t app_ref)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't set minimum metadata fraction of page buffer")
         if(H5P_set(new_plist, H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_NAME, &(f->shared->page_buf->min_raw_perc)) < 0)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't set minimum raw data fraction of page buffer")
+        if(H5P_set(new_plist, H5F_ACS_PAGE_BUFFER_WB_HIGH_NAME, &(f->shared->page_buf->wb_high)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't set write-behind high watermark of page buffer")
+        if(H5P_set(new_plist, H5F_ACS_PAGE_BUFFER_WB_LOW_NAME, &(f->shared->page_buf->wb_low)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't set write-behind low watermark of page buffer")
+        if(H5P_set(new_plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, &(f->shared->page_buf->prefetch_max)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't set prefetch size of page buffer")
     } /* end if */
 #ifdef H5_HAVE_PARALLEL
     if(H5P_set(new_plist, H5_COLL_MD_READ_FLAG_NAME, &(f->coll_md_read)) < 0)
@@ -216,6 +226,39 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5F_get_access_plist() */
 
+
+/*-------------------------------------------------------------------------
+ * Function: H5F_get_filter_pool
+ *
+ * Purpose:  Retrieve the pool of worker threads for running the I/O filter
+ *           pipeline on the file's chunks, creating it on first use.
+ *
+ * Return:   Success:    Pointer to the thread pool.  NULL if the file
+ *                       wasn't opened with more than one filter thread.
+ *           Failure:    NULL
+ *-------------------------------------------------------------------------
+ */
+H5TP_t *
+H5F_get_filter_pool(H5F_t *f)
+{
+    H5TP_t *ret_value = NULL;   /* Return value */
+
+    FUNC_ENTER_NOAPI(NULL)
+
+    HDassert(f);
+    HDassert(f->shared);
+
+    /* Start the workers the first time they are needed */
+    if(NULL == f->shared->filter_pool && f->shared->filter_nthreads > 1)
+        if(NULL == (f->shared->filter_pool = H5TP_create(f->shared->filter_nthreads)))
+            HGOTO_ERROR(H5E_FILE, H5E_CANTINIT, NULL, "can't create filter thread pool")
+
+    ret_value = f->shared->filter_pool;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F_get_filter_pool() */
+
 
 /*-------------------------------------------------------------------------
  * Function: H5F_get_obj_count
@@ -442,6 +485,7 @@ H5F_get_objects_cb(void *obj_ptr, hid_t obj_id, void *key)
             case H5I_ERROR_CLASS:
             case H5I_ERROR_MSG:
             case H5I_ERROR_STACK:
+            case H5I_EVENTSET:
             case H5I_NTYPES:
             default:
                 HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, H5_ITER_ERROR, "unknown or invalid data object")
@@ -932,6 +976,10 @@ H5F__new(H5F_file_t *shared, unsigned flags, hid_t fcpl_id, hid_t fapl_id, H5FD_
             HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get garbage collect reference")
         if(H5P_get(plist, H5F_ACS_SIEVE_BUF_SIZE_NAME, &(f->shared->sieve_buf_size)) < 0)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get sieve buffer size")
+        if(H5P_get(plist, H5F_ACS_FILTER_NTHREADS_NAME, &(f->shared->filter_nthreads)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get # of filter threads")
+        if(H5P_get(plist, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_NAME, &(f->shared->rdcc_shared_nbytes)) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get shared data cache byte size")
         if(H5P_get(plist, H5F_ACS_LIBVER_LOW_BOUND_NAME, &(f->shared->low_bound)) < 0)
             HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, NULL, "can't get 'low' bound for library format versions")
         if(H5P_get(plist, H5F_ACS_LIBVER_HIGH_BOUND_NAME, &(f->shared->high_bound)) < 0)
@@ -1145,6 +1193,14 @@ H5F__dest(H5F_t *f, hbool_t flush)
             f->shared->efc = NULL;
         } /* end if */
 
+        /* Stop the filter pipeline's worker threads */
+        if(f->shared->filter_pool) {
+            if(H5TP_close(f->shared->filter_pool) < 0)
+                /* Push error, but keep going*/
+                HDONE_ERROR(H5E_FILE, H5E_CANTRELEASE, FAIL, "can't close filter thread pool")
+            f->shared->filter_pool = NULL;
+        } /* end if */
+
         /* With the shutdown modifications, the contents of the metadata cache
          * should be clean at this point, with the possible exception of the
          * the superblock and superblock extension.
@@ -1490,6 +1546,9 @@ H5F_open(const char *name, unsigned flags, hid_t fcpl_id, hid_t fapl_id)
     size_t              page_buf_size;
     unsigned            page_buf_min_meta_perc;
     unsigned            page_buf_min_raw_perc;
+    size_t              page_buf_wb_high;
+    size_t              page_buf_wb_low;
+    size_t              page_buf_prefetch;
     hbool_t             set_flag = FALSE;   /*set the status_flags in the superblock */
     hbool_t             clear = FALSE;      /*clear the status_flags         */
     hbool_t             evict_on_close;     /* evict on close value from plist  */
@@ -1652,19 +1711,17 @@ H5F_open(const char *name, unsigned flags, hid_t fcpl_id, hid_t fapl_id)
     if(H5P_get(a_plist, H5F_ACS_PAGE_BUFFER_SIZE_NAME, &page_buf_size) < 0)
         HGOTO_ERROR(H5E_FILE, H5E_CANTGET, NULL, "can't get page buffer size")
     if(page_buf_size) {
-#ifdef H5_HAVE_PARALLEL
-        /* Collective metadata writes are not supported with page buffering */
-        if(file->coll_md_write)
-            HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "collective metadata writes are not supported with page buffering")
-
-        /* Temporary: fail file create when page buffering feature is enabled for parallel */
-        HGOTO_ERROR(H5E_FILE, H5E_CANTOPENFILE, NULL, "page buffering is disabled for parallel")
-#endif /* H5_HAVE_PARALLEL */
         /* Query for other page buffer cache properties */
         if(H5P_get(a_plist, H5F_ACS_PAGE_BUFFER_MIN_META_PERC_NAME, &page_buf_min_meta_perc) < 0)
             HGOTO_ERROR(H5E_FILE, H5E_CANTGET, NULL, "can't get minimum metadata fraction of page buffer")
         if(H5P_get(a_plist, H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_NAME, &page_buf_min_raw_perc) < 0)
             HGOTO_ERROR(H5E_FILE, H5E_CANTGET, NULL, "can't get minimum raw data fraction of page buffer")
+        if(H5P_get(a_plist, H5F_ACS_PAGE_BUFFER_WB_HIGH_NAME, &page_buf_wb_high) < 0)
+            HGOTO_ERROR(H5E_FILE, H5E_CANTGET, NULL, "can't get write-behind high watermark of page buffer")
+        if(H5P_get(a_plist, H5F_ACS_PAGE_BUFFER_WB_LOW_NAME, &page_buf_wb_low) < 0)
+            HGOTO_ERROR(H5E_FILE, H5E_CANTGET, NULL, "can't get write-behind low watermark of page buffer")
+        if(H5P_get(a_plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, &page_buf_prefetch) < 0)
+            HGOTO_ERROR(H5E_FILE, H5E_CANTGET, NULL, "can't get prefetch size of page buffer")
     } /* end if */
 
     /*
@@ -1679,7 +1736,7 @@ H5F_open(const char *name, unsigned flags, hid_t fcpl_id, hid_t fapl_id)
 
         /* Create the page buffer before initializing the superblock */
         if(page_buf_size)
-            if(H5PB_create(file, page_buf_size, page_buf_min_meta_perc, page_buf_min_raw_perc) < 0)
+            if(H5PB_create(file, page_buf_size, page_buf_min_meta_perc, page_buf_min_raw_perc, page_buf_wb_high, page_buf_wb_low, page_buf_prefetch) < 0)
                 HGOTO_ERROR(H5E_FILE, H5E_CANTINIT, NULL, "unable to create page buffer")
 
         /* Initialize information about the superblock and allocate space for it */
@@ -1701,7 +1758,7 @@ H5F_open(const char *name, unsigned flags, hid_t fcpl_id, hid_t fapl_id)
 
         /* Create the page buffer before initializing the superblock */
         if(page_buf_size)
-            if(H5PB_create(file, page_buf_size, page_buf_min_meta_perc, page_buf_min_raw_perc) < 0)
+            if(H5PB_create(file, page_buf_size, page_buf_min_meta_perc, page_buf_min_raw_perc, page_buf_wb_high, page_buf_wb_low, page_buf_prefetch) < 0)
                 HGOTO_ERROR(H5E_FILE, H5E_CANTINIT, NULL, "unable to create page buffer")
 
         /* Open the root group */
@@ -2660,6 +2717,32 @@ H5F_set_grp_btree_shared(H5F_t *f, H5UC_t *rc)
     FUNC_LEAVE_NOAPI(SUCCEED)
 } /* H5F_set_grp_btree_shared() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5F_set_rdcc_shared
+ *
+ * Purpose:     Set the raw data chunk cache budget shared by all the
+ *              datasets in the file.  (It's owned by the datasets, which
+ *              set it back to NULL when the last one using it is closed.)
+ *
+ * Return:      SUCCEED/FAIL
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5F_set_rdcc_shared(H5F_t *f, struct H5D_rdcc_shared_t *rdcc_shared)
+{
+    /* Use FUNC_ENTER_NOAPI_NOINIT_NOERR here to avoid performance issues */
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Sanity check */
+    HDassert(f);
+    HDassert(f->shared);
+
+    f->shared->rdcc_shared = rdcc_shared;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* H5F_set_rdcc_shared() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5F_set_sohm_addr
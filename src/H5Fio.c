@@ -37,6 +37,7 @@
 #include "H5Fpkg.h"             /* File access				*/
 #include "H5FDprivate.h"	/* File drivers				*/
 #include "H5Iprivate.h"		/* IDs			  		*/
+#include "H5MMprivate.h"	/* Memory management			*/
 #include "H5PBprivate.h"	/* Page Buffer				*/
 
 
@@ -59,6 +60,8 @@
 /* Local Prototypes */
 /********************/
 
+static hbool_t H5F__block_vector_direct(const H5F_t *f, haddr_t addr, size_t size);
+
 
 /*********************/
 /* Package Variables */
@@ -121,6 +124,46 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5F_block_read() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5F_block_read_concurrent
+ *
+ * Purpose:	Reads raw data straight from the file driver, for a caller
+ *		which has released the library lock.  Only valid for files
+ *		where H5F_concurrent_reads() is TRUE: the page buffer and
+ *		metadata accumulator are skipped, which is safe because
+ *		nothing in a read-only file can be newer than the file
+ *		itself.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5F_block_read_concurrent(H5F_t *f, haddr_t addr, size_t size, void *buf/*out*/)
+{
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(f);
+    HDassert(f->shared);
+    HDassert(buf);
+    HDassert(H5F_addr_defined(addr));
+    HDassert(H5F_concurrent_reads(f));
+
+    /* Check for attempting I/O on 'temporary' file address */
+    if(H5F_addr_le(f->shared->tmp_addr, (addr + size)))
+        HGOTO_ERROR(H5E_IO, H5E_BADRANGE, FAIL, "attempting I/O in temporary file space")
+
+    if(H5FD_read(f->shared->lf, H5FD_MEM_DRAW, addr, size, buf) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "driver read request failed")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F_block_read_concurrent() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5F_block_write
@@ -168,6 +211,188 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5F_block_write() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5F__block_vector_direct
+ *
+ * Purpose:	Decides whether a raw data block in a vector request can
+ *		go straight to the file driver.  Blocks can't when the
+ *		page buffer is in use, or when they overlap the metadata
+ *		accumulator, which H5F_block_read/H5F_block_write keep in
+ *		step with raw data I/O.
+ *
+ * Return:	TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+H5F__block_vector_direct(const H5F_t *f, haddr_t addr, size_t size)
+{
+    const H5F_meta_accum_t *accum = &f->shared->accum;  /* Metadata accumulator */
+    hbool_t ret_value = TRUE;           /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(f->shared->page_buf)
+        ret_value = FALSE;
+    else if((f->shared->feature_flags & H5FD_FEAT_ACCUMULATE_METADATA) && accum->size > 0
+            && H5F_addr_overlap(addr, size, accum->loc, accum->size))
+        ret_value = FALSE;
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F__block_vector_direct() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5F_block_read_vector
+ *
+ * Purpose:	Reads COUNT blocks of raw data from the file into the
+ *		buffers in BUFS.  Blocks which can go straight to the file
+ *		driver are read with a single vector read; the rest are
+ *		read as by H5F_block_read().
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5F_block_read_vector(H5F_t *f, size_t count, const haddr_t addrs[],
+    const size_t sizes[], void *bufs[]/*out*/)
+{
+    H5FD_mem_t  *vtypes = NULL;         /* Memory types of driver requests */
+    haddr_t     *vaddrs = NULL;         /* Addresses of driver requests */
+    size_t      *vsizes = NULL;         /* Sizes of driver requests */
+    void        **vbufs = NULL;         /* Buffers of driver requests */
+    size_t      nvec = 0;               /* Number of driver requests */
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(f);
+    HDassert(f->shared);
+    HDassert(0 == count || (addrs && sizes && bufs));
+
+    if(0 == count)
+        HGOTO_DONE(SUCCEED)
+
+    if(NULL == (vtypes = (H5FD_mem_t *)H5MM_malloc(count * sizeof(H5FD_mem_t)))
+            || NULL == (vaddrs = (haddr_t *)H5MM_malloc(count * sizeof(haddr_t)))
+            || NULL == (vsizes = (size_t *)H5MM_malloc(count * sizeof(size_t)))
+            || NULL == (vbufs = (void **)H5MM_malloc(count * sizeof(void *))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector read arrays")
+
+    for(u = 0; u < count; u++) {
+        HDassert(H5F_addr_defined(addrs[u]));
+
+        /* Check for attempting I/O on 'temporary' file address */
+        if(H5F_addr_le(f->shared->tmp_addr, (addrs[u] + sizes[u])))
+            HGOTO_ERROR(H5E_IO, H5E_BADRANGE, FAIL, "attempting I/O in temporary file space")
+
+        /* Collect the blocks for the driver, and pass the rest through
+         * the page buffer layer
+         */
+        if(H5F__block_vector_direct(f, addrs[u], sizes[u])) {
+            vtypes[nvec] = H5FD_MEM_DRAW;
+            vaddrs[nvec] = addrs[u];
+            vsizes[nvec] = sizes[u];
+            vbufs[nvec] = bufs[u];
+            nvec++;
+        } /* end if */
+        else
+            if(H5PB_read(f, H5FD_MEM_DRAW, addrs[u], sizes[u], bufs[u]) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "read through page buffer failed")
+    } /* end for */
+
+    if(nvec > 0 && H5FD_read_vector(f->shared->lf, nvec, vtypes, vaddrs, vsizes, vbufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_READERROR, FAIL, "driver vector read request failed")
+
+done:
+    vtypes = (H5FD_mem_t *)H5MM_xfree(vtypes);
+    vaddrs = (haddr_t *)H5MM_xfree(vaddrs);
+    vsizes = (size_t *)H5MM_xfree(vsizes);
+    vbufs = (void **)H5MM_xfree(vbufs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F_block_read_vector() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5F_block_write_vector
+ *
+ * Purpose:	Writes COUNT blocks of raw data from the buffers in BUFS
+ *		to the file.  Blocks which can go straight to the file
+ *		driver are written with a single vector write; the rest
+ *		are written as by H5F_block_write().
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5F_block_write_vector(H5F_t *f, size_t count, const haddr_t addrs[],
+    const size_t sizes[], const void *bufs[])
+{
+    H5FD_mem_t  *vtypes = NULL;         /* Memory types of driver requests */
+    haddr_t     *vaddrs = NULL;         /* Addresses of driver requests */
+    size_t      *vsizes = NULL;         /* Sizes of driver requests */
+    const void  **vbufs = NULL;         /* Buffers of driver requests */
+    size_t      nvec = 0;               /* Number of driver requests */
+    size_t      u;                      /* Local index variable */
+    herr_t      ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Sanity checks */
+    HDassert(f);
+    HDassert(f->shared);
+    HDassert(H5F_INTENT(f) & H5F_ACC_RDWR);
+    HDassert(0 == count || (addrs && sizes && bufs));
+
+    if(0 == count)
+        HGOTO_DONE(SUCCEED)
+
+    if(NULL == (vtypes = (H5FD_mem_t *)H5MM_malloc(count * sizeof(H5FD_mem_t)))
+            || NULL == (vaddrs = (haddr_t *)H5MM_malloc(count * sizeof(haddr_t)))
+            || NULL == (vsizes = (size_t *)H5MM_malloc(count * sizeof(size_t)))
+            || NULL == (vbufs = (const void **)H5MM_malloc(count * sizeof(void *))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate vector write arrays")
+
+    for(u = 0; u < count; u++) {
+        HDassert(H5F_addr_defined(addrs[u]));
+
+        /* Check for attempting I/O on 'temporary' file address */
+        if(H5F_addr_le(f->shared->tmp_addr, (addrs[u] + sizes[u])))
+            HGOTO_ERROR(H5E_IO, H5E_BADRANGE, FAIL, "attempting I/O in temporary file space")
+
+        /* Collect the blocks for the driver, and pass the rest through
+         * the page buffer layer
+         */
+        if(H5F__block_vector_direct(f, addrs[u], sizes[u])) {
+            vtypes[nvec] = H5FD_MEM_DRAW;
+            vaddrs[nvec] = addrs[u];
+            vsizes[nvec] = sizes[u];
+            vbufs[nvec] = bufs[u];
+            nvec++;
+        } /* end if */
+        else
+            if(H5PB_write(f, H5FD_MEM_DRAW, addrs[u], sizes[u], bufs[u]) < 0)
+                HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "write through page buffer failed")
+    } /* end for */
+
+    if(nvec > 0 && H5FD_write_vector(f->shared->lf, nvec, vtypes, vaddrs, vsizes, vbufs) < 0)
+        HGOTO_ERROR(H5E_IO, H5E_WRITEERROR, FAIL, "driver vector write request failed")
+
+done:
+    vtypes = (H5FD_mem_t *)H5MM_xfree(vtypes);
+    vaddrs = (haddr_t *)H5MM_xfree(vaddrs);
+    vsizes = (size_t *)H5MM_xfree(vsizes);
+    vbufs = (const void **)H5MM_xfree(vbufs);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F_block_write_vector() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    H5F_flush_tagged_metadata
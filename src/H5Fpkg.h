@@ -41,6 +41,7 @@
 #include "H5Gprivate.h"         /* Groups                                   */
 #include "H5Oprivate.h"         /* Object header messages                   */
 #include "H5PBprivate.h"        /* Page buffer                              */
+#include "H5TPprivate.h"        /* Thread pools                             */
 #include "H5UCprivate.h"        /* Reference counted object functions       */
 
 
@@ -297,6 +298,10 @@ struct H5F_file_t {
     size_t	rdcc_nbytes;	/* Size of raw data chunk cache	(bytes)	*/
     double	rdcc_w0;	/* Preempt read chunks first? [0.0..1.0]*/
     size_t      sieve_buf_size; /* Size of the data sieve buffer allocated (in bytes) */
+    unsigned    filter_nthreads; /* # of threads for running the I/O filter pipeline */
+    H5TP_t      *filter_pool;   /* Worker threads for the I/O filter pipeline (created on first use) */
+    size_t      rdcc_shared_nbytes; /* Size of raw data chunk cache shared by all datasets (bytes), or 0 */
+    struct H5D_rdcc_shared_t *rdcc_shared; /* Raw data chunk cache budget shared by all datasets (created on first use) */
     hsize_t	threshold;	/* Threshold for alignment		*/
     hsize_t	alignment;	/* Alignment				*/
     unsigned	gc_ref;		/* Garbage-collect references?		*/
@@ -312,6 +312,10 @@ typedef struct H5F_t H5F_t;
 #define H5F_RDCC_NBYTES(F)      ((F)->shared->rdcc_nbytes)
 #define H5F_RDCC_W0(F)          ((F)->shared->rdcc_w0)
 #define H5F_SIEVE_BUF_SIZE(F)   ((F)->shared->sieve_buf_size)
+#define H5F_FILTER_NTHREADS(F)  ((F)->shared->filter_nthreads)
+#define H5F_RDCC_SHARED_NBYTES(F) ((F)->shared->rdcc_shared_nbytes)
+#define H5F_RDCC_SHARED(F)      ((F)->shared->rdcc_shared)
+#define H5F_SET_RDCC_SHARED(F, S) (((F)->shared->rdcc_shared = (S)), SUCCEED)
 #define H5F_GC_REF(F)           ((F)->shared->gc_ref)
 #define H5F_STORE_MSG_CRT_IDX(F)    ((F)->shared->store_msg_crt_idx)
 #define H5F_SET_STORE_MSG_CRT_IDX(F, FL)    ((F)->shared->store_msg_crt_idx = (FL))
@@ -369,6 +373,10 @@ typedef struct H5F_t H5F_t;
 #define H5F_RDCC_NBYTES(F)      (H5F_rdcc_nbytes(F))
 #define H5F_RDCC_W0(F)          (H5F_rdcc_w0(F))
 #define H5F_SIEVE_BUF_SIZE(F)   (H5F_sieve_buf_size(F))
+#define H5F_FILTER_NTHREADS(F)  (H5F_filter_nthreads(F))
+#define H5F_RDCC_SHARED_NBYTES(F) (H5F_rdcc_shared_nbytes(F))
+#define H5F_RDCC_SHARED(F)      (H5F_rdcc_shared(F))
+#define H5F_SET_RDCC_SHARED(F, S) (H5F_set_rdcc_shared((F), (S)))
 #define H5F_GC_REF(F)           (H5F_gc_ref(F))
 #define H5F_STORE_MSG_CRT_IDX(F) (H5F_store_msg_crt_idx(F))
 #define H5F_SET_STORE_MSG_CRT_IDX(F, FL)    (H5F_set_store_msg_crt_idx((F), (FL)))
@@ -447,6 +455,12 @@ typedef struct H5F_t H5F_t;
  * creation property list and is always ASCII. */
 #define H5F_DEFAULT_CSET H5T_CSET_ASCII
 
+/* Raw data in files opened read-only may be read without the library lock
+ * held, when the file driver allows it (see H5F_concurrent_reads()) */
+#if defined(H5_HAVE_THREADSAFE) && !defined(H5_HAVE_WIN_THREADS)
+#define H5F_HAVE_CONCURRENT_READS
+#endif /* H5_HAVE_THREADSAFE && !H5_HAVE_WIN_THREADS */
+
 /* ========= File Creation properties ============ */
 #define H5F_CRT_USER_BLOCK_NAME      "block_size"       /* Size of the file user block in bytes */
 #define H5F_CRT_SYM_LEAF_NAME        "symbol_leaf"      /* 1/2 rank for symbol table leaf nodes */
@@ -507,6 +521,11 @@ typedef struct H5F_t H5F_t;
 #define H5F_ACS_PAGE_BUFFER_SIZE_NAME           "page_buffer_size" /* the maximum size for the page buffer cache */
 #define H5F_ACS_PAGE_BUFFER_MIN_META_PERC_NAME  "page_buffer_min_meta_perc" /* the min metadata percentage for the page buffer cache */
 #define H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_NAME   "page_buffer_min_raw_perc" /* the min raw data percentage for the page buffer cache */
+#define H5F_ACS_PAGE_BUFFER_WB_HIGH_NAME        "page_buffer_wb_high" /* the dirty bytes in the page buffer which start a write-behind drain */
+#define H5F_ACS_PAGE_BUFFER_WB_LOW_NAME         "page_buffer_wb_low" /* the dirty bytes in the page buffer at which a write-behind drain stops */
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_NAME       "page_buffer_prefetch" /* the max. # of raw data pages read ahead by the page buffer */
+#define H5F_ACS_FILTER_NTHREADS_NAME            "filter_nthreads" /* the # of threads used to run the I/O filter pipeline */
+#define H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_NAME "rdcc_shared_nbytes" /* Size of raw data chunk cache shared by all datasets (bytes) */
 
 /* ======================== File Mount properties ====================*/
 #define H5F_MNT_SYM_LOCAL_NAME         "local"                 /* Whether absolute symlinks local to file. */
@@ -645,6 +664,8 @@ struct H5O_loc_t;
 struct H5HG_heap_t;
 struct H5VL_class_t;
 struct H5P_genplist_t;
+struct H5TP_t;
+struct H5D_rdcc_shared_t;
 
 /* Forward declarations for anonymous H5F objects */
 
@@ -762,6 +783,10 @@ H5_DLL size_t H5F_rdcc_nbytes(const H5F_t *f);
 H5_DLL size_t H5F_rdcc_nslots(const H5F_t *f);
 H5_DLL double H5F_rdcc_w0(const H5F_t *f);
 H5_DLL size_t H5F_sieve_buf_size(const H5F_t *f);
+H5_DLL unsigned H5F_filter_nthreads(const H5F_t *f);
+H5_DLL size_t H5F_rdcc_shared_nbytes(const H5F_t *f);
+H5_DLL struct H5D_rdcc_shared_t *H5F_rdcc_shared(const H5F_t *f);
+H5_DLL herr_t H5F_set_rdcc_shared(H5F_t *f, struct H5D_rdcc_shared_t *rdcc_shared);
 H5_DLL unsigned H5F_gc_ref(const H5F_t *f);
 H5_DLL unsigned H5F_use_latest_flags(const H5F_t *f, unsigned fl);
 H5_DLL hbool_t H5F_store_msg_crt_idx(const H5F_t *f);
@@ -784,6 +809,7 @@ H5_DLL char *H5F_mdc_log_location(const H5F_t *f);
 H5_DLL hid_t H5F_get_driver_id(const H5F_t *f);
 H5_DLL herr_t H5F_get_fileno(const H5F_t *f, unsigned long *filenum);
 H5_DLL hbool_t H5F_has_feature(const H5F_t *f, unsigned feature);
+H5_DLL hbool_t H5F_concurrent_reads(const H5F_t *f);
 H5_DLL haddr_t H5F_get_eoa(const H5F_t *f, H5FD_mem_t type);
 H5_DLL herr_t H5F_get_vfd_handle(const H5F_t *file, hid_t fapl, void **file_handle);
 
@@ -793,9 +819,17 @@ H5_DLL hbool_t H5F_has_mount(const H5F_t *file);
 H5_DLL herr_t H5F_traverse_mount(struct H5O_loc_t *oloc/*in,out*/);
 H5_DLL herr_t H5F_flush_mounts(H5F_t *f);
 
+/* Functions that manage the worker threads for the I/O filter pipeline */
+H5_DLL struct H5TP_t *H5F_get_filter_pool(H5F_t *f);
+
 /* Functions that operate on blocks of bytes wrt super block */
 H5_DLL herr_t H5F_block_read(H5F_t *f, H5FD_mem_t type, haddr_t addr, size_t size, void *buf/*out*/);
 H5_DLL herr_t H5F_block_write(H5F_t *f, H5FD_mem_t type, haddr_t addr, size_t size, const void *buf);
+H5_DLL herr_t H5F_block_read_concurrent(H5F_t *f, haddr_t addr, size_t size, void *buf/*out*/);
+H5_DLL herr_t H5F_block_read_vector(H5F_t *f, size_t count, const haddr_t addrs[],
+    const size_t sizes[], void *bufs[]/*out*/);
+H5_DLL herr_t H5F_block_write_vector(H5F_t *f, size_t count, const haddr_t addrs[],
+    const size_t sizes[], const void *bufs[]);
 
 /* Functions that flush or evict */
 H5_DLL herr_t H5F_flush_tagged_metadata(H5F_t *f, haddr_t tag);
@@ -709,6 +709,72 @@ H5F_sieve_buf_size(const H5F_t *f)
     FUNC_LEAVE_NOAPI(f->shared->sieve_buf_size)
 } /* end H5F_sieve_buf_size() */
 
+
+/*-------------------------------------------------------------------------
+ * Function: H5F_filter_nthreads
+ *
+ * Purpose:  Retrieve the # of threads for running the I/O filter pipeline
+ *
+ * Return:   '# of threads' value on success/abort on failure (shouldn't fail)
+ *-------------------------------------------------------------------------
+ */
+unsigned
+H5F_filter_nthreads(const H5F_t *f)
+{
+    /* Use FUNC_ENTER_NOAPI_NOINIT_NOERR here to avoid performance issues */
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(f);
+    HDassert(f->shared);
+
+    FUNC_LEAVE_NOAPI(f->shared->filter_nthreads)
+} /* end H5F_filter_nthreads() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F_rdcc_shared_nbytes
+ *
+ * Purpose:  Retrieve the size of the raw data chunk cache shared by all the
+ *           datasets in the file
+ *
+ * Return:   'shared cache size' value on success/abort on failure (shouldn't fail)
+ *-------------------------------------------------------------------------
+ */
+size_t
+H5F_rdcc_shared_nbytes(const H5F_t *f)
+{
+    /* Use FUNC_ENTER_NOAPI_NOINIT_NOERR here to avoid performance issues */
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(f);
+    HDassert(f->shared);
+
+    FUNC_LEAVE_NOAPI(f->shared->rdcc_shared_nbytes)
+} /* end H5F_rdcc_shared_nbytes() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5F_rdcc_shared
+ *
+ * Purpose:  Retrieve the raw data chunk cache budget shared by all the
+ *           datasets in the file
+ *
+ * Return:   Pointer to the shared budget (NULL if it hasn't been set up)
+ *           on success/abort on failure (shouldn't fail)
+ *-------------------------------------------------------------------------
+ */
+struct H5D_rdcc_shared_t *
+H5F_rdcc_shared(const H5F_t *f)
+{
+    /* Use FUNC_ENTER_NOAPI_NOINIT_NOERR here to avoid performance issues */
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(f);
+    HDassert(f->shared);
+
+    FUNC_LEAVE_NOAPI(f->shared->rdcc_shared)
+} /* end H5F_rdcc_shared() */
+
 
 /*-------------------------------------------------------------------------
  * Function: H5F_gc_ref
@@ -828,6 +894,37 @@ H5F_has_feature(const H5F_t *f, unsigned feature)
     FUNC_LEAVE_NOAPI((hbool_t)(f->shared->lf->feature_flags&feature))
 } /* end H5F_has_feature() */
 
+
+/*-------------------------------------------------------------------------
+ * Function: H5F_concurrent_reads
+ *
+ * Purpose:  Check if raw data in a file may be read with
+ *           H5F_block_read_concurrent() while the library lock is
+ *           released.  The file must be open read-only (and not for SWMR
+ *           reading, since a writer may be changing it) and its driver
+ *           must allow concurrent reads.
+ *
+ * Return:   TRUE/FALSE
+ *-------------------------------------------------------------------------
+ */
+hbool_t
+H5F_concurrent_reads(const H5F_t *f)
+{
+    hbool_t ret_value = FALSE;  /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(f);
+    HDassert(f->shared);
+
+#ifdef H5F_HAVE_CONCURRENT_READS
+    if(!(f->shared->flags & (H5F_ACC_RDWR | H5F_ACC_SWMR_READ)))
+        ret_value = (hbool_t)(0 != (f->shared->lf->feature_flags & H5FD_FEAT_CONCURRENT_READ));
+#endif /* H5F_HAVE_CONCURRENT_READS */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5F_concurrent_reads() */
+
 
 /*-------------------------------------------------------------------------
  * Function: H5F_get_driver_id
@@ -180,6 +180,9 @@ H5G_loc(hid_t loc_id, H5G_loc_t *loc)
         case H5I_ERROR_STACK:
             HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "unable to get group location of error class, message or stack")
 
+        case H5I_EVENTSET:
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "unable to get group location of event set")
+
         case H5I_GROUP:
             {
                 H5G_t	*group;
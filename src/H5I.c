@@ -23,6 +23,25 @@
  *          values within the range 1 to H5I_MAX_NUM_TYPES and are given out
  *          at run-time.  Types used by the library are stored in global
  *          variables defined in H5Ipublic.h.
+ *
+ *          The hash table is indexed by the low bits of the ID, which are
+ *          handed out in sequence, so IDs spread evenly over the buckets
+ *          and lookups take constant time however many IDs are open.  The
+ *          IDs in a type are also kept on a list in the order they were
+ *          registered, which is the order they are iterated over in.
+ *
+ *          Types are created and destroyed, and IDs are registered and
+ *          removed, only while holding the library's lock.  In threadsafe
+ *          builds each type also has a reader/writer lock, held across
+ *          looking an ID up and using what was found: changes to the
+ *          hash table, to an ID's object or to its reference counts take
+ *          it for writing, and lookups take it for reading.  So code
+ *          running without the library lock, such as the filters on the
+ *          filter threads, may look IDs up with H5I_object(),
+ *          H5I_object_verify() and H5I_get_ref(), and take and drop
+ *          internal references with H5I_inc_ref() and H5I_dec_ref(), as
+ *          long as it doesn't drop the last reference to an ID.  (This
+ *          is what pushing and clearing errors does.)
  */
 
 #include "H5Imodule.h"          /* This source code file is part of the H5I module */
@@ -36,7 +55,6 @@
 #include "H5Ipkg.h"             /* IDs                                      */
 #include "H5MMprivate.h"        /* Memory management                        */
 #include "H5Oprivate.h"         /* Object headers                           */
-#include "H5SLprivate.h"        /* Skip Lists                               */
 
 /* Define this to compile in support for dumping ID information */
 /* #define H5I_DEBUG_OUTPUT */
@@ -55,6 +73,24 @@
 #define H5I_MAKE(g,i)	((((hid_t)(g) & TYPE_MASK) << ID_BITS) |	  \
 			     ((hid_t)(i) & ID_MASK))
 
+/* Initial number of buckets in each type's hash table (a power of two) */
+#define H5I_HASH_MIN_SIZE       64
+
+/* Bucket for an ID */
+#define H5I_HASH_BUCKET(T, ID)  ((size_t)((ID) & ID_MASK) & ((T)->nbuckets - 1))
+
+/* Locking for the types */
+#if defined(H5_HAVE_THREADSAFE) && !defined(H5_HAVE_WIN_THREADS)
+#define H5I_HAVE_TYPE_LOCKS
+#define H5I_TYPE_RDLOCK(T)      (void)pthread_rwlock_rdlock(&(T)->lock);
+#define H5I_TYPE_WRLOCK(T)      (void)pthread_rwlock_wrlock(&(T)->lock);
+#define H5I_TYPE_UNLOCK(T)      (void)pthread_rwlock_unlock(&(T)->lock);
+#else /* defined(H5_HAVE_THREADSAFE) && !defined(H5_HAVE_WIN_THREADS) */
+#define H5I_TYPE_RDLOCK(T)
+#define H5I_TYPE_WRLOCK(T)
+#define H5I_TYPE_UNLOCK(T)
+#endif /* defined(H5_HAVE_THREADSAFE) && !defined(H5_HAVE_WIN_THREADS) */
+
 /* Local typedefs */
 
 /* Atom information structure used */
@@ -63,6 +99,10 @@ typedef struct H5I_id_info_t {
     unsigned	count;		/* ref. count for this atom		    */
     unsigned    app_count;      /* ref. count of application visible atoms  */
     const void	*obj_ptr;	/* pointer associated with the atom	    */
+    hbool_t     marked;         /* Removed while iterating over the type    */
+    struct H5I_id_info_t *hash_next;    /* Next ID in the same bucket       */
+    struct H5I_id_info_t *prev;         /* Previous ID in iteration order   */
+    struct H5I_id_info_t *next;         /* Next ID in iteration order       */
 } H5I_id_info_t;
 
 /* ID type structure used */
@@ -71,7 +111,15 @@ typedef struct {
     unsigned	init_count;	/* # of times this type has been initialized*/
     uint64_t	id_count;	/* Current number of IDs held		    */
     uint64_t	nextid;		/* ID to use for the next atom		    */
-    H5SL_t      *ids;           /* Pointer to skip list that stores IDs     */
+    H5I_id_info_t **buckets;    /* Hash table of IDs                        */
+    size_t      nbuckets;       /* Number of buckets (a power of two)       */
+    H5I_id_info_t *head;        /* First ID in iteration order              */
+    H5I_id_info_t *tail;        /* Last ID in iteration order               */
+    unsigned    iterating;      /* # of iterations over the type under way  */
+    hbool_t     marked;         /* Whether any IDs are marked for removal   */
+#ifdef H5I_HAVE_TYPE_LOCKS
+    pthread_rwlock_t lock;      /* Lock for lookups and changes to the IDs  */
+#endif /* H5I_HAVE_TYPE_LOCKS */
 } H5I_id_type_t;
 
 typedef struct {
@@ -120,17 +168,25 @@ H5FL_DEFINE_STATIC(H5I_id_type_t);
 H5FL_DEFINE_STATIC(H5I_class_t);
 
 /*--------------------- Local function prototypes ---------------------------*/
-static htri_t H5I__clear_type_cb(void *_id, void *key, void *udata);
+static herr_t H5I__create_table(H5I_id_type_t *type_ptr);
+static void H5I__destroy_table(H5I_id_type_t *type_ptr);
+static void H5I__insert(H5I_id_type_t *type_ptr, H5I_id_info_t *id_ptr);
+static void H5I__unlink(H5I_id_type_t *type_ptr, H5I_id_info_t *id_ptr);
+static void H5I__begin_iterate(H5I_id_type_t *type_ptr);
+static void H5I__end_iterate(H5I_id_type_t *type_ptr);
+static htri_t H5I__clear_type_cb(H5I_id_info_t *id, H5I_clear_type_ud_t *udata);
 static int H5I__destroy_type(H5I_type_t type);
 static void *H5I__remove_verify(hid_t id, H5I_type_t id_type);
 static void *H5I__remove_common(H5I_id_type_t *type_ptr, hid_t id);
 static int H5I__inc_type_ref(H5I_type_t type);
 static int H5I__get_type_ref(H5I_type_t type);
 static int H5I__search_cb(void *obj, hid_t id, void *_udata);
-static H5I_id_info_t *H5I__find_id(hid_t id);
+static int H5I__iterate_cb(H5I_id_info_t *item, H5I_iterate_ud_t *udata);
+static H5I_id_type_t *H5I__find_type(hid_t id);
+static H5I_id_info_t *H5I__find_id(const H5I_id_type_t *type_ptr, hid_t id);
 static ssize_t H5I__get_name(const H5G_loc_t *loc, char *name, size_t size);
 #ifdef H5I_DEBUG_OUTPUT
-static int H5I__debug_cb(void *_item, void *_key, void *_udata);
+static int H5I__debug_cb(H5I_id_info_t *item, H5I_type_t type);
 static herr_t H5I__debug(H5I_type_t type);
 #endif /* H5I_DEBUG_OUTPUT */
 
@@ -162,7 +218,7 @@ H5I_term_package(void)
 
         /* How many types are still being used? */
         for(type = (H5I_type_t)0; type < H5I_next_type; H5_INC_ENUM(H5I_type_t, type))
-            if((type_ptr = H5I_id_type_list_g[type]) && type_ptr->ids)
+            if((type_ptr = H5I_id_type_list_g[type]) && type_ptr->buckets)
                 n++;
 
         /* If no types are used then clean up */
@@ -170,7 +226,10 @@ H5I_term_package(void)
             for(type = (H5I_type_t)0; type < H5I_next_type; H5_INC_ENUM(H5I_type_t,type)) {
                 type_ptr = H5I_id_type_list_g[type];
                 if(type_ptr) {
-                    HDassert(NULL == type_ptr->ids);
+                    HDassert(NULL == type_ptr->buckets);
+#ifdef H5I_HAVE_TYPE_LOCKS
+                    (void)pthread_rwlock_destroy(&type_ptr->lock);
+#endif /* H5I_HAVE_TYPE_LOCKS */
                     type_ptr = H5FL_FREE(H5I_id_type_t, type_ptr);
                     H5I_id_type_list_g[type] = NULL;
                     n++;
@@ -295,6 +354,12 @@ H5I_register_type(const H5I_class_t *cls)
         /* Allocate the type information for new type */
         if(NULL == (type_ptr = (H5I_id_type_t *)H5FL_CALLOC(H5I_id_type_t)))
             HGOTO_ERROR(H5E_ATOM, H5E_CANTALLOC, FAIL, "ID type allocation failed")
+#ifdef H5I_HAVE_TYPE_LOCKS
+        if(pthread_rwlock_init(&type_ptr->lock, NULL)) {
+            type_ptr = H5FL_FREE(H5I_id_type_t, type_ptr);
+            HGOTO_ERROR(H5E_ATOM, H5E_CANTINIT, FAIL, "can't initialize ID type lock")
+        } /* end if */
+#endif /* H5I_HAVE_TYPE_LOCKS */
         H5I_id_type_list_g[cls->type_id] = type_ptr;
     } /* end if */
     else {
@@ -307,8 +372,8 @@ H5I_register_type(const H5I_class_t *cls)
         type_ptr->cls = cls;
         type_ptr->id_count = 0;
         type_ptr->nextid = cls->reserved;
-        if(NULL == (type_ptr->ids = H5SL_create(H5SL_TYPE_HID, NULL)))
-            HGOTO_ERROR(H5E_ATOM, H5E_CANTCREATE, FAIL, "skip list creation failed")
+        if(H5I__create_table(type_ptr) < 0)
+            HGOTO_ERROR(H5E_ATOM, H5E_CANTCREATE, FAIL, "hash table creation failed")
     } /* end if */
 
     /* Increment the count of the times this type has been initialized */
@@ -317,8 +382,10 @@ H5I_register_type(const H5I_class_t *cls)
 done:
     if(ret_value < 0) {	/* Clean up on error */
         if(type_ptr) {
-            if(type_ptr->ids)
-                H5SL_close(type_ptr->ids);
+            H5I_id_type_list_g[cls->type_id] = NULL;
+#ifdef H5I_HAVE_TYPE_LOCKS
+            (void)pthread_rwlock_destroy(&type_ptr->lock);
+#endif /* H5I_HAVE_TYPE_LOCKS */
             (void)H5FL_FREE(H5I_id_type_t, type_ptr);
         } /* end if */
     } /* end if */
@@ -492,6 +559,7 @@ herr_t
 H5I_clear_type(H5I_type_t type, hbool_t force, hbool_t app_ref)
 {
     H5I_clear_type_ud_t udata;          /* udata struct for callback */
+    H5I_id_info_t *item;                /* Current ID being worked with */
     int         ret_value = SUCCEED;    /* Return value */
 
     FUNC_ENTER_NOAPI(FAIL)
@@ -507,9 +575,16 @@ H5I_clear_type(H5I_type_t type, hbool_t force, hbool_t app_ref)
     udata.force = force;
     udata.app_ref = app_ref;
 
-    /* Attempt to free all ids in the type */
-    if(H5SL_try_free_safe(udata.type_ptr->ids, H5I__clear_type_cb, &udata) < 0)
-        HGOTO_ERROR(H5E_ATOM, H5E_CANTDELETE, FAIL, "can't free ids in type")
+    /* Attempt to free all ids in the type.  The free callbacks may remove
+     * other IDs in the type, so they're only marked until we're done. */
+    H5I__begin_iterate(udata.type_ptr);
+    for(item = udata.type_ptr->head; item; item = item->next)
+        if(!item->marked)
+            if(H5I__clear_type_cb(item, &udata) < 0) {
+                H5I__end_iterate(udata.type_ptr);
+                HGOTO_ERROR(H5E_ATOM, H5E_CANTDELETE, FAIL, "can't free ids in type")
+            } /* end if */
+    H5I__end_iterate(udata.type_ptr);
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -520,7 +595,8 @@ done:
  * Function:    H5I__clear_type_cb
  *
  * Purpose:     Attempts to free the specified ID, calling the free
- *              function for the object.
+ *              function for the object.  Called for each ID by
+ *              H5I_clear_type.
  *
  * Return:      TRUE/FALSE/FAIL
  *
@@ -530,10 +606,9 @@ done:
  *-------------------------------------------------------------------------
  */
 static htri_t
-H5I__clear_type_cb(void *_id, void H5_ATTR_UNUSED *key, void *_udata)
+H5I__clear_type_cb(H5I_id_info_t *id, H5I_clear_type_ud_t *udata)
 {
-    H5I_id_info_t       *id = (H5I_id_info_t *)_id; /* Current ID being worked with */
-    H5I_clear_type_ud_t *udata = (H5I_clear_type_ud_t *)_udata; /* udata struct */
+    unsigned            count;                /* ID's reference count */
     htri_t              ret_value = FALSE;    /* Return value */
 
     FUNC_ENTER_STATIC_NOERR
@@ -542,10 +617,14 @@ H5I__clear_type_cb(void *_id, void H5_ATTR_UNUSED *key, void *_udata)
     HDassert(udata);
     HDassert(udata->type_ptr);
 
+    H5I_TYPE_RDLOCK(udata->type_ptr)
+    count = id->count - (!udata->app_ref * id->app_count);
+    H5I_TYPE_UNLOCK(udata->type_ptr)
+
     /* Do nothing to the object if the reference count is larger than
      * one and forcing is off.
      */
-    if(udata->force || (id->count - (!udata->app_ref * id->app_count)) <= 1) {
+    if(udata->force || count <= 1) {
         /* Check for a 'free' function and call it, if it exists */
         /* (Casting away const OK -QAK) */
         if(udata->type_ptr->cls->free_func && (udata->type_ptr->cls->free_func)((void *)id->obj_ptr) < 0) {
@@ -568,13 +647,12 @@ H5I__clear_type_cb(void *_id, void H5_ATTR_UNUSED *key, void *_udata)
             ret_value = TRUE;
         } /* end else */
 
-        /* Remove ID if requested */
-        if(ret_value) {
-            /* Free ID info */
-            id = H5FL_FREE(H5I_id_info_t, id);
-
-            /* Decrement the number of IDs in the type */
-            udata->type_ptr->id_count--;
+        /* Remove ID if requested (and the free function didn't already) */
+        if(ret_value && !id->marked) {
+            /* Mark the ID for removal when the iteration ends */
+            H5I_TYPE_WRLOCK(udata->type_ptr)
+            H5I__unlink(udata->type_ptr, id);
+            H5I_TYPE_UNLOCK(udata->type_ptr)
         } /* end if */
     } /* end if */
 
@@ -655,10 +733,11 @@ H5I__destroy_type(H5I_type_t type)
     if(type_ptr->cls->flags & H5I_CLASS_IS_APPLICATION)
         type_ptr->cls = H5FL_FREE(H5I_class_t, (void *)type_ptr->cls);
 
-    if(H5SL_close(type_ptr->ids) < 0)
-        HGOTO_ERROR(H5E_ATOM, H5E_CANTCLOSEOBJ, FAIL, "can't close skip list")
-    type_ptr->ids = NULL;
+    H5I__destroy_table(type_ptr);
 
+#ifdef H5I_HAVE_TYPE_LOCKS
+    (void)pthread_rwlock_destroy(&type_ptr->lock);
+#endif /* H5I_HAVE_TYPE_LOCKS */
     type_ptr = H5FL_FREE(H5I_id_type_t, type_ptr);
     H5I_id_type_list_g[type] = NULL;
 
@@ -738,9 +817,9 @@ H5I_register(H5I_type_t type, const void *object, hbool_t app_ref)
     id_ptr->obj_ptr     = object;
 
     /* Insert into the type */
-    if (H5SL_insert(type_ptr->ids, id_ptr, &id_ptr->id) < 0)
-        HGOTO_ERROR(H5E_ATOM, H5E_CANTINSERT, H5I_INVALID_HID, "can't insert ID node into skip list")
-    type_ptr->id_count++;
+    H5I_TYPE_WRLOCK(type_ptr)
+    H5I__insert(type_ptr, id_ptr);
+    H5I_TYPE_UNLOCK(type_ptr)
     type_ptr->nextid++;
 
     /* Sanity check for the 'nextid' getting too large and wrapping around */
@@ -773,6 +852,7 @@ H5I_register_with_id(H5I_type_t type, const void *object, hbool_t app_ref, hid_t
 {
     H5I_id_type_t  *type_ptr;               /* ptr to the type                  */
     H5I_id_info_t  *id_ptr;                 /* ptr to the new ID information    */
+    hbool_t         in_use;                 /* Whether the ID is in use         */
     herr_t          ret_value = SUCCEED;    /* return value                     */
 
     FUNC_ENTER_NOAPI(FAIL)
@@ -781,8 +861,13 @@ H5I_register_with_id(H5I_type_t type, const void *object, hbool_t app_ref, hid_t
     HDassert(object);
 
     /* Make sure ID is not already in use */
-    if(NULL != (id_ptr = H5I__find_id(id)))
-        HGOTO_ERROR(H5E_ATOM, H5E_BADRANGE, FAIL, "ID already in use")
+    if(NULL != (type_ptr = H5I__find_type(id))) {
+        H5I_TYPE_RDLOCK(type_ptr)
+        in_use = (NULL != H5I__find_id(type_ptr, id));
+        H5I_TYPE_UNLOCK(type_ptr)
+        if(in_use)
+            HGOTO_ERROR(H5E_ATOM, H5E_BADRANGE, FAIL, "ID already in use")
+    } /* end if */
 
     /* Make sure type number is valid */
     if(type <= H5I_BADID || type >= H5I_next_type)
@@ -809,9 +894,9 @@ H5I_register_with_id(H5I_type_t type, const void *object, hbool_t app_ref, hid_t
     id_ptr->obj_ptr     = object;
 
     /* Insert into the type */
-    if(H5SL_insert(type_ptr->ids, id_ptr, &id_ptr->id) < 0)
-        HGOTO_ERROR(H5E_ATOM, H5E_CANTINSERT, FAIL, "can't insert ID node into skip list")
-    type_ptr->id_count++;
+    H5I_TYPE_WRLOCK(type_ptr)
+    H5I__insert(type_ptr, id_ptr);
+    H5I_TYPE_UNLOCK(type_ptr)
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -835,21 +920,28 @@ done:
 void *
 H5I_subst(hid_t id, const void *new_object)
 {
+    H5I_id_type_t *type_ptr;    /* Pointer to the ID's type */
     H5I_id_info_t *id_ptr;      /* Pointer to the atom */
     void *ret_value = NULL;	/* Return value */
 
     FUNC_ENTER_NOAPI(NULL)
 
-    /* General lookup of the ID */
-    if(NULL == (id_ptr = H5I__find_id(id)))
+    if(NULL == (type_ptr = H5I__find_type(id)))
         HGOTO_ERROR(H5E_ATOM, H5E_NOTFOUND, NULL, "can't get ID ref count")
 
-    /* Get the old object pointer to return */
-    /* (Casting away const OK -QAK) */
-    ret_value = (void *)id_ptr->obj_ptr;
+    /* General lookup of the ID */
+    H5I_TYPE_WRLOCK(type_ptr)
+    if(NULL != (id_ptr = H5I__find_id(type_ptr, id))) {
+        /* Get the old object pointer to return */
+        /* (Casting away const OK -QAK) */
+        ret_value = (void *)id_ptr->obj_ptr;
 
-    /* Set the new object pointer for the ID */
-    id_ptr->obj_ptr = new_object;
+        /* Set the new object pointer for the ID */
+        id_ptr->obj_ptr = new_object;
+    } /* end if */
+    H5I_TYPE_UNLOCK(type_ptr)
+    if(NULL == id_ptr)
+        HGOTO_ERROR(H5E_ATOM, H5E_NOTFOUND, NULL, "can't get ID ref count")
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -871,15 +963,20 @@ done:
 void *
 H5I_object(hid_t id)
 {
+    H5I_id_type_t	*type_ptr;          /* Pointer to the ID's type */
     H5I_id_info_t	*id_ptr;            /* Pointer to the new atom  */
     void		    *ret_value = NULL;  /* Return value             */
 
     FUNC_ENTER_NOAPI_NOERR
 
     /* General lookup of the ID */
-    if(NULL != (id_ptr = H5I__find_id(id))) {
-        /* Get the object pointer to return */
-        ret_value = (void *)id_ptr->obj_ptr;        /* (Casting away const OK -QAK) */
+    if(NULL != (type_ptr = H5I__find_type(id))) {
+        H5I_TYPE_RDLOCK(type_ptr)
+        if(NULL != (id_ptr = H5I__find_id(type_ptr, id))) {
+            /* Get the object pointer to return */
+            ret_value = (void *)id_ptr->obj_ptr;        /* (Casting away const OK -QAK) */
+        }
+        H5I_TYPE_UNLOCK(type_ptr)
     }
 
     FUNC_LEAVE_NOAPI(ret_value)
@@ -938,6 +1035,7 @@ done:
 void *
 H5I_object_verify(hid_t id, H5I_type_t id_type)
 {
+    H5I_id_type_t  *type_ptr;               /* Pointer to the ID's type */
     H5I_id_info_t  *id_ptr      = NULL;     /* Pointer to the new atom  */
     void           *ret_value   = NULL;     /* Return value             */
 
@@ -946,9 +1044,13 @@ H5I_object_verify(hid_t id, H5I_type_t id_type)
     HDassert(id_type >= 1 && id_type < H5I_next_type);
 
     /* Verify that the type of the ID is correct & lookup the ID */
-    if(id_type == H5I_TYPE(id) && NULL != (id_ptr = H5I__find_id(id))) {
-        /* Get the object pointer to return */
-        ret_value = (void *)id_ptr->obj_ptr;        /* (Casting away const OK -QAK) */
+    if(id_type == H5I_TYPE(id) && NULL != (type_ptr = H5I__find_type(id))) {
+        H5I_TYPE_RDLOCK(type_ptr)
+        if(NULL != (id_ptr = H5I__find_id(type_ptr, id))) {
+            /* Get the object pointer to return */
+            ret_value = (void *)id_ptr->obj_ptr;        /* (Casting away const OK -QAK) */
+        }
+        H5I_TYPE_UNLOCK(type_ptr)
     }
 
     FUNC_LEAVE_NOAPI(ret_value)
@@ -1118,15 +1220,18 @@ H5I__remove_common(H5I_id_type_t *type_ptr, hid_t id)
     HDassert(type_ptr);
 
     /* Get the ID node for the ID */
-    if(NULL == (curr_id = (H5I_id_info_t *)H5SL_remove(type_ptr->ids, &id)))
-        HGOTO_ERROR(H5E_ATOM, H5E_CANTDELETE, NULL, "can't remove ID node from skip list")
-
-    /* (Casting away const OK -QAK) */
-    ret_value = (void *)curr_id->obj_ptr;
-    curr_id = H5FL_FREE(H5I_id_info_t, curr_id);
+    H5I_TYPE_WRLOCK(type_ptr)
+    if(NULL != (curr_id = H5I__find_id(type_ptr, id))) {
+        /* (Casting away const OK -QAK) */
+        ret_value = (void *)curr_id->obj_ptr;
 
-    /* Decrement the number of IDs in the type */
-    (type_ptr->id_count)--;
+        /* Take the ID out of the hash table, and free it unless the type
+         * is being iterated over */
+        H5I__unlink(type_ptr, curr_id);
+    } /* end if */
+    H5I_TYPE_UNLOCK(type_ptr)
+    if(NULL == curr_id)
+        HGOTO_ERROR(H5E_ATOM, H5E_CANTDELETE, NULL, "can't remove ID node from hash table")
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -1227,7 +1332,10 @@ done:
 int
 H5I_dec_ref(hid_t id)
 {
+    H5I_id_type_t *type_ptr;    /* Pointer to the ID's type */
     H5I_id_info_t *id_ptr;      /* Pointer to the new ID */
+    const void *obj_ptr = NULL; /* ID's object */
+    hbool_t last = FALSE;       /* Whether this is the last reference */
     int ret_value = 0;          /* Return value */
 
     FUNC_ENTER_NOAPI((-1))
@@ -1235,8 +1343,21 @@ H5I_dec_ref(hid_t id)
     /* Sanity check */
     HDassert(id >= 0);
 
-    /* General lookup of the ID */
-    if(NULL == (id_ptr = H5I__find_id(id)))
+    if(NULL == (type_ptr = H5I__find_type(id)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
+
+    /* General lookup of the ID, dropping a reference unless it's the last */
+    H5I_TYPE_WRLOCK(type_ptr)
+    if(NULL != (id_ptr = H5I__find_id(type_ptr, id))) {
+        if(1 == id_ptr->count) {
+            obj_ptr = id_ptr->obj_ptr;
+            last = TRUE;
+        } /* end if */
+        else
+            ret_value = (int)--(id_ptr->count);
+    } /* end if */
+    H5I_TYPE_UNLOCK(type_ptr)
+    if(NULL == id_ptr)
         HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
 
     /* If this is the last reference to the object then invoke the type's
@@ -1252,15 +1373,13 @@ H5I_dec_ref(hid_t id)
      * method might fail.  This can happen when a mandatory filter fails to
      * write when a dataset is closed and the chunk cache is flushed to the 
      * file.  We have to close the dataset anyway. (SLU - 2010/9/7)
+     *
+     * (Only the library lock keeps the last reference from being taken
+     * meanwhile, so it must be held to drop it.)
      */
-    if(1 == id_ptr->count) {
-        H5I_id_type_t	*type_ptr;		/*ptr to the type	*/
-
-        /* Get the ID's type */
-        type_ptr = H5I_id_type_list_g[H5I_TYPE(id)];
-
+    if(last) {
         /* (Casting away const OK -QAK) */
-        if(!type_ptr->cls->free_func || (type_ptr->cls->free_func)((void *)id_ptr->obj_ptr) >= 0) {
+        if(!type_ptr->cls->free_func || (type_ptr->cls->free_func)((void *)obj_ptr) >= 0) {
             /* Remove the node from the type */
             if(NULL == H5I__remove_common(type_ptr, id))
                 HGOTO_ERROR(H5E_ATOM, H5E_CANTDELETE, (-1), "can't remove ID node")
@@ -1269,10 +1388,6 @@ H5I_dec_ref(hid_t id)
         else
             ret_value = -1;
     } /* end if */
-    else {
-        --(id_ptr->count);
-        ret_value = (int)id_ptr->count;
-    } /* end else */
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -1310,16 +1425,22 @@ H5I_dec_app_ref(hid_t id)
 
     /* Check if the ID still exists */
     if(ret_value > 0) {
+        H5I_id_type_t *type_ptr = H5I__find_type(id);     /* Pointer to the ID's type */
+
         /* General lookup of the ID */
-        if(NULL == (id_ptr = H5I__find_id(id)))
+        HDassert(type_ptr);
+        H5I_TYPE_WRLOCK(type_ptr)
+        if(NULL != (id_ptr = H5I__find_id(type_ptr, id))) {
+            /* Adjust app_ref */
+            --(id_ptr->app_count);
+            HDassert(id_ptr->count >= id_ptr->app_count);
+
+            /* Set return value */
+            ret_value = (int)id_ptr->app_count;
+        } /* end if */
+        H5I_TYPE_UNLOCK(type_ptr)
+        if(NULL == id_ptr)
             HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
-
-        /* Adjust app_ref */
-        --(id_ptr->app_count);
-        HDassert(id_ptr->count >= id_ptr->app_count);
-
-        /* Set return value */
-        ret_value = (int)id_ptr->app_count;
     } /* end if */
 
 done:
@@ -1413,6 +1534,7 @@ done:
 int
 H5I_inc_ref(hid_t id, hbool_t app_ref)
 {
+    H5I_id_type_t *type_ptr;    /* Pointer to the ID's type */
     H5I_id_info_t *id_ptr;      /* Pointer to the ID */
     int ret_value = 0;          /* Return value */
 
@@ -1421,17 +1543,23 @@ H5I_inc_ref(hid_t id, hbool_t app_ref)
     /* Sanity check */
     HDassert(id >= 0);
 
-    /* General lookup of the ID */
-    if (NULL == (id_ptr = H5I__find_id(id)))
+    if (NULL == (type_ptr = H5I__find_type(id)))
         HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
 
-    /* Adjust reference counts */
-    ++(id_ptr->count);
-    if (app_ref)
-        ++(id_ptr->app_count);
+    /* General lookup of the ID */
+    H5I_TYPE_WRLOCK(type_ptr)
+    if (NULL != (id_ptr = H5I__find_id(type_ptr, id))) {
+        /* Adjust reference counts */
+        ++(id_ptr->count);
+        if (app_ref)
+            ++(id_ptr->app_count);
 
-    /* Set return value */
-    ret_value = (int)(app_ref ? id_ptr->app_count : id_ptr->count);
+        /* Set return value */
+        ret_value = (int)(app_ref ? id_ptr->app_count : id_ptr->count);
+    }
+    H5I_TYPE_UNLOCK(type_ptr)
+    if (NULL == id_ptr)
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -1482,6 +1610,7 @@ done:
 int
 H5I_get_ref(hid_t id, hbool_t app_ref)
 {
+    H5I_id_type_t *type_ptr;    /* Pointer to the ID's type */
     H5I_id_info_t *id_ptr;      /* Pointer to the ID */
     int ret_value = 0;          /* Return value */
 
@@ -1490,12 +1619,17 @@ H5I_get_ref(hid_t id, hbool_t app_ref)
     /* Sanity check */
     HDassert(id >= 0);
 
-    /* General lookup of the ID */
-    if (NULL == (id_ptr = H5I__find_id(id)))
+    if (NULL == (type_ptr = H5I__find_type(id)))
         HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
 
-    /* Set return value */
-    ret_value = (int)(app_ref ? id_ptr->app_count : id_ptr->count);
+    /* General lookup of the ID */
+    H5I_TYPE_RDLOCK(type_ptr)
+    if (NULL != (id_ptr = H5I__find_id(type_ptr, id)))
+        /* Set return value */
+        ret_value = (int)(app_ref ? id_ptr->app_count : id_ptr->count);
+    H5I_TYPE_UNLOCK(type_ptr)
+    if (NULL == id_ptr)
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, (-1), "can't locate ID")
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -1747,6 +1881,7 @@ done:
 htri_t
 H5Iis_valid(hid_t id)
 {
+    H5I_id_type_t   *type_ptr;          /* ptr to the ID's type */
     H5I_id_info_t   *id_ptr;            /* ptr to the ID */
     htri_t          ret_value = TRUE;   /* Return value */
 
@@ -1754,10 +1889,16 @@ H5Iis_valid(hid_t id)
     H5TRACE1("t", "i", id);
 
     /* Find the ID */
-    if (NULL == (id_ptr = H5I__find_id(id)))
-        ret_value = FALSE;
-    else if (!id_ptr->app_count) /* Check if the found id is an internal id */
+    if (NULL == (type_ptr = H5I__find_type(id)))
         ret_value = FALSE;
+    else {
+        H5I_TYPE_RDLOCK(type_ptr)
+        if (NULL == (id_ptr = H5I__find_id(type_ptr, id)))
+            ret_value = FALSE;
+        else if (!id_ptr->app_count) /* Check if the found id is an internal id */
+            ret_value = FALSE;
+        H5I_TYPE_UNLOCK(type_ptr)
+    }
 
 done:
     FUNC_LEAVE_API(ret_value)
@@ -1863,10 +2004,8 @@ done:
  *-------------------------------------------------------------------------
  */
 static int
-H5I__iterate_cb(void *_item, void H5_ATTR_UNUSED *_key, void *_udata)
+H5I__iterate_cb(H5I_id_info_t *item, H5I_iterate_ud_t *udata)
 {
-    H5I_id_info_t *item = (H5I_id_info_t *)_item;       /* Pointer to the ID node */
-    H5I_iterate_ud_t *udata = (H5I_iterate_ud_t *)_udata; /* User data for callback */
     int ret_value = H5_ITER_CONT;     /* Callback return value */
 
     FUNC_ENTER_STATIC_NOERR
@@ -1932,15 +2071,22 @@ H5I_iterate(H5I_type_t type, H5I_search_func_t func, void *udata, hbool_t app_re
     /* Only iterate through ID list if it is initialized and there are IDs in type */
     if (type_ptr && type_ptr->init_count > 0 && type_ptr->id_count > 0) {
         H5I_iterate_ud_t iter_udata;    /* User data for iteration callback */
-        herr_t iter_status;             /* Iteration status */
+        H5I_id_info_t *item;            /* Current ID */
+        int iter_status = H5_ITER_CONT; /* Iteration status */
 
         /* Set up iterator user data */
         iter_udata.user_func    = func;
         iter_udata.user_udata   = udata;
         iter_udata.app_ref      = app_ref;
 
-        /* Iterate over IDs */
-        if ((iter_status = H5SL_iterate(type_ptr->ids, H5I__iterate_cb, &iter_udata)) < 0)
+        /* Iterate over IDs.  The callback may remove IDs from the type, so
+         * they're only marked until we're done. */
+        H5I__begin_iterate(type_ptr);
+        for (item = type_ptr->head; item && iter_status == H5_ITER_CONT; item = item->next)
+            if (!item->marked)
+                iter_status = H5I__iterate_cb(item, &iter_udata);
+        H5I__end_iterate(type_ptr);
+        if (iter_status < 0)
             HGOTO_ERROR(H5E_ATOM, H5E_BADITER, FAIL, "iteration failed")
     }
 
@@ -1950,23 +2096,273 @@ done:
 
 
 /*-------------------------------------------------------------------------
- * Function:    H5I__find_id
+ * Function:    H5I__create_table
  *
- * Purpose:     Given an object ID find the info struct that describes the
- *              object.
+ * Purpose:     Creates the (empty) hash table and iteration list for the
+ *              IDs in a type.
  *
- * Return:      Success:    A pointer to the object's info struct.
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5I__create_table(H5I_id_type_t *type_ptr)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    HDassert(type_ptr);
+    HDassert(NULL == type_ptr->buckets);
+
+    if(NULL == (type_ptr->buckets = (H5I_id_info_t **)H5MM_calloc(H5I_HASH_MIN_SIZE * sizeof(H5I_id_info_t *))))
+        HGOTO_ERROR(H5E_ATOM, H5E_CANTALLOC, FAIL, "can't allocate hash table buckets")
+    type_ptr->nbuckets = H5I_HASH_MIN_SIZE;
+    type_ptr->head = type_ptr->tail = NULL;
+    type_ptr->iterating = 0;
+    type_ptr->marked = FALSE;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5I__create_table() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__destroy_table
+ *
+ * Purpose:     Releases the hash table and any IDs left in a type.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5I__destroy_table(H5I_id_type_t *type_ptr)
+{
+    H5I_id_info_t *item, *next;         /* IDs left in the type */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(type_ptr);
+    HDassert(0 == type_ptr->iterating);
+
+    for(item = type_ptr->head; item; item = next) {
+        next = item->next;
+        item = H5FL_FREE(H5I_id_info_t, item);
+    } /* end for */
+    type_ptr->head = type_ptr->tail = NULL;
+    type_ptr->id_count = 0;
+
+    type_ptr->buckets = (H5I_id_info_t **)H5MM_xfree(type_ptr->buckets);
+    type_ptr->nbuckets = 0;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5I__destroy_table() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__insert
+ *
+ * Purpose:     Adds an ID to its type's hash table, doubling the table
+ *              when it holds as many IDs as it has buckets, and to the
+ *              end of the type's iteration order.  The caller holds the
+ *              type's lock for writing.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5I__insert(H5I_id_type_t *type_ptr, H5I_id_info_t *id_ptr)
+{
+    size_t bucket;                      /* Bucket for the ID */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(type_ptr);
+    HDassert(id_ptr);
+
+    /* Grow the table.  (If the buckets can't be allocated, the table just
+     * gets slower.) */
+    if(type_ptr->id_count >= type_ptr->nbuckets) {
+        H5I_id_info_t **new_buckets;    /* Hash table after growing */
+        size_t new_nbuckets = type_ptr->nbuckets * 2;
+
+        if(NULL != (new_buckets = (H5I_id_info_t **)H5MM_calloc(new_nbuckets * sizeof(H5I_id_info_t *)))) {
+            H5I_id_info_t **old_buckets = type_ptr->buckets;
+            H5I_id_info_t *item, *next;
+            size_t u;
+
+            for(u = 0; u < type_ptr->nbuckets; u++)
+                for(item = old_buckets[u]; item; item = next) {
+                    size_t new_bucket = (size_t)(item->id & ID_MASK) & (new_nbuckets - 1);
+
+                    next = item->hash_next;
+                    item->hash_next = new_buckets[new_bucket];
+                    new_buckets[new_bucket] = item;
+                } /* end for */
+            type_ptr->buckets = new_buckets;
+            type_ptr->nbuckets = new_nbuckets;
+
+            H5MM_xfree(old_buckets);
+        } /* end if */
+    } /* end if */
+
+    /* Add the ID to its bucket */
+    id_ptr->marked = FALSE;
+    bucket = H5I_HASH_BUCKET(type_ptr, id_ptr->id);
+    id_ptr->hash_next = type_ptr->buckets[bucket];
+    type_ptr->buckets[bucket] = id_ptr;
+
+    /* Add the ID to the end of the iteration order */
+    id_ptr->prev = type_ptr->tail;
+    id_ptr->next = NULL;
+    if(type_ptr->tail)
+        type_ptr->tail->next = id_ptr;
+    else
+        type_ptr->head = id_ptr;
+    type_ptr->tail = id_ptr;
+
+    type_ptr->id_count++;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5I__insert() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__unlink
+ *
+ * Purpose:     Removes an ID from its type's hash table, so it can no
+ *              longer be found.  If the type is being iterated over, the
+ *              ID is marked, and freed when the last iteration ends;
+ *              otherwise it is freed now.  The caller holds the type's
+ *              lock for writing.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5I__unlink(H5I_id_type_t *type_ptr, H5I_id_info_t *id_ptr)
+{
+    H5I_id_info_t **pp;                 /* Link to the ID in its bucket */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(type_ptr);
+    HDassert(id_ptr);
+    HDassert(!id_ptr->marked);
+
+    /* Take the ID out of its bucket */
+    for(pp = &type_ptr->buckets[H5I_HASH_BUCKET(type_ptr, id_ptr->id)]; *pp != id_ptr; pp = &(*pp)->hash_next)
+        HDassert(*pp);
+    *pp = id_ptr->hash_next;
+
+    type_ptr->id_count--;
+
+    if(type_ptr->iterating) {
+        id_ptr->marked = TRUE;
+        type_ptr->marked = TRUE;
+    } /* end if */
+    else {
+        if(id_ptr->prev)
+            id_ptr->prev->next = id_ptr->next;
+        else
+            type_ptr->head = id_ptr->next;
+        if(id_ptr->next)
+            id_ptr->next->prev = id_ptr->prev;
+        else
+            type_ptr->tail = id_ptr->prev;
+        id_ptr = H5FL_FREE(H5I_id_info_t, id_ptr);
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5I__unlink() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__begin_iterate
+ *
+ * Purpose:     Notes the start of an iteration over the IDs in a type.
+ *              Until it ends, removing an ID leaves it in the iteration
+ *              order (marked), so that iterations can step past it.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5I__begin_iterate(H5I_id_type_t *type_ptr)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(type_ptr);
+
+    type_ptr->iterating++;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5I__begin_iterate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__end_iterate
+ *
+ * Purpose:     Notes the end of an iteration over the IDs in a type.
+ *              When the last one ends, frees the IDs removed during it.
+ *
+ * Return:      void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5I__end_iterate(H5I_id_type_t *type_ptr)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(type_ptr);
+    HDassert(type_ptr->iterating > 0);
+
+    if(0 == --type_ptr->iterating && type_ptr->marked) {
+        H5I_id_info_t *item, *next;     /* IDs in the type */
+
+        for(item = type_ptr->head; item; item = next) {
+            next = item->next;
+            if(item->marked) {
+                if(item->prev)
+                    item->prev->next = next;
+                else
+                    type_ptr->head = next;
+                if(next)
+                    next->prev = item->prev;
+                else
+                    type_ptr->tail = item->prev;
+                item = H5FL_FREE(H5I_id_info_t, item);
+            } /* end if */
+        } /* end for */
+        type_ptr->marked = FALSE;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5I__end_iterate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__find_type
+ *
+ * Purpose:     Given an object ID find the type it belongs to, if that
+ *              type is in use.
+ *
+ * Return:      Success:    A pointer to the ID's type.
  *
  *              Failure:    NULL
  *
  *-------------------------------------------------------------------------
  */
-static H5I_id_info_t *
-H5I__find_id(hid_t id)
+static H5I_id_type_t *
+H5I__find_type(hid_t id)
 {
     H5I_type_t		type;			/*ID's type		*/
-    H5I_id_type_t	*type_ptr;		/*ptr to the type	*/
-    H5I_id_info_t	*ret_value = NULL;	/* Return value */
+    H5I_id_type_t	*ret_value = NULL;	/* Return value */
 
     FUNC_ENTER_STATIC_NOERR
 
@@ -1975,14 +2371,45 @@ H5I__find_id(hid_t id)
     if (type <= H5I_BADID || type >= H5I_next_type)
         HGOTO_DONE(NULL)
 
-    type_ptr = H5I_id_type_list_g[type];
-    if (!type_ptr || type_ptr->init_count <= 0)
-        HGOTO_DONE(NULL)
+    ret_value = H5I_id_type_list_g[type];
+    if (ret_value && ret_value->init_count <= 0)
+        ret_value = NULL;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5I__find_type() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5I__find_id
+ *
+ * Purpose:     Given an object ID of type TYPE_PTR find the info struct
+ *              that describes the object.  The caller holds the type's
+ *              lock, and only uses the info struct until releasing it.
+ *
+ * Return:      Success:    A pointer to the object's info struct.
+ *
+ *              Failure:    NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5I_id_info_t *
+H5I__find_id(const H5I_id_type_t *type_ptr, hid_t id)
+{
+    H5I_id_info_t	*id_ptr;		/*ptr to the ID		*/
+    H5I_id_info_t	*ret_value = NULL;	/* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(type_ptr);
 
     /* Locate the ID node for the ID */
-    ret_value = (H5I_id_info_t *)H5SL_search(type_ptr->ids, &id);
+    for (id_ptr = type_ptr->buckets[H5I_HASH_BUCKET(type_ptr, id)]; id_ptr; id_ptr = id_ptr->hash_next)
+        if (id_ptr->id == id) {
+            ret_value = id_ptr;
+            break;
+        }
 
-done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5I__find_id() */
 
@@ -2157,10 +2584,8 @@ done:
  *-------------------------------------------------------------------------
  */
 static int
-H5I__debug_cb(void *_item, void H5_ATTR_UNUSED *_key, void *_udata)
+H5I__debug_cb(H5I_id_info_t *item, H5I_type_t type)
 {
-    H5I_id_info_t  *item    = (H5I_id_info_t *)_item;       /* Pointer to the ID node */
-    H5I_type_t      type    = *(H5I_type_t *)_udata;        /* User data */
     H5G_name_t     *path    = NULL;                         /* Path to file object */
 
     FUNC_ENTER_STATIC_NOERR
@@ -2198,6 +2623,7 @@ H5I__debug_cb(void *_item, void H5_ATTR_UNUSED *_key, void *_udata)
         case H5I_ERROR_CLASS:
         case H5I_ERROR_MSG:
         case H5I_ERROR_STACK:
+        case H5I_EVENTSET:
         case H5I_NTYPES:
         default:
             break;   /* Other types of IDs are not stored in files */
@@ -2227,6 +2653,7 @@ static herr_t
 H5I__debug(H5I_type_t type)
 {
     H5I_id_type_t *type_ptr;
+    H5I_id_info_t *item;
 
     FUNC_ENTER_STATIC_NOERR
 
@@ -2241,7 +2668,9 @@ H5I__debug(H5I_type_t type)
 
     /* List */
     HDfprintf(stderr, "	 List:\n");
-    H5SL_iterate(type_ptr->ids, H5I__debug_cb, &type);
+    for(item = type_ptr->head; item; item = item->next)
+        if(!item->marked)
+            H5I__debug_cb(item, type);
 
     FUNC_LEAVE_NOAPI(SUCCEED)
 } /* end H5I__debug() */
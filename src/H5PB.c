@@ -32,6 +32,7 @@
 /* Headers */
 /***********/
 #include "H5private.h"		/* Generic Functions			*/
+#include "H5CXprivate.h"        /* API Contexts                         */
 #include "H5Eprivate.h"		/* Error handling		  	*/
 #include "H5Fpkg.h"		/* Files				*/
 #include "H5FDprivate.h"	/* File drivers				*/
@@ -43,6 +44,54 @@
 /****************/
 /* Local Macros */
 /****************/
+
+/* Whether write-behind drains are performed by a background thread */
+#if defined(H5_HAVE_THREADSAFE) && defined(H5TP_HAVE_THREADS)
+#define H5PB_WB_HAVE_THREAD
+#define H5PB_WB_NTHREADS        1
+#else /* defined(H5_HAVE_THREADSAFE) && defined(H5TP_HAVE_THREADS) */
+#define H5PB_WB_NTHREADS        0
+#endif /* defined(H5_HAVE_THREADSAFE) && defined(H5TP_HAVE_THREADS) */
+
+/* Max. # of pages written together by a write-behind drain */
+#define H5PB_WB_BATCH_SIZE      64
+
+/* Max. # of pages read together when prefetching raw data */
+#define H5PB_PREFETCH_BATCH_SIZE 64
+
+/* Hash function for the page index: pages are aligned, so consecutive
+ * pages fall in consecutive buckets
+ */
+#define H5PB__HASH(page_buf, addr)                                      \
+        ((size_t)((addr) / (page_buf)->page_size) & ((page_buf)->index_len - 1))
+
+#define H5PB__INDEX_INSERT(page_buf, page_ptr) {                        \
+        size_t _k = H5PB__HASH(page_buf, (page_ptr)->addr);             \
+                                                                        \
+        (page_ptr)->ht_prev = NULL;                                     \
+        (page_ptr)->ht_next = (page_buf)->index[_k];                    \
+        if((page_ptr)->ht_next != NULL)                                 \
+            (page_ptr)->ht_next->ht_prev = (page_ptr);                  \
+        (page_buf)->index[_k] = (page_ptr);                             \
+}
+
+#define H5PB__INDEX_REMOVE(page_buf, page_ptr) {                        \
+        if((page_ptr)->ht_prev != NULL)                                 \
+            (page_ptr)->ht_prev->ht_next = (page_ptr)->ht_next;         \
+        else                                                            \
+            (page_buf)->index[H5PB__HASH(page_buf, (page_ptr)->addr)] = (page_ptr)->ht_next; \
+        if((page_ptr)->ht_next != NULL)                                 \
+            (page_ptr)->ht_next->ht_prev = (page_ptr)->ht_prev;         \
+        (page_ptr)->ht_next = NULL;                                     \
+        (page_ptr)->ht_prev = NULL;                                     \
+}
+
+#define H5PB__INDEX_SEARCH(page_buf, search_addr, page_ptr) {           \
+        (page_ptr) = (page_buf)->index[H5PB__HASH(page_buf, search_addr)]; \
+        while((page_ptr) != NULL && (page_ptr)->addr != (search_addr))  \
+            (page_ptr) = (page_ptr)->ht_next;                           \
+}
+
 #define H5PB__PREPEND(page_ptr, head_ptr, tail_ptr, len) {              \
         if((head_ptr) == NULL) {                                        \
             (head_ptr) = (page_ptr);                                    \
@@ -92,6 +141,20 @@
                      (page_buf)->LRU_tail_ptr, (page_buf)->LRU_list_len) \
 }
 
+#define H5PB__MARK_DIRTY(page_buf, page_ptr) {                          \
+        if(!(page_ptr)->is_dirty) {                                     \
+            (page_ptr)->is_dirty = TRUE;                                \
+            (page_buf)->dirty_count++;                                  \
+        } /* end if */                                                  \
+}
+
+#define H5PB__MARK_CLEAN(page_buf, page_ptr) {                          \
+        if((page_ptr)->is_dirty) {                                      \
+            (page_ptr)->is_dirty = FALSE;                               \
+            (page_buf)->dirty_count--;                                  \
+        } /* end if */                                                  \
+}
+
 #define H5PB__MOVE_TO_TOP_LRU(page_buf, page_ptr) {                     \
         HDassert(page_buf);                                             \
         HDassert(page_ptr);                                             \
@@ -113,6 +176,25 @@ typedef struct {
     hbool_t actual_slist;
 } H5PB_ud1_t;
 
+/* Pages collected by a write-behind drain, to be written together */
+typedef struct {
+    size_t nentries;                                /* # of pages */
+    H5PB_entry_t *entries[H5PB_WB_BATCH_SIZE];      /* Page entries */
+    H5FD_mem_t types[H5PB_WB_BATCH_SIZE];           /* Types of pages */
+    haddr_t addrs[H5PB_WB_BATCH_SIZE];              /* Addresses of pages */
+    size_t sizes[H5PB_WB_BATCH_SIZE];               /* Sizes to write, up to the EOA */
+    const void *bufs[H5PB_WB_BATCH_SIZE];           /* Page buffers */
+} H5PB_wb_batch_t;
+
+/* Raw data pages collected by a prefetch, to be read together */
+typedef struct {
+    size_t nentries;                                /* # of pages */
+    H5FD_mem_t types[H5PB_PREFETCH_BATCH_SIZE];     /* Types of pages */
+    haddr_t addrs[H5PB_PREFETCH_BATCH_SIZE];        /* Addresses of pages */
+    size_t sizes[H5PB_PREFETCH_BATCH_SIZE];         /* Sizes to read, up to the EOA */
+    void *bufs[H5PB_PREFETCH_BATCH_SIZE];           /* Page buffers */
+} H5PB_prefetch_batch_t;
+
 
 /********************/
 /* Package Typedefs */
@@ -125,6 +207,12 @@ typedef struct {
 static herr_t H5PB__insert_entry(H5PB_t *page_buf, H5PB_entry_t *page_entry);
 static htri_t H5PB__make_space(H5F_t *f, H5PB_t *page_buf, H5FD_mem_t inserted_type);
 static herr_t H5PB__write_entry(H5F_t *f, H5PB_entry_t *page_entry);
+static herr_t H5PB__prefetch(H5F_t *f, H5PB_t *page_buf, haddr_t page_addr);
+static herr_t H5PB__wb_start(H5F_t *f, H5PB_t *page_buf);
+static herr_t H5PB__wb_wait(H5PB_t *page_buf);
+static herr_t H5PB__wb_exec(void *_shared);
+static herr_t H5PB__wb_write(H5F_file_t *shared);
+static herr_t H5PB__wb_write_batch(H5F_file_t *shared, H5PB_wb_batch_t *batch);
 
 
 /*********************/
@@ -149,6 +237,10 @@ H5FL_DEFINE_STATIC(H5PB_t);
 /* Declare a free list to manage the H5PB_entry_t struct */
 H5FL_DEFINE_STATIC(H5PB_entry_t);
 
+/* Declare a free list to manage the page index */
+typedef H5PB_entry_t *H5PB_entry_ptr_t;
+H5FL_SEQ_DEFINE_STATIC(H5PB_entry_ptr_t);
+
 
 
 /*-------------------------------------------------------------------------
@@ -183,6 +275,7 @@ H5PB_reset_stats(H5PB_t *page_buf)
     page_buf->evictions[1] = 0;
     page_buf->bypasses[0] = 0;
     page_buf->bypasses[1] = 0;
+    page_buf->prefetches = 0;
 
     FUNC_LEAVE_NOAPI(SUCCEED)
 }  /* H5PB_reset_stats() */
@@ -269,6 +362,7 @@ H5PB_print_stats(const H5PB_t *page_buf)
     HDprintf("\t Misses: %u\n", page_buf->misses[1]);
     HDprintf("\t Evictions: %u\n", page_buf->evictions[1]);
     HDprintf("\t Bypasses: %u\n", page_buf->bypasses[1]);
+    HDprintf("\t Prefetches: %u\n", page_buf->prefetches);
     HDprintf("\t Hit Rate = %f%%\n", ((double)page_buf->hits[1]/(page_buf->accesses[1]-page_buf->bypasses[0]))*100);
     HDprintf("*****************\n\n");
 
@@ -281,6 +375,19 @@ H5PB_print_stats(const H5PB_t *page_buf)
  *
  * Purpose:	Create and setup the PB on the file.
  *
+ *              If WB_HIGH is non-zero and the file is writable, dirty
+ *              pages are written behind: when WB_HIGH bytes of pages are
+ *              dirty, they're written in address order until no more than
+ *              WB_LOW bytes are dirty.
+ *
+ *              If PREFETCH is non-zero, up to PREFETCH raw data pages are
+ *              read ahead when a sequential read misses.
+ *
+ *              With MPI-IO, metadata pages are written through to the
+ *              file as they're written, so they're never dirty and
+ *              write-behind is not used.  Raw data bypasses the page
+ *              buffer.
+ *
  * Return:	Non-negative on success/Negative on failure
  *
  * Programmer:	Mohamad Chaarawi
@@ -288,9 +395,11 @@ H5PB_print_stats(const H5PB_t *page_buf)
  *-------------------------------------------------------------------------
  */
 herr_t
-H5PB_create(H5F_t *f, size_t size, unsigned page_buf_min_meta_perc, unsigned page_buf_min_raw_perc)
+H5PB_create(H5F_t *f, size_t size, unsigned page_buf_min_meta_perc, unsigned page_buf_min_raw_perc,
+    size_t wb_high, size_t wb_low, size_t prefetch)
 {
     H5PB_t *page_buf = NULL;
+    size_t npages;                 /* Max. # of pages in the page buffer */
     herr_t ret_value = SUCCEED;    /* Return value */
 
     FUNC_ENTER_NOAPI(FAIL)
@@ -311,6 +420,8 @@ H5PB_create(H5F_t *f, size_t size, unsigned page_buf_min_meta_perc, unsigned pag
     } /* end if */
     else if(0 != size % f->shared->fs_page_size)
         HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTINIT, FAIL, "Page Buffer size must be >= to the page size")
+    if(wb_low > wb_high)
+        HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTINIT, FAIL, "write-behind low watermark can't be bigger than high watermark")
 
     /* Allocate the new page buffering structure */
     if(NULL == (page_buf = H5FL_CALLOC(H5PB_t)))
@@ -332,9 +443,30 @@ H5PB_create(H5F_t *f, size_t size, unsigned page_buf_min_meta_perc, unsigned pag
     if(NULL == (page_buf->mf_slist_ptr = H5SL_create(H5SL_TYPE_HADDR, NULL)))
         HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTCREATE, FAIL, "can't create skip list")
 
+    /* Size the page index to the max. # of pages, so buckets hold one page
+     * on average
+     */
+    npages = size / page_buf->page_size;
+    page_buf->index_len = 1;
+    while(page_buf->index_len < npages)
+        page_buf->index_len *= 2;
+    if(NULL == (page_buf->index = H5FL_SEQ_CALLOC(H5PB_entry_ptr_t, page_buf->index_len)))
+        HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTALLOC, FAIL, "can't allocate page index")
+
     if(NULL == (page_buf->page_fac = H5FL_fac_init(page_buf->page_size)))
         HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTINIT, FAIL, "can't create page factory")
 
+    /* Set up write-behind */
+    page_buf->wb_high = wb_high;
+    page_buf->wb_low = wb_low;
+    if(wb_high > 0 && (H5F_ACC_RDWR & H5F_INTENT(f)) && !H5F_HAS_FEATURE(f, H5FD_FEAT_HAS_MPI))
+        if(NULL == (page_buf->wb_pool = H5TP_create(H5PB_WB_NTHREADS)))
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTCREATE, FAIL, "can't create write-behind thread pool")
+
+    /* Set up raw data prefetch */
+    page_buf->prefetch_max = prefetch;
+    page_buf->raw_last_addr = HADDR_UNDEF;
+
     f->shared->page_buf = page_buf;
 
 done:
@@ -344,8 +476,12 @@ done:
                 H5SL_close(page_buf->slist_ptr);
             if(page_buf->mf_slist_ptr != NULL)
                 H5SL_close(page_buf->mf_slist_ptr);
+            if(page_buf->index != NULL)
+                page_buf->index = H5FL_SEQ_FREE(H5PB_entry_ptr_t, page_buf->index);
             if(page_buf->page_fac != NULL)
                 H5FL_fac_term(page_buf->page_fac);
+            if(page_buf->wb_pool != NULL)
+                H5TP_close(page_buf->wb_pool);
             page_buf = H5FL_FREE(H5PB_t, page_buf);
         } /* end if */
     } /* end if */
@@ -393,6 +529,8 @@ done:
  *
  * Purpose:	Flush/Free all the PB entries to the file.
  *
+ *              A write-behind drain in progress is waited for first.
+ *
  * Return:	Non-negative on success/Negative on failure
  *
  * Programmer:	Mohamad Chaarawi
@@ -413,9 +551,18 @@ H5PB_flush(H5F_t *f)
     if(f->shared->page_buf && (H5F_ACC_RDWR & H5F_INTENT(f))) {
         H5PB_t *page_buf = f->shared->page_buf;
 
+        /* Wait for a write-behind drain */
+        if(H5PB__wb_wait(page_buf) < 0)
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTFLUSH, FAIL, "can't wait for write-behind of page buffer")
+
         /* Iterate over all entries in page buffer skip list */
         if(H5SL_iterate(page_buf->slist_ptr, H5PB__flush_cb, (void *)f))
             HGOTO_ERROR(H5E_PAGEBUF, H5E_BADITER, FAIL, "can't flush page buffer skip list")
+
+        /* Pages a failed drain left dirty were just written, so let
+         * write-behind start again
+         */
+        page_buf->wb_failed = FALSE;
     } /* end if */
 
 done:
@@ -489,6 +636,15 @@ H5PB_dest(H5F_t *f)
         if(H5PB_flush(f) < 0)
             HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTFLUSH, FAIL, "can't flush page buffer")
 
+        /* Shut down write-behind */
+        if(page_buf->wb_pool) {
+            if(H5PB__wb_wait(page_buf) < 0)
+                HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTFLUSH, FAIL, "can't wait for write-behind of page buffer")
+            if(H5TP_close(page_buf->wb_pool) < 0)
+                HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTRELEASE, FAIL, "can't close write-behind thread pool")
+            page_buf->wb_pool = NULL;
+        } /* end if */
+
         /* Set up context info */
         op_data.page_buf = page_buf;
 
@@ -502,6 +658,9 @@ H5PB_dest(H5F_t *f)
         if(H5SL_destroy(page_buf->mf_slist_ptr, H5PB__dest_cb, &op_data))
             HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTCLOSEOBJ, FAIL, "can't destroy page buffer skip list")
 
+        /* Free the page index */
+        page_buf->index = H5FL_SEQ_FREE(H5PB_entry_ptr_t, page_buf->index);
+
         /* Destroy the page factory */
         if(H5FL_fac_term(page_buf->page_fac) < 0)
             HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTRELEASE, FAIL, "can't destroy page buffer page factory")
@@ -540,6 +699,12 @@ H5PB_add_new_page(H5F_t *f, H5FD_mem_t type, haddr_t page_addr)
     /* Sanity checks */
     HDassert(page_buf);
 
+#ifdef H5_HAVE_PARALLEL
+    /* With MPI-IO, writes bypass the page buffer and never use new pages */
+    if(H5F_HAS_FEATURE(f, H5FD_FEAT_HAS_MPI))
+        HGOTO_DONE(SUCCEED)
+#endif /* H5_HAVE_PARALLEL */
+
     /* If there is an existing page, this means that at some point the
      * file free space manager freed and re-allocated a page at the same
      * address.  No need to do anything here then...
@@ -603,7 +768,7 @@ H5PB_update_entry(H5PB_t *page_buf, haddr_t addr, size_t size, const void *buf)
     page_addr = (addr / page_buf->page_size) * page_buf->page_size;
 
     /* search for the page and update if found */
-    page_entry = (H5PB_entry_t *)H5SL_search(page_buf->slist_ptr, (void *)(&page_addr));
+    H5PB__INDEX_SEARCH(page_buf, page_addr, page_entry)
     if(page_entry) {
         haddr_t offset;
 
@@ -646,14 +811,15 @@ H5PB_remove_entry(const H5F_t *f, haddr_t addr)
     /* Sanity checks */
     HDassert(page_buf);
 
-    /* Search for address in the skip list */
-    page_entry = (H5PB_entry_t *)H5SL_search(page_buf->slist_ptr, (void *)(&addr));
+    /* Search for address in the page index */
+    H5PB__INDEX_SEARCH(page_buf, addr, page_entry)
 
     /* If found, remove the entry from the PB cache */
     if(page_entry) {
         HDassert(page_entry->type != H5F_MEM_PAGE_DRAW);
         if(NULL == H5SL_remove(page_buf->slist_ptr, &(page_entry->addr)))
             HGOTO_ERROR(H5E_CACHE, H5E_BADVALUE, FAIL, "Page Entry is not in skip list")
+        H5PB__INDEX_REMOVE(page_buf, page_entry)
 
         /* Remove from LRU list */
         H5PB__REMOVE_LRU(page_buf, page_entry)
@@ -661,6 +827,9 @@ H5PB_remove_entry(const H5F_t *f, haddr_t addr)
 
         page_buf->meta_count--;
 
+        /* The page is discarded without being written */
+        H5PB__MARK_CLEAN(page_buf, page_entry)
+
         page_entry->page_buf_ptr = H5FL_FAC_FREE(page_buf->page_fac, page_entry->page_buf_ptr);
         page_entry = H5FL_FREE(H5PB_entry_t, page_entry);
     } /* end if */
@@ -694,6 +863,7 @@ H5PB_read(H5F_t *f, H5FD_mem_t type, haddr_t addr, size_t size, void *buf/*out*/
     hsize_t num_touched_pages;          /* Number of pages accessed */
     size_t access_size;
     hbool_t bypass_pb = FALSE;          /* Whether to bypass page buffering */
+    hbool_t raw_miss = FALSE;           /* Whether a raw data page was read into the page buffer */
     hsize_t i;                          /* Local index variable */
     herr_t ret_value = SUCCEED;         /* Return value */
 
@@ -784,66 +954,46 @@ H5PB_read(H5F_t *f, H5FD_mem_t type, haddr_t addr, size_t size, void *buf/*out*/
     /* Copy raw data from dirty pages into the read buffer if the read
        request spans pages in the page buffer*/
     if(H5FD_MEM_DRAW == type && size >= page_buf->page_size) {
-        H5SL_node_t *node;
-
         /* For each touched page in the page buffer, check if it
          * exists in the page Buffer and is dirty. If it does, we
          * update the buffer with what's in the page so we get the up
          * to date data into the buffer after the big read from the file.
          */
-        node = H5SL_find(page_buf->slist_ptr, (void *)(&first_page_addr));
         for(i = 0; i < num_touched_pages; i++) {
             search_addr = i*page_buf->page_size + first_page_addr;
 
-            /* if we still haven't located a starting page, search again */
-            if(!node && i!=0)
-                node = H5SL_find(page_buf->slist_ptr, (void *)(&search_addr));
-
             /* if the current page is in the Page Buffer, do the updates */
-            if(node) {
-                page_entry = (H5PB_entry_t *)H5SL_item(node);
-
-                HDassert(page_entry);
+            H5PB__INDEX_SEARCH(page_buf, search_addr, page_entry)
+            if(page_entry && page_entry->is_dirty) {
+                /* special handling for the first page if it is not a full page access */
+                if(i == 0 && first_page_addr != addr) {
+                    offset = addr - first_page_addr;
+                    HDassert(page_buf->page_size > offset);
 
-                /* If the current page address falls out of the access
-                   block, then there are no more pages to go over */
-                if(page_entry->addr >= addr + size)
-                    break;
+                    HDmemcpy(buf, (uint8_t *)page_entry->page_buf_ptr + offset, 
+                             page_buf->page_size - (size_t)offset);
 
-                HDassert(page_entry->addr == search_addr);
+                    /* move to top of LRU list */
+                    H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
+                } /* end if */
+                /* special handling for the last page if it is not a full page access */
+                else if(num_touched_pages > 1 && i == num_touched_pages-1 && search_addr < addr+size) {
+                    offset = (num_touched_pages-2)*page_buf->page_size + 
+                        (page_buf->page_size - (addr - first_page_addr));
 
-                if(page_entry->is_dirty) {
-                    /* special handling for the first page if it is not a full page access */
-                    if(i == 0 && first_page_addr != addr) {
-                        offset = addr - first_page_addr;
-                        HDassert(page_buf->page_size > offset);
+                    HDmemcpy((uint8_t *)buf + offset, page_entry->page_buf_ptr,
+                             (size_t)((addr + size) - last_page_addr));
 
-                        HDmemcpy(buf, (uint8_t *)page_entry->page_buf_ptr + offset, 
-                                 page_buf->page_size - (size_t)offset);
+                    /* move to top of LRU list */
+                    H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
+                } /* end else-if */
+                /* copy the entire fully accessed pages */
+                else {
+                    offset = i*page_buf->page_size;
 
-                        /* move to top of LRU list */
-                        H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
-                    } /* end if */
-                    /* special handling for the last page if it is not a full page access */
-                    else if(num_touched_pages > 1 && i == num_touched_pages-1 && search_addr < addr+size) {
-                        offset = (num_touched_pages-2)*page_buf->page_size + 
-                            (page_buf->page_size - (addr - first_page_addr));
-
-                        HDmemcpy((uint8_t *)buf + offset, page_entry->page_buf_ptr,
-                                 (size_t)((addr + size) - last_page_addr));
-
-                        /* move to top of LRU list */
-                        H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
-                    } /* end else-if */
-                    /* copy the entire fully accessed pages */
-                    else {
-                        offset = i*page_buf->page_size;
-
-                        HDmemcpy((uint8_t *)buf+(i*page_buf->page_size) , page_entry->page_buf_ptr, 
-                             page_buf->page_size);
-                    } /* end else */
-                } /* end if */
-                node = H5SL_next(node);
+                    HDmemcpy((uint8_t *)buf+(i*page_buf->page_size) , page_entry->page_buf_ptr, 
+                         page_buf->page_size);
+                } /* end else */
             } /* end if */
         } /* end for */
     } /* end if */
@@ -863,8 +1013,8 @@ H5PB_read(H5F_t *f, H5FD_mem_t type, haddr_t addr, size_t size, void *buf/*out*/
             else
                 access_size = (0 == i ? (size_t)((first_page_addr + page_buf->page_size) - addr) : (size - access_size));
 
-            /* Lookup the page in the skip list */
-            page_entry = (H5PB_entry_t *)H5SL_search(page_buf->slist_ptr, (void *)(&search_addr));
+            /* Lookup the page in the page index */
+            H5PB__INDEX_SEARCH(page_buf, search_addr, page_entry)
 
             /* if found */
             if(page_entry) {
@@ -953,12 +1103,26 @@ H5PB_read(H5F_t *f, H5FD_mem_t type, haddr_t addr, size_t size, void *buf/*out*/
                     HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTSET, FAIL, "error inserting new page in page buffer")
 
                 /* Update statistics */
-                if(type == H5FD_MEM_DRAW)
+                if(type == H5FD_MEM_DRAW) {
                     page_buf->misses[1]++;
+                    raw_miss = TRUE;
+                } /* end if */
                 else
                     page_buf->misses[0]++;
             } /* end else */
         } /* end for */
+
+        /* Read raw data pages ahead of a sequential read which missed */
+        if(H5FD_MEM_DRAW == type && page_buf->prefetch_max > 0) {
+            haddr_t last_addr = (H5F_addr_defined(last_page_addr) ? last_page_addr : first_page_addr);
+
+            if(raw_miss && H5F_addr_defined(page_buf->raw_last_addr) &&
+                    (first_page_addr == page_buf->raw_last_addr ||
+                     first_page_addr == page_buf->raw_last_addr + page_buf->page_size))
+                if(H5PB__prefetch(f, page_buf, last_addr + page_buf->page_size) < 0)
+                    HGOTO_ERROR(H5E_PAGEBUF, H5E_READERROR, FAIL, "can't read ahead raw data pages")
+            page_buf->raw_last_addr = last_addr;
+        } /* end if */
     } /* end else */
 
 done:
@@ -1044,7 +1208,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
 
 #ifdef H5_HAVE_PARALLEL
         if(bypass_pb) {
-            if(H5PB_update_entry(page_buf, addr, size, buf) > 0)
+            if(H5PB_update_entry(page_buf, addr, size, buf) < 0)
                 HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTUPDATE, FAIL, "failed to update PB with metadata cache")
             HGOTO_DONE(SUCCEED)
         } /* end if */
@@ -1096,7 +1260,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
             /* Special handling for the first page if it is not a full page update */
             if(i == 0 && first_page_addr != addr) {
                 /* Lookup the page in the skip list */
-                page_entry = (H5PB_entry_t *)H5SL_search(page_buf->slist_ptr, (void *)(&search_addr));
+                H5PB__INDEX_SEARCH(page_buf, search_addr, page_entry)
                 if(page_entry) {
                     offset = addr - first_page_addr;
                     HDassert(page_buf->page_size > offset);
@@ -1105,7 +1269,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                     HDmemcpy((uint8_t *)page_entry->page_buf_ptr + offset, buf, page_buf->page_size - (size_t)offset);
 
                     /* Mark page dirty and push to top of LRU */
-                    page_entry->is_dirty = TRUE;
+                    H5PB__MARK_DIRTY(page_buf, page_entry)
                     H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
                 } /* end if */
             } /* end if */
@@ -1115,7 +1279,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                 HDassert(search_addr+page_buf->page_size > addr+size);
 
                 /* Lookup the page in the skip list */
-                page_entry = (H5PB_entry_t *)H5SL_search(page_buf->slist_ptr, (void *)(&search_addr));
+                H5PB__INDEX_SEARCH(page_buf, search_addr, page_entry)
                 if(page_entry) {
                     offset = (num_touched_pages - 2) * page_buf->page_size + 
                         (page_buf->page_size - (addr - first_page_addr));
@@ -1125,15 +1289,18 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                              (size_t)((addr + size) - last_page_addr));
 
                     /* Mark page dirty and push to top of LRU */
-                    page_entry->is_dirty = TRUE;
+                    H5PB__MARK_DIRTY(page_buf, page_entry)
                     H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
                 } /* end if */
             } /* end else-if */
             /* Discard all fully written pages from the page buffer */
             else {
-                page_entry = (H5PB_entry_t *)H5SL_remove(page_buf->slist_ptr, (void *)(&search_addr));
+                H5PB__INDEX_SEARCH(page_buf, search_addr, page_entry)
                 if(page_entry) {
-                    /* Remove from LRU list */
+                    /* Remove from skip list, page index and LRU list */
+                    if(NULL == H5SL_remove(page_buf->slist_ptr, &(page_entry->addr)))
+                        HGOTO_ERROR(H5E_PAGEBUF, H5E_BADVALUE, FAIL, "Page Entry is not in skip list")
+                    H5PB__INDEX_REMOVE(page_buf, page_entry)
                     H5PB__REMOVE_LRU(page_buf, page_entry)
 
                     /* Decrement page count of appropriate type */
@@ -1142,6 +1309,9 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                     else
                         page_buf->meta_count--;
 
+                    /* The page is overwritten, so there's no need to write it */
+                    H5PB__MARK_CLEAN(page_buf, page_entry)
+
                     /* Free page info */
                     page_entry->page_buf_ptr = H5FL_FAC_FREE(page_buf->page_fac, page_entry->page_buf_ptr);
                     page_entry = H5FL_FREE(H5PB_entry_t, page_entry);
@@ -1165,7 +1335,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                 access_size = (0 == i ? (size_t)(first_page_addr + page_buf->page_size - addr) : (size - access_size));
 
             /* Lookup the page in the skip list */
-            page_entry = (H5PB_entry_t *)H5SL_search(page_buf->slist_ptr, (void *)(&search_addr));
+            H5PB__INDEX_SEARCH(page_buf, search_addr, page_entry)
 
             /* If found */
             if(page_entry) {
@@ -1176,7 +1346,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                 HDmemcpy((uint8_t *)page_entry->page_buf_ptr + offset, (const uint8_t *)buf + buf_offset, access_size);
 
                 /* Mark page dirty and push to top of LRU */
-                page_entry->is_dirty = TRUE;
+                H5PB__MARK_DIRTY(page_buf, page_entry)
                 H5PB__MOVE_TO_TOP_LRU(page_buf, page_entry)
 
                 /* Update statistics */
@@ -1292,7 +1462,7 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
                 HDmemcpy((uint8_t *)new_page_buf + offset, (const uint8_t *)buf+buf_offset, access_size);
 
                 /* Page is dirty now */
-                page_entry->is_dirty = TRUE;
+                H5PB__MARK_DIRTY(page_buf, page_entry)
 
                 /* Insert page into PB, evicting other pages as necessary */
                 if(H5PB__insert_entry(page_buf, page_entry) < 0)
@@ -1301,6 +1471,11 @@ H5PB_write(H5F_t *f, H5FD_mem_t type, haddr_t addr,
         } /* end for */
     } /* end else */
 
+    /* Start writing dirty pages behind, if enough of them are dirty */
+    if(page_buf->wb_pool)
+        if(H5PB__wb_start(f, page_buf) < 0)
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_WRITEERROR, FAIL, "can't start write-behind of page buffer")
+
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5PB_write() */
@@ -1337,10 +1512,11 @@ H5PB__insert_entry(H5PB_t *page_buf, H5PB_entry_t *page_entry)
 
     FUNC_ENTER_STATIC
 
-    /* Insert entry in skip list */
+    /* Insert entry in skip list and page index */
     if(H5SL_insert(page_buf->slist_ptr, page_entry, &(page_entry->addr)) < 0)
         HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTINSERT, FAIL, "can't insert entry in skip list")
     HDassert(H5SL_count(page_buf->slist_ptr) * page_buf->page_size <= page_buf->max_size);
+    H5PB__INDEX_INSERT(page_buf, page_entry)
 
     /* Increment appropriate page count */
     if(H5F_MEM_PAGE_DRAW == page_entry->type || H5F_MEM_PAGE_GHEAP == page_entry->type)
@@ -1427,9 +1603,34 @@ H5PB__make_space(H5F_t *f, H5PB_t *page_buf, H5FD_mem_t inserted_type)
         } /* end while */
     } /* end else */
 
-    /* Remove from page index */
+    /* With write-behind, prefer the oldest clean page that can be evicted,
+     * leaving dirty pages to be written in address order by a drain
+     */
+    if(page_buf->wb_pool && page_entry->is_dirty && page_buf->dirty_count < page_buf->LRU_list_len) {
+        H5PB_entry_t *clean_entry;      /* Pointer to clean eviction candidate */
+
+        for(clean_entry = page_entry->prev; clean_entry; clean_entry = clean_entry->prev) {
+            hbool_t is_raw = (H5F_MEM_PAGE_DRAW == clean_entry->type || H5F_MEM_PAGE_GHEAP == clean_entry->type);
+
+            /* Skip pages kept by the metadata or raw data threshold */
+            if(clean_entry->is_dirty)
+                continue;
+            if(H5FD_MEM_DRAW == inserted_type) {
+                if(H5F_MEM_PAGE_META == clean_entry->type && page_buf->min_meta_count >= page_buf->meta_count)
+                    continue;
+            } /* end if */
+            else if(is_raw && page_buf->min_raw_count >= page_buf->raw_count)
+                continue;
+
+            page_entry = clean_entry;
+            break;
+        } /* end for */
+    } /* end if */
+
+    /* Remove from skip list and page index */
     if(NULL == H5SL_remove(page_buf->slist_ptr, &(page_entry->addr)))
         HGOTO_ERROR(H5E_PAGEBUF, H5E_BADVALUE, FAIL, "Tail Page Entry is not in skip list")
+    H5PB__INDEX_REMOVE(page_buf, page_entry)
 
     /* Remove entry from LRU list */
     H5PB__REMOVE_LRU(page_buf, page_entry)
@@ -1510,9 +1711,405 @@ H5PB__write_entry(H5F_t *f, H5PB_entry_t *page_entry)
             HGOTO_ERROR(H5E_PAGEBUF, H5E_WRITEERROR, FAIL, "file write failed")
     } /* end if */
 
-    page_entry->is_dirty = FALSE;
+    H5PB__MARK_CLEAN(f->shared->page_buf, page_entry)
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5PB__write_entry() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5PB__prefetch()
+ *
+ * Purpose:     Reads raw data pages ahead of a sequential read, starting
+ *              at PAGE_ADDR, and inserts them in the page buffer.  Pages
+ *              are read with vector reads, in batches.
+ *
+ *              At most half of the page buffer is read ahead, so the
+ *              pages read are still cached when they're used.  Reading
+ *              stops at the EOA, at the first page already in the page
+ *              buffer, and when no space can be made for raw data.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5PB__prefetch(H5F_t *f, H5PB_t *page_buf, haddr_t page_addr)
+{
+    H5PB_prefetch_batch_t batch;        /* Pages to read together */
+    size_t max_pages;                   /* Max. # of pages to read ahead */
+    size_t npages = 0;                  /* # of pages read ahead */
+    hbool_t stop = FALSE;               /* Whether to stop reading ahead */
+    haddr_t eoa;                        /* Current EOA for the file */
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(f);
+    HDassert(page_buf);
+    HDassert(page_buf->prefetch_max > 0);
+
+    batch.nentries = 0;
+    max_pages = MIN(page_buf->prefetch_max, (page_buf->max_size / page_buf->page_size) / 2);
+
+    /* Retrieve the 'eoa' for the file */
+    if(HADDR_UNDEF == (eoa = H5F_get_eoa(f, H5FD_MEM_DRAW)))
+        HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTGET, FAIL, "driver get_eoa request failed")
+
+    while(!stop && npages < max_pages) {
+        /* Collect the pages to read */
+        while(batch.nentries < H5PB_PREFETCH_BATCH_SIZE && (npages + batch.nentries) < max_pages) {
+            H5PB_entry_t *page_entry;       /* Page already in the page buffer */
+            size_t page_size = page_buf->page_size;
+
+            if(H5F_addr_ge(page_addr, eoa)) {
+                stop = TRUE;
+                break;
+            } /* end if */
+            H5PB__INDEX_SEARCH(page_buf, page_addr, page_entry)
+            if(page_entry) {
+                stop = TRUE;
+                break;
+            } /* end if */
+
+            /* Adjust the page length if it exceeds the EOA */
+            if((page_addr + page_size) > eoa)
+                page_size = (size_t)(eoa - page_addr);
+
+            if(NULL == (batch.bufs[batch.nentries] = H5FL_FAC_MALLOC(page_buf->page_fac)))
+                HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTALLOC, FAIL, "memory allocation failed for page buffer entry")
+            batch.types[batch.nentries] = H5FD_MEM_DRAW;
+            batch.addrs[batch.nentries] = page_addr;
+            batch.sizes[batch.nentries] = page_size;
+            batch.nentries++;
+
+            page_addr += page_buf->page_size;
+        } /* end while */
+        if(0 == batch.nentries)
+            break;
+
+        /* Read the pages */
+        if(H5FD_read_vector(f->shared->lf, batch.nentries, batch.types, batch.addrs, batch.sizes, batch.bufs) < 0)
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_READERROR, FAIL, "driver read request failed")
+
+        /* Insert the pages in the page buffer */
+        for(u = 0; u < batch.nentries; u++) {
+            H5PB_entry_t *page_entry;       /* New page entry */
+
+            /* Make space for the page, evicting another if necessary */
+            if((H5SL_count(page_buf->slist_ptr) * page_buf->page_size) >= page_buf->max_size) {
+                htri_t can_make_space;
+
+                if((can_make_space = H5PB__make_space(f, page_buf, H5FD_MEM_DRAW)) < 0)
+                    HGOTO_ERROR(H5E_PAGEBUF, H5E_NOSPACE, FAIL, "make space in Page buffer Failed")
+                if(0 == can_make_space) {
+                    stop = TRUE;
+                    break;
+                } /* end if */
+            } /* end if */
+
+            if(NULL == (page_entry = H5FL_CALLOC(H5PB_entry_t)))
+                HGOTO_ERROR(H5E_PAGEBUF, H5E_NOSPACE, FAIL, "memory allocation failed")
+            page_entry->page_buf_ptr = batch.bufs[u];
+            page_entry->addr = batch.addrs[u];
+            page_entry->type = H5F_MEM_PAGE_DRAW;
+            page_entry->is_dirty = FALSE;
+            batch.bufs[u] = NULL;
+
+            if(H5PB__insert_entry(page_buf, page_entry) < 0)
+                HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTSET, FAIL, "error inserting new page in page buffer")
+
+            /* Update statistics */
+            page_buf->prefetches++;
+        } /* end for */
+
+        /* Release pages which weren't inserted */
+        for(; u < batch.nentries; u++)
+            batch.bufs[u] = H5FL_FAC_FREE(page_buf->page_fac, batch.bufs[u]);
+
+        npages += batch.nentries;
+        batch.nentries = 0;
+    } /* end while */
+
+done:
+    /* Release pages which weren't inserted */
+    for(u = 0; u < batch.nentries; u++)
+        if(batch.bufs[u])
+            batch.bufs[u] = H5FL_FAC_FREE(page_buf->page_fac, batch.bufs[u]);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5PB__prefetch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5PB__wb_start()
+ *
+ * Purpose:     Starts a write-behind drain if the dirty pages have reached
+ *              the high watermark and no drain is pending.
+ *
+ *              In thread-safe builds the drain is run by a background
+ *              thread, which takes the API lock and so runs when no other
+ *              thread is in the library.  Otherwise the drain runs before
+ *              this routine returns.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5PB__wb_start(H5F_t *f, H5PB_t *page_buf)
+{
+    herr_t ret_value = SUCCEED;    /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(f);
+    HDassert(page_buf);
+    HDassert(page_buf->wb_pool);
+
+    /* Collect a drain that has finished, so another can start */
+    if(page_buf->wb_pending && !page_buf->wb_active)
+        if(H5PB__wb_wait(page_buf) < 0)
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTWAIT, FAIL, "can't wait for write-behind drain")
+
+    /* Don't start again after a failure, until the next flush */
+    if(page_buf->wb_pending || page_buf->wb_failed)
+        HGOTO_DONE(SUCCEED)
+    if((size_t)page_buf->dirty_count * page_buf->page_size < page_buf->wb_high)
+        HGOTO_DONE(SUCCEED)
+
+    page_buf->wb_pending = TRUE;
+    page_buf->wb_active = TRUE;
+    if(H5TP_submit(page_buf->wb_pool, &page_buf->wb_task, H5PB__wb_exec, f->shared) < 0) {
+        page_buf->wb_pending = FALSE;
+        page_buf->wb_active = FALSE;
+        HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTINSERT, FAIL, "can't submit write-behind drain")
+    } /* end if */
+
+    /* A drain run in place has finished already */
+    if(!page_buf->wb_active)
+        if(H5PB__wb_wait(page_buf) < 0)
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTWAIT, FAIL, "can't wait for write-behind drain")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5PB__wb_start() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5PB__wb_wait()
+ *
+ * Purpose:     Waits for a pending write-behind drain to finish.  A
+ *              failed drain leaves its pages dirty and stops write-behind
+ *              until the next flush, which writes them.
+ *
+ *              In thread-safe builds, the API lock is released while
+ *              waiting for a drain that hasn't finished, so the worker
+ *              thread can take it.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5PB__wb_wait(H5PB_t *page_buf)
+{
+#ifdef H5PB_WB_HAVE_THREAD
+    hbool_t release_lock;               /* Whether to release the API lock */
+    unsigned lock_count = 0;            /* # of times API lock was held */
+#endif /* H5PB_WB_HAVE_THREAD */
+    herr_t wait_ret;                    /* Result of waiting */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(page_buf);
+
+    if(!page_buf->wb_pending)
+        HGOTO_DONE(SUCCEED)
+
+#ifdef H5PB_WB_HAVE_THREAD
+    release_lock = page_buf->wb_active;
+    if(release_lock)
+        if(H5TS_mutex_unlock_all(&H5_g.init_lock, &lock_count))
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTUNLOCK, FAIL, "can't release API lock")
+#endif /* H5PB_WB_HAVE_THREAD */
+
+    wait_ret = H5TP_task_wait(page_buf->wb_pool, &page_buf->wb_task);
+
+#ifdef H5PB_WB_HAVE_THREAD
+    if(release_lock)
+        if(H5TS_mutex_relock(&H5_g.init_lock, lock_count))
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTLOCK, FAIL, "can't re-acquire API lock")
+#endif /* H5PB_WB_HAVE_THREAD */
+
+    if(wait_ret < 0)
+        HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTWAIT, FAIL, "can't wait for write-behind drain")
+
+    page_buf->wb_pending = FALSE;
+    if(page_buf->wb_task.status < 0)
+        page_buf->wb_failed = TRUE;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5PB__wb_wait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5PB__wb_exec()
+ *
+ * Purpose:     Thread pool callback which performs a write-behind drain,
+ *              holding the API lock and in an API context of its own, as
+ *              an API routine would.  Errors are reported through the
+ *              return value, and the error stack is left empty.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5PB__wb_exec(void *_shared)
+{
+    H5F_file_t *shared = (H5F_file_t *)_shared;     /* Shared file info */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(shared);
+    HDassert(shared->page_buf);
+
+    H5_API_LOCK
+
+    if(H5CX_push() < 0)
+        ret_value = FAIL;
+    else {
+        if(H5PB__wb_write(shared) < 0)
+            ret_value = FAIL;
+
+        (void)H5CX_pop();
+    } /* end else */
+
+    shared->page_buf->wb_active = FALSE;
+
+    /* Failures are reported to whoever waits for the drain */
+    (void)H5E_clear_stack(NULL);
+
+    H5_API_UNLOCK
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5PB__wb_exec() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5PB__wb_write()
+ *
+ * Purpose:     Writes dirty pages in address order, in batches of
+ *              vector writes, until no more than the low watermark of
+ *              bytes is dirty.  Pages are marked clean as they're written,
+ *              and pages past the EOA are discarded, as by
+ *              H5PB__write_entry().
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5PB__wb_write(H5F_file_t *shared)
+{
+    H5PB_t *page_buf = shared->page_buf;        /* Page buffer */
+    H5PB_wb_batch_t batch;              /* Pages to write together */
+    H5SL_node_t *node;                  /* Current skip list node */
+    unsigned low_count;                 /* # of dirty pages to leave */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(page_buf);
+
+    batch.nentries = 0;
+    low_count = (unsigned)(page_buf->wb_low / page_buf->page_size);
+
+    node = H5SL_first(page_buf->slist_ptr);
+    while(node && (page_buf->dirty_count - batch.nentries) > low_count) {
+        H5PB_entry_t *page_entry = (H5PB_entry_t *)H5SL_item(node);
+        haddr_t eoa;                    /* Current EOA for the file */
+        size_t page_size = page_buf->page_size;
+
+        node = H5SL_next(node);
+        if(!page_entry->is_dirty)
+            continue;
+
+        /* Retrieve the 'eoa' for the file */
+        if(HADDR_UNDEF == (eoa = H5FD_get_eoa(shared->lf, (H5FD_mem_t)page_entry->type)))
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_CANTGET, FAIL, "driver get_eoa request failed")
+
+        /* Discard pages starting at or past the EOA */
+        if(page_entry->addr >= eoa) {
+            H5PB__MARK_CLEAN(page_buf, page_entry)
+            continue;
+        } /* end if */
+
+        /* Adjust the page length if it exceeds the EOA */
+        if((page_entry->addr + page_size) > eoa)
+            page_size = (size_t)(eoa - page_entry->addr);
+
+        batch.entries[batch.nentries] = page_entry;
+        batch.types[batch.nentries] = (H5FD_mem_t)page_entry->type;
+        batch.addrs[batch.nentries] = page_entry->addr;
+        batch.sizes[batch.nentries] = page_size;
+        batch.bufs[batch.nentries] = page_entry->page_buf_ptr;
+        batch.nentries++;
+
+        if(H5PB_WB_BATCH_SIZE == batch.nentries)
+            if(H5PB__wb_write_batch(shared, &batch) < 0)
+                HGOTO_ERROR(H5E_PAGEBUF, H5E_WRITEERROR, FAIL, "can't write dirty pages")
+    } /* end while */
+
+    if(batch.nentries > 0)
+        if(H5PB__wb_write_batch(shared, &batch) < 0)
+            HGOTO_ERROR(H5E_PAGEBUF, H5E_WRITEERROR, FAIL, "can't write dirty pages")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5PB__wb_write() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5PB__wb_write_batch()
+ *
+ * Purpose:     Writes the pages collected by a write-behind drain with
+ *              one vector write, marks them clean and empties the batch.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5PB__wb_write_batch(H5F_file_t *shared, H5PB_wb_batch_t *batch)
+{
+    size_t u;                           /* Local index variable */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC
+
+    /* Sanity check */
+    HDassert(shared);
+    HDassert(batch);
+
+    if(H5FD_write_vector(shared->lf, batch->nentries, batch->types, batch->addrs, batch->sizes, batch->bufs) < 0)
+        HGOTO_ERROR(H5E_PAGEBUF, H5E_WRITEERROR, FAIL, "file write failed")
+
+    for(u = 0; u < batch->nentries; u++)
+        H5PB__MARK_CLEAN(shared->page_buf, batch->entries[u])
+    batch->nentries = 0;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5PB__wb_write_batch() */
+
@@ -41,6 +41,10 @@ typedef struct H5PB_entry_t {
     /* Fields supporting replacement policies */
     struct H5PB_entry_t     *next;      /* next pointer in the LRU list */
     struct H5PB_entry_t     *prev;      /* previous pointer in the LRU list */
+
+    /* Fields supporting the page index */
+    struct H5PB_entry_t     *ht_next;   /* next pointer in the hash bucket */
+    struct H5PB_entry_t     *ht_prev;   /* previous pointer in the hash bucket */
 } H5PB_entry_t;
 
 
@@ -33,6 +33,7 @@
 #include "H5Fprivate.h"		/* File access				*/
 #include "H5FLprivate.h"	/* Free Lists                           */
 #include "H5SLprivate.h"	/* Skip List				*/
+#include "H5TPprivate.h"	/* Thread pools				*/
 
 
 /**************************/
@@ -58,7 +59,9 @@ typedef struct H5PB_t {
     unsigned            min_meta_count;     /* Minimum # of entries for metadata */
     unsigned            min_raw_count;      /* Minimum # of entries for raw data */
 
-    H5SL_t              *slist_ptr;         /* Skip list with all the active page entries */
+    H5SL_t              *slist_ptr;         /* Skip list with all the active page entries, in address order */
+    struct H5PB_entry_t **index;            /* Hash table of the active page entries, for lookups */
+    size_t              index_len;          /* Number of buckets in the hash table (a power of two) */
     H5SL_t              *mf_slist_ptr;      /* Skip list containing newly allocated page entries inserted from the MF layer */
 
     size_t              LRU_list_len;       /* Number of entries in the LRU (identical to slist_ptr count) */
@@ -67,12 +70,27 @@ typedef struct H5PB_t {
 
     H5FL_fac_head_t     *page_fac;           /* Factory for allocating pages */
 
+    /* Write-behind */
+    size_t              wb_high;            /* Dirty bytes which start a drain of dirty pages (0 if disabled) */
+    size_t              wb_low;             /* Dirty bytes at which a drain stops */
+    unsigned            dirty_count;        /* Number of dirty entries in the skip list */
+    H5TP_t              *wb_pool;           /* Thread pool which runs drains */
+    H5TP_task_t         wb_task;            /* Task for the current drain */
+    hbool_t             wb_pending;         /* Whether a drain was submitted and not yet waited for */
+    hbool_t             wb_active;          /* Whether the current drain hasn't finished */
+    hbool_t             wb_failed;          /* Whether a drain failed since the last flush */
+
+    /* Raw data prefetch */
+    size_t              prefetch_max;       /* Max. # of raw data pages read ahead of a sequential read (0 if disabled) */
+    haddr_t             raw_last_addr;      /* Address of the last raw data page read through the page buffer */
+
     /* Statistics */
     unsigned            accesses[2];
     unsigned            hits[2];
     unsigned            misses[2];
     unsigned            evictions[2];
     unsigned            bypasses[2];
+    unsigned            prefetches;         /* Number of raw data pages read ahead */
 } H5PB_t;
 
 /*****************************/
@@ -85,7 +103,8 @@ typedef struct H5PB_t {
 /***************************************/
 
 /* General routines */
-H5_DLL herr_t H5PB_create(H5F_t *file, size_t page_buffer_size, unsigned page_buf_min_meta_perc, unsigned page_buf_min_raw_perc);
+H5_DLL herr_t H5PB_create(H5F_t *file, size_t page_buffer_size, unsigned page_buf_min_meta_perc, unsigned page_buf_min_raw_perc,
+    size_t page_buf_wb_high, size_t page_buf_wb_low, size_t page_buf_prefetch);
 H5_DLL herr_t H5PB_flush(H5F_t *f);
 H5_DLL herr_t H5PB_dest(H5F_t *f);
 H5_DLL herr_t H5PB_add_new_page(H5F_t *f, H5FD_mem_t type, haddr_t page_addr);
@@ -61,6 +61,21 @@
 #define H5D_ACS_PREEMPT_READ_CHUNKS_DEF         H5D_CHUNK_CACHE_W0_DEFAULT
 #define H5D_ACS_PREEMPT_READ_CHUNKS_ENC         H5P__encode_double
 #define H5D_ACS_PREEMPT_READ_CHUNKS_DEC         H5P__decode_double
+/* Definition for replacement policy of raw data chunk cache */
+#define H5D_ACS_DATA_CACHE_POLICY_SIZE          sizeof(H5D_chunk_cache_policy_t)
+#define H5D_ACS_DATA_CACHE_POLICY_DEF           H5D_CHUNK_CACHE_POLICY_LRU
+#define H5D_ACS_DATA_CACHE_POLICY_ENC           H5P__dacc_chunk_cache_policy_enc
+#define H5D_ACS_DATA_CACHE_POLICY_DEC           H5P__dacc_chunk_cache_policy_dec
+/* Definition for read-ahead window of raw data chunk cache */
+#define H5D_ACS_DATA_CACHE_READ_AHEAD_SIZE      sizeof(size_t)
+#define H5D_ACS_DATA_CACHE_READ_AHEAD_DEF       0
+#define H5D_ACS_DATA_CACHE_READ_AHEAD_ENC       H5P__encode_size_t
+#define H5D_ACS_DATA_CACHE_READ_AHEAD_DEC       H5P__decode_size_t
+/* Definition for max. gap between uncached chunks read together */
+#define H5D_ACS_CHUNK_READ_GAP_SIZE             sizeof(size_t)
+#define H5D_ACS_CHUNK_READ_GAP_DEF              0
+#define H5D_ACS_CHUNK_READ_GAP_ENC              H5P__encode_size_t
+#define H5D_ACS_CHUNK_READ_GAP_DEC              H5P__decode_size_t
 /* Definitions for VDS view option */
 #define H5D_ACS_VDS_VIEW_SIZE                   sizeof(H5D_vds_view_t)
 #define H5D_ACS_VDS_VIEW_DEF                    H5D_VDS_LAST_AVAILABLE
@@ -121,6 +136,8 @@ static herr_t H5P__encode_chunk_cache_nbytes(const void *value, void **_pp,
 static herr_t H5P__decode_chunk_cache_nbytes(const void **_pp, void *_value);
 
 /* Property list callbacks */
+static herr_t H5P__dacc_chunk_cache_policy_enc(const void *value, void **pp, size_t *size);
+static herr_t H5P__dacc_chunk_cache_policy_dec(const void **pp, void *value);
 static herr_t H5P__dacc_vds_view_enc(const void *value, void **pp, size_t *size);
 static herr_t H5P__dacc_vds_view_dec(const void **pp, void *value);
 static herr_t H5P__dapl_vds_file_pref_set(hid_t prop_id, const char* name, size_t size, void* value);
@@ -197,6 +214,9 @@ H5P__dacc_reg_prop(H5P_genclass_t *pclass)
     size_t rdcc_nslots = H5D_ACS_DATA_CACHE_NUM_SLOTS_DEF;      /* Default raw data chunk cache # of slots */
     size_t rdcc_nbytes = H5D_ACS_DATA_CACHE_BYTE_SIZE_DEF;      /* Default raw data chunk cache # of bytes */
     double rdcc_w0 = H5D_ACS_PREEMPT_READ_CHUNKS_DEF;           /* Default raw data chunk cache dirty ratio */
+    H5D_chunk_cache_policy_t rdcc_policy = H5D_ACS_DATA_CACHE_POLICY_DEF; /* Default raw data chunk cache replacement policy */
+    size_t rdcc_read_ahead = H5D_ACS_DATA_CACHE_READ_AHEAD_DEF; /* Default raw data chunk cache read-ahead window */
+    size_t chunk_read_gap = H5D_ACS_CHUNK_READ_GAP_DEF;         /* Default max. gap between uncached chunks read together */
     H5D_vds_view_t virtual_view = H5D_ACS_VDS_VIEW_DEF;         /* Default VDS view option */
     hsize_t printf_gap = H5D_ACS_VDS_PRINTF_GAP_DEF;            /* Default VDS printf gap */
     herr_t ret_value = SUCCEED;         /* Return value */
@@ -218,6 +238,21 @@ H5P__dacc_reg_prop(H5P_genclass_t *pclass)
              NULL, NULL, NULL, H5D_ACS_PREEMPT_READ_CHUNKS_ENC, H5D_ACS_PREEMPT_READ_CHUNKS_DEC, NULL, NULL, NULL, NULL) < 0)
          HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
 
+    /* Register the replacement policy of raw data chunk cache */
+    if(H5P_register_real(pclass, H5D_ACS_DATA_CACHE_POLICY_NAME, H5D_ACS_DATA_CACHE_POLICY_SIZE, &rdcc_policy,
+             NULL, NULL, NULL, H5D_ACS_DATA_CACHE_POLICY_ENC, H5D_ACS_DATA_CACHE_POLICY_DEC, NULL, NULL, NULL, NULL) < 0)
+         HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register the read-ahead window of raw data chunk cache */
+    if(H5P_register_real(pclass, H5D_ACS_DATA_CACHE_READ_AHEAD_NAME, H5D_ACS_DATA_CACHE_READ_AHEAD_SIZE, &rdcc_read_ahead,
+             NULL, NULL, NULL, H5D_ACS_DATA_CACHE_READ_AHEAD_ENC, H5D_ACS_DATA_CACHE_READ_AHEAD_DEC, NULL, NULL, NULL, NULL) < 0)
+         HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register the max. gap between uncached chunks read together */
+    if(H5P_register_real(pclass, H5D_ACS_CHUNK_READ_GAP_NAME, H5D_ACS_CHUNK_READ_GAP_SIZE, &chunk_read_gap,
+             NULL, NULL, NULL, H5D_ACS_CHUNK_READ_GAP_ENC, H5D_ACS_CHUNK_READ_GAP_DEC, NULL, NULL, NULL, NULL) < 0)
+         HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
     /* Register the VDS view option */
     if(H5P_register_real(pclass, H5D_ACS_VDS_VIEW_NAME, H5D_ACS_VDS_VIEW_SIZE, &virtual_view,
             NULL, NULL, NULL, H5D_ACS_VDS_VIEW_ENC, H5D_ACS_VDS_VIEW_DEC,
@@ -864,6 +899,296 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Pget_chunk_cache() */
 
+
+/*-------------------------------------------------------------------------
+ * Function: H5Pset_chunk_cache_policy
+ *
+ * Purpose:  Set the replacement policy of the raw data chunk cache.
+ *
+ *        H5D_CHUNK_CACHE_POLICY_LRU (the default) hashes each chunk to
+ *        one of RDCC_NSLOTS slots, preempting any other chunk in the
+ *        slot, and otherwise preempts chunks in LRU order, adjusted by
+ *        RDCC_W0.
+ *
+ *        H5D_CHUNK_CACHE_POLICY_2Q indexes the chunks with a hash table
+ *        which grows as needed, so chunks never preempt each other by
+ *        colliding and RDCC_NSLOTS only needs to be non-zero.  Chunks
+ *        are preempted by the 2Q algorithm: a chunk is cached in a FIFO
+ *        queue at first, and only when it's accessed again after being
+ *        preempted from there is it cached in the LRU queue, which
+ *        holds the working set.  A sweep over a dataset only goes
+ *        through the FIFO queue, so it doesn't flush the working set
+ *        from the cache.  RDCC_W0 is ignored.
+ *
+ *        Like the other chunk cache settings, the policy is only used
+ *        when a dataset is first opened.
+ *
+ * Return:    Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_chunk_cache_policy(hid_t dapl_id, H5D_chunk_cache_policy_t policy)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "iDp", dapl_id, policy);
+
+    /* Check argument */
+    if(policy < H5D_CHUNK_CACHE_POLICY_LRU || policy >= H5D_CHUNK_CACHE_POLICY_NTYPES)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "not a valid chunk cache policy")
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set policy */
+    if(H5P_set(plist, H5D_ACS_DATA_CACHE_POLICY_NAME, &policy) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set data cache policy")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_chunk_cache_policy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Pget_chunk_cache_policy
+ *
+ * Purpose:  Retrieves the replacement policy of the raw data chunk cache.
+ *
+ * Return:    Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_chunk_cache_policy(hid_t dapl_id, H5D_chunk_cache_policy_t *policy/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", dapl_id, policy);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get policy */
+    if(policy)
+        if(H5P_get(plist, H5D_ACS_DATA_CACHE_POLICY_NAME, policy) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get data cache policy")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_chunk_cache_policy() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Pset_chunk_read_ahead
+ *
+ * Purpose:  Set the read-ahead window of the raw data chunk cache, in
+ *        chunks.
+ *
+ *        When reads of a dataset move forward through its chunks, either
+ *        sequentially or with a constant stride, the chunks the next
+ *        reads will need are loaded into the chunk cache (and decoded,
+ *        if the dataset is filtered) at the end of each read, up to
+ *        NCHUNKS of them.  No more than half of the chunk cache is used
+ *        for chunks read ahead.  Zero (the default) disables read-ahead.
+ *
+ *        Like the other chunk cache settings, the window is only used
+ *        when a dataset is first opened.
+ *
+ * Return:    Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_chunk_read_ahead(hid_t dapl_id, size_t nchunks)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "iz", dapl_id, nchunks);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set read-ahead window */
+    if(H5P_set(plist, H5D_ACS_DATA_CACHE_READ_AHEAD_NAME, &nchunks) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set data cache read-ahead window")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_chunk_read_ahead() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Pget_chunk_read_ahead
+ *
+ * Purpose:  Retrieves the read-ahead window of the raw data chunk cache,
+ *        in chunks.
+ *
+ * Return:    Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_chunk_read_ahead(hid_t dapl_id, size_t *nchunks/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", dapl_id, nchunks);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get read-ahead window */
+    if(nchunks)
+        if(H5P_get(plist, H5D_ACS_DATA_CACHE_READ_AHEAD_NAME, nchunks) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get data cache read-ahead window")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_chunk_read_ahead() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Pset_chunk_read_gap
+ *
+ * Purpose:  Set the largest gap, in bytes, between chunks which are read
+ *        from the file together.
+ *
+ *        When a read selects chunks of a dataset without filters which
+ *        bypass the chunk cache, those which are no more than GAP bytes
+ *        apart in the file are read with a single I/O operation, the
+ *        bytes between them being read and discarded.  Adjacent chunks
+ *        are always read together.  The default is zero.
+ *
+ * Return:    Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_chunk_read_gap(hid_t dapl_id, size_t gap)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "iz", dapl_id, gap);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set gap */
+    if(H5P_set(plist, H5D_ACS_CHUNK_READ_GAP_NAME, &gap) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set chunk read gap")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_chunk_read_gap() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Pget_chunk_read_gap
+ *
+ * Purpose:  Retrieves the largest gap, in bytes, between chunks which are
+ *        read from the file together.
+ *
+ * Return:    Non-negative on success/Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_chunk_read_gap(hid_t dapl_id, size_t *gap/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", dapl_id, gap);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(dapl_id, H5P_DATASET_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get gap */
+    if(gap)
+        if(H5P_get(plist, H5D_ACS_CHUNK_READ_GAP_NAME, gap) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get chunk read gap")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_chunk_read_gap() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__dacc_chunk_cache_policy_enc
+ *
+ * Purpose:     Callback routine which is called whenever the chunk cache
+ *              policy property in the dataset access property list is
+ *              encoded.
+ *
+ * Return:      Success:        Non-negative
+ *              Failure:        Negative
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__dacc_chunk_cache_policy_enc(const void *value, void **_pp, size_t *size)
+{
+    const H5D_chunk_cache_policy_t *policy = (const H5D_chunk_cache_policy_t *)value; /* Create local alias for values */
+    uint8_t **pp = (uint8_t **)_pp;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Sanity check */
+    HDassert(policy);
+    HDassert(size);
+
+    if(NULL != *pp)
+        /* Encode policy property */
+        *(*pp)++ = (uint8_t)*policy;
+
+    /* Size of policy property */
+    (*size)++;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5P__dacc_chunk_cache_policy_enc() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5P__dacc_chunk_cache_policy_dec
+ *
+ * Purpose:     Callback routine which is called whenever the chunk cache
+ *              policy property in the dataset access property list is
+ *              decoded.
+ *
+ * Return:      Success:        Non-negative
+ *              Failure:        Negative
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5P__dacc_chunk_cache_policy_dec(const void **_pp, void *_value)
+{
+    H5D_chunk_cache_policy_t *policy = (H5D_chunk_cache_policy_t *)_value;
+    const uint8_t **pp = (const uint8_t **)_pp;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Sanity checks */
+    HDassert(pp);
+    HDassert(*pp);
+    HDassert(policy);
+
+    /* Decode policy property */
+    *policy = (H5D_chunk_cache_policy_t)*(*pp)++;
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5P__dacc_chunk_cache_policy_dec() */
+
 
 /*-------------------------------------------------------------------------
  * Function:       H5P__encode_chunk_cache_nslots
@@ -3162,6 +3162,118 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Pset_scaleoffset() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_bitshuffle
+ *
+ * Purpose:     Sets the bitshuffle filter for a dataset creation property
+ *              list.  BLOCK_SIZE is the number of elements bitshuffled
+ *              together, a multiple of 8, or 0 for the default of about
+ *              8 KB of elements.  COMPRESSION is H5Z_BITSHUFFLE_COMP_NONE,
+ *              or H5Z_BITSHUFFLE_COMP_LZ4 to compress each block with LZ4.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_bitshuffle(hid_t plist_id, unsigned block_size, unsigned compression)
+{
+    H5O_pline_t         pline;
+    H5P_genplist_t *plist;      /* Property list pointer */
+    unsigned cd_values[H5Z_BITSHUFFLE_TOTAL_NPARMS] = {0, 0, 0, 0, 0};  /* Filter parameters */
+    herr_t ret_value=SUCCEED;   /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "iIuIu", plist_id, block_size, compression);
+
+    /* Check arguments */
+    if(TRUE != H5P_isa_class(plist_id, H5P_DATASET_CREATE))
+        HGOTO_ERROR (H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataset creation property list")
+    if(block_size % H5Z_BITSHUFFLE_BLOCK_MULT)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "block size must be a multiple of 8")
+    if(compression != H5Z_BITSHUFFLE_COMP_NONE && compression != H5Z_BITSHUFFLE_COMP_LZ4)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid compression")
+
+    /* Get the plist structure */
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(plist_id)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set the user's parameters; the rest are set for each dataset */
+    cd_values[H5Z_BITSHUFFLE_PARM_BLOCK] = block_size;
+    cd_values[H5Z_BITSHUFFLE_PARM_COMP] = compression;
+
+    /* Add the bitshuffle filter */
+    if(H5P_peek(plist, H5O_CRT_PIPELINE_NAME, &pline) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get pipeline")
+    if(H5Z_append(&pline, H5Z_FILTER_BITSHUFFLE, H5Z_FLAG_OPTIONAL, (size_t)H5Z_BITSHUFFLE_TOTAL_NPARMS, cd_values) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to add bitshuffle filter to pipeline")
+    if(H5P_poke(plist, H5O_CRT_PIPELINE_NAME, &pline) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to set pipeline")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_bitshuffle() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_zstd
+ *
+ * Purpose:     Sets Zstandard compression for a dataset creation property
+ *              list.  LEVEL is the compression level, up to
+ *              H5Z_ZSTD_MAX_LEVEL; negative levels are faster still.  If
+ *              DICT_REF isn't NULL, it refers to a dataset of bytes in
+ *              the same file as the datasets created with the property
+ *              list, which is used as the compression dictionary.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_zstd(hid_t plist_id, int level, const hobj_ref_t *dict_ref)
+{
+    H5O_pline_t         pline;
+    H5P_genplist_t *plist;      /* Property list pointer */
+    unsigned cd_values[H5Z_ZSTD_USER_NPARMS];   /* Filter parameters */
+    size_t cd_nelmts = 1;       /* Number of filter parameters */
+    herr_t ret_value=SUCCEED;   /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "iIs*r", plist_id, level, dict_ref);
+
+    /* Check arguments */
+    if(TRUE != H5P_isa_class(plist_id, H5P_DATASET_CREATE))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a dataset creation property list")
+    if(level > H5Z_ZSTD_MAX_LEVEL)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid compression level")
+    if(dict_ref && (!H5F_addr_defined(*dict_ref) || 0 == *dict_ref))
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid dictionary reference")
+
+    /* Get the plist structure */
+    if(NULL == (plist = (H5P_genplist_t *)H5I_object(plist_id)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set the parameters; the dictionary's key is set for each dataset */
+    cd_values[H5Z_ZSTD_PARM_LEVEL] = (unsigned)level;
+    if(dict_ref) {
+        cd_values[H5Z_ZSTD_PARM_DICT_LO] = (unsigned)(*dict_ref & 0xffffffff);
+        cd_values[H5Z_ZSTD_PARM_DICT_HI] = (unsigned)(*dict_ref >> 32);
+        cd_nelmts = H5Z_ZSTD_USER_NPARMS;
+    } /* end if */
+
+    /* Add the zstd filter */
+    if(H5P_peek(plist, H5O_CRT_PIPELINE_NAME, &pline) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get pipeline")
+    if(H5Z_append(&pline, H5Z_FILTER_ZSTD, H5Z_FLAG_OPTIONAL, cd_nelmts, cd_values) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to add zstd filter to pipeline")
+    if(H5P_poke(plist, H5O_CRT_PIPELINE_NAME, &pline) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to set pipeline")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_zstd() */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5Pset_fill_value
@@ -258,6 +258,30 @@
 #define H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_DEF            0
 #define H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_ENC            H5P__encode_unsigned
 #define H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_DEC            H5P__decode_unsigned
+/* Definitions for write-behind watermarks of page buffer(bytes) */
+#define H5F_ACS_PAGE_BUFFER_WB_HIGH_SIZE        sizeof(size_t)
+#define H5F_ACS_PAGE_BUFFER_WB_HIGH_DEF         0
+#define H5F_ACS_PAGE_BUFFER_WB_HIGH_ENC         H5P__encode_size_t
+#define H5F_ACS_PAGE_BUFFER_WB_HIGH_DEC         H5P__decode_size_t
+#define H5F_ACS_PAGE_BUFFER_WB_LOW_SIZE         sizeof(size_t)
+#define H5F_ACS_PAGE_BUFFER_WB_LOW_DEF          0
+#define H5F_ACS_PAGE_BUFFER_WB_LOW_ENC          H5P__encode_size_t
+#define H5F_ACS_PAGE_BUFFER_WB_LOW_DEC          H5P__decode_size_t
+/* Definitions for max. # of raw data pages read ahead by page buffer */
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_SIZE       sizeof(size_t)
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_DEF        0
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_ENC        H5P__encode_size_t
+#define H5F_ACS_PAGE_BUFFER_PREFETCH_DEC        H5P__decode_size_t
+/* Definition for # of threads used to run the I/O filter pipeline */
+#define H5F_ACS_FILTER_NTHREADS_SIZE            sizeof(unsigned)
+#define H5F_ACS_FILTER_NTHREADS_DEF             0
+#define H5F_ACS_FILTER_NTHREADS_ENC             H5P__encode_unsigned
+#define H5F_ACS_FILTER_NTHREADS_DEC             H5P__decode_unsigned
+/* Definition for size of raw data chunk cache shared by all datasets(bytes) */
+#define H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_SIZE        sizeof(size_t)
+#define H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_DEF         0
+#define H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_ENC         H5P__encode_size_t
+#define H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_DEC         H5P__decode_size_t
 
 
 /******************/
@@ -397,6 +421,11 @@ static const H5AC_cache_image_config_t H5F_def_mdc_initCacheImageCfg_g = H5F_ACS
 static const size_t H5F_def_page_buf_size_g = H5F_ACS_PAGE_BUFFER_SIZE_DEF;      /* Default page buffer size */
 static const unsigned H5F_def_page_buf_min_meta_perc_g = H5F_ACS_PAGE_BUFFER_MIN_META_PERC_DEF;      /* Default page buffer minimum metadata size */
 static const unsigned H5F_def_page_buf_min_raw_perc_g = H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_DEF;      /* Default page buffer mininum raw data size */
+static const size_t H5F_def_page_buf_wb_high_g = H5F_ACS_PAGE_BUFFER_WB_HIGH_DEF;      /* Default page buffer write-behind high watermark */
+static const size_t H5F_def_page_buf_wb_low_g = H5F_ACS_PAGE_BUFFER_WB_LOW_DEF;      /* Default page buffer write-behind low watermark */
+static const size_t H5F_def_page_buf_prefetch_g = H5F_ACS_PAGE_BUFFER_PREFETCH_DEF;      /* Default page buffer raw data prefetch */
+static const unsigned H5F_def_filter_nthreads_g = H5F_ACS_FILTER_NTHREADS_DEF;      /* Default # of filter pipeline threads */
+static const size_t H5F_def_rdcc_shared_nbytes_g = H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_DEF;      /* Default shared raw data chunk cache # of bytes */
 
 
 /*-------------------------------------------------------------------------
@@ -643,6 +672,32 @@ H5P__facc_reg_prop(H5P_genclass_t *pclass)
             NULL, NULL, NULL, H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_ENC, H5F_ACS_PAGE_BUFFER_MIN_RAW_PERC_DEC,
             NULL, NULL, NULL, NULL) < 0)
         HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+    /* Register the page buffer write-behind watermarks */
+    if(H5P_register_real(pclass, H5F_ACS_PAGE_BUFFER_WB_HIGH_NAME, H5F_ACS_PAGE_BUFFER_WB_HIGH_SIZE, &H5F_def_page_buf_wb_high_g,
+            NULL, NULL, NULL, H5F_ACS_PAGE_BUFFER_WB_HIGH_ENC, H5F_ACS_PAGE_BUFFER_WB_HIGH_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+    if(H5P_register_real(pclass, H5F_ACS_PAGE_BUFFER_WB_LOW_NAME, H5F_ACS_PAGE_BUFFER_WB_LOW_SIZE, &H5F_def_page_buf_wb_low_g,
+            NULL, NULL, NULL, H5F_ACS_PAGE_BUFFER_WB_LOW_ENC, H5F_ACS_PAGE_BUFFER_WB_LOW_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+    /* Register the page buffer raw data prefetch */
+    if(H5P_register_real(pclass, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, H5F_ACS_PAGE_BUFFER_PREFETCH_SIZE, &H5F_def_page_buf_prefetch_g,
+            NULL, NULL, NULL, H5F_ACS_PAGE_BUFFER_PREFETCH_ENC, H5F_ACS_PAGE_BUFFER_PREFETCH_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register the # of threads for running the filter pipeline */
+    if(H5P_register_real(pclass, H5F_ACS_FILTER_NTHREADS_NAME, H5F_ACS_FILTER_NTHREADS_SIZE, &H5F_def_filter_nthreads_g,
+            NULL, NULL, NULL, H5F_ACS_FILTER_NTHREADS_ENC, H5F_ACS_FILTER_NTHREADS_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
+
+    /* Register the size of raw data chunk cache shared by all datasets */
+    if(H5P_register_real(pclass, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_NAME, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_SIZE, &H5F_def_rdcc_shared_nbytes_g,
+            NULL, NULL, NULL, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_ENC, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_DEC,
+            NULL, NULL, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTINSERT, FAIL, "can't insert property into class")
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
@@ -4939,3 +4994,295 @@ done:
     FUNC_LEAVE_API(ret_value)
 } /* end H5Pget_page_buffer_size() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_page_buffer_write_behind
+ *
+ * Purpose:     Enables write-behind in the page buffer.  When the dirty
+ *              pages in the page buffer reach HIGH_WATERMARK bytes, they
+ *              are written to the file in address order until no more
+ *              than LOW_WATERMARK bytes are dirty.  The writing is done
+ *              by a background thread where the library is thread-safe,
+ *              and when the watermark is reached otherwise.
+ *
+ *              A HIGH_WATERMARK of 0 disables write-behind, so that dirty
+ *              pages are only written when they are evicted or flushed.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_page_buffer_write_behind(hid_t plist_id, size_t high_watermark,
+    size_t low_watermark)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "izz", plist_id, high_watermark, low_watermark);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    if(low_watermark > high_watermark)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "low watermark can't be bigger than high watermark")
+
+    /* Set watermarks */
+    if(H5P_set(plist, H5F_ACS_PAGE_BUFFER_WB_HIGH_NAME, &high_watermark) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set page buffer write-behind high watermark")
+    if(H5P_set(plist, H5F_ACS_PAGE_BUFFER_WB_LOW_NAME, &low_watermark) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set page buffer write-behind low watermark")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_page_buffer_write_behind() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_page_buffer_write_behind
+ *
+ * Purpose:     Retrieves the page buffer write-behind watermarks.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_page_buffer_write_behind(hid_t plist_id, size_t *high_watermark/*out*/,
+    size_t *low_watermark/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE3("e", "ixx", plist_id, high_watermark, low_watermark);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get watermarks */
+    if(high_watermark)
+        if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_WB_HIGH_NAME, high_watermark) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get page buffer write-behind high watermark")
+    if(low_watermark)
+        if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_WB_LOW_NAME, low_watermark) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get page buffer write-behind low watermark")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_page_buffer_write_behind() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_page_buffer_prefetch
+ *
+ * Purpose:     Sets the max. # of raw data pages the page buffer reads
+ *              ahead of a sequential read.  Reads are sequential when
+ *              they start in or just after the page the previous raw
+ *              data read ended in.  At most half of the page buffer is
+ *              read ahead.
+ *
+ *              A value of 0 disables prefetching.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_page_buffer_prefetch(hid_t plist_id, size_t npages)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "iz", plist_id, npages);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set size */
+    if(H5P_set(plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, &npages) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set page buffer prefetch size")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_page_buffer_prefetch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_page_buffer_prefetch
+ *
+ * Purpose:     Retrieves the max. # of raw data pages the page buffer
+ *              reads ahead.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_page_buffer_prefetch(hid_t plist_id, size_t *npages/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED;   /* return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", plist_id, npages);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get size */
+    if(npages)
+        if(H5P_get(plist, H5F_ACS_PAGE_BUFFER_PREFETCH_NAME, npages) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get page buffer prefetch size")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_page_buffer_prefetch() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_filter_nthreads
+ *
+ * Purpose:     Set the number of worker threads used to run the I/O filter
+ *              pipeline on chunks, when a read touches several filtered
+ *              chunks which aren't in the chunk cache.  Zero or one means
+ *              that chunks are decoded on the calling thread, one at a
+ *              time.  Worker threads are only used by thread-safe builds
+ *              of the library; other builds accept the setting but always
+ *              filter chunks on the calling thread.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_filter_nthreads(hid_t plist_id, unsigned nthreads)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "iIu", plist_id, nthreads);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set value */
+    if(H5P_set(plist, H5F_ACS_FILTER_NTHREADS_NAME, &nthreads) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set # of filter threads")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_filter_nthreads() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_filter_nthreads
+ *
+ * Purpose:     Retrieves the number of worker threads used to run the I/O
+ *              filter pipeline on chunks.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_filter_nthreads(hid_t plist_id, unsigned *nthreads)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "i*Iu", plist_id, nthreads);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get value */
+    if(nthreads)
+        if(H5P_get(plist, H5F_ACS_FILTER_NTHREADS_NAME, nthreads) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get # of filter threads")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_filter_nthreads() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pset_shared_chunk_cache
+ *
+ * Purpose:     Set the size of a raw data chunk cache budget which is
+ *              shared by all the datasets in the file.  Each dataset
+ *              still has its own chunk cache (see H5Pset_cache and
+ *              H5Pset_chunk_cache), but when the chunks cached by all
+ *              the datasets would take up more than RDCC_NBYTES, chunks
+ *              are preempted from the datasets using the most of the
+ *              budget first.  Zero (the default) means there's no
+ *              shared budget.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pset_shared_chunk_cache(hid_t plist_id, size_t rdcc_nbytes)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "iz", plist_id, rdcc_nbytes);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Set value */
+    if(H5P_set(plist, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_NAME, &rdcc_nbytes) < 0)
+        HGOTO_ERROR(H5E_PLIST, H5E_CANTSET, FAIL, "can't set shared data cache byte size")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pset_shared_chunk_cache() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    H5Pget_shared_chunk_cache
+ *
+ * Purpose:     Retrieves the size of the raw data chunk cache budget
+ *              shared by all the datasets in the file.
+ *
+ * Return:      Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Pget_shared_chunk_cache(hid_t plist_id, size_t *rdcc_nbytes/*out*/)
+{
+    H5P_genplist_t *plist;      /* Property list pointer */
+    herr_t ret_value = SUCCEED; /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE2("e", "ix", plist_id, rdcc_nbytes);
+
+    /* Get the plist structure */
+    if(NULL == (plist = H5P_object_verify(plist_id, H5P_FILE_ACCESS)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get value */
+    if(rdcc_nbytes)
+        if(H5P_get(plist, H5F_ACS_DATA_CACHE_SHARED_BYTE_SIZE_NAME, rdcc_nbytes) < 0)
+            HGOTO_ERROR(H5E_PLIST, H5E_CANTGET, FAIL, "can't get shared data cache byte size")
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Pget_shared_chunk_cache() */
+
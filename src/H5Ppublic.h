@@ -30,6 +30,7 @@
 #include "H5Lpublic.h"
 #include "H5Opublic.h"
 #include "H5MMpublic.h"
+#include "H5Rpublic.h"
 #include "H5Tpublic.h"
 #include "H5Zpublic.h"
 
@@ -369,6 +370,14 @@ H5_DLL herr_t H5Pset_mdc_image_config(hid_t plist_id, H5AC_cache_image_config_t
 H5_DLL herr_t H5Pget_mdc_image_config(hid_t plist_id, H5AC_cache_image_config_t *config_ptr /*out*/);
 H5_DLL herr_t H5Pset_page_buffer_size(hid_t plist_id, size_t buf_size, unsigned min_meta_per, unsigned min_raw_per);
 H5_DLL herr_t H5Pget_page_buffer_size(hid_t plist_id, size_t *buf_size, unsigned *min_meta_per, unsigned *min_raw_per);
+H5_DLL herr_t H5Pset_page_buffer_write_behind(hid_t plist_id, size_t high_watermark, size_t low_watermark);
+H5_DLL herr_t H5Pget_page_buffer_write_behind(hid_t plist_id, size_t *high_watermark/*out*/, size_t *low_watermark/*out*/);
+H5_DLL herr_t H5Pset_page_buffer_prefetch(hid_t plist_id, size_t npages);
+H5_DLL herr_t H5Pget_page_buffer_prefetch(hid_t plist_id, size_t *npages/*out*/);
+H5_DLL herr_t H5Pset_filter_nthreads(hid_t plist_id, unsigned nthreads);
+H5_DLL herr_t H5Pget_filter_nthreads(hid_t plist_id, unsigned *nthreads);
+H5_DLL herr_t H5Pset_shared_chunk_cache(hid_t plist_id, size_t rdcc_nbytes);
+H5_DLL herr_t H5Pget_shared_chunk_cache(hid_t plist_id, size_t *rdcc_nbytes/*out*/);
 
 /* Dataset creation property list (DCPL) routines */
 H5_DLL herr_t H5Pset_layout(hid_t plist_id, H5D_layout_t layout);
@@ -396,6 +405,8 @@ H5_DLL herr_t H5Pset_szip(hid_t plist_id, unsigned options_mask, unsigned pixels
 H5_DLL herr_t H5Pset_shuffle(hid_t plist_id);
 H5_DLL herr_t H5Pset_nbit(hid_t plist_id);
 H5_DLL herr_t H5Pset_scaleoffset(hid_t plist_id, H5Z_SO_scale_type_t scale_type, int scale_factor);
+H5_DLL herr_t H5Pset_bitshuffle(hid_t plist_id, unsigned block_size, unsigned compression);
+H5_DLL herr_t H5Pset_zstd(hid_t plist_id, int level, const hobj_ref_t *dict_ref);
 H5_DLL herr_t H5Pset_fill_value(hid_t plist_id, hid_t type_id,
      const void *value);
 H5_DLL herr_t H5Pget_fill_value(hid_t plist_id, hid_t type_id,
@@ -416,6 +427,14 @@ H5_DLL herr_t H5Pget_chunk_cache(hid_t dapl_id,
        size_t *rdcc_nslots/*out*/,
        size_t *rdcc_nbytes/*out*/,
        double *rdcc_w0/*out*/);
+H5_DLL herr_t H5Pset_chunk_cache_policy(hid_t dapl_id,
+       H5D_chunk_cache_policy_t policy);
+H5_DLL herr_t H5Pget_chunk_cache_policy(hid_t dapl_id,
+       H5D_chunk_cache_policy_t *policy/*out*/);
+H5_DLL herr_t H5Pset_chunk_read_ahead(hid_t dapl_id, size_t nchunks);
+H5_DLL herr_t H5Pget_chunk_read_ahead(hid_t dapl_id, size_t *nchunks/*out*/);
+H5_DLL herr_t H5Pset_chunk_read_gap(hid_t dapl_id, size_t gap);
+H5_DLL herr_t H5Pget_chunk_read_gap(hid_t dapl_id, size_t *gap/*out*/);
 H5_DLL herr_t H5Pset_virtual_view(hid_t plist_id, H5D_vds_view_t view);
 H5_DLL herr_t H5Pget_virtual_view(hid_t plist_id, H5D_vds_view_t *view);
 H5_DLL herr_t H5Pset_virtual_printf_gap(hid_t plist_id, hsize_t gap_size);
@@ -0,0 +1,476 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5TP.c
+ *
+ * Purpose:		Implements a small pool of worker threads, for running
+ *                      independent, CPU-bound pieces of work (such as
+ *                      running the I/O filter pipeline on several chunks)
+ *                      concurrently.
+ *
+ *                      Operations run on worker threads without holding
+ *                      the library's global lock, so they must only touch
+ *                      memory owned by their task and read-only library
+ *                      state.  In particular, operations must not call
+ *                      API routines, use free lists or the API context.
+ *                      Workers are only started in thread-safe builds,
+ *                      where each thread has its own error stack, so
+ *                      operations report failure through their return
+ *                      value and callers should re-issue errors on their
+ *                      own thread.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/****************/
+/* Module Setup */
+/****************/
+
+
+/***********/
+/* Headers */
+/***********/
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5FLprivate.h"	/* Free Lists                           */
+#include "H5MMprivate.h"	/* Memory management			*/
+#include "H5TPprivate.h"        /* Thread pools                         */
+
+#ifdef H5TP_HAVE_THREADS
+#include <pthread.h>
+#endif /* H5TP_HAVE_THREADS */
+
+/****************/
+/* Local Macros */
+/****************/
+
+
+/******************/
+/* Local Typedefs */
+/******************/
+
+
+/********************/
+/* Package Typedefs */
+/********************/
+
+/* Typedef for thread pool */
+struct H5TP_t {
+    unsigned nthreads;          /* Number of worker threads running */
+#ifdef H5TP_HAVE_THREADS
+    pthread_t *threads;         /* Worker threads */
+    pthread_mutex_t lock;       /* Protects the fields below */
+    pthread_cond_t work_cond;   /* Signalled when work is queued or the pool closes */
+    pthread_cond_t done_cond;   /* Signalled when a task completes */
+    H5TP_task_t *head;          /* Head of queue of tasks waiting to run */
+    H5TP_task_t *tail;          /* Tail of queue of tasks waiting to run */
+    size_t npending;            /* # of tasks queued or running */
+    hbool_t closing;            /* Whether the pool is shutting down */
+#endif /* H5TP_HAVE_THREADS */
+};
+
+
+/********************/
+/* Local Prototypes */
+/********************/
+#ifdef H5TP_HAVE_THREADS
+static void *H5TP__worker(void *_tp);
+#endif /* H5TP_HAVE_THREADS */
+
+
+/*********************/
+/* Package Variables */
+/*********************/
+
+
+/*****************************/
+/* Library Private Variables */
+/*****************************/
+
+
+/*******************/
+/* Local Variables */
+/*******************/
+
+/* Declare a free list to manage the H5TP_t struct */
+H5FL_DEFINE_STATIC(H5TP_t);
+
+
+#ifdef H5TP_HAVE_THREADS
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP__worker
+ *
+ * Purpose:	Main loop for a worker thread: take tasks off the pool's
+ *              queue and run them, until the pool is closed and the
+ *              queue is empty.
+ *
+ * Note:	This routine runs without the library lock, so it doesn't
+ *              use the FUNC_ENTER macros.
+ *
+ * Return:	NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static void *
+H5TP__worker(void *_tp)
+{
+    H5TP_t *tp = (H5TP_t *)_tp;         /* Thread pool */
+
+    HDassert(tp);
+
+    pthread_mutex_lock(&tp->lock);
+    while(1) {
+        H5TP_task_t *task;              /* Task to run */
+        herr_t status;                  /* Status from task's operation */
+
+        /* Wait for work to do */
+        while(NULL == tp->head && !tp->closing)
+            pthread_cond_wait(&tp->work_cond, &tp->lock);
+
+        /* Leave once the pool is closing and all work is done */
+        if(NULL == tp->head)
+            break;
+
+        /* Take the task off the queue */
+        task = tp->head;
+        tp->head = task->next;
+        if(NULL == tp->head)
+            tp->tail = NULL;
+        task->next = NULL;
+        pthread_mutex_unlock(&tp->lock);
+
+        /* Perform the operation.  Tasks report failure through their
+         * status, so drop any errors left on this thread's stack (which
+         * the ID table allows without the library lock).
+         */
+        status = (task->op)(task->op_data);
+        (void)H5E_clear_stack(NULL);
+
+        /* Mark the task complete.  The task may be released as soon as the
+         * lock is dropped, so it mustn't be touched after that.
+         */
+        pthread_mutex_lock(&tp->lock);
+        task->status = status;
+        task->done = TRUE;
+        tp->npending--;
+        pthread_cond_broadcast(&tp->done_cond);
+    } /* end while */
+    pthread_mutex_unlock(&tp->lock);
+
+    return NULL;
+} /* end H5TP__worker() */
+#endif /* H5TP_HAVE_THREADS */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP_create
+ *
+ * Purpose:	Create a thread pool with NTHREADS worker threads.  When
+ *              NTHREADS is zero or threads aren't available, no workers
+ *              are started and tasks run on the calling thread as they
+ *              are submitted.  (A single worker is still worth having to
+ *              run tasks in the background.)
+ *
+ * Return:	Pointer to thread pool on success
+ *              NULL on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+H5TP_t *
+H5TP_create(unsigned nthreads)
+{
+    H5TP_t *tp = NULL;          /* Thread pool */
+#ifdef H5TP_HAVE_THREADS
+    hbool_t lock_init = FALSE;  /* Whether the mutex was initialized */
+    hbool_t work_init = FALSE;  /* Whether the "work" condition was initialized */
+    hbool_t done_init = FALSE;  /* Whether the "done" condition was initialized */
+#endif /* H5TP_HAVE_THREADS */
+    H5TP_t *ret_value = NULL;   /* Return value */
+
+    FUNC_ENTER_NOAPI(NULL)
+
+    /* Create thread pool info */
+    if(NULL == (tp = H5FL_CALLOC(H5TP_t)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for thread pool info")
+
+#ifdef H5TP_HAVE_THREADS
+    if(nthreads > H5TP_MAX_THREADS)
+        nthreads = H5TP_MAX_THREADS;
+
+    if(nthreads > 0) {
+        if(pthread_mutex_init(&tp->lock, NULL))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTINIT, NULL, "can't initialize thread pool mutex")
+        lock_init = TRUE;
+        if(pthread_cond_init(&tp->work_cond, NULL))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTINIT, NULL, "can't initialize thread pool condition")
+        work_init = TRUE;
+        if(pthread_cond_init(&tp->done_cond, NULL))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTINIT, NULL, "can't initialize thread pool condition")
+        done_init = TRUE;
+
+        if(NULL == (tp->threads = (pthread_t *)H5MM_malloc(nthreads * sizeof(pthread_t))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, NULL, "memory allocation failed for worker threads")
+
+        /* Start the workers */
+        for(tp->nthreads = 0; tp->nthreads < nthreads; tp->nthreads++)
+            if(pthread_create(&tp->threads[tp->nthreads], NULL, H5TP__worker, tp))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_CANTINIT, NULL, "can't create worker thread")
+    } /* end if */
+#endif /* H5TP_HAVE_THREADS */
+
+    /* Set the return value */
+    ret_value = tp;
+
+done:
+    /* Release resources on error */
+    if(!ret_value && tp) {
+#ifdef H5TP_HAVE_THREADS
+        if(tp->nthreads > 0) {
+            unsigned u;             /* Local index variable */
+
+            pthread_mutex_lock(&tp->lock);
+            tp->closing = TRUE;
+            pthread_cond_broadcast(&tp->work_cond);
+            pthread_mutex_unlock(&tp->lock);
+            for(u = 0; u < tp->nthreads; u++)
+                pthread_join(tp->threads[u], NULL);
+        } /* end if */
+        if(tp->threads)
+            tp->threads = (pthread_t *)H5MM_xfree(tp->threads);
+        if(done_init)
+            pthread_cond_destroy(&tp->done_cond);
+        if(work_init)
+            pthread_cond_destroy(&tp->work_cond);
+        if(lock_init)
+            pthread_mutex_destroy(&tp->lock);
+#endif /* H5TP_HAVE_THREADS */
+        tp = H5FL_FREE(H5TP_t, tp);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5TP_create() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP_get_nthreads
+ *
+ * Purpose:	Retrieve the number of worker threads in a pool.  Zero
+ *              means that tasks run on the calling thread.
+ *
+ * Return:	Number of worker threads (can't fail)
+ *
+ *-------------------------------------------------------------------------
+ */
+unsigned
+H5TP_get_nthreads(const H5TP_t *tp)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    HDassert(tp);
+
+    FUNC_LEAVE_NOAPI(tp->nthreads)
+} /* end H5TP_get_nthreads() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP_submit
+ *
+ * Purpose:	Queue a task which calls OP with OP_DATA on a worker
+ *              thread.  TASK is owned by the caller and must not be
+ *              released until H5TP_task_wait or H5TP_wait has returned.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5TP_submit(H5TP_t *tp, H5TP_task_t *task, H5TP_op_t op, void *op_data)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /*
+     * Check arguments.
+     */
+    HDassert(tp);
+    HDassert(task);
+    HDassert(op);
+
+    /* Set up the task */
+    task->op = op;
+    task->op_data = op_data;
+    task->status = SUCCEED;
+    task->done = FALSE;
+    task->next = NULL;
+
+#ifdef H5TP_HAVE_THREADS
+    if(tp->nthreads > 0) {
+        /* Append the task to the queue and wake a worker */
+        if(pthread_mutex_lock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTLOCK, FAIL, "can't lock thread pool")
+        if(tp->tail)
+            tp->tail->next = task;
+        else
+            tp->head = task;
+        tp->tail = task;
+        tp->npending++;
+        pthread_cond_signal(&tp->work_cond);
+        if(pthread_mutex_unlock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTUNLOCK, FAIL, "can't unlock thread pool")
+    } /* end if */
+    else
+#endif /* H5TP_HAVE_THREADS */
+    {
+        /* No workers, run the task now */
+        task->status = (op)(op_data);
+        task->done = TRUE;
+    } /* end else */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5TP_submit() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP_task_wait
+ *
+ * Purpose:	Wait for a task to complete.  The task's operation status
+ *              is left in TASK->status.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5TP_task_wait(H5TP_t *tp, H5TP_task_t *task)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /*
+     * Check arguments.
+     */
+    HDassert(tp);
+    HDassert(task);
+
+#ifdef H5TP_HAVE_THREADS
+    if(tp->nthreads > 0) {
+        if(pthread_mutex_lock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTLOCK, FAIL, "can't lock thread pool")
+        while(!task->done)
+            pthread_cond_wait(&tp->done_cond, &tp->lock);
+        if(pthread_mutex_unlock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTUNLOCK, FAIL, "can't unlock thread pool")
+    } /* end if */
+#endif /* H5TP_HAVE_THREADS */
+
+    HDassert(task->done);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5TP_task_wait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP_wait
+ *
+ * Purpose:	Wait for all tasks submitted to a pool to complete.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5TP_wait(H5TP_t *tp)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /*
+     * Check arguments.
+     */
+    HDassert(tp);
+
+#ifdef H5TP_HAVE_THREADS
+    if(tp->nthreads > 0) {
+        if(pthread_mutex_lock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTLOCK, FAIL, "can't lock thread pool")
+        while(tp->npending > 0)
+            pthread_cond_wait(&tp->done_cond, &tp->lock);
+        if(pthread_mutex_unlock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTUNLOCK, FAIL, "can't unlock thread pool")
+    } /* end if */
+#endif /* H5TP_HAVE_THREADS */
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5TP_wait() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5TP_close
+ *
+ * Purpose:	Finish any queued tasks, stop the worker threads and
+ *              release the pool.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5TP_close(H5TP_t *tp)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /*
+     * Check arguments.
+     */
+    HDassert(tp);
+
+#ifdef H5TP_HAVE_THREADS
+    if(tp->nthreads > 0) {
+        unsigned u;                     /* Local index variable */
+
+        /* Tell the workers to leave once the queue drains */
+        if(pthread_mutex_lock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTLOCK, FAIL, "can't lock thread pool")
+        tp->closing = TRUE;
+        pthread_cond_broadcast(&tp->work_cond);
+        if(pthread_mutex_unlock(&tp->lock))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_CANTUNLOCK, FAIL, "can't unlock thread pool")
+
+        for(u = 0; u < tp->nthreads; u++)
+            if(pthread_join(tp->threads[u], NULL))
+                HDONE_ERROR(H5E_RESOURCE, H5E_CANTFREE, FAIL, "can't join worker thread")
+        HDassert(0 == tp->npending);
+
+        tp->threads = (pthread_t *)H5MM_xfree(tp->threads);
+        pthread_cond_destroy(&tp->done_cond);
+        pthread_cond_destroy(&tp->work_cond);
+        pthread_mutex_destroy(&tp->lock);
+    } /* end if */
+#endif /* H5TP_HAVE_THREADS */
+
+    tp = H5FL_FREE(H5TP_t, tp);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5TP_close() */
+
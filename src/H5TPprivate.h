@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*-------------------------------------------------------------------------
+ *
+ * Created:		H5TPprivate.h
+ *
+ * Purpose:		Private header for library accessible worker thread
+ *                      pool routines.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef _H5TPprivate_H
+#define _H5TPprivate_H
+
+/* Include package's public header */
+/* #include "H5TPpublic.h" */
+
+/* Private headers needed by this file */
+
+/**************************/
+/* Library Private Macros */
+/**************************/
+
+/* Worker threads are only available in thread-safe builds with Pthreads,
+ * and not when the (unsynchronized) memory allocation sanity checks are
+ * enabled.  Other builds assume the library runs on one thread: its error
+ * stack and the filters' pools aren't protected there.  Without workers,
+ * a thread pool runs each task on the calling thread when it's submitted.
+ */
+#if defined(H5_HAVE_THREADSAFE) && defined(H5_HAVE_PTHREAD_H) && \
+        !defined(H5_HAVE_WIN_THREADS) && !defined(H5_MEMORY_ALLOC_SANITY_CHECK)
+#define H5TP_HAVE_THREADS
+#endif
+
+/* Upper limit on the number of worker threads in one pool */
+#define H5TP_MAX_THREADS        256
+
+
+/****************************/
+/* Library Private Typedefs */
+/****************************/
+
+/* Thread pool info (forward decl - defined in H5TP.c) */
+typedef struct H5TP_t H5TP_t;
+
+/* Operation performed by a task on a worker thread */
+typedef herr_t (*H5TP_op_t)(void *op_data);
+
+/* A unit of work for a thread pool.  Tasks are allocated by the caller and
+ * must stay valid until they have completed.
+ */
+typedef struct H5TP_task_t {
+    H5TP_op_t op;                       /* Operation to perform */
+    void *op_data;                      /* Data for operation */
+    herr_t status;                      /* Return value from operation */
+    hbool_t done;                       /* Whether the operation has completed */
+    struct H5TP_task_t *next;           /* Next task in pool's queue */
+} H5TP_task_t;
+
+
+/*****************************/
+/* Library-private Variables */
+/*****************************/
+
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+
+/* General routines for thread pool operations */
+H5_DLL H5TP_t *H5TP_create(unsigned nthreads);
+H5_DLL unsigned H5TP_get_nthreads(const H5TP_t *tp);
+H5_DLL herr_t H5TP_submit(H5TP_t *tp, H5TP_task_t *task, H5TP_op_t op,
+    void *op_data);
+H5_DLL herr_t H5TP_task_wait(H5TP_t *tp, H5TP_task_t *task);
+H5_DLL herr_t H5TP_wait(H5TP_t *tp);
+H5_DLL herr_t H5TP_close(H5TP_t *tp);
+
+#endif /* _H5TPprivate_H */
+
@@ -218,6 +218,216 @@ H5TS_mutex_unlock(H5TS_mutex_t *mutex)
 #endif /* H5_HAVE_WIN_THREADS */
 } /* H5TS_mutex_unlock */
 
+
+#ifndef H5_HAVE_WIN_THREADS
+/*--------------------------------------------------------------------------
+ * NAME
+ *    H5TS_mutex_unlock_all
+ *
+ * USAGE
+ *    H5TS_mutex_unlock_all(&mutex_var, &lock_count)
+ *
+ * RETURNS
+ *    0 on success and non-zero on error.
+ *
+ * DESCRIPTION
+ *    Releases every acquisition of a recursive lock held by the calling
+ *    thread, so another thread can take it while this one blocks, and
+ *    returns the number of acquisitions in LOCK_COUNT for
+ *    H5TS_mutex_relock().  LOCK_COUNT is zero if the calling thread
+ *    doesn't hold the lock.
+ *
+ *--------------------------------------------------------------------------
+ */
+herr_t
+H5TS_mutex_unlock_all(H5TS_mutex_t *mutex, unsigned *lock_count)
+{
+    herr_t ret_value = pthread_mutex_lock(&mutex->atomic_lock);
+
+    if(ret_value)
+        return ret_value;
+
+    if(mutex->lock_count && pthread_equal(HDpthread_self(), mutex->owner_thread)) {
+        *lock_count = mutex->lock_count;
+        mutex->lock_count = 0;
+        ret_value = pthread_cond_signal(&mutex->cond_var);
+    } /* end if */
+    else
+        *lock_count = 0;
+
+    {
+        int err;
+
+        err = pthread_mutex_unlock(&mutex->atomic_lock);
+        if(err != 0 && !ret_value)
+            ret_value = err;
+    }
+
+    return ret_value;
+} /* H5TS_mutex_unlock_all */
+
+
+/*--------------------------------------------------------------------------
+ * NAME
+ *    H5TS_mutex_relock
+ *
+ * USAGE
+ *    H5TS_mutex_relock(&mutex_var, lock_count)
+ *
+ * RETURNS
+ *    0 on success and non-zero on error.
+ *
+ * DESCRIPTION
+ *    Re-acquires a recursive lock released with H5TS_mutex_unlock_all(),
+ *    LOCK_COUNT times over.  Does nothing if LOCK_COUNT is zero.
+ *
+ *--------------------------------------------------------------------------
+ */
+herr_t
+H5TS_mutex_relock(H5TS_mutex_t *mutex, unsigned lock_count)
+{
+    herr_t ret_value;
+
+    if(0 == lock_count)
+        return 0;
+
+    if((ret_value = pthread_mutex_lock(&mutex->atomic_lock)))
+        return ret_value;
+
+    /* Wait for the lock to be free, then take ownership of it */
+    while(mutex->lock_count)
+        pthread_cond_wait(&mutex->cond_var, &mutex->atomic_lock);
+    mutex->owner_thread = HDpthread_self();
+    mutex->lock_count = lock_count;
+
+    return pthread_mutex_unlock(&mutex->atomic_lock);
+} /* H5TS_mutex_relock */
+
+
+/*--------------------------------------------------------------------------
+ * NAME
+ *    H5TS_mutex_setup
+ *
+ * USAGE
+ *    H5TS_mutex_setup(&mutex_var)
+ *
+ * RETURNS
+ *    0 on success and non-zero on error.
+ *
+ * DESCRIPTION
+ *    Initializes a recursive lock, which is released with
+ *    H5TS_mutex_teardown().
+ *
+ *--------------------------------------------------------------------------
+ */
+herr_t
+H5TS_mutex_setup(H5TS_mutex_t *mutex)
+{
+    herr_t ret_value;
+
+    if((ret_value = pthread_mutex_init(&mutex->atomic_lock, NULL)))
+        return ret_value;
+    if((ret_value = pthread_cond_init(&mutex->cond_var, NULL))) {
+        (void)pthread_mutex_destroy(&mutex->atomic_lock);
+        return ret_value;
+    } /* end if */
+    mutex->lock_count = 0;
+
+    return 0;
+} /* H5TS_mutex_setup */
+
+
+/*--------------------------------------------------------------------------
+ * NAME
+ *    H5TS_mutex_teardown
+ *
+ * USAGE
+ *    H5TS_mutex_teardown(&mutex_var)
+ *
+ * RETURNS
+ *    0 on success and non-zero on error.
+ *
+ * DESCRIPTION
+ *    Releases a recursive lock initialized with H5TS_mutex_setup().
+ *    The lock must not be held.
+ *
+ *--------------------------------------------------------------------------
+ */
+herr_t
+H5TS_mutex_teardown(H5TS_mutex_t *mutex)
+{
+    herr_t ret_value;
+
+    HDassert(0 == mutex->lock_count);
+
+    ret_value = pthread_cond_destroy(&mutex->cond_var);
+    {
+        int err;
+
+        err = pthread_mutex_destroy(&mutex->atomic_lock);
+        if(err != 0 && !ret_value)
+            ret_value = err;
+    }
+
+    return ret_value;
+} /* H5TS_mutex_teardown */
+
+
+/*--------------------------------------------------------------------------
+ * NAME
+ *    H5TS_mutex_lock_yield
+ *
+ * USAGE
+ *    H5TS_mutex_lock_yield(&mutex_var, &held_mutex_var)
+ *
+ * RETURNS
+ *    0 on success and non-zero on error.
+ *
+ * DESCRIPTION
+ *    Acquires a recursive lock like H5TS_mutex_lock(), for a thread
+ *    which also holds the recursive lock HELD.  When another thread
+ *    owns MUTEX, every acquisition of HELD is released while waiting
+ *    for it and re-acquired afterwards, since the owner may need HELD
+ *    to make progress.
+ *
+ *--------------------------------------------------------------------------
+ */
+herr_t
+H5TS_mutex_lock_yield(H5TS_mutex_t *mutex, H5TS_mutex_t *held)
+{
+    unsigned held_count;                /* # of times HELD was held */
+    herr_t ret_value = pthread_mutex_lock(&mutex->atomic_lock);
+
+    if(ret_value)
+        return ret_value;
+
+    /* Take the lock right away if it's free or already ours */
+    if(0 == mutex->lock_count || pthread_equal(HDpthread_self(), mutex->owner_thread)) {
+        if(0 == mutex->lock_count)
+            mutex->owner_thread = HDpthread_self();
+        mutex->lock_count++;
+        return pthread_mutex_unlock(&mutex->atomic_lock);
+    } /* end if */
+
+    if((ret_value = pthread_mutex_unlock(&mutex->atomic_lock)))
+        return ret_value;
+
+    /* Wait for the owner without holding HELD */
+    if((ret_value = H5TS_mutex_unlock_all(held, &held_count)))
+        return ret_value;
+    ret_value = H5TS_mutex_lock(mutex);
+    {
+        int err;
+
+        err = H5TS_mutex_relock(held, held_count);
+        if(err != 0 && !ret_value)
+            ret_value = err;
+    }
+
+    return ret_value;
+} /* H5TS_mutex_lock_yield */
+#endif /* H5_HAVE_WIN_THREADS */
+
 
 /*--------------------------------------------------------------------------
  * NAME
@@ -119,6 +119,13 @@ extern      "C"
 H5_DLL void   H5TS_pthread_first_thread_init(void);
 H5_DLL herr_t H5TS_mutex_lock(H5TS_mutex_t *mutex);
 H5_DLL herr_t H5TS_mutex_unlock(H5TS_mutex_t *mutex);
+#ifndef H5_HAVE_WIN_THREADS
+H5_DLL herr_t H5TS_mutex_unlock_all(H5TS_mutex_t *mutex, unsigned *lock_count);
+H5_DLL herr_t H5TS_mutex_relock(H5TS_mutex_t *mutex, unsigned lock_count);
+H5_DLL herr_t H5TS_mutex_setup(H5TS_mutex_t *mutex);
+H5_DLL herr_t H5TS_mutex_teardown(H5TS_mutex_t *mutex);
+H5_DLL herr_t H5TS_mutex_lock_yield(H5TS_mutex_t *mutex, H5TS_mutex_t *held);
+#endif /* H5_HAVE_WIN_THREADS */
 H5_DLL herr_t H5TS_cancel_count_inc(void);
 H5_DLL herr_t H5TS_cancel_count_dec(void);
 H5_DLL H5TS_thread_t H5TS_create_thread(void *(*func)(void *), H5TS_attr_t * attr, void *udata);
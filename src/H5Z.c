@@ -67,8 +67,25 @@ static H5Z_class2_t         *H5Z_table_g = NULL;
 static H5Z_stats_t          *H5Z_stat_table_g = NULL;
 #endif /* H5Z_DEBUG */
 
+/* The filter table is read by H5Z_pipeline() on threads which don't hold
+ * the library lock (chunk decoding), so changes to it are made under a
+ * write lock.  Everything else touching the table holds the library lock.
+ */
+#ifdef H5Z_HAVE_FILTER_LOCKS
+static pthread_rwlock_t      H5Z_table_lock_g = PTHREAD_RWLOCK_INITIALIZER;
+#define H5Z_TABLE_RDLOCK     (void)pthread_rwlock_rdlock(&H5Z_table_lock_g);
+#define H5Z_TABLE_WRLOCK     (void)pthread_rwlock_wrlock(&H5Z_table_lock_g);
+#define H5Z_TABLE_UNLOCK     (void)pthread_rwlock_unlock(&H5Z_table_lock_g);
+#else
+#define H5Z_TABLE_RDLOCK
+#define H5Z_TABLE_WRLOCK
+#define H5Z_TABLE_UNLOCK
+#endif /* H5Z_HAVE_FILTER_LOCKS */
+
 /* Local functions */
 static int H5Z_find_idx(H5Z_filter_t id);
+static int H5Z__find_func(H5Z_filter_t id, H5Z_func_t *func);
+static hbool_t H5Z__filter_pooled(H5Z_func_t func);
 static int H5Z__check_unregister_dset_cb(void *obj_ptr, hid_t obj_id, void *key);
 static int H5Z__check_unregister_group_cb(void *obj_ptr, hid_t obj_id, void *key);
 static int H5Z__flush_file_cb(void *obj_ptr, hid_t obj_id, void *key);
@@ -98,12 +115,18 @@ H5Z__init_package(void)
         HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register nbit filter")
     if (H5Z_register(H5Z_SCALEOFFSET) < 0)
         HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register scaleoffset filter")
+    if (H5Z_register(H5Z_BITSHUFFLE) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register bitshuffle filter")
 
     /* External filters */
 #ifdef H5_HAVE_FILTER_DEFLATE
     if (H5Z_register(H5Z_DEFLATE) < 0)
         HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register deflate filter")
 #endif /* H5_HAVE_FILTER_DEFLATE */
+#ifdef H5_HAVE_FILTER_ZSTD
+    if (H5Z_register(H5Z_ZSTD) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register zstd filter")
+#endif /* H5_HAVE_FILTER_ZSTD */
 #ifdef H5_HAVE_FILTER_SZIP
     H5Z_SZIP->encoder_present = SZ_encoder_enabled();
     if (H5Z_register(H5Z_SZIP) < 0)
@@ -181,15 +204,41 @@ H5Z_term_package(void)
                             bandwidth);
                 } /* end for */
             } /* end for */
+
+            /* Print the filter buffer pool's statistics */
+            {
+                size_t max_size;
+                hsize_t nreused, nallocated;
+
+                H5Z__buf_get_stats(NULL, &max_size, &nreused, &nallocated);
+                if(nreused + nallocated > 0)
+                    HDfprintf(H5DEBUG(Z), "H5Z: buffer pool reused %Hu of "
+                            "%Hu buffers, held at most %Zu bytes\n",
+                            nreused, nreused + nallocated, max_size);
+            }
         } /* end if */
 #endif /* H5Z_DEBUG */
         /* Free the table of filters */
         if (H5Z_table_g) {
+            H5Z_TABLE_WRLOCK
             H5Z_table_g = (H5Z_class2_t *)H5MM_xfree(H5Z_table_g);
 #ifdef H5Z_DEBUG
             H5Z_stat_table_g = (H5Z_stats_t *)H5MM_xfree(H5Z_stat_table_g);
 #endif /* H5Z_DEBUG */
             H5Z_table_used_g = H5Z_table_alloc_g = 0;
+            H5Z_TABLE_UNLOCK
+
+#ifdef H5_HAVE_FILTER_DEFLATE
+            /* Free deflate's streams */
+            H5Z__deflate_term();
+#endif /* H5_HAVE_FILTER_DEFLATE */
+#ifdef H5_HAVE_FILTER_ZSTD
+            /* Free zstd's contexts and dictionaries */
+            H5Z__zstd_term();
+#endif /* H5_HAVE_FILTER_ZSTD */
+
+            /* Free the buffers held by the filter buffer pool */
+            H5Z__buf_term();
 
             n++;
         } /* end if */
@@ -301,6 +350,8 @@ H5Z_register (const H5Z_class2_t *cls)
         if (H5Z_table_g[i].id == cls->id)
             break;
 
+    H5Z_TABLE_WRLOCK
+
     /* Filter not already registered */
     if (i >= H5Z_table_used_g) {
         if (H5Z_table_used_g >= H5Z_table_alloc_g) {
@@ -309,13 +360,20 @@ H5Z_register (const H5Z_class2_t *cls)
 #ifdef H5Z_DEBUG
             H5Z_stats_t *stat_table = (H5Z_stats_t *)H5MM_realloc(H5Z_stat_table_g, n * sizeof(H5Z_stats_t));
 #endif /* H5Z_DEBUG */
-            if (!table)
-                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to extend filter table")
-            H5Z_table_g = table;
+            if (table)
+                H5Z_table_g = table;
 #ifdef H5Z_DEBUG
-            if (!stat_table)
-                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to extend filter statistics table")
-            H5Z_stat_table_g = stat_table;
+            if (stat_table)
+                H5Z_stat_table_g = stat_table;
+            if (!table || !stat_table) {
+                H5Z_TABLE_UNLOCK
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to extend filter table")
+            } /* end if */
+#else /* H5Z_DEBUG */
+            if (!table) {
+                H5Z_TABLE_UNLOCK
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "unable to extend filter table")
+            } /* end if */
 #endif /* H5Z_DEBUG */
             H5Z_table_alloc_g = n;
         } /* end if */
@@ -333,6 +391,8 @@ H5Z_register (const H5Z_class2_t *cls)
         HDmemcpy(H5Z_table_g+i, cls, sizeof(H5Z_class2_t));
     } /* end else */
 
+    H5Z_TABLE_UNLOCK
+
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 }
@@ -427,11 +487,13 @@ H5Z__unregister(H5Z_filter_t filter_id)
 
     /* Remove filter from table */
     /* Don't worry about shrinking table size (for now) */
+    H5Z_TABLE_WRLOCK
     HDmemmove(&H5Z_table_g[filter_index], &H5Z_table_g[filter_index+1], sizeof(H5Z_class2_t)*((H5Z_table_used_g-1)-filter_index));
 #ifdef H5Z_DEBUG
     HDmemmove(&H5Z_stat_table_g[filter_index], &H5Z_stat_table_g[filter_index+1], sizeof(H5Z_stats_t)*((H5Z_table_used_g-1)-filter_index));
 #endif /* H5Z_DEBUG */
     H5Z_table_used_g--;
+    H5Z_TABLE_UNLOCK
 
 done:
     FUNC_LEAVE_NOAPI_VOL(ret_value)
@@ -1181,6 +1243,34 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5Z_find_idx() */
 
+
+/*-------------------------------------------------------------------------
+ * Function: H5Z__find_func
+ *
+ * Purpose:  Look up a filter's callback under the filter table's read
+ *           lock, for callers which may not hold the library lock.
+ *
+ * Return:   Success:    Non-negative index of entry in global filter table.
+ *           Failure:    Negative
+ *-------------------------------------------------------------------------
+ */
+static int
+H5Z__find_func(H5Z_filter_t id, H5Z_func_t *func)
+{
+    int    ret_value = FAIL;    /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(func);
+
+    H5Z_TABLE_RDLOCK
+    if ((ret_value = H5Z_find_idx(id)) >= 0)
+        *func = H5Z_table_g[ret_value].filter;
+    H5Z_TABLE_UNLOCK
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__find_func() */
+
 
 /*-------------------------------------------------------------------------
  * Function: H5Z_find
@@ -1231,6 +1321,9 @@ done:
  *           then the pipeline function should free the original buffer
  *           and return a fresh buffer, adjusting BUF_SIZE accordingly.
  *
+ *           The buffer returned is never one of the filter buffer pool's,
+ *           so it can be freed with H5MM_xfree().
+ *
  * Return:   Non-negative on success
  *           Negative on failure
  *-------------------------------------------------------------------------
@@ -1240,10 +1333,57 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
         unsigned *filter_mask/*in,out*/, H5Z_EDC_t edc_read,
         H5Z_cb_t cb_struct, size_t *nbytes/*in,out*/,
         size_t *buf_size/*in,out*/, void **buf/*in,out*/)
+{
+    herr_t      ret_value = SUCCEED;       /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    ret_value = H5Z_pipeline_lend(pline, flags, filter_mask, edc_read, cb_struct,
+            nbytes, buf_size, buf, NULL, (size_t)0);
+
+    /* The caller won't return the buffer to the pool */
+    H5Z__buf_forget(*buf);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_pipeline() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Z_pipeline_lend
+ *
+ * Purpose:  Process data through the filter pipeline, like
+ *           H5Z_pipeline(), lending the buffer *LENT_BUF of LENT_SIZE
+ *           bytes (if it isn't NULL) to the filters being reversed, for
+ *           their output.  The caller allocates it like a chunk with
+ *           filters, as big as the data will be once all the filters
+ *           have been reversed.
+ *
+ *           Filters which can uncompress straight into the lent buffer
+ *           are given it (just deflate, for now), which spares them from
+ *           allocating and growing buffers for data whose size they
+ *           don't know.  When a filter takes the buffer, *LENT_BUF is
+ *           set to NULL: it becomes the pipeline's buffer, and is freed
+ *           or returned in *BUF like any other.  Otherwise the caller
+ *           still owns it.
+ *
+ *           Unlike H5Z_pipeline(), the buffer returned in *BUF may be one
+ *           from the filter buffer pool, and must be freed with
+ *           H5Z_buf_free().
+ *
+ * Return:   Non-negative on success
+ *           Negative on failure
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Z_pipeline_lend(const H5O_pline_t *pline, unsigned flags,
+        unsigned *filter_mask/*in,out*/, H5Z_EDC_t edc_read,
+        H5Z_cb_t cb_struct, size_t *nbytes/*in,out*/,
+        size_t *buf_size/*in,out*/, void **buf/*in,out*/,
+        void **lent_buf/*in,out*/, size_t lent_size)
 {
     size_t    i, idx, new_nbytes;
     int       fclass_idx;        /* Index of filter class in global table */
-    H5Z_class2_t *fclass=NULL;   /* Filter class pointer */
+    H5Z_func_t filter_func = NULL; /* Filter callback */
 #ifdef H5Z_DEBUG
     H5Z_stats_t  *fstats=NULL;   /* Filter stats pointer */
     H5_timer_t    timer;
@@ -1274,7 +1414,7 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
              * indicate no plugin through HDF5_PRELOAD_PLUG (using the symbol "::"),
              * try to load it dynamically and register it.  Otherwise, return failure
              */
-            if ((fclass_idx = H5Z_find_idx(pline->filter[idx].id)) < 0) {
+            if ((fclass_idx = H5Z__find_func(pline->filter[idx].id, &filter_func)) < 0) {
                 hbool_t issue_error = FALSE;
                 H5PL_key_t key;
                 const H5Z_class2_t    *filter_info;
@@ -1287,7 +1427,7 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
                         HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "unable to register filter")
 
                     /* Search in the table of registered filters again to find the dynamic filter just loaded and registered */
-                    if ((fclass_idx = H5Z_find_idx(pline->filter[idx].id)) < 0)
+                    if ((fclass_idx = H5Z__find_func(pline->filter[idx].id, &filter_func)) < 0)
                         issue_error = TRUE;
                 }
                 else
@@ -1304,14 +1444,21 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
                 }
             } /* end if */
 
-            fclass = &H5Z_table_g[fclass_idx];
 #ifdef H5Z_DEBUG
             fstats = &H5Z_stat_table_g[fclass_idx];
             H5_timer_begin (&timer);
 #endif
             tmp_flags = flags | (pline->filter[idx].flags);
             tmp_flags |= (edc_read== H5Z_DISABLE_EDC) ? H5Z_FLAG_SKIP_EDC : 0;
-            new_nbytes = (fclass->filter)(tmp_flags, pline->filter[idx].cd_nelmts,
+            if(!H5Z__filter_pooled(filter_func))
+                H5Z__buf_forget(*buf);
+#ifdef H5_HAVE_FILTER_DEFLATE
+            if(lent_buf && *lent_buf && filter_func == H5Z_DEFLATE->filter)
+                new_nbytes = H5Z__filter_deflate_lend(tmp_flags, pline->filter[idx].cd_nelmts,
+                        pline->filter[idx].cd_values, *nbytes, buf_size, buf, lent_buf, lent_size);
+            else
+#endif /* H5_HAVE_FILTER_DEFLATE */
+            new_nbytes = (filter_func)(tmp_flags, pline->filter[idx].cd_nelmts,
                                         pline->filter[idx].cd_values, *nbytes, buf_size, buf);
 
 #ifdef H5Z_DEBUG
@@ -1339,7 +1486,7 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
                 failed |= (unsigned)1 << idx;
                 continue; /*filter excluded*/
             }
-            if ((fclass_idx = H5Z_find_idx(pline->filter[idx].id)) < 0) {
+            if ((fclass_idx = H5Z__find_func(pline->filter[idx].id, &filter_func)) < 0) {
                 /* Check if filter is optional -- If it isn't, then error */
                 if ((pline->filter[idx].flags & H5Z_FLAG_OPTIONAL) == 0)
                     HGOTO_ERROR(H5E_PLINE, H5E_WRITEERROR, FAIL, "required filter is not registered")
@@ -1348,12 +1495,13 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
                 H5E_clear_stack (NULL);
                 continue; /*filter excluded*/
             }
-            fclass = &H5Z_table_g[fclass_idx];
 #ifdef H5Z_DEBUG
             fstats = &H5Z_stat_table_g[fclass_idx];
             H5_timer_begin (&timer);
 #endif
-            new_nbytes = (fclass->filter)(flags | (pline->filter[idx].flags), pline->filter[idx].cd_nelmts,
+            if(!H5Z__filter_pooled(filter_func))
+                H5Z__buf_forget(*buf);
+            new_nbytes = (filter_func)(flags | (pline->filter[idx].flags), pline->filter[idx].cd_nelmts,
                     pline->filter[idx].cd_values, *nbytes, buf_size, buf);
 #ifdef H5Z_DEBUG
             H5_timer_end (&(fstats->stats[0].timer), &timer);
@@ -1381,7 +1529,78 @@ H5Z_pipeline(const H5O_pline_t *pline, unsigned flags,
 
 done:
     FUNC_LEAVE_NOAPI(ret_value)
-}
+} /* end H5Z_pipeline_lend() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Z__filter_pooled
+ *
+ * Purpose:  Check whether the filter function FUNC is one of the
+ *           library's own, which take buffers from the filter buffer
+ *           pool and free them with H5Z_buf_free().  Any other filter
+ *           may free or resize the buffer it's given behind the pool's
+ *           back, so the pool must forget the buffer first.
+ *
+ * Return:   TRUE/FALSE (never fails)
+ *-------------------------------------------------------------------------
+ */
+static hbool_t
+H5Z__filter_pooled(H5Z_func_t func)
+{
+    hbool_t ret_value = FALSE;          /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(func == H5Z_SHUFFLE->filter || func == H5Z_FLETCHER32->filter
+            || func == H5Z_NBIT->filter || func == H5Z_SCALEOFFSET->filter
+            || func == H5Z_BITSHUFFLE->filter)
+        ret_value = TRUE;
+#ifdef H5_HAVE_FILTER_DEFLATE
+    else if(func == H5Z_DEFLATE->filter)
+        ret_value = TRUE;
+#endif /* H5_HAVE_FILTER_DEFLATE */
+#ifdef H5_HAVE_FILTER_ZSTD
+    else if(func == H5Z_ZSTD->filter)
+        ret_value = TRUE;
+#endif /* H5_HAVE_FILTER_ZSTD */
+#ifdef H5_HAVE_FILTER_SZIP
+    else if(func == H5Z_SZIP->filter)
+        ret_value = TRUE;
+#endif /* H5_HAVE_FILTER_SZIP */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__filter_pooled() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: H5Z_filter_unlocked
+ *
+ * Purpose:  Check whether the registered filter ID can be run without
+ *           the library lock.  Only the library's own filters can: the
+ *           state they share between chunks has locks of its own, while
+ *           nothing is known about application filters or plugins.
+ *           SZIP isn't one of them, since the szip library itself may
+ *           not be thread-safe.
+ *
+ * Return:   TRUE/FALSE (never fails)
+ *-------------------------------------------------------------------------
+ */
+hbool_t
+H5Z_filter_unlocked(H5Z_filter_t id)
+{
+    int     idx;                        /* Filter index in global table */
+    hbool_t ret_value = FALSE;          /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    /* Predefined filter IDs can't be registered through the API, but a
+     * plugin could still take one over, so check the callback too */
+    if (id >= 0 && id < H5Z_FILTER_RESERVED && id != H5Z_FILTER_SZIP)
+        if ((idx = H5Z_find_idx(id)) >= 0)
+            ret_value = H5Z__filter_pooled(H5Z_table_g[idx].filter);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_filter_unlocked() */
 
 
 /*-------------------------------------------------------------------------
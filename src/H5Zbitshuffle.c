@@ -0,0 +1,421 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The bitshuffle filter, which transposes the bits of the
+ *              elements in a chunk, so that the first bit of every element
+ *              comes first, then the second, and so on.  Bits which hardly
+ *              change from element to element, like the exponents and high
+ *              mantissa bits of floating-point data, end up in long runs
+ *              which compress well.  The filter can compress the shuffled
+ *              data with the LZ4 codec in H5Zlz4.c as well.
+ *
+ *              The chunk is shuffled in blocks of a few kilobytes, each a
+ *              multiple of 8 elements, which are independent of each other
+ *              so that they can be shuffled and compressed in parallel.
+ *              Elements past the last multiple of 8 are stored as they are.
+ *
+ *              The data is laid out as by the bitshuffle filter plugin.
+ *              Without compression, each block is replaced by its bit rows
+ *              (8 times the element size of them, of one bit from each
+ *              element in the block, least significant bit of each byte
+ *              first).  With LZ4, the chunk starts with its size as a
+ *              big-endian 8-byte integer and the block size in bytes as a
+ *              big-endian 4-byte integer, and each block is stored as the
+ *              big-endian 4-byte size of its compressed bit rows, followed
+ *              by them.
+ */
+
+#include "H5Zmodule.h"          /* This source code file is part of the H5Z module */
+
+
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5Iprivate.h"		/* IDs			  		*/
+#include "H5MMprivate.h"	/* Memory management			*/
+#include "H5Pprivate.h"         /* Property lists                       */
+#include "H5Tprivate.h"		/* Datatypes         			*/
+#include "H5Zpkg.h"		/* Data filters				*/
+
+/* Local function prototypes */
+static herr_t H5Z_set_local_bitshuffle(hid_t dcpl_id, hid_t type_id, hid_t space_id);
+static size_t H5Z_filter_bitshuffle(unsigned flags, size_t cd_nelmts,
+    const unsigned cd_values[], size_t nbytes, size_t *buf_size, void **buf);
+static void H5Z__bitshuffle_block(uint8_t *dest, const uint8_t *src,
+    size_t elem_size, size_t nelmts);
+static void H5Z__bitunshuffle_block(uint8_t *dest, const uint8_t *src,
+    size_t elem_size, size_t nelmts);
+
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_BITSHUFFLE[1] = {{
+    H5Z_CLASS_T_VERS,       /* H5Z_class_t version */
+    H5Z_FILTER_BITSHUFFLE,	/* Filter id number		*/
+    1,              /* encoder_present flag (set to true) */
+    1,              /* decoder_present flag (set to true) */
+    "bitshuffle",		/* Filter name for debugging	*/
+    NULL,                       /* The "can apply" callback     */
+    H5Z_set_local_bitshuffle,   /* The "set local" callback     */
+    H5Z_filter_bitshuffle,	/* The actual filter function	*/
+}};
+
+/* Local macros */
+#define H5Z_BITSHUFFLE_VERS_MAJOR       0       /* Version of the plugin's layout */
+#define H5Z_BITSHUFFLE_VERS_MINOR       3
+#define H5Z_BITSHUFFLE_TARGET_BLOCK     8192    /* Bytes in a block by default */
+#define H5Z_BITSHUFFLE_MIN_BLOCK        128     /* Fewest elements in a block by default */
+#define H5Z_BITSHUFFLE_HDR_SIZE         12      /* Size of the header with LZ4 */
+#define H5Z_BITSHUFFLE_BLOCK_HDR_SIZE   4       /* Size of a block's header with LZ4 */
+
+/* Transpose the 8x8 bit matrix in X, with row I in its byte I */
+#define H5Z_BITSHUFFLE_TRANSPOSE8(X)                                         \
+{                                                                            \
+    uint64_t _t;                                                             \
+                                                                             \
+    _t = ((X) ^ ((X) >> 7)) & (uint64_t)0x00AA00AA00AA00AAULL;              \
+    (X) = (X) ^ _t ^ (_t << 7);                                              \
+    _t = ((X) ^ ((X) >> 14)) & (uint64_t)0x0000CCCC0000CCCCULL;             \
+    (X) = (X) ^ _t ^ (_t << 14);                                             \
+    _t = ((X) ^ ((X) >> 28)) & (uint64_t)0x00000000F0F0F0F0ULL;             \
+    (X) = (X) ^ _t ^ (_t << 28);                                             \
+}
+
+/* Big-endian integers in the LZ4 headers */
+#define H5Z_BITSHUFFLE_ENCODE32(P, V)                                        \
+{                                                                            \
+    (P)[0] = (uint8_t)((V) >> 24);                                           \
+    (P)[1] = (uint8_t)((V) >> 16);                                           \
+    (P)[2] = (uint8_t)((V) >> 8);                                            \
+    (P)[3] = (uint8_t)(V);                                                   \
+}
+#define H5Z_BITSHUFFLE_DECODE32(P)                                           \
+    (((uint32_t)(P)[0] << 24) | ((uint32_t)(P)[1] << 16) |                   \
+        ((uint32_t)(P)[2] << 8) | (uint32_t)(P)[3])
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_set_local_bitshuffle
+ *
+ * Purpose:	Set the "local" dataset parameters for bitshuffling: the
+ *              version of the layout and the size of the datatype.  The
+ *              block size and compression are left as the user set them.
+ *
+ * Return:	Success: Non-negative
+ *		Failure: Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5Z_set_local_bitshuffle(hid_t dcpl_id, hid_t type_id, hid_t H5_ATTR_UNUSED space_id)
+{
+    H5P_genplist_t *dcpl_plist;     /* Property list pointer */
+    const H5T_t	*type;                  /* Datatype */
+    unsigned flags;                     /* Filter flags */
+    size_t cd_nelmts = H5Z_BITSHUFFLE_TOTAL_NPARMS;     /* Number of filter parameters */
+    unsigned cd_values[H5Z_BITSHUFFLE_TOTAL_NPARMS] = {0, 0, 0, 0, 0};  /* Filter parameters */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Get the plist structure */
+    if(NULL == (dcpl_plist = H5P_object_verify(dcpl_id, H5P_DATASET_CREATE)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get datatype */
+    if(NULL == (type = (const H5T_t *)H5I_object_verify(type_id, H5I_DATATYPE)))
+	HGOTO_ERROR(H5E_ARGS, H5E_BADTYPE, FAIL, "not a datatype")
+
+    /* Get the filter's current parameters (any not set default to 0) */
+    if(H5P_get_filter_by_id(dcpl_plist, H5Z_FILTER_BITSHUFFLE, &flags, &cd_nelmts, cd_values, (size_t)0, NULL, NULL) < 0)
+	HGOTO_ERROR(H5E_PLINE, H5E_CANTGET, FAIL, "can't get bitshuffle parameters")
+
+    /* Check the user's parameters */
+    if(cd_values[H5Z_BITSHUFFLE_PARM_BLOCK] % H5Z_BITSHUFFLE_BLOCK_MULT)
+        HGOTO_ERROR(H5E_PLINE, H5E_BADVALUE, FAIL, "bitshuffle block size isn't a multiple of 8 elements")
+    if(cd_values[H5Z_BITSHUFFLE_PARM_COMP] != H5Z_BITSHUFFLE_COMP_NONE
+            && cd_values[H5Z_BITSHUFFLE_PARM_COMP] != H5Z_BITSHUFFLE_COMP_LZ4)
+        HGOTO_ERROR(H5E_PLINE, H5E_BADVALUE, FAIL, "unknown bitshuffle compression")
+
+    /* Set "local" parameters for this dataset */
+    cd_values[H5Z_BITSHUFFLE_PARM_VERS_MAJOR] = H5Z_BITSHUFFLE_VERS_MAJOR;
+    cd_values[H5Z_BITSHUFFLE_PARM_VERS_MINOR] = H5Z_BITSHUFFLE_VERS_MINOR;
+    if((cd_values[H5Z_BITSHUFFLE_PARM_SIZE] = (unsigned)H5T_get_size(type)) == 0)
+	HGOTO_ERROR(H5E_PLINE, H5E_BADTYPE, FAIL, "bad datatype size")
+
+    /* Modify the filter's parameters for this dataset */
+    if(H5P_modify_filter(dcpl_plist, H5Z_FILTER_BITSHUFFLE, flags, (size_t)H5Z_BITSHUFFLE_TOTAL_NPARMS, cd_values) < 0)
+	HGOTO_ERROR(H5E_PLINE, H5E_CANTSET, FAIL, "can't set local bitshuffle parameters")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_set_local_bitshuffle() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__bitshuffle_block
+ *
+ * Purpose:	Transposes the bits of a block of NELMTS elements of
+ *              ELEM_SIZE bytes, a multiple of 8 of them, into
+ *              8 * ELEM_SIZE bit rows of NELMTS / 8 bytes each.
+ *
+ *              Each byte of 8 consecutive elements is transposed as an
+ *              8x8 bit matrix, giving one byte of each of that byte's
+ *              8 bit rows.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__bitshuffle_block(uint8_t *dest, const uint8_t *src, size_t elem_size, size_t nelmts)
+{
+    size_t row_size = nelmts / 8;       /* Bytes in a bit row */
+    size_t i, j, k;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(nelmts % H5Z_BITSHUFFLE_BLOCK_MULT == 0);
+
+    for(j = 0; j < elem_size; j++) {
+        uint8_t *out = dest + j * 8 * row_size;
+
+        for(i = 0; i < row_size; i++) {
+            const uint8_t *in = src + i * 8 * elem_size + j;
+            uint64_t x = 0;
+
+            for(k = 0; k < 8; k++)
+                x |= (uint64_t)in[k * elem_size] << (8 * k);
+            H5Z_BITSHUFFLE_TRANSPOSE8(x)
+            for(k = 0; k < 8; k++)
+                out[k * row_size + i] = (uint8_t)(x >> (8 * k));
+        } /* end for */
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__bitshuffle_block() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__bitunshuffle_block
+ *
+ * Purpose:	Reverses H5Z__bitshuffle_block, turning the bit rows of a
+ *              block of NELMTS elements of ELEM_SIZE bytes back into the
+ *              elements.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__bitunshuffle_block(uint8_t *dest, const uint8_t *src, size_t elem_size, size_t nelmts)
+{
+    size_t row_size = nelmts / 8;       /* Bytes in a bit row */
+    size_t i, j, k;
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(nelmts % H5Z_BITSHUFFLE_BLOCK_MULT == 0);
+
+    for(j = 0; j < elem_size; j++) {
+        const uint8_t *in = src + j * 8 * row_size;
+
+        for(i = 0; i < row_size; i++) {
+            uint8_t *out = dest + i * 8 * elem_size + j;
+            uint64_t x = 0;
+
+            for(k = 0; k < 8; k++)
+                x |= (uint64_t)in[k * row_size + i] << (8 * k);
+            H5Z_BITSHUFFLE_TRANSPOSE8(x)
+            for(k = 0; k < 8; k++)
+                out[k * elem_size] = (uint8_t)(x >> (8 * k));
+        } /* end for */
+    } /* end for */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__bitunshuffle_block() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_filter_bitshuffle
+ *
+ * Purpose:	Implement an I/O filter which bitshuffles the elements in
+ *              a chunk and optionally compresses the result with LZ4.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z_filter_bitshuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
+    size_t nbytes, size_t *buf_size, void **buf)
+{
+    const uint8_t *src = (const uint8_t *)*buf;     /* Data to filter */
+    uint8_t *dest = NULL;               /* Filtered data */
+    uint8_t *tmp = NULL;                /* Block of bit rows, with LZ4 */
+    size_t elem_size;                   /* Size of an element */
+    size_t block_size;                  /* Elements in a full block */
+    size_t nelmts;                      /* Elements in the chunk */
+    size_t dest_size;                   /* Size of the filtered data */
+    size_t leftover;                    /* Bytes after the last multiple of 8 elements */
+    size_t done;                        /* Elements filtered so far */
+    unsigned comp;                      /* Compression */
+    size_t ret_value = 0;               /* Return value */
+
+    FUNC_ENTER_NOAPI(0)
+
+    /* Check arguments */
+    if(cd_nelmts != H5Z_BITSHUFFLE_TOTAL_NPARMS || cd_values[H5Z_BITSHUFFLE_PARM_SIZE] == 0)
+	HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid bitshuffle parameters")
+    elem_size = cd_values[H5Z_BITSHUFFLE_PARM_SIZE];
+    comp = cd_values[H5Z_BITSHUFFLE_PARM_COMP];
+    if(comp != H5Z_BITSHUFFLE_COMP_NONE && comp != H5Z_BITSHUFFLE_COMP_LZ4)
+	HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "unknown bitshuffle compression")
+
+    /* Work out the chunk's size and its blocks' */
+    if(comp == H5Z_BITSHUFFLE_COMP_LZ4 && (flags & H5Z_FLAG_REVERSE)) {
+        uint64_t chunk_size;
+        uint32_t block_bytes;
+
+        if(nbytes < H5Z_BITSHUFFLE_HDR_SIZE)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle chunk is truncated")
+        chunk_size = ((uint64_t)H5Z_BITSHUFFLE_DECODE32(src) << 32) | H5Z_BITSHUFFLE_DECODE32(src + 4);
+        block_bytes = H5Z_BITSHUFFLE_DECODE32(src + 8);
+        if(chunk_size > (uint64_t)((size_t)-1) || chunk_size % elem_size
+                || block_bytes == 0 || block_bytes % (elem_size * H5Z_BITSHUFFLE_BLOCK_MULT))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bad bitshuffle chunk header")
+        dest_size = (size_t)chunk_size;
+        block_size = block_bytes / elem_size;
+    } /* end if */
+    else {
+        if(nbytes % elem_size)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "chunk isn't a whole number of elements")
+        dest_size = nbytes;
+        if(0 == (block_size = cd_values[H5Z_BITSHUFFLE_PARM_BLOCK])) {
+            /* A block which fits in the L1 cache */
+            block_size = H5Z_BITSHUFFLE_TARGET_BLOCK / elem_size;
+            block_size -= block_size % H5Z_BITSHUFFLE_BLOCK_MULT;
+            block_size = MAX(block_size, H5Z_BITSHUFFLE_MIN_BLOCK);
+        } /* end if */
+        else if(block_size % H5Z_BITSHUFFLE_BLOCK_MULT)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "bitshuffle block size isn't a multiple of 8 elements")
+        if(block_size > (size_t)0xffffffff / elem_size)
+            HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "bitshuffle block size is too large")
+    } /* end else */
+    nelmts = dest_size / elem_size;
+    leftover = (nelmts % H5Z_BITSHUFFLE_BLOCK_MULT) * elem_size;
+
+    if(comp == H5Z_BITSHUFFLE_COMP_NONE) {
+        /* Shuffle or unshuffle each block in place */
+        if(NULL == (dest = (uint8_t *)H5Z_buf_malloc(MAX(dest_size, 1))))
+	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle buffer")
+
+        for(done = 0; done + H5Z_BITSHUFFLE_BLOCK_MULT <= nelmts; done += block_size) {
+            size_t n = MIN(block_size, nelmts - done);
+
+            n -= n % H5Z_BITSHUFFLE_BLOCK_MULT;
+            if(flags & H5Z_FLAG_REVERSE)
+                H5Z__bitunshuffle_block(dest + done * elem_size, src + done * elem_size, elem_size, n);
+            else
+                H5Z__bitshuffle_block(dest + done * elem_size, src + done * elem_size, elem_size, n);
+        } /* end for */
+        if(leftover)
+            HDmemcpy(dest + dest_size - leftover, src + dest_size - leftover, leftover);
+
+        ret_value = dest_size;
+    } /* end if */
+    else if(flags & H5Z_FLAG_REVERSE) {
+        const uint8_t *in = src + H5Z_BITSHUFFLE_HDR_SIZE;
+        const uint8_t *in_end = src + nbytes;
+
+        /* Input */
+        if(NULL == (dest = (uint8_t *)H5Z_buf_malloc(MAX(dest_size, 1))))
+	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle buffer")
+        if(NULL == (tmp = (uint8_t *)H5Z_buf_malloc(block_size * elem_size)))
+	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle block")
+
+        /* Decompress and unshuffle each block */
+        for(done = 0; done + H5Z_BITSHUFFLE_BLOCK_MULT <= nelmts; done += block_size) {
+            size_t n = MIN(block_size, nelmts - done);
+            size_t comp_size;
+
+            n -= n % H5Z_BITSHUFFLE_BLOCK_MULT;
+            if((size_t)(in_end - in) < H5Z_BITSHUFFLE_BLOCK_HDR_SIZE)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle chunk is truncated")
+            comp_size = H5Z_BITSHUFFLE_DECODE32(in);
+            in += H5Z_BITSHUFFLE_BLOCK_HDR_SIZE;
+            if(comp_size > (size_t)(in_end - in))
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle chunk is truncated")
+            if(H5Z__lz4_decompress(in, comp_size, tmp, n * elem_size) < 0)
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "can't decompress bitshuffle block")
+            in += comp_size;
+            H5Z__bitunshuffle_block(dest + done * elem_size, tmp, elem_size, n);
+        } /* end for */
+        if((size_t)(in_end - in) != leftover)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "bitshuffle chunk is the wrong size")
+        if(leftover)
+            HDmemcpy(dest + dest_size - leftover, in, leftover);
+
+        ret_value = dest_size;
+    } /* end if */
+    else {
+        size_t nblocks = (nelmts + block_size - 1) / block_size;
+        size_t bound = H5Z__lz4_compress_bound(block_size * elem_size);
+        uint8_t *out;
+
+        /* The header, and each block, which may grow a little if it doesn't
+         * compress */
+        dest_size = H5Z_BITSHUFFLE_HDR_SIZE + nblocks * (H5Z_BITSHUFFLE_BLOCK_HDR_SIZE + bound) + leftover;
+        if(NULL == (dest = (uint8_t *)H5Z_buf_malloc(dest_size)))
+	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle buffer")
+        if(NULL == (tmp = (uint8_t *)H5Z_buf_malloc(block_size * elem_size)))
+	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for bitshuffle block")
+
+        H5Z_BITSHUFFLE_ENCODE32(dest, (uint32_t)((uint64_t)nbytes >> 32))
+        H5Z_BITSHUFFLE_ENCODE32(dest + 4, (uint32_t)nbytes)
+        H5Z_BITSHUFFLE_ENCODE32(dest + 8, (uint32_t)(block_size * elem_size))
+        out = dest + H5Z_BITSHUFFLE_HDR_SIZE;
+
+        /* Shuffle and compress each block */
+        for(done = 0; done + H5Z_BITSHUFFLE_BLOCK_MULT <= nelmts; done += block_size) {
+            size_t n = MIN(block_size, nelmts - done);
+            size_t comp_size;
+
+            n -= n % H5Z_BITSHUFFLE_BLOCK_MULT;
+            H5Z__bitshuffle_block(tmp, src + done * elem_size, elem_size, n);
+            if(0 == (comp_size = H5Z__lz4_compress(tmp, n * elem_size, out + H5Z_BITSHUFFLE_BLOCK_HDR_SIZE, bound)))
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTFILTER, 0, "can't compress bitshuffle block")
+            H5Z_BITSHUFFLE_ENCODE32(out, (uint32_t)comp_size)
+            out += H5Z_BITSHUFFLE_BLOCK_HDR_SIZE + comp_size;
+        } /* end for */
+        if(leftover) {
+            HDmemcpy(out, src + nbytes - leftover, leftover);
+            out += leftover;
+        } /* end if */
+
+        ret_value = (size_t)(out - dest);
+    } /* end else */
+
+    /* Replace the input buffer */
+    H5Z_buf_free(*buf);
+    *buf = dest;
+    *buf_size = dest_size;
+    dest = NULL;
+
+done:
+    if(dest)
+        H5Z_buf_free(dest);
+    if(tmp)
+        H5Z_buf_free(tmp);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_filter_bitshuffle() */
+
@@ -33,9 +33,20 @@
 # include H5_ZLIB_HEADER /* "zlib.h" */
 #endif
 
+/* A zlib stream for each direction, either set up when first needed */
+typedef struct H5Z_deflate_ctx_t {
+    z_stream inflate_strm;              /* Stream for uncompressing */
+    hbool_t inflate_init;               /* Whether inflate_strm is set up */
+    z_stream deflate_strm;              /* Stream for compressing */
+    int deflate_level;                  /* Its aggression level, or -1 if not set up */
+    struct H5Z_deflate_ctx_t *next;     /* Next context in the pool */
+} H5Z_deflate_ctx_t;
+
 /* Local function prototypes */
 static size_t H5Z_filter_deflate (unsigned flags, size_t cd_nelmts,
     const unsigned cd_values[], size_t nbytes, size_t *buf_size, void **buf);
+static H5Z_deflate_ctx_t *H5Z__deflate_get_ctx(void);
+static void H5Z__deflate_put_ctx(H5Z_deflate_ctx_t *ctx);
 
 /* This message derives from H5Z */
 const H5Z_class2_t H5Z_DEFLATE[1] = {{
@@ -51,7 +62,24 @@ const H5Z_class2_t H5Z_DEFLATE[1] = {{
 
 #define H5Z_DEFLATE_SIZE_ADJUST(s) (HDceil(((double)(s)) * (double)1.001f) + 12)
 
-
+/* Pool of zlib streams.  Setting up a stream allocates its window and
+ * tables, which costs more than compressing a small chunk, so streams are
+ * reset and reused instead.  Chunks are filtered by threads which don't
+ * hold the library lock, so the pool has a lock of its own; a thread has
+ * a context to itself while it filters a chunk.
+ */
+static H5Z_deflate_ctx_t *H5Z_deflate_ctxs_g = NULL;
+
+#ifdef H5Z_HAVE_FILTER_LOCKS
+static pthread_mutex_t H5Z_deflate_lock_g = PTHREAD_MUTEX_INITIALIZER;
+#define H5Z_DEFLATE_LOCK    (void)pthread_mutex_lock(&H5Z_deflate_lock_g);
+#define H5Z_DEFLATE_UNLOCK  (void)pthread_mutex_unlock(&H5Z_deflate_lock_g);
+#else
+#define H5Z_DEFLATE_LOCK
+#define H5Z_DEFLATE_UNLOCK
+#endif /* H5Z_HAVE_FILTER_LOCKS */
+
+
 /*-------------------------------------------------------------------------
  * Function:	H5Z_filter_deflate
  *
@@ -64,8 +92,6 @@ const H5Z_class2_t H5Z_DEFLATE[1] = {{
  * Programmer:	Robb Matzke
  *              Thursday, April 16, 1998
  *
- * Modifications:
- *
  *-------------------------------------------------------------------------
  */
 static size_t
@@ -73,11 +99,43 @@ H5Z_filter_deflate (unsigned flags, size_t cd_nelmts,
 		    const unsigned cd_values[], size_t nbytes,
 		    size_t *buf_size, void **buf)
 {
+    size_t	ret_value = 0;          /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    ret_value = H5Z__filter_deflate_lend(flags, cd_nelmts, cd_values, nbytes, buf_size, buf, NULL, (size_t)0);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_filter_deflate() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__filter_deflate_lend
+ *
+ * Purpose:	The deflate filter, uncompressing into the buffer *LENT_BUF
+ *              of LENT_SIZE bytes when one is lent.  The lent buffer is
+ *              used (and *LENT_BUF set to NULL) unless the data turns out
+ *              not to fit; without one, the output buffer starts out as
+ *              big as the input buffer.  Output buffers only grow when
+ *              the data doesn't fit.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+size_t
+H5Z__filter_deflate_lend(unsigned flags, size_t cd_nelmts,
+    const unsigned cd_values[], size_t nbytes, size_t *buf_size, void **buf,
+    void **lent_buf, size_t lent_size)
+{
+    H5Z_deflate_ctx_t *ctx = NULL;      /* Streams from the pool */
     void	*outbuf = NULL;         /* Pointer to new buffer */
+    hbool_t     lent = FALSE;           /* Whether outbuf is the lent buffer */
     int		status;                 /* Status from zlib operation */
     size_t	ret_value = 0;          /* Return value */
 
-    FUNC_ENTER_NOAPI(0)
+    FUNC_ENTER_PACKAGE
 
     /* Sanity check */
     HDassert(*buf_size > 0);
@@ -88,71 +146,90 @@ H5Z_filter_deflate (unsigned flags, size_t cd_nelmts,
     if (cd_nelmts!=1 || cd_values[0]>9)
 	HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid deflate aggression level")
 
+    /* Get streams to work with */
+    if(NULL == (ctx = H5Z__deflate_get_ctx()))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for deflate streams")
+
     if (flags & H5Z_FLAG_REVERSE) {
 	/* Input; uncompress */
-	z_stream	z_strm;                 /* zlib parameters */
-	size_t		nalloc = *buf_size;     /* Number of bytes for output (compressed) buffer */
-
-        /* Allocate space for the compressed buffer */
-	if (NULL==(outbuf = H5MM_malloc(nalloc)))
-	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for deflate uncompression")
+	z_stream	*z_strm = &ctx->inflate_strm;   /* zlib parameters */
+	size_t		nalloc;                 /* Number of bytes for output (uncompressed) buffer */
+
+        /* Set up or reset the uncompression stream */
+        if(ctx->inflate_init) {
+            if(Z_OK != inflateReset(z_strm))
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "inflateReset() failed")
+        } /* end if */
+        else {
+            if(Z_OK != inflateInit(z_strm))
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "inflateInit() failed")
+            ctx->inflate_init = TRUE;
+        } /* end else */
+
+        /* Uncompress into the lent buffer, or allocate one */
+        if(lent_buf && *lent_buf && lent_size > 0) {
+            outbuf = *lent_buf;
+            nalloc = lent_size;
+            lent = TRUE;
+        } /* end if */
+        else {
+            nalloc = *buf_size;
+            if (NULL==(outbuf = H5Z_buf_malloc(nalloc)))
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for deflate uncompression")
+        } /* end else */
 
         /* Set the uncompression parameters */
-	HDmemset(&z_strm, 0, sizeof(z_strm));
-	z_strm.next_in = (Bytef *)*buf;
-        H5_CHECKED_ASSIGN(z_strm.avail_in, unsigned, nbytes, size_t);
-	z_strm.next_out = (Bytef *)outbuf;
-        H5_CHECKED_ASSIGN(z_strm.avail_out, unsigned, nalloc, size_t);
-
-        /* Initialize the uncompression routines */
-	if (Z_OK!=inflateInit(&z_strm))
-	    HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "inflateInit() failed")
+	z_strm->next_in = (Bytef *)*buf;
+        H5_CHECKED_ASSIGN(z_strm->avail_in, unsigned, nbytes, size_t);
+	z_strm->next_out = (Bytef *)outbuf;
+        H5_CHECKED_ASSIGN(z_strm->avail_out, unsigned, nalloc, size_t);
 
         /* Loop to uncompress the buffer */
 	do {
-            /* Uncompress some data */
-	    status = inflate(&z_strm, Z_SYNC_FLUSH);
+            /* Uncompress the rest of the data */
+	    status = inflate(z_strm, Z_FINISH);
 
             /* Check if we are done uncompressing data */
 	    if (Z_STREAM_END==status)
                 break;	/*done*/
 
             /* Check for error */
-	    if (Z_OK!=status) {
-		(void)inflateEnd(&z_strm);
+            if((Z_OK != status && Z_BUF_ERROR != status) || 0 != z_strm->avail_out)
 		HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "inflate() failed")
-	    }
+
+            /* We're not done and just ran out of buffer space, get more */
             else {
-                /* If we're not done and just ran out of buffer space, get more */
-                if(0 == z_strm.avail_out) {
-                    void	*new_outbuf;         /* Pointer to new output buffer */
-
-                    /* Allocate a buffer twice as big */
-                    nalloc *= 2;
-                    if(NULL == (new_outbuf = H5MM_realloc(outbuf, nalloc))) {
-                        (void)inflateEnd(&z_strm);
-                        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for deflate uncompression")
-                    } /* end if */
-                    outbuf = new_outbuf;
+                void	*new_outbuf;         /* Pointer to new output buffer */
 
-                    /* Update pointers to buffer for next set of uncompressed data */
-                    z_strm.next_out = (unsigned char*)outbuf + z_strm.total_out;
-                    z_strm.avail_out = (uInt)(nalloc - z_strm.total_out);
+                /* Allocate a buffer twice as big */
+                nalloc *= 2;
+                if(lent) {
+                    /* Leave the lent buffer to its owner */
+                    if(NULL == (new_outbuf = H5Z_buf_malloc(nalloc)))
+                        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for deflate uncompression")
+                    HDmemcpy(new_outbuf, outbuf, (size_t)z_strm->total_out);
+                    lent = FALSE;
                 } /* end if */
+                else if(NULL == (new_outbuf = H5Z_buf_realloc(outbuf, nalloc)))
+                    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for deflate uncompression")
+                outbuf = new_outbuf;
+
+                /* Update pointers to buffer for next set of uncompressed data */
+                z_strm->next_out = (unsigned char*)outbuf + z_strm->total_out;
+                z_strm->avail_out = (uInt)(nalloc - z_strm->total_out);
             } /* end else */
-	} while(status==Z_OK);
+	} while(1);
 
         /* Free the input buffer */
-	H5MM_xfree(*buf);
+	H5Z_buf_free(*buf);
 
         /* Set return values */
 	*buf = outbuf;
 	outbuf = NULL;
+        if(lent)
+            *lent_buf = NULL;
 	*buf_size = nalloc;
-	ret_value = z_strm.total_out;
-
-        /* Finish uncompressing the stream */
-	(void)inflateEnd(&z_strm);
+	ret_value = z_strm->total_out;
     } /* end if */
     else {
 	/*
@@ -160,47 +237,149 @@ H5Z_filter_deflate (unsigned flags, size_t cd_nelmts,
 	 * input.  The library doesn't provide in-place compression, so we
 	 * must allocate a separate buffer for the result.
 	 */
-	const Bytef *z_src = (const Bytef*)(*buf);
-	Bytef	    *z_dst;		/*destination buffer		*/
-	uLongf	     z_dst_nbytes = (uLongf)H5Z_DEFLATE_SIZE_ADJUST(nbytes);
-	uLong	     z_src_nbytes = (uLong)nbytes;
+	z_stream	*z_strm = &ctx->deflate_strm;   /* zlib parameters */
+	uLong		z_dst_nbytes;   /* Size of destination buffer */
         int          aggression;     /* Compression aggression setting */
 
         /* Set the compression aggression level */
         H5_CHECKED_ASSIGN(aggression, int, cd_values[0], unsigned);
 
-        /* Allocate output (compressed) buffer */
-	if(NULL == (outbuf = H5MM_malloc(z_dst_nbytes)))
+        /* Set up or reset the compression stream, at this level */
+        if(ctx->deflate_level < 0) {
+            if(Z_OK != deflateInit(z_strm, aggression))
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "deflateInit() failed")
+            ctx->deflate_level = aggression;
+        } /* end if */
+        else {
+            if(Z_OK != deflateReset(z_strm))
+                HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "deflateReset() failed")
+            if(ctx->deflate_level != aggression) {
+                if(Z_OK != deflateParams(z_strm, aggression, Z_DEFAULT_STRATEGY))
+                    HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "deflateParams() failed")
+                ctx->deflate_level = aggression;
+            } /* end if */
+        } /* end else */
+
+        /* Allocate output (compressed) buffer, with room for data which
+         * grows a little */
+        z_dst_nbytes = (uLong)H5Z_DEFLATE_SIZE_ADJUST(nbytes);
+	if(NULL == (outbuf = H5Z_buf_malloc((size_t)z_dst_nbytes)))
 	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "unable to allocate deflate destination buffer")
-        z_dst = (Bytef *)outbuf;
 
         /* Perform compression from the source to the destination buffer */
-	status = compress2(z_dst, &z_dst_nbytes, z_src, z_src_nbytes, aggression);
+	z_strm->next_in = (Bytef *)*buf;
+        H5_CHECKED_ASSIGN(z_strm->avail_in, unsigned, nbytes, size_t);
+	z_strm->next_out = (Bytef *)outbuf;
+        H5_CHECKED_ASSIGN(z_strm->avail_out, unsigned, (size_t)z_dst_nbytes, size_t);
+	status = deflate(z_strm, Z_FINISH);
 
         /* Check for various zlib errors */
-	if(Z_BUF_ERROR == status)
+	if(Z_OK == status || Z_BUF_ERROR == status)
 	    HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "overflow")
-	else if(Z_MEM_ERROR == status)
-	    HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "deflate memory error")
-	else if(Z_OK != status)
+	else if(Z_STREAM_END != status)
 	    HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, 0, "other deflate error")
-        /* Successfully uncompressed the buffer */
+        /* Successfully compressed the buffer */
         else {
             /* Free the input buffer */
-	    H5MM_xfree(*buf);
+	    H5Z_buf_free(*buf);
 
             /* Set return values */
 	    *buf = outbuf;
 	    outbuf = NULL;
 	    *buf_size = nbytes;
-	    ret_value = z_dst_nbytes;
+	    ret_value = z_strm->total_out;
 	} /* end else */
     } /* end else */
 
 done:
-    if(outbuf)
-        H5MM_xfree(outbuf);
+    if(outbuf && !lent)
+        H5Z_buf_free(outbuf);
+    if(ctx)
+        H5Z__deflate_put_ctx(ctx);
     FUNC_LEAVE_NOAPI(ret_value)
-}
-#endif /* H5_HAVE_FILTER_DEFLATE */
+} /* end H5Z__filter_deflate_lend() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__deflate_get_ctx
+ *
+ * Purpose:	Takes streams from the pool, or allocates them (to be set up
+ *              when first used) if the pool is empty.
+ *
+ * Return:	Success: Pointer to the streams
+ *		Failure: NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5Z_deflate_ctx_t *
+H5Z__deflate_get_ctx(void)
+{
+    H5Z_deflate_ctx_t *ctx;             /* Streams */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    H5Z_DEFLATE_LOCK
+    if(NULL != (ctx = H5Z_deflate_ctxs_g))
+        H5Z_deflate_ctxs_g = ctx->next;
+    H5Z_DEFLATE_UNLOCK
+
+    if(NULL == ctx && NULL != (ctx = (H5Z_deflate_ctx_t *)H5MM_calloc(sizeof(H5Z_deflate_ctx_t))))
+        ctx->deflate_level = -1;
+
+    FUNC_LEAVE_NOAPI(ctx)
+} /* end H5Z__deflate_get_ctx() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__deflate_put_ctx
+ *
+ * Purpose:	Returns streams to the pool.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__deflate_put_ctx(H5Z_deflate_ctx_t *ctx)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    H5Z_DEFLATE_LOCK
+    ctx->next = H5Z_deflate_ctxs_g;
+    H5Z_deflate_ctxs_g = ctx;
+    H5Z_DEFLATE_UNLOCK
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__deflate_put_ctx() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__deflate_term
+ *
+ * Purpose:	Frees the pool of streams, when the library closes.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5Z__deflate_term(void)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    H5Z_DEFLATE_LOCK
+    while(H5Z_deflate_ctxs_g) {
+        H5Z_deflate_ctx_t *ctx = H5Z_deflate_ctxs_g;
+
+        H5Z_deflate_ctxs_g = ctx->next;
+        if(ctx->inflate_init)
+            (void)inflateEnd(&ctx->inflate_strm);
+        if(ctx->deflate_level >= 0)
+            (void)deflateEnd(&ctx->deflate_strm);
+        H5MM_xfree(ctx);
+    } /* end while */
+    H5Z_DEFLATE_UNLOCK
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__deflate_term() */
+#endif /* H5_HAVE_FILTER_DEFLATE */
@@ -134,31 +134,23 @@ H5Z_filter_fletcher32 (unsigned flags, size_t H5_ATTR_UNUSED cd_nelmts, const un
         /* Compute checksum (can't fail) */
         fletcher = H5_checksum_fletcher32(src, nbytes);
 
-	if (NULL == (outbuf = H5MM_malloc(nbytes + FLETCHER_LEN)))
+        /* Grow the input buffer to hold the checksum too (a pooled buffer
+         * usually has room for it already, and isn't moved) */
+	if (NULL == (outbuf = H5Z_buf_realloc(*buf, nbytes + FLETCHER_LEN)))
 	    HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "unable to allocate Fletcher32 checksum destination buffer")
-
-        dst = (unsigned char *) outbuf;
-
-        /* Copy raw data */
-        HDmemcpy((void*)dst, (void*)(*buf), nbytes);
+	*buf = outbuf;
+	outbuf = NULL;
 
         /* Append checksum to raw data for storage */
-        dst += nbytes;
+        dst = (unsigned char *)(*buf) + nbytes;
         UINT32ENCODE(dst, fletcher);
 
-        /* Free input buffer */
- 	H5MM_xfree(*buf);
-
         /* Set return values */
         *buf_size = nbytes + FLETCHER_LEN;
-	*buf = outbuf;
-	outbuf = NULL;
 	ret_value = *buf_size;
     }
 
 done:
-    if(outbuf)
-        H5MM_xfree(outbuf);
     FUNC_LEAVE_NOAPI(ret_value)
 }
 
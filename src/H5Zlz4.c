@@ -0,0 +1,331 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	A small codec for the LZ4 block format, used by filters
+ *              which compress their data in independent blocks (see
+ *              H5Zbitshuffle.c).
+ *
+ *              A block is a series of sequences, each of which is a token
+ *              byte (the number of literals in its high nibble and the
+ *              match length less 4 in its low nibble, either of which is
+ *              continued in following bytes of 255 when it's 15), the
+ *              literals, and a little-endian 2-byte offset back to the
+ *              match.  The last sequence has only literals.  The last 5
+ *              bytes of a block are always literals, and no match starts
+ *              in the last 12 bytes.
+ *
+ *              The compressor is a greedy single pass with a hash table
+ *              of recent positions, which speeds up over data that doesn't
+ *              compress.  The decompressor checks every length and offset
+ *              against its buffers, so corrupt data in a file is an error
+ *              rather than a crash.
+ */
+
+#include "H5Zmodule.h"          /* This source code file is part of the H5Z module */
+
+
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5Zpkg.h"		/* Data filters				*/
+
+/* Format limits */
+#define H5Z_LZ4_MINMATCH        4       /* Shortest match */
+#define H5Z_LZ4_LASTLITERALS    5       /* Bytes at the end which are always literals */
+#define H5Z_LZ4_MFLIMIT         12      /* No match starts in this many bytes at the end */
+#define H5Z_LZ4_MAX_DISTANCE    65535   /* Longest offset back to a match */
+#define H5Z_LZ4_RUN_MASK        15      /* Length which continues in more bytes */
+
+/* Compressor tuning */
+#define H5Z_LZ4_HASH_LOG        12      /* log2 of the hash table's size */
+#define H5Z_LZ4_SKIP_TRIGGER    6       /* Misses before the search starts skipping */
+
+/* Read 4 bytes for comparing and hashing, whatever their alignment */
+#define H5Z_LZ4_READ32(P, V)    HDmemcpy(&(V), (P), sizeof(uint32_t))
+
+/* Hash the 4 bytes at a position */
+#define H5Z_LZ4_HASH(V)         (((V) * 2654435761U) >> (32 - H5Z_LZ4_HASH_LOG))
+
+/* Write a length which continues past its nibble */
+#define H5Z_LZ4_PUT_LENGTH(OP, L)                                            \
+{                                                                            \
+    size_t _len = (L);                                                       \
+                                                                             \
+    while(_len >= 255) {                                                     \
+        *(OP)++ = 255;                                                       \
+        _len -= 255;                                                         \
+    }                                                                        \
+    *(OP)++ = (uint8_t)_len;                                                 \
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__lz4_compress_bound
+ *
+ * Purpose:	Computes the largest size which NBYTES bytes can compress
+ *              to, which is a little more than NBYTES when the data
+ *              doesn't compress.
+ *
+ * Return:	The size
+ *
+ *-------------------------------------------------------------------------
+ */
+size_t
+H5Z__lz4_compress_bound(size_t nbytes)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    FUNC_LEAVE_NOAPI(nbytes + (nbytes / 255) + 16)
+} /* end H5Z__lz4_compress_bound() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__lz4_compress
+ *
+ * Purpose:	Compresses the SRC_SIZE bytes at SRC into a block at DST,
+ *              which has room for DST_SIZE bytes.
+ *
+ * Return:	Success:	Size of the compressed block
+ *		Failure:	0, if the block doesn't fit in DST_SIZE
+ *                              bytes (which can't happen when DST_SIZE is
+ *                              H5Z__lz4_compress_bound(SRC_SIZE))
+ *
+ *-------------------------------------------------------------------------
+ */
+size_t
+H5Z__lz4_compress(const void *_src, size_t src_size, void *_dst, size_t dst_size)
+{
+    const uint8_t *src = (const uint8_t *)_src;
+    const uint8_t *ip = src;                    /* Current position */
+    const uint8_t *anchor = src;                /* Start of literals not yet written */
+    const uint8_t *iend = src + src_size;
+    const uint8_t *mflimit;                     /* Last position a match can start at */
+    const uint8_t *matchlimit;                  /* End of the bytes a match can cover */
+    uint8_t *dst = (uint8_t *)_dst;
+    uint8_t *op = dst;                          /* Current output position */
+    uint8_t *oend = dst + dst_size;
+    uint32_t htab[1 << H5Z_LZ4_HASH_LOG];       /* Positions by hash of their bytes */
+    size_t lit_len;                             /* Number of literals */
+    size_t ret_value = 0;                       /* Return value */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    /* Blocks too short for a match are all literals */
+    if(src_size > H5Z_LZ4_MFLIMIT) {
+        uint32_t v;
+
+        mflimit = iend - H5Z_LZ4_MFLIMIT;
+        matchlimit = iend - H5Z_LZ4_LASTLITERALS;
+
+        /* Every entry points at the start until it's replaced, which is
+         * only ever a wasted comparison */
+        HDmemset(htab, 0, sizeof(htab));
+        ip++;
+
+        for(;;) {
+            const uint8_t *ref;         /* Match candidate */
+            uint8_t *token;             /* Token of this sequence */
+            size_t step = 1;
+            unsigned misses = 1u << H5Z_LZ4_SKIP_TRIGGER;
+            size_t match_len;
+            uint32_t r;
+
+            /* Look for a match, moving on faster the longer none is found */
+            for(;;) {
+                uint32_t h;
+
+                if(ip > mflimit)
+                    goto last_literals;
+
+                H5Z_LZ4_READ32(ip, v);
+                h = H5Z_LZ4_HASH(v);
+                ref = src + htab[h];
+                htab[h] = (uint32_t)(ip - src);
+                if(ref < ip && (size_t)(ip - ref) <= H5Z_LZ4_MAX_DISTANCE) {
+                    H5Z_LZ4_READ32(ref, r);
+                    if(r == v)
+                        break;
+                } /* end if */
+
+                ip += step;
+                step = misses++ >> H5Z_LZ4_SKIP_TRIGGER;
+            } /* end for */
+
+            /* Extend the match back over literals, and forward */
+            while(ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            } /* end while */
+            match_len = H5Z_LZ4_MINMATCH;
+            while(ip + match_len < matchlimit && ip[match_len] == ref[match_len])
+                match_len++;
+
+            /* Make sure the sequence fits: a token, the literals and their
+             * length, an offset and the match length */
+            lit_len = (size_t)(ip - anchor);
+            if((size_t)(oend - op) < 1 + lit_len + (lit_len / 255) + 1 + 2 + (match_len / 255) + 1)
+                HGOTO_DONE(0)
+
+            /* Write the token and the literals */
+            token = op++;
+            if(lit_len >= H5Z_LZ4_RUN_MASK) {
+                *token = H5Z_LZ4_RUN_MASK << 4;
+                H5Z_LZ4_PUT_LENGTH(op, lit_len - H5Z_LZ4_RUN_MASK)
+            } /* end if */
+            else
+                *token = (uint8_t)(lit_len << 4);
+            HDmemcpy(op, anchor, lit_len);
+            op += lit_len;
+
+            /* Write the offset and the match length */
+            *op++ = (uint8_t)((ip - ref) & 0xff);
+            *op++ = (uint8_t)((ip - ref) >> 8);
+            if(match_len - H5Z_LZ4_MINMATCH >= H5Z_LZ4_RUN_MASK) {
+                *token |= H5Z_LZ4_RUN_MASK;
+                H5Z_LZ4_PUT_LENGTH(op, match_len - H5Z_LZ4_MINMATCH - H5Z_LZ4_RUN_MASK)
+            } /* end if */
+            else
+                *token |= (uint8_t)(match_len - H5Z_LZ4_MINMATCH);
+
+            /* Carry on after the match, remembering a position inside it */
+            ip += match_len;
+            anchor = ip;
+            if(ip > mflimit)
+                break;
+            H5Z_LZ4_READ32(ip - 2, v);
+            htab[H5Z_LZ4_HASH(v)] = (uint32_t)(ip - 2 - src);
+        } /* end for */
+    } /* end if */
+
+last_literals:
+    /* The last sequence is the remaining literals */
+    lit_len = (size_t)(iend - anchor);
+    if((size_t)(oend - op) < 1 + lit_len + (lit_len / 255) + 1)
+        HGOTO_DONE(0)
+    if(lit_len >= H5Z_LZ4_RUN_MASK) {
+        *op++ = H5Z_LZ4_RUN_MASK << 4;
+        H5Z_LZ4_PUT_LENGTH(op, lit_len - H5Z_LZ4_RUN_MASK)
+    } /* end if */
+    else
+        *op++ = (uint8_t)(lit_len << 4);
+    HDmemcpy(op, anchor, lit_len);
+    op += lit_len;
+
+    ret_value = (size_t)(op - dst);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__lz4_compress() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__lz4_decompress
+ *
+ * Purpose:	Decompresses the block of SRC_SIZE bytes at SRC into
+ *              exactly DST_SIZE bytes at DST.
+ *
+ * Return:	Non-negative on success/Negative on failure, including
+ *              when the block is corrupt or isn't DST_SIZE bytes long
+ *              decompressed
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Z__lz4_decompress(const void *_src, size_t src_size, void *_dst, size_t dst_size)
+{
+    const uint8_t *ip = (const uint8_t *)_src;
+    const uint8_t *iend = ip + src_size;
+    uint8_t *dst = (uint8_t *)_dst;
+    uint8_t *op = dst;
+    uint8_t *oend = dst + dst_size;
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_PACKAGE
+
+    while(ip < iend) {
+        unsigned token = *ip++;
+        size_t lit_len = token >> 4;
+        size_t match_len = token & H5Z_LZ4_RUN_MASK;
+        size_t offset;
+        const uint8_t *match;
+
+        /* Copy the literals */
+        if(lit_len == H5Z_LZ4_RUN_MASK) {
+            unsigned b;
+
+            do {
+                if(ip >= iend)
+                    HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "truncated lz4 block")
+                b = *ip++;
+                lit_len += b;
+            } while(b == 255);
+        } /* end if */
+        if(lit_len > (size_t)(iend - ip) || lit_len > (size_t)(oend - op))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "lz4 literals overrun the block")
+        HDmemcpy(op, ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        /* The last sequence has no match */
+        if(ip == iend)
+            break;
+
+        /* Copy the match */
+        if((size_t)(iend - ip) < 2)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "truncated lz4 block")
+        offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > (size_t)(op - dst))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "bad lz4 match offset")
+        if(match_len == H5Z_LZ4_RUN_MASK) {
+            unsigned b;
+
+            do {
+                if(ip >= iend)
+                    HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "truncated lz4 block")
+                b = *ip++;
+                match_len += b;
+            } while(b == 255);
+        } /* end if */
+        match_len += H5Z_LZ4_MINMATCH;
+        if(match_len > (size_t)(oend - op))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "lz4 match overruns the block")
+
+        match = op - offset;
+        if(offset >= match_len)
+            HDmemcpy(op, match, match_len);
+        else if(offset >= 8) {
+            size_t u;
+
+            /* Overlapping, but each 8 bytes are written before they're read */
+            for(u = 0; u + 8 <= match_len; u += 8)
+                HDmemcpy(op + u, match + u, (size_t)8);
+            for(; u < match_len; u++)
+                op[u] = match[u];
+        } /* end if */
+        else {
+            size_t u;
+
+            /* A short repeating pattern */
+            for(u = 0; u < match_len; u++)
+                op[u] = match[u];
+        } /* end else */
+        op += match_len;
+    } /* end while */
+
+    if(op != oend)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, FAIL, "lz4 block is the wrong size")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__lz4_decompress() */
+
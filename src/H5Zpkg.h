@@ -21,6 +21,22 @@
 /* Include private header file */
 #include "H5Zprivate.h"          /* Filter functions                */
 
+/* Other private headers needed by this file */
+#include "H5Fprivate.h"         /* File access                          */
+#include "H5TPprivate.h"        /* Thread pools                         */
+
+/**************************/
+/* Package Private Macros */
+/**************************/
+
+/* Filters run on the filter pools' worker threads, and on the threads of
+ * files read without the library lock, so state a filter shares between
+ * chunks needs a lock of its own in either kind of build.
+ */
+#if defined(H5TP_HAVE_THREADS) || defined(H5F_HAVE_CONCURRENT_READS)
+#define H5Z_HAVE_FILTER_LOCKS
+#endif
+
 /********************/
 /* Internal filters */
 /********************/
@@ -37,6 +53,9 @@ H5_DLLVAR H5Z_class2_t H5Z_NBIT[1];
 /* Scale/offset filter */
 H5_DLLVAR H5Z_class2_t H5Z_SCALEOFFSET[1];
 
+/* Bitshuffle filter */
+H5_DLLVAR const H5Z_class2_t H5Z_BITSHUFFLE[1];
+
 /********************/
 /* External filters */
 /********************/
@@ -51,8 +70,35 @@ H5_DLLVAR const H5Z_class2_t H5Z_DEFLATE[1];
 H5_DLLVAR H5Z_class2_t H5Z_SZIP[1];
 #endif /* H5_HAVE_FILTER_SZIP */
 
+/* zstd filter */
+#ifdef H5_HAVE_FILTER_ZSTD
+H5_DLLVAR const H5Z_class2_t H5Z_ZSTD[1];
+#endif /* H5_HAVE_FILTER_ZSTD */
+
 /* Package internal routines */
 H5_DLL herr_t H5Z__unregister(H5Z_filter_t filter_id);
+#ifdef H5_HAVE_FILTER_DEFLATE
+H5_DLL size_t H5Z__filter_deflate_lend(unsigned flags, size_t cd_nelmts,
+    const unsigned cd_values[], size_t nbytes, size_t *buf_size, void **buf,
+    void **lent_buf, size_t lent_size);
+H5_DLL void H5Z__deflate_term(void);
+#endif /* H5_HAVE_FILTER_DEFLATE */
+#ifdef H5_HAVE_FILTER_ZSTD
+H5_DLL void H5Z__zstd_term(void);
+#endif /* H5_HAVE_FILTER_ZSTD */
+
+/* Filter buffer pool */
+H5_DLL void H5Z__buf_forget(const void *buf);
+H5_DLL void H5Z__buf_get_stats(size_t *cur_size, size_t *max_size,
+    hsize_t *nreused, hsize_t *nallocated);
+H5_DLL void H5Z__buf_term(void);
+
+/* LZ4 block codec */
+H5_DLL size_t H5Z__lz4_compress_bound(size_t nbytes);
+H5_DLL size_t H5Z__lz4_compress(const void *src, size_t src_size, void *dst,
+    size_t dst_size);
+H5_DLL herr_t H5Z__lz4_decompress(const void *src, size_t src_size, void *dst,
+    size_t dst_size);
 
 #endif /* _H5Zpkg_H */
 
@@ -0,0 +1,682 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The pool of buffers which the library's filters and the
+ *              chunk cache borrow chunk buffers from and return them to,
+ *              so that a chunk going through the filter pipeline doesn't
+ *              cost a malloc() and free() (and for large chunks, mapping
+ *              and faulting in fresh pages) for every buffer it passes
+ *              through.
+ *
+ *              Buffers are rounded up to a size class (four classes to
+ *              each doubling of the size) and aligned for vector loads,
+ *              or to a page once they're a page or more.  They're plain
+ *              blocks from the C library, which other filters can free()
+ *              or realloc() as usual, so the pool keeps a table of the
+ *              blocks it handed out: H5Z_buf_free() puts those back on
+ *              the free list of their class, and frees any other block
+ *              like H5MM_xfree().  H5Z_pipeline() has the pool forget a
+ *              block before lending it to a filter which isn't one of the
+ *              library's own.
+ *
+ *              The memory held on the free lists is bounded by a limit
+ *              which can be set with H5Zset_buffer_pool_limit(): blocks
+ *              returned beyond it are freed instead.  The pool is shared
+ *              by the whole library, since filters run on threads which
+ *              don't hold the library lock and don't know which file
+ *              their chunk belongs to, so it has a lock of its own.
+ */
+
+#include "H5Zmodule.h"          /* This source code file is part of the H5Z module */
+
+
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5MMprivate.h"	/* Memory management			*/
+#include "H5Zpkg.h"		/* Data filters				*/
+
+/* Smallest and largest buffers kept in the pool (others are just malloc'd) */
+#define H5Z_BUF_MIN_SIZE        ((size_t)1024)
+#define H5Z_BUF_MAX_SIZE        ((size_t)1 << 30)
+
+/* Size classes to each doubling of the size, and in all (1 KiB to 1 GiB) */
+#define H5Z_BUF_CLASS_STEPS     4
+#define H5Z_BUF_NCLASSES        (1 + (20 * H5Z_BUF_CLASS_STEPS))
+
+/* Alignment of buffers smaller than a page, and of the others */
+#define H5Z_BUF_ALIGN           ((size_t)64)
+#define H5Z_BUF_PAGE_SIZE       ((size_t)4096)
+
+/* Default limit on the memory held on the free lists */
+#define H5Z_BUF_DEF_LIMIT       ((size_t)32 * 1024 * 1024)
+
+/* Initial # of slots in the table of blocks handed out */
+#define H5Z_BUF_TABLE_INIT      64
+
+/* Hash a block's address into the table, which has a power of 2 slots */
+#define H5Z_BUF_HASH(B, M)      (((size_t)((uintptr_t)(B) >> 6) ^ (size_t)((uintptr_t)(B) >> 12) \
+                                        ^ (size_t)((uintptr_t)(B) >> 22)) & (M))
+
+/* A block handed out, in the table of them */
+typedef struct H5Z_buf_slot_t {
+    void *buf;                  /* The block (NULL for an empty slot) */
+    unsigned cls;               /* Its size class */
+} H5Z_buf_slot_t;
+
+/* Local function prototypes */
+static unsigned H5Z__buf_class(size_t size);
+static size_t H5Z__buf_class_size(unsigned cls);
+static size_t H5Z__buf_find(const void *buf);
+static herr_t H5Z__buf_track(void *buf, unsigned cls);
+static void H5Z__buf_untrack(size_t slot);
+static void H5Z__buf_trim(size_t limit);
+
+/* Free list of each size class, linked through the blocks' first bytes */
+static void *H5Z_buf_free_g[H5Z_BUF_NCLASSES];
+
+/* Memory on the free lists, its high-water mark and limit */
+static size_t H5Z_buf_free_size_g = 0;
+static size_t H5Z_buf_free_hwm_g = 0;
+static size_t H5Z_buf_limit_g = H5Z_BUF_DEF_LIMIT;
+
+/* # of buffers taken from the free lists, and allocated instead */
+static hsize_t H5Z_buf_nreused_g = 0;
+static hsize_t H5Z_buf_nallocated_g = 0;
+
+/* Table of the blocks handed out, with open addressing */
+static H5Z_buf_slot_t *H5Z_buf_table_g = NULL;
+static size_t H5Z_buf_table_size_g = 0;
+static size_t H5Z_buf_table_used_g = 0;
+
+/* Filters borrow and return buffers on threads which don't hold the
+ * library lock, so the pool has a lock of its own.
+ */
+#ifdef H5Z_HAVE_FILTER_LOCKS
+static pthread_mutex_t H5Z_buf_lock_g = PTHREAD_MUTEX_INITIALIZER;
+#define H5Z_BUF_LOCK        (void)pthread_mutex_lock(&H5Z_buf_lock_g);
+#define H5Z_BUF_UNLOCK      (void)pthread_mutex_unlock(&H5Z_buf_lock_g);
+#else
+#define H5Z_BUF_LOCK
+#define H5Z_BUF_UNLOCK
+#endif /* H5Z_HAVE_FILTER_LOCKS */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_class
+ *
+ * Purpose:	Find the smallest size class which holds SIZE bytes, which
+ *              must be no more than H5Z_BUF_MAX_SIZE.
+ *
+ * Return:	The size class (never fails)
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+H5Z__buf_class(size_t size)
+{
+    size_t base = H5Z_BUF_MIN_SIZE;     /* Size of the class ending the last doubling */
+    size_t step;                        /* Difference between classes in this doubling */
+    unsigned cls = 0;                   /* Size class */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(size <= H5Z_BUF_MAX_SIZE);
+
+    if(size > base) {
+        /* Find the doubling the size is in */
+        while(2 * base < size) {
+            base *= 2;
+            cls += H5Z_BUF_CLASS_STEPS;
+        } /* end while */
+
+        /* Find the class in it */
+        step = base / H5Z_BUF_CLASS_STEPS;
+        cls += (unsigned)((size - base + step - 1) / step);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(cls)
+} /* end H5Z__buf_class() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_class_size
+ *
+ * Purpose:	Find the size of the buffers in size class CLS.
+ *
+ * Return:	The size (never fails)
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__buf_class_size(unsigned cls)
+{
+    size_t base;                        /* Size of the class ending the last doubling */
+    size_t ret_value = H5Z_BUF_MIN_SIZE;        /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(cls < H5Z_BUF_NCLASSES);
+
+    if(cls > 0) {
+        base = H5Z_BUF_MIN_SIZE << ((cls - 1) / H5Z_BUF_CLASS_STEPS);
+        ret_value = base + (base / H5Z_BUF_CLASS_STEPS) * (((cls - 1) % H5Z_BUF_CLASS_STEPS) + 1);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__buf_class_size() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_find
+ *
+ * Purpose:	Find the block BUF in the table of blocks handed out.  The
+ *              caller holds the pool's lock.
+ *
+ * Return:	The block's slot in the table, or the size of the table if
+ *              the pool didn't hand it out (never fails)
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__buf_find(const void *buf)
+{
+    size_t mask;                        /* Mask for slots in the table */
+    size_t ret_value;                   /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(buf);
+
+    ret_value = H5Z_buf_table_size_g;
+    if(H5Z_buf_table_used_g > 0) {
+        mask = H5Z_buf_table_size_g - 1;
+        for(ret_value = H5Z_BUF_HASH(buf, mask); H5Z_buf_table_g[ret_value].buf; ret_value = (ret_value + 1) & mask)
+            if(H5Z_buf_table_g[ret_value].buf == buf)
+                break;
+        if(NULL == H5Z_buf_table_g[ret_value].buf)
+            ret_value = H5Z_buf_table_size_g;
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__buf_find() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_track
+ *
+ * Purpose:	Add the block BUF of size class CLS to the table of blocks
+ *              handed out, doubling the table when it's half full.  The
+ *              caller holds the pool's lock.
+ *
+ * Return:	Non-negative on success/Negative on failure, when the block
+ *              is just left out of the pool
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5Z__buf_track(void *buf, unsigned cls)
+{
+    size_t mask;                        /* Mask for slots in the table */
+    size_t u, v;                        /* Local index variables */
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(buf);
+
+    /* Create or grow the table */
+    if(2 * (H5Z_buf_table_used_g + 1) > H5Z_buf_table_size_g) {
+        H5Z_buf_slot_t *new_table;      /* New array of slots */
+        size_t new_size = H5Z_buf_table_size_g ? 2 * H5Z_buf_table_size_g : H5Z_BUF_TABLE_INIT;
+
+        if(NULL == (new_table = (H5Z_buf_slot_t *)H5MM_calloc(new_size * sizeof(H5Z_buf_slot_t))))
+            HGOTO_DONE(FAIL)
+
+        /* Re-hash the blocks into the new table */
+        mask = new_size - 1;
+        for(u = 0; u < H5Z_buf_table_size_g; u++)
+            if(H5Z_buf_table_g[u].buf) {
+                for(v = H5Z_BUF_HASH(H5Z_buf_table_g[u].buf, mask); new_table[v].buf; v = (v + 1) & mask)
+                    ;
+                new_table[v] = H5Z_buf_table_g[u];
+            } /* end if */
+
+        H5MM_xfree(H5Z_buf_table_g);
+        H5Z_buf_table_g = new_table;
+        H5Z_buf_table_size_g = new_size;
+    } /* end if */
+
+    /* Add the block */
+    mask = H5Z_buf_table_size_g - 1;
+    for(u = H5Z_BUF_HASH(buf, mask); H5Z_buf_table_g[u].buf; u = (u + 1) & mask)
+        HDassert(H5Z_buf_table_g[u].buf != buf);
+    H5Z_buf_table_g[u].buf = buf;
+    H5Z_buf_table_g[u].cls = cls;
+    H5Z_buf_table_used_g++;
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z__buf_track() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_untrack
+ *
+ * Purpose:	Remove the block in slot SLOT from the table of blocks
+ *              handed out, moving back the blocks after it which would
+ *              otherwise no longer be found.  The caller holds the pool's
+ *              lock.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__buf_untrack(size_t slot)
+{
+    size_t mask = H5Z_buf_table_size_g - 1;     /* Mask for slots in the table */
+    size_t u, home;                     /* Local index variables */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    HDassert(slot < H5Z_buf_table_size_g);
+    HDassert(H5Z_buf_table_g[slot].buf);
+
+    for(u = (slot + 1) & mask; H5Z_buf_table_g[u].buf; u = (u + 1) & mask) {
+        home = H5Z_BUF_HASH(H5Z_buf_table_g[u].buf, mask);
+
+        /* Move the block back into the hole, unless it hashes after the hole */
+        if(slot <= u ? (home <= slot || home > u) : (home <= slot && home > u)) {
+            H5Z_buf_table_g[slot] = H5Z_buf_table_g[u];
+            slot = u;
+        } /* end if */
+    } /* end for */
+    H5Z_buf_table_g[slot].buf = NULL;
+    H5Z_buf_table_used_g--;
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__buf_untrack() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_trim
+ *
+ * Purpose:	Free blocks from the free lists, largest first, until they
+ *              hold no more than LIMIT bytes.  The caller holds the pool's
+ *              lock.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__buf_trim(size_t limit)
+{
+    void *buf;                          /* Block to free */
+    unsigned cls;                       /* Size class of the blocks */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(cls = H5Z_BUF_NCLASSES; cls > 0 && H5Z_buf_free_size_g > limit; cls--)
+        while(H5Z_buf_free_g[cls - 1] && H5Z_buf_free_size_g > limit) {
+            buf = H5Z_buf_free_g[cls - 1];
+            H5Z_buf_free_g[cls - 1] = *(void **)buf;
+            H5Z_buf_free_size_g -= H5Z__buf_class_size(cls - 1);
+
+            /* Free with HDfree since it came from HDposix_memalign */
+            HDfree(buf);
+        } /* end while */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__buf_trim() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_buf_malloc
+ *
+ * Purpose:	Allocate a buffer of at least SIZE bytes for data going
+ *              through the filter pipeline, from the pool if it's big
+ *              enough to be worth keeping there.
+ *
+ * Return:	Success:	Pointer to the buffer, to be freed with
+ *                              H5Z_buf_free()
+ *		Failure:	NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+void *
+H5Z_buf_malloc(size_t size)
+{
+    void *ret_value = NULL;             /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+#ifndef H5_MEMORY_ALLOC_SANITY_CHECK
+    if(size >= H5Z_BUF_MIN_SIZE && size <= H5Z_BUF_MAX_SIZE) {
+        unsigned cls = H5Z__buf_class(size);            /* Size class of the buffer */
+        size_t cls_size = H5Z__buf_class_size(cls);     /* Size of buffers in the class */
+
+        /* Take a block from the class's free list */
+        H5Z_BUF_LOCK
+        if(NULL != (ret_value = H5Z_buf_free_g[cls])) {
+            H5Z_buf_free_g[cls] = *(void **)ret_value;
+            H5Z_buf_free_size_g -= cls_size;
+            H5Z_buf_nreused_g++;
+
+            /* If there's no room to remember the block is the pool's,
+             * it's simply freed in the end */
+            (void)H5Z__buf_track(ret_value, cls);
+        } /* end if */
+        H5Z_BUF_UNLOCK
+
+        /* ... or allocate one */
+        if(NULL == ret_value) {
+#ifdef H5_HAVE_WIN32_API
+            ret_value = HDmalloc(cls_size);
+#else /* H5_HAVE_WIN32_API */
+            if(HDposix_memalign(&ret_value, (cls_size >= H5Z_BUF_PAGE_SIZE ? H5Z_BUF_PAGE_SIZE : H5Z_BUF_ALIGN), cls_size) != 0)
+                ret_value = NULL;
+#endif /* H5_HAVE_WIN32_API */
+            if(NULL == ret_value)
+                HGOTO_DONE(NULL)
+
+            H5Z_BUF_LOCK
+            H5Z_buf_nallocated_g++;
+            (void)H5Z__buf_track(ret_value, cls);
+            H5Z_BUF_UNLOCK
+        } /* end if */
+    } /* end if */
+    else
+#endif /* H5_MEMORY_ALLOC_SANITY_CHECK */
+        ret_value = H5MM_malloc(size);
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_buf_malloc() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_buf_realloc
+ *
+ * Purpose:	Change the size of the buffer BUF, which may be from the
+ *              pool or not, like H5MM_realloc().  A buffer from the pool
+ *              whose size class holds SIZE bytes is returned as is.
+ *
+ * Return:	Success:	Pointer to the buffer, to be freed with
+ *                              H5Z_buf_free()
+ *		Failure:	NULL, and BUF is still valid
+ *
+ *-------------------------------------------------------------------------
+ */
+void *
+H5Z_buf_realloc(void *buf, size_t size)
+{
+    size_t slot;                        /* Slot of the buffer in the table */
+    size_t cls_size = 0;                /* Size of the buffer, if from the pool */
+    void *ret_value = NULL;             /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(NULL == buf)
+        ret_value = H5Z_buf_malloc(size);
+    else if(0 == size)
+        ret_value = H5Z_buf_free(buf);
+    else {
+        H5Z_BUF_LOCK
+        if((slot = H5Z__buf_find(buf)) < H5Z_buf_table_size_g)
+            cls_size = H5Z__buf_class_size(H5Z_buf_table_g[slot].cls);
+        H5Z_BUF_UNLOCK
+
+        if(0 == cls_size)
+            ret_value = H5MM_realloc(buf, size);
+        else if(size <= cls_size)
+            ret_value = buf;
+        else if(NULL != (ret_value = H5Z_buf_malloc(size))) {
+            HDmemcpy(ret_value, buf, cls_size);
+            H5Z_buf_free(buf);
+        } /* end if */
+    } /* end else */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_buf_realloc() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_buf_free
+ *
+ * Purpose:	Free the buffer BUF: return it to the pool if it came from
+ *              there and the pool's free lists have room for it, or else
+ *              release it like H5MM_xfree().  BUF may be NULL.
+ *
+ * Return:	NULL (never fails)
+ *
+ *-------------------------------------------------------------------------
+ */
+void *
+H5Z_buf_free(void *buf)
+{
+    size_t slot;                        /* Slot of the buffer in the table */
+    hbool_t pooled = FALSE;             /* Whether the buffer is from the pool */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    if(buf) {
+        H5Z_BUF_LOCK
+        if((slot = H5Z__buf_find(buf)) < H5Z_buf_table_size_g) {
+            unsigned cls = H5Z_buf_table_g[slot].cls;   /* Size class of the buffer */
+            size_t cls_size = H5Z__buf_class_size(cls); /* Size of buffers in the class */
+
+            pooled = TRUE;
+            H5Z__buf_untrack(slot);
+
+            /* Put the block on its class's free list, if it's not too full */
+            if(H5Z_buf_free_size_g + cls_size <= H5Z_buf_limit_g) {
+                *(void **)buf = H5Z_buf_free_g[cls];
+                H5Z_buf_free_g[cls] = buf;
+                H5Z_buf_free_size_g += cls_size;
+                if(H5Z_buf_free_size_g > H5Z_buf_free_hwm_g)
+                    H5Z_buf_free_hwm_g = H5Z_buf_free_size_g;
+                buf = NULL;
+            } /* end if */
+        } /* end if */
+        H5Z_BUF_UNLOCK
+
+        if(buf) {
+            /* Free with HDfree if it came from HDposix_memalign */
+            if(pooled)
+                HDfree(buf);
+            else
+                H5MM_xfree(buf);
+        } /* end if */
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(NULL)
+} /* end H5Z_buf_free() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_forget
+ *
+ * Purpose:	Make the pool forget that the buffer BUF came from it, if
+ *              it did, before BUF goes where it may be freed or resized
+ *              behind the pool's back: it's just an ordinary block of
+ *              memory from then on.  BUF may be NULL.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5Z__buf_forget(const void *buf)
+{
+    size_t slot;                        /* Slot of the buffer in the table */
+
+    FUNC_ENTER_PACKAGE_NOERR
+
+    if(buf) {
+        H5Z_BUF_LOCK
+        if((slot = H5Z__buf_find(buf)) < H5Z_buf_table_size_g)
+            H5Z__buf_untrack(slot);
+        H5Z_BUF_UNLOCK
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__buf_forget() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_buf_garbage_coll
+ *
+ * Purpose:	Free all the buffers on the pool's free lists.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Z_buf_garbage_coll(void)
+{
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    H5Z_BUF_LOCK
+    H5Z__buf_trim((size_t)0);
+    H5Z_BUF_UNLOCK
+
+    FUNC_LEAVE_NOAPI(SUCCEED)
+} /* end H5Z_buf_garbage_coll() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_get_stats
+ *
+ * Purpose:	Retrieve the pool's statistics: the memory on its free
+ *              lists now and at most, and the number of buffers taken
+ *              from them and allocated instead.  Any of the pointers may
+ *              be NULL.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5Z__buf_get_stats(size_t *cur_size, size_t *max_size, hsize_t *nreused,
+    hsize_t *nallocated)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    H5Z_BUF_LOCK
+    if(cur_size)
+        *cur_size = H5Z_buf_free_size_g;
+    if(max_size)
+        *max_size = H5Z_buf_free_hwm_g;
+    if(nreused)
+        *nreused = H5Z_buf_nreused_g;
+    if(nallocated)
+        *nallocated = H5Z_buf_nallocated_g;
+    H5Z_BUF_UNLOCK
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__buf_get_stats() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__buf_term
+ *
+ * Purpose:	Free the buffers on the pool's free lists and its table of
+ *              buffers handed out, when the library closes.  Buffers still
+ *              out are freed like any other when they're returned.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5Z__buf_term(void)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    H5Z_BUF_LOCK
+    H5Z__buf_trim((size_t)0);
+    H5Z_buf_table_g = (H5Z_buf_slot_t *)H5MM_xfree(H5Z_buf_table_g);
+    H5Z_buf_table_size_g = H5Z_buf_table_used_g = 0;
+    H5Z_BUF_UNLOCK
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__buf_term() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Zset_buffer_pool_limit
+ *
+ * Purpose:	Sets the most memory the pool of buffers which filters and
+ *              the chunk cache share holds on to for reuse, freeing the
+ *              buffers beyond it.  A limit of 0 turns off reuse.  The
+ *              default limit is 32 MB.
+ *
+ * Return:	Success:	non-negative
+ *		Failure:	negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Zset_buffer_pool_limit(size_t limit)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE1("e", "z", limit);
+
+    H5Z_BUF_LOCK
+    H5Z_buf_limit_g = limit;
+    H5Z__buf_trim(limit);
+    H5Z_BUF_UNLOCK
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Zset_buffer_pool_limit() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Zget_buffer_pool_stats
+ *
+ * Purpose:	Gets the statistics of the pool of buffers which filters
+ *              and the chunk cache share.  The pool is global for the
+ *              entire library, and its statistics cover the life of the
+ *              library.
+ *
+ * Parameters:
+ *  size_t *cur_size;    OUT: The memory the pool holds for reuse
+ *  size_t *max_size;    OUT: The high-water mark of CUR_SIZE, which is never
+ *                            more than the limit set with H5Zset_buffer_pool_limit
+ *  hsize_t *nreused;    OUT: The number of buffers reused from the pool
+ *  hsize_t *nallocated; OUT: The number of buffers the pool had to allocate
+ *
+ * Return:	Success:	non-negative
+ *		Failure:	negative
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Zget_buffer_pool_stats(size_t *cur_size, size_t *max_size, hsize_t *nreused,
+    hsize_t *nallocated)
+{
+    herr_t ret_value = SUCCEED;         /* Return value */
+
+    FUNC_ENTER_API(FAIL)
+    H5TRACE4("e", "*z*z*h*h", cur_size, max_size, nreused, nallocated);
+
+    H5Z__buf_get_stats(cur_size, max_size, nreused, nallocated);
+
+done:
+    FUNC_LEAVE_API(ret_value)
+} /* end H5Zget_buffer_pool_stats() */
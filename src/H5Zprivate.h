@@ -39,6 +39,9 @@ typedef struct H5Z_filter_info_t H5Z_filter_info_t;
 #define H5_SZIP_MSB_OPTION_MASK         16
 #define H5_SZIP_RAW_OPTION_MASK         128
 
+/* Blocks of the bitshuffle filter are a multiple of this many elements */
+#define H5Z_BITSHUFFLE_BLOCK_MULT       8
+
 /* Common # of 'client data values' for filters */
 /* (avoids dynamic memory allocation in most cases) */
 #define H5Z_COMMON_CD_VALUES    4
@@ -84,6 +87,10 @@ H5_DLL herr_t H5Z_pipeline(const struct H5O_pline_t *pline,
  			    H5Z_EDC_t edc_read, H5Z_cb_t cb_struct,
 			    size_t *nbytes/*in,out*/, size_t *buf_size/*in,out*/,
                             void **buf/*in,out*/);
+H5_DLL herr_t H5Z_pipeline_lend(const struct H5O_pline_t *pline,
+    unsigned flags, unsigned *filter_mask/*in,out*/, H5Z_EDC_t edc_read,
+    H5Z_cb_t cb_struct, size_t *nbytes/*in,out*/, size_t *buf_size/*in,out*/,
+    void **buf/*in,out*/, void **lent_buf/*in,out*/, size_t lent_size);
 H5_DLL H5Z_class2_t *H5Z_find(H5Z_filter_t id);
 H5_DLL herr_t H5Z_can_apply(hid_t dcpl_id, hid_t type_id);
 H5_DLL herr_t H5Z_set_local(hid_t dcpl_id, hid_t type_id);
@@ -94,8 +101,19 @@ H5_DLL H5Z_filter_info_t *H5Z_filter_info(const struct H5O_pline_t *pline,
 H5_DLL htri_t H5Z_filter_in_pline(const struct H5O_pline_t *pline, H5Z_filter_t filter);
 H5_DLL htri_t H5Z_all_filters_avail(const struct H5O_pline_t *pline);
 H5_DLL htri_t H5Z_filter_avail(H5Z_filter_t id);
+H5_DLL hbool_t H5Z_filter_unlocked(H5Z_filter_t id);
 H5_DLL herr_t H5Z_delete(struct H5O_pline_t *pline, H5Z_filter_t filter);
 H5_DLL herr_t H5Z_get_filter_info(H5Z_filter_t filter, unsigned int *filter_config_flags);
+#ifdef H5_HAVE_FILTER_ZSTD
+H5_DLL hbool_t H5Z_zstd_dict_loaded(unsigned key);
+H5_DLL herr_t H5Z_zstd_dict_load(const void *buf, size_t size, unsigned *key);
+#endif /* H5_HAVE_FILTER_ZSTD */
+
+/* Filter buffer pool */
+H5_DLL void *H5Z_buf_malloc(size_t size);
+H5_DLL void *H5Z_buf_realloc(void *buf, size_t size);
+H5_DLL void *H5Z_buf_free(void *buf);
+H5_DLL herr_t H5Z_buf_garbage_coll(void);
 
 /* Data Transform Functions */
 typedef struct H5Z_data_xform_t H5Z_data_xform_t; /* Defined in H5Ztrans.c */
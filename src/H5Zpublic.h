@@ -39,6 +39,8 @@ typedef int H5Z_filter_t;
 #define H5Z_FILTER_SZIP         4       /*szip compression              */
 #define H5Z_FILTER_NBIT         5       /*nbit compression              */
 #define H5Z_FILTER_SCALEOFFSET  6       /*scale+offset compression      */
+#define H5Z_FILTER_BITSHUFFLE   7       /*bitshuffle, with lz4 compression */
+#define H5Z_FILTER_ZSTD         8       /*zstandard compression         */
 #define H5Z_FILTER_RESERVED     256	/*filter ids below this value are reserved for library use */
 
 #define H5Z_FILTER_MAX		65535	/*maximum filter id		*/
@@ -85,6 +87,26 @@ typedef int H5Z_filter_t;
 #define H5Z_SZIP_PARM_BPP       2       /* "Local" parameter for bits-per-pixel */
 #define H5Z_SZIP_PARM_PPS       3       /* "Local" parameter for pixels-per-scanline */
 
+/* Macros for the bitshuffle filter */
+#define H5Z_BITSHUFFLE_USER_NPARMS      2       /* Number of parameters that users can set */
+#define H5Z_BITSHUFFLE_TOTAL_NPARMS     5       /* Total number of parameters for filter */
+#define H5Z_BITSHUFFLE_PARM_VERS_MAJOR  0       /* "Local" parameter for the layout's major version */
+#define H5Z_BITSHUFFLE_PARM_VERS_MINOR  1       /* "Local" parameter for the layout's minor version */
+#define H5Z_BITSHUFFLE_PARM_SIZE        2       /* "Local" parameter for the datatype's size */
+#define H5Z_BITSHUFFLE_PARM_BLOCK       3       /* "User" parameter for elements per block */
+#define H5Z_BITSHUFFLE_PARM_COMP        4       /* "User" parameter for compression */
+#define H5Z_BITSHUFFLE_COMP_NONE        0       /* Bitshuffle only */
+#define H5Z_BITSHUFFLE_COMP_LZ4         2       /* Bitshuffle and compress with LZ4 */
+
+/* Macros for the zstd filter */
+#define H5Z_ZSTD_USER_NPARMS    3       /* Number of parameters that users can set, with a dictionary */
+#define H5Z_ZSTD_TOTAL_NPARMS   4       /* Total number of parameters for filter, with a dictionary */
+#define H5Z_ZSTD_PARM_LEVEL     0       /* "User" parameter for compression level */
+#define H5Z_ZSTD_PARM_DICT_LO   1       /* "User" parameter for low 32 bits of dictionary's object reference */
+#define H5Z_ZSTD_PARM_DICT_HI   2       /* "User" parameter for high 32 bits of dictionary's object reference */
+#define H5Z_ZSTD_PARM_DICT_KEY  3       /* "Local" parameter for the dictionary's checksum */
+#define H5Z_ZSTD_MAX_LEVEL      22      /* Highest compression level */
+
 /* Macros for the nbit filter */
 #define H5Z_NBIT_USER_NPARMS     0     /* Number of parameters that users can set */
 
@@ -220,6 +242,9 @@ H5_DLL herr_t H5Zregister(const void *cls);
 H5_DLL herr_t H5Zunregister(H5Z_filter_t id);
 H5_DLL htri_t H5Zfilter_avail(H5Z_filter_t id);
 H5_DLL herr_t H5Zget_filter_info(H5Z_filter_t filter, unsigned int *filter_config_flags);
+H5_DLL herr_t H5Zset_buffer_pool_limit(size_t limit);
+H5_DLL herr_t H5Zget_buffer_pool_stats(size_t *cur_size, size_t *max_size,
+    hsize_t *nreused, hsize_t *nallocated);
 
 /* Symbols defined for compatibility with previous versions of the HDF5 API.
  *
@@ -22,10 +22,39 @@
 #include "H5Tprivate.h"		/* Datatypes         			*/
 #include "H5Zpkg.h"		/* Data filters				*/
 
+/* SIMD kernels: SSE2 wherever the compiler targets it, and AVX2 where the
+ * compiler can build single functions for it, picked at run time */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define H5Z_SHUFFLE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+        && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define H5Z_SHUFFLE_AVX2
+#include <immintrin.h>
+#define H5Z_SHUFFLE_AVX2_ATTR   __attribute__((target("avx2")))
+#endif
+#endif
+
 /* Local function prototypes */
 static herr_t H5Z_set_local_shuffle(hid_t dcpl_id, hid_t type_id, hid_t space_id);
 static size_t H5Z_filter_shuffle(unsigned flags, size_t cd_nelmts,
     const unsigned cd_values[], size_t nbytes, size_t *buf_size, void **buf);
+static void H5Z__shuffle_generic(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements, size_t start);
+static void H5Z__unshuffle_generic(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements, size_t start);
+#ifdef H5Z_SHUFFLE_SSE2
+static size_t H5Z__shuffle_sse2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements);
+static size_t H5Z__unshuffle_sse2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements);
+#endif /* H5Z_SHUFFLE_SSE2 */
+#ifdef H5Z_SHUFFLE_AVX2
+static size_t H5Z__shuffle_avx2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements) H5Z_SHUFFLE_AVX2_ATTR;
+static size_t H5Z__unshuffle_avx2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements) H5Z_SHUFFLE_AVX2_ATTR;
+#endif /* H5Z_SHUFFLE_AVX2 */
 
 /* This message derives from H5Z */
 const H5Z_class2_t H5Z_SHUFFLE[1] = {{
@@ -42,6 +71,9 @@ const H5Z_class2_t H5Z_SHUFFLE[1] = {{
 /* Local macros */
 #define H5Z_SHUFFLE_PARM_SIZE      0       /* "Local" parameter for shuffling size */
 
+/* Largest element size with a SIMD kernel (the kernels handle powers of 2) */
+#define H5Z_SHUFFLE_SIMD_MAX       16
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5Z_set_local_shuffle
@@ -95,6 +127,466 @@ done:
     FUNC_LEAVE_NOAPI(ret_value)
 } /* end H5Z_set_local_shuffle() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__shuffle_generic
+ *
+ * Purpose:	Shuffles the elements from START on in a buffer of
+ *              NUMOFELEMENTS elements of BYTESOFTYPE bytes, one byte at a
+ *              time.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__shuffle_generic(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements, size_t start)
+{
+    const unsigned char *_src;  /* Alias for source buffer */
+    unsigned char *_dest;       /* Alias for destination buffer */
+    size_t count = numofelements - start;   /* Number of elements to shuffle */
+    size_t i;                   /* Local index variables */
+#ifdef NO_DUFFS_DEVICE
+    size_t j;                   /* Local index variable */
+#endif /* NO_DUFFS_DEVICE */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(count > 0)
+        for(i=0; i<bytesoftype; i++) {
+            _src=src+(start*bytesoftype)+i;
+            _dest=dest+(i*numofelements)+start;
+#define DUFF_GUTS							    \
+    *_dest++=*_src;                             \
+    _src+=bytesoftype;
+#ifdef NO_DUFFS_DEVICE
+            j = count;
+            while(j > 0) {
+                DUFF_GUTS;
+
+                j--;
+            } /* end for */
+#else /* NO_DUFFS_DEVICE */
+        {
+            size_t duffs_index; /* Counting index for Duff's device */
+
+            duffs_index = (count + 7) / 8;
+            switch (count % 8) {
+                default:
+                    HDassert(0 && "This Should never be executed!");
+                    break;
+                case 0:
+                    do
+                      {
+                        DUFF_GUTS
+                case 7:
+                        DUFF_GUTS
+                case 6:
+                        DUFF_GUTS
+                case 5:
+                        DUFF_GUTS
+                case 4:
+                        DUFF_GUTS
+                case 3:
+                        DUFF_GUTS
+                case 2:
+                        DUFF_GUTS
+                case 1:
+                        DUFF_GUTS
+                  } while (--duffs_index > 0);
+            } /* end switch */
+        }
+#endif /* NO_DUFFS_DEVICE */
+#undef DUFF_GUTS
+        } /* end for */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__shuffle_generic() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__unshuffle_generic
+ *
+ * Purpose:	Unshuffles the elements from START on in a buffer of
+ *              NUMOFELEMENTS elements of BYTESOFTYPE bytes, one byte at a
+ *              time.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__unshuffle_generic(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements, size_t start)
+{
+    const unsigned char *_src;  /* Alias for source buffer */
+    unsigned char *_dest;       /* Alias for destination buffer */
+    size_t count = numofelements - start;   /* Number of elements to unshuffle */
+    size_t i;                   /* Local index variables */
+#ifdef NO_DUFFS_DEVICE
+    size_t j;                   /* Local index variable */
+#endif /* NO_DUFFS_DEVICE */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    if(count > 0)
+        for(i=0; i<bytesoftype; i++) {
+            _src=src+(i*numofelements)+start;
+            _dest=dest+(start*bytesoftype)+i;
+#define DUFF_GUTS							    \
+    *_dest=*_src++;                             \
+    _dest+=bytesoftype;
+#ifdef NO_DUFFS_DEVICE
+            j = count;
+            while(j > 0) {
+                DUFF_GUTS;
+
+                j--;
+            } /* end for */
+#else /* NO_DUFFS_DEVICE */
+        {
+            size_t duffs_index; /* Counting index for Duff's device */
+
+            duffs_index = (count + 7) / 8;
+            switch (count % 8) {
+                default:
+                    HDassert(0 && "This Should never be executed!");
+                    break;
+                case 0:
+                    do
+                      {
+                        DUFF_GUTS
+                case 7:
+                        DUFF_GUTS
+                case 6:
+                        DUFF_GUTS
+                case 5:
+                        DUFF_GUTS
+                case 4:
+                        DUFF_GUTS
+                case 3:
+                        DUFF_GUTS
+                case 2:
+                        DUFF_GUTS
+                case 1:
+                        DUFF_GUTS
+                  } while (--duffs_index > 0);
+            } /* end switch */
+        }
+#endif /* NO_DUFFS_DEVICE */
+#undef DUFF_GUTS
+        } /* end for */
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__unshuffle_generic() */
+
+/*
+ * The SIMD kernels transpose blocks of 16 (SSE2) or 32 (AVX2) elements,
+ * held in BYTESOFTYPE vectors, with rounds of byte interleaves: vector K
+ * of the first half is interleaved with vector K of the second half, into
+ * vectors 2K and 2K+1.  Taking the offset of each byte in a 16-element
+ * block as a number, each round rotates its bits left by one.  Byte B of
+ * element E is at E * BYTESOFTYPE + B in the elements and at B * 16 + E
+ * when shuffled, so shuffling takes four rounds (the bits of E) and
+ * unshuffling takes log2(BYTESOFTYPE) rounds (the bits of B).
+ *
+ * The AVX2 interleaves work on each 128-bit half of the vectors, so the
+ * AVX2 kernels put a block of 16 elements in each half.
+ */
+#ifdef H5Z_SHUFFLE_SSE2
+
+/* Expands M(K, ...) for K = 0 .. N-1 (N is 1, 2, 4, 8 or 16), so that the
+ * kernels index their vectors with constants and can keep them in registers */
+#define H5Z_SHUFFLE_REPEAT_1(M, K, ...)     M(K, __VA_ARGS__)
+#define H5Z_SHUFFLE_REPEAT_2(M, K, ...)     H5Z_SHUFFLE_REPEAT_1(M, K, __VA_ARGS__) H5Z_SHUFFLE_REPEAT_1(M, (K) + 1, __VA_ARGS__)
+#define H5Z_SHUFFLE_REPEAT_4(M, K, ...)     H5Z_SHUFFLE_REPEAT_2(M, K, __VA_ARGS__) H5Z_SHUFFLE_REPEAT_2(M, (K) + 2, __VA_ARGS__)
+#define H5Z_SHUFFLE_REPEAT_8(M, K, ...)     H5Z_SHUFFLE_REPEAT_4(M, K, __VA_ARGS__) H5Z_SHUFFLE_REPEAT_4(M, (K) + 4, __VA_ARGS__)
+#define H5Z_SHUFFLE_REPEAT_16(M, K, ...)    H5Z_SHUFFLE_REPEAT_8(M, K, __VA_ARGS__) H5Z_SHUFFLE_REPEAT_8(M, (K) + 8, __VA_ARGS__)
+
+/* Finishes a round of interleaves */
+#define H5Z_SHUFFLE_COPY(K, T)          v[K] = t[K];
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__shuffle_sse2
+ *
+ * Purpose:	Shuffles as many whole blocks of 16 elements as there are in
+ *              a buffer, with SSE2 instructions.  BYTESOFTYPE must be 2, 4,
+ *              8 or 16.
+ *
+ * Return:	Number of elements shuffled
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__shuffle_sse2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements)
+{
+    __m128i v[H5Z_SHUFFLE_SIMD_MAX], t[H5Z_SHUFFLE_SIMD_MAX];   /* Vectors in the block */
+    size_t e;                   /* First element in the block */
+    unsigned r;                 /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+#define H5Z_SHUFFLE_LOAD(K, T)                                                \
+    v[K] = _mm_loadu_si128((const __m128i *)(src + (e * (T)) + (16 * (K))));
+#define H5Z_SHUFFLE_ROUND(K, H)                                               \
+    t[2 * (K)] = _mm_unpacklo_epi8(v[K], v[(K) + (H)]);                       \
+    t[(2 * (K)) + 1] = _mm_unpackhi_epi8(v[K], v[(K) + (H)]);
+#define H5Z_SHUFFLE_STORE(K, T)                                               \
+    _mm_storeu_si128((__m128i *)(dest + ((K) * numofelements) + e), v[K]);
+#define H5Z_SHUFFLE_BLOCKS(T, H)                                              \
+    for(e = 0; e + 16 <= numofelements; e += 16) {                            \
+        H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_LOAD, 0, T)                        \
+        for(r = 0; r < 4; r++) {                                              \
+            H5Z_SHUFFLE_REPEAT_##H(H5Z_SHUFFLE_ROUND, 0, H)                   \
+            H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_COPY, 0, T)                    \
+        } /* end for */                                                       \
+        H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_STORE, 0, T)                       \
+    } /* end for */
+
+    switch(bytesoftype) {
+        case 2:
+            H5Z_SHUFFLE_BLOCKS(2, 1)
+            break;
+
+        case 4:
+            H5Z_SHUFFLE_BLOCKS(4, 2)
+            break;
+
+        case 8:
+            H5Z_SHUFFLE_BLOCKS(8, 4)
+            break;
+
+        default:
+            HDassert(16 == bytesoftype);
+            H5Z_SHUFFLE_BLOCKS(16, 8)
+            break;
+    } /* end switch */
+
+#undef H5Z_SHUFFLE_LOAD
+#undef H5Z_SHUFFLE_ROUND
+#undef H5Z_SHUFFLE_STORE
+#undef H5Z_SHUFFLE_BLOCKS
+
+    FUNC_LEAVE_NOAPI(e)
+} /* end H5Z__shuffle_sse2() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__unshuffle_sse2
+ *
+ * Purpose:	Unshuffles as many whole blocks of 16 elements as there are
+ *              in a buffer, with SSE2 instructions.  BYTESOFTYPE must be 2,
+ *              4, 8 or 16.
+ *
+ * Return:	Number of elements unshuffled
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__unshuffle_sse2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements)
+{
+    __m128i v[H5Z_SHUFFLE_SIMD_MAX], t[H5Z_SHUFFLE_SIMD_MAX];   /* Vectors in the block */
+    size_t e;                   /* First element in the block */
+    unsigned r;                 /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+#define H5Z_SHUFFLE_LOAD(K, T)                                                \
+    v[K] = _mm_loadu_si128((const __m128i *)(src + ((K) * numofelements) + e));
+#define H5Z_SHUFFLE_ROUND(K, H)                                               \
+    t[2 * (K)] = _mm_unpacklo_epi8(v[K], v[(K) + (H)]);                       \
+    t[(2 * (K)) + 1] = _mm_unpackhi_epi8(v[K], v[(K) + (H)]);
+#define H5Z_SHUFFLE_STORE(K, T)                                               \
+    _mm_storeu_si128((__m128i *)(dest + (e * (T)) + (16 * (K))), v[K]);
+#define H5Z_SHUFFLE_BLOCKS(T, H)                                              \
+    for(e = 0; e + 16 <= numofelements; e += 16) {                            \
+        H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_LOAD, 0, T)                        \
+        for(r = 1; r < (T); r *= 2) {                                         \
+            H5Z_SHUFFLE_REPEAT_##H(H5Z_SHUFFLE_ROUND, 0, H)                   \
+            H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_COPY, 0, T)                    \
+        } /* end for */                                                       \
+        H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_STORE, 0, T)                       \
+    } /* end for */
+
+    switch(bytesoftype) {
+        case 2:
+            H5Z_SHUFFLE_BLOCKS(2, 1)
+            break;
+
+        case 4:
+            H5Z_SHUFFLE_BLOCKS(4, 2)
+            break;
+
+        case 8:
+            H5Z_SHUFFLE_BLOCKS(8, 4)
+            break;
+
+        default:
+            HDassert(16 == bytesoftype);
+            H5Z_SHUFFLE_BLOCKS(16, 8)
+            break;
+    } /* end switch */
+
+#undef H5Z_SHUFFLE_LOAD
+#undef H5Z_SHUFFLE_ROUND
+#undef H5Z_SHUFFLE_STORE
+#undef H5Z_SHUFFLE_BLOCKS
+
+    FUNC_LEAVE_NOAPI(e)
+} /* end H5Z__unshuffle_sse2() */
+#endif /* H5Z_SHUFFLE_SSE2 */
+
+#ifdef H5Z_SHUFFLE_AVX2
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__shuffle_avx2
+ *
+ * Purpose:	Shuffles as many whole blocks of 32 elements as there are in
+ *              a buffer, with AVX2 instructions.  BYTESOFTYPE must be 2, 4,
+ *              8 or 16.
+ *
+ * Return:	Number of elements shuffled
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__shuffle_avx2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements)
+{
+    __m256i v[H5Z_SHUFFLE_SIMD_MAX], t[H5Z_SHUFFLE_SIMD_MAX];   /* Vectors in the block */
+    size_t e;                   /* First element in the block */
+    unsigned r;                 /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    /* Elements 0-15 of the block go in the low halves of the vectors, 16-31
+     * in the high halves */
+#define H5Z_SHUFFLE_LOAD(K, T)                                                \
+    {                                                                         \
+        __m256i lo = _mm256_loadu_si256((const __m256i *)(src + (e * (T)) + (32 * (K)))); \
+        __m256i hi = _mm256_loadu_si256((const __m256i *)(src + ((e + 16) * (T)) + (32 * (K)))); \
+                                                                              \
+        v[2 * (K)] = _mm256_permute2x128_si256(lo, hi, 0x20);                 \
+        v[(2 * (K)) + 1] = _mm256_permute2x128_si256(lo, hi, 0x31);           \
+    }
+#define H5Z_SHUFFLE_ROUND(K, H)                                               \
+    t[2 * (K)] = _mm256_unpacklo_epi8(v[K], v[(K) + (H)]);                    \
+    t[(2 * (K)) + 1] = _mm256_unpackhi_epi8(v[K], v[(K) + (H)]);
+#define H5Z_SHUFFLE_STORE(K, T)                                               \
+    _mm256_storeu_si256((__m256i *)(dest + ((K) * numofelements) + e), v[K]);
+#define H5Z_SHUFFLE_BLOCKS(T, H)                                              \
+    for(e = 0; e + 32 <= numofelements; e += 32) {                            \
+        H5Z_SHUFFLE_REPEAT_##H(H5Z_SHUFFLE_LOAD, 0, T)                        \
+        for(r = 0; r < 4; r++) {                                              \
+            H5Z_SHUFFLE_REPEAT_##H(H5Z_SHUFFLE_ROUND, 0, H)                   \
+            H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_COPY, 0, T)                    \
+        } /* end for */                                                       \
+        H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_STORE, 0, T)                       \
+    } /* end for */
+
+    switch(bytesoftype) {
+        case 2:
+            H5Z_SHUFFLE_BLOCKS(2, 1)
+            break;
+
+        case 4:
+            H5Z_SHUFFLE_BLOCKS(4, 2)
+            break;
+
+        case 8:
+            H5Z_SHUFFLE_BLOCKS(8, 4)
+            break;
+
+        default:
+            HDassert(16 == bytesoftype);
+            H5Z_SHUFFLE_BLOCKS(16, 8)
+            break;
+    } /* end switch */
+
+#undef H5Z_SHUFFLE_LOAD
+#undef H5Z_SHUFFLE_ROUND
+#undef H5Z_SHUFFLE_STORE
+#undef H5Z_SHUFFLE_BLOCKS
+
+    FUNC_LEAVE_NOAPI(e)
+} /* end H5Z__shuffle_avx2() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__unshuffle_avx2
+ *
+ * Purpose:	Unshuffles as many whole blocks of 32 elements as there are
+ *              in a buffer, with AVX2 instructions.  BYTESOFTYPE must be 2,
+ *              4, 8 or 16.
+ *
+ * Return:	Number of elements unshuffled
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z__unshuffle_avx2(unsigned char *dest, const unsigned char *src,
+    size_t bytesoftype, size_t numofelements)
+{
+    __m256i v[H5Z_SHUFFLE_SIMD_MAX], t[H5Z_SHUFFLE_SIMD_MAX];   /* Vectors in the block */
+    size_t e;                   /* First element in the block */
+    unsigned r;                 /* Local index variable */
+
+    FUNC_ENTER_STATIC_NOERR
+
+#define H5Z_SHUFFLE_LOAD(K, T)                                                \
+    v[K] = _mm256_loadu_si256((const __m256i *)(src + ((K) * numofelements) + e));
+#define H5Z_SHUFFLE_ROUND(K, H)                                               \
+    t[2 * (K)] = _mm256_unpacklo_epi8(v[K], v[(K) + (H)]);                    \
+    t[(2 * (K)) + 1] = _mm256_unpackhi_epi8(v[K], v[(K) + (H)]);
+    /* The low halves of the vectors hold elements 0-15 of the block, the
+     * high halves 16-31 */
+#define H5Z_SHUFFLE_STORE(K, T)                                               \
+    _mm256_storeu_si256((__m256i *)(dest + (e * (T)) + (32 * (K))),           \
+        _mm256_permute2x128_si256(v[2 * (K)], v[(2 * (K)) + 1], 0x20));       \
+    _mm256_storeu_si256((__m256i *)(dest + ((e + 16) * (T)) + (32 * (K))),    \
+        _mm256_permute2x128_si256(v[2 * (K)], v[(2 * (K)) + 1], 0x31));
+#define H5Z_SHUFFLE_BLOCKS(T, H)                                              \
+    for(e = 0; e + 32 <= numofelements; e += 32) {                            \
+        H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_LOAD, 0, T)                        \
+        for(r = 1; r < (T); r *= 2) {                                         \
+            H5Z_SHUFFLE_REPEAT_##H(H5Z_SHUFFLE_ROUND, 0, H)                   \
+            H5Z_SHUFFLE_REPEAT_##T(H5Z_SHUFFLE_COPY, 0, T)                    \
+        } /* end for */                                                       \
+        H5Z_SHUFFLE_REPEAT_##H(H5Z_SHUFFLE_STORE, 0, T)                       \
+    } /* end for */
+
+    switch(bytesoftype) {
+        case 2:
+            H5Z_SHUFFLE_BLOCKS(2, 1)
+            break;
+
+        case 4:
+            H5Z_SHUFFLE_BLOCKS(4, 2)
+            break;
+
+        case 8:
+            H5Z_SHUFFLE_BLOCKS(8, 4)
+            break;
+
+        default:
+            HDassert(16 == bytesoftype);
+            H5Z_SHUFFLE_BLOCKS(16, 8)
+            break;
+    } /* end switch */
+
+#undef H5Z_SHUFFLE_LOAD
+#undef H5Z_SHUFFLE_ROUND
+#undef H5Z_SHUFFLE_STORE
+#undef H5Z_SHUFFLE_BLOCKS
+
+    FUNC_LEAVE_NOAPI(e)
+} /* end H5Z__unshuffle_avx2() */
+#endif /* H5Z_SHUFFLE_AVX2 */
+
 
 /*-------------------------------------------------------------------------
  * Function:	H5Z_filter_shuffle
@@ -106,6 +598,10 @@ done:
  *              Usually, the bytes in each byte position are more related to
  *              each other and putting them together will increase compression.
  *
+ *              Elements of 2, 4, 8 or 16 bytes are [un]shuffled with SIMD
+ *              instructions, when the CPU has them, up to the last whole
+ *              block of elements the instructions work on.
+ *
  * Return:	Success: Size of buffer filtered
  *		Failure: 0
  *
@@ -123,14 +619,11 @@ H5Z_filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
                    size_t nbytes, size_t *buf_size, void **buf)
 {
     void *dest = NULL;          /* Buffer to deposit [un]shuffled bytes into */
-    unsigned char *_src=NULL;   /* Alias for source buffer */
-    unsigned char *_dest=NULL;  /* Alias for destination buffer */
+    unsigned char *_src;        /* Alias for source buffer */
+    unsigned char *_dest;       /* Alias for destination buffer */
     unsigned bytesoftype;       /* Number of bytes per element */
     size_t numofelements;       /* Number of elements in buffer */
-    size_t i;                   /* Local index variables */
-#ifdef NO_DUFFS_DEVICE
-    size_t j;                   /* Local index variable */
-#endif /* NO_DUFFS_DEVICE */
+    size_t nsimd;               /* Number of elements [un]shuffled with SIMD instructions */
     size_t leftover;            /* Extra bytes at end of buffer */
     size_t ret_value = 0;       /* Return value */
 
@@ -152,128 +645,45 @@ H5Z_filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
         leftover = nbytes%bytesoftype;
 
         /* Allocate the destination buffer */
-        if (NULL==(dest = H5MM_malloc(nbytes)))
+        if (NULL==(dest = H5Z_buf_malloc(nbytes)))
             HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for shuffle buffer")
 
-        if(flags & H5Z_FLAG_REVERSE) {
-            /* Get the pointer to the source buffer */
-            _src =(unsigned char *)(*buf);
-
-            /* Input; unshuffle */
-            for(i=0; i<bytesoftype; i++) {
-                _dest=((unsigned char *)dest)+i;
-#define DUFF_GUTS							    \
-    *_dest=*_src++;                             \
-    _dest+=bytesoftype;
-#ifdef NO_DUFFS_DEVICE
-                j = numofelements;
-                while(j > 0) {
-                    DUFF_GUTS;
-
-                    j--;
-                } /* end for */
-#else /* NO_DUFFS_DEVICE */
-            {
-                size_t duffs_index; /* Counting index for Duff's device */
-
-                duffs_index = (numofelements + 7) / 8;
-                switch (numofelements % 8) {
-                    default:
-                        HDassert(0 && "This Should never be executed!");
-                        break;
-                    case 0:
-                        do
-                          {
-                            DUFF_GUTS
-                    case 7:
-                            DUFF_GUTS
-                    case 6:
-                            DUFF_GUTS
-                    case 5:
-                            DUFF_GUTS
-                    case 4:
-                            DUFF_GUTS
-                    case 3:
-                            DUFF_GUTS
-                    case 2:
-                            DUFF_GUTS
-                    case 1:
-                            DUFF_GUTS
-                      } while (--duffs_index > 0);
-                } /* end switch */
-            }
-#endif /* NO_DUFFS_DEVICE */
-#undef DUFF_GUTS
-            } /* end for */
-
-            /* Add leftover to the end of data */
-            if(leftover>0) {
-                /* Adjust back to end of shuffled bytes */
-                _dest -= (bytesoftype - 1);     /*lint !e794 _dest is initialized */
-                HDmemcpy((void*)_dest, (void*)_src, leftover);
-            }
+        /* Get the pointers to the buffers */
+        _src = (unsigned char *)(*buf);
+        _dest = (unsigned char *)dest;
+
+        /* [Un]shuffle whole blocks of elements with SIMD instructions, if
+         * there are kernels for the element size */
+        nsimd = 0;
+#ifdef H5Z_SHUFFLE_SSE2
+        if(bytesoftype <= H5Z_SHUFFLE_SIMD_MAX && 0 == (bytesoftype & (bytesoftype - 1))) {
+#ifdef H5Z_SHUFFLE_AVX2
+            if(__builtin_cpu_supports("avx2"))
+                nsimd = (flags & H5Z_FLAG_REVERSE) ?
+                    H5Z__unshuffle_avx2(_dest, _src, (size_t)bytesoftype, numofelements) :
+                    H5Z__shuffle_avx2(_dest, _src, (size_t)bytesoftype, numofelements);
+            else
+#endif /* H5Z_SHUFFLE_AVX2 */
+                nsimd = (flags & H5Z_FLAG_REVERSE) ?
+                    H5Z__unshuffle_sse2(_dest, _src, (size_t)bytesoftype, numofelements) :
+                    H5Z__shuffle_sse2(_dest, _src, (size_t)bytesoftype, numofelements);
         } /* end if */
-        else {
-            /* Get the pointer to the destination buffer */
-            _dest =(unsigned char *)dest;
+#endif /* H5Z_SHUFFLE_SSE2 */
 
+        /* [Un]shuffle the rest of the elements a byte at a time */
+        if(flags & H5Z_FLAG_REVERSE)
+            /* Input; unshuffle */
+            H5Z__unshuffle_generic(_dest, _src, (size_t)bytesoftype, numofelements, nsimd);
+        else
             /* Output; shuffle */
-            for(i=0; i<bytesoftype; i++) {
-                _src=((unsigned char *)(*buf))+i;
-#define DUFF_GUTS							    \
-    *_dest++=*_src;                             \
-    _src+=bytesoftype;
-#ifdef NO_DUFFS_DEVICE
-                j = numofelements;
-                while(j > 0) {
-                    DUFF_GUTS;
+            H5Z__shuffle_generic(_dest, _src, (size_t)bytesoftype, numofelements, nsimd);
 
-                    j--;
-                } /* end for */
-#else /* NO_DUFFS_DEVICE */
-            {
-                size_t duffs_index; /* Counting index for Duff's device */
-
-                duffs_index = (numofelements + 7) / 8;
-                switch (numofelements % 8) {
-                    default:
-                        HDassert(0 && "This Should never be executed!");
-                        break;
-                    case 0:
-                        do
-                          {
-                            DUFF_GUTS
-                    case 7:
-                            DUFF_GUTS
-                    case 6:
-                            DUFF_GUTS
-                    case 5:
-                            DUFF_GUTS
-                    case 4:
-                            DUFF_GUTS
-                    case 3:
-                            DUFF_GUTS
-                    case 2:
-                            DUFF_GUTS
-                    case 1:
-                            DUFF_GUTS
-                      } while (--duffs_index > 0);
-                } /* end switch */
-            }
-#endif /* NO_DUFFS_DEVICE */
-#undef DUFF_GUTS
-            } /* end for */
-
-            /* Add leftover to the end of data */
-            if(leftover>0) {
-                /* Adjust back to end of shuffled bytes */
-                _src -= (bytesoftype - 1);      /*lint !e794 _src is initialized */
-                HDmemcpy((void*)_dest, (void*)_src, leftover);
-            }
-        } /* end else */
+        /* Add leftover to the end of data */
+        if(leftover>0)
+            HDmemcpy(_dest + (nbytes - leftover), _src + (nbytes - leftover), leftover);
 
         /* Free the input buffer */
-        H5MM_xfree(*buf);
+        H5Z_buf_free(*buf);
 
         /* Set the buffer information to return */
         *buf = dest;
@@ -286,4 +696,3 @@ H5Z_filter_shuffle(unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
 done:
     FUNC_LEAVE_NOAPI(ret_value)
 }
-
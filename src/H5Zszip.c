@@ -313,7 +313,7 @@ H5Z_filter_szip (unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
         H5_CHECKED_ASSIGN(nalloc, size_t, stored_nalloc, uint32_t);
 
         /* Allocate space for the uncompressed buffer */
-        if(NULL == (outbuf = (unsigned char *)H5MM_malloc(nalloc)))
+        if(NULL == (outbuf = (unsigned char *)H5Z_buf_malloc(nalloc)))
             HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for szip decompression")
 
         /* Decompress the buffer */
@@ -323,7 +323,7 @@ H5Z_filter_szip (unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
         HDassert(size_out==nalloc);
 
         /* Free the input buffer */
-        H5MM_xfree(*buf);
+        H5Z_buf_free(*buf);
 
         /* Set return values */
         *buf = outbuf;
@@ -336,7 +336,7 @@ H5Z_filter_szip (unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
         unsigned char *dst = NULL;    /* Temporary pointer to new output buffer */
 
         /* Allocate space for the compressed buffer & header (assume data won't get bigger) */
-        if(NULL == (dst=outbuf = (unsigned char *)H5MM_malloc(nbytes+4)))
+        if(NULL == (dst=outbuf = (unsigned char *)H5Z_buf_malloc(nbytes+4)))
             HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "unable to allocate szip destination buffer")
 
         /* Encode the uncompressed length */
@@ -350,7 +350,7 @@ H5Z_filter_szip (unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
         HDassert(size_out<=nbytes);
 
         /* Free the input buffer */
-        H5MM_xfree(*buf);
+        H5Z_buf_free(*buf);
 
         /* Set return values */
         *buf = outbuf;
@@ -361,7 +361,7 @@ H5Z_filter_szip (unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
 
 done:
     if(outbuf)
-        H5MM_xfree(outbuf);
+        H5Z_buf_free(outbuf);
     FUNC_LEAVE_NOAPI(ret_value)
 }
 
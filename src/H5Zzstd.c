@@ -0,0 +1,512 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:	The Zstandard filter, which compresses each chunk as a zstd
+ *              frame.  The frames record the chunk's size, so chunks are
+ *              decompressed straight into a buffer of the right size.
+ *
+ *              Small chunks compress much better against a dictionary: a
+ *              dataset of bytes in the same file, trained with zstd or
+ *              just typical data.  The filter's parameters refer to it,
+ *              and when a dataset using it is created or opened, H5D
+ *              reads it and loads it here, keyed by its checksum, which
+ *              the filter's parameters record too.  Loaded dictionaries
+ *              are kept (prepared for each compression level used) until
+ *              the library closes.
+ *
+ *              Compression and decompression contexts are expensive to
+ *              set up, so they're kept in a pool and reused from chunk to
+ *              chunk, and by all the threads decoding chunks.
+ */
+
+#include "H5Zmodule.h"          /* This source code file is part of the H5Z module */
+
+
+#include "H5private.h"		/* Generic Functions			*/
+#include "H5Eprivate.h"		/* Error handling		  	*/
+#include "H5MMprivate.h"	/* Memory management			*/
+#include "H5Pprivate.h"         /* Property lists                       */
+#include "H5Zpkg.h"		/* Data filters				*/
+
+#ifdef H5_HAVE_FILTER_ZSTD
+
+#include <zstd.h>
+
+/* A compression level's prepared copy of a dictionary */
+typedef struct H5Z_zstd_cdict_t {
+    int level;                          /* Compression level */
+    ZSTD_CDict *cdict;                  /* Dictionary prepared for it */
+    struct H5Z_zstd_cdict_t *next;      /* Next level's */
+} H5Z_zstd_cdict_t;
+
+/* A loaded dictionary */
+typedef struct H5Z_zstd_dict_t {
+    unsigned key;                       /* Checksum of the dictionary */
+    size_t size;                        /* Size of the dictionary */
+    void *buf;                          /* The dictionary */
+    ZSTD_DDict *ddict;                  /* Dictionary prepared for decompression */
+    H5Z_zstd_cdict_t *cdicts;           /* ... and for each compression level */
+    struct H5Z_zstd_dict_t *next;       /* Next dictionary */
+} H5Z_zstd_dict_t;
+
+/* A compression and a decompression context, either created when needed */
+typedef struct H5Z_zstd_ctx_t {
+    ZSTD_CCtx *cctx;                    /* Compression context */
+    ZSTD_DCtx *dctx;                    /* Decompression context */
+    struct H5Z_zstd_ctx_t *next;        /* Next context in the pool */
+} H5Z_zstd_ctx_t;
+
+/* Local function prototypes */
+static herr_t H5Z_set_local_zstd(hid_t dcpl_id, hid_t type_id, hid_t space_id);
+static size_t H5Z_filter_zstd(unsigned flags, size_t cd_nelmts,
+    const unsigned cd_values[], size_t nbytes, size_t *buf_size, void **buf);
+static H5Z_zstd_dict_t *H5Z__zstd_find_dict(unsigned key);
+static H5Z_zstd_ctx_t *H5Z__zstd_get_ctx(void);
+static void H5Z__zstd_put_ctx(H5Z_zstd_ctx_t *ctx);
+
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_ZSTD[1] = {{
+    H5Z_CLASS_T_VERS,       /* H5Z_class_t version */
+    H5Z_FILTER_ZSTD,		/* Filter id number		*/
+    1,              /* encoder_present flag (set to true) */
+    1,              /* decoder_present flag (set to true) */
+    "zstd",			/* Filter name for debugging	*/
+    NULL,                       /* The "can apply" callback     */
+    H5Z_set_local_zstd,         /* The "set local" callback     */
+    H5Z_filter_zstd,            /* The actual filter function	*/
+}};
+
+/* Loaded dictionaries and the pool of contexts */
+static H5Z_zstd_dict_t *H5Z_zstd_dicts_g = NULL;
+static H5Z_zstd_ctx_t *H5Z_zstd_ctxs_g = NULL;
+
+/* Chunks are decoded by threads which don't hold the library lock, so the
+ * dictionaries and the pool have a lock of their own.
+ */
+#ifdef H5Z_HAVE_FILTER_LOCKS
+static pthread_mutex_t H5Z_zstd_lock_g = PTHREAD_MUTEX_INITIALIZER;
+#define H5Z_ZSTD_LOCK       (void)pthread_mutex_lock(&H5Z_zstd_lock_g);
+#define H5Z_ZSTD_UNLOCK     (void)pthread_mutex_unlock(&H5Z_zstd_lock_g);
+#else
+#define H5Z_ZSTD_LOCK
+#define H5Z_ZSTD_UNLOCK
+#endif /* H5Z_HAVE_FILTER_LOCKS */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_set_local_zstd
+ *
+ * Purpose:	Set the "local" dataset parameter for zstd compression: a
+ *              place for the key of the dictionary, if one is used, which
+ *              H5D fills in once it has loaded the dictionary.
+ *
+ * Return:	Success: Non-negative
+ *		Failure: Negative
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+H5Z_set_local_zstd(hid_t dcpl_id, hid_t H5_ATTR_UNUSED type_id, hid_t H5_ATTR_UNUSED space_id)
+{
+    H5P_genplist_t *dcpl_plist;     /* Property list pointer */
+    unsigned flags;                 /* Filter flags */
+    size_t cd_nelmts = H5Z_ZSTD_TOTAL_NPARMS;   /* Number of filter parameters */
+    unsigned cd_values[H5Z_ZSTD_TOTAL_NPARMS];  /* Filter parameters */
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    /* Get the plist structure */
+    if(NULL == (dcpl_plist = H5P_object_verify(dcpl_id, H5P_DATASET_CREATE)))
+        HGOTO_ERROR(H5E_ATOM, H5E_BADATOM, FAIL, "can't find object for ID")
+
+    /* Get the filter's current parameters */
+    if(H5P_get_filter_by_id(dcpl_plist, H5Z_FILTER_ZSTD, &flags, &cd_nelmts, cd_values, (size_t)0, NULL, NULL) < 0)
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTGET, FAIL, "can't get zstd parameters")
+
+    /* Make room for the dictionary's key */
+    if(cd_nelmts == H5Z_ZSTD_USER_NPARMS) {
+        cd_values[H5Z_ZSTD_PARM_DICT_KEY] = 0;
+        if(H5P_modify_filter(dcpl_plist, H5Z_FILTER_ZSTD, flags, (size_t)H5Z_ZSTD_TOTAL_NPARMS, cd_values) < 0)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTSET, FAIL, "can't set local zstd parameters")
+    } /* end if */
+    else if(cd_nelmts != 1 && cd_nelmts != H5Z_ZSTD_TOTAL_NPARMS)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, FAIL, "invalid number of zstd parameters")
+
+done:
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_set_local_zstd() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_filter_zstd
+ *
+ * Purpose:	Implement an I/O filter around Zstandard compression in
+ *              libzstd, with the dictionary the parameters refer to, if
+ *              any.
+ *
+ * Return:	Success: Size of buffer filtered
+ *		Failure: 0
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+H5Z_filter_zstd(unsigned flags, size_t cd_nelmts, const unsigned cd_values[],
+    size_t nbytes, size_t *buf_size, void **buf)
+{
+    H5Z_zstd_ctx_t *ctx = NULL;         /* Contexts from the pool */
+    H5Z_zstd_dict_t *dict = NULL;       /* Dictionary, if any */
+    void *outbuf = NULL;                /* Pointer to new buffer */
+    size_t status;                      /* Status from zstd operation */
+    int level;                          /* Compression level */
+    size_t ret_value = 0;               /* Return value */
+
+    FUNC_ENTER_NOAPI(0)
+
+    /* Sanity check */
+    HDassert(*buf_size > 0);
+    HDassert(buf);
+    HDassert(*buf);
+
+    /* Check arguments */
+    if(cd_nelmts != 1 && cd_nelmts != H5Z_ZSTD_TOTAL_NPARMS)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid number of zstd parameters")
+    level = (int)cd_values[H5Z_ZSTD_PARM_LEVEL];
+    if(level > H5Z_ZSTD_MAX_LEVEL)
+        HGOTO_ERROR(H5E_ARGS, H5E_BADVALUE, 0, "invalid zstd compression level")
+
+    /* Find the dictionary */
+    if(cd_nelmts == H5Z_ZSTD_TOTAL_NPARMS) {
+        H5Z_ZSTD_LOCK
+        dict = H5Z__zstd_find_dict(cd_values[H5Z_ZSTD_PARM_DICT_KEY]);
+        H5Z_ZSTD_UNLOCK
+        if(NULL == dict)
+            HGOTO_ERROR(H5E_PLINE, H5E_NOTFOUND, 0, "zstd dictionary isn't loaded")
+    } /* end if */
+
+    /* Get contexts to work with */
+    if(NULL == (ctx = H5Z__zstd_get_ctx()))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "can't allocate zstd context")
+
+    if(flags & H5Z_FLAG_REVERSE) {
+        /* Input; uncompress into a buffer of the size the frame records */
+        unsigned long long nalloc = ZSTD_getFrameContentSize(*buf, nbytes);
+
+        if(nalloc == ZSTD_CONTENTSIZE_ERROR)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, 0, "chunk isn't a zstd frame")
+        if(nalloc == ZSTD_CONTENTSIZE_UNKNOWN)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, 0, "zstd frame doesn't record its size")
+        if(nalloc > (unsigned long long)0xffffffff)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, 0, "zstd frame is too large for a chunk")
+        if(NULL == ctx->dctx && NULL == (ctx->dctx = ZSTD_createDCtx()))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "can't allocate zstd decompression context")
+
+        /* Allocate space for the uncompressed buffer */
+        if(NULL == (outbuf = H5Z_buf_malloc(MAX((size_t)nalloc, 1))))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "memory allocation failed for zstd uncompression")
+
+        /* Uncompress the buffer */
+        if(dict)
+            status = ZSTD_decompress_usingDDict(ctx->dctx, outbuf, (size_t)nalloc, *buf, nbytes, dict->ddict);
+        else
+            status = ZSTD_decompressDCtx(ctx->dctx, outbuf, (size_t)nalloc, *buf, nbytes);
+        if(ZSTD_isError(status))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, 0, "zstd decompression failed")
+        if(status != (size_t)nalloc)
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTDECODE, 0, "zstd frame is shorter than its recorded size")
+
+        /* Free the input buffer */
+        H5Z_buf_free(*buf);
+
+        /* Set return values */
+        *buf = outbuf;
+        outbuf = NULL;
+        *buf_size = MAX((size_t)nalloc, 1);
+        ret_value = (size_t)nalloc;
+    } /* end if */
+    else {
+        /* Output; compress into a buffer big enough for the worst case */
+        size_t nalloc = ZSTD_compressBound(nbytes);
+
+        if(NULL == ctx->cctx && NULL == (ctx->cctx = ZSTD_createCCtx()))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "can't allocate zstd compression context")
+
+        /* Allocate output (compressed) buffer */
+        if(NULL == (outbuf = H5Z_buf_malloc(nalloc)))
+            HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "unable to allocate zstd destination buffer")
+
+        /* Compress the buffer */
+        if(dict) {
+            H5Z_zstd_cdict_t *cdict;    /* Dictionary prepared for the level */
+
+            /* Prepare the dictionary for the level, the first time it's used */
+            H5Z_ZSTD_LOCK
+            for(cdict = dict->cdicts; cdict; cdict = cdict->next)
+                if(cdict->level == level)
+                    break;
+            if(NULL == cdict && NULL != (cdict = (H5Z_zstd_cdict_t *)H5MM_malloc(sizeof(H5Z_zstd_cdict_t)))) {
+                if(NULL == (cdict->cdict = ZSTD_createCDict(dict->buf, dict->size, level)))
+                    cdict = (H5Z_zstd_cdict_t *)H5MM_xfree(cdict);
+                else {
+                    cdict->level = level;
+                    cdict->next = dict->cdicts;
+                    dict->cdicts = cdict;
+                } /* end else */
+            } /* end if */
+            H5Z_ZSTD_UNLOCK
+            if(NULL == cdict)
+                HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, 0, "can't prepare zstd dictionary")
+
+            status = ZSTD_compress_usingCDict(ctx->cctx, outbuf, nalloc, *buf, nbytes, cdict->cdict);
+        } /* end if */
+        else
+            status = ZSTD_compressCCtx(ctx->cctx, outbuf, nalloc, *buf, nbytes, level);
+        if(ZSTD_isError(status))
+            HGOTO_ERROR(H5E_PLINE, H5E_CANTENCODE, 0, "zstd compression failed")
+
+        /* Free the input buffer */
+        H5Z_buf_free(*buf);
+
+        /* Set return values */
+        *buf = outbuf;
+        outbuf = NULL;
+        *buf_size = nalloc;
+        ret_value = status;
+    } /* end else */
+
+done:
+    if(ctx)
+        H5Z__zstd_put_ctx(ctx);
+    if(outbuf)
+        H5Z_buf_free(outbuf);
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_filter_zstd() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__zstd_find_dict
+ *
+ * Purpose:	Finds a loaded dictionary by its key.  The caller holds
+ *              the lock.
+ *
+ * Return:	Success:	The dictionary
+ *		Failure:	NULL, if it isn't loaded
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5Z_zstd_dict_t *
+H5Z__zstd_find_dict(unsigned key)
+{
+    H5Z_zstd_dict_t *dict;          /* Dictionary being checked */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    for(dict = H5Z_zstd_dicts_g; dict; dict = dict->next)
+        if(dict->key == key)
+            break;
+
+    FUNC_LEAVE_NOAPI(dict)
+} /* end H5Z__zstd_find_dict() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_zstd_dict_loaded
+ *
+ * Purpose:	Checks whether the dictionary with a key is loaded.
+ *
+ * Return:	TRUE/FALSE
+ *
+ *-------------------------------------------------------------------------
+ */
+hbool_t
+H5Z_zstd_dict_loaded(unsigned key)
+{
+    hbool_t ret_value;              /* Return value */
+
+    FUNC_ENTER_NOAPI_NOINIT_NOERR
+
+    H5Z_ZSTD_LOCK
+    ret_value = (NULL != H5Z__zstd_find_dict(key));
+    H5Z_ZSTD_UNLOCK
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_zstd_dict_loaded() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z_zstd_dict_load
+ *
+ * Purpose:	Loads a dictionary of SIZE bytes, unless it's loaded
+ *              already, and returns its key in *KEY.
+ *
+ * Return:	Non-negative on success/Negative on failure
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+H5Z_zstd_dict_load(const void *buf, size_t size, unsigned *key)
+{
+    H5Z_zstd_dict_t *dict = NULL;   /* Dictionary */
+    herr_t ret_value = SUCCEED;     /* Return value */
+
+    FUNC_ENTER_NOAPI(FAIL)
+
+    HDassert(buf);
+    HDassert(key);
+
+    /* Check whether it's loaded (loaded dictionaries don't change, so
+     * comparing them needs no lock) */
+    *key = (unsigned)H5_checksum_lookup3(buf, size, 0);
+    H5Z_ZSTD_LOCK
+    dict = H5Z__zstd_find_dict(*key);
+    H5Z_ZSTD_UNLOCK
+    if(dict) {
+        if(dict->size != size || HDmemcmp(dict->buf, buf, size))
+            HGOTO_ERROR(H5E_PLINE, H5E_EXISTS, FAIL, "a different zstd dictionary with the same checksum is loaded")
+        dict = NULL;
+        HGOTO_DONE(SUCCEED)
+    } /* end if */
+
+    /* Load it */
+    if(NULL == (dict = (H5Z_zstd_dict_t *)H5MM_calloc(sizeof(H5Z_zstd_dict_t))))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate zstd dictionary")
+    if(NULL == (dict->buf = H5MM_malloc(size)))
+        HGOTO_ERROR(H5E_RESOURCE, H5E_NOSPACE, FAIL, "can't allocate zstd dictionary")
+    HDmemcpy(dict->buf, buf, size);
+    dict->size = size;
+    dict->key = *key;
+    if(NULL == (dict->ddict = ZSTD_createDDict(buf, size)))
+        HGOTO_ERROR(H5E_PLINE, H5E_CANTINIT, FAIL, "can't prepare zstd dictionary")
+
+    /* Add it, unless another thread loaded it meanwhile */
+    H5Z_ZSTD_LOCK
+    if(NULL == H5Z__zstd_find_dict(*key)) {
+        dict->next = H5Z_zstd_dicts_g;
+        H5Z_zstd_dicts_g = dict;
+        dict = NULL;
+    } /* end if */
+    H5Z_ZSTD_UNLOCK
+
+done:
+    if(dict) {
+        if(dict->ddict)
+            (void)ZSTD_freeDDict(dict->ddict);
+        H5MM_xfree(dict->buf);
+        H5MM_xfree(dict);
+    } /* end if */
+
+    FUNC_LEAVE_NOAPI(ret_value)
+} /* end H5Z_zstd_dict_load() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__zstd_get_ctx
+ *
+ * Purpose:	Takes contexts from the pool, or makes new ones if the pool
+ *              is empty.  The zstd contexts themselves are created when
+ *              first needed.
+ *
+ * Return:	Success:	The contexts
+ *		Failure:	NULL
+ *
+ *-------------------------------------------------------------------------
+ */
+static H5Z_zstd_ctx_t *
+H5Z__zstd_get_ctx(void)
+{
+    H5Z_zstd_ctx_t *ctx;            /* Contexts */
+
+    FUNC_ENTER_STATIC_NOERR
+
+    H5Z_ZSTD_LOCK
+    if(NULL != (ctx = H5Z_zstd_ctxs_g))
+        H5Z_zstd_ctxs_g = ctx->next;
+    H5Z_ZSTD_UNLOCK
+
+    if(NULL == ctx)
+        ctx = (H5Z_zstd_ctx_t *)H5MM_calloc(sizeof(H5Z_zstd_ctx_t));
+
+    FUNC_LEAVE_NOAPI(ctx)
+} /* end H5Z__zstd_get_ctx() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__zstd_put_ctx
+ *
+ * Purpose:	Returns contexts to the pool.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+H5Z__zstd_put_ctx(H5Z_zstd_ctx_t *ctx)
+{
+    FUNC_ENTER_STATIC_NOERR
+
+    H5Z_ZSTD_LOCK
+    ctx->next = H5Z_zstd_ctxs_g;
+    H5Z_zstd_ctxs_g = ctx;
+    H5Z_ZSTD_UNLOCK
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__zstd_put_ctx() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:	H5Z__zstd_term
+ *
+ * Purpose:	Frees the pool of contexts and the loaded dictionaries,
+ *              when the library closes.
+ *
+ * Return:	void
+ *
+ *-------------------------------------------------------------------------
+ */
+void
+H5Z__zstd_term(void)
+{
+    FUNC_ENTER_PACKAGE_NOERR
+
+    H5Z_ZSTD_LOCK
+    while(H5Z_zstd_ctxs_g) {
+        H5Z_zstd_ctx_t *ctx = H5Z_zstd_ctxs_g;
+
+        H5Z_zstd_ctxs_g = ctx->next;
+        (void)ZSTD_freeCCtx(ctx->cctx);
+        (void)ZSTD_freeDCtx(ctx->dctx);
+        H5MM_xfree(ctx);
+    } /* end while */
+    while(H5Z_zstd_dicts_g) {
+        H5Z_zstd_dict_t *dict = H5Z_zstd_dicts_g;
+
+        H5Z_zstd_dicts_g = dict->next;
+        while(dict->cdicts) {
+            H5Z_zstd_cdict_t *cdict = dict->cdicts;
+
+            dict->cdicts = cdict->next;
+            (void)ZSTD_freeCDict(cdict->cdict);
+            H5MM_xfree(cdict);
+        } /* end while */
+        (void)ZSTD_freeDDict(dict->ddict);
+        H5MM_xfree(dict->buf);
+        H5MM_xfree(dict);
+    } /* end while */
+    H5Z_ZSTD_UNLOCK
+
+    FUNC_LEAVE_NOAPI_VOID
+} /* end H5Z__zstd_term() */
+
+#endif /* H5_HAVE_FILTER_ZSTD */
+
@@ -122,6 +122,21 @@
 #   include <sys/file.h>
 #endif
 
+/*
+ * preadv() and pwritev() in sys/uio.h are used by the sec2 driver for vector
+ * I/O.
+ */
+#ifdef H5_HAVE_SYS_UIO_H
+#   include <sys/uio.h>
+#endif
+
+/*
+ * mmap() and madvise() in sys/mman.h are used by the mmap driver.
+ */
+#ifdef H5_HAVE_SYS_MMAN_H
+#   include <sys/mman.h>
+#endif
+
 /*
  * Resource usage is not Posix.1 but HDF5 uses it anyway for some performance
  * and debugging code if available.
@@ -889,6 +904,9 @@ H5_DLL int HDfprintf (FILE *stream, const char *fmt, ...);
 #ifndef HDfstat
     #define HDfstat(F,B)        fstat(F,B)
 #endif /* HDfstat */
+#ifndef HDfsync
+    #define HDfsync(F)      fsync(F)
+#endif /* HDfsync */
 #ifndef HDlstat
     #define HDlstat(S,B)    lstat(S,B)
 #endif /* HDlstat */
@@ -1100,6 +1118,11 @@ typedef off_t               h5_stat_size_t;
  * The (char*) casts are required for the DEC when optimizations are turned
  * on and the source and/or destination are not aligned.
  */
+#ifdef H5_HAVE_MADVISE
+    #ifndef HDmadvise
+        #define HDmadvise(A,L,V)    madvise(A,L,V)
+    #endif /* HDmadvise */
+#endif /* H5_HAVE_MADVISE */
 #ifndef HDmemcpy
     #define HDmemcpy(X,Y,Z)    memcpy((char*)(X),(const char*)(Y),Z)
 #endif /* HDmemcpy */
@@ -1118,6 +1141,14 @@ typedef off_t               h5_stat_size_t;
 #ifndef HDmktime
     #define HDmktime(T)    mktime(T)
 #endif /* HDmktime */
+#ifdef H5_HAVE_MMAP
+    #ifndef HDmmap
+        #define HDmmap(A,L,P,F,D,O)    mmap(A,L,P,F,D,O)
+    #endif /* HDmmap */
+    #ifndef HDmunmap
+        #define HDmunmap(A,L)    munmap(A,L)
+    #endif /* HDmunmap */
+#endif /* H5_HAVE_MMAP */
 #ifndef HDmodf
     #define HDmodf(X,Y)    modf(X,Y)
 #endif /* HDmodf */
@@ -1148,6 +1179,16 @@ typedef off_t               h5_stat_size_t;
 #ifndef HDpowf
     #define HDpowf(X,Y)   powf(X,Y)
 #endif /* HDpowf */
+#ifdef H5_HAVE_PREAD
+    #ifndef HDpread
+        #define HDpread(F,B,Z,O)    pread(F,B,Z,O)
+    #endif /* HDpread */
+#endif /* H5_HAVE_PREAD */
+#ifdef H5_HAVE_PREADV
+    #ifndef HDpreadv
+        #define HDpreadv(F,V,N,O)    preadv(F,V,N,O)
+    #endif /* HDpreadv */
+#endif /* H5_HAVE_PREADV */
 #ifndef HDprintf
     #define HDprintf(...)   HDfprintf(stdout, __VA_ARGS__)
 #endif /* HDprintf */
@@ -1160,6 +1201,16 @@ typedef off_t               h5_stat_size_t;
 #ifndef HDputs
     #define HDputs(S)    puts(S)
 #endif /* HDputs */
+#ifdef H5_HAVE_PWRITE
+    #ifndef HDpwrite
+        #define HDpwrite(F,B,Z,O)    pwrite(F,B,Z,O)
+    #endif /* HDpwrite */
+#endif /* H5_HAVE_PWRITE */
+#ifdef H5_HAVE_PWRITEV
+    #ifndef HDpwritev
+        #define HDpwritev(F,V,N,O)    pwritev(F,V,N,O)
+    #endif /* HDpwritev */
+#endif /* H5_HAVE_PWRITEV */
 #ifndef HDqsort
     #define HDqsort(M,N,Z,F)  qsort(M,N,Z,F)
 #endif /* HDqsort*/
@@ -1364,6 +1415,9 @@ typedef off_t               h5_stat_size_t;
 #ifndef HDstrncmp
     #define HDstrncmp(X,Y,Z)  strncmp(X,Y,Z)
 #endif /* HDstrncmp */
+#ifndef HDstrncasecmp
+    #define HDstrncasecmp(X,Y,Z)  strncasecmp(X,Y,Z)
+#endif /* HDstrncasecmp */
 #ifndef HDstrncpy
     #define HDstrncpy(X,Y,Z)  strncpy(X,Y,Z)
 #endif /* HDstrncpy */
@@ -2654,6 +2708,7 @@ H5_DLL int H5CX_term_package(void);
 H5_DLL int H5D_term_package(void);
 H5_DLL int H5D_top_term_package(void);
 H5_DLL int H5E_term_package(void);
+H5_DLL int H5ES_term_package(void);
 H5_DLL int H5F_term_package(void);
 H5_DLL int H5FD_term_package(void);
 H5_DLL int H5FL_term_package(void);
@@ -38,6 +38,7 @@ typedef __int64             h5_stat_size_t;
 #define HDfdopen(N,S)       _fdopen(N,S)
 #define HDfileno(F)         _fileno(F)
 #define HDfstat(F,B)        _fstati64(F,B)
+#define HDfsync(F)          _commit(F)
 #define HDisatty(F)         _isatty(F)
 #define HDgetcwd(S,Z)       _getcwd(S,Z)
 #define HDgetdcwd(D,S,Z)    _getdcwd(D,S,Z)
@@ -62,6 +63,7 @@ typedef __int64             h5_stat_size_t;
 #define HDstat(S,B)         _stati64(S,B)
 #define HDstrcasecmp(A,B)   _stricmp(A,B)
 #define HDstrdup(S)         _strdup(S)
+#define HDstrncasecmp(A,B,C) _strnicmp(A,B,C)
 #define HDtzset()           _tzset()
 #define HDunlink(S)         _unlink(S)
 #define HDwrite(F,M,Z)      _write(F,M,Z)
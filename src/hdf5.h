@@ -24,6 +24,7 @@
 #include "H5ACpublic.h"         /* Metadata cache                           */
 #include "H5Dpublic.h"          /* Datasets                                 */
 #include "H5Epublic.h"          /* Errors                                   */
+#include "H5ESpublic.h"         /* Event sets                               */
 #include "H5Fpublic.h"          /* Files                                    */
 #include "H5FDpublic.h"         /* File drivers                             */
 #include "H5Gpublic.h"          /* Groups                                   */
@@ -39,14 +40,19 @@
 #include "H5Zpublic.h"          /* Data filters                             */
 
 /* Predefined file drivers */
+#include "H5FDblkcache.h"       /* Persistent local block cache over a driver   */
 #include "H5FDcore.h"           /* Files stored entirely in memory              */
 #include "H5FDdirect.h"         /* Linux direct I/O                             */
 #include "H5FDfamily.h"         /* File families                                */
+#include "H5FDhttp.h"           /* Read-only HTTP range requests                */
+#include "H5FDiouring.h"        /* Linux io_uring deep-queue I/O                */
 #include "H5FDlog.h"            /* sec2 driver with I/O logging (for debugging) */
+#include "H5FDmmap.h"           /* Read-only memory-mapped file I/O             */
 #include "H5FDmpi.h"            /* MPI-based file drivers                       */
 #include "H5FDmulti.h"          /* Usage-partitioned file family                */
 #include "H5FDsec2.h"           /* POSIX unbuffered file I/O                    */
 #include "H5FDstdio.h"          /* Standard C buffered I/O                      */
+#include "H5FDsubfiling.h"      /* Address space striped over subfiles          */
 #ifdef H5_HAVE_WINDOWS
 #include "H5FDwindows.h"        /* Win32 I/O                                    */
 #endif
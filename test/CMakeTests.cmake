@@ -531,6 +531,7 @@ set (test_CLEANFILES
     test_swmr*.h5
     cache_logging.h5
     cache_logging.out
+    event_set.h5
     vds_swmr.h5
     vds_swmr_src_*.h5
     tmp/vds_src_2.h5
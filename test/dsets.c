@@ -84,6 +84,12 @@ const char *FILENAME[] = {
     "dls_01_strings",   /* 23 */
     "power2up",         /* 24 */
     "version_bounds",   /* 25 */
+    "filter_nthreads",  /* 26 */
+    "shared_chunk_cache", /* 27 */
+    "chunk_cache_policy", /* 28 */
+    "chunk_read_ahead",   /* 29 */
+    "chunk_read_coalesce", /* 30 */
+    "multi_dset_io",      /* 31 */
     NULL
 };
 
@@ -104,6 +110,9 @@ const char *FILENAME[] = {
 #define DSET_CONV_BUF_NAME          "conv_buf"
 #define DSET_TCONV_NAME             "tconv"
 #define DSET_DEFLATE_NAME           "deflate"
+#define DSET_DEFLATE_LEVELS_NAME    "deflate_levels"
+#define DSET_BUFFER_POOL_NAME       "buffer_pool"
+#define DSET_BUFFER_POOL_NAME_2     "buffer_pool_2"
 #define DSET_SHUFFLE_NAME           "shuffle"
 #define DSET_FLETCHER32_NAME        "fletcher32"
 #define DSET_FLETCHER32_NAME_2      "fletcher32_2"
@@ -126,6 +135,11 @@ const char *FILENAME[] = {
 #define DSET_SET_LOCAL_NAME         "set_local"
 #define DSET_SET_LOCAL_NAME_2       "set_local_2"
 #define DSET_ONEBYTE_SHUF_NAME      "onebyte_shuffle"
+#define DSET_MULTIBYTE_SHUF_NAME    "multibyte_shuffle"
+#define DSET_BITSHUFFLE_NAME        "bitshuffle"
+#define DSET_ZSTD_NAME              "zstd"
+#define DSET_ZSTD_DICT_NAME         "zstd_dict"
+#define DSET_ZSTD_DICT_DATA_NAME    "zstd_with_dict"
 #define DSET_NBIT_INT_NAME             "nbit_int"
 #define DSET_NBIT_FLOAT_NAME           "nbit_float"
 #define DSET_NBIT_DOUBLE_NAME          "nbit_double"
@@ -276,6 +290,24 @@ double  points_dbl[DSET_DIM1][DSET_DIM2], check_dbl[DSET_DIM1][DSET_DIM2];
 size_t  count_nbytes_read = 0;
 size_t  count_nbytes_written = 0;
 
+/* Elements in the bitshuffle test's chunks: 2 blocks of 4-byte elements,
+ * part of a block and 3 elements past the last multiple of 8 */
+#define DSET_BITSHUFFLE_NELMTS  5003
+
+/* Elements in the deflate levels test's datasets and their chunks */
+#define DSET_DEFLATE_LEVELS_NELMTS  4096
+#define DSET_DEFLATE_LEVELS_CHUNK   512
+
+/* Elements in the buffer pool test's datasets and their chunks */
+#define DSET_BUFFER_POOL_NELMTS     8192
+#define DSET_BUFFER_POOL_CHUNK      1024
+#define DSET_BUFFER_POOL_LIMIT      ((size_t)32 * 1024 * 1024)
+
+/* Bytes in the zstd test's dataset, its chunks and its dictionary */
+#define DSET_ZSTD_NBYTES        8192
+#define DSET_ZSTD_CHUNK         256
+#define DSET_ZSTD_DICT_NBYTES   1024
+
 /* Temporary buffer dimensions */
 #define DSET_TMP_DIM1   50
 #define DSET_TMP_DIM2   100
@@ -515,7 +547,8 @@ test_simple_io(const char *env_h5_drvr, hid_t fapl)
     TESTING("simple I/O");
 
     /* Can't run this test with multi-file VFDs because of HDopen/read/seek the file directly */
-    if(HDstrcmp(env_h5_drvr, "split") && HDstrcmp(env_h5_drvr, "multi") && HDstrcmp(env_h5_drvr, "family")) {
+    if(HDstrcmp(env_h5_drvr, "split") && HDstrcmp(env_h5_drvr, "multi") && HDstrcmp(env_h5_drvr, "family")
+            && HDstrcmp(env_h5_drvr, "subfiling")) {
         h5_fixname(FILENAME[4], fapl, filename, sizeof filename);
 
         /* Initialize the dataset */
@@ -648,7 +681,8 @@ test_userblock_offset(const char *env_h5_drvr, hid_t fapl, hbool_t new_format)
     TESTING("dataset offset with user block");
 
     /* Can't run this test with multi-file VFDs because of HDopen/read/seek the file directly */
-    if(HDstrcmp(env_h5_drvr, "split") && HDstrcmp(env_h5_drvr, "multi") && HDstrcmp(env_h5_drvr, "family")) {
+    if(HDstrcmp(env_h5_drvr, "split") && HDstrcmp(env_h5_drvr, "multi") && HDstrcmp(env_h5_drvr, "family")
+            && HDstrcmp(env_h5_drvr, "subfiling")) {
         h5_fixname(FILENAME[2], fapl, filename, sizeof filename);
 
         if((fcpl=H5Pcreate(H5P_FILE_CREATE)) < 0) goto error;
@@ -2512,6 +2546,324 @@ error:
 }
 
 
+/*-------------------------------------------------------------------------
+ * Function:  test_deflate_levels
+ *
+ * Purpose:   Tests that deflate compresses each chunk the same way when
+ *            chunks of datasets with different aggression levels (and
+ *            other filters) are compressed in turn as when a dataset is
+ *            compressed by itself, and that the chunks read back are the
+ *            ones written, whether or not they are cached.
+ *
+ * Return:    Success:    0
+ *            Failure:    -1
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_deflate_levels(hid_t
+#ifndef H5_HAVE_FILTER_DEFLATE
+H5_ATTR_UNUSED
+#endif /* H5_HAVE_FILTER_DEFLATE */
+file)
+{
+#ifdef H5_HAVE_FILTER_DEFLATE
+    const unsigned  levels[] = {1, 6, 9, 6};    /* The last with shuffle and fletcher32 */
+    hsize_t         nelmts = DSET_DEFLATE_LEVELS_NELMTS;
+    hsize_t         chunk = DSET_DEFLATE_LEVELS_CHUNK;
+    hsize_t         start, count = DSET_DEFLATE_LEVELS_CHUNK;
+    hid_t           dsets[NELMTS(levels)], dset = -1;
+    hid_t           space = -1, mspace = -1, dc = -1, dapl = -1;
+    int             *orig_data = NULL, *new_data = NULL;
+    unsigned char   *chunk1 = NULL, *chunk2 = NULL;
+    hsize_t         chunk1_size, chunk2_size;
+    uint32_t        filter_mask;
+    char            name[64];
+    size_t          u, v;
+
+    TESTING("deflate filter aggression levels");
+
+    for(u = 0; u < NELMTS(levels); u++)
+        dsets[u] = -1;
+
+    if(NULL == (orig_data = (int *)HDmalloc(DSET_DEFLATE_LEVELS_NELMTS * sizeof(int))))
+        TEST_ERROR
+    if(NULL == (new_data = (int *)HDmalloc(DSET_DEFLATE_LEVELS_NELMTS * sizeof(int))))
+        TEST_ERROR
+    if(NULL == (chunk1 = (unsigned char *)HDmalloc(2 * DSET_DEFLATE_LEVELS_CHUNK * sizeof(int))))
+        TEST_ERROR
+    if(NULL == (chunk2 = (unsigned char *)HDmalloc(2 * DSET_DEFLATE_LEVELS_CHUNK * sizeof(int))))
+        TEST_ERROR
+    for(u = 0; u < DSET_DEFLATE_LEVELS_NELMTS; u++)
+        orig_data[u] = (int)((u / 3) + (u % 7) * (u % 5));
+
+    if((space = H5Screate_simple(1, &nelmts, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((mspace = H5Screate_simple(1, &count, NULL)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Without a chunk cache, each chunk is compressed as it's written */
+    if((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk_cache(dapl, (size_t)0, (size_t)0, 0.0F) < 0)
+        FAIL_STACK_ERROR
+
+    for(v = 0; v < 2; v++)
+        for(u = 0; u < NELMTS(levels); u++) {
+            if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pset_chunk(dc, 1, &chunk) < 0)
+                FAIL_STACK_ERROR
+            if(u == NELMTS(levels) - 1 && H5Pset_shuffle(dc) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pset_deflate(dc, levels[u]) < 0)
+                FAIL_STACK_ERROR
+            if(u == NELMTS(levels) - 1 && H5Pset_fletcher32(dc) < 0)
+                FAIL_STACK_ERROR
+            HDsnprintf(name, sizeof(name), "%s_%u_%u%s", DSET_DEFLATE_LEVELS_NAME, levels[u],
+                    (unsigned)u, v ? "_alone" : "");
+            if((dset = H5Dcreate2(file, name, H5T_NATIVE_INT, space, H5P_DEFAULT, dc, v ? H5P_DEFAULT : dapl)) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pclose(dc) < 0)
+                FAIL_STACK_ERROR
+
+            /* The second time through, write each dataset all at once */
+            if(v) {
+                if(H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+                    FAIL_STACK_ERROR
+                if(H5Dclose(dset) < 0)
+                    FAIL_STACK_ERROR
+            } /* end if */
+            else
+                dsets[u] = dset;
+            dset = -1;
+        } /* end for */
+
+    /* Write the chunks of the first datasets in turn */
+    for(start = 0; start < DSET_DEFLATE_LEVELS_NELMTS; start += DSET_DEFLATE_LEVELS_CHUNK)
+        for(u = 0; u < NELMTS(levels); u++) {
+            if(H5Sselect_hyperslab(space, H5S_SELECT_SET, &start, NULL, &count, NULL) < 0)
+                FAIL_STACK_ERROR
+            if(H5Dwrite(dsets[u], H5T_NATIVE_INT, mspace, space, H5P_DEFAULT, orig_data + start) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+
+    /* Check the chunks stored, and the data read */
+    for(u = 0; u < NELMTS(levels); u++) {
+        HDsnprintf(name, sizeof(name), "%s_%u_%u_alone", DSET_DEFLATE_LEVELS_NAME, levels[u], (unsigned)u);
+        if((dset = H5Dopen2(file, name, H5P_DEFAULT)) < 0)
+            FAIL_STACK_ERROR
+        for(start = 0; start < DSET_DEFLATE_LEVELS_NELMTS; start += DSET_DEFLATE_LEVELS_CHUNK) {
+            if(H5Dget_chunk_storage_size(dsets[u], &start, &chunk1_size) < 0)
+                FAIL_STACK_ERROR
+            if(H5Dget_chunk_storage_size(dset, &start, &chunk2_size) < 0)
+                FAIL_STACK_ERROR
+            if(chunk1_size != chunk2_size || chunk1_size >= DSET_DEFLATE_LEVELS_CHUNK * sizeof(int))
+                TEST_ERROR
+            if(H5Dread_chunk(dsets[u], H5P_DEFAULT, &start, &filter_mask, chunk1) < 0)
+                FAIL_STACK_ERROR
+            if(H5Dread_chunk(dset, H5P_DEFAULT, &start, &filter_mask, chunk2) < 0)
+                FAIL_STACK_ERROR
+            if(HDmemcmp(chunk1, chunk2, (size_t)chunk1_size)) {
+                H5_FAILED();
+                HDprintf("    Chunk at %lu compressed at level %u differently\n", (unsigned long)start, levels[u]);
+                goto error;
+            } /* end if */
+        } /* end for */
+
+        for(v = 0; v < 2; v++) {
+            HDmemset(new_data, 0, DSET_DEFLATE_LEVELS_NELMTS * sizeof(int));
+            if(H5Dread(v ? dset : dsets[u], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+                FAIL_STACK_ERROR
+            if(HDmemcmp(new_data, orig_data, DSET_DEFLATE_LEVELS_NELMTS * sizeof(int))) {
+                H5_FAILED();
+                HDprintf("    Read different values than written at level %u\n", levels[u]);
+                goto error;
+            } /* end if */
+        } /* end for */
+
+        if(H5Dclose(dset) < 0)
+            FAIL_STACK_ERROR
+        dset = -1;
+        if(H5Dclose(dsets[u]) < 0)
+            FAIL_STACK_ERROR
+        dsets[u] = -1;
+    } /* end for */
+
+    if(H5Pclose(dapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(mspace) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(space) < 0)
+        FAIL_STACK_ERROR
+
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(chunk1);
+    HDfree(chunk2);
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        for(u = 0; u < NELMTS(levels); u++)
+            H5Dclose(dsets[u]);
+        H5Dclose(dset);
+        H5Pclose(dc);
+        H5Pclose(dapl);
+        H5Sclose(mspace);
+        H5Sclose(space);
+    } H5E_END_TRY;
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(chunk1);
+    HDfree(chunk2);
+
+    return -1;
+#else /* H5_HAVE_FILTER_DEFLATE */
+    TESTING("deflate filter aggression levels");
+    SKIPPED();
+    HDputs("    Deflate filter not enabled");
+
+    return 0;
+#endif /* H5_HAVE_FILTER_DEFLATE */
+} /* end test_deflate_levels() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:  test_buffer_pool
+ *
+ * Purpose:   Tests that the filter pipeline reuses the buffers it
+ *            returns to the filter buffer pool, that the pool never holds
+ *            more than its limit, and that H5garbage_collect() empties it.
+ *
+ * Return:    Success:    0
+ *            Failure:    -1
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_buffer_pool(hid_t file)
+{
+    const char      *names[] = {DSET_BUFFER_POOL_NAME, DSET_BUFFER_POOL_NAME_2};
+    hsize_t         nelmts = DSET_BUFFER_POOL_NELMTS;
+    hsize_t         chunk = DSET_BUFFER_POOL_CHUNK;
+    hid_t           dset = -1, space = -1, dc = -1, dapl = -1;
+    int             *orig_data = NULL, *new_data = NULL;
+    size_t          cur_size, max_size;
+    hsize_t         nreused, nreused2, nallocated;
+    size_t          u, v;
+
+    TESTING("filter buffer pool");
+
+    if(NULL == (orig_data = (int *)HDmalloc(DSET_BUFFER_POOL_NELMTS * sizeof(int))))
+        TEST_ERROR
+    if(NULL == (new_data = (int *)HDmalloc(DSET_BUFFER_POOL_NELMTS * sizeof(int))))
+        TEST_ERROR
+    for(u = 0; u < DSET_BUFFER_POOL_NELMTS; u++)
+        orig_data[u] = (int)(u * 7 + (u % 11));
+
+    if((space = H5Screate_simple(1, &nelmts, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk(dc, 1, &chunk) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_shuffle(dc) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fletcher32(dc) < 0)
+        FAIL_STACK_ERROR
+
+    /* Without a chunk cache, each chunk goes through the pipeline at once */
+    if((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk_cache(dapl, (size_t)0, (size_t)0, 0.0F) < 0)
+        FAIL_STACK_ERROR
+
+    /* The first time through use the default limit, then no pool at all */
+    for(v = 0; v < 2; v++) {
+        if(H5Zset_buffer_pool_limit(v ? (size_t)0 : DSET_BUFFER_POOL_LIMIT) < 0)
+            FAIL_STACK_ERROR
+        if(H5Zget_buffer_pool_stats(&cur_size, NULL, &nreused, NULL) < 0)
+            FAIL_STACK_ERROR
+        if(v && cur_size != 0)
+            TEST_ERROR
+
+        if((dset = H5Dcreate2(file, names[v], H5T_NATIVE_INT, space, H5P_DEFAULT, dc, dapl)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+            FAIL_STACK_ERROR
+        HDmemset(new_data, 0, DSET_BUFFER_POOL_NELMTS * sizeof(int));
+        if(H5Dread(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+            FAIL_STACK_ERROR
+        if(HDmemcmp(new_data, orig_data, DSET_BUFFER_POOL_NELMTS * sizeof(int))) {
+            H5_FAILED();
+            HDputs("    Read different values than written");
+            goto error;
+        } /* end if */
+        if(H5Dclose(dset) < 0)
+            FAIL_STACK_ERROR
+        dset = -1;
+
+        if(H5Zget_buffer_pool_stats(&cur_size, &max_size, &nreused2, &nallocated) < 0)
+            FAIL_STACK_ERROR
+        if(v) {
+            /* Nothing is kept without a limit */
+            if(cur_size != 0 || nreused2 != nreused)
+                TEST_ERROR
+        } /* end if */
+        else {
+            if(max_size > DSET_BUFFER_POOL_LIMIT || cur_size > max_size)
+                TEST_ERROR
+#ifndef H5_MEMORY_ALLOC_SANITY_CHECK
+            /* Each chunk after the first reuses the buffers of the last */
+            if(nreused2 <= nreused || cur_size == 0)
+                TEST_ERROR
+#endif /* H5_MEMORY_ALLOC_SANITY_CHECK */
+
+            /* Garbage collection empties the pool */
+            if(H5garbage_collect() < 0)
+                FAIL_STACK_ERROR
+            if(H5Zget_buffer_pool_stats(&cur_size, NULL, NULL, NULL) < 0)
+                FAIL_STACK_ERROR
+            if(cur_size != 0)
+                TEST_ERROR
+        } /* end else */
+    } /* end for */
+
+    /* Restore the default limit */
+    if(H5Zset_buffer_pool_limit(DSET_BUFFER_POOL_LIMIT) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Pclose(dapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(dc) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(space) < 0)
+        FAIL_STACK_ERROR
+
+    HDfree(orig_data);
+    HDfree(new_data);
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Zset_buffer_pool_limit(DSET_BUFFER_POOL_LIMIT);
+        H5Dclose(dset);
+        H5Pclose(dc);
+        H5Pclose(dapl);
+        H5Sclose(space);
+    } H5E_END_TRY;
+    HDfree(orig_data);
+    HDfree(new_data);
+
+    return -1;
+} /* end test_buffer_pool() */
+
+
 /*-------------------------------------------------------------------------
  * Function:  test_missing_filter
  *
@@ -2853,416 +3205,545 @@ error:
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_int
+ * Function:  test_multibyte_shuffle
  *
- * Purpose:     Tests the integer datatype for nbit filter
+ * Purpose:   Tests shuffling elements of several sizes, including the
+ *            sizes shuffled with SIMD instructions, with numbers of
+ *            elements that leave part of a block for the scalar code.
+ *            The chunks stored must be the same as those shuffled a byte
+ *            at a time, and the data read must be the data written.
  *
- * Return:      Success:        0
- *              Failure:        -1
+ * Return:    Success:    0
+ *            Failure:    -1
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_int(hid_t file)
+test_multibyte_shuffle(hid_t file)
 {
-    hid_t               dataset, datatype, mem_datatype, space, dc;
-    hsize_t             size[2] = {2, 5};
-    hsize_t             chunk_size[2] = {2,5};
-    int                 orig_data[2][5];
-    int                 new_data[2][5];
-    unsigned int        mask;
-    size_t              precision, offset;
-    double              power;
-    size_t              i, j;
-
-    puts("Testing nbit filter");
-    TESTING("    nbit int (setup)");
-
-    /* Define dataset datatype (integer), and set precision, offset */
-    datatype = H5Tcopy(H5T_NATIVE_INT);
-    precision = 17; /* precision includes sign bit */
-    if(H5Tset_precision(datatype,precision) < 0) goto error;
-    offset = 4;
-    if(H5Tset_offset(datatype,offset) < 0) goto error;
-
-    /* Copy to memory datatype before setting order */
-    mem_datatype = H5Tcopy(datatype);
-
-    /* Set order of dataset datatype */
-    if(H5Tset_order(datatype, H5T_ORDER_BE) < 0) goto error;
-
-    /* Create the data space */
-    if((space = H5Screate_simple(2, size, NULL)) < 0) goto error;
-
-    /* Use nbit filter  */
-    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
-    if(H5Pset_chunk(dc, 2, chunk_size) < 0) goto error;
-    if(H5Pset_nbit(dc) < 0) goto error;
-
-    /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_INT_NAME, datatype,
-                             space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
-
-    /* Initialize data, assuming size of long long >= size of int */
-    for(i= 0;i< (size_t)size[0]; i++)
-        for(j = 0; j < (size_t)size[1]; j++) {
-            power = HDpow(2.0f, (double)(precision - 1));
-            orig_data[i][j] = (int)(((long long)HDrandom() % (long long)power) << offset);
-
-            /* even-numbered values are negtive */
-            if((i*size[1]+j+1)%2 == 0)
-                orig_data[i][j] = -orig_data[i][j];
-        }
-
-    PASSED();
-
-    /*----------------------------------------------------------------------
-     * STEP 1: Test nbit by setting up a chunked dataset and writing
-     * to it.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    nbit int (write)");
+    const hsize_t   elem_sizes[] = {2, 3, 4, 8, 16};
+    const hsize_t   nelmts[] = {5, 16, 1003};
+    hid_t           dataset = -1, space = -1, dc = -1, type = -1;
+    unsigned char   *orig_data = NULL, *new_data = NULL, *shuf_data = NULL;
+    char            name[64];
+    uint32_t        filter_mask;
+    size_t          s, n, e, b;
 
-    if(H5Dwrite(dataset, mem_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
-        goto error;
-    PASSED();
+    TESTING("multi-byte shuffling");
 
-    /*----------------------------------------------------------------------
-     * STEP 2: Try to read the data we just wrote.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    nbit int (read)");
+    if(NULL == (orig_data = (unsigned char *)HDmalloc(16 * 1003)))
+        TEST_ERROR
+    if(NULL == (new_data = (unsigned char *)HDmalloc(16 * 1003)))
+        TEST_ERROR
+    if(NULL == (shuf_data = (unsigned char *)HDmalloc(16 * 1003)))
+        TEST_ERROR
 
-    /* Read the dataset back */
-    if(H5Dread(dataset, mem_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
-        goto error;
+    for(s = 0; s < NELMTS(elem_sizes); s++)
+        for(n = 0; n < NELMTS(nelmts); n++) {
+            size_t size = (size_t)elem_sizes[s];
+            size_t nelmt = (size_t)nelmts[n];
+            hsize_t offset[1] = {0};
+
+            /* Create the dataset, with one chunk */
+            if((type = H5Tarray_create2(H5T_NATIVE_UCHAR, 1, &elem_sizes[s])) < 0)
+                FAIL_STACK_ERROR
+            if((space = H5Screate_simple(1, &nelmts[n], NULL)) < 0)
+                FAIL_STACK_ERROR
+            if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pset_chunk(dc, 1, &nelmts[n]) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pset_shuffle(dc) < 0)
+                FAIL_STACK_ERROR
+            HDsnprintf(name, sizeof(name), "%s_%u_%u", DSET_MULTIBYTE_SHUF_NAME, (unsigned)size, (unsigned)nelmt);
+            if((dataset = H5Dcreate2(file, name, type, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+                FAIL_STACK_ERROR
+
+            for(e = 0; e < size * nelmt; e++)
+                orig_data[e] = (unsigned char)HDrandom();
+            if(H5Dwrite(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+                FAIL_STACK_ERROR
+            if(H5Dflush(dataset) < 0)
+                FAIL_STACK_ERROR
+
+            /* Check the chunk stored */
+            if(H5Dread_chunk(dataset, H5P_DEFAULT, offset, &filter_mask, new_data) < 0)
+                FAIL_STACK_ERROR
+            for(e = 0; e < nelmt; e++)
+                for(b = 0; b < size; b++)
+                    shuf_data[(b * nelmt) + e] = orig_data[(e * size) + b];
+            if(HDmemcmp(new_data, shuf_data, size * nelmt)) {
+                H5_FAILED();
+                HDprintf("    Chunk of %u %u-byte elements shuffled differently\n", (unsigned)nelmt, (unsigned)size);
+                goto error;
+            } /* end if */
 
-    /* Check that the values read are the same as the values written
-     * Use mask for checking the significant bits, ignoring the padding bits
-     */
-    mask = ~((unsigned)~0 << (precision + offset)) & ((unsigned)~0 << offset);
-    for(i=0; i<(size_t)size[0]; i++) {
-        for(j=0; j<(size_t)size[1]; j++) {
-            if(((unsigned)new_data[i][j] & mask) != ((unsigned)orig_data[i][j] & mask)) {
+            /* Check the data read */
+            HDmemset(new_data, 0, size * nelmt);
+            if(H5Dread(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+                FAIL_STACK_ERROR
+            if(HDmemcmp(new_data, orig_data, size * nelmt)) {
                 H5_FAILED();
-                printf("    Read different values than written.\n");
-                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
+                HDprintf("    Read different values than written for %u %u-byte elements\n", (unsigned)nelmt, (unsigned)size);
                 goto error;
-            }
-        }
-    }
+            } /* end if */
 
-    /*----------------------------------------------------------------------
-     * Cleanup
-     *----------------------------------------------------------------------
-     */
-    if(H5Tclose(datatype) < 0) goto error;
-    if(H5Tclose(mem_datatype) < 0) goto error;
-    if(H5Pclose(dc) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
+            if(H5Dclose(dataset) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pclose(dc) < 0)
+                FAIL_STACK_ERROR
+            if(H5Sclose(space) < 0)
+                FAIL_STACK_ERROR
+            if(H5Tclose(type) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(shuf_data);
 
     PASSED();
 
     return 0;
 
 error:
+    H5E_BEGIN_TRY {
+        H5Dclose(dataset);
+        H5Pclose(dc);
+        H5Sclose(space);
+        H5Tclose(type);
+    } H5E_END_TRY;
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(shuf_data);
+
     return -1;
-}
+} /* end test_multibyte_shuffle() */
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_float
+ * Function:  test_bitshuffle
  *
- * Purpose:     Tests the float datatype of nbit filter
+ * Purpose:   Tests the bitshuffle filter, with and without LZ4, on
+ *            elements of several sizes, in chunks which end with a
+ *            partial block and elements past the last multiple of 8.
+ *            Without compression the chunks stored must be the bit rows
+ *            worked out a bit at a time; with LZ4 they must be laid out
+ *            in blocks after a header and be smaller than the data.  The
+ *            data read must be the data written, and a corrupt chunk
+ *            must fail to read.
  *
- * Return:      Success:        0
- *              Failure:        -1
+ * Return:    Success:    0
+ *            Failure:    -1
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_float(hid_t file)
+test_bitshuffle(hid_t file)
 {
-    hid_t               dataset, datatype, space, dc;
-    const hsize_t       size[2] = {2, 5};
-    const hsize_t       chunk_size[2] = {2, 5};
-    /* orig_data[] are initialized to be within the range that can be represented by
-     * dataset datatype (no precision loss during datatype conversion)
-     */
-    float               orig_data[2][5] = {{188384.0f, 19.103516f, -1.0831790e9f, -84.242188f, 5.2045898f},
-                                           {-49140.0f, 2350.25f, -3.2110596e-1f, 6.4998865e-5f, -0.0f}};
-    float               new_data[2][5];
-    size_t              precision, offset;
-    size_t              i, j;
-
-    TESTING("    nbit float (setup)");
-
-    /* Define user-defined single-precision floating-point type for dataset */
-    datatype = H5Tcopy(H5T_IEEE_F32BE);
-    if(H5Tset_fields(datatype, (size_t)26, (size_t)20, (size_t)6, (size_t)7, (size_t)13) < 0)
-        FAIL_STACK_ERROR
-    offset = 7;
-    if(H5Tset_offset(datatype,offset) < 0)
-        FAIL_STACK_ERROR
-    precision = 20;
-    if(H5Tset_precision(datatype,precision) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_size(datatype, (size_t)4) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_ebias(datatype, (size_t)31) < 0)
-        FAIL_STACK_ERROR
+    const hsize_t   elem_sizes[] = {1, 2, 3, 4, 8};
+    const unsigned  block_sizes[] = {0, 64};
+    const unsigned  comps[] = {H5Z_BITSHUFFLE_COMP_NONE, H5Z_BITSHUFFLE_COMP_LZ4};
+    hsize_t         nelmts = DSET_BITSHUFFLE_NELMTS;
+    hid_t           dataset = -1, space = -1, dc = -1, type = -1;
+    unsigned char   *orig_data = NULL, *new_data = NULL, *shuf_data = NULL;
+    char            name[64];
+    uint32_t        filter_mask;
+    hsize_t         offset[1] = {0};
+    size_t          s, c, k, e, b, done;
+    herr_t          ret;
+
+    TESTING("bitshuffle filter");
+
+    if(NULL == (orig_data = (unsigned char *)HDmalloc(8 * DSET_BITSHUFFLE_NELMTS)))
+        TEST_ERROR
+    if(NULL == (new_data = (unsigned char *)HDmalloc(16 * DSET_BITSHUFFLE_NELMTS)))
+        TEST_ERROR
+    if(NULL == (shuf_data = (unsigned char *)HDmalloc(8 * DSET_BITSHUFFLE_NELMTS)))
+        TEST_ERROR
 
-    /* Create the data space */
-    if((space = H5Screate_simple(2, size, NULL)) < 0)
+    if((space = H5Screate_simple(1, &nelmts, NULL)) < 0)
         FAIL_STACK_ERROR
 
-    /* Use nbit filter  */
-    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
-        FAIL_STACK_ERROR
-    if(H5Pset_chunk(dc, 2, chunk_size) < 0)
-        FAIL_STACK_ERROR
-    if(H5Pset_nbit(dc) < 0)
-        FAIL_STACK_ERROR
+    for(s = 0; s < NELMTS(elem_sizes); s++)
+        for(k = 0; k < NELMTS(block_sizes); k++)
+            for(c = 0; c < NELMTS(comps); c++) {
+                size_t size = (size_t)elem_sizes[s];
+                size_t block = block_sizes[k];
 
-    /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_FLOAT_NAME, datatype, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
-        FAIL_STACK_ERROR
-    PASSED();
+                /* Create the dataset, with one chunk */
+                if((type = H5Tarray_create2(H5T_NATIVE_UCHAR, 1, &elem_sizes[s])) < 0)
+                    FAIL_STACK_ERROR
+                if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+                    FAIL_STACK_ERROR
+                if(H5Pset_chunk(dc, 1, &nelmts) < 0)
+                    FAIL_STACK_ERROR
+                if(H5Pset_bitshuffle(dc, block_sizes[k], comps[c]) < 0)
+                    FAIL_STACK_ERROR
+                HDsnprintf(name, sizeof(name), "%s_%u_%u_%u", DSET_BITSHUFFLE_NAME, (unsigned)size, block_sizes[k], comps[c]);
+                if((dataset = H5Dcreate2(file, name, type, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+                    FAIL_STACK_ERROR
 
-    /*----------------------------------------------------------------------
-     * STEP 1: Test nbit by setting up a chunked dataset and writing
-     * to it.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    nbit float (write)");
+                /* Slowly changing little-endian values */
+                for(e = 0; e < DSET_BITSHUFFLE_NELMTS; e++)
+                    for(b = 0; b < size; b++)
+                        orig_data[(e * size) + b] = (unsigned char)(b < 4 ? ((e * 7) / 5) >> (8 * b) : 0);
+                if(H5Dwrite(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+                    FAIL_STACK_ERROR
+                if(H5Dflush(dataset) < 0)
+                    FAIL_STACK_ERROR
 
-    if(H5Dwrite(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
-        FAIL_STACK_ERROR
+                /* Work out the bit rows of each block, a bit at a time */
+                if(block == 0)
+                    block = MAX((8192 / size) - ((8192 / size) % 8), 128);
+                HDmemset(shuf_data, 0, size * DSET_BITSHUFFLE_NELMTS);
+                for(done = 0; done + 8 <= DSET_BITSHUFFLE_NELMTS; done += block) {
+                    size_t n = MIN(block, DSET_BITSHUFFLE_NELMTS - done);
+
+                    n -= n % 8;
+                    for(e = 0; e < n; e++)
+                        for(b = 0; b < 8 * size; b++)
+                            if((orig_data[((done + e) * size) + (b / 8)] >> (b % 8)) & 1)
+                                shuf_data[(done * size) + (b * (n / 8)) + (e / 8)] |= (unsigned char)(1 << (e % 8));
+                } /* end for */
+                e = (DSET_BITSHUFFLE_NELMTS % 8) * size;
+                HDmemcpy(shuf_data + (DSET_BITSHUFFLE_NELMTS * size) - e, orig_data + (DSET_BITSHUFFLE_NELMTS * size) - e, e);
 
-    PASSED();
+                /* Check the chunk stored */
+                if(H5Dread_chunk(dataset, H5P_DEFAULT, offset, &filter_mask, new_data) < 0)
+                    FAIL_STACK_ERROR
+                if(filter_mask != 0)
+                    TEST_ERROR
+                if(comps[c] == H5Z_BITSHUFFLE_COMP_NONE) {
+                    if(HDmemcmp(new_data, shuf_data, size * DSET_BITSHUFFLE_NELMTS)) {
+                        H5_FAILED();
+                        HDprintf("    Chunk of %u-byte elements bitshuffled differently\n", (unsigned)size);
+                        goto error;
+                    } /* end if */
+                } /* end if */
+                else {
+                    hsize_t chunk_size = H5Dget_storage_size(dataset);
+                    const unsigned char *p = new_data + 12;
+
+                    /* The header, then blocks of compressed bit rows.  Tiny
+                     * blocks may not pay for their size prefix, so only
+                     * check the default size compresses the data. */
+                    if(block_sizes[k] == 0 && chunk_size >= size * DSET_BITSHUFFLE_NELMTS)
+                        TEST_ERROR
+                    if(new_data[6] != (unsigned char)((size * DSET_BITSHUFFLE_NELMTS) >> 8)
+                            || new_data[7] != (unsigned char)(size * DSET_BITSHUFFLE_NELMTS))
+                        TEST_ERROR
+                    if(new_data[10] != (unsigned char)((block * size) >> 8) || new_data[11] != (unsigned char)(block * size))
+                        TEST_ERROR
+                    for(done = 0; done + 8 <= DSET_BITSHUFFLE_NELMTS; done += block)
+                        p += 4 + (((size_t)p[2] << 8) | p[3]);
+                    if((hsize_t)(p - new_data) + (DSET_BITSHUFFLE_NELMTS % 8) * size != chunk_size)
+                        TEST_ERROR
+                } /* end else */
 
-    /*----------------------------------------------------------------------
-     * STEP 2: Try to read the data we just wrote.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    nbit float (read)");
+                /* Check the data read */
+                HDmemset(new_data, 0, size * DSET_BITSHUFFLE_NELMTS);
+                if(H5Dread(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+                    FAIL_STACK_ERROR
+                if(HDmemcmp(new_data, orig_data, size * DSET_BITSHUFFLE_NELMTS)) {
+                    H5_FAILED();
+                    HDprintf("    Read different values than written for %u-byte elements\n", (unsigned)size);
+                    goto error;
+                } /* end if */
 
-    /* Read the dataset back */
-    if(H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
-        FAIL_STACK_ERROR
+                /* Replace the first block of a compressed chunk with garbage */
+                if(comps[c] == H5Z_BITSHUFFLE_COMP_LZ4 && size == 4) {
+                    if(H5Dread_chunk(dataset, H5P_DEFAULT, offset, &filter_mask, new_data) < 0)
+                        FAIL_STACK_ERROR
+                    HDmemset(new_data + 16, 0xf0, (size_t)((new_data[14] << 8) | new_data[15]));
+                    if(H5Dwrite_chunk(dataset, H5P_DEFAULT, filter_mask, offset, (size_t)H5Dget_storage_size(dataset), new_data) < 0)
+                        FAIL_STACK_ERROR
+                    H5E_BEGIN_TRY {
+                        ret = H5Dread(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data);
+                    } H5E_END_TRY;
+                    if(ret >= 0) {
+                        H5_FAILED();
+                        HDprintf("    Read a corrupt chunk\n");
+                        goto error;
+                    } /* end if */
+                } /* end if */
 
-    /* Check that the values read are the same as the values written
-     * Assume size of int = size of float
-     */
-    for(i = 0; i < (size_t)size[0]; i++) {
-        for(j = 0; j < (size_t)size[1]; j++) {
-            if(!(orig_data[i][j] == orig_data[i][j]))
-                continue;  /* skip if value is NaN */
-            if(!H5_FLT_ABS_EQUAL(new_data[i][j], orig_data[i][j])) {
-                H5_FAILED();
-                printf("    Read different values than written.\n");
-                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
-                goto error;
-            }
-        }
-    }
+                if(H5Dclose(dataset) < 0)
+                    FAIL_STACK_ERROR
+                if(H5Pclose(dc) < 0)
+                    FAIL_STACK_ERROR
+                if(H5Tclose(type) < 0)
+                    FAIL_STACK_ERROR
+            } /* end for */
 
-    /*----------------------------------------------------------------------
-     * Cleanup
-     *----------------------------------------------------------------------
-     */
-    if(H5Tclose(datatype) < 0)
+    /* Block sizes must be a multiple of 8 and the compression known */
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
         FAIL_STACK_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5Pset_bitshuffle(dc, 12, H5Z_BITSHUFFLE_COMP_NONE);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        TEST_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5Pset_bitshuffle(dc, 0, 99);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        TEST_ERROR
     if(H5Pclose(dc) < 0)
         FAIL_STACK_ERROR
     if(H5Sclose(space) < 0)
         FAIL_STACK_ERROR
-    if(H5Dclose(dataset) < 0)
-        FAIL_STACK_ERROR
+
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(shuf_data);
 
     PASSED();
 
     return 0;
 
 error:
+    H5E_BEGIN_TRY {
+        H5Dclose(dataset);
+        H5Pclose(dc);
+        H5Sclose(space);
+        H5Tclose(type);
+    } H5E_END_TRY;
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(shuf_data);
+
     return -1;
-}
+} /* end test_bitshuffle() */
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_double
+ * Function:  test_zstd
  *
- * Purpose:     Tests the double datatype of nbit filter
+ * Purpose:   Tests the zstd filter on small chunks of records, with and
+ *            without a dictionary of similar records.  The data read
+ *            must be the data written, the dictionary must make the
+ *            chunks smaller and its key must be stored with the filter.
+ *            Levels above the maximum and dictionaries which aren't
+ *            datasets must be rejected.
  *
- * Return:      Success:        0
- *              Failure:        -1
+ * Return:    Success:    0
+ *            Failure:    -1
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_double(hid_t file)
+test_zstd(hid_t
+#ifndef H5_HAVE_FILTER_ZSTD
+H5_ATTR_UNUSED
+#endif /* H5_HAVE_FILTER_ZSTD */
+file)
 {
-/* assume unsigned int and float has the same number of bytes */
-    hid_t               dataset, datatype, space, dc;
-    const hsize_t       size[2] = {2, 5};
-    const hsize_t       chunk_size[2] = {2, 5};
-    /* orig_data[] are initialized to be within the range that can be represented by
-     * dataset datatype (no precision loss during datatype conversion)
-     */
-    double              orig_data[2][5] = {
-        {
-            H5_DOUBLE(1.6081706885101836e+60),
-            H5_DOUBLE(-255.32099170994480),
-            H5_DOUBLE(1.2677579992621376e-61),
-            H5_DOUBLE(64568.289448797700),
-            H5_DOUBLE(-1.0619721778839084e-75)
-        },
-        {
-            H5_DOUBLE(2.1499497833454840e+56),
-            H5_DOUBLE(6.6562295504670740e-3),
-            H5_DOUBLE(-1.5747263393432150),
-            H5_DOUBLE(1.0711093225222612),
-            H5_DOUBLE(-9.8971679387636870e-1)
-        }};
-    double              new_data[2][5];
-    size_t              precision, offset;
-    size_t             i, j;
+#ifdef H5_HAVE_FILTER_ZSTD
+    hsize_t         nbytes = DSET_ZSTD_NBYTES;
+    hsize_t         chunk = DSET_ZSTD_CHUNK;
+    hsize_t         dict_nbytes = DSET_ZSTD_DICT_NBYTES;
+    hid_t           dataset = -1, space = -1, dict_space = -1, dc = -1, dcpl = -1, group = -1;
+    char            *orig_data = NULL, *new_data = NULL, *dict_data = NULL;
+    hobj_ref_t      dict_ref, group_ref;
+    hsize_t         plain_size, dict_size;
+    unsigned        flags, cd_values[H5Z_ZSTD_TOTAL_NPARMS];
+    size_t          cd_nelmts, n;
+    hid_t           dset_id;
+    herr_t          ret;
+
+    TESTING("zstd filter");
+
+    if(NULL == (orig_data = (char *)HDcalloc(1, DSET_ZSTD_NBYTES)))
+        TEST_ERROR
+    if(NULL == (new_data = (char *)HDcalloc(1, DSET_ZSTD_NBYTES)))
+        TEST_ERROR
+    if(NULL == (dict_data = (char *)HDcalloc(1, DSET_ZSTD_DICT_NBYTES)))
+        TEST_ERROR
 
-    TESTING("    nbit double (setup)");
+    /* Records which repeat across chunks more than within them */
+    for(n = 0; n + 64 <= DSET_ZSTD_NBYTES; n += 64)
+        HDsnprintf(orig_data + n, 64, "{\"station\": %5u, \"reading\": %7.3f, \"ok\": true}  ",
+                (unsigned)((n * 7919) % 65521), (double)(n % 997) / 7.0);
+    for(n = 0; n + 64 <= DSET_ZSTD_DICT_NBYTES; n += 64)
+        HDsnprintf(dict_data + n, 64, "{\"station\": %5u, \"reading\": %7.3f, \"ok\": false} ",
+                (unsigned)(n * 31), (double)n / 3.0);
 
-    /* Define user-defined doule-precision floating-point type for dataset */
-    datatype = H5Tcopy(H5T_IEEE_F64BE);
-    if(H5Tset_fields(datatype, (size_t)55, (size_t)46, (size_t)9, (size_t)5, (size_t)41) < 0)
+    /* Store the dictionary and refer to it */
+    if((dict_space = H5Screate_simple(1, &dict_nbytes, NULL)) < 0)
         FAIL_STACK_ERROR
-    offset = 5;
-    if(H5Tset_offset(datatype,offset) < 0)
+    if((dataset = H5Dcreate2(file, DSET_ZSTD_DICT_NAME, H5T_NATIVE_UCHAR, dict_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
         FAIL_STACK_ERROR
-    precision = 51;
-    if(H5Tset_precision(datatype,precision) < 0)
+    if(H5Dwrite(dataset, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, dict_data) < 0)
         FAIL_STACK_ERROR
-    if(H5Tset_size(datatype, (size_t)8) < 0)
+    if(H5Dclose(dataset) < 0)
         FAIL_STACK_ERROR
-    if(H5Tset_ebias(datatype, (size_t)255) < 0)
+    if(H5Rcreate(&dict_ref, file, DSET_ZSTD_DICT_NAME, H5R_OBJECT, (hid_t)-1) < 0)
         FAIL_STACK_ERROR
 
-    /* Create the data space */
-    if((space = H5Screate_simple(2, size, NULL)) < 0)
+    if((space = H5Screate_simple(1, &nbytes, NULL)) < 0)
         FAIL_STACK_ERROR
 
-    /* Use nbit filter  */
+    /* Write the records with and without the dictionary */
+    for(n = 0; n < 2; n++) {
+        const char *name = n ? DSET_ZSTD_DICT_DATA_NAME : DSET_ZSTD_NAME;
+
+        if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pset_chunk(dc, 1, &chunk) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pset_zstd(dc, 3, n ? &dict_ref : NULL) < 0)
+            FAIL_STACK_ERROR
+        if((dataset = H5Dcreate2(file, name, H5T_NATIVE_UCHAR, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dwrite(dataset, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dclose(dataset) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pclose(dc) < 0)
+            FAIL_STACK_ERROR
+
+        /* Reopen the dataset and check what was stored */
+        if((dataset = H5Dopen2(file, name, H5P_DEFAULT)) < 0)
+            FAIL_STACK_ERROR
+        if((dcpl = H5Dget_create_plist(dataset)) < 0)
+            FAIL_STACK_ERROR
+        cd_nelmts = H5Z_ZSTD_TOTAL_NPARMS;
+        if(H5Pget_filter_by_id2(dcpl, H5Z_FILTER_ZSTD, &flags, &cd_nelmts, cd_values, (size_t)0, NULL, NULL) < 0)
+            FAIL_STACK_ERROR
+        if(cd_nelmts != (n ? H5Z_ZSTD_TOTAL_NPARMS : 1) || cd_values[H5Z_ZSTD_PARM_LEVEL] != 3)
+            TEST_ERROR
+        if(n && (cd_values[H5Z_ZSTD_PARM_DICT_LO] != (unsigned)(dict_ref & 0xffffffff)
+                || cd_values[H5Z_ZSTD_PARM_DICT_HI] != (unsigned)(dict_ref >> 32)))
+            TEST_ERROR
+        if(H5Pclose(dcpl) < 0)
+            FAIL_STACK_ERROR
+
+        HDmemset(new_data, 0, DSET_ZSTD_NBYTES);
+        if(H5Dread(dataset, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+            FAIL_STACK_ERROR
+        if(HDmemcmp(new_data, orig_data, DSET_ZSTD_NBYTES)) {
+            H5_FAILED();
+            HDprintf("    Read different values than written %s a dictionary\n", n ? "with" : "without");
+            goto error;
+        } /* end if */
+        if(n)
+            dict_size = H5Dget_storage_size(dataset);
+        else
+            plain_size = H5Dget_storage_size(dataset);
+        if(H5Dclose(dataset) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+
+    /* The records compress, and better with the dictionary */
+    if(plain_size >= DSET_ZSTD_NBYTES || dict_size >= plain_size) {
+        H5_FAILED();
+        HDprintf("    Stored %lu bytes without a dictionary and %lu bytes with one\n",
+                (unsigned long)plain_size, (unsigned long)dict_size);
+        goto error;
+    } /* end if */
+
+    /* Levels are limited, and dictionaries must be datasets */
     if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
         FAIL_STACK_ERROR
-    if(H5Pset_chunk(dc, 2, chunk_size) < 0)
+    if(H5Pset_chunk(dc, 1, &chunk) < 0)
         FAIL_STACK_ERROR
-    if(H5Pset_nbit(dc) < 0)
+    H5E_BEGIN_TRY {
+        ret = H5Pset_zstd(dc, H5Z_ZSTD_MAX_LEVEL + 1, NULL);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        TEST_ERROR
+    if((group = H5Gcreate2(file, "zstd_group", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Gclose(group) < 0)
+        FAIL_STACK_ERROR
+    if(H5Rcreate(&group_ref, file, "zstd_group", H5R_OBJECT, (hid_t)-1) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_zstd(dc, 1, &group_ref) < 0)
+        FAIL_STACK_ERROR
+    H5E_BEGIN_TRY {
+        dset_id = H5Dcreate2(file, "zstd_bad_dict", H5T_NATIVE_UCHAR, space, H5P_DEFAULT, dc, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dset_id >= 0) {
+        H5Dclose(dset_id);
+        H5_FAILED();
+        HDprintf("    Created a dataset with a group for a dictionary\n");
+        goto error;
+    } /* end if */
+    if(H5Pclose(dc) < 0)
         FAIL_STACK_ERROR
 
-    /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_DOUBLE_NAME, datatype, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+    if(H5Sclose(space) < 0)
         FAIL_STACK_ERROR
+    if(H5Sclose(dict_space) < 0)
+        FAIL_STACK_ERROR
+
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(dict_data);
 
     PASSED();
 
-    /*----------------------------------------------------------------------
-     * STEP 1: Test nbit by setting up a chunked dataset and writing
-     * to it.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    nbit double (write)");
+    return 0;
 
-    if(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
-        FAIL_STACK_ERROR
-    PASSED();
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(dataset);
+        H5Pclose(dc);
+        H5Pclose(dcpl);
+        H5Gclose(group);
+        H5Sclose(space);
+        H5Sclose(dict_space);
+    } H5E_END_TRY;
+    HDfree(orig_data);
+    HDfree(new_data);
+    HDfree(dict_data);
 
-    /*----------------------------------------------------------------------
-     * STEP 2: Try to read the data we just wrote.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    nbit double (read)");
+    return -1;
+#else /* H5_HAVE_FILTER_ZSTD */
+    TESTING("zstd filter");
+    SKIPPED();
+    HDputs("    Zstd filter not enabled");
 
-    /* Read the dataset back */
-    if(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
-        FAIL_STACK_ERROR
-
-    /* Check that the values read are the same as the values written
-     * Assume size of long long = size of double
-     */
-    for(i = 0; i < (size_t)size[0]; i++) {
-        for(j = 0; j < (size_t)size[1]; j++) {
-            if(!(orig_data[i][j] == orig_data[i][j]))
-                continue;  /* skip if value is NaN */
-            if(!H5_DBL_ABS_EQUAL(new_data[i][j], orig_data[i][j])) {
-                H5_FAILED();
-                printf("    Read different values than written.\n");
-                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
-                goto error;
-            }
-        }
-    }
-
-    /*----------------------------------------------------------------------
-     * Cleanup
-     *----------------------------------------------------------------------
-     */
-    if(H5Tclose(datatype) < 0)
-        FAIL_STACK_ERROR
-    if(H5Pclose(dc) < 0)
-        FAIL_STACK_ERROR
-    if(H5Sclose(space) < 0)
-        FAIL_STACK_ERROR
-    if(H5Dclose(dataset) < 0)
-        FAIL_STACK_ERROR
-
-    PASSED();
-
-    return 0;
-
-error:
-    return -1;
-}
+    return 0;
+#endif /* H5_HAVE_FILTER_ZSTD */
+} /* end test_zstd() */
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_array
+ * Function:    test_nbit_int
  *
- * Purpose:     Tests the simple version array datatype for nbit filter
+ * Purpose:     Tests the integer datatype for nbit filter
  *
  * Return:      Success:        0
  *              Failure:        -1
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_array(hid_t file)
+test_nbit_int(hid_t file)
 {
-    hid_t               dataset, base_datatype, array_datatype, space, dc;
-    hid_t               mem_base_datatype, mem_array_datatype;
-    const hsize_t       size[2] = {2, 5};
-    const hsize_t       adims[2] = {3, 2};
-    const hsize_t       chunk_size[2] = {2,5};
-    unsigned int        orig_data[2][5][3][2];
-    unsigned int        new_data[2][5][3][2];
+    hid_t               dataset, datatype, mem_datatype, space, dc;
+    hsize_t             size[2] = {2, 5};
+    hsize_t             chunk_size[2] = {2,5};
+    int                 orig_data[2][5];
+    int                 new_data[2][5];
+    unsigned int        mask;
     size_t              precision, offset;
     double              power;
-    size_t              i, j, m, n;
-
-    TESTING("    nbit array (setup)");
-
-    /* Define dataset array datatype's base datatype and set precision, offset */
-    base_datatype = H5Tcopy(H5T_NATIVE_UINT);
-    precision = 22;
-    if(H5Tset_precision(base_datatype,precision) < 0) goto error;
-    offset = 7;
-    if(H5Tset_offset(base_datatype,offset) < 0) goto error;
+    size_t              i, j;
 
-    /* Copy to memory array datatype's base datatype before setting order */
-    mem_base_datatype = H5Tcopy(base_datatype);
+    puts("Testing nbit filter");
+    TESTING("    nbit int (setup)");
 
-    /* Set order of dataset array datatype's base datatype */
-    if(H5Tset_order(base_datatype, H5T_ORDER_BE) < 0) goto error;
+    /* Define dataset datatype (integer), and set precision, offset */
+    datatype = H5Tcopy(H5T_NATIVE_INT);
+    precision = 17; /* precision includes sign bit */
+    if(H5Tset_precision(datatype,precision) < 0) goto error;
+    offset = 4;
+    if(H5Tset_offset(datatype,offset) < 0) goto error;
 
-    /* Create dataset array datatype */
-    array_datatype = H5Tarray_create2(base_datatype, 2, adims);
+    /* Copy to memory datatype before setting order */
+    mem_datatype = H5Tcopy(datatype);
 
-    /* Create memory array datatype */
-    mem_array_datatype = H5Tarray_create2(mem_base_datatype, 2, adims);
+    /* Set order of dataset datatype */
+    if(H5Tset_order(datatype, H5T_ORDER_BE) < 0) goto error;
 
     /* Create the data space */
     if((space = H5Screate_simple(2, size, NULL)) < 0) goto error;
@@ -3273,18 +3754,20 @@ test_nbit_array(hid_t file)
     if(H5Pset_nbit(dc) < 0) goto error;
 
     /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_ARRAY_NAME, array_datatype,
+    if((dataset = H5Dcreate2(file, DSET_NBIT_INT_NAME, datatype,
                              space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
 
-    /* Initialize data, assuming size of long long >= size of unsigned int */
+    /* Initialize data, assuming size of long long >= size of int */
     for(i= 0;i< (size_t)size[0]; i++)
-      for(j = 0; j < (size_t)size[1]; j++)
-        for(m = 0; m < (size_t)adims[0]; m++)
-          for(n = 0; n < (size_t)adims[1]; n++) {
-            power = HDpow(2.0F, (double)precision);
-            orig_data[i][j][m][n] = (unsigned int)(((long long)HDrandom() %
-                                     (long long)power) << offset);
-          } /* end for */
+        for(j = 0; j < (size_t)size[1]; j++) {
+            power = HDpow(2.0f, (double)(precision - 1));
+            orig_data[i][j] = (int)(((long long)HDrandom() % (long long)power) << offset);
+
+            /* even-numbered values are negtive */
+            if((i*size[1]+j+1)%2 == 0)
+                orig_data[i][j] = -orig_data[i][j];
+        }
+
     PASSED();
 
     /*----------------------------------------------------------------------
@@ -3292,48 +3775,43 @@ test_nbit_array(hid_t file)
      * to it.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit array (write)");
+    TESTING("    nbit int (write)");
 
-    if(H5Dwrite(dataset, mem_array_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                 orig_data) < 0)
+    if(H5Dwrite(dataset, mem_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
         goto error;
-
     PASSED();
 
     /*----------------------------------------------------------------------
      * STEP 2: Try to read the data we just wrote.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit array (read)");
+    TESTING("    nbit int (read)");
 
     /* Read the dataset back */
-    if(H5Dread(dataset, mem_array_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                new_data) < 0)
+    if(H5Dread(dataset, mem_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
         goto error;
 
     /* Check that the values read are the same as the values written
+     * Use mask for checking the significant bits, ignoring the padding bits
      */
-    for(i=0; i<(size_t)size[0]; i++)
-      for(j=0; j<(size_t)size[1]; j++)
-        for(m = 0; m < (size_t)adims[0]; m++)
-          for(n = 0; n < (size_t)adims[1]; n++) {
-            if(new_data[i][j][m][n]!= orig_data[i][j][m][n]) {
+    mask = ~((unsigned)~0 << (precision + offset)) & ((unsigned)~0 << offset);
+    for(i=0; i<(size_t)size[0]; i++) {
+        for(j=0; j<(size_t)size[1]; j++) {
+            if(((unsigned)new_data[i][j] & mask) != ((unsigned)orig_data[i][j] & mask)) {
                 H5_FAILED();
                 printf("    Read different values than written.\n");
-                printf("    At index %lu,%lu,%lu,%lu\n",
-                (unsigned long)i, (unsigned long)j, (unsigned long)m, (unsigned long)n);
+                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
                 goto error;
             }
-          }
+        }
+    }
 
     /*----------------------------------------------------------------------
      * Cleanup
      *----------------------------------------------------------------------
      */
-    if(H5Tclose(array_datatype) < 0) goto error;
-    if(H5Tclose(base_datatype) < 0) goto error;
-    if(H5Tclose(mem_array_datatype) < 0) goto error;
-    if(H5Tclose(mem_base_datatype) < 0) goto error;
+    if(H5Tclose(datatype) < 0) goto error;
+    if(H5Tclose(mem_datatype) < 0) goto error;
     if(H5Pclose(dc) < 0) goto error;
     if(H5Sclose(space) < 0) goto error;
     if(H5Dclose(dataset) < 0) goto error;
@@ -3348,110 +3826,44 @@ error:
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_compound
+ * Function:    test_nbit_float
  *
- * Purpose:     Tests a simple version of compound datatype of nbit filter
+ * Purpose:     Tests the float datatype of nbit filter
  *
  * Return:      Success:        0
- *
  *              Failure:        -1
- *
- * Programmer:  Xiaowen Wu
- *              Tuesday, Jan. 18th, 2005
- *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_compound(hid_t file)
+test_nbit_float(hid_t file)
 {
-    typedef struct {     /* Struct with atomic fields */
-        int i;
-        char c;
-        short s;
-        float f;
-    } atomic;
-    hid_t               i_tid, c_tid, s_tid, f_tid;
-    hid_t               cmpd_tid; /* atomic compound datatype */
-    hid_t               mem_cmpd_tid; /* memory atomic compound datatype */
-    size_t              precision[3] = {15, 7, 10};
-    size_t              offset[3] = {9, 0, 3};
-    hid_t               dataset, space, dc;
+    hid_t               dataset, datatype, space, dc;
     const hsize_t       size[2] = {2, 5};
     const hsize_t       chunk_size[2] = {2, 5};
-    const float         float_val[2][5] = {{188384.0F, 19.103516F, -1.0831790e9F, -84.242188F, 5.2045898F},
-                                           {-49140.0F, 2350.25F, -3.2110596e-1F, 6.4998865e-5F, -0.0F}};
-    atomic              orig_data[2][5];
-    atomic              new_data[2][5];
-    unsigned int        i_mask, s_mask, c_mask;
-    double              power;
+    /* orig_data[] are initialized to be within the range that can be represented by
+     * dataset datatype (no precision loss during datatype conversion)
+     */
+    float               orig_data[2][5] = {{188384.0f, 19.103516f, -1.0831790e9f, -84.242188f, 5.2045898f},
+                                           {-49140.0f, 2350.25f, -3.2110596e-1f, 6.4998865e-5f, -0.0f}};
+    float               new_data[2][5];
+    size_t              precision, offset;
     size_t              i, j;
 
+    TESTING("    nbit float (setup)");
 
-    TESTING("    nbit compound (setup)");
-
-    /* Define datatypes of members of compound datatype */
-    if((i_tid = H5Tcopy(H5T_NATIVE_INT)) < 0)
-        FAIL_STACK_ERROR
-    if((c_tid = H5Tcopy(H5T_NATIVE_CHAR)) < 0)
-        FAIL_STACK_ERROR
-    if((s_tid = H5Tcopy(H5T_NATIVE_SHORT)) < 0)
-        FAIL_STACK_ERROR
-    if((f_tid = H5Tcopy(H5T_IEEE_F32BE)) < 0)
-        FAIL_STACK_ERROR
-
-    /* Set precision and offset etc. */
-    if(H5Tset_precision(i_tid,precision[0]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(i_tid,offset[0]) < 0)
-        FAIL_STACK_ERROR
-
-    if(H5Tset_precision(c_tid,precision[1]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(c_tid,offset[1]) < 0)
-        FAIL_STACK_ERROR
-
-    if(H5Tset_precision(s_tid,precision[2]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(s_tid,offset[2]) < 0)
-        FAIL_STACK_ERROR
-
-    if(H5Tset_fields(f_tid, (size_t)26, (size_t)20, (size_t)6, (size_t)7, (size_t)13) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(f_tid, (size_t)7) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_precision(f_tid, (size_t)20) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_size(f_tid, (size_t)4) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_ebias(f_tid, (size_t)31) < 0)
-        FAIL_STACK_ERROR
-
-    /* Create a memory compound datatype before setting the order */
-    if((mem_cmpd_tid = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid, "i", HOFFSET(atomic, i), i_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid, "c", HOFFSET(atomic, c), c_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid, "s", HOFFSET(atomic, s), s_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid, "f", HOFFSET(atomic, f), H5T_NATIVE_FLOAT) < 0)
-        FAIL_STACK_ERROR
-
-    /* Create a dataset compound datatype and insert some atomic types */
-    if((cmpd_tid = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid, "i", HOFFSET(atomic, i), i_tid) < 0)
+    /* Define user-defined single-precision floating-point type for dataset */
+    datatype = H5Tcopy(H5T_IEEE_F32BE);
+    if(H5Tset_fields(datatype, (size_t)26, (size_t)20, (size_t)6, (size_t)7, (size_t)13) < 0)
         FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid, "c", HOFFSET(atomic, c), c_tid) < 0)
+    offset = 7;
+    if(H5Tset_offset(datatype,offset) < 0)
         FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid, "s", HOFFSET(atomic, s), s_tid) < 0)
+    precision = 20;
+    if(H5Tset_precision(datatype,precision) < 0)
         FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid, "f", HOFFSET(atomic, f), f_tid) < 0)
+    if(H5Tset_size(datatype, (size_t)4) < 0)
         FAIL_STACK_ERROR
-
-    /* Set order of dataset compound datatype */
-    if(H5Tset_order(cmpd_tid, H5T_ORDER_BE) < 0)
+    if(H5Tset_ebias(datatype, (size_t)31) < 0)
         FAIL_STACK_ERROR
 
     /* Create the data space */
@@ -3467,63 +3879,40 @@ test_nbit_compound(hid_t file)
         FAIL_STACK_ERROR
 
     /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_COMPOUND_NAME, cmpd_tid, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+    if((dataset = H5Dcreate2(file, DSET_NBIT_FLOAT_NAME, datatype, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
         FAIL_STACK_ERROR
-
-    /* Initialize data, assuming size of long long >= size of member datatypes */
-    for(i = 0; i < (size_t)size[0]; i++)
-        for(j = 0; j < (size_t)size[1]; j++) {
-            power = HDpow(2.0F, (double)(precision[0]-1));
-            orig_data[i][j].i = (int)(((long long)HDrandom() % (long long)power) << offset[0]);
-            power = HDpow(2.0F, (double)(precision[1]-1));
-            orig_data[i][j].c = (char)(((long long)HDrandom() % (long long)power) << offset[1]);
-            power = HDpow(2.0F, (double)(precision[2]-1));
-            orig_data[i][j].s = (short)(((long long)HDrandom() % (long long)power) << offset[2]);
-            orig_data[i][j].f = float_val[i][j];
-
-            /* some even-numbered integer values are negtive */
-            if((i * size[1] + j + 1) % 2 == 0) {
-                orig_data[i][j].i = -orig_data[i][j].i;
-                orig_data[i][j].s = (short)-orig_data[i][j].s;
-            }
-        }
-
-    PASSED();
+    PASSED();
 
     /*----------------------------------------------------------------------
      * STEP 1: Test nbit by setting up a chunked dataset and writing
      * to it.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit compound (write)");
+    TESTING("    nbit float (write)");
 
-    if(H5Dwrite(dataset, mem_cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+    if(H5Dwrite(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
         FAIL_STACK_ERROR
+
     PASSED();
 
     /*----------------------------------------------------------------------
      * STEP 2: Try to read the data we just wrote.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit compound (read)");
+    TESTING("    nbit float (read)");
 
     /* Read the dataset back */
-    if(H5Dread(dataset, mem_cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+    if(H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
         FAIL_STACK_ERROR
 
     /* Check that the values read are the same as the values written
-     * Use mask for checking the significant bits, ignoring the padding bits
+     * Assume size of int = size of float
      */
-    i_mask = ~((unsigned)~0 << (precision[0] + offset[0])) & ((unsigned)~0 << offset[0]);
-    c_mask = ~((unsigned)~0 << (precision[1] + offset[1])) & ((unsigned)~0 << offset[1]);
-    s_mask = ~((unsigned)~0 << (precision[2] + offset[2])) & ((unsigned)~0 << offset[2]);
-    for(i = 0; i < size[0]; i++) {
-        for(j = 0; j < size[1]; j++) {
-            if(((unsigned)new_data[i][j].i & i_mask) != ((unsigned)orig_data[i][j].i & i_mask) ||
-                ((unsigned)new_data[i][j].c & c_mask) != ((unsigned)orig_data[i][j].c & c_mask) ||
-                ((unsigned)new_data[i][j].s & s_mask) != ((unsigned)orig_data[i][j].s & s_mask) ||
-                (orig_data[i][j].f == orig_data[i][j].f && !H5_FLT_ABS_EQUAL(new_data[i][j].f, orig_data[i][j].f)))
-            {
+    for(i = 0; i < (size_t)size[0]; i++) {
+        for(j = 0; j < (size_t)size[1]; j++) {
+            if(!(orig_data[i][j] == orig_data[i][j]))
+                continue;  /* skip if value is NaN */
+            if(!H5_FLT_ABS_EQUAL(new_data[i][j], orig_data[i][j])) {
                 H5_FAILED();
                 printf("    Read different values than written.\n");
                 printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
@@ -3536,17 +3925,7 @@ test_nbit_compound(hid_t file)
      * Cleanup
      *----------------------------------------------------------------------
      */
-    if(H5Tclose(i_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(c_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(s_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(f_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(cmpd_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(mem_cmpd_tid) < 0)
+    if(H5Tclose(datatype) < 0)
         FAIL_STACK_ERROR
     if(H5Pclose(dc) < 0)
         FAIL_STACK_ERROR
@@ -3565,227 +3944,202 @@ error:
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_compound_2
+ * Function:    test_nbit_double
  *
- * Purpose:     Tests a complex version of compound datatype of nbit filter
+ * Purpose:     Tests the double datatype of nbit filter
  *
  * Return:      Success:        0
- *
  *              Failure:        -1
- *
- * Programmer:  Xiaowen Wu
- *              Tuesday, Jan. 18th, 2005
- *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_compound_2(hid_t file)
+test_nbit_double(hid_t file)
 {
-    typedef struct {     /* Struct with atomic fields */
-        int i;
-        char c;
-        short s;
-        float f;
-    } atomic;
-
-    typedef struct {     /* Struct with complex fields */
-        atomic a;
-        unsigned int v;
-        char   b[2][2];
-        atomic d[2][2];
-    } complex;
-
-    hid_t               i_tid, c_tid, s_tid, f_tid, v_tid;
-    hid_t               cmpd_tid1; /* atomic compound datatype */
-    hid_t               cmpd_tid2; /* complex compound datatype */
-    hid_t               mem_cmpd_tid1; /* memory atomic compound datatype */
-    hid_t               mem_cmpd_tid2; /* memory complex compound datatype */
-    hid_t               base_tid;      /* simple array datatype's base datatype */
-    hid_t               array_tid;     /* simple array datatype */
-    hid_t               array_cmplx_tid;     /* complex array datatype */
-    hid_t               mem_array_cmplx_tid; /* memory complex array datatype */
-    const hsize_t       array_dims[2] = {2, 2};
-    size_t              precision[5] = {31, 8, 10, 23, 8};
-    size_t              offset[5] = {1, 0, 3, 5, 0};
-    hid_t               dataset, space, dc;
+/* assume unsigned int and float has the same number of bytes */
+    hid_t               dataset, datatype, space, dc;
     const hsize_t       size[2] = {2, 5};
     const hsize_t       chunk_size[2] = {2, 5};
-    const float         float_val[2][5] = {{188384.0F, 19.103516F, -1.0831790e9F, -84.242188F, 5.2045898F},
-                                           {-49140.0F, 2350.25F, -3.2110596e-1F, 6.4998865e-5F, -0.0F}};
-    complex             orig_data[2][5];
-    complex             new_data[2][5];
-    unsigned int        i_mask, s_mask, c_mask, b_mask;
-    double              power;
-    size_t              i, j, m, n, b_failed, d_failed;
-
+    /* orig_data[] are initialized to be within the range that can be represented by
+     * dataset datatype (no precision loss during datatype conversion)
+     */
+    double              orig_data[2][5] = {
+        {
+            H5_DOUBLE(1.6081706885101836e+60),
+            H5_DOUBLE(-255.32099170994480),
+            H5_DOUBLE(1.2677579992621376e-61),
+            H5_DOUBLE(64568.289448797700),
+            H5_DOUBLE(-1.0619721778839084e-75)
+        },
+        {
+            H5_DOUBLE(2.1499497833454840e+56),
+            H5_DOUBLE(6.6562295504670740e-3),
+            H5_DOUBLE(-1.5747263393432150),
+            H5_DOUBLE(1.0711093225222612),
+            H5_DOUBLE(-9.8971679387636870e-1)
+        }};
+    double              new_data[2][5];
+    size_t              precision, offset;
+    size_t             i, j;
 
-    TESTING("    nbit compound complex (setup)");
+    TESTING("    nbit double (setup)");
 
-    /* Define datatypes of members of compound datatype */
-    if((i_tid = H5Tcopy(H5T_NATIVE_INT)) < 0)
+    /* Define user-defined doule-precision floating-point type for dataset */
+    datatype = H5Tcopy(H5T_IEEE_F64BE);
+    if(H5Tset_fields(datatype, (size_t)55, (size_t)46, (size_t)9, (size_t)5, (size_t)41) < 0)
         FAIL_STACK_ERROR
-    if((c_tid = H5Tcopy(H5T_NATIVE_CHAR)) < 0)
+    offset = 5;
+    if(H5Tset_offset(datatype,offset) < 0)
         FAIL_STACK_ERROR
-    if((s_tid = H5Tcopy(H5T_NATIVE_SHORT)) < 0)
+    precision = 51;
+    if(H5Tset_precision(datatype,precision) < 0)
         FAIL_STACK_ERROR
-    if((v_tid = H5Tcopy(H5T_NATIVE_UINT)) < 0)
+    if(H5Tset_size(datatype, (size_t)8) < 0)
         FAIL_STACK_ERROR
-    if((f_tid = H5Tcopy(H5T_IEEE_F32BE)) < 0)
+    if(H5Tset_ebias(datatype, (size_t)255) < 0)
         FAIL_STACK_ERROR
 
-    /* Set precision and offset etc. of atomic compound datatype members */
-    if(H5Tset_precision(i_tid,precision[0]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(i_tid,offset[0]) < 0)
+    /* Create the data space */
+    if((space = H5Screate_simple(2, size, NULL)) < 0)
         FAIL_STACK_ERROR
 
-    if(H5Tset_precision(c_tid,precision[1]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(c_tid,offset[1]) < 0)
+    /* Use nbit filter  */
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
         FAIL_STACK_ERROR
-
-    if(H5Tset_precision(s_tid,precision[2]) < 0)
+    if(H5Pset_chunk(dc, 2, chunk_size) < 0)
         FAIL_STACK_ERROR
-    if(H5Tset_offset(s_tid,offset[2]) < 0)
+    if(H5Pset_nbit(dc) < 0)
         FAIL_STACK_ERROR
 
-    if(H5Tset_fields(f_tid, (size_t)26, (size_t)20, (size_t)6, (size_t)7, (size_t)13) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(f_tid, (size_t)7) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_precision(f_tid, (size_t)20) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_size(f_tid, (size_t)4) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_ebias(f_tid, (size_t)31) < 0)
+    /* Create the dataset */
+    if((dataset = H5Dcreate2(file, DSET_NBIT_DOUBLE_NAME, datatype, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
         FAIL_STACK_ERROR
 
-    /* Create a memory atomic compound datatype before setting the order */
-    if((mem_cmpd_tid1 = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid1, "i", HOFFSET(atomic, i), i_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid1, "c", HOFFSET(atomic, c), c_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid1, "s", HOFFSET(atomic, s), s_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid1, "f", HOFFSET(atomic, f), H5T_NATIVE_FLOAT) < 0)
-        FAIL_STACK_ERROR
+    PASSED();
 
-    /* Create a dataset atomic compound datatype and insert some atomic types */
-    if((cmpd_tid1 = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid1, "i", HOFFSET(atomic, i), i_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid1, "c", HOFFSET(atomic, c), c_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid1, "s", HOFFSET(atomic, s), s_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid1, "f", HOFFSET(atomic, f), f_tid) < 0)
-        FAIL_STACK_ERROR
+    /*----------------------------------------------------------------------
+     * STEP 1: Test nbit by setting up a chunked dataset and writing
+     * to it.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    nbit double (write)");
 
-    /* Set order of dataset compound datatype */
-    if(H5Tset_order(cmpd_tid1, H5T_ORDER_BE) < 0)
+    if(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
         FAIL_STACK_ERROR
+    PASSED();
 
-    /* Set precision and offset of the other data member */
-    if(H5Tset_precision(v_tid,precision[3]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(v_tid,offset[3]) < 0)
-        FAIL_STACK_ERROR
+    /*----------------------------------------------------------------------
+     * STEP 2: Try to read the data we just wrote.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    nbit double (read)");
 
-    /* Create the simple array datatype */
-    if((base_tid = H5Tcopy(H5T_NATIVE_CHAR)) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_precision(base_tid,precision[4]) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tset_offset(base_tid,offset[4]) < 0)
-        FAIL_STACK_ERROR
-    if((array_tid = H5Tarray_create2(base_tid, 2, array_dims)) < 0)
+    /* Read the dataset back */
+    if(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
         FAIL_STACK_ERROR
 
-    /* Create the complex memory and dataset array datatype */
-    if((array_cmplx_tid = H5Tarray_create2(cmpd_tid1, 2, array_dims)) < 0)
-        FAIL_STACK_ERROR
-    if((mem_array_cmplx_tid = H5Tarray_create2(mem_cmpd_tid1, 2, array_dims)) < 0)
-        FAIL_STACK_ERROR
+    /* Check that the values read are the same as the values written
+     * Assume size of long long = size of double
+     */
+    for(i = 0; i < (size_t)size[0]; i++) {
+        for(j = 0; j < (size_t)size[1]; j++) {
+            if(!(orig_data[i][j] == orig_data[i][j]))
+                continue;  /* skip if value is NaN */
+            if(!H5_DBL_ABS_EQUAL(new_data[i][j], orig_data[i][j])) {
+                H5_FAILED();
+                printf("    Read different values than written.\n");
+                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
+                goto error;
+            }
+        }
+    }
 
-    /* Create a memory complex compound datatype before setting the order */
-    if((mem_cmpd_tid2 = H5Tcreate(H5T_COMPOUND, sizeof(complex))) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid2, "a", HOFFSET(complex, a), mem_cmpd_tid1) < 0)
+    /*----------------------------------------------------------------------
+     * Cleanup
+     *----------------------------------------------------------------------
+     */
+    if(H5Tclose(datatype) < 0)
         FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid2, "v", HOFFSET(complex, v), v_tid) < 0)
+    if(H5Pclose(dc) < 0)
         FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid2, "b", HOFFSET(complex, b), array_tid) < 0)
+    if(H5Sclose(space) < 0)
         FAIL_STACK_ERROR
-    if(H5Tinsert(mem_cmpd_tid2, "d", HOFFSET(complex, d), mem_array_cmplx_tid) < 0)
+    if(H5Dclose(dataset) < 0)
         FAIL_STACK_ERROR
 
-    /* Set order of dataset other complex compound member datatype */
-    if(H5Tset_order(v_tid, H5T_ORDER_BE) < 0)
-        FAIL_STACK_ERROR
+    PASSED();
 
-    /* Create a dataset complex compound datatype and insert members */
-    if((cmpd_tid2 = H5Tcreate(H5T_COMPOUND, sizeof(complex))) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid2, "a", HOFFSET(complex, a), cmpd_tid1) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid2, "v", HOFFSET(complex, v), v_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid2, "b", HOFFSET(complex, b), array_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tinsert(cmpd_tid2, "d", HOFFSET(complex, d), array_cmplx_tid) < 0)
-        FAIL_STACK_ERROR
+    return 0;
 
-    /* Create the data space */
-    if((space = H5Screate_simple(2, size, NULL)) < 0)
-        FAIL_STACK_ERROR
+error:
+    return -1;
+}
 
-    /* Use nbit filter  */
-    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
-        FAIL_STACK_ERROR
-    if(H5Pset_chunk(dc, 2, chunk_size) < 0)
-        FAIL_STACK_ERROR
-    if(H5Pset_nbit(dc) < 0)
-        FAIL_STACK_ERROR
 
-    /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_COMPOUND_NAME_2, cmpd_tid2, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
-        FAIL_STACK_ERROR
+/*-------------------------------------------------------------------------
+ * Function:    test_nbit_array
+ *
+ * Purpose:     Tests the simple version array datatype for nbit filter
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_nbit_array(hid_t file)
+{
+    hid_t               dataset, base_datatype, array_datatype, space, dc;
+    hid_t               mem_base_datatype, mem_array_datatype;
+    const hsize_t       size[2] = {2, 5};
+    const hsize_t       adims[2] = {3, 2};
+    const hsize_t       chunk_size[2] = {2,5};
+    unsigned int        orig_data[2][5][3][2];
+    unsigned int        new_data[2][5][3][2];
+    size_t              precision, offset;
+    double              power;
+    size_t              i, j, m, n;
 
-    /* Initialize data, assuming size of long long >= size of member datatypes */
-    for(i= 0;i< (size_t)size[0]; i++)
-        for(j = 0; j < (size_t)size[1]; j++) {
-            power = HDpow(2.0F, (double)(precision[0]-1));
-            orig_data[i][j].a.i = (int)(((long long)HDrandom() % (long long)power) << offset[0]);
-            power = HDpow(2.0F, (double)(precision[1]-1));
-            orig_data[i][j].a.c = (char)(((long long)HDrandom() % (long long)power) << offset[1]);
-            power = HDpow(2.0F, (double)(precision[2]-1));
-            orig_data[i][j].a.s = (short)(-((long long)HDrandom() % (long long)power) << offset[2]);
-            orig_data[i][j].a.f = float_val[i][j];
+    TESTING("    nbit array (setup)");
 
-            power = HDpow(2.0F, (double)precision[3]);
-            orig_data[i][j].v = (unsigned int)(((long long)HDrandom() % (long long)power) << offset[3]);
+    /* Define dataset array datatype's base datatype and set precision, offset */
+    base_datatype = H5Tcopy(H5T_NATIVE_UINT);
+    precision = 22;
+    if(H5Tset_precision(base_datatype,precision) < 0) goto error;
+    offset = 7;
+    if(H5Tset_offset(base_datatype,offset) < 0) goto error;
 
-            for(m = 0; m < (size_t)array_dims[0]; m++)
-                for(n = 0; n < (size_t)array_dims[1]; n++) {
-                    power = HDpow(2.0F, (double)(precision[4]-1));
-                    orig_data[i][j].b[m][n] = (char)(((long long)HDrandom() % (long long)power) << offset[4]);
-                } /* end for */
+    /* Copy to memory array datatype's base datatype before setting order */
+    mem_base_datatype = H5Tcopy(base_datatype);
 
-            for(m = 0; m < (size_t)array_dims[0]; m++)
-                for(n = 0; n < (size_t)array_dims[1]; n++) {
-                    power = HDpow(2.0F, (double)(precision[0]-1));
-                    orig_data[i][j].d[m][n].i = (int)(-((long long)HDrandom() % (long long)power) << offset[0]);
-                    power = HDpow(2.0F, (double)(precision[1]-1));
-                    orig_data[i][j].d[m][n].c = (char)(((long long)HDrandom() % (long long)power) << offset[1]);
-                    power = HDpow(2.0F, (double)(precision[2]-1));
-                    orig_data[i][j].d[m][n].s = (short)(((long long)HDrandom() % (long long)power) << offset[2]);
-                    orig_data[i][j].d[m][n].f = float_val[i][j];
-                } /* end for */
-        } /* end for */
+    /* Set order of dataset array datatype's base datatype */
+    if(H5Tset_order(base_datatype, H5T_ORDER_BE) < 0) goto error;
+
+    /* Create dataset array datatype */
+    array_datatype = H5Tarray_create2(base_datatype, 2, adims);
+
+    /* Create memory array datatype */
+    mem_array_datatype = H5Tarray_create2(mem_base_datatype, 2, adims);
+
+    /* Create the data space */
+    if((space = H5Screate_simple(2, size, NULL)) < 0) goto error;
+
+    /* Use nbit filter  */
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    if(H5Pset_chunk(dc, 2, chunk_size) < 0) goto error;
+    if(H5Pset_nbit(dc) < 0) goto error;
 
+    /* Create the dataset */
+    if((dataset = H5Dcreate2(file, DSET_NBIT_ARRAY_NAME, array_datatype,
+                             space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
+
+    /* Initialize data, assuming size of long long >= size of unsigned int */
+    for(i= 0;i< (size_t)size[0]; i++)
+      for(j = 0; j < (size_t)size[1]; j++)
+        for(m = 0; m < (size_t)adims[0]; m++)
+          for(n = 0; n < (size_t)adims[1]; n++) {
+            power = HDpow(2.0F, (double)precision);
+            orig_data[i][j][m][n] = (unsigned int)(((long long)HDrandom() %
+                                     (long long)power) << offset);
+          } /* end for */
     PASSED();
 
     /*----------------------------------------------------------------------
@@ -3793,112 +4147,51 @@ test_nbit_compound_2(hid_t file)
      * to it.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit compound complex (write)");
+    TESTING("    nbit array (write)");
+
+    if(H5Dwrite(dataset, mem_array_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                 orig_data) < 0)
+        goto error;
 
-    if(H5Dwrite(dataset, mem_cmpd_tid2, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
-        FAIL_STACK_ERROR
     PASSED();
 
     /*----------------------------------------------------------------------
      * STEP 2: Try to read the data we just wrote.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit compound complex (read)");
+    TESTING("    nbit array (read)");
 
     /* Read the dataset back */
-    if(H5Dread(dataset, mem_cmpd_tid2, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
-        FAIL_STACK_ERROR
+    if(H5Dread(dataset, mem_array_datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                new_data) < 0)
+        goto error;
 
     /* Check that the values read are the same as the values written
-     * Use mask for checking the significant bits, ignoring the padding bits
-     */
-    /* The original code
-     *   i_mask = ~((unsigned)~0 << (precision[0] + offset[0])) & ((unsigned)~0 << offset[0]);
-     * left shift a 32-bit integer for 32-bit.  The result is undefined by C language.  A user
-     * discovered it using clang compiler with -fcatch-undefined-behavior option (see Issue 7674
-     * in Jira).  So I changed it in a funny way as below to avoid it. SLU - 2011/8/11
      */
-    if(sizeof(unsigned) > 4)
-        i_mask = ~((unsigned)~0 << (precision[0] + offset[0])) & ((unsigned)~0 << offset[0]);
-    else {
-        i_mask = 0xffffffff;
-        i_mask = i_mask & ((unsigned)~0 << offset[0]);
-    }
-    c_mask = ~((unsigned)~0 << (precision[1] + offset[1])) & ((unsigned)~0 << offset[1]);
-    s_mask = ~((unsigned)~0 << (precision[2] + offset[2])) & ((unsigned)~0 << offset[2]);
-    b_mask = ~((unsigned)~0 << (precision[4] + offset[4])) & ((unsigned)~0 << offset[4]);
-    for(i=0; i<(size_t)size[0]; i++) {
-        for(j=0; j<(size_t)size[1]; j++) {
-            b_failed = 0;
-            d_failed = 0;
-
-            for(m = 0; m < (size_t)array_dims[0]; m++)
-            for(n = 0; n < (size_t)array_dims[1]; n++)
-            if(((unsigned)new_data[i][j].b[m][n] & b_mask)!=((unsigned)orig_data[i][j].b[m][n] & b_mask)) {
-                b_failed = 1;
-                goto out;
-            }
-
-            for(m = 0; m < (size_t)array_dims[0]; m++)
-                for(n = 0; n < (size_t)array_dims[1]; n++)
-                    if(((unsigned)new_data[i][j].d[m][n].i & i_mask) != ((unsigned)orig_data[i][j].d[m][n].i & i_mask)||
-                            ((unsigned)new_data[i][j].d[m][n].c & c_mask) != ((unsigned)orig_data[i][j].d[m][n].c & c_mask)||
-                            ((unsigned)new_data[i][j].d[m][n].s & s_mask) != ((unsigned)orig_data[i][j].d[m][n].s & s_mask)||
-                            (new_data[i][j].d[m][n].f == new_data[i][j].d[m][n].f && !H5_FLT_ABS_EQUAL(new_data[i][j].d[m][n].f, new_data[i][j].d[m][n].f))) {
-                        d_failed = 1;
-                        goto out;
-                    }
-
-out:
-            if(((unsigned)new_data[i][j].a.i & i_mask) != ((unsigned)orig_data[i][j].a.i & i_mask)||
-                    ((unsigned)new_data[i][j].a.c & c_mask) != ((unsigned)orig_data[i][j].a.c & c_mask)||
-                    ((unsigned)new_data[i][j].a.s & s_mask) != ((unsigned)orig_data[i][j].a.s & s_mask)||
-                    (new_data[i][j].a.f == new_data[i][j].a.f && !H5_FLT_ABS_EQUAL(new_data[i][j].a.f, new_data[i][j].a.f)) ||
-                    new_data[i][j].v != orig_data[i][j].v || b_failed || d_failed) {
+    for(i=0; i<(size_t)size[0]; i++)
+      for(j=0; j<(size_t)size[1]; j++)
+        for(m = 0; m < (size_t)adims[0]; m++)
+          for(n = 0; n < (size_t)adims[1]; n++) {
+            if(new_data[i][j][m][n]!= orig_data[i][j][m][n]) {
                 H5_FAILED();
                 printf("    Read different values than written.\n");
-                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
+                printf("    At index %lu,%lu,%lu,%lu\n",
+                (unsigned long)i, (unsigned long)j, (unsigned long)m, (unsigned long)n);
                 goto error;
             }
-        }
-    }
+          }
 
     /*----------------------------------------------------------------------
      * Cleanup
      *----------------------------------------------------------------------
      */
-    if(H5Tclose(i_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(c_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(s_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(f_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(v_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(cmpd_tid2) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(cmpd_tid1) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(mem_cmpd_tid2) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(mem_cmpd_tid1) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(array_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(base_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(array_cmplx_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Tclose(mem_array_cmplx_tid) < 0)
-        FAIL_STACK_ERROR
-    if(H5Pclose(dc) < 0)
-        FAIL_STACK_ERROR
-    if(H5Sclose(space) < 0)
-        FAIL_STACK_ERROR
-    if(H5Dclose(dataset) < 0)
-        FAIL_STACK_ERROR
+    if(H5Tclose(array_datatype) < 0) goto error;
+    if(H5Tclose(base_datatype) < 0) goto error;
+    if(H5Tclose(mem_array_datatype) < 0) goto error;
+    if(H5Tclose(mem_base_datatype) < 0) goto error;
+    if(H5Pclose(dc) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
 
     PASSED();
 
@@ -3910,100 +4203,145 @@ error:
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_compound_3
+ * Function:    test_nbit_compound
  *
- * Purpose:     Tests no-op datatypes in compound datatype for nbit filter
+ * Purpose:     Tests a simple version of compound datatype of nbit filter
  *
  * Return:      Success:        0
  *
  *              Failure:        -1
  *
  * Programmer:  Xiaowen Wu
- *              Thursday, Mar. 31th, 2005
+ *              Tuesday, Jan. 18th, 2005
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_compound_3(hid_t file)
+test_nbit_compound(hid_t file)
 {
-    typedef struct {     /* Struct with some no-op type fields */
-        int i;              /* integer field, NOT a no-op type */
-        char str[30];       /* fixed-length string, no-op type */
-        char *vl_str;       /* varible-length string, no-op type */
-        hvl_t v;            /* VL datatype field, no-op type */
-        hobj_ref_t r;       /* Object reference field, no-op type */
-        unsigned char o[5]; /* Opaque field, no-op type */
+    typedef struct {     /* Struct with atomic fields */
+        int i;
+        char c;
+        short s;
+        float f;
     } atomic;
-    hid_t               i_tid, str_tid, vl_str_tid, v_tid, o_tid;
+    hid_t               i_tid, c_tid, s_tid, f_tid;
     hid_t               cmpd_tid; /* atomic compound datatype */
-    hid_t               dataset, space, dc, obj_ref_dataset = -1;
-    const hsize_t       size[1] = {5};
-    const hsize_t       chunk_size[1] = {5};
-    atomic              orig_data[5];
-    atomic              new_data[5];
+    hid_t               mem_cmpd_tid; /* memory atomic compound datatype */
+    size_t              precision[3] = {15, 7, 10};
+    size_t              offset[3] = {9, 0, 3};
+    hid_t               dataset, space, dc;
+    const hsize_t       size[2] = {2, 5};
+    const hsize_t       chunk_size[2] = {2, 5};
+    const float         float_val[2][5] = {{188384.0F, 19.103516F, -1.0831790e9F, -84.242188F, 5.2045898F},
+                                           {-49140.0F, 2350.25F, -3.2110596e-1F, 6.4998865e-5F, -0.0F}};
+    atomic              orig_data[2][5];
+    atomic              new_data[2][5];
+    unsigned int        i_mask, s_mask, c_mask;
     double              power;
-    size_t              i, k, j;
+    size_t              i, j;
 
 
-    TESTING("    nbit compound with no-op type (setup)");
+    TESTING("    nbit compound (setup)");
 
     /* Define datatypes of members of compound datatype */
-    i_tid=H5Tcopy(H5T_NATIVE_INT);
-    if(H5Tset_precision(i_tid, (size_t)17) < 0) goto error;
+    if((i_tid = H5Tcopy(H5T_NATIVE_INT)) < 0)
+        FAIL_STACK_ERROR
+    if((c_tid = H5Tcopy(H5T_NATIVE_CHAR)) < 0)
+        FAIL_STACK_ERROR
+    if((s_tid = H5Tcopy(H5T_NATIVE_SHORT)) < 0)
+        FAIL_STACK_ERROR
+    if((f_tid = H5Tcopy(H5T_IEEE_F32BE)) < 0)
+        FAIL_STACK_ERROR
 
-    str_tid=H5Tcopy(H5T_C_S1);
-    if(H5Tset_size(str_tid, (size_t)30) < 0) goto error;
+    /* Set precision and offset etc. */
+    if(H5Tset_precision(i_tid,precision[0]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(i_tid,offset[0]) < 0)
+        FAIL_STACK_ERROR
 
-    vl_str_tid = H5Tcopy(H5T_C_S1);
-    if(H5Tset_size(vl_str_tid,H5T_VARIABLE) < 0) goto error;
+    if(H5Tset_precision(c_tid,precision[1]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(c_tid,offset[1]) < 0)
+        FAIL_STACK_ERROR
 
-    if((v_tid = H5Tvlen_create(H5T_NATIVE_UINT)) < 0) goto error;
+    if(H5Tset_precision(s_tid,precision[2]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(s_tid,offset[2]) < 0)
+        FAIL_STACK_ERROR
 
-    if((o_tid = H5Tcreate(H5T_OPAQUE, (size_t)5)) < 0) goto error;
-    if(H5Tset_tag(o_tid, "testing opaque field") < 0) goto error;
+    if(H5Tset_fields(f_tid, (size_t)26, (size_t)20, (size_t)6, (size_t)7, (size_t)13) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(f_tid, (size_t)7) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_precision(f_tid, (size_t)20) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_size(f_tid, (size_t)4) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_ebias(f_tid, (size_t)31) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create a memory compound datatype before setting the order */
+    if((mem_cmpd_tid = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid, "i", HOFFSET(atomic, i), i_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid, "c", HOFFSET(atomic, c), c_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid, "s", HOFFSET(atomic, s), s_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid, "f", HOFFSET(atomic, f), H5T_NATIVE_FLOAT) < 0)
+        FAIL_STACK_ERROR
 
     /* Create a dataset compound datatype and insert some atomic types */
-    cmpd_tid = H5Tcreate(H5T_COMPOUND, sizeof(atomic));
-    if(H5Tinsert(cmpd_tid, "i", HOFFSET(atomic, i), i_tid) < 0) goto error;
-    if(H5Tinsert(cmpd_tid, "str", HOFFSET(atomic, str), str_tid) < 0) goto error;
-    if(H5Tinsert(cmpd_tid, "vl_str", HOFFSET(atomic, vl_str), vl_str_tid) < 0) goto error;
-    if(H5Tinsert(cmpd_tid, "v", HOFFSET(atomic, v), v_tid) < 0) goto error;
-    if(H5Tinsert(cmpd_tid, "r", HOFFSET(atomic, r), H5T_STD_REF_OBJ) < 0) goto error;
-    if(H5Tinsert(cmpd_tid, "o", HOFFSET(atomic, o), o_tid) < 0) goto error;
+    if((cmpd_tid = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid, "i", HOFFSET(atomic, i), i_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid, "c", HOFFSET(atomic, c), c_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid, "s", HOFFSET(atomic, s), s_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid, "f", HOFFSET(atomic, f), f_tid) < 0)
+        FAIL_STACK_ERROR
+
+    /* Set order of dataset compound datatype */
+    if(H5Tset_order(cmpd_tid, H5T_ORDER_BE) < 0)
+        FAIL_STACK_ERROR
 
     /* Create the data space */
-    if((space = H5Screate_simple(1, size, NULL)) < 0) goto error;
+    if((space = H5Screate_simple(2, size, NULL)) < 0)
+        FAIL_STACK_ERROR
 
     /* Use nbit filter  */
-    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
-    if(H5Pset_chunk(dc, 1, chunk_size) < 0) goto error;
-    if(H5Pset_nbit(dc) < 0) goto error;
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk(dc, 2, chunk_size) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_nbit(dc) < 0)
+        FAIL_STACK_ERROR
 
     /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_NBIT_COMPOUND_NAME_3, cmpd_tid,
-                             space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
-
-    /* Create the dataset object reference points to */
-    if((obj_ref_dataset = H5Dcreate2(file, "nbit_obj_ref", H5T_NATIVE_INT,
-                                     space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) goto error;
-
-    /* Initialize data */
-    for(i = 0; i < (size_t)size[0]; i++) {
-        power = HDpow(2.0F, 17.0F - 1.0F);
-        HDmemset(&orig_data[i], 0, sizeof(orig_data[i]));
-        orig_data[i].i = (int)(HDrandom() % (long)power);
-        HDstrcpy(orig_data[i].str, "fixed-length C string");
-        orig_data[i].vl_str = HDstrdup("variable-length C string");
-
-        orig_data[i].v.p = HDmalloc((size_t)(i+1)*sizeof(unsigned int));
-        orig_data[i].v.len = (size_t)i+1;
-        for(k = 0; k < (i+1); k++) ((unsigned int *)orig_data[i].v.p)[k] = (unsigned int)(i*100 + k);
+    if((dataset = H5Dcreate2(file, DSET_NBIT_COMPOUND_NAME, cmpd_tid, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
 
-        /* Create reference to the dataset "nbit_obj_ref" */
-        if(H5Rcreate(&orig_data[i].r, file, "nbit_obj_ref", H5R_OBJECT, (hid_t)-1) < 0) goto error;
+    /* Initialize data, assuming size of long long >= size of member datatypes */
+    for(i = 0; i < (size_t)size[0]; i++)
+        for(j = 0; j < (size_t)size[1]; j++) {
+            power = HDpow(2.0F, (double)(precision[0]-1));
+            orig_data[i][j].i = (int)(((long long)HDrandom() % (long long)power) << offset[0]);
+            power = HDpow(2.0F, (double)(precision[1]-1));
+            orig_data[i][j].c = (char)(((long long)HDrandom() % (long long)power) << offset[1]);
+            power = HDpow(2.0F, (double)(precision[2]-1));
+            orig_data[i][j].s = (short)(((long long)HDrandom() % (long long)power) << offset[2]);
+            orig_data[i][j].f = float_val[i][j];
 
-        for(j = 0; j < 5; j++) orig_data[i].o[j] = (unsigned char)(i + j);
-    }
+            /* some even-numbered integer values are negtive */
+            if((i * size[1] + j + 1) % 2 == 0) {
+                orig_data[i][j].i = -orig_data[i][j].i;
+                orig_data[i][j].s = (short)-orig_data[i][j].s;
+            }
+        }
 
     PASSED();
 
@@ -4012,73 +4350,65 @@ test_nbit_compound_3(hid_t file)
      * to it.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit compound with no-op type (write)");
+    TESTING("    nbit compound (write)");
 
-    if(H5Dwrite(dataset, cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                 orig_data) < 0)
-        goto error;
+    if(H5Dwrite(dataset, mem_cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+        FAIL_STACK_ERROR
     PASSED();
 
     /*----------------------------------------------------------------------
      * STEP 2: Try to read the data we just wrote.
      *----------------------------------------------------------------------
      */
-    TESTING("    nbit compound with no-op type (read)");
+    TESTING("    nbit compound (read)");
 
     /* Read the dataset back */
-    if(H5Dread(dataset, cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                new_data) < 0)
-        goto error;
-
-    /* Check that the values read are the same as the values written */
-    for(i = 0; i < (size_t)size[0]; i++) {
-        if(new_data[i].i != orig_data[i].i ||
-           strcmp(new_data[i].str, orig_data[i].str) !=0 ||
-           strcmp(new_data[i].vl_str, orig_data[i].vl_str) !=0 ||
-           new_data[i].v.len != orig_data[i].v.len ||
-           new_data[i].r != orig_data[i].r)
-        {
-            H5_FAILED();
-            printf("    Read different values than written.\n");
-            printf("    At index %lu\n", (unsigned long)i);
-            goto error;
-        }
-
-        for(k=0; k<i+1; k++)
-            if(((unsigned int *)orig_data[i].v.p)[k] !=((unsigned int *)new_data[i].v.p)[k])
-            {
-                H5_FAILED();
-                printf("    Read different values than written.\n");
-                printf("    At index %lu\n", (unsigned long)i);
-                goto error;
-            }
+    if(H5Dread(dataset, mem_cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+        FAIL_STACK_ERROR
 
-        for(j=0; j<5; j++)
-            if(orig_data[i].o[j] != new_data[i].o[j])
+    /* Check that the values read are the same as the values written
+     * Use mask for checking the significant bits, ignoring the padding bits
+     */
+    i_mask = ~((unsigned)~0 << (precision[0] + offset[0])) & ((unsigned)~0 << offset[0]);
+    c_mask = ~((unsigned)~0 << (precision[1] + offset[1])) & ((unsigned)~0 << offset[1]);
+    s_mask = ~((unsigned)~0 << (precision[2] + offset[2])) & ((unsigned)~0 << offset[2]);
+    for(i = 0; i < size[0]; i++) {
+        for(j = 0; j < size[1]; j++) {
+            if(((unsigned)new_data[i][j].i & i_mask) != ((unsigned)orig_data[i][j].i & i_mask) ||
+                ((unsigned)new_data[i][j].c & c_mask) != ((unsigned)orig_data[i][j].c & c_mask) ||
+                ((unsigned)new_data[i][j].s & s_mask) != ((unsigned)orig_data[i][j].s & s_mask) ||
+                (orig_data[i][j].f == orig_data[i][j].f && !H5_FLT_ABS_EQUAL(new_data[i][j].f, orig_data[i][j].f)))
             {
                 H5_FAILED();
                 printf("    Read different values than written.\n");
-                printf("    At index %lu\n", (unsigned long)i);
+                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
                 goto error;
             }
+        }
     }
 
     /*----------------------------------------------------------------------
      * Cleanup
      *----------------------------------------------------------------------
      */
-    if(H5Dvlen_reclaim(cmpd_tid, space, H5P_DEFAULT, new_data) < 0) goto error;
-    if(H5Dvlen_reclaim(cmpd_tid, space, H5P_DEFAULT, orig_data) < 0) goto error;
-    if(H5Tclose(i_tid) < 0) goto error;
-    if(H5Tclose(str_tid) < 0) goto error;
-    if(H5Tclose(vl_str_tid) < 0) goto error;
-    if(H5Tclose(v_tid) < 0) goto error;
-    if(H5Tclose(o_tid) < 0) goto error;
-    if(H5Tclose(cmpd_tid) < 0) goto error;
-    if(H5Pclose(dc) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Dclose(obj_ref_dataset) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
+    if(H5Tclose(i_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(c_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(s_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(f_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(cmpd_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(mem_cmpd_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(dc) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(space) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dclose(dataset) < 0)
+        FAIL_STACK_ERROR
 
     PASSED();
 
@@ -4090,45 +4420,570 @@ error:
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_nbit_int_size
+ * Function:    test_nbit_compound_2
  *
- * Purpose:     Tests the correct size of the integer datatype for nbit filter
+ * Purpose:     Tests a complex version of compound datatype of nbit filter
  *
  * Return:      Success:        0
  *
  *              Failure:        -1
  *
- * Programmer:  Raymond Lu
- *              19 November 2010
+ * Programmer:  Xiaowen Wu
+ *              Tuesday, Jan. 18th, 2005
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_nbit_int_size(hid_t file)
+test_nbit_compound_2(hid_t file)
 {
-    hid_t   dataspace, dataset, datatype, mem_datatype, dset_create_props;
-    hsize_t dims[2], chunk_size[2];
-    hsize_t dset_size = 0;
-    int     orig_data[DSET_DIM1][DSET_DIM2];
-    double  power;
-    int     i, j;
-    size_t  precision, offset;
-
-    TESTING("    nbit integer dataset size");
+    typedef struct {     /* Struct with atomic fields */
+        int i;
+        char c;
+        short s;
+        float f;
+    } atomic;
 
-   /* Define dataset datatype (integer), and set precision, offset */
-   if((datatype = H5Tcopy(H5T_NATIVE_INT)) < 0) {
-       H5_FAILED();
-       printf("    line %d: H5Tcopy failed\n",__LINE__);
-       goto error;
-   } /* end if */
+    typedef struct {     /* Struct with complex fields */
+        atomic a;
+        unsigned int v;
+        char   b[2][2];
+        atomic d[2][2];
+    } complex;
 
-   precision = 16; /* precision includes sign bit */
-   if(H5Tset_precision(datatype,precision)<0) {
-       H5_FAILED();
-       printf("    line %d: H5Pset_precision failed\n",__LINE__);
-       goto error;
-   } /* end if */
+    hid_t               i_tid, c_tid, s_tid, f_tid, v_tid;
+    hid_t               cmpd_tid1; /* atomic compound datatype */
+    hid_t               cmpd_tid2; /* complex compound datatype */
+    hid_t               mem_cmpd_tid1; /* memory atomic compound datatype */
+    hid_t               mem_cmpd_tid2; /* memory complex compound datatype */
+    hid_t               base_tid;      /* simple array datatype's base datatype */
+    hid_t               array_tid;     /* simple array datatype */
+    hid_t               array_cmplx_tid;     /* complex array datatype */
+    hid_t               mem_array_cmplx_tid; /* memory complex array datatype */
+    const hsize_t       array_dims[2] = {2, 2};
+    size_t              precision[5] = {31, 8, 10, 23, 8};
+    size_t              offset[5] = {1, 0, 3, 5, 0};
+    hid_t               dataset, space, dc;
+    const hsize_t       size[2] = {2, 5};
+    const hsize_t       chunk_size[2] = {2, 5};
+    const float         float_val[2][5] = {{188384.0F, 19.103516F, -1.0831790e9F, -84.242188F, 5.2045898F},
+                                           {-49140.0F, 2350.25F, -3.2110596e-1F, 6.4998865e-5F, -0.0F}};
+    complex             orig_data[2][5];
+    complex             new_data[2][5];
+    unsigned int        i_mask, s_mask, c_mask, b_mask;
+    double              power;
+    size_t              i, j, m, n, b_failed, d_failed;
+
+
+    TESTING("    nbit compound complex (setup)");
+
+    /* Define datatypes of members of compound datatype */
+    if((i_tid = H5Tcopy(H5T_NATIVE_INT)) < 0)
+        FAIL_STACK_ERROR
+    if((c_tid = H5Tcopy(H5T_NATIVE_CHAR)) < 0)
+        FAIL_STACK_ERROR
+    if((s_tid = H5Tcopy(H5T_NATIVE_SHORT)) < 0)
+        FAIL_STACK_ERROR
+    if((v_tid = H5Tcopy(H5T_NATIVE_UINT)) < 0)
+        FAIL_STACK_ERROR
+    if((f_tid = H5Tcopy(H5T_IEEE_F32BE)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Set precision and offset etc. of atomic compound datatype members */
+    if(H5Tset_precision(i_tid,precision[0]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(i_tid,offset[0]) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Tset_precision(c_tid,precision[1]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(c_tid,offset[1]) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Tset_precision(s_tid,precision[2]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(s_tid,offset[2]) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Tset_fields(f_tid, (size_t)26, (size_t)20, (size_t)6, (size_t)7, (size_t)13) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(f_tid, (size_t)7) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_precision(f_tid, (size_t)20) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_size(f_tid, (size_t)4) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_ebias(f_tid, (size_t)31) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create a memory atomic compound datatype before setting the order */
+    if((mem_cmpd_tid1 = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid1, "i", HOFFSET(atomic, i), i_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid1, "c", HOFFSET(atomic, c), c_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid1, "s", HOFFSET(atomic, s), s_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid1, "f", HOFFSET(atomic, f), H5T_NATIVE_FLOAT) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create a dataset atomic compound datatype and insert some atomic types */
+    if((cmpd_tid1 = H5Tcreate(H5T_COMPOUND, sizeof(atomic))) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid1, "i", HOFFSET(atomic, i), i_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid1, "c", HOFFSET(atomic, c), c_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid1, "s", HOFFSET(atomic, s), s_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid1, "f", HOFFSET(atomic, f), f_tid) < 0)
+        FAIL_STACK_ERROR
+
+    /* Set order of dataset compound datatype */
+    if(H5Tset_order(cmpd_tid1, H5T_ORDER_BE) < 0)
+        FAIL_STACK_ERROR
+
+    /* Set precision and offset of the other data member */
+    if(H5Tset_precision(v_tid,precision[3]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(v_tid,offset[3]) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create the simple array datatype */
+    if((base_tid = H5Tcopy(H5T_NATIVE_CHAR)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_precision(base_tid,precision[4]) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tset_offset(base_tid,offset[4]) < 0)
+        FAIL_STACK_ERROR
+    if((array_tid = H5Tarray_create2(base_tid, 2, array_dims)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create the complex memory and dataset array datatype */
+    if((array_cmplx_tid = H5Tarray_create2(cmpd_tid1, 2, array_dims)) < 0)
+        FAIL_STACK_ERROR
+    if((mem_array_cmplx_tid = H5Tarray_create2(mem_cmpd_tid1, 2, array_dims)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create a memory complex compound datatype before setting the order */
+    if((mem_cmpd_tid2 = H5Tcreate(H5T_COMPOUND, sizeof(complex))) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid2, "a", HOFFSET(complex, a), mem_cmpd_tid1) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid2, "v", HOFFSET(complex, v), v_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid2, "b", HOFFSET(complex, b), array_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(mem_cmpd_tid2, "d", HOFFSET(complex, d), mem_array_cmplx_tid) < 0)
+        FAIL_STACK_ERROR
+
+    /* Set order of dataset other complex compound member datatype */
+    if(H5Tset_order(v_tid, H5T_ORDER_BE) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create a dataset complex compound datatype and insert members */
+    if((cmpd_tid2 = H5Tcreate(H5T_COMPOUND, sizeof(complex))) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid2, "a", HOFFSET(complex, a), cmpd_tid1) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid2, "v", HOFFSET(complex, v), v_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid2, "b", HOFFSET(complex, b), array_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tinsert(cmpd_tid2, "d", HOFFSET(complex, d), array_cmplx_tid) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create the data space */
+    if((space = H5Screate_simple(2, size, NULL)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Use nbit filter  */
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk(dc, 2, chunk_size) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_nbit(dc) < 0)
+        FAIL_STACK_ERROR
+
+    /* Create the dataset */
+    if((dataset = H5Dcreate2(file, DSET_NBIT_COMPOUND_NAME_2, cmpd_tid2, space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Initialize data, assuming size of long long >= size of member datatypes */
+    for(i= 0;i< (size_t)size[0]; i++)
+        for(j = 0; j < (size_t)size[1]; j++) {
+            power = HDpow(2.0F, (double)(precision[0]-1));
+            orig_data[i][j].a.i = (int)(((long long)HDrandom() % (long long)power) << offset[0]);
+            power = HDpow(2.0F, (double)(precision[1]-1));
+            orig_data[i][j].a.c = (char)(((long long)HDrandom() % (long long)power) << offset[1]);
+            power = HDpow(2.0F, (double)(precision[2]-1));
+            orig_data[i][j].a.s = (short)(-((long long)HDrandom() % (long long)power) << offset[2]);
+            orig_data[i][j].a.f = float_val[i][j];
+
+            power = HDpow(2.0F, (double)precision[3]);
+            orig_data[i][j].v = (unsigned int)(((long long)HDrandom() % (long long)power) << offset[3]);
+
+            for(m = 0; m < (size_t)array_dims[0]; m++)
+                for(n = 0; n < (size_t)array_dims[1]; n++) {
+                    power = HDpow(2.0F, (double)(precision[4]-1));
+                    orig_data[i][j].b[m][n] = (char)(((long long)HDrandom() % (long long)power) << offset[4]);
+                } /* end for */
+
+            for(m = 0; m < (size_t)array_dims[0]; m++)
+                for(n = 0; n < (size_t)array_dims[1]; n++) {
+                    power = HDpow(2.0F, (double)(precision[0]-1));
+                    orig_data[i][j].d[m][n].i = (int)(-((long long)HDrandom() % (long long)power) << offset[0]);
+                    power = HDpow(2.0F, (double)(precision[1]-1));
+                    orig_data[i][j].d[m][n].c = (char)(((long long)HDrandom() % (long long)power) << offset[1]);
+                    power = HDpow(2.0F, (double)(precision[2]-1));
+                    orig_data[i][j].d[m][n].s = (short)(((long long)HDrandom() % (long long)power) << offset[2]);
+                    orig_data[i][j].d[m][n].f = float_val[i][j];
+                } /* end for */
+        } /* end for */
+
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 1: Test nbit by setting up a chunked dataset and writing
+     * to it.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    nbit compound complex (write)");
+
+    if(H5Dwrite(dataset, mem_cmpd_tid2, H5S_ALL, H5S_ALL, H5P_DEFAULT, orig_data) < 0)
+        FAIL_STACK_ERROR
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 2: Try to read the data we just wrote.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    nbit compound complex (read)");
+
+    /* Read the dataset back */
+    if(H5Dread(dataset, mem_cmpd_tid2, H5S_ALL, H5S_ALL, H5P_DEFAULT, new_data) < 0)
+        FAIL_STACK_ERROR
+
+    /* Check that the values read are the same as the values written
+     * Use mask for checking the significant bits, ignoring the padding bits
+     */
+    /* The original code
+     *   i_mask = ~((unsigned)~0 << (precision[0] + offset[0])) & ((unsigned)~0 << offset[0]);
+     * left shift a 32-bit integer for 32-bit.  The result is undefined by C language.  A user
+     * discovered it using clang compiler with -fcatch-undefined-behavior option (see Issue 7674
+     * in Jira).  So I changed it in a funny way as below to avoid it. SLU - 2011/8/11
+     */
+    if(sizeof(unsigned) > 4)
+        i_mask = ~((unsigned)~0 << (precision[0] + offset[0])) & ((unsigned)~0 << offset[0]);
+    else {
+        i_mask = 0xffffffff;
+        i_mask = i_mask & ((unsigned)~0 << offset[0]);
+    }
+    c_mask = ~((unsigned)~0 << (precision[1] + offset[1])) & ((unsigned)~0 << offset[1]);
+    s_mask = ~((unsigned)~0 << (precision[2] + offset[2])) & ((unsigned)~0 << offset[2]);
+    b_mask = ~((unsigned)~0 << (precision[4] + offset[4])) & ((unsigned)~0 << offset[4]);
+    for(i=0; i<(size_t)size[0]; i++) {
+        for(j=0; j<(size_t)size[1]; j++) {
+            b_failed = 0;
+            d_failed = 0;
+
+            for(m = 0; m < (size_t)array_dims[0]; m++)
+            for(n = 0; n < (size_t)array_dims[1]; n++)
+            if(((unsigned)new_data[i][j].b[m][n] & b_mask)!=((unsigned)orig_data[i][j].b[m][n] & b_mask)) {
+                b_failed = 1;
+                goto out;
+            }
+
+            for(m = 0; m < (size_t)array_dims[0]; m++)
+                for(n = 0; n < (size_t)array_dims[1]; n++)
+                    if(((unsigned)new_data[i][j].d[m][n].i & i_mask) != ((unsigned)orig_data[i][j].d[m][n].i & i_mask)||
+                            ((unsigned)new_data[i][j].d[m][n].c & c_mask) != ((unsigned)orig_data[i][j].d[m][n].c & c_mask)||
+                            ((unsigned)new_data[i][j].d[m][n].s & s_mask) != ((unsigned)orig_data[i][j].d[m][n].s & s_mask)||
+                            (new_data[i][j].d[m][n].f == new_data[i][j].d[m][n].f && !H5_FLT_ABS_EQUAL(new_data[i][j].d[m][n].f, new_data[i][j].d[m][n].f))) {
+                        d_failed = 1;
+                        goto out;
+                    }
+
+out:
+            if(((unsigned)new_data[i][j].a.i & i_mask) != ((unsigned)orig_data[i][j].a.i & i_mask)||
+                    ((unsigned)new_data[i][j].a.c & c_mask) != ((unsigned)orig_data[i][j].a.c & c_mask)||
+                    ((unsigned)new_data[i][j].a.s & s_mask) != ((unsigned)orig_data[i][j].a.s & s_mask)||
+                    (new_data[i][j].a.f == new_data[i][j].a.f && !H5_FLT_ABS_EQUAL(new_data[i][j].a.f, new_data[i][j].a.f)) ||
+                    new_data[i][j].v != orig_data[i][j].v || b_failed || d_failed) {
+                H5_FAILED();
+                printf("    Read different values than written.\n");
+                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
+                goto error;
+            }
+        }
+    }
+
+    /*----------------------------------------------------------------------
+     * Cleanup
+     *----------------------------------------------------------------------
+     */
+    if(H5Tclose(i_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(c_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(s_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(f_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(v_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(cmpd_tid2) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(cmpd_tid1) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(mem_cmpd_tid2) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(mem_cmpd_tid1) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(array_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(base_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(array_cmplx_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Tclose(mem_array_cmplx_tid) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(dc) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(space) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dclose(dataset) < 0)
+        FAIL_STACK_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_nbit_compound_3
+ *
+ * Purpose:     Tests no-op datatypes in compound datatype for nbit filter
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Xiaowen Wu
+ *              Thursday, Mar. 31th, 2005
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_nbit_compound_3(hid_t file)
+{
+    typedef struct {     /* Struct with some no-op type fields */
+        int i;              /* integer field, NOT a no-op type */
+        char str[30];       /* fixed-length string, no-op type */
+        char *vl_str;       /* varible-length string, no-op type */
+        hvl_t v;            /* VL datatype field, no-op type */
+        hobj_ref_t r;       /* Object reference field, no-op type */
+        unsigned char o[5]; /* Opaque field, no-op type */
+    } atomic;
+    hid_t               i_tid, str_tid, vl_str_tid, v_tid, o_tid;
+    hid_t               cmpd_tid; /* atomic compound datatype */
+    hid_t               dataset, space, dc, obj_ref_dataset = -1;
+    const hsize_t       size[1] = {5};
+    const hsize_t       chunk_size[1] = {5};
+    atomic              orig_data[5];
+    atomic              new_data[5];
+    double              power;
+    size_t              i, k, j;
+
+
+    TESTING("    nbit compound with no-op type (setup)");
+
+    /* Define datatypes of members of compound datatype */
+    i_tid=H5Tcopy(H5T_NATIVE_INT);
+    if(H5Tset_precision(i_tid, (size_t)17) < 0) goto error;
+
+    str_tid=H5Tcopy(H5T_C_S1);
+    if(H5Tset_size(str_tid, (size_t)30) < 0) goto error;
+
+    vl_str_tid = H5Tcopy(H5T_C_S1);
+    if(H5Tset_size(vl_str_tid,H5T_VARIABLE) < 0) goto error;
+
+    if((v_tid = H5Tvlen_create(H5T_NATIVE_UINT)) < 0) goto error;
+
+    if((o_tid = H5Tcreate(H5T_OPAQUE, (size_t)5)) < 0) goto error;
+    if(H5Tset_tag(o_tid, "testing opaque field") < 0) goto error;
+
+    /* Create a dataset compound datatype and insert some atomic types */
+    cmpd_tid = H5Tcreate(H5T_COMPOUND, sizeof(atomic));
+    if(H5Tinsert(cmpd_tid, "i", HOFFSET(atomic, i), i_tid) < 0) goto error;
+    if(H5Tinsert(cmpd_tid, "str", HOFFSET(atomic, str), str_tid) < 0) goto error;
+    if(H5Tinsert(cmpd_tid, "vl_str", HOFFSET(atomic, vl_str), vl_str_tid) < 0) goto error;
+    if(H5Tinsert(cmpd_tid, "v", HOFFSET(atomic, v), v_tid) < 0) goto error;
+    if(H5Tinsert(cmpd_tid, "r", HOFFSET(atomic, r), H5T_STD_REF_OBJ) < 0) goto error;
+    if(H5Tinsert(cmpd_tid, "o", HOFFSET(atomic, o), o_tid) < 0) goto error;
+
+    /* Create the data space */
+    if((space = H5Screate_simple(1, size, NULL)) < 0) goto error;
+
+    /* Use nbit filter  */
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    if(H5Pset_chunk(dc, 1, chunk_size) < 0) goto error;
+    if(H5Pset_nbit(dc) < 0) goto error;
+
+    /* Create the dataset */
+    if((dataset = H5Dcreate2(file, DSET_NBIT_COMPOUND_NAME_3, cmpd_tid,
+                             space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
+
+    /* Create the dataset object reference points to */
+    if((obj_ref_dataset = H5Dcreate2(file, "nbit_obj_ref", H5T_NATIVE_INT,
+                                     space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) goto error;
+
+    /* Initialize data */
+    for(i = 0; i < (size_t)size[0]; i++) {
+        power = HDpow(2.0F, 17.0F - 1.0F);
+        HDmemset(&orig_data[i], 0, sizeof(orig_data[i]));
+        orig_data[i].i = (int)(HDrandom() % (long)power);
+        HDstrcpy(orig_data[i].str, "fixed-length C string");
+        orig_data[i].vl_str = HDstrdup("variable-length C string");
+
+        orig_data[i].v.p = HDmalloc((size_t)(i+1)*sizeof(unsigned int));
+        orig_data[i].v.len = (size_t)i+1;
+        for(k = 0; k < (i+1); k++) ((unsigned int *)orig_data[i].v.p)[k] = (unsigned int)(i*100 + k);
+
+        /* Create reference to the dataset "nbit_obj_ref" */
+        if(H5Rcreate(&orig_data[i].r, file, "nbit_obj_ref", H5R_OBJECT, (hid_t)-1) < 0) goto error;
+
+        for(j = 0; j < 5; j++) orig_data[i].o[j] = (unsigned char)(i + j);
+    }
+
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 1: Test nbit by setting up a chunked dataset and writing
+     * to it.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    nbit compound with no-op type (write)");
+
+    if(H5Dwrite(dataset, cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                 orig_data) < 0)
+        goto error;
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 2: Try to read the data we just wrote.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    nbit compound with no-op type (read)");
+
+    /* Read the dataset back */
+    if(H5Dread(dataset, cmpd_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                new_data) < 0)
+        goto error;
+
+    /* Check that the values read are the same as the values written */
+    for(i = 0; i < (size_t)size[0]; i++) {
+        if(new_data[i].i != orig_data[i].i ||
+           strcmp(new_data[i].str, orig_data[i].str) !=0 ||
+           strcmp(new_data[i].vl_str, orig_data[i].vl_str) !=0 ||
+           new_data[i].v.len != orig_data[i].v.len ||
+           new_data[i].r != orig_data[i].r)
+        {
+            H5_FAILED();
+            printf("    Read different values than written.\n");
+            printf("    At index %lu\n", (unsigned long)i);
+            goto error;
+        }
+
+        for(k=0; k<i+1; k++)
+            if(((unsigned int *)orig_data[i].v.p)[k] !=((unsigned int *)new_data[i].v.p)[k])
+            {
+                H5_FAILED();
+                printf("    Read different values than written.\n");
+                printf("    At index %lu\n", (unsigned long)i);
+                goto error;
+            }
+
+        for(j=0; j<5; j++)
+            if(orig_data[i].o[j] != new_data[i].o[j])
+            {
+                H5_FAILED();
+                printf("    Read different values than written.\n");
+                printf("    At index %lu\n", (unsigned long)i);
+                goto error;
+            }
+    }
+
+    /*----------------------------------------------------------------------
+     * Cleanup
+     *----------------------------------------------------------------------
+     */
+    if(H5Dvlen_reclaim(cmpd_tid, space, H5P_DEFAULT, new_data) < 0) goto error;
+    if(H5Dvlen_reclaim(cmpd_tid, space, H5P_DEFAULT, orig_data) < 0) goto error;
+    if(H5Tclose(i_tid) < 0) goto error;
+    if(H5Tclose(str_tid) < 0) goto error;
+    if(H5Tclose(vl_str_tid) < 0) goto error;
+    if(H5Tclose(v_tid) < 0) goto error;
+    if(H5Tclose(o_tid) < 0) goto error;
+    if(H5Tclose(cmpd_tid) < 0) goto error;
+    if(H5Pclose(dc) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Dclose(obj_ref_dataset) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
+
+    PASSED();
+
+    return 0;
+
+error:
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_nbit_int_size
+ *
+ * Purpose:     Tests the correct size of the integer datatype for nbit filter
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Raymond Lu
+ *              19 November 2010
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_nbit_int_size(hid_t file)
+{
+    hid_t   dataspace, dataset, datatype, mem_datatype, dset_create_props;
+    hsize_t dims[2], chunk_size[2];
+    hsize_t dset_size = 0;
+    int     orig_data[DSET_DIM1][DSET_DIM2];
+    double  power;
+    int     i, j;
+    size_t  precision, offset;
+
+    TESTING("    nbit integer dataset size");
+
+   /* Define dataset datatype (integer), and set precision, offset */
+   if((datatype = H5Tcopy(H5T_NATIVE_INT)) < 0) {
+       H5_FAILED();
+       printf("    line %d: H5Tcopy failed\n",__LINE__);
+       goto error;
+   } /* end if */
+
+   precision = 16; /* precision includes sign bit */
+   if(H5Tset_precision(datatype,precision)<0) {
+       H5_FAILED();
+       printf("    line %d: H5Pset_precision failed\n",__LINE__);
+       goto error;
+   } /* end if */
 
    offset = 8;
    if(H5Tset_offset(datatype,offset)<0) {
@@ -4997,388 +5852,941 @@ test_scaleoffset_double(hid_t file)
 
     PASSED();
 
-    /*----------------------------------------------------------------------
-     * STEP 1: Test scaleoffset by setting up a chunked dataset and writing
-     * to it.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    scaleoffset double without fill value, D-scaling (write)");
+    /*----------------------------------------------------------------------
+     * STEP 1: Test scaleoffset by setting up a chunked dataset and writing
+     * to it.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    scaleoffset double without fill value, D-scaling (write)");
+
+    if(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                 orig_data) < 0) goto error;
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 2: Try to read the data we just wrote.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    scaleoffset double without fill value, D-scaling (read)");
+
+    /* Read the dataset back */
+    if(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                new_data) < 0) goto error;
+
+    /* Check that the values read are the same as the values written */
+    for(i=0; i<(size_t)size[0]; i++) {
+        for(j=0; j<(size_t)size[1]; j++) {
+            if(HDfabs(new_data[i][j]-orig_data[i][j]) > HDpow(10.0F, -7.0F)) {
+                H5_FAILED();
+                printf("    Read different values than written.\n");
+                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
+                goto error;
+            }
+        }
+    }
+
+    /*----------------------------------------------------------------------
+     * Cleanup
+     *----------------------------------------------------------------------
+     */
+    if(H5Tclose(datatype) < 0) goto error;
+    if(H5Pclose(dc) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
+
+    PASSED();
+
+    return 0;
+error:
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_scaleoffset_double_2
+ *
+ * Purpose:     Tests the double datatype for scaleoffset filter, with fill
+ *              value set, using variable-minimum-bits method
+ *
+ * Return:      Success:        0
+ *
+ *              Failure:        -1
+ *
+ * Programmer:  Xiaowen Wu
+ *              Monday, Apr. 25th, 2005
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_scaleoffset_double_2(hid_t file)
+{
+    hid_t               dataset, datatype, space, mspace, dc;
+    const hsize_t       size[2] = {2, 5};
+    const hsize_t       chunk_size[2] = {2,5};
+    double              orig_data[2][5];
+    double              new_data[2][5];
+    double              fillval;
+    hsize_t             start[2];  /* Start of hyperslab */
+    hsize_t             stride[2]; /* Stride of hyperslab */
+    hsize_t             count[2];  /* Block count */
+    hsize_t             block[2];  /* Block sizes */
+    size_t              j;
+
+    TESTING("    scaleoffset double with fill value, D-scaling (setup)");
+
+    datatype = H5Tcopy(H5T_NATIVE_DOUBLE);
+
+    /* Set order of dataset datatype */
+    if(H5Tset_order(datatype, H5T_ORDER_BE) < 0) goto error;
+
+    /* Create the data space for the dataset */
+    if((space = H5Screate_simple(2, size, NULL)) < 0) goto error;
+
+    /* Create the dataset property list  */
+    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+
+    /* Set fill value */
+    fillval = 10000.0F;
+    if(H5Pset_fill_value(dc, H5T_NATIVE_DOUBLE, &fillval) < 0) goto error;
+
+    /* Set up to use scaleoffset filter, decimal scale factor is 7,
+     * use variable-minimum-bits method
+     */
+    if(H5Pset_chunk(dc, 2, chunk_size) < 0) goto error;
+    if(H5Pset_scaleoffset(dc, H5Z_SO_FLOAT_DSCALE,7) < 0) goto error;
+
+    /* Create the dataset */
+    if((dataset = H5Dcreate2(file, DSET_SCALEOFFSET_DOUBLE_NAME_2, datatype,
+                             space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
+
+    /* Create the memory data space */
+    if((mspace = H5Screate_simple(2, size, NULL)) < 0) goto error;
+
+    /* Select hyperslab for data to write, using 1x5 blocks,
+     * (1,1) stride and (1,1) count starting at the position (0,0).
+     */
+    start[0]  = 0; start[1]  = 0;
+    stride[0] = 1; stride[1] = 1;
+    count[0]  = 1; count[1]  = 1;
+    block[0]  = 1; block[1]  = 5;
+    if(H5Sselect_hyperslab(mspace, H5S_SELECT_SET, start,
+                           stride, count, block) < 0) goto error;
+
+    /* Initialize data of hyperslab */
+    for(j = 0; j < (size_t)size[1]; j++) {
+        orig_data[0][j] = (float)(HDrandom() % 10000000) / 10000000.0F;
+
+        /* even-numbered values are negtive */
+        if((j + 1) % 2 == 0)
+            orig_data[0][j] = -orig_data[0][j];
+    }
+
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 1: Test scaleoffset by setting up a chunked dataset and writing
+     * to it.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    scaleoffset double with fill value, D-scaling (write)");
+
+    /* only data in the hyperslab will be written, other value should be fill value */
+    if(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, mspace, mspace, H5P_DEFAULT,
+                 orig_data) < 0) goto error;
+    PASSED();
+
+    /*----------------------------------------------------------------------
+     * STEP 2: Try to read the data we just wrote.
+     *----------------------------------------------------------------------
+     */
+    TESTING("    scaleoffset double with fill value, D-scaling (read)");
+
+    /* Read the dataset back */
+    if(H5Dread(dataset, H5T_NATIVE_DOUBLE, mspace, mspace, H5P_DEFAULT,
+                new_data) < 0) goto error;
+
+    /* Check that the values read are the same as the values written */
+    for(j=0; j<(size_t)size[1]; j++) {
+        if(HDfabs(new_data[0][j]-orig_data[0][j]) > HDpow(10.0F, -7.0F)) {
+            H5_FAILED();
+            printf("    Read different values than written.\n");
+            printf("    At index %lu,%lu\n", (unsigned long)0, (unsigned long)j);
+            goto error;
+        }
+    }
+
+    /*----------------------------------------------------------------------
+     * Cleanup
+     *----------------------------------------------------------------------
+     */
+    if(H5Tclose(datatype) < 0) goto error;
+    if(H5Pclose(dc) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
+
+    PASSED();
+
+    return 0;
+error:
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_multiopen
+ *
+ * Purpose:     Tests that a bug no longer exists.  If a dataset is opened
+ *              twice and one of the handles is used to extend the dataset,
+ *              then the other handle should return the new size when
+ *              queried.
+ *
+ * Return:      Success:    0
+ *
+ *              Failure:    -1
+ *
+ * Programmer:  Robb Matzke
+ *              Tuesday, June  9, 1998
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_multiopen (hid_t file)
+{
+    hid_t   dcpl = -1, space = -1, dset1 = -1, dset2 = -1;
+    hsize_t cur_size[1] = {10};
+    hsize_t tmp_size[1];
+    static hsize_t max_size[1] = {H5S_UNLIMITED};
+
+    TESTING("multi-open with extending");
+
+    /* Create the dataset and open it twice */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    if(H5Pset_chunk(dcpl, 1, cur_size) < 0) goto error;
+    if((space = H5Screate_simple(1, cur_size, max_size)) < 0) goto error;
+    if((dset1 = H5Dcreate2(file, "multiopen", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) goto error;
+    if((dset2 = H5Dopen2(dset1, ".", H5P_DEFAULT)) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+
+    /* Extend with the first handle */
+    cur_size[0] = 20;
+    if(H5Dset_extent(dset1, cur_size) < 0) goto error;
+
+    /* Get the size from the second handle */
+    if((space = H5Dget_space(dset2)) < 0) goto error;
+    if(H5Sget_simple_extent_dims(space, tmp_size, NULL) < 0) goto error;
+    if(cur_size[0] != tmp_size[0]) {
+        H5_FAILED();
+        printf("    Got %d instead of %d!\n", (int)tmp_size[0], (int)cur_size[0]);
+        goto error;
+    } /* end if */
+
+    if(H5Dclose(dset1) < 0) goto error;
+    if(H5Dclose(dset2) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Pclose(dcpl) < 0) goto error;
+
+    PASSED();
+    return 0;
+
+ error:
+    H5E_BEGIN_TRY {
+    H5Dclose(dset1);
+    H5Dclose(dset2);
+    H5Sclose(space);
+    H5Pclose(dcpl);
+    } H5E_END_TRY;
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_types
+ *
+ * Purpose:    Make some datasets with various types so we can test h5ls.
+ *
+ * Return:    Success:    0
+ *
+ *        Failure:    -1
+ *
+ * Programmer:    Robb Matzke
+ *              Monday, June  7, 1999
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_types(hid_t file)
+{
+    hid_t        grp=-1, type=-1, space=-1, dset=-1;
+    size_t        i;
+    hsize_t        nelmts;
+    unsigned char    buf[32];
+
+    TESTING("various datatypes");
+    if((grp = H5Gcreate2(file, "typetests", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) goto error;
 
-    if(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                 orig_data) < 0) goto error;
-    PASSED();
+    /* bitfield_1 */
+    nelmts = sizeof(buf);
+    if((type=H5Tcopy(H5T_STD_B8LE)) < 0 ||
+    (space=H5Screate_simple(1, &nelmts, NULL)) < 0 ||
+    (dset=H5Dcreate2(grp, "bitfield_1", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+    goto error;
+    for(i=0; i<sizeof buf; i++) buf[i] = (unsigned char)0xff ^ (unsigned char)i;
+    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+    goto error;
 
-    /*----------------------------------------------------------------------
-     * STEP 2: Try to read the data we just wrote.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    scaleoffset double without fill value, D-scaling (read)");
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Tclose(type) < 0) goto error;
+    if(H5Dclose(dset) < 0) goto error;
 
-    /* Read the dataset back */
-    if(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                new_data) < 0) goto error;
+    /* bitfield_2 */
+    nelmts = sizeof(buf)/2;
+    if((type=H5Tcopy(H5T_STD_B16LE)) < 0 ||
+    (space=H5Screate_simple(1, &nelmts, NULL)) < 0 ||
+    (dset=H5Dcreate2(grp, "bitfield_2", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+    goto error;
+    for(i=0; i<sizeof buf; i++) buf[i] = (unsigned char)0xff ^ (unsigned char)i;
+    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+    goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Tclose(type) < 0) goto error;
+    if(H5Dclose(dset) < 0) goto error;
 
-    /* Check that the values read are the same as the values written */
-    for(i=0; i<(size_t)size[0]; i++) {
-        for(j=0; j<(size_t)size[1]; j++) {
-            if(HDfabs(new_data[i][j]-orig_data[i][j]) > HDpow(10.0F, -7.0F)) {
-                H5_FAILED();
-                printf("    Read different values than written.\n");
-                printf("    At index %lu,%lu\n", (unsigned long)i, (unsigned long)j);
-                goto error;
-            }
-        }
-    }
+    /* opaque_1 */
+    nelmts = sizeof(buf);
+    if((type = H5Tcreate(H5T_OPAQUE, (size_t)1)) < 0 ||
+            H5Tset_tag(type, "testing 1-byte opaque type") < 0 ||
+            (space = H5Screate_simple(1, &nelmts, NULL)) < 0 ||
+            (dset = H5Dcreate2(grp, "opaque_1", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+    goto error;
+    for(i = 0; i < sizeof buf; i++)
+        buf[i] = (unsigned char)0xff ^ (unsigned char)i;
+    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) goto error;
+    if(H5Sclose(space) < 0) goto error;
+    if(H5Tclose(type) < 0) goto error;
+    if(H5Dclose(dset) < 0) goto error;
 
-    /*----------------------------------------------------------------------
-     * Cleanup
-     *----------------------------------------------------------------------
-     */
-    if(H5Tclose(datatype) < 0) goto error;
-    if(H5Pclose(dc) < 0) goto error;
+    /* opaque_2 */
+    nelmts = sizeof(buf)/4;
+    if((type = H5Tcreate(H5T_OPAQUE, (size_t)4)) < 0 ||
+            H5Tset_tag(type, "testing 4-byte opaque type") < 0 ||
+            (space = H5Screate_simple(1, &nelmts, NULL)) < 0 ||
+            (dset = H5Dcreate2(grp, "opaque_2", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+    goto error;
+    for(i = 0; i < sizeof buf; i++)
+        buf[i] = (unsigned char)0xff ^ (unsigned char)i;
+    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) goto error;
     if(H5Sclose(space) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
+    if(H5Tclose(type) < 0) goto error;
+    if(H5Dclose(dset) < 0) goto error;
 
+    /* Cleanup */
+    if(H5Gclose(grp) < 0) goto error;
     PASSED();
-
     return 0;
-error:
+
+ error:
+    H5E_BEGIN_TRY {
+    H5Gclose(grp);
+    H5Tclose(type);
+    H5Sclose(space);
+    H5Dclose(dset);
+    } H5E_END_TRY;
     return -1;
 }
 
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_CAN_APPLY_TEST[1] = {{
+    H5Z_CLASS_T_VERS,
+    H5Z_FILTER_CAN_APPLY_TEST,    /* Filter id number        */
+    1, 1,
+    "can_apply_test",        /* Filter name for debugging    */
+    can_apply_bogus,            /* The "can apply" callback     */
+    NULL,                       /* The "set local" callback     */
+    filter_bogus,        /* The actual filter function    */
+}};
+
 
 /*-------------------------------------------------------------------------
- * Function:    test_scaleoffset_double_2
- *
- * Purpose:     Tests the double datatype for scaleoffset filter, with fill
- *              value set, using variable-minimum-bits method
+ * Function:    test_can_apply
  *
- * Return:      Success:        0
+ * Purpose:    Tests library behavior when filter indicates it can't
+ *              apply to certain combinations of creation parameters.
+ *              The filter is mandate.  If the CAN_APPLY callback function
+ *              indicates wrong datatype, the dataset creation should fail.
  *
- *              Failure:        -1
+ * Return:    Success:    0
+ *        Failure:    -1
  *
- * Programmer:  Xiaowen Wu
- *              Monday, Apr. 25th, 2005
+ * Programmer:    Quincey Koziol
+ *              Friday, April  5, 2003
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_scaleoffset_double_2(hid_t file)
+test_can_apply(hid_t file)
 {
-    hid_t               dataset, datatype, space, mspace, dc;
-    const hsize_t       size[2] = {2, 5};
-    const hsize_t       chunk_size[2] = {2,5};
-    double              orig_data[2][5];
-    double              new_data[2][5];
-    double              fillval;
-    hsize_t             start[2];  /* Start of hyperslab */
-    hsize_t             stride[2]; /* Stride of hyperslab */
-    hsize_t             count[2];  /* Block count */
-    hsize_t             block[2];  /* Block sizes */
-    size_t              j;
-
-    TESTING("    scaleoffset double with fill value, D-scaling (setup)");
-
-    datatype = H5Tcopy(H5T_NATIVE_DOUBLE);
-
-    /* Set order of dataset datatype */
-    if(H5Tset_order(datatype, H5T_ORDER_BE) < 0) goto error;
+    hid_t       dsid;           /* Dataset ID */
+    hid_t       sid;            /* Dataspace ID */
+    hid_t       dcpl;           /* Dataspace creation property list ID */
+    const hsize_t dims[2] = {DSET_DIM1, DSET_DIM2};         /* Dataspace dimensions */
+    const hsize_t chunk_dims[2] = {2, 25};      /* Chunk dimensions */
+    hsize_t     dset_size;      /* Dataset size */
+    size_t      i,j;            /* Local index variables */
 
-    /* Create the data space for the dataset */
-    if((space = H5Screate_simple(2, size, NULL)) < 0) goto error;
+    TESTING("dataset filter 'can apply' callback");
 
-    /* Create the dataset property list  */
-    if((dc = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    /* Create dcpl with special filter */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't create dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
+    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
+        goto error;
+    } /* end if */
+    if(H5Zregister (H5Z_CAN_APPLY_TEST) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't register 'can apply' filter\n",__LINE__);
+        goto error;
+    }
+    /* The filter is mandate. */
+    if(H5Pset_filter(dcpl, H5Z_FILTER_CAN_APPLY_TEST, 0, (size_t)0, NULL) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set bogus filter\n",__LINE__);
+        goto error;
+    }
 
-    /* Set fill value */
-    fillval = 10000.0F;
-    if(H5Pset_fill_value(dc, H5T_NATIVE_DOUBLE, &fillval) < 0) goto error;
+    /* Create the data space */
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't open dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* Set up to use scaleoffset filter, decimal scale factor is 7,
-     * use variable-minimum-bits method
-     */
-    if(H5Pset_chunk(dc, 2, chunk_size) < 0) goto error;
-    if(H5Pset_scaleoffset(dc, H5Z_SO_FLOAT_DSCALE,7) < 0) goto error;
+    /* Create new dataset */
+    /* (Should fail because the 'can apply' function should indicate inappropriate
+     * combination.  And the filter is mandate.) */
+    H5E_BEGIN_TRY {
+        dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dsid >=0) {
+        H5_FAILED();
+        printf("    Line %d: Shouldn't have created dataset!\n",__LINE__);
+        H5Dclose(dsid);
+        goto error;
+    } /* end if */
 
-    /* Create the dataset */
-    if((dataset = H5Dcreate2(file, DSET_SCALEOFFSET_DOUBLE_NAME_2, datatype,
-                             space, H5P_DEFAULT, dc, H5P_DEFAULT)) < 0) goto error;
+    /* (Should fail because the 'can apply' function should fail) */
+    H5E_BEGIN_TRY {
+        dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME, H5T_NATIVE_FLOAT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dsid >=0) {
+        H5_FAILED();
+        printf("    Line %d: Shouldn't have created dataset!\n",__LINE__);
+        H5Dclose(dsid);
+        goto error;
+    } /* end if */
 
-    /* Create the memory data space */
-    if((mspace = H5Screate_simple(2, size, NULL)) < 0) goto error;
+    /* Create new dataset */
+    if((dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't create dataset\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* Select hyperslab for data to write, using 1x5 blocks,
-     * (1,1) stride and (1,1) count starting at the position (0,0).
-     */
-    start[0]  = 0; start[1]  = 0;
-    stride[0] = 1; stride[1] = 1;
-    count[0]  = 1; count[1]  = 1;
-    block[0]  = 1; block[1]  = 5;
-    if(H5Sselect_hyperslab(mspace, H5S_SELECT_SET, start,
-                           stride, count, block) < 0) goto error;
+    /* Write data */
+    if(H5Dwrite(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, points) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Error writing dataset data\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* Initialize data of hyperslab */
-    for(j = 0; j < (size_t)size[1]; j++) {
-        orig_data[0][j] = (float)(HDrandom() % 10000000) / 10000000.0F;
+    /* Flush the file (to clear the cache) */
+    if(H5Fflush(file, H5F_SCOPE_GLOBAL) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Error flushing file\n",__LINE__);
+        goto error;
+    } /* end if */
 
-        /* even-numbered values are negtive */
-        if((j + 1) % 2 == 0)
-            orig_data[0][j] = -orig_data[0][j];
-    }
+    /* Query the dataset's size on disk */
+    if((dset_size=H5Dget_storage_size(dsid))==0) {
+        H5_FAILED();
+        printf("    Line %d: Error querying dataset size\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    PASSED();
+    /* Verify that the size indicates data is uncompressed */
+    if((H5Tget_size(H5T_NATIVE_INT)*dims[0]*dims[1])!=dset_size) {
+        H5_FAILED();
+        printf("    Line %d: Incorrect dataset size: %lu\n",__LINE__,(unsigned long)dset_size);
+        goto error;
+    } /* end if */
 
-    /*----------------------------------------------------------------------
-     * STEP 1: Test scaleoffset by setting up a chunked dataset and writing
-     * to it.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    scaleoffset double with fill value, D-scaling (write)");
+    /* Read data */
+    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, check) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Error reading dataset data\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* only data in the hyperslab will be written, other value should be fill value */
-    if(H5Dwrite(dataset, H5T_NATIVE_DOUBLE, mspace, mspace, H5P_DEFAULT,
-                 orig_data) < 0) goto error;
-    PASSED();
+    /* Compare data */
+    /* Check that the values read are the same as the values written */
+    for(i=0; i<(size_t)dims[0]; i++) {
+    for(j=0; j<(size_t)dims[1]; j++) {
+        if(points[i][j] != check[i][j]) {
+        H5_FAILED();
+        printf("    Line %d: Read different values than written.\n",__LINE__);
+        printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
+        printf("    At original: %d\n",points[i][j]);
+        printf("    At returned: %d\n",check[i][j]);
+        goto error;
+        } /* end if */
+    } /* end for */
+    } /* end for */
 
-    /*----------------------------------------------------------------------
-     * STEP 2: Try to read the data we just wrote.
-     *----------------------------------------------------------------------
-     */
-    TESTING("    scaleoffset double with fill value, D-scaling (read)");
+    /* Close dataset */
+    if(H5Dclose(dsid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataset\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* Read the dataset back */
-    if(H5Dread(dataset, H5T_NATIVE_DOUBLE, mspace, mspace, H5P_DEFAULT,
-                new_data) < 0) goto error;
+    /* Close dataspace */
+    if(H5Sclose(sid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* Check that the values read are the same as the values written */
-    for(j=0; j<(size_t)size[1]; j++) {
-        if(HDfabs(new_data[0][j]-orig_data[0][j]) > HDpow(10.0F, -7.0F)) {
-            H5_FAILED();
-            printf("    Read different values than written.\n");
-            printf("    At index %lu,%lu\n", (unsigned long)0, (unsigned long)j);
-            goto error;
-        }
-    }
+    /* Close dataset creation property list */
+    if(H5Pclose(dcpl) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /*----------------------------------------------------------------------
-     * Cleanup
-     *----------------------------------------------------------------------
-     */
-    if(H5Tclose(datatype) < 0) goto error;
-    if(H5Pclose(dc) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
 
     PASSED();
-
     return 0;
+
 error:
     return -1;
-}
+} /* end test_can_apply() */
+
+/* This message derives from H5Z */
+const H5Z_class2_t H5Z_CAN_APPLY_TEST2[1] = {{
+    H5Z_CLASS_T_VERS,
+    H5Z_FILTER_CAN_APPLY_TEST2,    /* Filter id number        */
+    1, 1,
+    "can_apply_test",        /* Filter name for debugging    */
+    can_apply_bogus,            /* The "can apply" callback     */
+    NULL,                       /* The "set local" callback     */
+    filter_bogus3,        /* The actual filter function    */
+}};
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_multiopen
- *
- * Purpose:     Tests that a bug no longer exists.  If a dataset is opened
- *              twice and one of the handles is used to extend the dataset,
- *              then the other handle should return the new size when
- *              queried.
+ * Function:    test_can_apply2
  *
- * Return:      Success:    0
+ * Purpose:    Tests library behavior when an optional filter indicates
+ *              it can't apply to certain combinations of creation
+ *              parameters.  The filter function FILTER_BOGUS3 does nothing
+ *              than returning a failure.  Because the filter is optional,
+ *              the library skips the filter even though the CAN_APPLY_BOGUS
+ *              indicates the datatype DOUBLE can't apply to the dataset.
  *
- *              Failure:    -1
+ * Return:    Success:    0
+ *        Failure:    -1
  *
- * Programmer:  Robb Matzke
- *              Tuesday, June  9, 1998
+ * Programmer:    Raymond Lu
+ *              4 August 2010
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_multiopen (hid_t file)
+test_can_apply2(hid_t file)
 {
-    hid_t   dcpl = -1, space = -1, dset1 = -1, dset2 = -1;
-    hsize_t cur_size[1] = {10};
-    hsize_t tmp_size[1];
-    static hsize_t max_size[1] = {H5S_UNLIMITED};
+    hid_t       dsid;           /* Dataset ID */
+    hid_t       sid;            /* Dataspace ID */
+    hid_t       dcpl;           /* Dataspace creation property list ID */
+    const hsize_t dims[2] = {DSET_DIM1, DSET_DIM2};         /* Dataspace dimensions */
+    const hsize_t chunk_dims[2] = {2, 25};      /* Chunk dimensions */
+    hsize_t     dset_size;      /* Dataset size */
+    size_t      i,j;            /* Local index variables */
 
-    TESTING("multi-open with extending");
+    TESTING("dataset filter 'can apply' callback second");
 
-    /* Create the dataset and open it twice */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
-    if(H5Pset_chunk(dcpl, 1, cur_size) < 0) goto error;
-    if((space = H5Screate_simple(1, cur_size, max_size)) < 0) goto error;
-    if((dset1 = H5Dcreate2(file, "multiopen", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) goto error;
-    if((dset2 = H5Dopen2(dset1, ".", H5P_DEFAULT)) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
+    /* Create dcpl with special filter */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't create dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
+    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
+        goto error;
+    } /* end if */
+    if(H5Zregister (H5Z_CAN_APPLY_TEST2) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't register 'can apply' filter\n",__LINE__);
+        goto error;
+    }
+    /* The filter is optional. */
+    if(H5Pset_filter(dcpl, H5Z_FILTER_CAN_APPLY_TEST2, H5Z_FLAG_OPTIONAL, (size_t)0, NULL) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set bogus filter\n",__LINE__);
+        goto error;
+    }
 
-    /* Extend with the first handle */
-    cur_size[0] = 20;
-    if(H5Dset_extent(dset1, cur_size) < 0) goto error;
+    /* Create the data space */
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't open dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Create new dataset */
+    if((dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME2, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't create dataset\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Write data */
+    if(H5Dwrite(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, points) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Error writing dataset data\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Flush the file (to clear the cache) */
+    if(H5Fflush(file, H5F_SCOPE_GLOBAL) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Error flushing file\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Query the dataset's size on disk */
+    if((dset_size=H5Dget_storage_size(dsid))==0) {
+        H5_FAILED();
+        printf("    Line %d: Error querying dataset size\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Verify that the size indicates data is uncompressed */
+    if((H5Tget_size(H5T_NATIVE_DOUBLE)*dims[0]*dims[1])!=dset_size) {
+        H5_FAILED();
+        printf("    Line %d: Incorrect dataset size: %lu\n",__LINE__,(unsigned long)dset_size);
+        goto error;
+    } /* end if */
+
+    /* Read data */
+    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, check) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Error reading dataset data\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Compare data */
+    /* Check that the values read are the same as the values written */
+    for(i=0; i<(size_t)dims[0]; i++) {
+    for(j=0; j<(size_t)dims[1]; j++) {
+        if(points[i][j] != check[i][j]) {
+        H5_FAILED();
+        printf("    Line %d: Read different values than written.\n",__LINE__);
+        printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
+        printf("    At original: %d\n",points[i][j]);
+        printf("    At returned: %d\n",check[i][j]);
+        goto error;
+        } /* end if */
+    } /* end for */
+    } /* end for */
+
+    /* Close dataset */
+    if(H5Dclose(dsid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataset\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Close dataspace */
+    if(H5Sclose(sid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* Get the size from the second handle */
-    if((space = H5Dget_space(dset2)) < 0) goto error;
-    if(H5Sget_simple_extent_dims(space, tmp_size, NULL) < 0) goto error;
-    if(cur_size[0] != tmp_size[0]) {
+    /* Close dataset creation property list */
+    if(H5Pclose(dcpl) < 0) {
         H5_FAILED();
-        printf("    Got %d instead of %d!\n", (int)tmp_size[0], (int)cur_size[0]);
+        printf("    Line %d: Can't close dcpl\n",__LINE__);
         goto error;
     } /* end if */
 
-    if(H5Dclose(dset1) < 0) goto error;
-    if(H5Dclose(dset2) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Pclose(dcpl) < 0) goto error;
 
     PASSED();
     return 0;
 
- error:
-    H5E_BEGIN_TRY {
-    H5Dclose(dset1);
-    H5Dclose(dset2);
-    H5Sclose(space);
-    H5Pclose(dcpl);
-    } H5E_END_TRY;
+error:
     return -1;
-}
+} /* end test_can_apply2() */
+
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_types
+ * Function:    test_can_apply_szip
  *
- * Purpose:    Make some datasets with various types so we can test h5ls.
+ * Purpose:    Tests library behavior when szip filter indicates it can't
+ *              apply to certain combinations of creation parameters
  *
  * Return:    Success:    0
- *
  *        Failure:    -1
  *
- * Programmer:    Robb Matzke
- *              Monday, June  7, 1999
+ * Programmer:    Quincey Koziol
+ *              Monday, April  7, 2003
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_types(hid_t file)
+test_can_apply_szip(hid_t
+#ifndef H5_HAVE_FILTER_SZIP
+H5_ATTR_UNUSED
+#endif /* H5_HAVE_FILTER_SZIP */
+file)
 {
-    hid_t        grp=-1, type=-1, space=-1, dset=-1;
-    size_t        i;
-    hsize_t        nelmts;
-    unsigned char    buf[32];
+#ifdef H5_HAVE_FILTER_SZIP
+    hid_t       dsid;           /* Dataset ID */
+    hid_t       sid;            /* Dataspace ID */
+    hid_t       dcpl;           /* Dataspace creation property list ID */
+    unsigned szip_options_mask=H5_SZIP_NN_OPTION_MASK;
+    unsigned szip_pixels_per_block;
+    const hsize_t dims[2] = {500, 4096};        /* Dataspace dimensions */
+    const hsize_t dims2[2] = {4, 2};            /* Dataspace dimensions */
+    const hsize_t chunk_dims[2] = {250, 2048};  /* Chunk dimensions */
+    const hsize_t chunk_dims2[2] = {2, 1};      /* Chunk dimensions */
+    herr_t      ret;            /* Status value */
+#endif /* H5_HAVE_FILTER_SZIP */
 
-    TESTING("various datatypes");
-    if((grp = H5Gcreate2(file, "typetests", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) goto error;
+    TESTING("dataset szip filter 'can apply' callback");
 
-    /* bitfield_1 */
-    nelmts = sizeof(buf);
-    if((type=H5Tcopy(H5T_STD_B8LE)) < 0 ||
-    (space=H5Screate_simple(1, &nelmts, NULL)) < 0 ||
-    (dset=H5Dcreate2(grp, "bitfield_1", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-    goto error;
-    for(i=0; i<sizeof buf; i++) buf[i] = (unsigned char)0xff ^ (unsigned char)i;
-    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
-    goto error;
+#ifdef H5_HAVE_FILTER_SZIP
 
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Tclose(type) < 0) goto error;
-    if(H5Dclose(dset) < 0) goto error;
+    if(h5_szip_can_encode() == 1) {
+    /* Create the data space */
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't open dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* bitfield_2 */
-    nelmts = sizeof(buf)/2;
-    if((type=H5Tcopy(H5T_STD_B16LE)) < 0 ||
-    (space=H5Screate_simple(1, &nelmts, NULL)) < 0 ||
-    (dset=H5Dcreate2(grp, "bitfield_2", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-    goto error;
-    for(i=0; i<sizeof buf; i++) buf[i] = (unsigned char)0xff ^ (unsigned char)i;
-    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
-    goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Tclose(type) < 0) goto error;
-    if(H5Dclose(dset) < 0) goto error;
+    /* Create dcpl with special filter */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't create dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
+    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* opaque_1 */
-    nelmts = sizeof(buf);
-    if((type = H5Tcreate(H5T_OPAQUE, (size_t)1)) < 0 ||
-            H5Tset_tag(type, "testing 1-byte opaque type") < 0 ||
-            (space = H5Screate_simple(1, &nelmts, NULL)) < 0 ||
-            (dset = H5Dcreate2(grp, "opaque_1", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-    goto error;
-    for(i = 0; i < sizeof buf; i++)
-        buf[i] = (unsigned char)0xff ^ (unsigned char)i;
-    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Tclose(type) < 0) goto error;
-    if(H5Dclose(dset) < 0) goto error;
+    /* Set (invalid at property set time) szip parameters */
+    szip_pixels_per_block=3;
+    H5E_BEGIN_TRY {
+        ret=H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block);
+    } H5E_END_TRY;
+    if(ret>=0) {
+        H5_FAILED();
+        printf("    Line %d: Shouldn't be able to set szip filter\n",__LINE__);
+        goto error;
+    }
+
+    /* Set (invalid at property set time) szip parameters */
+    szip_pixels_per_block=512;
+    H5E_BEGIN_TRY {
+        ret=H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block);
+    } H5E_END_TRY;
+    if(ret>=0) {
+        H5_FAILED();
+        printf("    Line %d: Shouldn't be able to set szip filter\n",__LINE__);
+        goto error;
+    }
+
+    /* Set (invalid at dataset creation time) szip parameters */
+    szip_pixels_per_block=2;
+    if(H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set szip filter\n",__LINE__);
+        goto error;
+    }
+
+    /* Create new dataset */
+    /* (Should succeed; according to the new algorithm, scanline should be reset
+        to 2*128 satisfying 'maximum blocks per scanline' condition) */
+    H5E_BEGIN_TRY {
+        dsid = H5Dcreate2(file, DSET_CAN_APPLY_SZIP_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dsid <=0) {
+        H5_FAILED();
+        printf("    Line %d: Should have created dataset!\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Close dataset */
+    if(H5Dclose(dsid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataset\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Close dataspace */
+    if(H5Sclose(sid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Close dataset creation property list */
+    if(H5Pclose(dcpl) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Create another data space */
+    if((sid = H5Screate_simple(2, dims2, NULL)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't open dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Create dcpl with special filter */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't create dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
+    if(H5Pset_chunk(dcpl, 2, chunk_dims2) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Set (invalid at dataset creation time) szip parameters */
+    szip_pixels_per_block=32;
+    if(H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't set szip filter\n",__LINE__);
+        goto error;
+    }
+
+    /* Create new dataset */
+    /* (Should fail because the 'can apply' filter should indicate inappropriate combination) */
+    H5E_BEGIN_TRY {
+        dsid = H5Dcreate2(file, DSET_CAN_APPLY_SZIP_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dsid >=0) {
+        H5_FAILED();
+        printf("    Line %d: Shouldn't have created dataset!\n",__LINE__);
+        H5Dclose(dsid);
+        goto error;
+    } /* end if */
+
+    /* Close dataspace */
+    if(H5Sclose(sid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataspace\n",__LINE__);
+        goto error;
+    } /* end if */
+
+    /* Close dataset creation property list */
+    if(H5Pclose(dcpl) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dcpl\n",__LINE__);
+        goto error;
+    } /* end if */
 
-    /* opaque_2 */
-    nelmts = sizeof(buf)/4;
-    if((type = H5Tcreate(H5T_OPAQUE, (size_t)4)) < 0 ||
-            H5Tset_tag(type, "testing 4-byte opaque type") < 0 ||
-            (space = H5Screate_simple(1, &nelmts, NULL)) < 0 ||
-            (dset = H5Dcreate2(grp, "opaque_2", type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-    goto error;
-    for(i = 0; i < sizeof buf; i++)
-        buf[i] = (unsigned char)0xff ^ (unsigned char)i;
-    if(H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) goto error;
-    if(H5Sclose(space) < 0) goto error;
-    if(H5Tclose(type) < 0) goto error;
-    if(H5Dclose(dset) < 0) goto error;
 
-    /* Cleanup */
-    if(H5Gclose(grp) < 0) goto error;
     PASSED();
+} else {
+    SKIPPED();
+    puts("    Szip encoding is not enabled.");
+}
+#else /* H5_HAVE_FILTER_SZIP */
+    SKIPPED();
+    puts("    Szip filter is not enabled.");
+#endif /* H5_HAVE_FILTER_SZIP */
     return 0;
 
- error:
-    H5E_BEGIN_TRY {
-    H5Gclose(grp);
-    H5Tclose(type);
-    H5Sclose(space);
-    H5Dclose(dset);
-    } H5E_END_TRY;
+#ifdef H5_HAVE_FILTER_SZIP
+error:
     return -1;
-}
+#endif /* H5_HAVE_FILTER_SZIP */
+} /* end test_can_apply_szip() */
+
 
 /* This message derives from H5Z */
-const H5Z_class2_t H5Z_CAN_APPLY_TEST[1] = {{
+const H5Z_class2_t H5Z_SET_LOCAL_TEST[1] = {{
     H5Z_CLASS_T_VERS,
-    H5Z_FILTER_CAN_APPLY_TEST,    /* Filter id number        */
+    H5Z_FILTER_SET_LOCAL_TEST,    /* Filter id number        */
     1, 1,
-    "can_apply_test",        /* Filter name for debugging    */
-    can_apply_bogus,            /* The "can apply" callback     */
-    NULL,                       /* The "set local" callback     */
-    filter_bogus,        /* The actual filter function    */
+    "set_local_test",        /* Filter name for debugging    */
+    NULL,                       /* The "can apply" callback     */
+    set_local_bogus2,           /* The "set local" callback     */
+    filter_bogus2,        /* The actual filter function    */
 }};
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_can_apply
+ * Function:    test_set_local
  *
- * Purpose:    Tests library behavior when filter indicates it can't
- *              apply to certain combinations of creation parameters.
- *              The filter is mandate.  If the CAN_APPLY callback function
- *              indicates wrong datatype, the dataset creation should fail.
+ * Purpose:    Tests library behavior for "set local" filter callback
  *
  * Return:    Success:    0
  *        Failure:    -1
  *
  * Programmer:    Quincey Koziol
- *              Friday, April  5, 2003
+ *              Monday, April  7, 2003
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_can_apply(hid_t file)
+test_set_local(hid_t fapl)
 {
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       file;           /* File ID */
     hid_t       dsid;           /* Dataset ID */
     hid_t       sid;            /* Dataspace ID */
     hid_t       dcpl;           /* Dataspace creation property list ID */
     const hsize_t dims[2] = {DSET_DIM1, DSET_DIM2};         /* Dataspace dimensions */
     const hsize_t chunk_dims[2] = {2, 25};      /* Chunk dimensions */
     hsize_t     dset_size;      /* Dataset size */
-    size_t      i,j;            /* Local index variables */
+    unsigned    cd_values[2]={BOGUS2_PARAM_1, BOGUS2_PARAM_2};   /* Parameters for Bogus2 filter */
+    size_t      i,j;          /* Local index variables */
+    double      n;          /* Local index variables */
 
-    TESTING("dataset filter 'can apply' callback");
+    TESTING("dataset filter 'set local' callback");
+
+    h5_fixname(FILENAME[5], fapl, filename, sizeof filename);
+
+    /* Initialize the integer & floating-point dataset */
+    n=1.0F;
+    for(i = 0; i < DSET_DIM1; i++)
+    for(j = 0; j < DSET_DIM2; j++) {
+        points[i][j] = (int)n++;
+        points_dbl[i][j] = (double)1.5F*n++;
+    }
+
+    /* Open file */
+    if((file=H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't open file\n",__LINE__);
+    goto error;
+    }
 
     /* Create dcpl with special filter */
     if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
@@ -5391,15 +6799,14 @@ test_can_apply(hid_t file)
         printf("    Line %d: Can't set chunk sizes\n",__LINE__);
         goto error;
     } /* end if */
-    if(H5Zregister (H5Z_CAN_APPLY_TEST) < 0) {
+    if(H5Zregister (H5Z_SET_LOCAL_TEST) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't register 'can apply' filter\n",__LINE__);
+        printf("    Line %d: Can't register 'set local' filter\n",__LINE__);
         goto error;
     }
-    /* The filter is mandate. */
-    if(H5Pset_filter(dcpl, H5Z_FILTER_CAN_APPLY_TEST, 0, (size_t)0, NULL) < 0) {
+    if(H5Pset_filter(dcpl, H5Z_FILTER_SET_LOCAL_TEST, 0, (size_t)BOGUS2_PERM_NPARMS, cd_values) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't set bogus filter\n",__LINE__);
+        printf("    Line %d: Can't set bogus2 filter\n",__LINE__);
         goto error;
     }
 
@@ -5411,31 +6818,7 @@ test_can_apply(hid_t file)
     } /* end if */
 
     /* Create new dataset */
-    /* (Should fail because the 'can apply' function should indicate inappropriate
-     * combination.  And the filter is mandate.) */
-    H5E_BEGIN_TRY {
-        dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dsid >=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't have created dataset!\n",__LINE__);
-        H5Dclose(dsid);
-        goto error;
-    } /* end if */
-
-    /* (Should fail because the 'can apply' function should fail) */
-    H5E_BEGIN_TRY {
-        dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME, H5T_NATIVE_FLOAT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dsid >=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't have created dataset!\n",__LINE__);
-        H5Dclose(dsid);
-        goto error;
-    } /* end if */
-
-    /* Create new dataset */
-    if((dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
+    if((dsid = H5Dcreate2(file, DSET_SET_LOCAL_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
         H5_FAILED();
         printf("    Line %d: Can't create dataset\n",__LINE__);
         goto error;
@@ -5448,49 +6831,28 @@ test_can_apply(hid_t file)
         goto error;
     } /* end if */
 
-    /* Flush the file (to clear the cache) */
-    if(H5Fflush(file, H5F_SCOPE_GLOBAL) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Error flushing file\n",__LINE__);
-        goto error;
-    } /* end if */
-
-    /* Query the dataset's size on disk */
-    if((dset_size=H5Dget_storage_size(dsid))==0) {
+    /* Close dataset */
+    if(H5Dclose(dsid) < 0) {
         H5_FAILED();
-        printf("    Line %d: Error querying dataset size\n",__LINE__);
+        printf("    Line %d: Can't close dataset\n",__LINE__);
         goto error;
     } /* end if */
 
-    /* Verify that the size indicates data is uncompressed */
-    if((H5Tget_size(H5T_NATIVE_INT)*dims[0]*dims[1])!=dset_size) {
+    /* Create new dataset */
+    /* (Shouldn't get modified by output filter) */
+    if((dsid = H5Dcreate2(file, DSET_SET_LOCAL_NAME_2, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
         H5_FAILED();
-        printf("    Line %d: Incorrect dataset size: %lu\n",__LINE__,(unsigned long)dset_size);
+        printf("    Line %d: Can't create dataset\n",__LINE__);
         goto error;
     } /* end if */
 
-    /* Read data */
-    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, check) < 0) {
+    /* Write data */
+    if(H5Dwrite(dsid, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, points_dbl) < 0) {
         H5_FAILED();
-        printf("    Line %d: Error reading dataset data\n",__LINE__);
+        printf("    Line %d: Error writing dataset data\n",__LINE__);
         goto error;
     } /* end if */
 
-    /* Compare data */
-    /* Check that the values read are the same as the values written */
-    for(i=0; i<(size_t)dims[0]; i++) {
-    for(j=0; j<(size_t)dims[1]; j++) {
-        if(points[i][j] != check[i][j]) {
-        H5_FAILED();
-        printf("    Line %d: Read different values than written.\n",__LINE__);
-        printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
-        printf("    At original: %d\n",points[i][j]);
-        printf("    At returned: %d\n",check[i][j]);
-        goto error;
-        } /* end if */
-    } /* end for */
-    } /* end for */
-
     /* Close dataset */
     if(H5Dclose(dsid) < 0) {
         H5_FAILED();
@@ -5501,150 +6863,121 @@ test_can_apply(hid_t file)
     /* Close dataspace */
     if(H5Sclose(sid) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't close dataspace\n",__LINE__);
+        printf("    Line %d: Can't close dataspace\n", __LINE__);
         goto error;
     } /* end if */
 
     /* Close dataset creation property list */
     if(H5Pclose(dcpl) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't close dcpl\n",__LINE__);
+        printf("    Line %d: Can't close dcpl\n", __LINE__);
         goto error;
     } /* end if */
 
-
-    PASSED();
-    return 0;
-
-error:
-    return -1;
-} /* end test_can_apply() */
-
-/* This message derives from H5Z */
-const H5Z_class2_t H5Z_CAN_APPLY_TEST2[1] = {{
-    H5Z_CLASS_T_VERS,
-    H5Z_FILTER_CAN_APPLY_TEST2,    /* Filter id number        */
-    1, 1,
-    "can_apply_test",        /* Filter name for debugging    */
-    can_apply_bogus,            /* The "can apply" callback     */
-    NULL,                       /* The "set local" callback     */
-    filter_bogus3,        /* The actual filter function    */
-}};
-
-
-/*-------------------------------------------------------------------------
- * Function:    test_can_apply2
- *
- * Purpose:    Tests library behavior when an optional filter indicates
- *              it can't apply to certain combinations of creation
- *              parameters.  The filter function FILTER_BOGUS3 does nothing
- *              than returning a failure.  Because the filter is optional,
- *              the library skips the filter even though the CAN_APPLY_BOGUS
- *              indicates the datatype DOUBLE can't apply to the dataset.
- *
- * Return:    Success:    0
- *        Failure:    -1
- *
- * Programmer:    Raymond Lu
- *              4 August 2010
- *
- *-------------------------------------------------------------------------
- */
-static herr_t
-test_can_apply2(hid_t file)
-{
-    hid_t       dsid;           /* Dataset ID */
-    hid_t       sid;            /* Dataspace ID */
-    hid_t       dcpl;           /* Dataspace creation property list ID */
-    const hsize_t dims[2] = {DSET_DIM1, DSET_DIM2};         /* Dataspace dimensions */
-    const hsize_t chunk_dims[2] = {2, 25};      /* Chunk dimensions */
-    hsize_t     dset_size;      /* Dataset size */
-    size_t      i,j;            /* Local index variables */
-
-    TESTING("dataset filter 'can apply' callback second");
-
-    /* Create dcpl with special filter */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+    /* Close file (flushes & empties cache) */
+    if(H5Fclose(file) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't create dcpl\n",__LINE__);
+        printf("    Line %d: Can't close file\n", __LINE__);
         goto error;
     } /* end if */
-    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) {
+
+    /* Open file */
+    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
+        printf("    Line %d: Can't open file\n", __LINE__);
         goto error;
-    } /* end if */
-    if(H5Zregister (H5Z_CAN_APPLY_TEST2) < 0) {
+    }
+
+    /* Re-open dataset */
+    if((dsid = H5Dopen2(file, DSET_SET_LOCAL_NAME, H5P_DEFAULT)) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't register 'can apply' filter\n",__LINE__);
+        printf("    Line %d: Can't open dataset\n", __LINE__);
         goto error;
-    }
-    /* The filter is optional. */
-    if(H5Pset_filter(dcpl, H5Z_FILTER_CAN_APPLY_TEST2, H5Z_FLAG_OPTIONAL, (size_t)0, NULL) < 0) {
+    } /* end if */
+
+    /* Query the dataset's size on disk */
+    if((dset_size = H5Dget_storage_size(dsid)) == 0) {
         H5_FAILED();
-        printf("    Line %d: Can't set bogus filter\n",__LINE__);
+        printf("    Line %d: Error querying dataset size\n", __LINE__);
         goto error;
-    }
+    } /* end if */
 
-    /* Create the data space */
-    if((sid = H5Screate_simple(2, dims, NULL)) < 0) {
+    /* Verify that the size indicates data is uncompressed */
+    if((H5Tget_size(H5T_NATIVE_INT) * dims[0] * dims[1]) != dset_size) {
         H5_FAILED();
-        printf("    Line %d: Can't open dataspace\n",__LINE__);
+        printf("    Line %d: Incorrect dataset size: %lu\n", __LINE__, (unsigned long)dset_size);
         goto error;
     } /* end if */
 
-    /* Create new dataset */
-    if((dsid = H5Dcreate2(file, DSET_CAN_APPLY_NAME2, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
+    /* Read data */
+    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, check) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't create dataset\n",__LINE__);
+        printf("    Line %d: Error reading dataset data\n", __LINE__);
         goto error;
     } /* end if */
 
-    /* Write data */
-    if(H5Dwrite(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, points) < 0) {
+    /* Compare data */
+    /* Check that the values read are the modified version of what was written */
+    for(i=0; i<dims[0]; i++) {
+    for(j=0; j<dims[1]; j++) {
+        if((points[i][j]+(int)sizeof(int)) != check[i][j]) {
         H5_FAILED();
-        printf("    Line %d: Error writing dataset data\n",__LINE__);
+        printf("    Line %d: Read different values than written.\n",__LINE__);
+        printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
+        printf("    At original: %d\n",points[i][j]);
+        printf("    At returned: %d\n",check[i][j]);
+        goto error;
+        } /* end if */
+    } /* end for */
+    } /* end for */
+
+    /* Close dataset */
+    if(H5Dclose(dsid) < 0) {
+        H5_FAILED();
+        printf("    Line %d: Can't close dataset\n", __LINE__);
         goto error;
     } /* end if */
 
-    /* Flush the file (to clear the cache) */
-    if(H5Fflush(file, H5F_SCOPE_GLOBAL) < 0) {
+    /* Re-open second dataset */
+    if((dsid = H5Dopen2(file, DSET_SET_LOCAL_NAME_2, H5P_DEFAULT)) < 0) {
         H5_FAILED();
-        printf("    Line %d: Error flushing file\n",__LINE__);
+        printf("    Line %d: Can't open dataset\n", __LINE__);
         goto error;
     } /* end if */
 
     /* Query the dataset's size on disk */
-    if((dset_size=H5Dget_storage_size(dsid))==0) {
+    if((dset_size = H5Dget_storage_size(dsid)) == 0) {
         H5_FAILED();
-        printf("    Line %d: Error querying dataset size\n",__LINE__);
+        printf("    Line %d: Error querying dataset size\n", __LINE__);
         goto error;
     } /* end if */
 
     /* Verify that the size indicates data is uncompressed */
-    if((H5Tget_size(H5T_NATIVE_DOUBLE)*dims[0]*dims[1])!=dset_size) {
+    if((H5Tget_size(H5T_NATIVE_DOUBLE) * dims[0] * dims[1]) != dset_size) {
         H5_FAILED();
-        printf("    Line %d: Incorrect dataset size: %lu\n",__LINE__,(unsigned long)dset_size);
+        printf("    Line %d: Incorrect dataset size: %lu\n", __LINE__, (unsigned long)dset_size);
         goto error;
     } /* end if */
 
     /* Read data */
-    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, check) < 0) {
+    if(H5Dread(dsid, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, check_dbl) < 0) {
         H5_FAILED();
-        printf("    Line %d: Error reading dataset data\n",__LINE__);
+        printf("    Line %d: Error reading dataset data\n", __LINE__);
         goto error;
     } /* end if */
 
     /* Compare data */
-    /* Check that the values read are the same as the values written */
-    for(i=0; i<(size_t)dims[0]; i++) {
-    for(j=0; j<(size_t)dims[1]; j++) {
-        if(points[i][j] != check[i][j]) {
+    /* Check that the values read are the modified version of what was written */
+    for(i=0; i<dims[0]; i++) {
+    for(j=0; j<dims[1]; j++) {
+        /* If the difference between two values is greater than 0.001%, they're
+             * considered not equal. */
+            if(!H5_DBL_REL_EQUAL(points_dbl[i][j], check_dbl[i][j], (double)0.00001F)) {
         H5_FAILED();
         printf("    Line %d: Read different values than written.\n",__LINE__);
         printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
-        printf("    At original: %d\n",points[i][j]);
-        printf("    At returned: %d\n",check[i][j]);
+        printf("    At original: %f\n",points_dbl[i][j]);
+        printf("    At returned: %f\n",check_dbl[i][j]);
         goto error;
         } /* end if */
     } /* end for */
@@ -5657,17 +6990,10 @@ test_can_apply2(hid_t file)
         goto error;
     } /* end if */
 
-    /* Close dataspace */
-    if(H5Sclose(sid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataspace\n",__LINE__);
-        goto error;
-    } /* end if */
-
-    /* Close dataset creation property list */
-    if(H5Pclose(dcpl) < 0) {
+    /* Close file */
+    if(H5Fclose(file) < 0) {
         H5_FAILED();
-        printf("    Line %d: Can't close dcpl\n",__LINE__);
+        printf("    Line %d: Can't close file\n",__LINE__);
         goto error;
     } /* end if */
 
@@ -5677,548 +7003,491 @@ test_can_apply2(hid_t file)
 
 error:
     return -1;
-} /* end test_can_apply2() */
-
+} /* end test_set_local() */
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_can_apply_szip
+ * Function:    test_compare_dcpl
  *
- * Purpose:    Tests library behavior when szip filter indicates it can't
- *              apply to certain combinations of creation parameters
+ * Purpose:    Verifies that if the same DCPL was used to create two
+ *              datasets, the DCPLs retrieved from each dataset should
+ *              compare equal.
  *
  * Return:    Success:    0
  *        Failure:    -1
  *
  * Programmer:    Quincey Koziol
- *              Monday, April  7, 2003
+ *              Wednesday, January  7, 2004
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_can_apply_szip(hid_t
-#ifndef H5_HAVE_FILTER_SZIP
-H5_ATTR_UNUSED
-#endif /* H5_HAVE_FILTER_SZIP */
-file)
+test_compare_dcpl(hid_t file)
 {
-#ifdef H5_HAVE_FILTER_SZIP
-    hid_t       dsid;           /* Dataset ID */
-    hid_t       sid;            /* Dataspace ID */
-    hid_t       dcpl;           /* Dataspace creation property list ID */
-    unsigned szip_options_mask=H5_SZIP_NN_OPTION_MASK;
-    unsigned szip_pixels_per_block;
+    hid_t       dsid=(-1);      /* Dataset ID */
+    hid_t       sid=(-1);       /* Dataspace ID */
+    hid_t       dcpl=(-1);      /* Dataspace creation property list ID */
+    hid_t       dcpl1=(-1),dcpl2=(-1);          /* Dataspace creation property list IDs from datasets */
     const hsize_t dims[2] = {500, 4096};        /* Dataspace dimensions */
-    const hsize_t dims2[2] = {4, 2};            /* Dataspace dimensions */
     const hsize_t chunk_dims[2] = {250, 2048};  /* Chunk dimensions */
-    const hsize_t chunk_dims2[2] = {2, 1};      /* Chunk dimensions */
-    herr_t      ret;            /* Status value */
-#endif /* H5_HAVE_FILTER_SZIP */
-
-    TESTING("dataset szip filter 'can apply' callback");
 
-#ifdef H5_HAVE_FILTER_SZIP
+    TESTING("comparing dataset creation property lists");
 
-    if(h5_szip_can_encode() == 1) {
     /* Create the data space */
-    if((sid = H5Screate_simple(2, dims, NULL)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open dataspace\n",__LINE__);
-        goto error;
-    } /* end if */
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) TEST_ERROR
 
     /* Create dcpl with special filter */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't create dcpl\n",__LINE__);
-        goto error;
-    } /* end if */
-    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
-        goto error;
-    } /* end if */
-
-    /* Set (invalid at property set time) szip parameters */
-    szip_pixels_per_block=3;
-    H5E_BEGIN_TRY {
-        ret=H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block);
-    } H5E_END_TRY;
-    if(ret>=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't be able to set szip filter\n",__LINE__);
-        goto error;
-    }
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR
+    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) TEST_ERROR
 
-    /* Set (invalid at property set time) szip parameters */
-    szip_pixels_per_block=512;
-    H5E_BEGIN_TRY {
-        ret=H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block);
-    } H5E_END_TRY;
-    if(ret>=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't be able to set szip filter\n",__LINE__);
-        goto error;
-    }
+    /* Set gzip parameter (if available) */
+#ifdef H5_HAVE_FILTER_DEFLATE
+    if(H5Pset_deflate (dcpl, 9) < 0) TEST_ERROR
+#endif /* H5_HAVE_FILTER_DEFLATE */
 
-    /* Set (invalid at dataset creation time) szip parameters */
-    szip_pixels_per_block=2;
-    if(H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't set szip filter\n",__LINE__);
-        goto error;
-    }
+    /* Create first dataset */
+    if((dsid = H5Dcreate2(file, DSET_COMPARE_DCPL_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR
 
-    /* Create new dataset */
-    /* (Should succeed; according to the new algorithm, scanline should be reset
-        to 2*128 satisfying 'maximum blocks per scanline' condition) */
-    H5E_BEGIN_TRY {
-        dsid = H5Dcreate2(file, DSET_CAN_APPLY_SZIP_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dsid <=0) {
-        H5_FAILED();
-        printf("    Line %d: Should have created dataset!\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Get copy of dataset's dataset creation property list */
+    if((dcpl1=H5Dget_create_plist(dsid)) < 0) TEST_ERROR
 
     /* Close dataset */
-    if(H5Dclose(dsid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataset\n",__LINE__);
-        goto error;
-    } /* end if */
-
-    /* Close dataspace */
-    if(H5Sclose(sid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataspace\n",__LINE__);
-        goto error;
-    } /* end if */
-
-    /* Close dataset creation property list */
-    if(H5Pclose(dcpl) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dcpl\n",__LINE__);
-        goto error;
-    } /* end if */
-
-    /* Create another data space */
-    if((sid = H5Screate_simple(2, dims2, NULL)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open dataspace\n",__LINE__);
-        goto error;
-    } /* end if */
+    if(H5Dclose (dsid) < 0) TEST_ERROR
 
-    /* Create dcpl with special filter */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't create dcpl\n",__LINE__);
-        goto error;
-    } /* end if */
-    if(H5Pset_chunk(dcpl, 2, chunk_dims2) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Create second dataset */
+    if((dsid = H5Dcreate2(file, DSET_COMPARE_DCPL_NAME_2, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR
 
-    /* Set (invalid at dataset creation time) szip parameters */
-    szip_pixels_per_block=32;
-    if(H5Pset_szip (dcpl, szip_options_mask, szip_pixels_per_block) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't set szip filter\n",__LINE__);
-        goto error;
-    }
+    /* Get copy of dataset's dataset creation property list */
+    if((dcpl2=H5Dget_create_plist(dsid)) < 0) TEST_ERROR
 
-    /* Create new dataset */
-    /* (Should fail because the 'can apply' filter should indicate inappropriate combination) */
-    H5E_BEGIN_TRY {
-        dsid = H5Dcreate2(file, DSET_CAN_APPLY_SZIP_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dsid >=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't have created dataset!\n",__LINE__);
-        H5Dclose(dsid);
-        goto error;
-    } /* end if */
+    /* Close dataset */
+    if(H5Dclose (dsid) < 0) TEST_ERROR
 
     /* Close dataspace */
-    if(H5Sclose(sid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataspace\n",__LINE__);
-        goto error;
-    } /* end if */
+    if(H5Sclose(sid) < 0) TEST_ERROR
 
-    /* Close dataset creation property list */
-    if(H5Pclose(dcpl) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dcpl\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Compare dataset creation property lists */
+    if(H5Pequal(dcpl1,dcpl2)<=0) TEST_ERROR
+
+    /* Close dataset creation property lists */
+    if(H5Pclose(dcpl) < 0) TEST_ERROR
+    if(H5Pclose(dcpl1) < 0) TEST_ERROR
+    if(H5Pclose(dcpl2) < 0) TEST_ERROR
 
 
     PASSED();
-} else {
-    SKIPPED();
-    puts("    Szip encoding is not enabled.");
-}
-#else /* H5_HAVE_FILTER_SZIP */
-    SKIPPED();
-    puts("    Szip filter is not enabled.");
-#endif /* H5_HAVE_FILTER_SZIP */
+
     return 0;
 
-#ifdef H5_HAVE_FILTER_SZIP
 error:
-    return -1;
-#endif /* H5_HAVE_FILTER_SZIP */
-} /* end test_can_apply_szip() */
-
-
-/* This message derives from H5Z */
-const H5Z_class2_t H5Z_SET_LOCAL_TEST[1] = {{
-    H5Z_CLASS_T_VERS,
-    H5Z_FILTER_SET_LOCAL_TEST,    /* Filter id number        */
-    1, 1,
-    "set_local_test",        /* Filter name for debugging    */
-    NULL,                       /* The "can apply" callback     */
-    set_local_bogus2,           /* The "set local" callback     */
-    filter_bogus2,        /* The actual filter function    */
-}};
+    H5E_BEGIN_TRY {
+        H5Dclose(dsid);
+        H5Sclose(sid);
+        H5Pclose(dcpl);
+        H5Pclose(dcpl1);
+        H5Pclose(dcpl2);
+    } H5E_END_TRY;
+    return -1;
+} /* end test_compare_dcpl() */
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_set_local
+ * Function:    test_copy_dcpl
  *
- * Purpose:    Tests library behavior for "set local" filter callback
+ * Purpose:    Verifies whether the copy of dataset creation property
+ *              list works.  It tests the DCPL for chunked layout with
+ *              filter and for contiguous layout with external storage.
+ *              (Please see #1608 in Bugzilla)
  *
  * Return:    Success:    0
  *        Failure:    -1
  *
- * Programmer:    Quincey Koziol
- *              Monday, April  7, 2003
+ * Programmer:    Raymond Lu
+ *              28 January 2010
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_set_local(hid_t fapl)
+test_copy_dcpl(hid_t file, hid_t fapl)
 {
-    char        filename[FILENAME_BUF_SIZE];
-    hid_t       file;           /* File ID */
-    hid_t       dsid;           /* Dataset ID */
-    hid_t       sid;            /* Dataspace ID */
-    hid_t       dcpl;           /* Dataspace creation property list ID */
-    const hsize_t dims[2] = {DSET_DIM1, DSET_DIM2};         /* Dataspace dimensions */
-    const hsize_t chunk_dims[2] = {2, 25};      /* Chunk dimensions */
-    hsize_t     dset_size;      /* Dataset size */
-    unsigned    cd_values[2]={BOGUS2_PARAM_1, BOGUS2_PARAM_2};   /* Parameters for Bogus2 filter */
-    size_t      i,j;          /* Local index variables */
-    double      n;          /* Local index variables */
+    hid_t       dsid1=(-1), dsid2=(-1);         /* Dataset ID */
+    hid_t       new_dsid1=(-1), new_dsid2=(-1); /* Dataset ID */
+    hid_t       sid=(-1);                       /* Dataspace ID */
+    hid_t       dcpl=(-1);                      /* Dataset creation property list ID */
+    hid_t       dcpl1=(-1),dcpl2=(-1);          /* Copies of creation property list IDs */
+    hid_t       dcpl1_copy=(-1),dcpl2_copy=(-1);/* Copies of creation property list IDs */
+    const hsize_t dims[2] = {500, 4096};        /* Dataspace dimensions */
+    const hsize_t chunk_dims[2] = {250, 2048};  /* Chunk dimensions */
+    char    filename[FILENAME_BUF_SIZE];
+    hid_t       new_file=(-1);
 
-    TESTING("dataset filter 'set local' callback");
+    TESTING("copying dataset creation property lists");
 
-    h5_fixname(FILENAME[5], fapl, filename, sizeof filename);
+    /* Create the data space */
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) TEST_ERROR
 
-    /* Initialize the integer & floating-point dataset */
-    n=1.0F;
-    for(i = 0; i < DSET_DIM1; i++)
-    for(j = 0; j < DSET_DIM2; j++) {
-        points[i][j] = (int)n++;
-        points_dbl[i][j] = (double)1.5F*n++;
-    }
+    /* Create dcpl with special filter */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR
+    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) TEST_ERROR
+    if(H5Pset_fletcher32(dcpl) < 0) TEST_ERROR
 
-    /* Open file */
-    if((file=H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open file\n",__LINE__);
-    goto error;
-    }
+    /* Create first dataset of chunking with filter */
+    if((dsid1 = H5Dcreate2(file, DSET_COPY_DCPL_NAME_1, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl,
+        H5P_DEFAULT)) < 0) TEST_ERROR
 
-    /* Create dcpl with special filter */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't create dcpl\n",__LINE__);
-        goto error;
-    } /* end if */
-    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't set chunk sizes\n",__LINE__);
-        goto error;
-    } /* end if */
-    if(H5Zregister (H5Z_SET_LOCAL_TEST) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't register 'set local' filter\n",__LINE__);
-        goto error;
-    }
-    if(H5Pset_filter(dcpl, H5Z_FILTER_SET_LOCAL_TEST, 0, (size_t)BOGUS2_PERM_NPARMS, cd_values) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't set bogus2 filter\n",__LINE__);
-        goto error;
-    }
+    /* Close dataset */
+    if(H5Dclose (dsid1) < 0) TEST_ERROR
 
-    /* Create the data space */
-    if((sid = H5Screate_simple(2, dims, NULL)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open dataspace\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Reopen the first dataset */
+    if((dsid1 = H5Dopen2(file, DSET_COPY_DCPL_NAME_1, H5P_DEFAULT)) < 0) TEST_ERROR
 
-    /* Create new dataset */
-    if((dsid = H5Dcreate2(file, DSET_SET_LOCAL_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't create dataset\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Get the copy of dataset's creation property list */
+    if((dcpl1=H5Dget_create_plist(dsid1)) < 0) TEST_ERROR
+    if((dcpl1_copy = H5Pcopy(dcpl1)) < 0) TEST_ERROR
 
-    /* Write data */
-    if(H5Dwrite(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, points) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Error writing dataset data\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Close dataset */
+    if(H5Dclose (dsid1) < 0) TEST_ERROR
+
+    /* Change the DCPL for contiguous layout with external storage.  The size of the reserved
+     * space in the external file is the size of the dataset - 500*4096*sizeof(int).
+     * There's no need to clean up the external file since the library doesn't create it
+     * until the data is written to it. */
+    if(H5Pset_layout(dcpl, H5D_CONTIGUOUS) < 0) TEST_ERROR
+    if(H5Premove_filter(dcpl, H5Z_FILTER_FLETCHER32) < 0) TEST_ERROR
+    if(H5Pset_external(dcpl, COPY_DCPL_EXTFILE_NAME, (off_t)0, (hsize_t)(500 * 4096 * sizeof(int))) < 0) TEST_ERROR
+
+    /* Create second dataset of contiguous layout with external storage */
+    if((dsid2 = H5Dcreate2(file, DSET_COPY_DCPL_NAME_2, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl,
+        H5P_DEFAULT)) < 0) TEST_ERROR
 
     /* Close dataset */
-    if(H5Dclose(dsid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataset\n",__LINE__);
-        goto error;
-    } /* end if */
+    if(H5Dclose (dsid2) < 0) TEST_ERROR
 
-    /* Create new dataset */
-    /* (Shouldn't get modified by output filter) */
-    if((dsid = H5Dcreate2(file, DSET_SET_LOCAL_NAME_2, H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't create dataset\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Reopen the second dataset */
+    if((dsid2 = H5Dopen2(file, DSET_COPY_DCPL_NAME_2, H5P_DEFAULT)) < 0) TEST_ERROR
 
-    /* Write data */
-    if(H5Dwrite(dsid, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, points_dbl) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Error writing dataset data\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Get copy of dataset's dataset creation property list */
+    if((dcpl2=H5Dget_create_plist(dsid2)) < 0) TEST_ERROR
+    if((dcpl2_copy = H5Pcopy(dcpl2)) < 0) TEST_ERROR
 
     /* Close dataset */
-    if(H5Dclose(dsid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataset\n",__LINE__);
-        goto error;
-    } /* end if */
+    if(H5Dclose (dsid2) < 0) TEST_ERROR
+
+    /* Create a second file and create 2 datasets with the copies of the DCPLs in the first
+     * file.  Test whether the copies of DCPLs work. */
+    h5_fixname(FILENAME[13], fapl, filename, sizeof filename);
+    if((new_file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        TEST_ERROR
+
+    if((new_dsid1 = H5Dcreate2(new_file, DSET_COPY_DCPL_NAME_1, H5T_NATIVE_INT, sid,
+            H5P_DEFAULT, dcpl1_copy, H5P_DEFAULT)) < 0) TEST_ERROR
+
+    if((new_dsid2 = H5Dcreate2(new_file, DSET_COPY_DCPL_NAME_2, H5T_NATIVE_INT, sid,
+            H5P_DEFAULT, dcpl2_copy, H5P_DEFAULT)) < 0) TEST_ERROR
 
     /* Close dataspace */
-    if(H5Sclose(sid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataspace\n", __LINE__);
-        goto error;
-    } /* end if */
+    if(H5Sclose(sid) < 0) TEST_ERROR
 
-    /* Close dataset creation property list */
-    if(H5Pclose(dcpl) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dcpl\n", __LINE__);
-        goto error;
-    } /* end if */
+    /* Close datasets */
+    if(H5Dclose (new_dsid1) < 0) TEST_ERROR
+    if(H5Dclose (new_dsid2) < 0) TEST_ERROR
 
-    /* Close file (flushes & empties cache) */
-    if(H5Fclose(file) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close file\n", __LINE__);
-        goto error;
-    } /* end if */
+    /* Close the second file */
+    if(H5Fclose (new_file) < 0) TEST_ERROR
 
-    /* Open file */
-    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open file\n", __LINE__);
-        goto error;
-    }
+    /* Close dataset creation property lists */
+    if(H5Pclose(dcpl) < 0) TEST_ERROR
+    if(H5Pclose(dcpl1) < 0) TEST_ERROR
+    if(H5Pclose(dcpl2) < 0) TEST_ERROR
+    if(H5Pclose(dcpl1_copy) < 0) TEST_ERROR
+    if(H5Pclose(dcpl2_copy) < 0) TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(dsid1);
+        H5Dclose(dsid2);
+        H5Dclose(new_dsid1);
+        H5Dclose(new_dsid2);
+        H5Sclose(sid);
+        H5Pclose(dcpl);
+        H5Pclose(dcpl1);
+        H5Pclose(dcpl2);
+        H5Pclose(dcpl1_copy);
+        H5Pclose(dcpl2_copy);
+    } H5E_END_TRY;
+    return -1;
+} /* end test_copy_dcpl() */
+
+
+/*-------------------------------------------------------------------------
+ * Function: test_filter_delete
+ *
+ * Purpose: Tests deletion of filters from a dataset creation property list
+ *
+ * Return: Success: 0
+ *  Failure: -1
+ *
+ * Programmer: Pedro Vicente
+ *              Monday, January 26, 2004
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_filter_delete(hid_t file)
+{
+    H5Z_filter_t filtn;                 /* filter identification number */
+    hid_t        dsid=-1;                  /* dataset ID */
+    hid_t        sid=-1;                   /* dataspace ID */
+    hid_t        dcpl=-1;                  /* dataset creation property list ID */
+    hid_t        dcpl1=-1;                 /* dataset creation property list ID */
+    hsize_t      dims[2]={20,20};       /* dataspace dimensions */
+    hsize_t      chunk_dims[2]={10,10}; /* chunk dimensions */
+    int          nfilters;              /* number of filters in DCPL */
+    unsigned     flags;                 /* flags for filter */
+    herr_t       ret;                   /* generic return value */
+    int          i;
+
+    TESTING("filter deletion");
+
+#ifdef H5_HAVE_FILTER_DEFLATE
+    /* create the data space */
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) goto error;
 
-    /* Re-open dataset */
-    if((dsid = H5Dopen2(file, DSET_SET_LOCAL_NAME, H5P_DEFAULT)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open dataset\n", __LINE__);
-        goto error;
-    } /* end if */
+    /* create dcpl  */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) goto error;
 
-    /* Query the dataset's size on disk */
-    if((dset_size = H5Dget_storage_size(dsid)) == 0) {
-        H5_FAILED();
-        printf("    Line %d: Error querying dataset size\n", __LINE__);
-        goto error;
-    } /* end if */
+    if(H5Pset_fletcher32 (dcpl) < 0) goto error;
+    if(H5Pset_deflate (dcpl, 6) < 0) goto error;
+    if(H5Pset_shuffle (dcpl) < 0) goto error;
 
-    /* Verify that the size indicates data is uncompressed */
-    if((H5Tget_size(H5T_NATIVE_INT) * dims[0] * dims[1]) != dset_size) {
-        H5_FAILED();
-        printf("    Line %d: Incorrect dataset size: %lu\n", __LINE__, (unsigned long)dset_size);
-        goto error;
-    } /* end if */
+    /* create a dataset */
+    if((dsid = H5Dcreate2(file,"dsetdel", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) goto error;
 
-    /* Read data */
-    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, check) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Error reading dataset data\n", __LINE__);
-        goto error;
-    } /* end if */
+    /* get copy of dataset's dataset creation property list */
+    if((dcpl1=H5Dget_create_plist(dsid)) < 0) goto error;
 
-    /* Compare data */
-    /* Check that the values read are the modified version of what was written */
-    for(i=0; i<dims[0]; i++) {
-    for(j=0; j<dims[1]; j++) {
-        if((points[i][j]+(int)sizeof(int)) != check[i][j]) {
-        H5_FAILED();
-        printf("    Line %d: Read different values than written.\n",__LINE__);
-        printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
-        printf("    At original: %d\n",points[i][j]);
-        printf("    At returned: %d\n",check[i][j]);
-        goto error;
-        } /* end if */
-    } /* end for */
-    } /* end for */
+   /*----------------------------------------------------------------------
+    * delete the deflate filter
+    *----------------------------------------------------------------------
+    */
+    /* delete the deflate filter */
+    if(H5Premove_filter(dcpl1,H5Z_FILTER_DEFLATE) < 0) goto error;
 
-    /* Close dataset */
-    if(H5Dclose(dsid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataset\n", __LINE__);
-        goto error;
-    } /* end if */
+    /* get information about filters */
+    if((nfilters = H5Pget_nfilters(dcpl1)) < 0) goto error;
 
-    /* Re-open second dataset */
-    if((dsid = H5Dopen2(file, DSET_SET_LOCAL_NAME_2, H5P_DEFAULT)) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't open dataset\n", __LINE__);
-        goto error;
-    } /* end if */
+    /* check if filter was deleted */
+    for(i=0; i<nfilters; i++) {
+        filtn = H5Pget_filter2(dcpl1, (unsigned)i, NULL, NULL, NULL, (size_t)0, NULL, NULL);
+        if(H5Z_FILTER_DEFLATE==filtn)
+            goto error;
+    }
 
-    /* Query the dataset's size on disk */
-    if((dset_size = H5Dget_storage_size(dsid)) == 0) {
+    /* try to get the info for the deflate filter */
+    H5E_BEGIN_TRY {
+        ret = H5Pget_filter_by_id2(dcpl1, H5Z_FILTER_DEFLATE, &flags, NULL, NULL, (size_t)0, NULL, NULL);
+    } H5E_END_TRY;
+    if(ret >=0) {
         H5_FAILED();
-        printf("    Line %d: Error querying dataset size\n", __LINE__);
+        printf("    Line %d: Shouldn't have deleted filter!\n",__LINE__);
         goto error;
     } /* end if */
 
-    /* Verify that the size indicates data is uncompressed */
-    if((H5Tget_size(H5T_NATIVE_DOUBLE) * dims[0] * dims[1]) != dset_size) {
+    /* try to delete the deflate filter again */
+    H5E_BEGIN_TRY {
+        ret=H5Premove_filter(dcpl1,H5Z_FILTER_DEFLATE);
+    } H5E_END_TRY;
+    if(ret >=0) {
         H5_FAILED();
-        printf("    Line %d: Incorrect dataset size: %lu\n", __LINE__, (unsigned long)dset_size);
+        printf("    Line %d: Shouldn't have deleted filter!\n",__LINE__);
         goto error;
     } /* end if */
 
-    /* Read data */
-    if(H5Dread(dsid, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, check_dbl) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Error reading dataset data\n", __LINE__);
-        goto error;
-    } /* end if */
+   /*----------------------------------------------------------------------
+    * delete all filters
+    *----------------------------------------------------------------------
+    */
+    /* delete all filters */
+    if(H5Premove_filter(dcpl1,H5Z_FILTER_ALL) < 0) goto error;
 
-    /* Compare data */
-    /* Check that the values read are the modified version of what was written */
-    for(i=0; i<dims[0]; i++) {
-    for(j=0; j<dims[1]; j++) {
-        /* If the difference between two values is greater than 0.001%, they're
-             * considered not equal. */
-            if(!H5_DBL_REL_EQUAL(points_dbl[i][j], check_dbl[i][j], (double)0.00001F)) {
-        H5_FAILED();
-        printf("    Line %d: Read different values than written.\n",__LINE__);
-        printf("    At index %lu,%lu\n", (unsigned long)(i), (unsigned long)(j));
-        printf("    At original: %f\n",points_dbl[i][j]);
-        printf("    At returned: %f\n",check_dbl[i][j]);
-        goto error;
-        } /* end if */
-    } /* end for */
-    } /* end for */
+    /* get information about filters */
+    if((nfilters = H5Pget_nfilters(dcpl1)) < 0) goto error;
 
-    /* Close dataset */
-    if(H5Dclose(dsid) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close dataset\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* check if filters were deleted */
+    if(nfilters)goto error;
 
-    /* Close file */
-    if(H5Fclose(file) < 0) {
-        H5_FAILED();
-        printf("    Line %d: Can't close file\n",__LINE__);
-        goto error;
-    } /* end if */
+   /*----------------------------------------------------------------------
+    * close
+    *----------------------------------------------------------------------
+    */
 
+    /* clean up objects used for this test */
+    if(H5Pclose (dcpl) < 0) goto error;
+    if(H5Pclose (dcpl1) < 0) goto error;
+    if(H5Dclose (dsid) < 0) goto error;
+    if(H5Sclose (sid) < 0) goto error;
 
     PASSED();
+#else
+    SKIPPED();
+#endif
     return 0;
 
 error:
+    H5E_BEGIN_TRY {
+        H5Pclose(dcpl);
+        H5Pclose(dcpl1);
+        H5Dclose(dsid);
+        H5Sclose(sid);
+    } H5E_END_TRY;
     return -1;
-} /* end test_set_local() */
+} /* end test_filter_delete() */
+
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_compare_dcpl
+ * Function: auxread_fdata
  *
- * Purpose:    Verifies that if the same DCPL was used to create two
- *              datasets, the DCPLs retrieved from each dataset should
- *              compare equal.
+ * Purpose: reads a dataset "NAME" from FID
  *
- * Return:    Success:    0
- *        Failure:    -1
+ * Return: Success: 0
+ *  Failure: -1
  *
- * Programmer:    Quincey Koziol
- *              Wednesday, January  7, 2004
+ * Programmer: Pedro Vicente
+ *              Monday, March 8, 2004
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_compare_dcpl(hid_t file)
+auxread_fdata(hid_t fid, const char *name)
 {
-    hid_t       dsid=(-1);      /* Dataset ID */
-    hid_t       sid=(-1);       /* Dataspace ID */
-    hid_t       dcpl=(-1);      /* Dataspace creation property list ID */
-    hid_t       dcpl1=(-1),dcpl2=(-1);          /* Dataspace creation property list IDs from datasets */
-    const hsize_t dims[2] = {500, 4096};        /* Dataspace dimensions */
-    const hsize_t chunk_dims[2] = {250, 2048};  /* Chunk dimensions */
+    hid_t     dset_id=-1;           /* dataset ID */
+    hid_t     dcpl_id=-1;           /* dataset creation property list ID */
+    hid_t     space_id=-1;          /* space ID */
+    hid_t     ftype_id=-1;          /* file data type ID */
+    hid_t     mtype_id=-1;          /* memory data type ID */
+    size_t    msize;             /* memory size of memory type */
+    void      *buf=NULL;         /* data buffer */
+    hsize_t   nelmts;            /* number of elements in dataset */
+    int       rank;              /* rank of dataset */
+    hsize_t   dims[H5S_MAX_RANK];/* dimensions of dataset */
+    int       i;
 
-    TESTING("comparing dataset creation property lists");
+    if((dset_id = H5Dopen2(fid, name, H5P_DEFAULT)) < 0)
+        goto error;
+    if((space_id = H5Dget_space(dset_id)) < 0)
+        goto error;
+    if((ftype_id = H5Dget_type(dset_id)) < 0)
+        goto error;
+    if((dcpl_id = H5Dget_create_plist(dset_id)) < 0)
+        goto error;
+    if((rank = H5Sget_simple_extent_ndims(space_id)) < 0)
+        goto error;
+    HDmemset(dims, 0, sizeof dims);
+    if(H5Sget_simple_extent_dims(space_id, dims, NULL) < 0)
+        goto error;
+    nelmts = 1;
+    for(i = 0; i < rank; i++)
+        nelmts *= dims[i];
+    if((mtype_id = H5Tget_native_type(ftype_id, H5T_DIR_DEFAULT)) < 0)
+        goto error;
+    if((msize = H5Tget_size(mtype_id)) == 0)
+        goto error;
 
-    /* Create the data space */
-    if((sid = H5Screate_simple(2, dims, NULL)) < 0) TEST_ERROR
+    if(nelmts) {
+        buf = (void *)HDmalloc((size_t)(nelmts * msize));
+        if(buf == NULL) {
+            printf( "cannot read into memory\n" );
+            goto error;
+        }
+        if(H5Dread(dset_id, mtype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            goto error;
+    }
 
-    /* Create dcpl with special filter */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR
-    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) TEST_ERROR
+    if(H5Pclose(dcpl_id) < 0)
+        goto error;
+    if(H5Sclose(space_id) < 0)
+        goto error;
+    if(H5Dclose(dset_id) < 0)
+        goto error;
+    if(buf)
+        HDfree(buf);
 
-    /* Set gzip parameter (if available) */
-#ifdef H5_HAVE_FILTER_DEFLATE
-    if(H5Pset_deflate (dcpl, 9) < 0) TEST_ERROR
-#endif /* H5_HAVE_FILTER_DEFLATE */
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Pclose(dcpl_id);
+        H5Sclose(space_id);
+        H5Dclose(dset_id);
+        H5Tclose(ftype_id);
+        H5Tclose(mtype_id);
+        if(buf)
+            HDfree(buf);
+    } H5E_END_TRY;
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function: test_filters_endianess
+ *
+ * Purpose: Reads/writes data with filters (big-endian/little-endian data)
+ *
+ * Return: Success: 0
+ *  Failure: -1
+ *
+ * Programmer: Pedro Vicente
+ *              Monday, March 8, 2004
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_filters_endianess(void)
+{
+    hid_t     fid=-1;                   /* file ID */
+    hid_t     dsid=-1;                  /* dataset ID */
+    hid_t     sid=-1;                   /* dataspace ID */
+    hid_t     dcpl=-1;                  /* dataset creation property list ID */
+    const char *data_file = H5_get_srcdir_filename("test_filters_le.h5"); /* Corrected test file name */
 
-    /* Create first dataset */
-    if((dsid = H5Dcreate2(file, DSET_COMPARE_DCPL_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR
+    TESTING("filters with big-endian/little-endian data");
 
-    /* Get copy of dataset's dataset creation property list */
-    if((dcpl1=H5Dget_create_plist(dsid)) < 0) TEST_ERROR
+   /*-------------------------------------------------------------------------
+    * step 1: open a file written on a little-endian machine
+    *-------------------------------------------------------------------------
+    */
 
-    /* Close dataset */
-    if(H5Dclose (dsid) < 0) TEST_ERROR
+    /* open */
+    if((fid = H5Fopen(data_file, H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
 
-    /* Create second dataset */
-    if((dsid = H5Dcreate2(file, DSET_COMPARE_DCPL_NAME_2, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR
+    /* read */
+    if(auxread_fdata(fid,"dset") < 0) TEST_ERROR
 
-    /* Get copy of dataset's dataset creation property list */
-    if((dcpl2=H5Dget_create_plist(dsid)) < 0) TEST_ERROR
+    /* close */
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
-    /* Close dataset */
-    if(H5Dclose (dsid) < 0) TEST_ERROR
+   /*-------------------------------------------------------------------------
+    * step 2: open a file written on a big-endian machine
+    *-------------------------------------------------------------------------
+    */
 
-    /* Close dataspace */
-    if(H5Sclose(sid) < 0) TEST_ERROR
+    /* compose the name of the file to open, using the srcdir, if appropriate */
+    data_file = H5_get_srcdir_filename("test_filters_be.h5"); /* Corrected test file name */
 
-    /* Compare dataset creation property lists */
-    if(H5Pequal(dcpl1,dcpl2)<=0) TEST_ERROR
+    /* open */
+    if((fid = H5Fopen(data_file, H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
 
-    /* Close dataset creation property lists */
-    if(H5Pclose(dcpl) < 0) TEST_ERROR
-    if(H5Pclose(dcpl1) < 0) TEST_ERROR
-    if(H5Pclose(dcpl2) < 0) TEST_ERROR
+    /* read */
+    if(auxread_fdata(fid,"dset") < 0) TEST_ERROR
 
+    /* close */
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
     PASSED();
 
@@ -6226,789 +7495,754 @@ test_compare_dcpl(hid_t file)
 
 error:
     H5E_BEGIN_TRY {
+        H5Pclose(dcpl);
         H5Dclose(dsid);
         H5Sclose(sid);
-        H5Pclose(dcpl);
-        H5Pclose(dcpl1);
-        H5Pclose(dcpl2);
+        H5Fclose(fid);
     } H5E_END_TRY;
     return -1;
-} /* end test_compare_dcpl() */
+} /* end test_filters_endianess() */
 
 
 /*-------------------------------------------------------------------------
- * Function:    test_copy_dcpl
+ * Function: test_zero_dims
  *
- * Purpose:    Verifies whether the copy of dataset creation property
- *              list works.  It tests the DCPL for chunked layout with
- *              filter and for contiguous layout with external storage.
- *              (Please see #1608 in Bugzilla)
+ * Purpose: Tests read/writes to zero-sized extendible datasets
  *
- * Return:    Success:    0
- *        Failure:    -1
+ * Return: Success: 0
+ *  Failure: -1
  *
- * Programmer:    Raymond Lu
- *              28 January 2010
+ * Programmer: Quincey Koziol
+ *              Tuesday, July 27, 2004
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_copy_dcpl(hid_t file, hid_t fapl)
+test_zero_dims(hid_t file)
 {
-    hid_t       dsid1=(-1), dsid2=(-1);         /* Dataset ID */
-    hid_t       new_dsid1=(-1), new_dsid2=(-1); /* Dataset ID */
-    hid_t       sid=(-1);                       /* Dataspace ID */
-    hid_t       dcpl=(-1);                      /* Dataset creation property list ID */
-    hid_t       dcpl1=(-1),dcpl2=(-1);          /* Copies of creation property list IDs */
-    hid_t       dcpl1_copy=(-1),dcpl2_copy=(-1);/* Copies of creation property list IDs */
-    const hsize_t dims[2] = {500, 4096};        /* Dataspace dimensions */
-    const hsize_t chunk_dims[2] = {250, 2048};  /* Chunk dimensions */
-    char    filename[FILENAME_BUF_SIZE];
-    hid_t       new_file=(-1);
+    hid_t       s = -1, d = -1, dcpl = -1;
+    hid_t       s2 = -1, d2 = -1, dcpl2 = -1;
+    hsize_t     dzero = 0, dmax = H5S_UNLIMITED, csize = 5;
+    hsize_t     dzero2[2] = {0, 0};
+    hsize_t     dmax2[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
+    hsize_t    csize2[2] = {5, 5};
+    hid_t    fapl;        /* File access property list */
+    H5D_chunk_index_t idx_type; /* Dataset chunk index type */
+    H5F_libver_t low;           /* File format low bound */
+    herr_t      ret;
 
-    TESTING("copying dataset creation property lists");
+    TESTING("I/O on datasets with zero-sized dims");
 
-    /* Create the data space */
-    if((sid = H5Screate_simple(2, dims, NULL)) < 0) TEST_ERROR
+    /* Get the file's file access property list */
+    if((fapl = H5Fget_access_plist(file)) < 0) FAIL_STACK_ERROR
 
-    /* Create dcpl with special filter */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR
-    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) TEST_ERROR
-    if(H5Pset_fletcher32(dcpl) < 0) TEST_ERROR
+    /* Get library format */
+    if(H5Pget_libver_bounds(fapl, &low, NULL) < 0) FAIL_STACK_ERROR
 
-    /* Create first dataset of chunking with filter */
-    if((dsid1 = H5Dcreate2(file, DSET_COPY_DCPL_NAME_1, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl,
-        H5P_DEFAULT)) < 0) TEST_ERROR
+    /* Close FAPL */
+    if(H5Pclose(fapl) < 0) TEST_ERROR
 
-    /* Close dataset */
-    if(H5Dclose (dsid1) < 0) TEST_ERROR
+    /*
+     * One-dimensional dataset
+     */
+    if((s = H5Screate_simple(1, &dzero, &dmax)) < 0) FAIL_STACK_ERROR
 
-    /* Reopen the first dataset */
-    if((dsid1 = H5Dopen2(file, DSET_COPY_DCPL_NAME_1, H5P_DEFAULT)) < 0) TEST_ERROR
+    /* Try creating chunked dataset with undefined chunk dimensions */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_layout(dcpl, H5D_CHUNKED) < 0) FAIL_STACK_ERROR
 
-    /* Get the copy of dataset's creation property list */
-    if((dcpl1=H5Dget_create_plist(dsid1)) < 0) TEST_ERROR
-    if((dcpl1_copy = H5Pcopy(dcpl1)) < 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        d = H5Dcreate2(file, ZERODIM_DATASET, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(d > 0) {
+        H5Dclose(d);
+        FAIL_PUTS_ERROR("created dataset with undefined chunk dimensions")
+    } /* end if */
 
-    /* Close dataset */
-    if(H5Dclose (dsid1) < 0) TEST_ERROR
+    /* Try creating chunked dataset with zero-sized chunk dimensions */
+    H5E_BEGIN_TRY {
+        ret = H5Pset_chunk(dcpl, 1, &dzero);
+    } H5E_END_TRY;
+    if(ret > 0)
+        FAIL_PUTS_ERROR("set zero-sized chunk dimensions")
 
-    /* Change the DCPL for contiguous layout with external storage.  The size of the reserved
-     * space in the external file is the size of the dataset - 500*4096*sizeof(int).
-     * There's no need to clean up the external file since the library doesn't create it
-     * until the data is written to it. */
-    if(H5Pset_layout(dcpl, H5D_CONTIGUOUS) < 0) TEST_ERROR
-    if(H5Premove_filter(dcpl, H5Z_FILTER_FLETCHER32) < 0) TEST_ERROR
-    if(H5Pset_external(dcpl, COPY_DCPL_EXTFILE_NAME, (off_t)0, (hsize_t)(500 * 4096 * sizeof(int))) < 0) TEST_ERROR
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
 
-    /* Create second dataset of contiguous layout with external storage */
-    if((dsid2 = H5Dcreate2(file, DSET_COPY_DCPL_NAME_2, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl,
-        H5P_DEFAULT)) < 0) TEST_ERROR
+    /* Create the zero-sized extendible dataset */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 1, &csize) < 0) FAIL_STACK_ERROR
+    if((d = H5Dcreate2(file, ZERODIM_DATASET, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
 
-    /* Close dataset */
-    if(H5Dclose (dsid2) < 0) TEST_ERROR
+    /* Get the chunk index type */
+    if(H5D__layout_idx_type_test(d, &idx_type) < 0) FAIL_STACK_ERROR
 
-    /* Reopen the second dataset */
-    if((dsid2 = H5Dopen2(file, DSET_COPY_DCPL_NAME_2, H5P_DEFAULT)) < 0) TEST_ERROR
+    /* Verify index type */
+    if(low == H5F_LIBVER_LATEST) {
+    if(idx_type != H5D_CHUNK_IDX_EARRAY)
+        FAIL_PUTS_ERROR("should be using extensible array as index");
+    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
+    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
 
-    /* Get copy of dataset's dataset creation property list */
-    if((dcpl2=H5Dget_create_plist(dsid2)) < 0) TEST_ERROR
-    if((dcpl2_copy = H5Pcopy(dcpl2)) < 0) TEST_ERROR
+    /* Various no-op writes */
+    if(H5Dwrite(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
+    if(H5Dwrite(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
+    if(H5Dwrite(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
+    if(H5Dwrite(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
 
-    /* Close dataset */
-    if(H5Dclose (dsid2) < 0) TEST_ERROR
+    /* Various no-op reads */
+    if(H5Dread(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
+    if(H5Dread(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
+    if(H5Dread(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
+    if(H5Dread(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
 
-    /* Create a second file and create 2 datasets with the copies of the DCPLs in the first
-     * file.  Test whether the copies of DCPLs work. */
-    h5_fixname(FILENAME[13], fapl, filename, sizeof filename);
-    if((new_file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)) < 0)
-        TEST_ERROR
+    if(H5Dclose(d) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(s) < 0) FAIL_STACK_ERROR
 
-    if((new_dsid1 = H5Dcreate2(new_file, DSET_COPY_DCPL_NAME_1, H5T_NATIVE_INT, sid,
-            H5P_DEFAULT, dcpl1_copy, H5P_DEFAULT)) < 0) TEST_ERROR
+    /*
+     * Two-dimensional dataset
+     */
+    if((s2 = H5Screate_simple(2, dzero2, dmax2)) < 0) FAIL_STACK_ERROR
 
-    if((new_dsid2 = H5Dcreate2(new_file, DSET_COPY_DCPL_NAME_2, H5T_NATIVE_INT, sid,
-            H5P_DEFAULT, dcpl2_copy, H5P_DEFAULT)) < 0) TEST_ERROR
+    /* Try creating chunked dataset with undefined chunk dimensions */
+    if((dcpl2 = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_layout(dcpl2, H5D_CHUNKED) < 0) FAIL_STACK_ERROR
 
-    /* Close dataspace */
-    if(H5Sclose(sid) < 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        d2 = H5Dcreate2(file, ZERODIM_DATASET2, H5T_NATIVE_INT, s2, H5P_DEFAULT, dcpl2, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(d2 > 0) {
+        H5Dclose(d2);
+        FAIL_PUTS_ERROR("created dataset with undefined chunk dimensions")
+    } /* end if */
 
-    /* Close datasets */
-    if(H5Dclose (new_dsid1) < 0) TEST_ERROR
-    if(H5Dclose (new_dsid2) < 0) TEST_ERROR
+    /* Try creating chunked dataset with zero-sized chunk dimensions */
+    H5E_BEGIN_TRY {
+        ret = H5Pset_chunk(dcpl2, 2, dzero2);
+    } H5E_END_TRY;
+    if(ret > 0)
+        FAIL_PUTS_ERROR("set zero-sized chunk dimensions")
 
-    /* Close the second file */
-    if(H5Fclose (new_file) < 0) TEST_ERROR
+    if(H5Pclose(dcpl2) < 0) FAIL_STACK_ERROR
 
-    /* Close dataset creation property lists */
-    if(H5Pclose(dcpl) < 0) TEST_ERROR
-    if(H5Pclose(dcpl1) < 0) TEST_ERROR
-    if(H5Pclose(dcpl2) < 0) TEST_ERROR
-    if(H5Pclose(dcpl1_copy) < 0) TEST_ERROR
-    if(H5Pclose(dcpl2_copy) < 0) TEST_ERROR
+    /* Write to the zero-sized extendible dataset */
+    if((dcpl2 = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl2, 2, csize2) < 0) FAIL_STACK_ERROR
+
+    /* Create the dataset */
+    if((d2 = H5Dcreate2(file, ZERODIM_DATASET2, H5T_NATIVE_INT, s2, H5P_DEFAULT, dcpl2, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+
+    /* Get the chunk index type */
+    if(H5D__layout_idx_type_test(d2, &idx_type) < 0) FAIL_STACK_ERROR
+
+    /* Verify index type */
+    if(low == H5F_LIBVER_LATEST) {
+    if(idx_type != H5D_CHUNK_IDX_BT2)
+        FAIL_PUTS_ERROR("should be using v2 B-tree as index");
+    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
+    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
 
-    PASSED();
+    /* Just a no-op */
+    if(H5Dwrite(d2, H5T_NATIVE_INT, s2, s2, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
+
+    if(H5Dclose(d2) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dcpl2) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(s2) < 0) FAIL_STACK_ERROR
 
+    PASSED();
     return 0;
 
 error:
     H5E_BEGIN_TRY {
-        H5Dclose(dsid1);
-        H5Dclose(dsid2);
-        H5Dclose(new_dsid1);
-        H5Dclose(new_dsid2);
-        H5Sclose(sid);
+        H5Pclose(fapl);
+
         H5Pclose(dcpl);
-        H5Pclose(dcpl1);
+        H5Dclose(d);
+        H5Sclose(s);
+
         H5Pclose(dcpl2);
-        H5Pclose(dcpl1_copy);
-        H5Pclose(dcpl2_copy);
+        H5Dclose(d2);
+        H5Sclose(s2);
     } H5E_END_TRY;
     return -1;
-} /* end test_copy_dcpl() */
+} /* end test_zero_dims() */
 
 
 /*-------------------------------------------------------------------------
- * Function: test_filter_delete
+ * Function: test_missing_chunk
  *
- * Purpose: Tests deletion of filters from a dataset creation property list
+ * Purpose: Tests that reads from chunked dataset with undefined fill value and
+ *              not all chunks written don't overwrite data in user's buffer
+ *              for missing chunks.
  *
  * Return: Success: 0
  *  Failure: -1
  *
- * Programmer: Pedro Vicente
- *              Monday, January 26, 2004
+ * Programmer: Quincey Koziol
+ *              Tuesday, August 25, 2004
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_filter_delete(hid_t file)
+test_missing_chunk(hid_t file)
 {
-    H5Z_filter_t filtn;                 /* filter identification number */
-    hid_t        dsid=-1;                  /* dataset ID */
-    hid_t        sid=-1;                   /* dataspace ID */
-    hid_t        dcpl=-1;                  /* dataset creation property list ID */
-    hid_t        dcpl1=-1;                 /* dataset creation property list ID */
-    hsize_t      dims[2]={20,20};       /* dataspace dimensions */
-    hsize_t      chunk_dims[2]={10,10}; /* chunk dimensions */
-    int          nfilters;              /* number of filters in DCPL */
-    unsigned     flags;                 /* flags for filter */
-    herr_t       ret;                   /* generic return value */
-    int          i;
+    hid_t       d = -1, did2 = -1;        /* Dataset IDs */
+    hid_t    dcpl = -1, dcpl2 = -1;        /* Dataset creation property IDs */
+    hid_t       s = -1, sid2 = -1;         /* Dataspace ID */
+    hsize_t    hs_start[1], hs_stride[1], hs_count[1], hs_block[1];    /* Hyperslab setting */
+    hsize_t    hs_start2[2], hs_stride2[2], hs_count2[2], hs_block2[2];/* Hyperslab setting */
 
-    TESTING("filter deletion");
+    /* Buffers for reading/writing dataset */
+    int         wdata[MISSING_CHUNK_DIM],
+                rdata[MISSING_CHUNK_DIM];
+    int         wdata2[MISSING_CHUNK_DIM][MISSING_CHUNK_DIM],
+                rdata2[MISSING_CHUNK_DIM][MISSING_CHUNK_DIM];
 
-#ifdef H5_HAVE_FILTER_DEFLATE
-    /* create the data space */
-    if((sid = H5Screate_simple(2, dims, NULL)) < 0) goto error;
+    /* Setting for 1-D dataset */
+    hsize_t     dsize=100, dmax=H5S_UNLIMITED;
+    hsize_t    csize=5;
 
-    /* create dcpl  */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
-    if(H5Pset_chunk(dcpl, 2, chunk_dims) < 0) goto error;
+    /* Setting for 2-D dataset */
+    hsize_t     dsize2[2] = {100, 100}, dmax2[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
+    hsize_t    csize2[2] = {5, 5};
+    size_t      u, i, j;    /* Local Index variable */
 
-    if(H5Pset_fletcher32 (dcpl) < 0) goto error;
-    if(H5Pset_deflate (dcpl, 6) < 0) goto error;
-    if(H5Pset_shuffle (dcpl) < 0) goto error;
+    hid_t    fapl;        /* File access property list */
+    H5F_libver_t low;              /* File format low bound */
+    H5D_chunk_index_t idx_type, idx_type2;     /* Dataset chunk index types */
 
-    /* create a dataset */
-    if((dsid = H5Dcreate2(file,"dsetdel", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) goto error;
+    TESTING("Read dataset with unwritten chunk & undefined fill value");
 
-    /* get copy of dataset's dataset creation property list */
-    if((dcpl1=H5Dget_create_plist(dsid)) < 0) goto error;
+    /* Get the file's file access property list */
+    if((fapl = H5Fget_access_plist(file)) < 0) TEST_ERROR;
 
-   /*----------------------------------------------------------------------
-    * delete the deflate filter
-    *----------------------------------------------------------------------
-    */
-    /* delete the deflate filter */
-    if(H5Premove_filter(dcpl1,H5Z_FILTER_DEFLATE) < 0) goto error;
+    /* Get library format */
+    if(H5Pget_libver_bounds(fapl, &low, NULL) < 0) TEST_ERROR;
 
-    /* get information about filters */
-    if((nfilters = H5Pget_nfilters(dcpl1)) < 0) goto error;
+    /* Close FAPL */
+    if(H5Pclose(fapl) < 0) TEST_ERROR
 
-    /* check if filter was deleted */
-    for(i=0; i<nfilters; i++) {
-        filtn = H5Pget_filter2(dcpl1, (unsigned)i, NULL, NULL, NULL, (size_t)0, NULL, NULL);
-        if(H5Z_FILTER_DEFLATE==filtn)
-            goto error;
+    /* Initialize data for 1-D dataset */
+    for(u = 0; u < MISSING_CHUNK_DIM; u++) {
+        wdata[u] = (int)u;
+        rdata[u] = 911;
+    } /* end for */
+
+    /* Initialize data for 2-D dataset */
+    for(i = 0; i < MISSING_CHUNK_DIM; i++) {
+    for(j = 0; j < MISSING_CHUNK_DIM; j++) {
+        wdata2[i][j] = (int)(j + (i * MISSING_CHUNK_DIM));
+        rdata2[i][j] = 911;
     }
+    } /* end for */
 
-    /* try to get the info for the deflate filter */
-    H5E_BEGIN_TRY {
-        ret = H5Pget_filter_by_id2(dcpl1, H5Z_FILTER_DEFLATE, &flags, NULL, NULL, (size_t)0, NULL, NULL);
-    } H5E_END_TRY;
-    if(ret >=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't have deleted filter!\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Create dataspace */
+    if((s = H5Screate_simple(1, &dsize, &dmax)) < 0) TEST_ERROR;
+    if((sid2 = H5Screate_simple(2, dsize2, dmax2)) < 0) TEST_ERROR;
 
-    /* try to delete the deflate filter again */
-    H5E_BEGIN_TRY {
-        ret=H5Premove_filter(dcpl1,H5Z_FILTER_DEFLATE);
-    } H5E_END_TRY;
-    if(ret >=0) {
-        H5_FAILED();
-        printf("    Line %d: Shouldn't have deleted filter!\n",__LINE__);
-        goto error;
-    } /* end if */
+    /* Create dataset creation property list */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
+    if((dcpl2 = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
 
-   /*----------------------------------------------------------------------
-    * delete all filters
-    *----------------------------------------------------------------------
-    */
-    /* delete all filters */
-    if(H5Premove_filter(dcpl1,H5Z_FILTER_ALL) < 0) goto error;
+    /* Set to chunked */
+    if(H5Pset_chunk(dcpl, 1, &csize) < 0) TEST_ERROR;
+    if(H5Pset_chunk(dcpl2, 2, csize2) < 0) TEST_ERROR;
 
-    /* get information about filters */
-    if((nfilters = H5Pget_nfilters(dcpl1)) < 0) goto error;
+    /* Undefine fill value */
+    if(H5Pset_fill_value(dcpl, H5T_NATIVE_INT, NULL) < 0) TEST_ERROR;
+    if(H5Pset_fill_value(dcpl2, H5T_NATIVE_INT, NULL) < 0) TEST_ERROR;
 
-    /* check if filters were deleted */
-    if(nfilters)goto error;
+    /* Create the 1-D & 2-D datasets */
+    if((d = H5Dcreate2(file, MISSING_CHUNK_DATASET, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
+    if((did2 = H5Dcreate2(file, MISSING_CHUNK_DATASET2, H5T_NATIVE_INT, sid2, H5P_DEFAULT, dcpl2, H5P_DEFAULT)) < 0) TEST_ERROR;
 
-   /*----------------------------------------------------------------------
-    * close
-    *----------------------------------------------------------------------
-    */
+    /* Get the chunk index types */
+    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
+    if(H5D__layout_idx_type_test(did2, &idx_type2) < 0) TEST_ERROR;
 
-    /* clean up objects used for this test */
-    if(H5Pclose (dcpl) < 0) goto error;
-    if(H5Pclose (dcpl1) < 0) goto error;
-    if(H5Dclose (dsid) < 0) goto error;
-    if(H5Sclose (sid) < 0) goto error;
+    /* Verify index type */
+    if(low == H5F_LIBVER_LATEST) {
+        if(idx_type != H5D_CHUNK_IDX_EARRAY)
+            FAIL_PUTS_ERROR("should be using Extensible Array as index");
+        if(idx_type2 != H5D_CHUNK_IDX_BT2)
+            FAIL_PUTS_ERROR("should be using v2 B-tree as index");
+    } else {
+    if(idx_type != H5D_CHUNK_IDX_BTREE)
+        FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+    if(idx_type2 != H5D_CHUNK_IDX_BTREE)
+        FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+    }
 
-    PASSED();
-#else
-    SKIPPED();
-#endif
-    return 0;
+    /* Select elements in every other chunk for 1-D dataset */
+    hs_start[0]=0;
+    hs_stride[0]=10;
+    hs_count[0]=10;
+    hs_block[0]=5;
+    if(H5Sselect_hyperslab(s, H5S_SELECT_SET, hs_start, hs_stride, hs_count,
+                hs_block) < 0) TEST_ERROR;
 
-error:
-    H5E_BEGIN_TRY {
-        H5Pclose(dcpl);
-        H5Pclose(dcpl1);
-        H5Dclose(dsid);
-        H5Sclose(sid);
-    } H5E_END_TRY;
-    return -1;
-} /* end test_filter_delete() */
+    /* Select elements in every other chunk for 2-D dataset */
+    hs_start2[0] = hs_start2[1] = 0;
+    hs_stride2[0] = hs_stride2[1] = 10;
+    hs_count2[0] = hs_count2[1] = 10;
+    hs_block2[0] = hs_block2[1] = 5;
+    if(H5Sselect_hyperslab(sid2, H5S_SELECT_SET, hs_start2, hs_stride2, hs_count2,
+                hs_block2) < 0) TEST_ERROR;
 
+    /* Write selected data to the datasets */
+    if(H5Dwrite(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, wdata) < 0) TEST_ERROR;
+    if(H5Dwrite(did2, H5T_NATIVE_INT, sid2, sid2, H5P_DEFAULT, wdata2) < 0) TEST_ERROR;
 
+    /* Read all data from the datasets */
+    if(H5Dread(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0) TEST_ERROR;
+    if(H5Dread(did2, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata2) < 0) TEST_ERROR;
 
-/*-------------------------------------------------------------------------
- * Function: auxread_fdata
- *
- * Purpose: reads a dataset "NAME" from FID
- *
- * Return: Success: 0
- *  Failure: -1
- *
- * Programmer: Pedro Vicente
- *              Monday, March 8, 2004
- *
- *-------------------------------------------------------------------------
- */
-static herr_t
-auxread_fdata(hid_t fid, const char *name)
-{
-    hid_t     dset_id=-1;           /* dataset ID */
-    hid_t     dcpl_id=-1;           /* dataset creation property list ID */
-    hid_t     space_id=-1;          /* space ID */
-    hid_t     ftype_id=-1;          /* file data type ID */
-    hid_t     mtype_id=-1;          /* memory data type ID */
-    size_t    msize;             /* memory size of memory type */
-    void      *buf=NULL;         /* data buffer */
-    hsize_t   nelmts;            /* number of elements in dataset */
-    int       rank;              /* rank of dataset */
-    hsize_t   dims[H5S_MAX_RANK];/* dimensions of dataset */
-    int       i;
+    /* Validata values read for the 1-D dataset */
+    for(u=0; u<MISSING_CHUNK_DIM; u++) {
+        if((u%10)>=5) {
+            if(rdata[u]!=911) {
+                printf("    Line %d: Incorrect value, rdata[%u]=%d\n",__LINE__,(unsigned)u,rdata[u]);
+                TEST_ERROR;
+            } /* end if */
+        } /* end if */
+        else {
+            if(rdata[u]!=wdata[u]) {
+                printf("    Line %d: Incorrect value, wdata[%u]=%d, rdata[%u]=%d\n",__LINE__,(unsigned)u,wdata[u],(unsigned)u,rdata[u]);
+                TEST_ERROR;
+            } /* end if */
+        } /* end else */
+    } /* end for */
 
-    if((dset_id = H5Dopen2(fid, name, H5P_DEFAULT)) < 0)
-        goto error;
-    if((space_id = H5Dget_space(dset_id)) < 0)
-        goto error;
-    if((ftype_id = H5Dget_type(dset_id)) < 0)
-        goto error;
-    if((dcpl_id = H5Dget_create_plist(dset_id)) < 0)
-        goto error;
-    if((rank = H5Sget_simple_extent_ndims(space_id)) < 0)
-        goto error;
-    HDmemset(dims, 0, sizeof dims);
-    if(H5Sget_simple_extent_dims(space_id, dims, NULL) < 0)
-        goto error;
-    nelmts = 1;
-    for(i = 0; i < rank; i++)
-        nelmts *= dims[i];
-    if((mtype_id = H5Tget_native_type(ftype_id, H5T_DIR_DEFAULT)) < 0)
-        goto error;
-    if((msize = H5Tget_size(mtype_id)) == 0)
-        goto error;
+    /* Validata values read for the 2-D dataset */
+    for(i = 0; i < MISSING_CHUNK_DIM; i++) {
+    for(j = 0; j < MISSING_CHUNK_DIM; j++) {
 
-    if(nelmts) {
-        buf = (void *)HDmalloc((size_t)(nelmts * msize));
-        if(buf == NULL) {
-            printf( "cannot read into memory\n" );
-            goto error;
-        }
-        if(H5Dread(dset_id, mtype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
-            goto error;
-    }
+        if((i % 10) >= 5 || (j % 10) >= 5) {
+        if(rdata2[i][j] != 911) {
+            printf("    Line %d: Incorrect value, rdata2[%u][%u] = %d\n",
+            __LINE__,(unsigned)i, (unsigned)j, rdata2[i][j]);
+            TEST_ERROR;
+        } /* end if */
+        } /* end if */
+        else {
+        if(rdata2[i][j] != wdata2[i][j]) {
+            printf("    Line %d: Incorrect value, wdata2[%u][%u] = %d, rdata2[%u][%u] = %d\n",
+            __LINE__,(unsigned)i, (unsigned)j, wdata2[i][j],(unsigned)i, (unsigned)j, rdata2[i][j]);
+            TEST_ERROR;
+        } /* end if */
+        } /* end else */
+    } /* end for */
+    } /* end for */
 
-    if(H5Pclose(dcpl_id) < 0)
-        goto error;
-    if(H5Sclose(space_id) < 0)
-        goto error;
-    if(H5Dclose(dset_id) < 0)
-        goto error;
-    if(buf)
-        HDfree(buf);
+    /* Close everything */
+    if(H5Pclose(dcpl) < 0) TEST_ERROR;
+    if(H5Pclose(dcpl2) < 0) TEST_ERROR;
+    if(H5Sclose(s) < 0) TEST_ERROR;
+    if(H5Sclose(sid2) < 0) TEST_ERROR;
+    if(H5Dclose(d) < 0) TEST_ERROR;
+    if(H5Dclose(did2) < 0) TEST_ERROR;
 
+    PASSED();
     return 0;
 
 error:
     H5E_BEGIN_TRY {
-        H5Pclose(dcpl_id);
-        H5Sclose(space_id);
-        H5Dclose(dset_id);
-        H5Tclose(ftype_id);
-        H5Tclose(mtype_id);
-        if(buf)
-            HDfree(buf);
+        H5Pclose(fapl);
+
+        H5Pclose(dcpl);
+        H5Pclose(dcpl2);
+        H5Dclose(d);
+        H5Dclose(did2);
+        H5Sclose(s);
+        H5Sclose(sid2);
     } H5E_END_TRY;
     return -1;
-}
+} /* end test_missing_chunk() */
 
 
 /*-------------------------------------------------------------------------
- * Function: test_filters_endianess
+ * Function: test_random_chunks_real
+ *
+ * Purpose: Tests that write/read on randomly selected chunks
  *
- * Purpose: Reads/writes data with filters (big-endian/little-endian data)
  *
  * Return: Success: 0
  *  Failure: -1
  *
- * Programmer: Pedro Vicente
- *              Monday, March 8, 2004
+ * Programmer: Christian Chilan
+ *             Monday, March 26, 2007
  *
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_filters_endianess(void)
+test_random_chunks_real(const char *testname, hbool_t early_alloc, hid_t fapl)
 {
-    hid_t     fid=-1;                   /* file ID */
-    hid_t     dsid=-1;                  /* dataset ID */
-    hid_t     sid=-1;                   /* dataspace ID */
-    hid_t     dcpl=-1;                  /* dataset creation property list ID */
-    const char *data_file = H5_get_srcdir_filename("test_filters_le.h5"); /* Corrected test file name */
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       s=-1, m=-1, d=-1, dcpl=-1, file=-1;
+    int         wbuf[NPOINTS],
+                rbuf[NPOINTS],
+                check2[20][20];
+    hsize_t     coord[NPOINTS][2];
+    hsize_t     dsize[2]={100,100}, dmax[2]={H5S_UNLIMITED, H5S_UNLIMITED}, csize[2]={10,10}, nsize[2]={200,200};
+    hsize_t    fixed_dmax[2] = {1000, 1000};
+    hsize_t     msize[1]={NPOINTS};
+    const char  dname[]="dataset";
+    int         chunk_row, chunk_col;
+    size_t      i, j;
+    H5D_chunk_index_t idx_type; /* Dataset chunk index type */
+    H5F_libver_t low;           /* File format low bound */
 
-    TESTING("filters with big-endian/little-endian data");
 
-   /*-------------------------------------------------------------------------
-    * step 1: open a file written on a little-endian machine
-    *-------------------------------------------------------------------------
-    */
+    TESTING(testname);
 
-    /* open */
-    if((fid = H5Fopen(data_file, H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    assert(NPOINTS < 100);
 
-    /* read */
-    if(auxread_fdata(fid,"dset") < 0) TEST_ERROR
+    h5_fixname(FILENAME[6], fapl, filename, sizeof filename);
 
-    /* close */
-    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    if(H5Pget_libver_bounds(fapl, &low, NULL) < 0) TEST_ERROR;
 
-   /*-------------------------------------------------------------------------
-    * step 2: open a file written on a big-endian machine
-    *-------------------------------------------------------------------------
-    */
+    /* Create file for first test */
+    if((file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR;
 
-    /* compose the name of the file to open, using the srcdir, if appropriate */
-    data_file = H5_get_srcdir_filename("test_filters_be.h5"); /* Corrected test file name */
+    /* Create dataspace */
+    if((s = H5Screate_simple(2, dsize, NULL)) < 0) TEST_ERROR;
 
-    /* open */
-    if((fid = H5Fopen(data_file, H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    /* Create dataset creation property list */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
 
-    /* read */
-    if(auxread_fdata(fid,"dset") < 0) TEST_ERROR
+    /* Set chunked layout */
+    if(H5Pset_chunk(dcpl, 2, csize) < 0) TEST_ERROR;
 
-    /* close */
-    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    /* Set early allocation time for one dataset; the other dataset is using default alloc time */
+    if(early_alloc)
+        if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) TEST_ERROR;
 
-    PASSED();
+    /* Create dataset */
+    if((d = H5Dcreate2(file, dname, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
 
-    return 0;
+    /* Initialization of check array for repeated coordinates */
+    for(i=0; i<dsize[0]/csize[0]; i++)
+        for(j=0; j<dsize[1]/csize[1]; j++)
+            check2[i][j] = 0;
 
-error:
-    H5E_BEGIN_TRY {
-        H5Pclose(dcpl);
-        H5Dclose(dsid);
-        H5Sclose(sid);
-        H5Fclose(fid);
-    } H5E_END_TRY;
-    return -1;
-} /* end test_filters_endianess() */
+    /* Generate random point coordinates. Only one point is selected per chunk */
+    for(i=0; i<NPOINTS; i++){
+        do {
+            chunk_row = (int)HDrandom () % (int)(dsize[0]/csize[0]);
+            chunk_col = (int)HDrandom () % (int)(dsize[1]/csize[1]);
+        } while (check2[chunk_row][chunk_col]);
 
+        wbuf[i] = check2[chunk_row][chunk_col] = chunk_row+chunk_col+1;
+        coord[i][0] = (hsize_t)chunk_row * csize[0];
+        coord[i][1] = (hsize_t)chunk_col * csize[1];
+    }
 
-/*-------------------------------------------------------------------------
- * Function: test_zero_dims
- *
- * Purpose: Tests read/writes to zero-sized extendible datasets
- *
- * Return: Success: 0
- *  Failure: -1
- *
- * Programmer: Quincey Koziol
- *              Tuesday, July 27, 2004
- *
- *-------------------------------------------------------------------------
- */
-static herr_t
-test_zero_dims(hid_t file)
-{
-    hid_t       s = -1, d = -1, dcpl = -1;
-    hid_t       s2 = -1, d2 = -1, dcpl2 = -1;
-    hsize_t     dzero = 0, dmax = H5S_UNLIMITED, csize = 5;
-    hsize_t     dzero2[2] = {0, 0};
-    hsize_t     dmax2[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
-    hsize_t    csize2[2] = {5, 5};
-    hid_t    fapl;        /* File access property list */
-    H5D_chunk_index_t idx_type; /* Dataset chunk index type */
-    H5F_libver_t low;           /* File format low bound */
-    herr_t      ret;
+    /* Create dataspace for write buffer */
+    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
 
-    TESTING("I/O on datasets with zero-sized dims");
+    /* Select the random points for writing */
+    if(H5Sselect_elements(s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
 
-    /* Get the file's file access property list */
-    if((fapl = H5Fget_access_plist(file)) < 0) FAIL_STACK_ERROR
+    /* Write into dataset */
+    if(H5Dwrite(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, wbuf) < 0) TEST_ERROR;
+
+    /* Close resources*/
+    if(H5Sclose(s) < 0) TEST_ERROR;
+    if(H5Sclose(m) < 0) TEST_ERROR;
+    if(H5Pclose(dcpl) < 0) TEST_ERROR;
+    if(H5Dclose(d) < 0) TEST_ERROR;
+    if(H5Fclose(file) < 0) TEST_ERROR;
+
+    /* Open first file again */
+    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) TEST_ERROR;
+
+    /* Open dataset */
+    if((d = H5Dopen2(file, dname, H5P_DEFAULT)) < 0) TEST_ERROR;
+
+    /* Get the chunk index type */
+    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
+
+    /* Verify index type */
+    if(low == H5F_LIBVER_LATEST) {
+        if(early_alloc) {
+            if(idx_type != H5D_CHUNK_IDX_NONE)
+                FAIL_PUTS_ERROR("should be using Non-Index as index");
+        } /* end if */
+        else {
+            if(idx_type != H5D_CHUNK_IDX_FARRAY)
+                FAIL_PUTS_ERROR("should be using Fixed Array as index");
+        } /* end else */
+    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
+    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+
+    /* Get dataset dataspace */
+    if((s = H5Dget_space(d)) < 0) TEST_ERROR;
+
+    /* Create dataspace for read buffer */
+    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
+
+    /* Select the random points for reading */
+    if(H5Sselect_elements (s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+
+    /* Read from dataset */
+    if(H5Dread(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, rbuf) < 0) TEST_ERROR;
+
+    /* Verify that written and read data are the same */
+    for(i = 0; i < NPOINTS; i++)
+        if(rbuf[i] != wbuf[i]){
+            printf("    Line %d: Incorrect value, wbuf[%u]=%d, rbuf[%u]=%d\n",__LINE__,(unsigned)i,wbuf[i],(unsigned)i,rbuf[i]);
+            printf("             coord[%u] = {%lu, %lu}\n", (unsigned)i, (unsigned long)coord[i][0], (unsigned long)coord[i][1]);
+            TEST_ERROR;
+        } /* end if */
 
-    /* Get library format */
-    if(H5Pget_libver_bounds(fapl, &low, NULL) < 0) FAIL_STACK_ERROR
+    /* Close resources */
+    if(H5Sclose(s) < 0) TEST_ERROR;
+    if(H5Sclose(m) < 0) TEST_ERROR;
+    if(H5Dclose(d) < 0) TEST_ERROR;
+    if(H5Fclose(file) < 0) TEST_ERROR;
 
-    /* Close FAPL */
-    if(H5Pclose(fapl) < 0) TEST_ERROR
 
-    /*
-     * One-dimensional dataset
-     */
-    if((s = H5Screate_simple(1, &dzero, &dmax)) < 0) FAIL_STACK_ERROR
+    /* Create second file */
+    if((file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR;
 
-    /* Try creating chunked dataset with undefined chunk dimensions */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
-    if(H5Pset_layout(dcpl, H5D_CHUNKED) < 0) FAIL_STACK_ERROR
+    /* Create dataspace with unlimited maximum dimensions */
+    if(early_alloc) {
+    if((s = H5Screate_simple(2, dsize, fixed_dmax)) < 0) TEST_ERROR;
+    } else
+    if((s = H5Screate_simple(2, dsize, dmax)) < 0) TEST_ERROR;
 
-    H5E_BEGIN_TRY {
-        d = H5Dcreate2(file, ZERODIM_DATASET, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(d > 0) {
-        H5Dclose(d);
-        FAIL_PUTS_ERROR("created dataset with undefined chunk dimensions")
-    } /* end if */
+    /* Create dataset creation property list */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
 
-    /* Try creating chunked dataset with zero-sized chunk dimensions */
-    H5E_BEGIN_TRY {
-        ret = H5Pset_chunk(dcpl, 1, &dzero);
-    } H5E_END_TRY;
-    if(ret > 0)
-        FAIL_PUTS_ERROR("set zero-sized chunk dimensions")
+    /* Set chunked layout */
+    if(H5Pset_chunk(dcpl, 2, csize) < 0) TEST_ERROR;
 
-    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    /* Set early allocation time for one dataset; the other dataset is using default alloc time */
+    if(early_alloc)
+        if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) TEST_ERROR;
 
-    /* Create the zero-sized extendible dataset */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
-    if(H5Pset_chunk(dcpl, 1, &csize) < 0) FAIL_STACK_ERROR
-    if((d = H5Dcreate2(file, ZERODIM_DATASET, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    /* Create dataset */
+    if((d = H5Dcreate2(file, dname, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
 
     /* Get the chunk index type */
-    if(H5D__layout_idx_type_test(d, &idx_type) < 0) FAIL_STACK_ERROR
+    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
 
     /* Verify index type */
     if(low == H5F_LIBVER_LATEST) {
-    if(idx_type != H5D_CHUNK_IDX_EARRAY)
-        FAIL_PUTS_ERROR("should be using extensible array as index");
+    if(early_alloc) {
+        if(idx_type != H5D_CHUNK_IDX_NONE)
+        FAIL_PUTS_ERROR("should be using implicit indexing");
+    } else if(idx_type != H5D_CHUNK_IDX_BT2)
+        FAIL_PUTS_ERROR("should be using v2 B-tree as index");
     } else if(idx_type != H5D_CHUNK_IDX_BTREE)
     FAIL_PUTS_ERROR("should be using v1 B-tree as index");
 
-    /* Various no-op writes */
-    if(H5Dwrite(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
-    if(H5Dwrite(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
-    if(H5Dwrite(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
-    if(H5Dwrite(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
+    /* Extend both dimensions of the dataset */
+    if(H5Dset_extent(d, nsize) < 0) TEST_ERROR;
 
-    /* Various no-op reads */
-    if(H5Dread(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
-    if(H5Dread(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
-    if(H5Dread(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
-    if(H5Dread(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
+    /* Reset the dataset dataspace to new dimensions */
+    if(H5Sset_extent_simple(s, 2, nsize, dmax) < 0) TEST_ERROR;
 
-    if(H5Dclose(d) < 0) FAIL_STACK_ERROR
-    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
-    if(H5Sclose(s) < 0) FAIL_STACK_ERROR
+    /* Initialize check buffer for repeated coordinates */
+    for(i = 0; i < nsize[0]/csize[0]; i++)
+        for(j = 0; j < nsize[1] / csize[1]; j++)
+            check2[i][j] = 0;
 
-    /*
-     * Two-dimensional dataset
-     */
-    if((s2 = H5Screate_simple(2, dzero2, dmax2)) < 0) FAIL_STACK_ERROR
+    /* Generate random point coordinates. Only one point is selected per chunk */
+    for(i = 0; i < NPOINTS; i++){
+        do {
+            chunk_row = (int)HDrandom() % (int)(nsize[0] / csize[0]);
+            chunk_col = (int)HDrandom() % (int)(nsize[1] / csize[1]);
+        } while (check2[chunk_row][chunk_col]);
 
-    /* Try creating chunked dataset with undefined chunk dimensions */
-    if((dcpl2 = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
-    if(H5Pset_layout(dcpl2, H5D_CHUNKED) < 0) FAIL_STACK_ERROR
+        wbuf[i] = check2[chunk_row][chunk_col] = chunk_row + chunk_col + 1;
+        coord[i][0] = (hsize_t)chunk_row * csize[0];
+        coord[i][1] = (hsize_t)chunk_col * csize[1];
+    }
 
-    H5E_BEGIN_TRY {
-        d2 = H5Dcreate2(file, ZERODIM_DATASET2, H5T_NATIVE_INT, s2, H5P_DEFAULT, dcpl2, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(d2 > 0) {
-        H5Dclose(d2);
-        FAIL_PUTS_ERROR("created dataset with undefined chunk dimensions")
-    } /* end if */
+    /* Create dataspace for write buffer */
+    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
 
-    /* Try creating chunked dataset with zero-sized chunk dimensions */
-    H5E_BEGIN_TRY {
-        ret = H5Pset_chunk(dcpl2, 2, dzero2);
-    } H5E_END_TRY;
-    if(ret > 0)
-        FAIL_PUTS_ERROR("set zero-sized chunk dimensions")
+    /* Select the random points for writing */
+    if(H5Sselect_elements(s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
 
-    if(H5Pclose(dcpl2) < 0) FAIL_STACK_ERROR
+    /* Write into dataset */
+    if(H5Dwrite(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, wbuf) < 0) TEST_ERROR;
 
-    /* Write to the zero-sized extendible dataset */
-    if((dcpl2 = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
-    if(H5Pset_chunk(dcpl2, 2, csize2) < 0) FAIL_STACK_ERROR
+    /* Close resources */
+    if(H5Sclose(s) < 0) TEST_ERROR;
+    if(H5Sclose(m) < 0) TEST_ERROR;
+    if(H5Pclose(dcpl) < 0) TEST_ERROR;
+    if(H5Dclose(d) < 0) TEST_ERROR;
+    if(H5Fclose(file) < 0) TEST_ERROR;
 
-    /* Create the dataset */
-    if((d2 = H5Dcreate2(file, ZERODIM_DATASET2, H5T_NATIVE_INT, s2, H5P_DEFAULT, dcpl2, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    /* Open second file again */
+    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) TEST_ERROR;
 
-    /* Get the chunk index type */
-    if(H5D__layout_idx_type_test(d2, &idx_type) < 0) FAIL_STACK_ERROR
+    /* Open dataset */
+    if((d = H5Dopen2(file, dname, H5P_DEFAULT)) < 0) TEST_ERROR;
 
-    /* Verify index type */
-    if(low == H5F_LIBVER_LATEST) {
-    if(idx_type != H5D_CHUNK_IDX_BT2)
-        FAIL_PUTS_ERROR("should be using v2 B-tree as index");
-    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
-    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+    /* Get dataset dataspace */
+    if((s = H5Dget_space(d)) < 0) TEST_ERROR;
 
-    /* Just a no-op */
-    if(H5Dwrite(d2, H5T_NATIVE_INT, s2, s2, H5P_DEFAULT, (void*)911) < 0) FAIL_STACK_ERROR
+    /* Create dataspace for read buffer */
+    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
 
-    if(H5Dclose(d2) < 0) FAIL_STACK_ERROR
-    if(H5Pclose(dcpl2) < 0) FAIL_STACK_ERROR
-    if(H5Sclose(s2) < 0) FAIL_STACK_ERROR
+    /* Select the random points for reading */
+    if(H5Sselect_elements (s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
 
-    PASSED();
-    return 0;
+    /* Read from dataset */
+    if(H5Dread(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, rbuf) < 0) TEST_ERROR;
 
-error:
-    H5E_BEGIN_TRY {
-        H5Pclose(fapl);
+    /* Verify that written and read data are the same */
+    for(i = 0; i < NPOINTS; i++)
+        if(rbuf[i] != wbuf[i]){
+            printf("    Line %d: Incorrect value, wbuf[%u]=%d, rbuf[%u]=%d\n",__LINE__,(unsigned)i,wbuf[i],(unsigned)i,rbuf[i]);
+                TEST_ERROR;
+        } /* end if */
 
-        H5Pclose(dcpl);
-        H5Dclose(d);
-        H5Sclose(s);
+    /* Close resources */
+    if(H5Sclose(s) < 0) TEST_ERROR;
+    if(H5Sclose(m) < 0) TEST_ERROR;
+    if(H5Dclose(d) < 0) TEST_ERROR;
+    if(H5Fclose(file) < 0) TEST_ERROR;
 
-        H5Pclose(dcpl2);
-        H5Dclose(d2);
-        H5Sclose(s2);
-    } H5E_END_TRY;
-    return -1;
-} /* end test_zero_dims() */
 
+    /* Create third file */
+    if((file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR;
 
-/*-------------------------------------------------------------------------
- * Function: test_missing_chunk
- *
- * Purpose: Tests that reads from chunked dataset with undefined fill value and
- *              not all chunks written don't overwrite data in user's buffer
- *              for missing chunks.
- *
- * Return: Success: 0
- *  Failure: -1
- *
- * Programmer: Quincey Koziol
- *              Tuesday, August 25, 2004
- *
- *-------------------------------------------------------------------------
- */
-static herr_t
-test_missing_chunk(hid_t file)
-{
-    hid_t       d = -1, did2 = -1;        /* Dataset IDs */
-    hid_t    dcpl = -1, dcpl2 = -1;        /* Dataset creation property IDs */
-    hid_t       s = -1, sid2 = -1;         /* Dataspace ID */
-    hsize_t    hs_start[1], hs_stride[1], hs_count[1], hs_block[1];    /* Hyperslab setting */
-    hsize_t    hs_start2[2], hs_stride2[2], hs_count2[2], hs_block2[2];/* Hyperslab setting */
+    /* Create dataspace with fixed maximum dimensions */
+    if((s = H5Screate_simple(2, dsize, fixed_dmax)) < 0) TEST_ERROR;
 
-    /* Buffers for reading/writing dataset */
-    int         wdata[MISSING_CHUNK_DIM],
-                rdata[MISSING_CHUNK_DIM];
-    int         wdata2[MISSING_CHUNK_DIM][MISSING_CHUNK_DIM],
-                rdata2[MISSING_CHUNK_DIM][MISSING_CHUNK_DIM];
+    /* Create dataset creation property list */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
 
-    /* Setting for 1-D dataset */
-    hsize_t     dsize=100, dmax=H5S_UNLIMITED;
-    hsize_t    csize=5;
+    /* Set chunked layout */
+    if(H5Pset_chunk(dcpl, 2, csize) < 0) TEST_ERROR;
 
-    /* Setting for 2-D dataset */
-    hsize_t     dsize2[2] = {100, 100}, dmax2[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
-    hsize_t    csize2[2] = {5, 5};
-    size_t      u, i, j;    /* Local Index variable */
+    /* Set early allocation time for one dataset; the other dataset is using default alloc time */
+    if(early_alloc)
+        if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) TEST_ERROR;
 
-    hid_t    fapl;        /* File access property list */
-    H5F_libver_t low;              /* File format low bound */
-    H5D_chunk_index_t idx_type, idx_type2;     /* Dataset chunk index types */
+    /* Create dataset */
+    if((d = H5Dcreate2(file, dname, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
 
-    TESTING("Read dataset with unwritten chunk & undefined fill value");
+    /* Get the chunk index type */
+    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
 
-    /* Get the file's file access property list */
-    if((fapl = H5Fget_access_plist(file)) < 0) TEST_ERROR;
+    /* Verify index type */
+    if(low == H5F_LIBVER_LATEST) {
+        if(early_alloc) {
+            if(idx_type != H5D_CHUNK_IDX_NONE)
+                FAIL_PUTS_ERROR("should be using Non-Index as index");
+        } /* end if */
+        else {
+            if(idx_type != H5D_CHUNK_IDX_FARRAY)
+                FAIL_PUTS_ERROR("should be using Fixed Array as index");
+        } /* end else */
+    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
+    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
 
-    /* Get library format */
-    if(H5Pget_libver_bounds(fapl, &low, NULL) < 0) TEST_ERROR;
+    /* Extend both dimensions of the dataset */
+    if(H5Dset_extent(d, nsize) < 0) TEST_ERROR;
+
+    /* Reset the dataset dataspace to new dimensions */
+    if(H5Sset_extent_simple(s, 2, nsize, dmax) < 0) TEST_ERROR;
 
-    /* Close FAPL */
-    if(H5Pclose(fapl) < 0) TEST_ERROR
+    /* Initialize check buffer for repeated coordinates */
+    for(i = 0; i < nsize[0]/csize[0]; i++)
+        for(j = 0; j < nsize[1] / csize[1]; j++)
+            check2[i][j] = 0;
 
-    /* Initialize data for 1-D dataset */
-    for(u = 0; u < MISSING_CHUNK_DIM; u++) {
-        wdata[u] = (int)u;
-        rdata[u] = 911;
-    } /* end for */
+    /* Generate random point coordinates. Only one point is selected per chunk */
+    for(i = 0; i < NPOINTS; i++){
+        do {
+            chunk_row = (int)HDrandom() % (int)(nsize[0] / csize[0]);
+            chunk_col = (int)HDrandom() % (int)(nsize[1] / csize[1]);
+        } while (check2[chunk_row][chunk_col]);
 
-    /* Initialize data for 2-D dataset */
-    for(i = 0; i < MISSING_CHUNK_DIM; i++) {
-    for(j = 0; j < MISSING_CHUNK_DIM; j++) {
-        wdata2[i][j] = (int)(j + (i * MISSING_CHUNK_DIM));
-        rdata2[i][j] = 911;
+        wbuf[i] = check2[chunk_row][chunk_col] = chunk_row + chunk_col + 1;
+        coord[i][0] = (hsize_t)chunk_row * csize[0];
+        coord[i][1] = (hsize_t)chunk_col * csize[1];
     }
-    } /* end for */
-
-    /* Create dataspace */
-    if((s = H5Screate_simple(1, &dsize, &dmax)) < 0) TEST_ERROR;
-    if((sid2 = H5Screate_simple(2, dsize2, dmax2)) < 0) TEST_ERROR;
 
-    /* Create dataset creation property list */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
-    if((dcpl2 = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
+    /* Create dataspace for write buffer */
+    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
 
-    /* Set to chunked */
-    if(H5Pset_chunk(dcpl, 1, &csize) < 0) TEST_ERROR;
-    if(H5Pset_chunk(dcpl2, 2, csize2) < 0) TEST_ERROR;
+    /* Select the random points for writing */
+    if(H5Sselect_elements(s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
 
-    /* Undefine fill value */
-    if(H5Pset_fill_value(dcpl, H5T_NATIVE_INT, NULL) < 0) TEST_ERROR;
-    if(H5Pset_fill_value(dcpl2, H5T_NATIVE_INT, NULL) < 0) TEST_ERROR;
+    /* Write into dataset */
+    if(H5Dwrite(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, wbuf) < 0) TEST_ERROR;
 
-    /* Create the 1-D & 2-D datasets */
-    if((d = H5Dcreate2(file, MISSING_CHUNK_DATASET, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
-    if((did2 = H5Dcreate2(file, MISSING_CHUNK_DATASET2, H5T_NATIVE_INT, sid2, H5P_DEFAULT, dcpl2, H5P_DEFAULT)) < 0) TEST_ERROR;
+    /* Close resources */
+    if(H5Sclose(s) < 0) TEST_ERROR;
+    if(H5Sclose(m) < 0) TEST_ERROR;
+    if(H5Pclose(dcpl) < 0) TEST_ERROR;
+    if(H5Dclose(d) < 0) TEST_ERROR;
+    if(H5Fclose(file) < 0) TEST_ERROR;
 
-    /* Get the chunk index types */
-    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
-    if(H5D__layout_idx_type_test(did2, &idx_type2) < 0) TEST_ERROR;
+    /* Open third file again */
+    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) TEST_ERROR;
 
-    /* Verify index type */
-    if(low == H5F_LIBVER_LATEST) {
-        if(idx_type != H5D_CHUNK_IDX_EARRAY)
-            FAIL_PUTS_ERROR("should be using Extensible Array as index");
-        if(idx_type2 != H5D_CHUNK_IDX_BT2)
-            FAIL_PUTS_ERROR("should be using v2 B-tree as index");
-    } else {
-    if(idx_type != H5D_CHUNK_IDX_BTREE)
-        FAIL_PUTS_ERROR("should be using v1 B-tree as index");
-    if(idx_type2 != H5D_CHUNK_IDX_BTREE)
-        FAIL_PUTS_ERROR("should be using v1 B-tree as index");
-    }
+    /* Open dataset */
+    if((d = H5Dopen2(file, dname, H5P_DEFAULT)) < 0) TEST_ERROR;
 
-    /* Select elements in every other chunk for 1-D dataset */
-    hs_start[0]=0;
-    hs_stride[0]=10;
-    hs_count[0]=10;
-    hs_block[0]=5;
-    if(H5Sselect_hyperslab(s, H5S_SELECT_SET, hs_start, hs_stride, hs_count,
-                hs_block) < 0) TEST_ERROR;
+    /* Get dataset dataspace */
+    if((s = H5Dget_space(d)) < 0) TEST_ERROR;
 
-    /* Select elements in every other chunk for 2-D dataset */
-    hs_start2[0] = hs_start2[1] = 0;
-    hs_stride2[0] = hs_stride2[1] = 10;
-    hs_count2[0] = hs_count2[1] = 10;
-    hs_block2[0] = hs_block2[1] = 5;
-    if(H5Sselect_hyperslab(sid2, H5S_SELECT_SET, hs_start2, hs_stride2, hs_count2,
-                hs_block2) < 0) TEST_ERROR;
+    /* Create dataspace for read buffer */
+    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
 
-    /* Write selected data to the datasets */
-    if(H5Dwrite(d, H5T_NATIVE_INT, s, s, H5P_DEFAULT, wdata) < 0) TEST_ERROR;
-    if(H5Dwrite(did2, H5T_NATIVE_INT, sid2, sid2, H5P_DEFAULT, wdata2) < 0) TEST_ERROR;
+    /* Select the random points for reading */
+    if(H5Sselect_elements (s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
 
-    /* Read all data from the datasets */
-    if(H5Dread(d, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0) TEST_ERROR;
-    if(H5Dread(did2, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata2) < 0) TEST_ERROR;
+    /* Read from dataset */
+    if(H5Dread(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, rbuf) < 0) TEST_ERROR;
 
-    /* Validata values read for the 1-D dataset */
-    for(u=0; u<MISSING_CHUNK_DIM; u++) {
-        if((u%10)>=5) {
-            if(rdata[u]!=911) {
-                printf("    Line %d: Incorrect value, rdata[%u]=%d\n",__LINE__,(unsigned)u,rdata[u]);
-                TEST_ERROR;
-            } /* end if */
-        } /* end if */
-        else {
-            if(rdata[u]!=wdata[u]) {
-                printf("    Line %d: Incorrect value, wdata[%u]=%d, rdata[%u]=%d\n",__LINE__,(unsigned)u,wdata[u],(unsigned)u,rdata[u]);
+    /* Verify that written and read data are the same */
+    for(i = 0; i < NPOINTS; i++)
+        if(rbuf[i] != wbuf[i]){
+            printf("    Line %d: Incorrect value, wbuf[%u]=%d, rbuf[%u]=%d\n",__LINE__,(unsigned)i,wbuf[i],(unsigned)i,rbuf[i]);
                 TEST_ERROR;
-            } /* end if */
-        } /* end else */
-    } /* end for */
-
-    /* Validata values read for the 2-D dataset */
-    for(i = 0; i < MISSING_CHUNK_DIM; i++) {
-    for(j = 0; j < MISSING_CHUNK_DIM; j++) {
-
-        if((i % 10) >= 5 || (j % 10) >= 5) {
-        if(rdata2[i][j] != 911) {
-            printf("    Line %d: Incorrect value, rdata2[%u][%u] = %d\n",
-            __LINE__,(unsigned)i, (unsigned)j, rdata2[i][j]);
-            TEST_ERROR;
-        } /* end if */
-        } /* end if */
-        else {
-        if(rdata2[i][j] != wdata2[i][j]) {
-            printf("    Line %d: Incorrect value, wdata2[%u][%u] = %d, rdata2[%u][%u] = %d\n",
-            __LINE__,(unsigned)i, (unsigned)j, wdata2[i][j],(unsigned)i, (unsigned)j, rdata2[i][j]);
-            TEST_ERROR;
         } /* end if */
-        } /* end else */
-    } /* end for */
-    } /* end for */
 
-    /* Close everything */
-    if(H5Pclose(dcpl) < 0) TEST_ERROR;
-    if(H5Pclose(dcpl2) < 0) TEST_ERROR;
+    /* Close resources */
     if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(sid2) < 0) TEST_ERROR;
+    if(H5Sclose(m) < 0) TEST_ERROR;
     if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Dclose(did2) < 0) TEST_ERROR;
+    if(H5Fclose(file) < 0) TEST_ERROR;
 
     PASSED();
     return 0;
 
 error:
     H5E_BEGIN_TRY {
-        H5Pclose(fapl);
-
         H5Pclose(dcpl);
-        H5Pclose(dcpl2);
-        H5Dclose(d);
-        H5Dclose(did2);
         H5Sclose(s);
-        H5Sclose(sid2);
+        H5Sclose(m);
+        H5Dclose(d);
+        H5Fclose(file);
     } H5E_END_TRY;
     return -1;
-} /* end test_missing_chunk() */
+} /* end test_random_chunks_real() */
 
 
 /*-------------------------------------------------------------------------
- * Function: test_random_chunks_real
+ * Function: test_random_chunks
  *
  * Purpose: Tests that write/read on randomly selected chunks
+ *          First file:
+ *              One dataset has fixed dimensions without max. dims & H5D_ALLOC_TIME_EARLY
+ *              One dataset has fixed dimensions without max. dims & default alloc time
+ *         Second file:
+ *        One extendible dataset with unlimited max. dims & H5D_ALLOC_TIME_EARLY
+ *        One extendible dataset with unlimited max. dims & default alloc time
+ *        third file:
+ *        one extendible dataset with fixed max. dims & H5D_ALLOC_TIME_EARLY
+ *        one extendible dataset with fixed max. dims & default alloc time
+ *
+ *          All the datasets in second & third files are extended before write/read operations
  *
  *
  * Return: Success: 0
@@ -7020,928 +8254,1688 @@ error:
  *-------------------------------------------------------------------------
  */
 static herr_t
-test_random_chunks_real(const char *testname, hbool_t early_alloc, hid_t fapl)
+test_random_chunks(hid_t fapl)
 {
-    char        filename[FILENAME_BUF_SIZE];
-    hid_t       s=-1, m=-1, d=-1, dcpl=-1, file=-1;
-    int         wbuf[NPOINTS],
-                rbuf[NPOINTS],
-                check2[20][20];
-    hsize_t     coord[NPOINTS][2];
-    hsize_t     dsize[2]={100,100}, dmax[2]={H5S_UNLIMITED, H5S_UNLIMITED}, csize[2]={10,10}, nsize[2]={200,200};
-    hsize_t    fixed_dmax[2] = {1000, 1000};
-    hsize_t     msize[1]={NPOINTS};
-    const char  dname[]="dataset";
-    int         chunk_row, chunk_col;
-    size_t      i, j;
-    H5D_chunk_index_t idx_type; /* Dataset chunk index type */
-    H5F_libver_t low;           /* File format low bound */
+    int         nerrors = 0;    /* Errors in sub-tests */
+
+    nerrors += test_random_chunks_real("Write/read on randomly selected chunks w/non-implicit index", FALSE, fapl);
+    nerrors += test_random_chunks_real("Write/read on randomly selected chunks w/implicit index", TRUE, fapl);
 
+    return nerrors;;
+} /* end test_random_chunks() */
 
-    TESTING(testname);
+#ifndef H5_NO_DEPRECATED_SYMBOLS
+/* Empty can_apply and set_local callbacks */
+static htri_t
+can_apply_deprec(hid_t H5_ATTR_UNUSED dcpl_id, hid_t H5_ATTR_UNUSED type_id, hid_t H5_ATTR_UNUSED space_id)
+{
+    return 1;
+}
 
-    assert(NPOINTS < 100);
+static herr_t
+set_local_deprec(hid_t H5_ATTR_UNUSED dcpl_id, hid_t H5_ATTR_UNUSED type_id, hid_t H5_ATTR_UNUSED space_id)
+{
+    return(SUCCEED);
+}
 
-    h5_fixname(FILENAME[6], fapl, filename, sizeof filename);
+/* Old style H5Z_class_t, essentially a copy of the "bogus" filter */
+const H5Z_class1_t H5Z_DEPREC[1] = {{
+    H5Z_FILTER_DEPREC,        /* Filter id number        */
+    "deprec",            /* Filter name for debugging    */
+    can_apply_deprec,           /* The "can apply" callback     */
+    set_local_deprec,           /* The "set local" callback     */
+    filter_bogus,        /* The actual filter function    */
+}};
 
-    if(H5Pget_libver_bounds(fapl, &low, NULL) < 0) TEST_ERROR;
 
-    /* Create file for first test */
-    if((file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR;
+/*-------------------------------------------------------------------------
+ * Function: test_deprec
+ *
+ * Purpose: Tests deprecated API symbols
+ *
+ * Return: Success: 0
+ *  Failure: -1
+ *
+ * Programmer: Quincey Koziol
+ *             Monday, October 8, 2007
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_deprec(hid_t file)
+{
+    hid_t    dataset, space, small_space, create_parms, dcpl;
+    hsize_t    dims[2], small_dims[2];
+    hsize_t     deprec_size;
+    herr_t    status;
+    hsize_t    csize[2];
 
-    /* Create dataspace */
-    if((s = H5Screate_simple(2, dsize, NULL)) < 0) TEST_ERROR;
+    TESTING("deprecated API routines");
 
-    /* Create dataset creation property list */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
+    /* Create the data space */
+    dims[0] = 256;
+    dims[1] = 512;
+    space = H5Screate_simple(2, dims, NULL);
+    assert(space>=0);
 
-    /* Set chunked layout */
-    if(H5Pset_chunk(dcpl, 2, csize) < 0) TEST_ERROR;
+    /* Create a small data space for compact dataset */
+    small_dims[0] = 16;
+    small_dims[1] = 8;
+    small_space = H5Screate_simple(2, small_dims, NULL);
+    assert(space>=0);
 
-    /* Set early allocation time for one dataset; the other dataset is using default alloc time */
-    if(early_alloc)
-        if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) TEST_ERROR;
+    /*
+     * Create a dataset using the default dataset creation properties.    We're
+     * not sure what they are, so we won't check.
+     */
+    if((dataset = H5Dcreate1(file, DSET_DEPREC_NAME, H5T_NATIVE_DOUBLE, space, H5P_DEFAULT)) < 0) goto error;
 
-    /* Create dataset */
-    if((d = H5Dcreate2(file, dname, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
+    /* Close the dataset */
+    if(H5Dclose(dataset) < 0) goto error;
 
-    /* Initialization of check array for repeated coordinates */
-    for(i=0; i<dsize[0]/csize[0]; i++)
-        for(j=0; j<dsize[1]/csize[1]; j++)
-            check2[i][j] = 0;
+    /*
+     * Try creating a dataset that already exists.  This should fail since a
+     * dataset can only be created once.  Temporarily turn off error
+     * reporting.
+     */
+    H5E_BEGIN_TRY {
+    dataset = H5Dcreate1(file, DSET_DEFAULT_NAME, H5T_NATIVE_DOUBLE, space,
+                H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dataset >= 0) {
+    H5_FAILED();
+    puts("    Library allowed overwrite of existing dataset.");
+    goto error;
+    }
 
-    /* Generate random point coordinates. Only one point is selected per chunk */
-    for(i=0; i<NPOINTS; i++){
-        do {
-            chunk_row = (int)HDrandom () % (int)(dsize[0]/csize[0]);
-            chunk_col = (int)HDrandom () % (int)(dsize[1]/csize[1]);
-        } while (check2[chunk_row][chunk_col]);
+    /*
+     * Open the dataset we created above and then close it.  This is how
+     * existing datasets are accessed.
+     */
+    if((dataset = H5Dopen1(file, DSET_DEPREC_NAME)) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
 
-        wbuf[i] = check2[chunk_row][chunk_col] = chunk_row+chunk_col+1;
-        coord[i][0] = (hsize_t)chunk_row * csize[0];
-        coord[i][1] = (hsize_t)chunk_col * csize[1];
+    /*
+     * Try opening a non-existent dataset. This should fail since new datasets
+     * cannot be created with this function.  Temporarily turn off error
+     * reporting.
+     */
+    H5E_BEGIN_TRY {
+    dataset = H5Dopen1(file, "does_not_exist");
+    } H5E_END_TRY;
+    if(dataset >= 0) {
+    H5_FAILED();
+    puts("    Opened a non-existent dataset.");
+    goto error;
     }
 
-    /* Create dataspace for write buffer */
-    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
+    /*
+     * Create a new dataset that uses chunked storage instead of the default
+     * layout.
+     */
+    create_parms = H5Pcreate(H5P_DATASET_CREATE);
+    assert(create_parms >= 0);
 
-    /* Select the random points for writing */
-    if(H5Sselect_elements(s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+    /* Add the deflate filter, if available */
+#if defined H5_HAVE_FILTER_DEFLATE
+{
+    H5Z_filter_t filtn;                 /* filter identification number */
+    size_t cd_nelmts = 1;               /* Number of filter parameters */
+    unsigned cd_value;                  /* Filter parameter */
 
-    /* Write into dataset */
-    if(H5Dwrite(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, wbuf) < 0) TEST_ERROR;
+    if(H5Pset_deflate(create_parms, 6) < 0) goto error;
 
-    /* Close resources*/
-    if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(m) < 0) TEST_ERROR;
-    if(H5Pclose(dcpl) < 0) TEST_ERROR;
-    if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Fclose(file) < 0) TEST_ERROR;
+    /* Check for the deflate filter */
+    filtn = H5Pget_filter1(create_parms, (unsigned)0, NULL, &cd_nelmts, &cd_value, (size_t)0, NULL);
+    if(H5Z_FILTER_DEFLATE != filtn)
+        goto error;
+    if(1 != cd_nelmts)
+        goto error;
+    if(6 != cd_value)
+        goto error;
 
-    /* Open first file again */
-    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) TEST_ERROR;
+    /* Check for the deflate filter */
+    if(H5Pget_filter_by_id1(create_parms, H5Z_FILTER_DEFLATE, NULL, &cd_nelmts, &cd_value, (size_t)0, NULL) < 0) goto error;
+    if(1 != cd_nelmts)
+        goto error;
+    if(6 != cd_value)
+        goto error;
+}
+#endif /* H5_HAVE_FILTER_DEFLATE */
 
-    /* Open dataset */
-    if((d = H5Dopen2(file, dname, H5P_DEFAULT)) < 0) TEST_ERROR;
+    /* Attempt to create a dataset with invalid chunk sizes */
+    csize[0] = dims[0]*2;
+    csize[1] = dims[1]*2;
+    status = H5Pset_chunk(create_parms, 2, csize);
+    assert(status >= 0);
+    H5E_BEGIN_TRY {
+        dataset = H5Dcreate1(file, DSET_DEPREC_NAME_CHUNKED, H5T_NATIVE_DOUBLE, space,
+            create_parms);
+    } H5E_END_TRY;
+    if(dataset >= 0) {
+    H5_FAILED();
+    puts("    Opened a dataset with incorrect chunking parameters.");
+    goto error;
+    }
 
-    /* Get the chunk index type */
-    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
+    csize[0] = 5;
+    csize[1] = 100;
+    status = H5Pset_chunk(create_parms, 2, csize);
+    assert(status >= 0);
 
-    /* Verify index type */
-    if(low == H5F_LIBVER_LATEST) {
-        if(early_alloc) {
-            if(idx_type != H5D_CHUNK_IDX_NONE)
-                FAIL_PUTS_ERROR("should be using Non-Index as index");
-        } /* end if */
-        else {
-            if(idx_type != H5D_CHUNK_IDX_FARRAY)
-                FAIL_PUTS_ERROR("should be using Fixed Array as index");
-        } /* end else */
-    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
-    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+    if((dataset = H5Dcreate1(file, DSET_DEPREC_NAME_CHUNKED, H5T_NATIVE_DOUBLE, space, create_parms)) < 0) goto error;
+    H5Pclose(create_parms);
 
-    /* Get dataset dataspace */
-    if((s = H5Dget_space(d)) < 0) TEST_ERROR;
+    /*
+     * Close the chunked dataset.
+     */
+    if(H5Dclose(dataset) < 0) goto error;
 
-    /* Create dataspace for read buffer */
-    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
 
-    /* Select the random points for reading */
-    if(H5Sselect_elements (s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+    /*
+     * Open the dataset we created above and then close it.  This is how
+     * existing datasets are accessed.
+     */
+    if((dataset = H5Dopen1(file, DSET_DEPREC_NAME_CHUNKED)) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
 
-    /* Read from dataset */
-    if(H5Dread(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, rbuf) < 0) TEST_ERROR;
+    /*
+     * Create a compact dataset, then close it.
+     */
+    create_parms = H5Pcreate(H5P_DATASET_CREATE);
+    assert(create_parms >= 0);
+    status = H5Pset_layout(create_parms, H5D_COMPACT);
+    assert(status >= 0);
+    status = H5Pset_alloc_time(create_parms, H5D_ALLOC_TIME_EARLY);
+    assert(status >= 0);
 
-    /* Verify that written and read data are the same */
-    for(i = 0; i < NPOINTS; i++)
-        if(rbuf[i] != wbuf[i]){
-            printf("    Line %d: Incorrect value, wbuf[%u]=%d, rbuf[%u]=%d\n",__LINE__,(unsigned)i,wbuf[i],(unsigned)i,rbuf[i]);
-            printf("             coord[%u] = {%lu, %lu}\n", (unsigned)i, (unsigned long)coord[i][0], (unsigned long)coord[i][1]);
-            TEST_ERROR;
-        } /* end if */
+    if((dataset = H5Dcreate1(file, DSET_DEPREC_NAME_COMPACT, H5T_NATIVE_DOUBLE, small_space, create_parms)) < 0) goto error;
+    H5Pclose(create_parms);
+    if(H5Dclose(dataset) < 0) goto error;
 
-    /* Close resources */
-    if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(m) < 0) TEST_ERROR;
-    if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Fclose(file) < 0) TEST_ERROR;
+    /*
+     * Open the dataset we created above and then close it.  This is how
+     * existing datasets are accessed.
+     */
+    if((dataset = H5Dopen1(file, DSET_DEPREC_NAME_COMPACT)) < 0) goto error;
+    if(H5Dclose(dataset) < 0) goto error;
+
+    /* Test H5Zregister with deprecated H5Z_class1_t */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    if(H5Pset_chunk(dcpl, 2, csize) < 0) goto error;
+    if(H5Zregister(H5Z_DEPREC) < 0) goto error;
+    if(H5Pset_filter(dcpl, H5Z_FILTER_DEPREC, 0, (size_t)0, NULL) < 0) goto error;
 
+    puts("");
+    if(test_filter_internal(file,DSET_DEPREC_NAME_FILTER,dcpl,DISABLE_FLETCHER32,DATA_NOT_CORRUPTED,&deprec_size) < 0) goto error;
 
-    /* Create second file */
-    if((file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR;
+    if(H5Pclose(dcpl) < 0) goto error;
 
-    /* Create dataspace with unlimited maximum dimensions */
-    if(early_alloc) {
-    if((s = H5Screate_simple(2, dsize, fixed_dmax)) < 0) TEST_ERROR;
-    } else
-    if((s = H5Screate_simple(2, dsize, dmax)) < 0) TEST_ERROR;
+    return 0;
 
-    /* Create dataset creation property list */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
+ error:
+    return -1;
+} /* end test_deprec() */
+#endif /* H5_NO_DEPRECATED_SYMBOLS */
 
-    /* Set chunked layout */
-    if(H5Pset_chunk(dcpl, 2, csize) < 0) TEST_ERROR;
 
-    /* Set early allocation time for one dataset; the other dataset is using default alloc time */
-    if(early_alloc)
-        if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) TEST_ERROR;
+/*-------------------------------------------------------------------------
+ * Function: test_huge_chunks
+ *
+ * Purpose: Tests that datasets with chunks >4GB can't be created.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ * Programmer:  Quincey Koziol
+ *              Thursday, May  1, 2008
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_huge_chunks(hid_t fapl)
+{
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       fid = -1;       /* File ID */
+    hid_t       dcpl = -1;      /* Dataset creation property list ID */
+    hid_t       sid = -1;       /* Dataspace ID */
+    hid_t       dsid = -1;      /* Dataset ID */
+    hsize_t     dim, chunk_dim; /* Dataset and chunk dimensions */
+    hsize_t     dim2[3], chunk_dim2[3];  /* Dataset and chunk dimensions */
+    herr_t      ret;            /* Generic return value */
 
-    /* Create dataset */
-    if((d = H5Dcreate2(file, dname, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
+    TESTING("creating dataset with >4GB chunks");
 
-    /* Get the chunk index type */
-    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
+    h5_fixname(FILENAME[7], fapl, filename, sizeof filename);
 
-    /* Verify index type */
-    if(low == H5F_LIBVER_LATEST) {
-    if(early_alloc) {
-        if(idx_type != H5D_CHUNK_IDX_NONE)
-        FAIL_PUTS_ERROR("should be using implicit indexing");
-    } else if(idx_type != H5D_CHUNK_IDX_BT2)
-        FAIL_PUTS_ERROR("should be using v2 B-tree as index");
-    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
-    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+    /* Create file */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) FAIL_STACK_ERROR
 
-    /* Extend both dimensions of the dataset */
-    if(H5Dset_extent(d, nsize) < 0) TEST_ERROR;
+    /* Create dataset creation property list */
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
 
-    /* Reset the dataset dataspace to new dimensions */
-    if(H5Sset_extent_simple(s, 2, nsize, dmax) < 0) TEST_ERROR;
+    /* Try to set too large of a chunk for 1-D dataset (# of elements) */
+    chunk_dim = TOO_HUGE_CHUNK_DIM;
+    H5E_BEGIN_TRY {
+        ret = H5Pset_chunk(dcpl, 1, &chunk_dim);
+    } H5E_END_TRY;
+    if(ret >= 0)
+    FAIL_PUTS_ERROR("    Set chunk size with too large of chunk dimensions.")
 
-    /* Initialize check buffer for repeated coordinates */
-    for(i = 0; i < nsize[0]/csize[0]; i++)
-        for(j = 0; j < nsize[1] / csize[1]; j++)
-            check2[i][j] = 0;
+    /* Try to set too large of a chunk for n-D dataset (# of elements) */
+    chunk_dim2[0] = TOO_HUGE_CHUNK_DIM2_0;
+    chunk_dim2[1] = TOO_HUGE_CHUNK_DIM2_1;
+    chunk_dim2[2] = TOO_HUGE_CHUNK_DIM2_2;
+    H5E_BEGIN_TRY {
+        ret = H5Pset_chunk(dcpl, 3, chunk_dim2);
+    } H5E_END_TRY;
+    if(ret >= 0)
+    FAIL_PUTS_ERROR("    Set chunk size with too large of chunk dimensions.")
 
-    /* Generate random point coordinates. Only one point is selected per chunk */
-    for(i = 0; i < NPOINTS; i++){
-        do {
-            chunk_row = (int)HDrandom() % (int)(nsize[0] / csize[0]);
-            chunk_col = (int)HDrandom() % (int)(nsize[1] / csize[1]);
-        } while (check2[chunk_row][chunk_col]);
+    /* Set 1-D chunk size */
+    chunk_dim = HUGE_CHUNK_DIM;
+    if(H5Pset_chunk(dcpl, 1, &chunk_dim) < 0) FAIL_STACK_ERROR
 
-        wbuf[i] = check2[chunk_row][chunk_col] = chunk_row + chunk_col + 1;
-        coord[i][0] = (hsize_t)chunk_row * csize[0];
-        coord[i][1] = (hsize_t)chunk_col * csize[1];
-    }
+    /* Create 1-D dataspace */
+    dim = HUGE_DIM;
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
 
-    /* Create dataspace for write buffer */
-    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
+    /* Try to create dataset */
+    H5E_BEGIN_TRY {
+        dsid = H5Dcreate2(fid, HUGE_DATASET, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dsid >= 0)
+    FAIL_PUTS_ERROR("    1-D Dataset with too large of chunk dimensions created.")
 
-    /* Select the random points for writing */
-    if(H5Sselect_elements(s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+    /* Close 1-D dataspace */
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
 
-    /* Write into dataset */
-    if(H5Dwrite(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, wbuf) < 0) TEST_ERROR;
 
-    /* Close resources */
-    if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(m) < 0) TEST_ERROR;
-    if(H5Pclose(dcpl) < 0) TEST_ERROR;
-    if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Fclose(file) < 0) TEST_ERROR;
+    /* Set n-D chunk size */
+    chunk_dim2[0] = HUGE_CHUNK_DIM2_0;
+    chunk_dim2[1] = HUGE_CHUNK_DIM2_1;
+    chunk_dim2[2] = HUGE_CHUNK_DIM2_2;
+    if(H5Pset_chunk(dcpl, 3, chunk_dim2) < 0) FAIL_STACK_ERROR
 
-    /* Open second file again */
-    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) TEST_ERROR;
+    /* Create n-D dataspace */
+    dim2[0] = HUGE_DIM2_0;
+    dim2[1] = HUGE_DIM2_1;
+    dim2[2] = HUGE_DIM2_2;
+    if((sid = H5Screate_simple(3, dim2, NULL)) < 0) FAIL_STACK_ERROR
 
-    /* Open dataset */
-    if((d = H5Dopen2(file, dname, H5P_DEFAULT)) < 0) TEST_ERROR;
+    /* Try to create dataset */
+    H5E_BEGIN_TRY {
+        dsid = H5Dcreate2(fid, HUGE_DATASET2, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(dsid >= 0)
+    FAIL_PUTS_ERROR("    n-D Dataset with too large of chunk dimensions created.")
 
-    /* Get dataset dataspace */
-    if((s = H5Dget_space(d)) < 0) TEST_ERROR;
+    /* Close n-D dataspace */
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
 
-    /* Create dataspace for read buffer */
-    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
+    /* Close everything else */
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
-    /* Select the random points for reading */
-    if(H5Sselect_elements (s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+    PASSED();
+    return 0;
 
-    /* Read from dataset */
-    if(H5Dread(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, rbuf) < 0) TEST_ERROR;
+error:
+    H5E_BEGIN_TRY {
+        H5Pclose(dcpl);
+        H5Dclose(dsid);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    return -1;
+} /* end test_huge_chunks() */
 
-    /* Verify that written and read data are the same */
-    for(i = 0; i < NPOINTS; i++)
-        if(rbuf[i] != wbuf[i]){
-            printf("    Line %d: Incorrect value, wbuf[%u]=%d, rbuf[%u]=%d\n",__LINE__,(unsigned)i,wbuf[i],(unsigned)i,rbuf[i]);
-                TEST_ERROR;
-        } /* end if */
 
-    /* Close resources */
-    if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(m) < 0) TEST_ERROR;
-    if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Fclose(file) < 0) TEST_ERROR;
+/*-------------------------------------------------------------------------
+ * Function: test_chunk_cache
+ *
+ * Purpose: Tests API for setting rdcc info on a DAPL, and interaction
+ *          with the corresponding properties in the file structure.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ * Programmer:  Neil Fortner
+ *              Wednesday, October 29, 2008
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_chunk_cache(hid_t fapl)
+{
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       fid = -1;       /* File ID */
+    hid_t       fapl_local = -1; /* Local fapl */
+    hid_t       fapl_def = -1;  /* Default fapl */
+    hid_t       dcpl = -1;      /* Dataset creation property list ID */
+    hid_t       dapl1 = -1;     /* Dataset access property list ID */
+    hid_t       dapl2 = -1;     /* Dataset access property list ID */
+    hid_t       sid = -1;       /* Dataspace ID */
+    hid_t       dsid = -1;      /* Dataset ID */
+    hsize_t     dim, chunk_dim; /* Dataset and chunk dimensions */
+    size_t      nslots_1, nslots_2, nslots_3, nslots_4; /* rdcc number of elements */
+    size_t      nbytes_1, nbytes_2, nbytes_3, nbytes_4; /* rdcc number of bytes */
+    size_t      nlinks;         /* Number of link traversals */
+    double      w0_1, w0_2, w0_3, w0_4; /* rdcc preemption policy */
 
+    TESTING("dataset chunk cache configuration");
 
-    /* Create third file */
-    if((file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR;
+    /* Create a default fapl and dapl */
+    if ((fapl_def = H5Pcreate(H5P_FILE_ACCESS)) < 0) FAIL_STACK_ERROR
+    if ((dapl1 = H5Pcreate(H5P_DATASET_ACCESS)) < 0) FAIL_STACK_ERROR
 
-    /* Create dataspace with fixed maximum dimensions */
-    if((s = H5Screate_simple(2, dsize, fixed_dmax)) < 0) TEST_ERROR;
+    /* Verify that H5Pget_chunk_cache(dapl) returns the same values as are in
+     * the default fapl.
+     */
+    if (H5Pget_cache(fapl_def, NULL, &nslots_1, &nbytes_1, &w0_1) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl1, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_1 != nslots_4) || (nbytes_1 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_1, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from default dapl do not match those from fapl.")
 
-    /* Create dataset creation property list */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) TEST_ERROR;
+    /* Set a lapl property on dapl1 (to verify inheritance) */
+    if (H5Pset_nlinks(dapl1, (size_t)134) < 0) FAIL_STACK_ERROR
+    if (H5Pget_nlinks(dapl1, &nlinks) < 0) FAIL_STACK_ERROR
+    if (nlinks != 134)
+        FAIL_PUTS_ERROR("    nlinks parameter not set properly on dapl.")
 
-    /* Set chunked layout */
-    if(H5Pset_chunk(dcpl, 2, csize) < 0) TEST_ERROR;
+    /* Copy fapl passed to this function (as we will be modifying it) */
+    if ((fapl_local = H5Pcopy(fapl)) < 0) FAIL_STACK_ERROR
 
-    /* Set early allocation time for one dataset; the other dataset is using default alloc time */
-    if(early_alloc)
-        if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) TEST_ERROR;
+    /* Set new rdcc settings on fapl */
+    nslots_2 = nslots_1 * 2;
+    nbytes_2 = nbytes_1 * 2;
+    w0_2 = w0_1 / (double)2.0F;
+    if (H5Pset_cache(fapl_local, 0, nslots_2, nbytes_2, w0_2) < 0) FAIL_STACK_ERROR
 
-    /* Create dataset */
-    if((d = H5Dcreate2(file, dname, H5T_NATIVE_INT, s, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) TEST_ERROR;
+    h5_fixname(FILENAME[8], fapl, filename, sizeof filename);
 
-    /* Get the chunk index type */
-    if(H5D__layout_idx_type_test(d, &idx_type) < 0) TEST_ERROR;
+    /* Create file */
+    if ((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_local)) < 0) FAIL_STACK_ERROR
 
-    /* Verify index type */
-    if(low == H5F_LIBVER_LATEST) {
-        if(early_alloc) {
-            if(idx_type != H5D_CHUNK_IDX_NONE)
-                FAIL_PUTS_ERROR("should be using Non-Index as index");
-        } /* end if */
-        else {
-            if(idx_type != H5D_CHUNK_IDX_FARRAY)
-                FAIL_PUTS_ERROR("should be using Fixed Array as index");
-        } /* end else */
-    } else if(idx_type != H5D_CHUNK_IDX_BTREE)
-    FAIL_PUTS_ERROR("should be using v1 B-tree as index");
+    /* Create dataset creation property list */
+    if ((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
 
-    /* Extend both dimensions of the dataset */
-    if(H5Dset_extent(d, nsize) < 0) TEST_ERROR;
+    /* Set chunking */
+    chunk_dim = 10;
+    if (H5Pset_chunk(dcpl, 1, &chunk_dim) < 0) FAIL_STACK_ERROR
 
-    /* Reset the dataset dataspace to new dimensions */
-    if(H5Sset_extent_simple(s, 2, nsize, dmax) < 0) TEST_ERROR;
+    /* Create 1-D dataspace */
+    dim = 100;
+    if ((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
 
-    /* Initialize check buffer for repeated coordinates */
-    for(i = 0; i < nsize[0]/csize[0]; i++)
-        for(j = 0; j < nsize[1] / csize[1]; j++)
-            check2[i][j] = 0;
+    /* Create dataset with default dapl */
+    if ((dsid = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, dapl1)) < 0)
+        FAIL_STACK_ERROR
 
-    /* Generate random point coordinates. Only one point is selected per chunk */
-    for(i = 0; i < NPOINTS; i++){
-        do {
-            chunk_row = (int)HDrandom() % (int)(nsize[0] / csize[0]);
-            chunk_col = (int)HDrandom() % (int)(nsize[1] / csize[1]);
-        } while (check2[chunk_row][chunk_col]);
+    /* Retrieve dapl from dataset, verfiy cache values are the same as on fapl_local */
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
 
-        wbuf[i] = check2[chunk_row][chunk_col] = chunk_row + chunk_col + 1;
-        coord[i][0] = (hsize_t)chunk_row * csize[0];
-        coord[i][1] = (hsize_t)chunk_col * csize[1];
-    }
+    /* Set new values on dapl1.  nbytes will be set to default, so the file
+     * property will override this setting */
+    nslots_3 = nslots_2 * 2;
+    nbytes_3 = H5D_CHUNK_CACHE_NBYTES_DEFAULT;
+    w0_3 = w0_2 / 2;
+    if (H5Pset_chunk_cache(dapl1, nslots_3, nbytes_3, w0_3) < 0) FAIL_STACK_ERROR
 
-    /* Create dataspace for write buffer */
-    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
+    /* Close dataset, reopen with dapl1.  Note the use of a dapl with H5Oopen */
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if ((dsid = H5Oopen(fid, "dset", dapl1)) < 0) FAIL_STACK_ERROR
+
+    /* Retrieve dapl from dataset, verfiy cache values are the same as on dapl1 */
+    /* Note we rely on the knowledge that H5Pget_chunk_cache retrieves these
+     * values directly from the dataset structure, and not from a copy of the
+     * dapl used to open the dataset (which is not preserved).
+     */
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_3 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from dapl1.")
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
 
-    /* Select the random points for writing */
-    if(H5Sselect_elements(s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+    /* Close dataset, reopen with H5P_DEFAULT as dapl */
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if ((dsid = H5Dopen2(fid, "dset", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
 
-    /* Write into dataset */
-    if(H5Dwrite(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, wbuf) < 0) TEST_ERROR;
+    /* Retrieve dapl from dataset, verfiy cache values are the same on fapl_local */
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
 
-    /* Close resources */
-    if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(m) < 0) TEST_ERROR;
-    if(H5Pclose(dcpl) < 0) TEST_ERROR;
-    if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Fclose(file) < 0) TEST_ERROR;
+    /* Similary, test use of H5Dcreate2 with H5P_DEFAULT */
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if ((dsid = H5Dcreate2(fid, "dset2", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
+    /* Don't close dapl2, we will use it in the next section */
 
-    /* Open third file again */
-    if((file = H5Fopen(filename, H5F_ACC_RDWR, fapl)) < 0) TEST_ERROR;
+    /* Modify cache values on fapl_local */
+    nbytes_3 = nbytes_2 * 2;
+    if (H5Pset_cache(fapl_local, 0, nslots_3, nbytes_3, w0_3) < 0) FAIL_STACK_ERROR
 
-    /* Open dataset */
-    if((d = H5Dopen2(file, dname, H5P_DEFAULT)) < 0) TEST_ERROR;
+    /* Close and reopen file with new fapl_local */
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if (H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    if ((fid = H5Fopen(filename, H5F_ACC_RDWR, fapl_local)) < 0) FAIL_STACK_ERROR
 
-    /* Get dataset dataspace */
-    if((s = H5Dget_space(d)) < 0) TEST_ERROR;
+    /* Verify that dapl2 retrieved earlier (using values from the old fapl)
+     * sets its values in the new file (test use of H5Dopen2 with a dapl)
+     */
+    if ((dsid = H5Dopen2(fid, "dset", dapl2)) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR /* Close dapl2, to avoid id leak */
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from dapl2.")
 
-    /* Create dataspace for read buffer */
-    if((m = H5Screate_simple(1, msize, NULL)) < 0) TEST_ERROR;
+    /* Test H5D_CHUNK_CACHE_NSLOTS_DEFAULT and H5D_CHUNK_CACHE_W0_DEFAULT */
+    nslots_2 = H5D_CHUNK_CACHE_NSLOTS_DEFAULT;
+    w0_2 = H5D_CHUNK_CACHE_W0_DEFAULT;
+    if (H5Pset_chunk_cache(dapl2, nslots_2, nbytes_2, w0_2) < 0) FAIL_STACK_ERROR
 
-    /* Select the random points for reading */
-    if(H5Sselect_elements (s, H5S_SELECT_SET, (size_t)NPOINTS, (const hsize_t *)coord) < 0) TEST_ERROR;
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if ((dsid = H5Dopen2(fid, "dset", dapl2)) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR /* Close dapl2, to avoid id leak */
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_3 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those expected.")
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
 
-    /* Read from dataset */
-    if(H5Dread(d, H5T_NATIVE_INT, m, s, H5P_DEFAULT, rbuf) < 0) TEST_ERROR;
+    /* Verify that the file has indeed started using the new cache values (test
+     * use of H5Oopen with H5P_DEFAULT) */
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if ((dsid = H5Oopen(fid, "dset", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_3 != nslots_4) || (nbytes_3 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
 
-    /* Verify that written and read data are the same */
-    for(i = 0; i < NPOINTS; i++)
-        if(rbuf[i] != wbuf[i]){
-            printf("    Line %d: Incorrect value, wbuf[%u]=%d, rbuf[%u]=%d\n",__LINE__,(unsigned)i,wbuf[i],(unsigned)i,rbuf[i]);
-                TEST_ERROR;
-        } /* end if */
+    /* Verify functionality of H5Pcopy with a dapl */
+    if ((dapl2 = H5Pcopy(dapl1)) < 0) FAIL_STACK_ERROR
+    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
+    if ((nslots_3 != nslots_4) || (nbytes_1 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
+        FAIL_PUTS_ERROR("    Cache values from dapl2 do not match those from dapl1.")
 
-    /* Close resources */
-    if(H5Sclose(s) < 0) TEST_ERROR;
-    if(H5Sclose(m) < 0) TEST_ERROR;
-    if(H5Dclose(d) < 0) TEST_ERROR;
-    if(H5Fclose(file) < 0) TEST_ERROR;
+    /* Close */
+    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
+    if (H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(fapl_local) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(fapl_def) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(dapl1) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+    if (H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if (H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
     PASSED();
     return 0;
 
 error:
     H5E_BEGIN_TRY {
+        H5Pclose(fapl_local);
+        H5Pclose(fapl_def);
+        H5Pclose(dapl1);
+        H5Pclose(dapl2);
         H5Pclose(dcpl);
-        H5Sclose(s);
-        H5Sclose(m);
-        H5Dclose(d);
-        H5Fclose(file);
+        H5Dclose(dsid);
+        H5Sclose(sid);
+        H5Fclose(fid);
     } H5E_END_TRY;
     return -1;
-} /* end test_random_chunks_real() */
-
-
-/*-------------------------------------------------------------------------
- * Function: test_random_chunks
- *
- * Purpose: Tests that write/read on randomly selected chunks
- *          First file:
- *              One dataset has fixed dimensions without max. dims & H5D_ALLOC_TIME_EARLY
- *              One dataset has fixed dimensions without max. dims & default alloc time
- *         Second file:
- *        One extendible dataset with unlimited max. dims & H5D_ALLOC_TIME_EARLY
- *        One extendible dataset with unlimited max. dims & default alloc time
- *        third file:
- *        one extendible dataset with fixed max. dims & H5D_ALLOC_TIME_EARLY
- *        one extendible dataset with fixed max. dims & default alloc time
- *
- *          All the datasets in second & third files are extended before write/read operations
- *
- *
- * Return: Success: 0
- *  Failure: -1
- *
- * Programmer: Christian Chilan
- *             Monday, March 26, 2007
- *
- *-------------------------------------------------------------------------
- */
-static herr_t
-test_random_chunks(hid_t fapl)
-{
-    int         nerrors = 0;    /* Errors in sub-tests */
-
-    nerrors += test_random_chunks_real("Write/read on randomly selected chunks w/non-implicit index", FALSE, fapl);
-    nerrors += test_random_chunks_real("Write/read on randomly selected chunks w/implicit index", TRUE, fapl);
-
-    return nerrors;;
-} /* end test_random_chunks() */
-
-#ifndef H5_NO_DEPRECATED_SYMBOLS
-/* Empty can_apply and set_local callbacks */
-static htri_t
-can_apply_deprec(hid_t H5_ATTR_UNUSED dcpl_id, hid_t H5_ATTR_UNUSED type_id, hid_t H5_ATTR_UNUSED space_id)
-{
-    return 1;
-}
-
-static herr_t
-set_local_deprec(hid_t H5_ATTR_UNUSED dcpl_id, hid_t H5_ATTR_UNUSED type_id, hid_t H5_ATTR_UNUSED space_id)
-{
-    return(SUCCEED);
-}
-
-/* Old style H5Z_class_t, essentially a copy of the "bogus" filter */
-const H5Z_class1_t H5Z_DEPREC[1] = {{
-    H5Z_FILTER_DEPREC,        /* Filter id number        */
-    "deprec",            /* Filter name for debugging    */
-    can_apply_deprec,           /* The "can apply" callback     */
-    set_local_deprec,           /* The "set local" callback     */
-    filter_bogus,        /* The actual filter function    */
-}};
+} /* end test_chunk_cache() */
 
 
 /*-------------------------------------------------------------------------
- * Function: test_deprec
- *
- * Purpose: Tests deprecated API symbols
+ * Function: test_shared_chunk_cache
  *
- * Return: Success: 0
- *  Failure: -1
+ * Purpose: Tests the chunk cache budget shared by all the datasets in a
+ *          file: that the datasets' caches stay within it together, that
+ *          chunks are preempted from the dataset caching the most, and
+ *          that dirty chunks preempted for another dataset are written.
  *
- * Programmer: Quincey Koziol
- *             Monday, October 8, 2007
+ * Return:      Success: 0
+ *              Failure: -1
  *
  *-------------------------------------------------------------------------
  */
+#define SHARED_CACHE_DIM        32
+#define SHARED_CACHE_CHUNK      8
+#define SHARED_CACHE_NDSETS     3
+#define SHARED_CACHE_CHUNK_SIZE (SHARED_CACHE_CHUNK * SHARED_CACHE_CHUNK * sizeof(int))
+#define SHARED_CACHE_NBYTES     (4 * SHARED_CACHE_CHUNK_SIZE)
 static herr_t
-test_deprec(hid_t file)
+test_shared_chunk_cache(hid_t fapl)
 {
-    hid_t    dataset, space, small_space, create_parms, dcpl;
-    hsize_t    dims[2], small_dims[2];
-    hsize_t     deprec_size;
-    herr_t    status;
-    hsize_t    csize[2];
-
-    TESTING("deprecated API routines");
-
-    /* Create the data space */
-    dims[0] = 256;
-    dims[1] = 512;
-    space = H5Screate_simple(2, dims, NULL);
-    assert(space>=0);
+    char        filename[FILENAME_BUF_SIZE];
+    char        dname[32];              /* Dataset name */
+    hid_t       fid = -1;               /* File ID */
+    hid_t       my_fapl = -1;           /* FAPL ID */
+    hid_t       fapl2 = -1;             /* FAPL ID, from file */
+    hid_t       dcpl = -1;              /* DCPL ID */
+    hid_t       sid = -1;               /* Dataspace ID */
+    hid_t       mid = -1;               /* Memory dataspace ID */
+    hid_t       did[SHARED_CACHE_NDSETS] = {-1, -1, -1};    /* Dataset IDs */
+    hid_t       did2 = -1;              /* Second handle for a dataset */
+    hsize_t     dim[2] = {SHARED_CACHE_DIM, SHARED_CACHE_DIM};  /* Dataset dimensions */
+    hsize_t     cdim[2] = {SHARED_CACHE_CHUNK, SHARED_CACHE_CHUNK}; /* Chunk dimensions */
+    hsize_t     start[2] = {0, 0};      /* Hyperslab start */
+    int         wbuf[SHARED_CACHE_NDSETS][SHARED_CACHE_DIM][SHARED_CACHE_DIM];  /* Write buffers */
+    int         rbuf[SHARED_CACHE_DIM][SHARED_CACHE_DIM];   /* Read buffer */
+    size_t      nbytes;                 /* Budget size */
+    size_t      shared_used;            /* Bytes used from the budget */
+    size_t      nbytes_used[SHARED_CACHE_NDSETS];   /* Bytes cached by each dataset */
+    unsigned    nshared;                /* # of chunks preempted for the budget */
+    unsigned    u, v, w;                /* Local index variables */
+
+    TESTING("chunk cache shared by all datasets in a file");
+
+    h5_fixname(FILENAME[27], fapl, filename, sizeof filename);
+
+    /* Check the property.  Each dataset's own cache is larger than the
+     * budget, so that only the budget limits them. */
+    if((my_fapl = H5Pcopy(fapl)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_cache(my_fapl, 0, (size_t)521, (size_t)(2 * SHARED_CACHE_NBYTES), 0.75F) < 0) FAIL_STACK_ERROR
+    if(H5Pget_shared_chunk_cache(my_fapl, &nbytes) < 0) FAIL_STACK_ERROR
+    if(nbytes != 0) FAIL_PUTS_ERROR("    Default shared chunk cache size isn't 0.")
+    if(H5Pset_shared_chunk_cache(my_fapl, (size_t)SHARED_CACHE_NBYTES) < 0) FAIL_STACK_ERROR
+    if(H5Pget_shared_chunk_cache(my_fapl, &nbytes) < 0) FAIL_STACK_ERROR
+    if(nbytes != SHARED_CACHE_NBYTES) FAIL_PUTS_ERROR("    Shared chunk cache size wasn't set.")
+
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++)
+        for(v = 0; v < SHARED_CACHE_DIM; v++)
+            for(w = 0; w < SHARED_CACHE_DIM; w++)
+                wbuf[u][v][w] = (int)((u * SHARED_CACHE_DIM + v) * SHARED_CACHE_DIM + w);
+
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, my_fapl)) < 0) FAIL_STACK_ERROR
+
+    /* Make sure the setting is retrieved from the file */
+    if((fapl2 = H5Fget_access_plist(fid)) < 0) FAIL_STACK_ERROR
+    if(H5Pget_shared_chunk_cache(fapl2, &nbytes) < 0) FAIL_STACK_ERROR
+    if(nbytes != SHARED_CACHE_NBYTES) FAIL_PUTS_ERROR("    Shared chunk cache size from file doesn't match.")
+    if(H5Pclose(fapl2) < 0) FAIL_STACK_ERROR
+
+    /* Create the datasets and write all of them, so that dirty chunks are
+     * preempted from the first datasets for the later ones */
+    if((sid = H5Screate_simple(2, dim, NULL)) < 0) FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 2, cdim) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++) {
+        HDsnprintf(dname, sizeof(dname), "dset%u", u);
+        if((did[u] = H5Dcreate2(fid, dname, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+        if(H5Dwrite(did[u], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf[u]) < 0) FAIL_STACK_ERROR
+    } /* end for */
 
-    /* Create a small data space for compact dataset */
-    small_dims[0] = 16;
-    small_dims[1] = 8;
-    small_space = H5Screate_simple(2, small_dims, NULL);
-    assert(space>=0);
+    /* The datasets' caches should stay within the budget together */
+    if(H5D__shared_cache_size_test(did[0], &shared_used, NULL) < 0) FAIL_STACK_ERROR
+    for(u = 0, nbytes = 0; u < SHARED_CACHE_NDSETS; u++) {
+        if(H5D__current_cache_size_test(did[u], &nbytes_used[u], NULL) < 0) FAIL_STACK_ERROR
+        nbytes += nbytes_used[u];
+    } /* end for */
+    if(shared_used != nbytes) FAIL_PUTS_ERROR("    Shared budget doesn't match datasets' caches.")
+    if(shared_used > SHARED_CACHE_NBYTES) FAIL_PUTS_ERROR("    Datasets' caches are over the shared budget.")
+    if(H5D__shared_cache_size_test(did[0], NULL, &nshared) < 0) FAIL_STACK_ERROR
+    if(nshared == 0) FAIL_PUTS_ERROR("    No chunks were preempted for the shared budget.")
 
-    /*
-     * Create a dataset using the default dataset creation properties.    We're
-     * not sure what they are, so we won't check.
-     */
-    if((dataset = H5Dcreate1(file, DSET_DEPREC_NAME, H5T_NATIVE_DOUBLE, space, H5P_DEFAULT)) < 0) goto error;
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++)
+        if(H5Dclose(did[u]) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
-    /* Close the dataset */
-    if(H5Dclose(dataset) < 0) goto error;
+    /* Re-open the file and check the data */
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, my_fapl)) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++) {
+        HDsnprintf(dname, sizeof(dname), "dset%u", u);
+        if((did[u] = H5Dopen2(fid, dname, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+        if(H5Dread(did[u], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+        if(HDmemcmp(rbuf, wbuf[u], sizeof(rbuf)) != 0) FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+    } /* end for */
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++)
+        if(H5Dclose(did[u]) < 0) FAIL_STACK_ERROR
+
+    /* Read one chunk at a time: the first dataset fills the budget, then
+     * chunks should be preempted from whichever dataset is caching the most */
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++) {
+        HDsnprintf(dname, sizeof(dname), "dset%u", u);
+        if((did[u] = H5Dopen2(fid, dname, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    } /* end for */
+    if((mid = H5Screate_simple(2, cdim, NULL)) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < 4; u++) {
+        start[1] = u * SHARED_CACHE_CHUNK;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, cdim, NULL) < 0) FAIL_STACK_ERROR
+        if(H5Dread(did[0], H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+        if(u < 2 && H5Dread(did[1], H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+    } /* end for */
+    if(H5D__current_cache_size_test(did[0], &nbytes_used[0], NULL) < 0) FAIL_STACK_ERROR
+    if(H5D__current_cache_size_test(did[1], &nbytes_used[1], NULL) < 0) FAIL_STACK_ERROR
+    if(nbytes_used[0] != 2 * SHARED_CACHE_CHUNK_SIZE || nbytes_used[1] != 2 * SHARED_CACHE_CHUNK_SIZE)
+        FAIL_PUTS_ERROR("    Chunks weren't preempted fairly.")
+    if(H5D__shared_cache_size_test(did[0], NULL, &nshared) < 0) FAIL_STACK_ERROR
+    if(nshared != 2) FAIL_PUTS_ERROR("    Wrong # of chunks preempted for the shared budget.")
+
+    /* Close the handle used to preempt the first dataset's chunks while
+     * another is open, then read more */
+    if((did2 = H5Dopen2(fid, "dset0", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    if(H5Dclose(did[0]) < 0) FAIL_STACK_ERROR
+    did[0] = did2;
+    did2 = -1;
+    for(u = 0; u < 4; u++) {
+        start[1] = u * SHARED_CACHE_CHUNK;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, cdim, NULL) < 0) FAIL_STACK_ERROR
+        for(v = 0; v < SHARED_CACHE_NDSETS; v++) {
+            if(H5Dread(did[v], H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+            for(w = 0; w < SHARED_CACHE_CHUNK * SHARED_CACHE_CHUNK; w++)
+                if(((int *)rbuf)[w] != wbuf[v][w / SHARED_CACHE_CHUNK][start[1] + w % SHARED_CACHE_CHUNK])
+                    FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+        } /* end for */
+    } /* end for */
+    if(H5D__shared_cache_size_test(did[0], &shared_used, NULL) < 0) FAIL_STACK_ERROR
+    if(shared_used > SHARED_CACHE_NBYTES) FAIL_PUTS_ERROR("    Datasets' caches are over the shared budget.")
 
-    /*
-     * Try creating a dataset that already exists.  This should fail since a
-     * dataset can only be created once.  Temporarily turn off error
-     * reporting.
-     */
-    H5E_BEGIN_TRY {
-    dataset = H5Dcreate1(file, DSET_DEFAULT_NAME, H5T_NATIVE_DOUBLE, space,
-                H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dataset >= 0) {
-    H5_FAILED();
-    puts("    Library allowed overwrite of existing dataset.");
-    goto error;
-    }
+    for(u = 0; u < SHARED_CACHE_NDSETS; u++)
+        if(H5Dclose(did[u]) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(mid) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(my_fapl) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
-    /*
-     * Open the dataset we created above and then close it.  This is how
-     * existing datasets are accessed.
-     */
-    if((dataset = H5Dopen1(file, DSET_DEPREC_NAME)) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
+    PASSED();
+    return 0;
 
-    /*
-     * Try opening a non-existent dataset. This should fail since new datasets
-     * cannot be created with this function.  Temporarily turn off error
-     * reporting.
-     */
+error:
     H5E_BEGIN_TRY {
-    dataset = H5Dopen1(file, "does_not_exist");
+        for(u = 0; u < SHARED_CACHE_NDSETS; u++)
+            H5Dclose(did[u]);
+        H5Dclose(did2);
+        H5Pclose(fapl2);
+        H5Pclose(my_fapl);
+        H5Pclose(dcpl);
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Fclose(fid);
     } H5E_END_TRY;
-    if(dataset >= 0) {
-    H5_FAILED();
-    puts("    Opened a non-existent dataset.");
-    goto error;
-    }
+    return -1;
+} /* end test_shared_chunk_cache() */
 
-    /*
-     * Create a new dataset that uses chunked storage instead of the default
-     * layout.
-     */
-    create_parms = H5Pcreate(H5P_DATASET_CREATE);
-    assert(create_parms >= 0);
 
-    /* Add the deflate filter, if available */
-#if defined H5_HAVE_FILTER_DEFLATE
+/*-------------------------------------------------------------------------
+ * Function: read_policy_chunks
+ *
+ * Purpose: Helper for test_chunk_cache_policy: reads chunks FIRST through
+ *          FIRST + N - 1 of a 1-D dataset, one chunk at a time, checks
+ *          the data and returns the # of chunk cache misses.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ *-------------------------------------------------------------------------
+ */
+#define POLICY_CHUNK            256
+#define POLICY_NCHUNKS          64
+static herr_t
+read_policy_chunks(hid_t did, hsize_t first, hsize_t n, unsigned *nmisses)
 {
-    H5Z_filter_t filtn;                 /* filter identification number */
-    size_t cd_nelmts = 1;               /* Number of filter parameters */
-    unsigned cd_value;                  /* Filter parameter */
+    hid_t       sid = -1, mid = -1;     /* Dataspace IDs */
+    hsize_t     start, count = POLICY_CHUNK;    /* Hyperslab selection */
+    int         rbuf[POLICY_CHUNK];     /* Read buffer */
+    unsigned    nmisses_before, nmisses_after;  /* Chunk cache misses */
+    hsize_t     u;                      /* Local index variable */
+    int         v;                      /* Local index variable */
+
+    if(H5Dget_chunk_cache_stats(did, NULL, &nmisses_before) < 0) FAIL_STACK_ERROR
+    if((sid = H5Dget_space(did)) < 0) FAIL_STACK_ERROR
+    if((mid = H5Screate_simple(1, &count, NULL)) < 0) FAIL_STACK_ERROR
+    for(u = first; u < first + n; u++) {
+        start = u * POLICY_CHUNK;
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL) < 0) FAIL_STACK_ERROR
+        if(H5Dread(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+        for(v = 0; v < POLICY_CHUNK; v++)
+            if(rbuf[v] != (int)start + v)
+                FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+    } /* end for */
+    if(H5Sclose(mid) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Dget_chunk_cache_stats(did, NULL, &nmisses_after) < 0) FAIL_STACK_ERROR
 
-    if(H5Pset_deflate(create_parms, 6) < 0) goto error;
+    *nmisses = nmisses_after - nmisses_before;
+    return 0;
 
-    /* Check for the deflate filter */
-    filtn = H5Pget_filter1(create_parms, (unsigned)0, NULL, &cd_nelmts, &cd_value, (size_t)0, NULL);
-    if(H5Z_FILTER_DEFLATE != filtn)
-        goto error;
-    if(1 != cd_nelmts)
-        goto error;
-    if(6 != cd_value)
-        goto error;
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mid);
+        H5Sclose(sid);
+    } H5E_END_TRY;
+    return -1;
+} /* end read_policy_chunks() */
 
-    /* Check for the deflate filter */
-    if(H5Pget_filter_by_id1(create_parms, H5Z_FILTER_DEFLATE, NULL, &cd_nelmts, &cd_value, (size_t)0, NULL) < 0) goto error;
-    if(1 != cd_nelmts)
-        goto error;
-    if(6 != cd_value)
-        goto error;
-}
-#endif /* H5_HAVE_FILTER_DEFLATE */
 
-    /* Attempt to create a dataset with invalid chunk sizes */
-    csize[0] = dims[0]*2;
-    csize[1] = dims[1]*2;
-    status = H5Pset_chunk(create_parms, 2, csize);
-    assert(status >= 0);
+/*-------------------------------------------------------------------------
+ * Function: test_chunk_cache_policy
+ *
+ * Purpose: Tests the chunk cache replacement policies: that the 2Q
+ *          policy keeps a working set cached through a sweep over the
+ *          dataset which flushes it with the LRU policy, that its index
+ *          doesn't depend on the # of slots, and that data written
+ *          through the cache with it are correct.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ *-------------------------------------------------------------------------
+ */
+#define POLICY_CACHE_NCHUNKS    8
+#define POLICY_2D_DIM           64
+#define POLICY_2D_CHUNK         4
+static herr_t
+test_chunk_cache_policy(hid_t fapl)
+{
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       fid = -1;               /* File ID */
+    hid_t       dcpl = -1;              /* DCPL ID */
+    hid_t       dapl = -1;              /* DAPL ID */
+    hid_t       dapl2 = -1;             /* DAPL ID, from dataset */
+    hid_t       sid = -1;               /* Dataspace ID */
+    hid_t       mid = -1;               /* Memory dataspace ID */
+    hid_t       did = -1;               /* Dataset ID */
+    hsize_t     dim = POLICY_CHUNK * POLICY_NCHUNKS;    /* Dataset dimensions */
+    hsize_t     cdim = POLICY_CHUNK;    /* Chunk dimensions */
+    hsize_t     dim2[2] = {POLICY_2D_DIM / 2, POLICY_2D_DIM / 2};   /* 2-D dataset dimensions */
+    hsize_t     max_dim2[2] = {H5S_UNLIMITED, H5S_UNLIMITED};       /* 2-D dataset max. dimensions */
+    hsize_t     cdim2[2] = {POLICY_2D_CHUNK, POLICY_2D_CHUNK};      /* 2-D chunk dimensions */
+    hsize_t     start[2], count[2];     /* Hyperslab selection */
+    int         *buf = NULL;            /* Data buffer */
+    int         *rbuf = NULL;           /* Read buffer */
+    int         row[POLICY_2D_DIM];     /* Row of 2-D data */
+    H5D_chunk_cache_policy_t policy;    /* Chunk cache policy */
+    unsigned    nhits, nmisses;         /* Chunk cache stats */
+    herr_t      ret;                    /* Generic return value */
+    int         p;                      /* Local index variable */
+    unsigned    u, v;                   /* Local index variables */
+
+    TESTING("chunk cache replacement policies");
+
+    h5_fixname(FILENAME[28], fapl, filename, sizeof filename);
+
+    /* Check the property */
+    if((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_cache_policy(dapl, &policy) < 0) FAIL_STACK_ERROR
+    if(policy != H5D_CHUNK_CACHE_POLICY_LRU) FAIL_PUTS_ERROR("    Default chunk cache policy isn't LRU.")
+    if(H5Pset_chunk_cache_policy(dapl, H5D_CHUNK_CACHE_POLICY_2Q) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_cache_policy(dapl, &policy) < 0) FAIL_STACK_ERROR
+    if(policy != H5D_CHUNK_CACHE_POLICY_2Q) FAIL_PUTS_ERROR("    Chunk cache policy wasn't set.")
     H5E_BEGIN_TRY {
-        dataset = H5Dcreate1(file, DSET_DEPREC_NAME_CHUNKED, H5T_NATIVE_DOUBLE, space,
-            create_parms);
+        ret = H5Pset_chunk_cache_policy(dapl, H5D_CHUNK_CACHE_POLICY_NTYPES);
     } H5E_END_TRY;
-    if(dataset >= 0) {
-    H5_FAILED();
-    puts("    Opened a dataset with incorrect chunking parameters.");
-    goto error;
-    }
-
-    csize[0] = 5;
-    csize[1] = 100;
-    status = H5Pset_chunk(create_parms, 2, csize);
-    assert(status >= 0);
+    if(ret >= 0) FAIL_PUTS_ERROR("    Invalid chunk cache policy was accepted.")
 
-    if((dataset = H5Dcreate1(file, DSET_DEPREC_NAME_CHUNKED, H5T_NATIVE_DOUBLE, space, create_parms)) < 0) goto error;
-    H5Pclose(create_parms);
+    /* Create a 1-D dataset, written without the chunk cache */
+    if(NULL == (buf = (int *)HDmalloc(POLICY_CHUNK * POLICY_NCHUNKS * sizeof(int)))) TEST_ERROR
+    if(NULL == (rbuf = (int *)HDmalloc(POLICY_2D_DIM * POLICY_2D_DIM * sizeof(int)))) TEST_ERROR
+    for(u = 0; u < POLICY_CHUNK * POLICY_NCHUNKS; u++)
+        buf[u] = (int)u;
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 1, &cdim) < 0) FAIL_STACK_ERROR
+    if((did = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) FAIL_STACK_ERROR
+    if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
 
-    /*
-     * Close the chunked dataset.
+    /* Read a working set of 4 chunks, sweep over other chunks, read the
+     * working set again, sweep some more and then read the working set
+     * once more, with each policy.  The last sweep flushes the working
+     * set from a cache using the LRU policy, but not the 2Q policy, for
+     * which the working set's chunks were in the LRU queue by then.
      */
-    if(H5Dclose(dataset) < 0) goto error;
+    for(p = H5D_CHUNK_CACHE_POLICY_LRU; p < H5D_CHUNK_CACHE_POLICY_NTYPES; p++) {
+        if(H5Pset_chunk_cache(dapl, (size_t)521, (size_t)(POLICY_CACHE_NCHUNKS * POLICY_CHUNK * sizeof(int)), 0.75F) < 0) FAIL_STACK_ERROR
+        if(H5Pset_chunk_cache_policy(dapl, (H5D_chunk_cache_policy_t)p) < 0) FAIL_STACK_ERROR
+        if((did = H5Dopen2(fid, "dset", dapl)) < 0) FAIL_STACK_ERROR
+
+        /* Make sure the setting is retrieved from the dataset */
+        if((dapl2 = H5Dget_access_plist(did)) < 0) FAIL_STACK_ERROR
+        if(H5Pget_chunk_cache_policy(dapl2, &policy) < 0) FAIL_STACK_ERROR
+        if(policy != (H5D_chunk_cache_policy_t)p) FAIL_PUTS_ERROR("    Chunk cache policy from dataset doesn't match.")
+        if(H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+
+        if(read_policy_chunks(did, (hsize_t)0, (hsize_t)4, &nmisses) < 0) TEST_ERROR
+        if(nmisses != 4) FAIL_PUTS_ERROR("    Wrong # of misses reading the working set the first time.")
+        if(read_policy_chunks(did, (hsize_t)10, (hsize_t)8, &nmisses) < 0) TEST_ERROR
+        if(read_policy_chunks(did, (hsize_t)0, (hsize_t)4, &nmisses) < 0) TEST_ERROR
+        if(nmisses != 4) FAIL_PUTS_ERROR("    Wrong # of misses reading the working set after a sweep.")
+        if(read_policy_chunks(did, (hsize_t)20, (hsize_t)32, &nmisses) < 0) TEST_ERROR
+        if(nmisses != 32) FAIL_PUTS_ERROR("    Wrong # of misses sweeping over the dataset.")
+        if(read_policy_chunks(did, (hsize_t)0, (hsize_t)4, &nmisses) < 0) TEST_ERROR
+        if(nmisses != (H5D_CHUNK_CACHE_POLICY_2Q == p ? 0U : 4U)) FAIL_PUTS_ERROR("    Working set wasn't kept cached as expected.")
+        if(H5Dget_chunk_cache_stats(did, &nhits, &nmisses) < 0) FAIL_STACK_ERROR
+        if(nmisses != (H5D_CHUNK_CACHE_POLICY_2Q == p ? 48U : 52U) || nhits != 52 - nmisses)
+            FAIL_PUTS_ERROR("    Wrong chunk cache stats.")
 
+        if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+    } /* end for */
 
-    /*
-     * Open the dataset we created above and then close it.  This is how
-     * existing datasets are accessed.
-     */
-    if((dataset = H5Dopen1(file, DSET_DEPREC_NAME_CHUNKED)) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
+    /* With only one slot, the working set thrashes with the LRU policy,
+     * but the 2Q policy's index just grows */
+    for(p = H5D_CHUNK_CACHE_POLICY_LRU; p < H5D_CHUNK_CACHE_POLICY_NTYPES; p++) {
+        if(H5Pset_chunk_cache(dapl, (size_t)1, (size_t)(POLICY_CACHE_NCHUNKS * POLICY_CHUNK * sizeof(int)), 0.75F) < 0) FAIL_STACK_ERROR
+        if(H5Pset_chunk_cache_policy(dapl, (H5D_chunk_cache_policy_t)p) < 0) FAIL_STACK_ERROR
+        if((did = H5Dopen2(fid, "dset", dapl)) < 0) FAIL_STACK_ERROR
 
-    /*
-     * Create a compact dataset, then close it.
-     */
-    create_parms = H5Pcreate(H5P_DATASET_CREATE);
-    assert(create_parms >= 0);
-    status = H5Pset_layout(create_parms, H5D_COMPACT);
-    assert(status >= 0);
-    status = H5Pset_alloc_time(create_parms, H5D_ALLOC_TIME_EARLY);
-    assert(status >= 0);
+        if(read_policy_chunks(did, (hsize_t)0, (hsize_t)4, &nmisses) < 0) TEST_ERROR
+        if(read_policy_chunks(did, (hsize_t)0, (hsize_t)4, &nmisses) < 0) TEST_ERROR
+        if(nmisses != (H5D_CHUNK_CACHE_POLICY_2Q == p ? 0U : 4U)) FAIL_PUTS_ERROR("    Chunks collided in the cache unexpectedly.")
 
-    if((dataset = H5Dcreate1(file, DSET_DEPREC_NAME_COMPACT, H5T_NATIVE_DOUBLE, small_space, create_parms)) < 0) goto error;
-    H5Pclose(create_parms);
-    if(H5Dclose(dataset) < 0) goto error;
+        if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+    } /* end for */
 
-    /*
-     * Open the dataset we created above and then close it.  This is how
-     * existing datasets are accessed.
+    /* Write an extendible 2-D dataset a row at a time through a cache
+     * using the 2Q policy which is too small for a row of chunks, with
+     * dirty chunks preempted from both queues and the index growing, then
+     * extend the dataset, write some more and check the data.
      */
-    if((dataset = H5Dopen1(file, DSET_DEPREC_NAME_COMPACT)) < 0) goto error;
-    if(H5Dclose(dataset) < 0) goto error;
+    if(H5Pset_chunk_cache(dapl, (size_t)1, (size_t)(POLICY_2D_DIM * sizeof(int) * POLICY_2D_CHUNK), 0.75F) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk_cache_policy(dapl, H5D_CHUNK_CACHE_POLICY_2Q) < 0) FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(2, dim2, max_dim2)) < 0) FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 2, cdim2) < 0) FAIL_STACK_ERROR
+    if((did = H5Dcreate2(fid, "dset2", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, dapl)) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < 2; u++) {
+        unsigned ndim = (POLICY_2D_DIM / 2) * (u + 1);   /* Current dimension sizes */
+
+        /* Write each row twice, the second time in reverse order of chunks */
+        count[0] = 1;
+        count[1] = ndim;
+        if((mid = H5Screate_simple(2, count, NULL)) < 0) FAIL_STACK_ERROR
+        if((sid = H5Dget_space(did)) < 0) FAIL_STACK_ERROR
+        for(start[0] = 0; start[0] < ndim; start[0]++) {
+            for(v = 0; v < ndim; v++)
+                row[v] = (int)(start[0] * POLICY_2D_DIM + v) - 1;
+            start[1] = 0;
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL) < 0) FAIL_STACK_ERROR
+            if(H5Dwrite(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, row) < 0) FAIL_STACK_ERROR
+        } /* end for */
+        count[1] = POLICY_2D_CHUNK;
+        if(H5Sclose(mid) < 0) FAIL_STACK_ERROR
+        if((mid = H5Screate_simple(2, count, NULL)) < 0) FAIL_STACK_ERROR
+        for(start[0] = 0; start[0] < ndim; start[0]++)
+            for(start[1] = ndim; start[1] > 0; ) {
+                start[1] -= POLICY_2D_CHUNK;
+                for(v = 0; v < POLICY_2D_CHUNK; v++)
+                    row[v] = (int)(start[0] * POLICY_2D_DIM + start[1] + v);
+                if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL) < 0) FAIL_STACK_ERROR
+                if(H5Dwrite(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, row) < 0) FAIL_STACK_ERROR
+            } /* end for */
+        if(H5Sclose(mid) < 0) FAIL_STACK_ERROR
+        if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
 
-    /* Test H5Zregister with deprecated H5Z_class1_t */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
-    if(H5Pset_chunk(dcpl, 2, csize) < 0) goto error;
-    if(H5Zregister(H5Z_DEPREC) < 0) goto error;
-    if(H5Pset_filter(dcpl, H5Z_FILTER_DEPREC, 0, (size_t)0, NULL) < 0) goto error;
+        /* Extend the dataset */
+        if(0 == u) {
+            dim2[0] = dim2[1] = POLICY_2D_DIM;
+            if(H5Dset_extent(did, dim2) < 0) FAIL_STACK_ERROR
+        } /* end if */
+    } /* end for */
 
-    puts("");
-    if(test_filter_internal(file,DSET_DEPREC_NAME_FILTER,dcpl,DISABLE_FLETCHER32,DATA_NOT_CORRUPTED,&deprec_size) < 0) goto error;
+    /* Check the data, both through the cache and after re-opening the dataset */
+    for(u = 0; u < 2; u++) {
+        if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+        for(v = 0; v < POLICY_2D_DIM * POLICY_2D_DIM; v++)
+            if(rbuf[v] != (int)v)
+                FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+        if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+        if(0 == u)
+            if((did = H5Dopen2(fid, "dset2", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    } /* end for */
+    did = -1;
 
-    if(H5Pclose(dcpl) < 0) goto error;
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dapl) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    HDfree(buf);
+    HDfree(rbuf);
 
+    PASSED();
     return 0;
 
- error:
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dapl2);
+        H5Pclose(dapl);
+        H5Pclose(dcpl);
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(buf)
+        HDfree(buf);
+    if(rbuf)
+        HDfree(rbuf);
     return -1;
-} /* end test_deprec() */
-#endif /* H5_NO_DEPRECATED_SYMBOLS */
+} /* end test_chunk_cache_policy() */
 
 
 /*-------------------------------------------------------------------------
- * Function: test_huge_chunks
+ * Function: read_ahead_sweep
  *
- * Purpose: Tests that datasets with chunks >4GB can't be created.
+ * Purpose: Helper for test_chunk_read_ahead: reads NREADS blocks of
+ *          BLOCK_ROWS x BLOCK_COLS elements from the 2-D dataset, the
+ *          first at the origin and each following one STEP_ROWS rows
+ *          further, checks the data and returns the # of chunk cache
+ *          hits.
  *
  * Return:      Success: 0
  *              Failure: -1
  *
- * Programmer:  Quincey Koziol
- *              Thursday, May  1, 2008
- *
  *-------------------------------------------------------------------------
  */
+#define READ_AHEAD_DIM          64
+#define READ_AHEAD_CHUNK_ROWS   4
+#define READ_AHEAD_CHUNK_COLS   16
 static herr_t
-test_huge_chunks(hid_t fapl)
+read_ahead_sweep(hid_t did, hsize_t block_rows, hsize_t block_cols,
+    hsize_t step_rows, unsigned nreads, unsigned *nhits)
 {
-    char        filename[FILENAME_BUF_SIZE];
-    hid_t       fid = -1;       /* File ID */
-    hid_t       dcpl = -1;      /* Dataset creation property list ID */
-    hid_t       sid = -1;       /* Dataspace ID */
-    hid_t       dsid = -1;      /* Dataset ID */
-    hsize_t     dim, chunk_dim; /* Dataset and chunk dimensions */
-    hsize_t     dim2[3], chunk_dim2[3];  /* Dataset and chunk dimensions */
-    herr_t      ret;            /* Generic return value */
-
-    TESTING("creating dataset with >4GB chunks");
-
-    h5_fixname(FILENAME[7], fapl, filename, sizeof filename);
-
-    /* Create file */
-    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) FAIL_STACK_ERROR
+    hid_t       sid = -1, mid = -1;     /* Dataspace IDs */
+    hsize_t     start[2] = {0, 0};      /* Hyperslab selection */
+    hsize_t     count[2];               /* Hyperslab selection */
+    int         rbuf[READ_AHEAD_DIM * READ_AHEAD_DIM];  /* Read buffer */
+    unsigned    u;                      /* Local index variable */
+    hsize_t     r, c;                   /* Local index variables */
+
+    count[0] = block_rows;
+    count[1] = block_cols;
+    if((sid = H5Dget_space(did)) < 0) FAIL_STACK_ERROR
+    if((mid = H5Screate_simple(2, count, NULL)) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < nreads; u++, start[0] += step_rows) {
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL) < 0) FAIL_STACK_ERROR
+        if(H5Dread(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+        for(r = 0; r < block_rows; r++)
+            for(c = 0; c < block_cols; c++)
+                if(rbuf[r * block_cols + c] != (int)((start[0] + r) * READ_AHEAD_DIM + c))
+                    FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+    } /* end for */
+    if(H5Sclose(mid) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Dget_chunk_cache_stats(did, nhits, NULL) < 0) FAIL_STACK_ERROR
 
-    /* Create dataset creation property list */
-    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    return 0;
 
-    /* Try to set too large of a chunk for 1-D dataset (# of elements) */
-    chunk_dim = TOO_HUGE_CHUNK_DIM;
+error:
     H5E_BEGIN_TRY {
-        ret = H5Pset_chunk(dcpl, 1, &chunk_dim);
+        H5Sclose(mid);
+        H5Sclose(sid);
     } H5E_END_TRY;
-    if(ret >= 0)
-    FAIL_PUTS_ERROR("    Set chunk size with too large of chunk dimensions.")
+    return -1;
+} /* end read_ahead_sweep() */
 
-    /* Try to set too large of a chunk for n-D dataset (# of elements) */
-    chunk_dim2[0] = TOO_HUGE_CHUNK_DIM2_0;
-    chunk_dim2[1] = TOO_HUGE_CHUNK_DIM2_1;
-    chunk_dim2[2] = TOO_HUGE_CHUNK_DIM2_2;
-    H5E_BEGIN_TRY {
-        ret = H5Pset_chunk(dcpl, 3, chunk_dim2);
-    } H5E_END_TRY;
-    if(ret >= 0)
-    FAIL_PUTS_ERROR("    Set chunk size with too large of chunk dimensions.")
 
-    /* Set 1-D chunk size */
-    chunk_dim = HUGE_CHUNK_DIM;
-    if(H5Pset_chunk(dcpl, 1, &chunk_dim) < 0) FAIL_STACK_ERROR
+/*-------------------------------------------------------------------------
+ * Function: test_chunk_read_ahead
+ *
+ * Purpose: Tests reading chunks ahead: that sweeping over a filtered
+ *          dataset a row at a time, or reading the chunks of one column
+ *          of chunks in turn, finds the chunks in the cache after the
+ *          first few reads when read-ahead is enabled, with either
+ *          chunk cache policy and with and without filter threads, and
+ *          that chunks which can't be read ahead don't fail the reads.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ *-------------------------------------------------------------------------
+ */
+#define READ_AHEAD_WINDOW       8
+#define READ_AHEAD_NCHUNKS      ((READ_AHEAD_DIM / READ_AHEAD_CHUNK_ROWS) * (READ_AHEAD_DIM / READ_AHEAD_CHUNK_COLS))
+static herr_t
+test_chunk_read_ahead(hid_t fapl)
+{
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       my_fapl = -1;           /* File access property list ID */
+    hid_t       fid = -1;               /* File ID */
+    hid_t       dcpl = -1;              /* DCPL ID */
+    hid_t       dapl = -1;              /* DAPL ID */
+    hid_t       dapl2 = -1;             /* DAPL ID, from dataset */
+    hid_t       sid = -1;               /* Dataspace ID */
+    hid_t       did = -1;               /* Dataset ID */
+    hsize_t     dim[2] = {READ_AHEAD_DIM, READ_AHEAD_DIM};  /* Dataset dimensions */
+    hsize_t     cdim[2] = {READ_AHEAD_CHUNK_ROWS, READ_AHEAD_CHUNK_COLS}; /* Chunk dimensions */
+    int         *buf = NULL;            /* Data buffer */
+    size_t      window;                 /* Read-ahead window */
+    H5F_t       *f = NULL;              /* Internal file object pointer */
+    hsize_t     scaled[2];              /* Scaled coordinates of chunk */
+    haddr_t     addr;                   /* Address of chunk */
+    haddr_t     cut;                    /* Address of the first chunk which can't be read */
+    haddr_t     eoa = HADDR_UNDEF;      /* File's end of allocated space */
+    hbool_t     eoa_cut = FALSE;        /* Whether the file's space was cut short */
+    unsigned    nhits;                  /* Chunk cache hits */
+    int         nused;                  /* # of chunks cached */
+    unsigned    u;                      /* Local index variable */
+    int         config;                 /* Read-ahead configuration */
 
-    /* Create 1-D dataspace */
-    dim = HUGE_DIM;
-    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
+    TESTING("reading chunks ahead");
 
-    /* Try to create dataset */
-    H5E_BEGIN_TRY {
-        dsid = H5Dcreate2(fid, HUGE_DATASET, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dsid >= 0)
-    FAIL_PUTS_ERROR("    1-D Dataset with too large of chunk dimensions created.")
+    h5_fixname(FILENAME[29], fapl, filename, sizeof filename);
 
-    /* Close 1-D dataspace */
-    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    /* Check the property */
+    if((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_read_ahead(dapl, &window) < 0) FAIL_STACK_ERROR
+    if(window != 0) FAIL_PUTS_ERROR("    Default read-ahead window isn't 0.")
+    if(H5Pset_chunk_read_ahead(dapl, (size_t)READ_AHEAD_WINDOW) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_read_ahead(dapl, &window) < 0) FAIL_STACK_ERROR
+    if(window != READ_AHEAD_WINDOW) FAIL_PUTS_ERROR("    Read-ahead window wasn't set.")
 
+    /* Create a filtered dataset */
+    if(NULL == (buf = (int *)HDmalloc(READ_AHEAD_DIM * READ_AHEAD_DIM * sizeof(int)))) TEST_ERROR
+    for(u = 0; u < READ_AHEAD_DIM * READ_AHEAD_DIM; u++)
+        buf[u] = (int)u;
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(2, dim, NULL)) < 0) FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 2, cdim) < 0) FAIL_STACK_ERROR
+    if(H5Pset_shuffle(dcpl) < 0) FAIL_STACK_ERROR
+    if((did = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) FAIL_STACK_ERROR
+    if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
-    /* Set n-D chunk size */
-    chunk_dim2[0] = HUGE_CHUNK_DIM2_0;
-    chunk_dim2[1] = HUGE_CHUNK_DIM2_1;
-    chunk_dim2[2] = HUGE_CHUNK_DIM2_2;
-    if(H5Pset_chunk(dcpl, 3, chunk_dim2) < 0) FAIL_STACK_ERROR
+    /* Sweep over the dataset without read-ahead, then with it using each
+     * chunk cache policy and with filter threads.  The cache holds half
+     * of the chunks.
+     */
+    for(config = 0; config < 4; config++) {
+        if((my_fapl = H5Pcopy(fapl)) < 0) FAIL_STACK_ERROR
+        if(3 == config)
+            if(H5Pset_filter_nthreads(my_fapl, 4) < 0) FAIL_STACK_ERROR
+        if((fid = H5Fopen(filename, H5F_ACC_RDONLY, my_fapl)) < 0) FAIL_STACK_ERROR
+        if(H5Pset_chunk_cache(dapl, (size_t)521, (size_t)(READ_AHEAD_NCHUNKS / 2) *
+                READ_AHEAD_CHUNK_ROWS * READ_AHEAD_CHUNK_COLS * sizeof(int), 0.75F) < 0) FAIL_STACK_ERROR
+        if(H5Pset_chunk_read_ahead(dapl, (size_t)(0 == config ? 0 : READ_AHEAD_WINDOW)) < 0) FAIL_STACK_ERROR
+        if(H5Pset_chunk_cache_policy(dapl, 2 == config ? H5D_CHUNK_CACHE_POLICY_2Q : H5D_CHUNK_CACHE_POLICY_LRU) < 0) FAIL_STACK_ERROR
+
+        /* Read a row at a time.  Each read selects one row of 4 chunks.
+         * With read-ahead, reads are seen to be sequential when they
+         * reach the second row of chunks, and the chunks of the next two
+         * rows are loaded then and as each following row is reached.
+         */
+        if((did = H5Dopen2(fid, "dset", dapl)) < 0) FAIL_STACK_ERROR
+        if((dapl2 = H5Dget_access_plist(did)) < 0) FAIL_STACK_ERROR
+        if(H5Pget_chunk_read_ahead(dapl2, &window) < 0) FAIL_STACK_ERROR
+        if(window != (0 == config ? 0 : READ_AHEAD_WINDOW)) FAIL_PUTS_ERROR("    Read-ahead window from dataset doesn't match.")
+        if(H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+        if(read_ahead_sweep(did, (hsize_t)1, (hsize_t)READ_AHEAD_DIM, (hsize_t)1, READ_AHEAD_DIM, &nhits) < 0) TEST_ERROR
+        if(nhits != (READ_AHEAD_DIM * 4) - (0 == config ? READ_AHEAD_NCHUNKS : 8))
+            FAIL_PUTS_ERROR("    Wrong # of chunk cache hits sweeping over rows.")
+        if(H5Dclose(did) < 0) FAIL_STACK_ERROR
 
-    /* Create n-D dataspace */
-    dim2[0] = HUGE_DIM2_0;
-    dim2[1] = HUGE_DIM2_1;
-    dim2[2] = HUGE_DIM2_2;
-    if((sid = H5Screate_simple(3, dim2, NULL)) < 0) FAIL_STACK_ERROR
+        /* Read the chunks of the first column of chunks in turn.  With
+         * read-ahead, the stride is seen at the third read, and the next
+         * chunks of the column are loaded then and after each read.
+         */
+        if((did = H5Dopen2(fid, "dset", dapl)) < 0) FAIL_STACK_ERROR
+        if(read_ahead_sweep(did, (hsize_t)READ_AHEAD_CHUNK_ROWS, (hsize_t)READ_AHEAD_CHUNK_COLS,
+                (hsize_t)READ_AHEAD_CHUNK_ROWS, READ_AHEAD_DIM / READ_AHEAD_CHUNK_ROWS, &nhits) < 0) TEST_ERROR
+        if(nhits != (0 == config ? 0 : (READ_AHEAD_DIM / READ_AHEAD_CHUNK_ROWS) - 3))
+            FAIL_PUTS_ERROR("    Wrong # of chunk cache hits reading a column of chunks.")
+        if(H5Dclose(did) < 0) FAIL_STACK_ERROR
 
-    /* Try to create dataset */
-    H5E_BEGIN_TRY {
-        dsid = H5Dcreate2(fid, HUGE_DATASET2, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
-    } H5E_END_TRY;
-    if(dsid >= 0)
-    FAIL_PUTS_ERROR("    n-D Dataset with too large of chunk dimensions created.")
+        if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
+        if(H5Pclose(my_fapl) < 0) FAIL_STACK_ERROR
+    } /* end for */
 
-    /* Close n-D dataspace */
-    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    /* Sweep over the first four rows of chunks with the rest of the chunks
+     * past the end of the file's allocated space, so that they can't be
+     * read.  The reads succeed, though the read-ahead window reaches into
+     * the chunks which can't be read, and those chunks aren't cached.
+     * Once the file's space is restored, all of the data can be read.
+     */
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl)) < 0) FAIL_STACK_ERROR
+    if(NULL == (f = (H5F_t *)H5I_object(fid))) FAIL_STACK_ERROR
+    if(H5Pset_chunk_read_ahead(dapl, (size_t)READ_AHEAD_WINDOW) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk_cache_policy(dapl, H5D_CHUNK_CACHE_POLICY_LRU) < 0) FAIL_STACK_ERROR
+    if((did = H5Dopen2(fid, "dset", dapl)) < 0) FAIL_STACK_ERROR
+
+    /* Find where the fifth row of chunks starts, checking that the chunks
+     * are laid out in order (this also caches the chunk index)
+     */
+    scaled[0] = 4;
+    scaled[1] = 0;
+    if(H5D__chunk_addr_test(did, scaled, &cut) < 0) FAIL_STACK_ERROR
+    for(scaled[0] = 0; scaled[0] < READ_AHEAD_DIM / READ_AHEAD_CHUNK_ROWS; scaled[0]++)
+        for(scaled[1] = 0; scaled[1] < READ_AHEAD_DIM / READ_AHEAD_CHUNK_COLS; scaled[1]++) {
+            if(H5D__chunk_addr_test(did, scaled, &addr) < 0) FAIL_STACK_ERROR
+            if((scaled[0] < 4) != H5F_addr_lt(addr, cut))
+                FAIL_PUTS_ERROR("    Chunks aren't laid out in order.")
+        } /* end for */
 
-    /* Close everything else */
-    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(HADDR_UNDEF == (eoa = H5FD_get_eoa(f->shared->lf, H5FD_MEM_DRAW))) FAIL_STACK_ERROR
+    if(H5FD_set_eoa(f->shared->lf, H5FD_MEM_DRAW, cut) < 0) FAIL_STACK_ERROR
+    eoa_cut = TRUE;
+    if(read_ahead_sweep(did, (hsize_t)1, (hsize_t)READ_AHEAD_DIM, (hsize_t)1, 4 * READ_AHEAD_CHUNK_ROWS, &nhits) < 0) TEST_ERROR
+    if(H5Eget_num(H5E_DEFAULT) != 0)
+        FAIL_PUTS_ERROR("    Errors reading chunks ahead were left on the error stack.")
+    if(H5D__current_cache_size_test(did, NULL, &nused) < 0) FAIL_STACK_ERROR
+    if(nused != 4 * (READ_AHEAD_DIM / READ_AHEAD_CHUNK_COLS))
+        FAIL_PUTS_ERROR("    Chunks which couldn't be read were cached.")
+    if(H5FD_set_eoa(f->shared->lf, H5FD_MEM_DRAW, eoa) < 0) FAIL_STACK_ERROR
+    eoa_cut = FALSE;
+    if(read_ahead_sweep(did, (hsize_t)1, (hsize_t)READ_AHEAD_DIM, (hsize_t)1, READ_AHEAD_DIM, &nhits) < 0) TEST_ERROR
+
+    if(H5Dclose(did) < 0) FAIL_STACK_ERROR
     if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dapl) < 0) FAIL_STACK_ERROR
+    HDfree(buf);
 
     PASSED();
     return 0;
 
 error:
+    if(eoa_cut)
+        H5FD_set_eoa(f->shared->lf, H5FD_MEM_DRAW, eoa);
     H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dapl2);
+        H5Pclose(dapl);
         H5Pclose(dcpl);
-        H5Dclose(dsid);
+        H5Pclose(my_fapl);
         H5Sclose(sid);
         H5Fclose(fid);
     } H5E_END_TRY;
+    if(buf)
+        HDfree(buf);
     return -1;
-} /* end test_huge_chunks() */
+} /* end test_chunk_read_ahead() */
 
 
 /*-------------------------------------------------------------------------
- * Function: test_chunk_cache
+ * Function: read_coalesce_count
  *
- * Purpose: Tests API for setting rdcc info on a DAPL, and interaction
- *          with the corresponding properties in the file structure.
+ * Purpose: Helper for test_chunk_read_coalesce: opens the file with the
+ *          log driver, opens the dataset with the chunk cache disabled
+ *          and the read gap GAP, reads every STRIDE'th chunk (or only
+ *          one element, if STRIDE is 0), as integers of MEM_TYPE, checks
+ *          the data and returns the # of reads from the file.
  *
  * Return:      Success: 0
  *              Failure: -1
  *
- * Programmer:  Neil Fortner
- *              Wednesday, October 29, 2008
- *
  *-------------------------------------------------------------------------
  */
+#define COALESCE_CHUNK          256
+#define COALESCE_NCHUNKS        64
+#define COALESCE_LOG            "chunk_read_coalesce.log"
+#define COALESCE_LOG_READS      "Total number of read operations: "
 static herr_t
-test_chunk_cache(hid_t fapl)
+read_coalesce_count(const char *filename, hid_t fapl, size_t gap,
+    hsize_t stride, hid_t mem_type, unsigned long long *nreads)
 {
-    char        filename[FILENAME_BUF_SIZE];
-    hid_t       fid = -1;       /* File ID */
-    hid_t       fapl_local = -1; /* Local fapl */
-    hid_t       fapl_def = -1;  /* Default fapl */
-    hid_t       dcpl = -1;      /* Dataset creation property list ID */
-    hid_t       dapl1 = -1;     /* Dataset access property list ID */
-    hid_t       dapl2 = -1;     /* Dataset access property list ID */
-    hid_t       sid = -1;       /* Dataspace ID */
-    hid_t       dsid = -1;      /* Dataset ID */
-    hsize_t     dim, chunk_dim; /* Dataset and chunk dimensions */
-    size_t      nslots_1, nslots_2, nslots_3, nslots_4; /* rdcc number of elements */
-    size_t      nbytes_1, nbytes_2, nbytes_3, nbytes_4; /* rdcc number of bytes */
-    size_t      nlinks;         /* Number of link traversals */
-    double      w0_1, w0_2, w0_3, w0_4; /* rdcc preemption policy */
-
-    TESTING("dataset chunk cache configuration");
-
-    /* Create a default fapl and dapl */
-    if ((fapl_def = H5Pcreate(H5P_FILE_ACCESS)) < 0) FAIL_STACK_ERROR
-    if ((dapl1 = H5Pcreate(H5P_DATASET_ACCESS)) < 0) FAIL_STACK_ERROR
-
-    /* Verify that H5Pget_chunk_cache(dapl) returns the same values as are in
-     * the default fapl.
-     */
-    if (H5Pget_cache(fapl_def, NULL, &nslots_1, &nbytes_1, &w0_1) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl1, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_1 != nslots_4) || (nbytes_1 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_1, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from default dapl do not match those from fapl.")
-
-    /* Set a lapl property on dapl1 (to verify inheritance) */
-    if (H5Pset_nlinks(dapl1, (size_t)134) < 0) FAIL_STACK_ERROR
-    if (H5Pget_nlinks(dapl1, &nlinks) < 0) FAIL_STACK_ERROR
-    if (nlinks != 134)
-        FAIL_PUTS_ERROR("    nlinks parameter not set properly on dapl.")
-
-    /* Copy fapl passed to this function (as we will be modifying it) */
-    if ((fapl_local = H5Pcopy(fapl)) < 0) FAIL_STACK_ERROR
+    hid_t       my_fapl = -1;           /* File access property list ID */
+    hid_t       fid = -1;               /* File ID */
+    hid_t       dapl = -1;              /* DAPL ID */
+    hid_t       did = -1;               /* Dataset ID */
+    hid_t       sid = -1;               /* Dataspace ID */
+    hid_t       mid = -1;               /* Memory dataspace ID */
+    hsize_t     start = 0, count, block, dstride;   /* Hyperslab selection */
+    long long   rbuf[COALESCE_CHUNK * COALESCE_NCHUNKS];    /* Read buffer */
+    int         *irbuf = (int *)rbuf;   /* Read buffer, as ints */
+    FILE        *log = NULL;            /* Log file */
+    char        line[256];              /* Line of log file */
+    size_t      gap_out;                /* Read gap from dataset */
+    hsize_t     u;                      /* Local index variable */
+
+    /* Log the reads, without the sieve buffer to combine them */
+    if((my_fapl = H5Pcopy(fapl)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_fapl_log(my_fapl, COALESCE_LOG, (unsigned long long)H5FD_LOG_NUM_READ, (size_t)0) < 0) FAIL_STACK_ERROR
+    if(H5Pset_sieve_buf_size(my_fapl, (size_t)0) < 0) FAIL_STACK_ERROR
+    if((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk_cache(dapl, (size_t)0, (size_t)0, H5D_CHUNK_CACHE_W0_DEFAULT) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk_read_gap(dapl, gap) < 0) FAIL_STACK_ERROR
+
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, my_fapl)) < 0) FAIL_STACK_ERROR
+    if((did = H5Dopen2(fid, "dset", dapl)) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dapl) < 0) FAIL_STACK_ERROR
+    if((dapl = H5Dget_access_plist(did)) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_read_gap(dapl, &gap_out) < 0) FAIL_STACK_ERROR
+    if(gap_out != gap) FAIL_PUTS_ERROR("    Read gap from dataset doesn't match.")
+
+    /* Select every STRIDE'th chunk, or one element */
+    if((sid = H5Dget_space(did)) < 0) FAIL_STACK_ERROR
+    if(stride > 0) {
+        dstride = stride * COALESCE_CHUNK;
+        count = COALESCE_NCHUNKS / stride;
+        block = COALESCE_CHUNK;
+    } /* end if */
+    else {
+        dstride = 1;
+        count = 1;
+        block = 1;
+    } /* end else */
+    if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, &dstride, &count, &block) < 0) FAIL_STACK_ERROR
+    count *= block;
+    if((mid = H5Screate_simple(1, &count, NULL)) < 0) FAIL_STACK_ERROR
+    if(H5Dread(did, mem_type, mid, sid, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < count; u++) {
+        long long expect = (long long)((u / block) * dstride + u % block);
+
+        if((H5T_NATIVE_LLONG == mem_type ? rbuf[u] : (long long)irbuf[u]) != expect)
+            FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+    } /* end for */
 
-    /* Set new rdcc settings on fapl */
-    nslots_2 = nslots_1 * 2;
-    nbytes_2 = nbytes_1 * 2;
-    w0_2 = w0_1 / (double)2.0F;
-    if (H5Pset_cache(fapl_local, 0, nslots_2, nbytes_2, w0_2) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(mid) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dapl) < 0) FAIL_STACK_ERROR
+    if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(my_fapl) < 0) FAIL_STACK_ERROR
 
-    h5_fixname(FILENAME[8], fapl, filename, sizeof filename);
+    /* Get the # of reads from the log */
+    *nreads = 0;
+    if(NULL == (log = HDfopen(COALESCE_LOG, "r"))) TEST_ERROR
+    while(HDfgets(line, (int)sizeof(line), log))
+        if(!HDstrncmp(line, COALESCE_LOG_READS, HDstrlen(COALESCE_LOG_READS))) {
+            *nreads = HDstrtoull(line + HDstrlen(COALESCE_LOG_READS), NULL, 10);
+            break;
+        } /* end if */
+    HDfclose(log);
+    HDremove(COALESCE_LOG);
+    if(0 == *nreads) FAIL_PUTS_ERROR("    # of reads wasn't logged.")
 
-    /* Create file */
-    if ((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_local)) < 0) FAIL_STACK_ERROR
+    return 0;
 
-    /* Create dataset creation property list */
-    if ((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Dclose(did);
+        H5Pclose(dapl);
+        H5Fclose(fid);
+        H5Pclose(my_fapl);
+    } H5E_END_TRY;
+    return -1;
+} /* end read_coalesce_count() */
 
-    /* Set chunking */
-    chunk_dim = 10;
-    if (H5Pset_chunk(dcpl, 1, &chunk_dim) < 0) FAIL_STACK_ERROR
 
-    /* Create 1-D dataspace */
-    dim = 100;
-    if ((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
+/*-------------------------------------------------------------------------
+ * Function: test_chunk_read_coalesce
+ *
+ * Purpose: Tests reading chunks which bypass the chunk cache together:
+ *          that adjacent chunks are read with one read, that chunks with
+ *          gaps between them are too when the read gap allows it, and
+ *          that the data are correct, with and without type conversion.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_chunk_read_coalesce(hid_t fapl)
+{
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       my_fapl = -1;           /* File access property list ID */
+    hid_t       fid = -1;               /* File ID */
+    hid_t       dcpl = -1;              /* DCPL ID */
+    hid_t       dapl = -1;              /* DAPL ID */
+    hid_t       sid = -1;               /* Dataspace ID */
+    hid_t       did = -1;               /* Dataset ID */
+    hsize_t     dim = COALESCE_CHUNK * COALESCE_NCHUNKS;    /* Dataset dimensions */
+    hsize_t     cdim = COALESCE_CHUNK;  /* Chunk dimensions */
+    int         buf[COALESCE_CHUNK * COALESCE_NCHUNKS]; /* Data buffer */
+    unsigned long long nbase, nreads;   /* # of reads from the file */
+    size_t      gap;                    /* Read gap */
+    unsigned    u;                      /* Local index variable */
 
-    /* Create dataset with default dapl */
-    if ((dsid = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, dapl1)) < 0)
-        FAIL_STACK_ERROR
+    TESTING("reading chunks bypassing the cache together");
 
-    /* Retrieve dapl from dataset, verfiy cache values are the same as on fapl_local */
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+    /* Use the log driver to count reads, with the file named for it */
+    if((my_fapl = H5Pcopy(fapl)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_fapl_log(my_fapl, COALESCE_LOG, (unsigned long long)H5FD_LOG_NUM_READ, (size_t)0) < 0) FAIL_STACK_ERROR
+    h5_fixname(FILENAME[30], my_fapl, filename, sizeof filename);
+    if(H5Pclose(my_fapl) < 0) FAIL_STACK_ERROR
+    if((my_fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0) FAIL_STACK_ERROR
+
+    /* Check the property */
+    if((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_read_gap(dapl, &gap) < 0) FAIL_STACK_ERROR
+    if(gap != 0) FAIL_PUTS_ERROR("    Default read gap isn't 0.")
+    if(H5Pset_chunk_read_gap(dapl, (size_t)4096) < 0) FAIL_STACK_ERROR
+    if(H5Pget_chunk_read_gap(dapl, &gap) < 0) FAIL_STACK_ERROR
+    if(gap != 4096) FAIL_PUTS_ERROR("    Read gap wasn't set.")
+    if(H5Pclose(dapl) < 0) FAIL_STACK_ERROR
+
+    /* Create a dataset whose chunks are allocated in order, next to each
+     * other */
+    for(u = 0; u < COALESCE_CHUNK * COALESCE_NCHUNKS; u++)
+        buf[u] = (int)u;
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, my_fapl)) < 0) FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 1, &cdim) < 0) FAIL_STACK_ERROR
+    if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) FAIL_STACK_ERROR
+    if((did = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) FAIL_STACK_ERROR
+    if(H5Dclose(did) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
-    /* Set new values on dapl1.  nbytes will be set to default, so the file
-     * property will override this setting */
-    nslots_3 = nslots_2 * 2;
-    nbytes_3 = H5D_CHUNK_CACHE_NBYTES_DEFAULT;
-    w0_3 = w0_2 / 2;
-    if (H5Pset_chunk_cache(dapl1, nslots_3, nbytes_3, w0_3) < 0) FAIL_STACK_ERROR
+    /* Count the reads for opening the dataset and reading one chunk */
+    if(read_coalesce_count(filename, my_fapl, (size_t)0, (hsize_t)0, H5T_NATIVE_INT, &nbase) < 0) TEST_ERROR
 
-    /* Close dataset, reopen with dapl1.  Note the use of a dapl with H5Oopen */
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if ((dsid = H5Oopen(fid, "dset", dapl1)) < 0) FAIL_STACK_ERROR
+    /* Reading all the chunks takes one read of raw data */
+    if(read_coalesce_count(filename, my_fapl, (size_t)0, (hsize_t)1, H5T_NATIVE_INT, &nreads) < 0) TEST_ERROR
+    if(nreads != nbase) FAIL_PUTS_ERROR("    Adjacent chunks weren't read together.")
+    if(read_coalesce_count(filename, my_fapl, (size_t)0, (hsize_t)1, H5T_NATIVE_LLONG, &nreads) < 0) TEST_ERROR
+    if(nreads != nbase) FAIL_PUTS_ERROR("    Adjacent chunks weren't read together with type conversion.")
 
-    /* Retrieve dapl from dataset, verfiy cache values are the same as on dapl1 */
-    /* Note we rely on the knowledge that H5Pget_chunk_cache retrieves these
-     * values directly from the dataset structure, and not from a copy of the
-     * dapl used to open the dataset (which is not preserved).
-     */
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_3 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from dapl1.")
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+    /* Reading every other chunk takes a read per chunk, unless the gap
+     * between them is allowed */
+    if(read_coalesce_count(filename, my_fapl, (size_t)0, (hsize_t)2, H5T_NATIVE_INT, &nreads) < 0) TEST_ERROR
+    if(nreads != nbase + (COALESCE_NCHUNKS / 2) - 1) FAIL_PUTS_ERROR("    Chunks with gaps were read together.")
+    if(read_coalesce_count(filename, my_fapl, COALESCE_CHUNK * sizeof(int), (hsize_t)2, H5T_NATIVE_INT, &nreads) < 0) TEST_ERROR
+    if(nreads != nbase) FAIL_PUTS_ERROR("    Chunks with allowed gaps weren't read together.")
+    if(read_coalesce_count(filename, my_fapl, COALESCE_CHUNK * sizeof(int) - 1, (hsize_t)2, H5T_NATIVE_LLONG, &nreads) < 0) TEST_ERROR
+    if(nreads != nbase + (COALESCE_NCHUNKS / 2) - 1) FAIL_PUTS_ERROR("    Chunks with larger gaps than allowed were read together.")
 
-    /* Close dataset, reopen with H5P_DEFAULT as dapl */
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if ((dsid = H5Dopen2(fid, "dset", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    if(H5Pclose(my_fapl) < 0) FAIL_STACK_ERROR
+    HDremove(filename);
 
-    /* Retrieve dapl from dataset, verfiy cache values are the same on fapl_local */
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+    PASSED();
+    return 0;
 
-    /* Similary, test use of H5Dcreate2 with H5P_DEFAULT */
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if ((dsid = H5Dcreate2(fid, "dset2", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
-        FAIL_STACK_ERROR
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
-    /* Don't close dapl2, we will use it in the next section */
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dapl);
+        H5Pclose(dcpl);
+        H5Pclose(my_fapl);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    return -1;
+} /* end test_chunk_read_coalesce() */
 
-    /* Modify cache values on fapl_local */
-    nbytes_3 = nbytes_2 * 2;
-    if (H5Pset_cache(fapl_local, 0, nslots_3, nbytes_3, w0_3) < 0) FAIL_STACK_ERROR
 
-    /* Close and reopen file with new fapl_local */
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if (H5Fclose(fid) < 0) FAIL_STACK_ERROR
-    if ((fid = H5Fopen(filename, H5F_ACC_RDWR, fapl_local)) < 0) FAIL_STACK_ERROR
+/*-------------------------------------------------------------------------
+ * Function: test_multi_dset_io
+ *
+ * Purpose: Tests H5Dwrite_multi and H5Dread_multi on datasets with each
+ *          storage layout, with type conversion and partial selections,
+ *          and checks that no data is transferred when any dataset's
+ *          arguments are invalid.  Also transfers 2-D selections which
+ *          cross chunk boundaries to and from datasets which aren't in
+ *          the chunk cache, which go through vector I/O.
+ *
+ * Return:      Success: 0
+ *              Failure: -1
+ *
+ *-------------------------------------------------------------------------
+ */
+#define MULTI_NDSETS    6
+#define MULTI_DIM       100
+#define MULTI_CHUNK     10
+#define MULTI_DIM0      20
+#define MULTI_DIM1      30
+static herr_t
+test_multi_dset_io(hid_t fapl)
+{
+    char        filename[FILENAME_BUF_SIZE];
+    hid_t       fid = -1;               /* File ID */
+    hid_t       dcpl[3] = {-1, -1, -1}; /* DCPL IDs, one per layout */
+    hid_t       sid = -1;               /* Dataspace ID */
+    hid_t       sel_sid = -1;           /* Dataspace ID with partial selection */
+    hid_t       did[MULTI_NDSETS];      /* Dataset IDs */
+    hid_t       mtype[MULTI_NDSETS];    /* Memory datatype IDs */
+    hid_t       mspace[MULTI_NDSETS];   /* Memory dataspace IDs */
+    hid_t       fspace[MULTI_NDSETS];   /* File dataspace IDs */
+    const void *wbuf[MULTI_NDSETS];     /* Write buffers */
+    void       *rbuf[MULTI_NDSETS];     /* Read buffers */
+    int         idata[MULTI_NDSETS][MULTI_DIM];     /* int data */
+    short       sdata[MULTI_NDSETS][MULTI_DIM];     /* short data */
+    int         rdata[MULTI_NDSETS][MULTI_DIM];     /* Data read back */
+    hsize_t     dim = MULTI_DIM;        /* Dataset dimensions */
+    hsize_t     cdim = MULTI_CHUNK;     /* Chunk dimensions */
+    hsize_t     start = 10, stride = 3, count = 20;     /* Partial selection */
+    hid_t       saved_id;               /* Saved dataset ID */
+    hsize_t     dims2[2] = {MULTI_DIM0, MULTI_DIM1};        /* 2-D dataset dimensions */
+    hsize_t     cdims2[2] = {7, 8};     /* 2-D chunk dimensions */
+    hsize_t     mdims2[2] = {MULTI_DIM0 - 4, MULTI_DIM1 - 6};   /* 2-D memory dimensions */
+    hsize_t     fstart2[2] = {3, 5};    /* 2-D file selection start */
+    hsize_t     mstart2[2] = {1, 2};    /* 2-D memory selection start */
+    hsize_t     count2[2] = {10, 17};   /* 2-D selection size */
+    hid_t       sid2 = -1;              /* 2-D file dataspace ID */
+    hid_t       msid2 = -1;             /* 2-D memory dataspace ID */
+    int         wdata2[2][MULTI_DIM0][MULTI_DIM1];  /* 2-D data written */
+    int         mdata2[2][MULTI_DIM0 - 4][MULTI_DIM1 - 6];  /* 2-D data in memory */
+    int         rdata2[MULTI_DIM0][MULTI_DIM1];     /* 2-D data read back */
+    herr_t      ret;                    /* Generic return value */
+    unsigned    u, v, w;                /* Local index variables */
+
+    TESTING("multi-dataset I/O");
+
+    for(u = 0; u < MULTI_NDSETS; u++)
+        did[u] = -1;
+
+    h5_fixname(FILENAME[31], fapl, filename, sizeof filename);
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) FAIL_STACK_ERROR
+    if((sel_sid = H5Scopy(sid)) < 0) FAIL_STACK_ERROR
+    if(H5Sselect_hyperslab(sel_sid, H5S_SELECT_SET, &start, &stride, &count, NULL) < 0) FAIL_STACK_ERROR
+
+    /* Contiguous, chunked and compact layouts */
+    for(u = 0; u < 3; u++)
+        if((dcpl[u] = H5Pcreate(H5P_DATASET_CREATE)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_layout(dcpl[0], H5D_CONTIGUOUS) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl[1], 1, &cdim) < 0) FAIL_STACK_ERROR
+    if(H5Pset_layout(dcpl[2], H5D_COMPACT) < 0) FAIL_STACK_ERROR
+
+    /* Create the datasets in the reverse of the order they're passed in,
+     * so that the file order differs from the caller's */
+    for(u = MULTI_NDSETS; u > 0; u--) {
+        char name[16];
+
+        HDsnprintf(name, sizeof(name), "dset%u", u - 1);
+        if((did[u - 1] = H5Dcreate2(fid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl[(u - 1) % 3], H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+    } /* end for */
 
-    /* Verify that dapl2 retrieved earlier (using values from the old fapl)
-     * sets its values in the new file (test use of H5Dopen2 with a dapl)
-     */
-    if ((dsid = H5Dopen2(fid, "dset", dapl2)) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR /* Close dapl2, to avoid id leak */
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_2 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_2, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from dapl2.")
+    /* Write every dataset at once: the odd ones from shorts, and the last
+     * one only partially */
+    for(u = 0; u < MULTI_NDSETS; u++) {
+        for(v = 0; v < MULTI_DIM; v++) {
+            idata[u][v] = (int)(u * 1000 + v);
+            sdata[u][v] = (short)(u * 1000 + v);
+        } /* end for */
+        mtype[u] = (u % 2) ? H5T_NATIVE_SHORT : H5T_NATIVE_INT;
+        wbuf[u] = (u % 2) ? (const void *)sdata[u] : (const void *)idata[u];
+        mspace[u] = H5S_ALL;
+        fspace[u] = H5S_ALL;
+    } /* end for */
+    mspace[MULTI_NDSETS - 1] = sel_sid;
+    fspace[MULTI_NDSETS - 1] = sel_sid;
+    if(H5Dwrite_multi((size_t)MULTI_NDSETS, did, mtype, mspace, fspace, H5P_DEFAULT, wbuf) < 0) FAIL_STACK_ERROR
+
+    /* Read every dataset back at once, as ints */
+    HDmemset(rdata, 0, sizeof(rdata));
+    for(u = 0; u < MULTI_NDSETS; u++) {
+        mtype[u] = H5T_NATIVE_INT;
+        mspace[u] = H5S_ALL;
+        fspace[u] = H5S_ALL;
+        rbuf[u] = rdata[u];
+    } /* end for */
+    if(H5Dread_multi((size_t)MULTI_NDSETS, did, mtype, mspace, fspace, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < MULTI_NDSETS; u++)
+        for(v = 0; v < MULTI_DIM; v++) {
+            int expect = (int)(u * 1000 + v);
+
+            /* Elements outside the partial selection hold the fill value */
+            if(u == MULTI_NDSETS - 1 && (v < start || v >= start + stride * count || (v - start) % stride))
+                expect = 0;
+            if(rdata[u][v] != expect) {
+                HDprintf("    Dataset %u, element %u: read %d, expected %d\n", u, v, rdata[u][v], expect);
+                TEST_ERROR
+            } /* end if */
+        } /* end for */
 
-    /* Test H5D_CHUNK_CACHE_NSLOTS_DEFAULT and H5D_CHUNK_CACHE_W0_DEFAULT */
-    nslots_2 = H5D_CHUNK_CACHE_NSLOTS_DEFAULT;
-    w0_2 = H5D_CHUNK_CACHE_W0_DEFAULT;
-    if (H5Pset_chunk_cache(dapl2, nslots_2, nbytes_2, w0_2) < 0) FAIL_STACK_ERROR
+    /* A dataset's elements read with H5Dread_multi match H5Dread's */
+    HDmemset(rdata[0], 0, sizeof(rdata[0]));
+    if(H5Dread(did[3], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata[0]) < 0) FAIL_STACK_ERROR
+    if(HDmemcmp(rdata[0], rdata[3], sizeof(rdata[0]))) TEST_ERROR
+
+    /* Nothing is written when any of the arguments is bad */
+    for(u = 0; u < MULTI_NDSETS; u++)
+        for(v = 0; v < MULTI_DIM; v++)
+            idata[u][v] = -1;
+    for(u = 0; u < MULTI_NDSETS; u++) {
+        wbuf[u] = idata[u];
+        mspace[u] = H5S_ALL;
+        fspace[u] = H5S_ALL;
+    } /* end for */
+    saved_id = did[MULTI_NDSETS - 1];
+    did[MULTI_NDSETS - 1] = sid;
+    H5E_BEGIN_TRY {
+        ret = H5Dwrite_multi((size_t)MULTI_NDSETS, did, mtype, mspace, fspace, H5P_DEFAULT, wbuf);
+    } H5E_END_TRY;
+    did[MULTI_NDSETS - 1] = saved_id;
+    if(ret >= 0) FAIL_PUTS_ERROR("    Write with a bad dataset ID succeeded.")
+    if(H5Dread(did[0], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata[0]) < 0) FAIL_STACK_ERROR
+    for(v = 0; v < MULTI_DIM; v++)
+        if(rdata[0][v] != (int)v) FAIL_PUTS_ERROR("    Data written when arguments were bad.")
+
+    /* ... or when the last dataset's memory datatype is bad ... */
+    mtype[MULTI_NDSETS - 1] = sid;
+    H5E_BEGIN_TRY {
+        ret = H5Dwrite_multi((size_t)MULTI_NDSETS, did, mtype, mspace, fspace, H5P_DEFAULT, wbuf);
+    } H5E_END_TRY;
+    mtype[MULTI_NDSETS - 1] = H5T_NATIVE_INT;
+    if(ret >= 0) FAIL_PUTS_ERROR("    Write with a bad memory datatype succeeded.")
 
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if ((dsid = H5Dopen2(fid, "dset", dapl2)) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR /* Close dapl2, to avoid id leak */
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_3 != nslots_4) || (nbytes_2 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those expected.")
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+    /* ... or when its selections have different numbers of elements */
+    mspace[MULTI_NDSETS - 1] = sel_sid;
+    H5E_BEGIN_TRY {
+        ret = H5Dwrite_multi((size_t)MULTI_NDSETS, did, mtype, mspace, fspace, H5P_DEFAULT, wbuf);
+    } H5E_END_TRY;
+    mspace[MULTI_NDSETS - 1] = H5S_ALL;
+    if(ret >= 0) FAIL_PUTS_ERROR("    Write with mismatched selections succeeded.")
+    if(H5Dread(did[0], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata[0]) < 0) FAIL_STACK_ERROR
+    for(v = 0; v < MULTI_DIM; v++)
+        if(rdata[0][v] != (int)v) FAIL_PUTS_ERROR("    Data written when arguments were bad.")
+
+    /* A count of zero does nothing */
+    if(H5Dread_multi((size_t)0, NULL, NULL, NULL, NULL, H5P_DEFAULT, NULL) < 0) FAIL_STACK_ERROR
+
+    for(u = 0; u < MULTI_NDSETS; u++) {
+        if(H5Dclose(did[u]) < 0) FAIL_STACK_ERROR
+        did[u] = -1;
+    } /* end for */
 
-    /* Verify that the file has indeed started using the new cache values (test
-     * use of H5Oopen with H5P_DEFAULT) */
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if ((dsid = H5Oopen(fid, "dset", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
-    if ((dapl2 = H5Dget_access_plist(dsid)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_3 != nslots_4) || (nbytes_3 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from retrieved dapl do not match those from fapl.")
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
+    /* Create a chunked and a contiguous 2-D dataset, with chunks which
+     * don't divide the dimensions, and fill them */
+    if((sid2 = H5Screate_simple(2, dims2, NULL)) < 0) FAIL_STACK_ERROR
+    if((msid2 = H5Screate_simple(2, mdims2, NULL)) < 0) FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl[1], 2, cdims2) < 0) FAIL_STACK_ERROR
+    if(H5Pset_alloc_time(dcpl[1], H5D_ALLOC_TIME_EARLY) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < 2; u++) {
+        for(v = 0; v < MULTI_DIM0; v++)
+            for(w = 0; w < MULTI_DIM1; w++)
+                wdata2[u][v][w] = (int)(u * 10000 + v * 100 + w);
+        if((did[u] = H5Dcreate2(fid, u ? "dset2d_contig" : "dset2d_chunk", H5T_NATIVE_INT, sid2, H5P_DEFAULT, dcpl[u], H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+        if(H5Dwrite(did[u], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata2[u]) < 0) FAIL_STACK_ERROR
+        if(H5Dclose(did[u]) < 0) FAIL_STACK_ERROR
+        did[u] = -1;
+    } /* end for */
 
-    /* Verify functionality of H5Pcopy with a dapl */
-    if ((dapl2 = H5Pcopy(dapl1)) < 0) FAIL_STACK_ERROR
-    if (H5Pget_chunk_cache(dapl2, &nslots_4, &nbytes_4, &w0_4) < 0) FAIL_STACK_ERROR
-    if ((nslots_3 != nslots_4) || (nbytes_1 != nbytes_4) || !H5_DBL_ABS_EQUAL(w0_3, w0_4))
-        FAIL_PUTS_ERROR("    Cache values from dapl2 do not match those from dapl1.")
+    /* Reopen the datasets, so nothing of them is cached, and read a block
+     * of each into the middle of a smaller buffer */
+    if(H5Sselect_hyperslab(sid2, H5S_SELECT_SET, fstart2, NULL, count2, NULL) < 0) FAIL_STACK_ERROR
+    if(H5Sselect_hyperslab(msid2, H5S_SELECT_SET, mstart2, NULL, count2, NULL) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < 2; u++) {
+        if((did[u] = H5Dopen2(fid, u ? "dset2d_contig" : "dset2d_chunk", H5P_DEFAULT)) < 0) FAIL_STACK_ERROR
+        mtype[u] = H5T_NATIVE_INT;
+        mspace[u] = msid2;
+        fspace[u] = sid2;
+        rbuf[u] = mdata2[u];
+        wbuf[u] = mdata2[u];
+    } /* end for */
+    HDmemset(mdata2, 0, sizeof(mdata2));
+    if(H5Dread_multi((size_t)2, did, mtype, mspace, fspace, H5P_DEFAULT, rbuf) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < 2; u++)
+        for(v = 0; v < MULTI_DIM0 - 4; v++)
+            for(w = 0; w < MULTI_DIM1 - 6; w++) {
+                int expect = 0;
+
+                if(v >= mstart2[0] && v < mstart2[0] + count2[0] && w >= mstart2[1] && w < mstart2[1] + count2[1])
+                    expect = wdata2[u][v - mstart2[0] + fstart2[0]][w - mstart2[1] + fstart2[1]];
+                if(mdata2[u][v][w] != expect) {
+                    HDprintf("    2-D dataset %u, element [%u][%u]: read %d, expected %d\n", u, v, w, mdata2[u][v][w], expect);
+                    TEST_ERROR
+                } /* end if */
+            } /* end for */
 
-    /* Close */
-    if (H5Dclose(dsid) < 0) FAIL_STACK_ERROR
-    if (H5Sclose(sid) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(fapl_local) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(fapl_def) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(dapl1) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(dapl2) < 0) FAIL_STACK_ERROR
-    if (H5Pclose(dcpl) < 0) FAIL_STACK_ERROR
-    if (H5Fclose(fid) < 0) FAIL_STACK_ERROR
+    /* Write the block back, negated, and check the whole datasets */
+    for(u = 0; u < 2; u++)
+        for(v = 0; v < MULTI_DIM0 - 4; v++)
+            for(w = 0; w < MULTI_DIM1 - 6; w++)
+                mdata2[u][v][w] = -mdata2[u][v][w];
+    if(H5Dwrite_multi((size_t)2, did, mtype, mspace, fspace, H5P_DEFAULT, wbuf) < 0) FAIL_STACK_ERROR
+    for(u = 0; u < 2; u++) {
+        if(H5Dread(did[u], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata2) < 0) FAIL_STACK_ERROR
+        for(v = 0; v < MULTI_DIM0; v++)
+            for(w = 0; w < MULTI_DIM1; w++) {
+                int expect = wdata2[u][v][w];
+
+                if(v >= fstart2[0] && v < fstart2[0] + count2[0] && w >= fstart2[1] && w < fstart2[1] + count2[1])
+                    expect = -expect;
+                if(rdata2[v][w] != expect) {
+                    HDprintf("    2-D dataset %u, element [%u][%u]: read %d, expected %d\n", u, v, w, rdata2[v][w], expect);
+                    TEST_ERROR
+                } /* end if */
+            } /* end for */
+        if(H5Dclose(did[u]) < 0) FAIL_STACK_ERROR
+        did[u] = -1;
+    } /* end for */
+
+    for(u = 0; u < 3; u++)
+        if(H5Pclose(dcpl[u]) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(msid2) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid2) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sel_sid) < 0) FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0) FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0) FAIL_STACK_ERROR
 
     PASSED();
     return 0;
 
 error:
     H5E_BEGIN_TRY {
-        H5Pclose(fapl_local);
-        H5Pclose(fapl_def);
-        H5Pclose(dapl1);
-        H5Pclose(dapl2);
-        H5Pclose(dcpl);
-        H5Dclose(dsid);
+        for(u = 0; u < MULTI_NDSETS; u++)
+            H5Dclose(did[u]);
+        for(u = 0; u < 3; u++)
+            H5Pclose(dcpl[u]);
+        H5Sclose(msid2);
+        H5Sclose(sid2);
+        H5Sclose(sel_sid);
         H5Sclose(sid);
         H5Fclose(fid);
     } H5E_END_TRY;
     return -1;
-} /* end test_chunk_cache() */
+} /* end test_multi_dset_io() */
 
 
 /*-------------------------------------------------------------------------
@@ -10170,6 +12164,489 @@ error:
 } /* test_unfiltered_edge_chunks */
 
 
+/*-------------------------------------------------------------------------
+ *
+ *  test_filter_nthreads():
+ *      Tests reading filtered chunks when the filters are reversed on
+ *      several worker threads, with and without the chunk cache, and
+ *      that a chunk which fails to decode is still reported.
+ *
+ *-------------------------------------------------------------------------
+ */
+#define FILTER_NTHREADS_DIM     64
+#define FILTER_NTHREADS_CHUNK   8
+static herr_t
+test_filter_nthreads(hid_t fapl)
+{
+    hid_t       fid = -1;               /* File id */
+    hid_t       did = -1;               /* Dataset id */
+    hid_t       sid = -1;               /* Dataspace id */
+    hid_t       mid = -1;               /* Memory dataspace id */
+    hid_t       dcpl = -1;              /* DCPL id */
+    hid_t       my_fapl = -1;           /* FAPL id */
+    hid_t       fapl2 = -1;             /* FAPL id, from file */
+    hsize_t     dim[2] = {FILTER_NTHREADS_DIM, FILTER_NTHREADS_DIM};    /* Dataset dimensions */
+    hsize_t     cdim[2] = {FILTER_NTHREADS_CHUNK, FILTER_NTHREADS_CHUNK}; /* Chunk dimensions */
+    hsize_t     start[2], count[2];     /* Hyperslab selection */
+    const unsigned corrupt_data[3] = {(unsigned)(2 * sizeof(int)), (unsigned)sizeof(int), 0xAAu}; /* Offset, length & value for "corrupt" filter */
+    int         *wbuf = NULL;           /* Write buffer */
+    int         *rbuf = NULL;           /* Read buffer */
+    char        filename[FILENAME_BUF_SIZE] = "";  /* Test file name */
+    unsigned    nthreads;               /* # of filter threads */
+    unsigned    nthreads_out;           /* # of filter threads, from file */
+    unsigned    use_cache;              /* Whether the chunk cache is enabled */
+    herr_t      ret;                    /* Generic return value */
+    size_t      u, v;                   /* Local index variables */
+
+    /* Output message about test being performed */
+    TESTING("reading chunks with filter threads");
+
+    h5_fixname(FILENAME[26], fapl, filename, sizeof filename);
+
+    /* Check the property */
+    if((my_fapl = H5Pcopy(fapl)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pget_filter_nthreads(my_fapl, &nthreads) < 0)
+        FAIL_STACK_ERROR
+    if(nthreads != 0)
+        FAIL_PUTS_ERROR("    Default # of filter threads isn't 0.")
+    if(H5Pset_filter_nthreads(my_fapl, 4) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pget_filter_nthreads(my_fapl, &nthreads) < 0)
+        FAIL_STACK_ERROR
+    if(nthreads != 4)
+        FAIL_PUTS_ERROR("    # of filter threads wasn't set.")
+    if(H5Pclose(my_fapl) < 0)
+        FAIL_STACK_ERROR
+
+    if(NULL == (wbuf = (int *)HDmalloc(sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM)))
+        TEST_ERROR
+    if(NULL == (rbuf = (int *)HDmalloc(sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM)))
+        TEST_ERROR
+    for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+        wbuf[u] = (int)(u * 7);
+
+    /* Create the file, with a shuffled & checksummed dataset, and another
+     * dataset whose chunks fail their checksums */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+        FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(2, dim, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 2, cdim) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_shuffle(dcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_fletcher32(dcpl) < 0)
+        FAIL_STACK_ERROR
+    if((did = H5Dcreate2(fid, DSET_SHUFFLE_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dclose(did) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Zregister(H5Z_CORRUPT) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_filter(dcpl, H5Z_FILTER_CORRUPT, 0, (size_t)3, corrupt_data) < 0)
+        FAIL_STACK_ERROR
+    if((did = H5Dcreate2(fid, DSET_FLETCHER32_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dclose(did) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(fid) < 0)
+        FAIL_STACK_ERROR
+
+    /* Read the data back with different # of threads */
+    for(use_cache = FALSE; use_cache <= TRUE; use_cache++)
+        for(nthreads = 0; nthreads <= 4; nthreads += 2) {
+            if((my_fapl = H5Pcopy(fapl)) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pset_filter_nthreads(my_fapl, nthreads) < 0)
+                FAIL_STACK_ERROR
+            if(use_cache)
+                if(H5Pset_cache(my_fapl, 0, (size_t)521, (size_t)(16 * sizeof(int) * FILTER_NTHREADS_CHUNK * FILTER_NTHREADS_CHUNK), 0.75F) < 0)
+                    FAIL_STACK_ERROR
+
+            if((fid = H5Fopen(filename, H5F_ACC_RDONLY, my_fapl)) < 0)
+                FAIL_STACK_ERROR
+
+            /* Make sure the setting is retrieved from the file */
+            if((fapl2 = H5Fget_access_plist(fid)) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pget_filter_nthreads(fapl2, &nthreads_out) < 0)
+                FAIL_STACK_ERROR
+            if(nthreads_out != nthreads)
+                FAIL_PUTS_ERROR("    # of filter threads from file doesn't match.")
+            if(H5Pclose(fapl2) < 0)
+                FAIL_STACK_ERROR
+
+            /* Read the whole dataset */
+            if((did = H5Dopen2(fid, DSET_SHUFFLE_NAME, H5P_DEFAULT)) < 0)
+                FAIL_STACK_ERROR
+            HDmemset(rbuf, 0, sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM);
+            if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf) < 0)
+                FAIL_STACK_ERROR
+            for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+                if(rbuf[u] != wbuf[u])
+                    FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+
+            /* Read a selection which doesn't line up with the chunks (and,
+             * with the cache enabled, partly hits chunks already cached) */
+            start[0] = 3;
+            start[1] = 5;
+            count[0] = FILTER_NTHREADS_DIM - 9;
+            count[1] = FILTER_NTHREADS_DIM - 11;
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+                FAIL_STACK_ERROR
+            if((mid = H5Screate_simple(2, count, NULL)) < 0)
+                FAIL_STACK_ERROR
+            HDmemset(rbuf, 0, sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM);
+            if(H5Dread(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, rbuf) < 0)
+                FAIL_STACK_ERROR
+            for(u = 0; u < count[0]; u++)
+                for(v = 0; v < count[1]; v++)
+                    if(rbuf[u * count[1] + v] != wbuf[(u + start[0]) * FILTER_NTHREADS_DIM + v + start[1]])
+                        FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+            if(H5Sclose(mid) < 0)
+                FAIL_STACK_ERROR
+            if(H5Dclose(did) < 0)
+                FAIL_STACK_ERROR
+
+            /* Reading the corrupted chunks should fail */
+            if((did = H5Dopen2(fid, DSET_FLETCHER32_NAME, H5P_DEFAULT)) < 0)
+                FAIL_STACK_ERROR
+            H5E_BEGIN_TRY {
+                ret = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf);
+            } H5E_END_TRY;
+            if(ret >= 0)
+                FAIL_PUTS_ERROR("    Reading corrupted chunks succeeded.")
+            if(H5Dclose(did) < 0)
+                FAIL_STACK_ERROR
+
+            if(H5Fclose(fid) < 0)
+                FAIL_STACK_ERROR
+            if(H5Pclose(my_fapl) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+
+    if(H5Sclose(sid) < 0)
+        FAIL_STACK_ERROR
+    HDfree(wbuf);
+    HDfree(rbuf);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dcpl);
+        H5Pclose(my_fapl);
+        H5Pclose(fapl2);
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(wbuf)
+        HDfree(wbuf);
+    if(rbuf)
+        HDfree(rbuf);
+    return -1;
+} /* test_filter_nthreads */
+
+
+/*-------------------------------------------------------------------------
+ *
+ *  test_filter_nthreads_write():
+ *      Tests writing filtered chunks when the filters are applied on
+ *      several worker threads, as chunks are evicted from the chunk cache
+ *      and when it's flushed, and that the file ends up the same as when
+ *      the filters are applied on the calling thread.
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_filter_nthreads_write(hid_t fapl)
+{
+    hid_t       fid = -1;               /* File id */
+    hid_t       did = -1;               /* Dataset id */
+    hid_t       sid = -1;               /* Dataspace id */
+    hid_t       mid = -1;               /* Memory dataspace id */
+    hid_t       dcpl = -1;              /* DCPL id */
+    hid_t       my_fapl = -1;           /* FAPL id */
+    hsize_t     dim[2] = {FILTER_NTHREADS_DIM, FILTER_NTHREADS_DIM};    /* Dataset dimensions */
+    hsize_t     cdim[2] = {FILTER_NTHREADS_CHUNK, FILTER_NTHREADS_CHUNK}; /* Chunk dimensions */
+    hsize_t     start[2], count[2];     /* Hyperslab selection */
+    hsize_t     storage_size = 0;       /* Dataset's storage size, with no threads */
+    hsize_t     file_size = 0;          /* File's size, with no threads */
+    hsize_t     size;                   /* Storage or file size */
+    int         *wbuf = NULL;           /* Write buffer */
+    int         *rbuf = NULL;           /* Read buffer */
+    char        filename[FILENAME_BUF_SIZE] = "";  /* Test file name */
+    unsigned    nthreads;               /* # of filter threads */
+    size_t      u;                      /* Local index variable */
+
+    /* Output message about test being performed */
+    TESTING("writing chunks with filter threads");
+
+    h5_fixname(FILENAME[26], fapl, filename, sizeof filename);
+
+    if(NULL == (wbuf = (int *)HDmalloc(sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM)))
+        TEST_ERROR
+    if(NULL == (rbuf = (int *)HDmalloc(sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM)))
+        TEST_ERROR
+    for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+        wbuf[u] = (int)(u % (1 + u / 256));
+
+    if((sid = H5Screate_simple(2, dim, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_chunk(dcpl, 2, cdim) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_shuffle(dcpl) < 0)
+        FAIL_STACK_ERROR
+#ifdef H5_HAVE_FILTER_DEFLATE
+    if(H5Pset_deflate(dcpl, 6) < 0)
+        FAIL_STACK_ERROR
+#endif /* H5_HAVE_FILTER_DEFLATE */
+    if(H5Pset_fletcher32(dcpl) < 0)
+        FAIL_STACK_ERROR
+
+    /* Write the same data with different # of threads */
+    for(nthreads = 0; nthreads <= 4; nthreads += 2) {
+        if((my_fapl = H5Pcopy(fapl)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pset_filter_nthreads(my_fapl, nthreads) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pset_cache(my_fapl, 0, (size_t)521, (size_t)(16 * sizeof(int) * FILTER_NTHREADS_CHUNK * FILTER_NTHREADS_CHUNK), 0.75F) < 0)
+            FAIL_STACK_ERROR
+
+        if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, my_fapl)) < 0)
+            FAIL_STACK_ERROR
+        if((did = H5Dcreate2(fid, DSET_SHUFFLE_NAME, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+            FAIL_STACK_ERROR
+
+        /* Write the dataset half a row of chunks at a time, so that partly
+         * written chunks are evicted from the cache and written again */
+        count[0] = FILTER_NTHREADS_CHUNK / 2;
+        count[1] = FILTER_NTHREADS_DIM;
+        if((mid = H5Screate_simple(2, count, NULL)) < 0)
+            FAIL_STACK_ERROR
+        start[1] = 0;
+        for(start[0] = 0; start[0] < FILTER_NTHREADS_DIM; start[0] += count[0]) {
+            if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+                FAIL_STACK_ERROR
+            if(H5Dwrite(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, wbuf + start[0] * FILTER_NTHREADS_DIM) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+        if(H5Sclose(mid) < 0)
+            FAIL_STACK_ERROR
+        if(H5Sselect_all(sid) < 0)
+            FAIL_STACK_ERROR
+
+        /* Write the first rows again, to leave dirty chunks for the flush */
+        if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dflush(did) < 0)
+            FAIL_STACK_ERROR
+
+        /* The chunks should take up the same space as with no threads */
+        if(0 == (size = H5Dget_storage_size(did)))
+            FAIL_STACK_ERROR
+        if(0 == nthreads)
+            storage_size = size;
+        else if(size != storage_size)
+            FAIL_PUTS_ERROR("    Storage size differs from serial filtering.")
+
+        if(H5Dclose(did) < 0)
+            FAIL_STACK_ERROR
+        if(H5Fclose(fid) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pclose(my_fapl) < 0)
+            FAIL_STACK_ERROR
+
+        if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Fget_filesize(fid, &size) < 0)
+            FAIL_STACK_ERROR
+        if(0 == nthreads)
+            file_size = size;
+        else if(size != file_size)
+            FAIL_PUTS_ERROR("    File size differs from serial filtering.")
+
+        /* Check the data */
+        if((did = H5Dopen2(fid, DSET_SHUFFLE_NAME, H5P_DEFAULT)) < 0)
+            FAIL_STACK_ERROR
+        HDmemset(rbuf, 0, sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM);
+        if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf) < 0)
+            FAIL_STACK_ERROR
+        for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+            if(rbuf[u] != wbuf[u])
+                FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+        if(H5Dclose(did) < 0)
+            FAIL_STACK_ERROR
+        if(H5Fclose(fid) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+
+    if(H5Pclose(dcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0)
+        FAIL_STACK_ERROR
+    HDfree(wbuf);
+    HDfree(rbuf);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dcpl);
+        H5Pclose(my_fapl);
+        H5Sclose(mid);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(wbuf)
+        HDfree(wbuf);
+    if(rbuf)
+        HDfree(rbuf);
+    return -1;
+} /* test_filter_nthreads_write */
+
+
+/*-------------------------------------------------------------------------
+ *
+ *  test_filter_nthreads_deflate():
+ *      Tests deflating and inflating chunks on many worker threads at
+ *      once, with datasets at different compression levels, so that the
+ *      threads share the deflate filter's pool of streams.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifdef H5_HAVE_FILTER_DEFLATE
+#define FILTER_NTHREADS_DEFLATE_NTHREADS        8
+#define FILTER_NTHREADS_DEFLATE_NDSETS          3
+static herr_t
+test_filter_nthreads_deflate(hid_t fapl)
+{
+    hid_t       fid = -1;               /* File id */
+    hid_t       did = -1;               /* Dataset id */
+    hid_t       sid = -1;               /* Dataspace id */
+    hid_t       dcpl = -1;              /* DCPL id */
+    hid_t       my_fapl = -1;           /* FAPL id */
+    hsize_t     dim[2] = {FILTER_NTHREADS_DIM, FILTER_NTHREADS_DIM};    /* Dataset dimensions */
+    hsize_t     cdim[2] = {FILTER_NTHREADS_CHUNK, FILTER_NTHREADS_CHUNK}; /* Chunk dimensions */
+    const unsigned level[FILTER_NTHREADS_DEFLATE_NDSETS] = {1, 6, 9};  /* Compression levels */
+    int         *wbuf = NULL;           /* Write buffer */
+    int         *rbuf = NULL;           /* Read buffer */
+    char        filename[FILENAME_BUF_SIZE] = "";  /* Test file name */
+    char        dset_name[32];          /* Dataset name */
+    unsigned    pass;                   /* Pass through the datasets */
+    size_t      u, v;                   /* Local index variables */
+
+    /* Output message about test being performed */
+    TESTING("deflating chunks on many filter threads");
+
+    h5_fixname(FILENAME[26], fapl, filename, sizeof filename);
+
+    if(NULL == (wbuf = (int *)HDmalloc(sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM)))
+        TEST_ERROR
+    if(NULL == (rbuf = (int *)HDmalloc(sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM)))
+        TEST_ERROR
+
+    if((my_fapl = H5Pcopy(fapl)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_filter_nthreads(my_fapl, FILTER_NTHREADS_DEFLATE_NTHREADS) < 0)
+        FAIL_STACK_ERROR
+    if((sid = H5Screate_simple(2, dim, NULL)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Write each dataset with its own level, from the filter threads */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, my_fapl)) < 0)
+        FAIL_STACK_ERROR
+    for(v = 0; v < FILTER_NTHREADS_DEFLATE_NDSETS; v++) {
+        for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+            wbuf[u] = (int)((u * (v + 3)) % (1 + u / 64));
+
+        if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pset_chunk(dcpl, 2, cdim) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pset_deflate(dcpl, level[v]) < 0)
+            FAIL_STACK_ERROR
+        HDsnprintf(dset_name, sizeof(dset_name), "deflate_%u", level[v]);
+        if((did = H5Dcreate2(fid, dset_name, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dclose(did) < 0)
+            FAIL_STACK_ERROR
+        if(H5Pclose(dcpl) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+    if(H5Fclose(fid) < 0)
+        FAIL_STACK_ERROR
+
+    /* Read the datasets back on the filter threads, twice over, so the
+     * second pass inflates with streams the first one left in the pool */
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, my_fapl)) < 0)
+        FAIL_STACK_ERROR
+    for(pass = 0; pass < 2; pass++)
+        for(v = 0; v < FILTER_NTHREADS_DEFLATE_NDSETS; v++) {
+            for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+                wbuf[u] = (int)((u * (v + 3)) % (1 + u / 64));
+
+            HDsnprintf(dset_name, sizeof(dset_name), "deflate_%u", level[v]);
+            if((did = H5Dopen2(fid, dset_name, H5P_DEFAULT)) < 0)
+                FAIL_STACK_ERROR
+            HDmemset(rbuf, 0, sizeof(int) * FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM);
+            if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf) < 0)
+                FAIL_STACK_ERROR
+            for(u = 0; u < FILTER_NTHREADS_DIM * FILTER_NTHREADS_DIM; u++)
+                if(rbuf[u] != wbuf[u])
+                    FAIL_PUTS_ERROR("    Data read doesn't match data written.")
+            if(H5Dclose(did) < 0)
+                FAIL_STACK_ERROR
+        } /* end for */
+    if(H5Fclose(fid) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Pclose(my_fapl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(sid) < 0)
+        FAIL_STACK_ERROR
+    HDfree(wbuf);
+    HDfree(rbuf);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Pclose(dcpl);
+        H5Pclose(my_fapl);
+        H5Sclose(sid);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(wbuf)
+        HDfree(wbuf);
+    if(rbuf)
+        HDfree(rbuf);
+    return -1;
+} /* test_filter_nthreads_deflate */
+#endif /* H5_HAVE_FILTER_DEFLATE */
+
+
 /*-------------------------------------------------------------------------
  * Function: test_large_chunk_shrink
  *
@@ -13157,7 +15634,12 @@ main(void)
             nerrors += (test_conv_buffer(file) < 0            ? 1 : 0);
             nerrors += (test_tconv(file) < 0            ? 1 : 0);
             nerrors += (test_filters(file, my_fapl) < 0        ? 1 : 0);
+            nerrors += (test_deflate_levels(file) < 0          ? 1 : 0);
+            nerrors += (test_buffer_pool(file) < 0             ? 1 : 0);
             nerrors += (test_onebyte_shuffle(file) < 0         ? 1 : 0);
+            nerrors += (test_multibyte_shuffle(file) < 0       ? 1 : 0);
+            nerrors += (test_bitshuffle(file) < 0              ? 1 : 0);
+            nerrors += (test_zstd(file) < 0                    ? 1 : 0);
             nerrors += (test_nbit_int(file) < 0                 ? 1 : 0);
             nerrors += (test_nbit_float(file) < 0                     ? 1 : 0);
             nerrors += (test_nbit_double(file) < 0                     ? 1 : 0);
@@ -13195,6 +15677,11 @@ main(void)
 
             nerrors += (test_huge_chunks(my_fapl) < 0        ? 1 : 0);
             nerrors += (test_chunk_cache(my_fapl) < 0        ? 1 : 0);
+            nerrors += (test_shared_chunk_cache(my_fapl) < 0 ? 1 : 0);
+            nerrors += (test_chunk_cache_policy(my_fapl) < 0 ? 1 : 0);
+            nerrors += (test_chunk_read_ahead(my_fapl) < 0 ? 1 : 0);
+            nerrors += (test_chunk_read_coalesce(my_fapl) < 0 ? 1 : 0);
+            nerrors += (test_multi_dset_io(my_fapl) < 0 ? 1 : 0);
             nerrors += (test_big_chunks_bypass_cache(my_fapl) < 0   ? 1 : 0);
             nerrors += (test_chunk_fast(envval, my_fapl) < 0    ? 1 : 0);
             nerrors += (test_reopen_chunk_fast(my_fapl) < 0        ? 1 : 0);
@@ -13204,6 +15691,11 @@ main(void)
             nerrors += (test_fixed_array(my_fapl) < 0        ? 1 : 0);
             nerrors += (test_idx_compatible() < 0            ? 1 : 0);
             nerrors += (test_unfiltered_edge_chunks(my_fapl) < 0    ? 1 : 0);
+            nerrors += (test_filter_nthreads(my_fapl) < 0           ? 1 : 0);
+            nerrors += (test_filter_nthreads_write(my_fapl) < 0     ? 1 : 0);
+#ifdef H5_HAVE_FILTER_DEFLATE
+            nerrors += (test_filter_nthreads_deflate(my_fapl) < 0   ? 1 : 0);
+#endif /* H5_HAVE_FILTER_DEFLATE */
             nerrors += (test_single_chunk(my_fapl) < 0              ? 1 : 0);
             nerrors += (test_large_chunk_shrink(my_fapl) < 0        ? 1 : 0);
             nerrors += (test_zero_dim_dset(my_fapl) < 0             ? 1 : 0);
@@ -0,0 +1,403 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:     Tests event sets and the asynchronous operations inserted in
+ *              them: H5Dread_async(), H5Dwrite_async(), H5Fflush_async()
+ *              and H5Fclose_async().
+ */
+#include "h5test.h"
+
+const char *FILENAME[] = {
+    "event_set",
+    NULL
+};
+
+#define ES_DIM          1000
+#define ES_NWRITES      8
+
+/* Error reported by H5Dwrite() for mismatched selections */
+#define ES_MISMATCH_DESC    "different number of elements selected"
+
+/* Information for es_find_error_cb() */
+typedef struct es_find_error_t {
+    const char *desc;                   /* Part of description to look for */
+    hbool_t found;                      /* Whether an error matched */
+} es_find_error_t;
+
+
+/*-------------------------------------------------------------------------
+ * Function:    es_find_error_cb
+ *
+ * Purpose:     H5Ewalk2() callback which looks for an error whose
+ *              description contains a string.
+ *
+ * Return:      0
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+es_find_error_cb(unsigned H5_ATTR_UNUSED n, const H5E_error2_t *err_desc, void *client_data)
+{
+    es_find_error_t *find = (es_find_error_t *)client_data;
+
+    if(err_desc->desc && HDstrstr(err_desc->desc, find->desc))
+        find->found = TRUE;
+
+    return 0;
+} /* end es_find_error_cb() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_es_basic
+ *
+ * Purpose:     Tests creating, waiting on and closing event sets, empty
+ *              and with operations in them, and bad arguments.
+ *
+ * Return:      Success:    0
+ *              Failure:    1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+test_es_basic(hid_t fapl)
+{
+    char        filename[1024];
+    hid_t       es_id = H5I_INVALID_HID;        /* Event set ID */
+    hid_t       fid = H5I_INVALID_HID;          /* File ID */
+    hid_t       sid = H5I_INVALID_HID;          /* Dataspace ID */
+    hid_t       did = H5I_INVALID_HID;          /* Dataset ID */
+    hsize_t     dim = ES_DIM;                   /* Dataset dimensions */
+    int         wbuf[ES_DIM], rbuf[ES_DIM];     /* Data buffers */
+    size_t      count, num_failed;              /* Event set counts */
+    herr_t      ret;                            /* Generic return value */
+    unsigned    u;                              /* Local index variable */
+
+    TESTING("event set basics");
+
+    h5_fixname(FILENAME[0], fapl, filename, sizeof filename);
+
+    /* An empty event set */
+    if((es_id = H5EScreate()) < 0) TEST_ERROR
+    if(H5I_EVENTSET != H5Iget_type(es_id)) TEST_ERROR
+    if(H5ESget_count(es_id, &count) < 0) TEST_ERROR
+    if(0 != count) TEST_ERROR
+    num_failed = 1;
+    if(H5ESwait(es_id, &num_failed) < 0) TEST_ERROR
+    if(0 != num_failed) TEST_ERROR
+
+    /* Write and read back a dataset */
+    for(u = 0; u < ES_DIM; u++)
+        wbuf[u] = (int)u;
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) TEST_ERROR
+    if((did = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) TEST_ERROR
+    if(H5Dwrite_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf, es_id) < 0) TEST_ERROR
+    if(H5Dread_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf, es_id) < 0) TEST_ERROR
+    if(H5Fflush_async(did, H5F_SCOPE_LOCAL, es_id) < 0) TEST_ERROR
+    if(H5ESget_count(es_id, &count) < 0) TEST_ERROR
+    if(3 != count) TEST_ERROR
+    if(H5ESwait(es_id, &num_failed) < 0) TEST_ERROR
+    if(0 != num_failed) TEST_ERROR
+    if(H5ESget_count(es_id, &count) < 0) TEST_ERROR
+    if(0 != count) TEST_ERROR
+    if(HDmemcmp(wbuf, rbuf, sizeof(rbuf))) TEST_ERROR
+
+    /* Bad arguments are reported by the call that inserts the operation */
+    H5E_BEGIN_TRY {
+        ret = H5Dwrite_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf, sid);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5Dread_async(sid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf, es_id);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5Fclose_async(did, es_id);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5ESwait(did, NULL);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    if(H5ESget_count(es_id, &count) < 0) TEST_ERROR
+    if(0 != count) TEST_ERROR
+
+    if(H5Dclose(did) < 0) TEST_ERROR
+    if(H5Sclose(sid) < 0) TEST_ERROR
+    if(H5Fclose(fid) < 0) TEST_ERROR
+    if(H5ESclose(es_id) < 0) TEST_ERROR
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Sclose(sid);
+        H5Fclose(fid);
+        H5ESclose(es_id);
+    } H5E_END_TRY;
+    return 1;
+} /* end test_es_basic() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_es_order
+ *
+ * Purpose:     Tests that asynchronous operations are performed in the
+ *              order they're inserted, within and across event sets, that
+ *              the IDs they use can be closed as soon as they're inserted,
+ *              and that an asynchronous file close waits for the
+ *              operations before it.
+ *
+ * Return:      Success:    0
+ *              Failure:    1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+test_es_order(hid_t fapl)
+{
+    char        filename[1024];
+    hid_t       es_id[2] = {H5I_INVALID_HID, H5I_INVALID_HID};  /* Event set IDs */
+    hid_t       fid = H5I_INVALID_HID;          /* File ID */
+    hid_t       sid = H5I_INVALID_HID;          /* Dataspace ID */
+    hid_t       msid = H5I_INVALID_HID;         /* Memory dataspace ID */
+    hid_t       did = H5I_INVALID_HID;          /* Dataset ID */
+    hsize_t     dim = ES_DIM;                   /* Dataset dimensions */
+    hsize_t     start, count;                   /* Hyperslab selection */
+    int         wbuf[ES_NWRITES][ES_DIM];       /* Write buffers */
+    int         rbuf[2][ES_DIM];                /* Read buffers */
+    unsigned    u, v;                           /* Local index variables */
+
+    TESTING("ordering of asynchronous operations");
+
+    h5_fixname(FILENAME[0], fapl, filename, sizeof filename);
+
+    if((es_id[0] = H5EScreate()) < 0) TEST_ERROR
+    if((es_id[1] = H5EScreate()) < 0) TEST_ERROR
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) TEST_ERROR
+    if((did = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) TEST_ERROR
+
+    /* Overwrite the dataset repeatedly, with each write's buffer and
+     * selection closed or changed right after the write is inserted.  Each
+     * write covers a shrinking prefix of the dataset, alternating between
+     * the two event sets, and a read in each set sees the writes before it.
+     */
+    for(u = 0; u < ES_NWRITES; u++) {
+        for(v = 0; v < ES_DIM; v++)
+            wbuf[u][v] = (int)(u * ES_DIM + v);
+        start = 0;
+        count = ES_DIM - u * 100;
+        if((msid = H5Screate_simple(1, &count, NULL)) < 0) TEST_ERROR
+        if(H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL) < 0) TEST_ERROR
+        if(H5Dwrite_async(did, H5T_NATIVE_INT, msid, sid, H5P_DEFAULT, wbuf[u], es_id[u % 2]) < 0) TEST_ERROR
+        if(H5Sclose(msid) < 0) TEST_ERROR
+        msid = H5I_INVALID_HID;
+        if(u == ES_NWRITES / 2)
+            if(H5Dread_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf[0], es_id[1]) < 0) TEST_ERROR
+    } /* end for */
+    if(H5Sselect_none(sid) < 0) TEST_ERROR
+    if(H5Dread_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf[1], es_id[0]) < 0) TEST_ERROR
+
+    /* Close the dataset and file before the operations complete */
+    if(H5Dclose(did) < 0) TEST_ERROR
+    did = H5I_INVALID_HID;
+    if(H5Fflush_async(fid, H5F_SCOPE_GLOBAL, es_id[1]) < 0) TEST_ERROR
+    if(H5Fclose_async(fid, es_id[1]) < 0) TEST_ERROR
+    fid = H5I_INVALID_HID;
+
+    /* Waiting on one set waits for operations inserted in it only, but
+     * those operations happen after every one inserted before them */
+    if(H5ESwait(es_id[1], NULL) < 0) TEST_ERROR
+    if(H5ESwait(es_id[0], NULL) < 0) TEST_ERROR
+
+    /* Each element holds the value from the last write covering it */
+    for(u = 0; u < 2; u++)
+        for(v = 0; v < ES_DIM; v++) {
+            unsigned last = u ? ES_NWRITES - 1 : ES_NWRITES / 2;    /* Last write before read */
+            unsigned w = MIN(last, (ES_DIM - 1 - v) / 100);         /* Last write covering element */
+
+            if(rbuf[u][v] != wbuf[w][v]) {
+                HDprintf("    Read %u, element %u: read %d, expected %d\n", u, v, rbuf[u][v], wbuf[w][v]);
+                TEST_ERROR
+            } /* end if */
+        } /* end for */
+
+    /* The file was closed asynchronously, after the other operations: it
+     * can be reopened and holds the last write */
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl)) < 0) TEST_ERROR
+    if((did = H5Dopen2(fid, "dset", H5P_DEFAULT)) < 0) TEST_ERROR
+    HDmemset(rbuf[0], 0, sizeof(rbuf[0]));
+    if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf[0]) < 0) TEST_ERROR
+    if(HDmemcmp(rbuf[0], rbuf[1], sizeof(rbuf[0]))) TEST_ERROR
+    if(H5Dclose(did) < 0) TEST_ERROR
+    if(H5Fclose(fid) < 0) TEST_ERROR
+
+    if(H5Sclose(sid) < 0) TEST_ERROR
+    if(H5ESclose(es_id[0]) < 0) TEST_ERROR
+    if(H5ESclose(es_id[1]) < 0) TEST_ERROR
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Sclose(msid);
+        H5Sclose(sid);
+        H5Fclose(fid);
+        H5ESclose(es_id[0]);
+        H5ESclose(es_id[1]);
+    } H5E_END_TRY;
+    return 1;
+} /* end test_es_order() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_es_errors
+ *
+ * Purpose:     Tests that an asynchronous operation's failure is reported
+ *              when its event set is waited on or closed, without
+ *              affecting the other operations.
+ *
+ * Return:      Success:    0
+ *              Failure:    1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+test_es_errors(hid_t fapl)
+{
+    char        filename[1024];
+    hid_t       es_id = H5I_INVALID_HID;        /* Event set ID */
+    hid_t       fid = H5I_INVALID_HID;          /* File ID */
+    hid_t       sid = H5I_INVALID_HID;          /* Dataspace ID */
+    hid_t       msid = H5I_INVALID_HID;         /* Memory dataspace ID */
+    hid_t       did = H5I_INVALID_HID;          /* Dataset ID */
+    hsize_t     dim = ES_DIM;                   /* Dataset dimensions */
+    hsize_t     small_dim = ES_DIM / 2;         /* Mismatched memory dimensions */
+    int         wbuf[ES_DIM], rbuf[ES_DIM];     /* Data buffers */
+    size_t      count, num_failed;              /* Event set counts */
+    es_find_error_t find;                       /* Error to look for */
+    herr_t      ret;                            /* Generic return value */
+    unsigned    u;                              /* Local index variable */
+
+    TESTING("failures of asynchronous operations");
+
+    h5_fixname(FILENAME[0], fapl, filename, sizeof filename);
+
+    for(u = 0; u < ES_DIM; u++)
+        wbuf[u] = (int)u;
+    if((es_id = H5EScreate()) < 0) TEST_ERROR
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) TEST_ERROR
+    if((sid = H5Screate_simple(1, &dim, NULL)) < 0) TEST_ERROR
+    if((msid = H5Screate_simple(1, &small_dim, NULL)) < 0) TEST_ERROR
+    if((did = H5Dcreate2(fid, "dset", H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) TEST_ERROR
+
+    /* A write whose selections don't match only fails when it's performed;
+     * the operations around it still happen */
+    if(H5Dwrite_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf, es_id) < 0) TEST_ERROR
+    if(H5Dwrite_async(did, H5T_NATIVE_INT, msid, H5S_ALL, H5P_DEFAULT, wbuf, es_id) < 0) TEST_ERROR
+    if(H5Dread_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf, es_id) < 0) TEST_ERROR
+    num_failed = 0;
+    H5E_BEGIN_TRY {
+        ret = H5ESwait(es_id, &num_failed);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    if(1 != num_failed) TEST_ERROR
+
+    /* The cause of the failure is on the waiter's error stack */
+    find.desc = ES_MISMATCH_DESC;
+    find.found = FALSE;
+    if(H5Ewalk2(H5E_DEFAULT, H5E_WALK_UPWARD, es_find_error_cb, &find) < 0) TEST_ERROR
+    if(!find.found) TEST_ERROR
+
+    if(H5ESget_count(es_id, &count) < 0) TEST_ERROR
+    if(0 != count) TEST_ERROR
+    if(HDmemcmp(wbuf, rbuf, sizeof(rbuf))) TEST_ERROR
+
+    /* The failure was reported: the event set can be used again */
+    if(H5Dread_async(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf, es_id) < 0) TEST_ERROR
+    if(H5ESwait(es_id, &num_failed) < 0) TEST_ERROR
+    if(0 != num_failed) TEST_ERROR
+
+    /* Closing an event set with a failed operation in it fails, but
+     * closes the event set */
+    if(H5Dwrite_async(did, H5T_NATIVE_INT, msid, H5S_ALL, H5P_DEFAULT, wbuf, es_id) < 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5ESclose(es_id);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    H5E_BEGIN_TRY {
+        ret = H5ESget_count(es_id, &count);
+    } H5E_END_TRY;
+    if(ret >= 0) TEST_ERROR
+    es_id = H5I_INVALID_HID;
+
+    if(H5Dclose(did) < 0) TEST_ERROR
+    if(H5Sclose(msid) < 0) TEST_ERROR
+    if(H5Sclose(sid) < 0) TEST_ERROR
+    if(H5Fclose(fid) < 0) TEST_ERROR
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(did);
+        H5Sclose(msid);
+        H5Sclose(sid);
+        H5Fclose(fid);
+        H5ESclose(es_id);
+    } H5E_END_TRY;
+    return 1;
+} /* end test_es_errors() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    main
+ *
+ * Purpose:     Tests event sets and asynchronous operations
+ *
+ * Return:      Success:    EXIT_SUCCESS
+ *              Failure:    EXIT_FAILURE
+ *
+ *-------------------------------------------------------------------------
+ */
+int
+main(void)
+{
+    hid_t       fapl = H5I_INVALID_HID;         /* File access property list ID */
+    int         nerrors = 0;                    /* Number of errors */
+
+    h5_reset();
+    fapl = h5_fileaccess();
+
+    nerrors += test_es_basic(fapl);
+    nerrors += test_es_order(fapl);
+    nerrors += test_es_errors(fapl);
+
+    if(nerrors)
+        goto error;
+    HDputs("All event set tests passed.");
+    h5_cleanup(FILENAME, fapl);
+
+    return EXIT_SUCCESS;
+
+error:
+    HDprintf("***** %d EVENT SET TEST%s FAILED! *****\n", nerrors, 1 == nerrors ? "" : "S");
+    return EXIT_FAILURE;
+} /* end main() */
+
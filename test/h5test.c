@@ -186,6 +186,18 @@ h5_clean_files(const char *base_name[], hid_t fapl)
                 HDsnprintf(temp, sizeof temp, "%s-%c.h5", filename, multi_letters[mt]);
                 HDremove(temp); /*don't care if it fails*/
             } /* end for */
+        } else if(driver == H5FD_SUBFILING) {
+            unsigned j;
+
+            for(j = 0; /*void*/; j++) {
+                HDsnprintf(temp, sizeof temp, H5FD_SUBFILING_NAME_FORMAT, filename, j);
+
+                if(HDaccess(temp, F_OK) < 0)
+                    break;
+
+                HDremove(temp);
+            } /* end for */
+            HDremove(filename);
         } else {
             HDremove(filename);
         }
@@ -258,6 +270,20 @@ h5_delete_test_file(const char *base_name, hid_t fapl)
             HDsnprintf(sub_filename, sizeof(sub_filename), "%s-%c.h5", filename, multi_letters[mt]);
             HDremove(sub_filename);
         } /* end for */
+    } else if(driver == H5FD_SUBFILING) {
+        unsigned j;
+        for(j = 0; /*void*/; j++) {
+            HDsnprintf(sub_filename, sizeof(sub_filename), H5FD_SUBFILING_NAME_FORMAT, filename, j);
+
+            /* If we can't access the file, it probably doesn't exist
+             * and we are done deleting the subfiles.
+             */
+            if(HDaccess(sub_filename, F_OK) < 0)
+                break;
+
+            HDremove(sub_filename);
+        } /* end for */
+        HDremove(filename);
     } else {
         HDremove(filename);
     } /* end if */
@@ -896,6 +922,16 @@ h5_fileaccess(void)
         if(H5Pset_fapl_family(fapl, fam_size, H5P_DEFAULT)<0)
             return -1;
     }
+    else if(!HDstrcmp(name, "subfiling")) {
+        unsigned nsubfiles = 0;     /* default number of subfiles */
+
+        /* Address space striped over subfiles, with the default stripe
+         * size and no worker threads */
+        if((val = HDstrtok(NULL, " \t\n\r")))
+            nsubfiles = (unsigned)HDstrtoul(val, NULL, 0);
+        if(H5Pset_fapl_subfiling(fapl, nsubfiles, (hsize_t)0, 0) < 0)
+            return -1;
+    }
     else if(!HDstrcmp(name, "log")) {
         unsigned log_flags = H5FD_LOG_LOC_IO | H5FD_LOG_ALLOC;
 
@@ -1034,6 +1070,15 @@ h5_get_vfd_fapl(void)
             fam_size = (hsize_t)(HDstrtod(tok, NULL) * 1024*1024);
         if(H5Pset_fapl_family(fapl, fam_size, H5P_DEFAULT) < 0)
             return -1;
+    } else if(!HDstrcmp(tok, "subfiling")) {
+        /* Address space striped over subfiles */
+        unsigned nsubfiles = 0;     /* default number of subfiles */
+
+        /* Was a number of subfiles specified in the environment variable? */
+        if((tok = HDstrtok(NULL, " \t\n\r")))
+            nsubfiles = (unsigned)HDstrtoul(tok, NULL, 0);
+        if(H5Pset_fapl_subfiling(fapl, nsubfiles, (hsize_t)0, 0) < 0)
+            return -1;
     } else if(!HDstrcmp(tok, "log")) {
         /* Log file access */
         unsigned log_flags = H5FD_LOG_LOC_IO | H5FD_LOG_ALLOC;
@@ -1401,6 +1446,29 @@ h5_get_file_size(const char *filename, hid_t fapl)
             /* Return total size */
             return(tot_size);
         } /* end if */
+        else if(driver == H5FD_SUBFILING) {
+            h5_stat_size_t tot_size = 0;
+
+            /* Add up the subfiles, until we find one that's missing */
+            for(j = 0; /*void*/; j++) {
+                /* Create the filename to query */
+                HDsnprintf(temp, sizeof temp, H5FD_SUBFILING_NAME_FORMAT, filename, (unsigned)j);
+
+                /* Check for existence of file */
+                if(HDaccess(temp, F_OK) < 0)
+                    break;
+
+                /* Get the file's statistics */
+                if(0 != HDstat(temp, &sb))
+                    return(-1);
+
+                /* Add to total size */
+                tot_size += (h5_stat_size_t)sb.st_size;
+            } /* end for */
+
+            /* Return total size */
+            return(tot_size);
+        } /* end if */
         else {
             HDassert(0 && "Unknown VFD!");
         } /* end else */
@@ -7750,6 +7750,7 @@ done:
             case H5I_ERROR_CLASS:
             case H5I_ERROR_MSG:
             case H5I_ERROR_STACK:
+            case H5I_EVENTSET:
             case H5I_NTYPES:
             default:
               return -1;
@@ -7838,6 +7839,7 @@ done:
             case H5I_ERROR_CLASS:
             case H5I_ERROR_MSG:
             case H5I_ERROR_STACK:
+            case H5I_EVENTSET:
             case H5I_NTYPES:
             default:
                 return -1;
@@ -34,6 +34,7 @@
 #include "H5CXprivate.h"        /* API Contexts                         */
 #include "H5Iprivate.h"
 #include "H5PBprivate.h"
+#include "H5TPprivate.h"        /* Thread pools                         */
 
 
 #define FILENAME_LEN		1024
@@ -51,10 +52,8 @@ static unsigned test_raw_data_handling(hid_t orig_fapl, const char *env_h5_drvr)
 static unsigned test_lru_processing(hid_t orig_fapl, const char *env_h5_drvr);
 static unsigned test_min_threshold(hid_t orig_fapl, const char *env_h5_drvr);
 static unsigned test_stats_collection(hid_t orig_fapl, const char *env_h5_drvr);
-#ifdef H5_HAVE_PARALLEL
-static unsigned verify_page_buffering_disabled(hid_t orig_fapl, 
-    const char *env_h5_drvr);
-#endif /* H5_HAVE_PARALLEL */
+static unsigned test_write_behind(hid_t orig_fapl, const char *env_h5_drvr);
+static unsigned test_prefetch(hid_t orig_fapl, const char *env_h5_drvr);
 
 const char *FILENAME[] = {
     "filepaged",
@@ -2002,120 +2001,419 @@ error:
     return 1;
 } /* test_stats_collection */
 
-
+
 /*-------------------------------------------------------------------------
- * Function:    verify_page_buffering_disabled()
+ * Function:    test_write_behind()
  *
- * Purpose:     This function should only be called in parallel 
- *              builds.
- *
- *              At present, page buffering should be disabled in parallel
- *              builds.  Verify this.
+ * Purpose:     Tests writing dirty pages behind: the watermark arguments
+ *              are checked, the dirty pages stay below the high watermark
+ *              where drains run when it's reached, a flush leaves no
+ *              dirty pages, and the data written is correct.  With
+ *              threads, writes and evictions return while the drain
+ *              they started is still pending.
  *
  * Return:      0 if test is sucessful
  *              1 if test fails
  *
- * Programmer:  John Mainzer
- *              03/21/17
- *              
- * Changes:     None.
- *
  *-------------------------------------------------------------------------
  */
-
-#ifdef H5_HAVE_PARALLEL
 static unsigned
-verify_page_buffering_disabled(hid_t orig_fapl, const char *env_h5_drvr)
+test_write_behind(hid_t orig_fapl, const char *env_h5_drvr)
 {
     char filename[FILENAME_LEN]; /* Filename to use */
     hid_t file_id = -1;          /* File ID */
     hid_t fcpl = -1;
     hid_t fapl = -1;
+    hid_t fapl2 = -1;
+    hid_t dset_id = -1;
+    hid_t dcpl = -1;
+    hid_t file_space = -1;
+    hid_t mem_space = -1;
+    size_t page_size = sizeof(int) * 200;
+    size_t high = 0, low = 0;
+    hsize_t dims = 4000;
+    hsize_t start, count = 100;
+    int num_elements = 4000;
+    int *data = NULL;
+    int i, j;
+    H5F_t *f = NULL;
+#ifdef H5TP_HAVE_THREADS
+    haddr_t addr;
+    hbool_t api_locked = FALSE;
+#endif /* H5TP_HAVE_THREADS */
 
-    TESTING("Page Buffering Disabled");
-    h5_fixname(FILENAME[0], orig_fapl, filename, sizeof(filename));
-
+    TESTING("Write-behind");
 
-    /* first, try to create a file with page buffering enabled */
+    h5_fixname(FILENAME[0], orig_fapl, filename, sizeof(filename));
 
     if((fapl = H5Pcopy(orig_fapl)) < 0)
         TEST_ERROR
 
-    if(set_multi_split(env_h5_drvr, fapl, 4096)  != 0)
+    if(set_multi_split(env_h5_drvr, fapl, (hsize_t)page_size) != 0)
         TEST_ERROR;
 
-    if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
-        FAIL_STACK_ERROR;
+    if((data = (int *)HDcalloc((size_t)num_elements, sizeof(int))) == NULL)
+        TEST_ERROR
+
+    /* Write-behind is disabled by default */
+    if(H5Pget_page_buffer_write_behind(fapl, &high, &low) < 0)
+        FAIL_STACK_ERROR
+    if(high != 0 || low != 0)
+        TEST_ERROR
+
+    /* The low watermark can't be bigger than the high one */
+    H5E_BEGIN_TRY {
+        if(H5Pset_page_buffer_write_behind(fapl, page_size, page_size * 2) >= 0)
+            TEST_ERROR
+    } H5E_END_TRY;
 
+    if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
+        FAIL_STACK_ERROR
     if(H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, 0, (hsize_t)1) < 0)
-        FAIL_STACK_ERROR;
+        FAIL_STACK_ERROR
+    if(H5Pset_file_space_page_size(fcpl, (hsize_t)page_size) < 0)
+        FAIL_STACK_ERROR
 
-    if(H5Pset_file_space_page_size(fcpl, 4096) < 0)
-        FAIL_STACK_ERROR;
+    /* Keep 8 pages in the page buffer, draining dirty ones from 4 down to 1 */
+    if(H5Pset_page_buffer_size(fapl, page_size * 8, 0, 0) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_page_buffer_write_behind(fapl, page_size * 4, page_size) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pget_page_buffer_write_behind(fapl, &high, &low) < 0)
+        FAIL_STACK_ERROR
+    if(high != page_size * 4 || low != page_size)
+        TEST_ERROR
 
-    if(H5Pset_page_buffer_size(fapl, 4096*8, 0, 0) < 0)
-        FAIL_STACK_ERROR;
+    /* Write dataset elements one by one through the page buffer */
+    if(H5Pset_sieve_buf_size(fapl, (size_t)0) < 0)
+        FAIL_STACK_ERROR
 
-    /* try to create  the file -- should fail */
-    H5E_BEGIN_TRY {
-        file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl, fapl);
-    } H5E_END_TRY;
+    if((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl, fapl)) < 0)
+        FAIL_STACK_ERROR
 
-    if(file_id >= 0)
-        TEST_ERROR;
+    /* The file's access property list has the watermarks */
+    if((fapl2 = H5Fget_access_plist(file_id)) < 0)
+        FAIL_STACK_ERROR
+    high = low = 0;
+    if(H5Pget_page_buffer_write_behind(fapl2, &high, &low) < 0)
+        FAIL_STACK_ERROR
+    if(high != page_size * 4 || low != page_size)
+        TEST_ERROR
+    if(H5Pclose(fapl2) < 0)
+        FAIL_STACK_ERROR
+
+    /* Get a pointer to the internal file object */
+    if(NULL == (f = (H5F_t *)H5I_object(file_id)))
+        FAIL_STACK_ERROR
+
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0)
+        FAIL_STACK_ERROR
+    if((file_space = H5Screate_simple(1, &dims, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((mem_space = H5Screate_simple(1, &count, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((dset_id = H5Dcreate2(file_id, "dset", H5T_NATIVE_INT, file_space,
+            H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+
+    /* Write half of each page of the dataset, dirtying a page each time */
+    for(i = 0; i < num_elements; i += 200) {
+        for(j = 0; j < (int)count; j++)
+            data[j] = i + j;
+
+        start = (hsize_t)i;
+        if(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &start, NULL, &count, NULL) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dwrite(dset_id, H5T_NATIVE_INT, mem_space, file_space, H5P_DEFAULT, data) < 0)
+            FAIL_STACK_ERROR
+
+#ifndef H5_HAVE_THREADSAFE
+        /* Drains run as soon as the high watermark is reached */
+        if(f->shared->page_buf->dirty_count * page_size >= page_size * 4)
+            TEST_ERROR
+#endif /* H5_HAVE_THREADSAFE */
+    } /* end for */
 
-    /* now, create a file, close it, and then try to open it with page 
-     * buffering enabled.
+    /* Flushing waits for a drain and writes the rest of the dirty pages */
+    if(H5Fflush(file_id, H5F_SCOPE_GLOBAL) < 0)
+        FAIL_STACK_ERROR
+    if(f->shared->page_buf->dirty_count != 0)
+        TEST_ERROR
+
+#ifdef H5TP_HAVE_THREADS
+    if(HADDR_UNDEF == (addr = H5Dget_offset(dset_id)))
+        FAIL_STACK_ERROR
+
+    /* Hold the library lock, so a drain can't run, while dirtying every
+     * page of the dataset again.  Reaching the high watermark queues a
+     * drain and filling the page buffer evicts pages, but neither waits
+     * for the drain.
      */
-    if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
-        FAIL_STACK_ERROR;
+    H5_API_LOCK
+    api_locked = TRUE;
+    for(i = 0; i < num_elements; i += 200) {
+        for(j = 0; j < (int)count; j++)
+            data[j] = i + j;
+
+        if(H5F_block_write(f, H5FD_MEM_DRAW, addr + (haddr_t)i * sizeof(int),
+                sizeof(int) * (size_t)count, data) < 0)
+            FAIL_STACK_ERROR
+    } /* end for */
+    if(!f->shared->page_buf->wb_pending || !f->shared->page_buf->wb_active)
+        TEST_ERROR
+    if(f->shared->page_buf->dirty_count * page_size < page_size * 4)
+        TEST_ERROR
+    api_locked = FALSE;
+    H5_API_UNLOCK
 
-    if(H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, 0, (hsize_t)1) < 0)
-        FAIL_STACK_ERROR;
+    if(H5Fflush(file_id, H5F_SCOPE_GLOBAL) < 0)
+        FAIL_STACK_ERROR
+    if(f->shared->page_buf->wb_pending || f->shared->page_buf->dirty_count != 0)
+        TEST_ERROR
+#endif /* H5TP_HAVE_THREADS */
 
-    if(H5Pset_file_space_page_size(fcpl, 4096) < 0)
-        FAIL_STACK_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(file_id) < 0)
+        FAIL_STACK_ERROR
 
-    /* create the file */
-    if((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl, H5P_DEFAULT)) < 0)
-        FAIL_STACK_ERROR;
+    /* Verify the data without page buffering */
+    if((file_id = H5Fopen(filename, H5F_ACC_RDONLY, orig_fapl)) < 0)
+        FAIL_STACK_ERROR
+    if((dset_id = H5Dopen2(file_id, "dset", H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+        FAIL_STACK_ERROR
+    for(i = 0; i < num_elements; i++) {
+        int expected = (i % 200) < (int)count ? i : 0;
+
+        if(data[i] != expected) {
+            HDfprintf(stderr, "Read different values than written\n");
+            TEST_ERROR;
+        } /* end if */
+    } /* end for */
 
-    /* close the file */
+    if(H5Dclose(dset_id) < 0)
+        FAIL_STACK_ERROR
     if(H5Fclose(file_id) < 0)
-        FAIL_STACK_ERROR;
+        FAIL_STACK_ERROR
+    if(H5Sclose(mem_space) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(file_space) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(fcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(fapl) < 0)
+        FAIL_STACK_ERROR
+    HDfree(data);
 
-    /* try to open the file using the fapl prepared above which enables 
-     * page buffering.  Should fail.
-     */
+    PASSED()
+    return 0;
+
+error:
+#ifdef H5TP_HAVE_THREADS
+    if(api_locked)
+        H5_API_UNLOCK
+#endif /* H5TP_HAVE_THREADS */
     H5E_BEGIN_TRY {
-        file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl);
+        H5Dclose(dset_id);
+        H5Sclose(mem_space);
+        H5Sclose(file_space);
+        H5Pclose(dcpl);
+        H5Pclose(fapl2);
+        H5Pclose(fapl);
+        H5Pclose(fcpl);
+        H5Fclose(file_id);
     } H5E_END_TRY;
+    if(data)
+        HDfree(data);
+    return 1;
+} /* test_write_behind */
 
-    if(file_id >= 0)
+
+/*-------------------------------------------------------------------------
+ * Function:    test_prefetch()
+ *
+ * Purpose:     Test that sequential raw data reads make the page buffer
+ *              read the following pages ahead, and that the data read
+ *              from prefetched pages is correct.
+ *
+ * Return:      0 if test is sucessful
+ *              1 if test fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static unsigned
+test_prefetch(hid_t orig_fapl, const char *env_h5_drvr)
+{
+    char filename[FILENAME_LEN]; /* Filename to use */
+    hid_t file_id = -1;          /* File ID */
+    hid_t fcpl = -1;
+    hid_t fapl = -1;
+    hid_t fapl2 = -1;
+    hid_t dset_id = -1;
+    hid_t dcpl = -1;
+    hid_t file_space = -1;
+    hid_t mem_space = -1;
+    size_t page_size = sizeof(int) * 200;
+    size_t npages = 0;
+    hsize_t dims = 4000;
+    hsize_t start, count = 100;
+    int num_elements = 4000;
+    int *data = NULL;
+    int i, j;
+    H5F_t *f = NULL;
+
+    TESTING("Raw data prefetch");
+
+    h5_fixname(FILENAME[0], orig_fapl, filename, sizeof(filename));
+
+    if((fapl = H5Pcopy(orig_fapl)) < 0)
+        TEST_ERROR
+
+    if(set_multi_split(env_h5_drvr, fapl, (hsize_t)page_size) != 0)
         TEST_ERROR;
 
-    if(H5Pclose(fcpl) < 0)
-        FAIL_STACK_ERROR;
+    if((data = (int *)HDcalloc((size_t)num_elements, sizeof(int))) == NULL)
+        TEST_ERROR
+
+    /* Prefetching is disabled by default */
+    if(H5Pget_page_buffer_prefetch(fapl, &npages) < 0)
+        FAIL_STACK_ERROR
+    if(npages != 0)
+        TEST_ERROR
+
+    if((fcpl = H5Pcreate(H5P_FILE_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, 0, (hsize_t)1) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_file_space_page_size(fcpl, (hsize_t)page_size) < 0)
+        FAIL_STACK_ERROR
+
+    /* Write the dataset without page buffering */
+    if((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl, fapl)) < 0)
+        FAIL_STACK_ERROR
+    if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0)
+        FAIL_STACK_ERROR
+    if((file_space = H5Screate_simple(1, &dims, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((mem_space = H5Screate_simple(1, &count, NULL)) < 0)
+        FAIL_STACK_ERROR
+    if((dset_id = H5Dcreate2(file_id, "dset", H5T_NATIVE_INT, file_space,
+            H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+
+    for(i = 0; i < num_elements; i++)
+        data[i] = i;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5Dclose(dset_id) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(file_id) < 0)
+        FAIL_STACK_ERROR
+
+    /* Reopen with 16 pages in the page buffer, reading up to 4 pages ahead */
+    if(H5Pset_page_buffer_size(fapl, page_size * 16, 0, 0) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pset_page_buffer_prefetch(fapl, (size_t)4) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pget_page_buffer_prefetch(fapl, &npages) < 0)
+        FAIL_STACK_ERROR
+    if(npages != 4)
+        TEST_ERROR
+
+    /* Read dataset elements through the page buffer */
+    if(H5Pset_sieve_buf_size(fapl, (size_t)0) < 0)
+        FAIL_STACK_ERROR
+
+    if((file_id = H5Fopen(filename, H5F_ACC_RDONLY, fapl)) < 0)
+        FAIL_STACK_ERROR
+
+    /* The file's access property list has the prefetch size */
+    if((fapl2 = H5Fget_access_plist(file_id)) < 0)
+        FAIL_STACK_ERROR
+    npages = 0;
+    if(H5Pget_page_buffer_prefetch(fapl2, &npages) < 0)
+        FAIL_STACK_ERROR
+    if(npages != 4)
+        TEST_ERROR
+    if(H5Pclose(fapl2) < 0)
+        FAIL_STACK_ERROR
+
+    /* Get a pointer to the internal file object */
+    if(NULL == (f = (H5F_t *)H5I_object(file_id)))
+        FAIL_STACK_ERROR
 
+    if((dset_id = H5Dopen2(file_id, "dset", H5P_DEFAULT)) < 0)
+        FAIL_STACK_ERROR
+
+    if(H5PB_reset_stats(f->shared->page_buf) < 0)
+        FAIL_STACK_ERROR
+
+    /* Read the dataset sequentially, half a page at a time */
+    for(i = 0; i < num_elements; i += (int)count) {
+        HDmemset(data, 0, (size_t)count * sizeof(int));
+
+        start = (hsize_t)i;
+        if(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &start, NULL, &count, NULL) < 0)
+            FAIL_STACK_ERROR
+        if(H5Dread(dset_id, H5T_NATIVE_INT, mem_space, file_space, H5P_DEFAULT, data) < 0)
+            FAIL_STACK_ERROR
+
+        for(j = 0; j < (int)count; j++)
+            if(data[j] != i + j) {
+                HDfprintf(stderr, "Read different values than written\n");
+                TEST_ERROR;
+            } /* end if */
+    } /* end for */
+
+    /* Most of the 20 pages of the dataset were read ahead */
+    if(f->shared->page_buf->prefetches == 0)
+        TEST_ERROR
+    if(f->shared->page_buf->misses[1] >= (unsigned)(dims / 200) / 2)
+        TEST_ERROR
+
+    if(H5Dclose(dset_id) < 0)
+        FAIL_STACK_ERROR
+    if(H5Fclose(file_id) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(mem_space) < 0)
+        FAIL_STACK_ERROR
+    if(H5Sclose(file_space) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(dcpl) < 0)
+        FAIL_STACK_ERROR
+    if(H5Pclose(fcpl) < 0)
+        FAIL_STACK_ERROR
     if(H5Pclose(fapl) < 0)
-        FAIL_STACK_ERROR;
+        FAIL_STACK_ERROR
+    HDfree(data);
 
     PASSED()
-
     return 0;
 
 error:
-
     H5E_BEGIN_TRY {
+        H5Dclose(dset_id);
+        H5Sclose(mem_space);
+        H5Sclose(file_space);
+        H5Pclose(dcpl);
+        H5Pclose(fapl2);
         H5Pclose(fapl);
         H5Pclose(fcpl);
         H5Fclose(file_id);
     } H5E_END_TRY;
-
+    if(data)
+        HDfree(data);
     return 1;
-
-} /* verify_page_buffering_disabled() */
-#endif /* H5_HAVE_PARALLEL */
+} /* test_prefetch */
 
 
 /*-------------------------------------------------------------------------
@@ -2167,20 +2465,13 @@ main(void)
     if(H5CX_push() < 0) FAIL_STACK_ERROR
     api_ctx_pushed = TRUE;
 
-#ifdef H5_HAVE_PARALLEL 
-
-    HDputs("Page Buffering is disabled for parallel.");
-    nerrors += verify_page_buffering_disabled(fapl, env_h5_drvr);
-
-#else /* H5_HAVE_PARALLEL */
-
     nerrors += test_args(fapl, env_h5_drvr);
     nerrors += test_raw_data_handling(fapl, env_h5_drvr);
     nerrors += test_lru_processing(fapl, env_h5_drvr);
     nerrors += test_min_threshold(fapl, env_h5_drvr);
     nerrors += test_stats_collection(fapl, env_h5_drvr);
-
-#endif /* H5_HAVE_PARALLEL */
+    nerrors += test_write_behind(fapl, env_h5_drvr);
+    nerrors += test_prefetch(fapl, env_h5_drvr);
 
     h5_clean_files(FILENAME, fapl);
 
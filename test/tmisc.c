@@ -323,6 +323,13 @@ typedef struct
 /* and bad offset values are written to that file for testing */
 #define MISC33_FILE             "bad_offset.h5"
 
+/* Definitions for misc. test #35 */
+#define MISC35_SPACE_RANK       3
+#define MISC35_SPACE_DIM1       3
+#define MISC35_SPACE_DIM2       15
+#define MISC35_SPACE_DIM3       13
+#define MISC35_NSPACES          64
+
 /****************************************************************
 **
 **  test_misc1(): test unlinking a dataset from a group and immediately
@@ -5585,6 +5592,76 @@ test_misc34(void)
 } /* end test_misc34() */
 
 
+/****************************************************************
+**
+**  test_misc35(): Check operation of free-list routines
+**
+****************************************************************/
+static void
+test_misc35(void)
+{
+    hid_t sid = H5I_INVALID_HID;        /* Dataspace ID */
+    hsize_t dims[] = {MISC35_SPACE_DIM1, MISC35_SPACE_DIM2, MISC35_SPACE_DIM3};  /* Dataspace dims */
+    size_t reg_size_start;              /* Initial amount of regular memory allocated */
+    size_t arr_size_start;              /* Initial amount of array memory allocated */
+    size_t blk_size_start;              /* Initial amount of block memory allocated */
+    size_t fac_size_start;              /* Initial amount of factory memory allocated */
+    size_t reg_size_final;              /* Final amount of regular memory allocated */
+    size_t arr_size_final;              /* Final amount of array memory allocated */
+    size_t blk_size_final;              /* Final amount of block memory allocated */
+    size_t fac_size_final;              /* Final amount of factory memory allocated */
+    int u;                              /* Local index variable */
+    herr_t ret;                         /* Return value */
+
+    /* Output message about test being performed */
+    MESSAGE(5, ("Free-list API calls"));
+
+    /* Create and close dataspaces, to put some blocks on the free lists */
+    for(u = 0; u < MISC35_NSPACES; u++) {
+        sid = H5Screate_simple(MISC35_SPACE_RANK, dims, NULL);
+        CHECK(sid, H5I_INVALID_HID, "H5Screate_simple");
+
+        ret = H5Sclose(sid);
+        CHECK(ret, FAIL, "H5Sclose");
+    } /* end for */
+
+    /* Retrieve the free list sizes */
+    ret = H5get_free_list_sizes(&reg_size_start, &arr_size_start, &blk_size_start, &fac_size_start);
+    CHECK(ret, FAIL, "H5get_free_list_sizes");
+
+#if !defined H5_NO_FREE_LISTS && !defined H5_USING_MEMCHECKER
+    /* All the free list values should be >0, except the factories' */
+    CHECK(reg_size_start, 0, "H5get_free_list_sizes");
+    CHECK(arr_size_start, 0, "H5get_free_list_sizes");
+#else /* !defined H5_NO_FREE_LISTS && !defined H5_USING_MEMCHECKER */
+    /* All the values should be == 0 */
+    VERIFY(reg_size_start, 0, "H5get_free_list_sizes");
+    VERIFY(arr_size_start, 0, "H5get_free_list_sizes");
+    VERIFY(blk_size_start, 0, "H5get_free_list_sizes");
+    VERIFY(fac_size_start, 0, "H5get_free_list_sizes");
+#endif /* !defined H5_NO_FREE_LISTS && !defined H5_USING_MEMCHECKER */
+
+    /* Garbage collect the free lists */
+    ret = H5garbage_collect();
+    CHECK(ret, FAIL, "H5garbage_collect");
+
+    /* Retrieve the free list sizes again; the calling thread's cache and
+     * all the free lists should be empty now */
+    ret = H5get_free_list_sizes(&reg_size_final, &arr_size_final, &blk_size_final, &fac_size_final);
+    CHECK(ret, FAIL, "H5get_free_list_sizes");
+
+    /* All the free list values should be <= previous values */
+    if(reg_size_final > reg_size_start)
+        ERROR("reg_size_final > reg_size_start");
+    if(arr_size_final > arr_size_start)
+        ERROR("arr_size_final > arr_size_start");
+    if(blk_size_final > blk_size_start)
+        ERROR("blk_size_final > blk_size_start");
+    if(fac_size_final > fac_size_start)
+        ERROR("fac_size_final > fac_size_start");
+} /* end test_misc35() */
+
+
 /****************************************************************
 **
 **  test_misc(): Main misc. test routine.
@@ -5634,6 +5711,7 @@ test_misc(void)
     test_misc32();      /* Test filter memory allocation functions */
     test_misc33();      /* Test to verify that H5HL_offset_into() returns error if offset exceeds heap block */
     test_misc34();      /* Test behavior of 0 and NULL in H5MM API calls */
+    test_misc35();      /* Test behavior of free-list API calls */
 
 } /* test_misc() */
 
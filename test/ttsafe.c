@@ -111,6 +111,12 @@ int main(int argc, char *argv[])
     AddTest("cancel", tts_cancel, cleanup_cancel, "thread cancellation safety test", NULL);
 #endif /* H5_HAVE_PTHREAD_H */
     AddTest("acreate", tts_acreate, cleanup_acreate, "multi-attribute creation", NULL);
+    AddTest("async", tts_async, cleanup_async, "asynchronous dataset I/O in event sets", NULL);
+#ifdef H5TP_HAVE_THREADS
+    AddTest("async_insert", tts_async_insert, cleanup_async, "asynchronous operations run in the background", NULL);
+#endif /* H5TP_HAVE_THREADS */
+    AddTest("rdconcur", tts_rdconcur, cleanup_rdconcur, "concurrent chunked reads from read-only files", NULL);
+    AddTest("id_lookup", tts_id_lookup, NULL, "ID lookups without the library lock", NULL);
 
 #else /* H5_HAVE_THREADSAFE */
 
@@ -23,6 +23,8 @@
  * so we include the private headers here.
  */
 #include "testhdf5.h"
+#include "H5Iprivate.h"
+#include "H5TPprivate.h"
 
 
 /* Prototypes for the support routines */
@@ -35,12 +37,20 @@ void                    tts_dcreate(void);
 void                    tts_error(void);
 void                    tts_cancel(void);
 void                    tts_acreate(void);
+void                    tts_async(void);
+#ifdef H5TP_HAVE_THREADS
+void                    tts_async_insert(void);
+#endif /* H5TP_HAVE_THREADS */
+void                    tts_rdconcur(void);
+void                    tts_id_lookup(void);
 
 /* Prototypes for the cleanup routines */
 void                    cleanup_dcreate(void);
 void                    cleanup_error(void);
 void                    cleanup_cancel(void);
 void                    cleanup_acreate(void);
+void                    cleanup_async(void);
+void                    cleanup_rdconcur(void);
 
 #endif /* H5_HAVE_THREADSAFE */
 #endif /* TTSAFE_H */
@@ -0,0 +1,299 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/********************************************************************
+ *
+ * Testing for thread safety of event sets and asynchronous dataset
+ * I/O. -- Threaded program --
+ * ------------------------------------------------------------------
+ *
+ * Plan: Have several threads each insert a series of overlapping
+ *       asynchronous writes to their own dataset, followed by an
+ *       asynchronous read, in their own event set, while the other
+ *       threads do the same.
+ *
+ * Claim: Each thread's read sees the last write covering each element,
+ *        since operations are performed in the order they're inserted,
+ *        and waiting on an event set in one thread doesn't block the
+ *        background thread performing another thread's operations.
+ *
+ * Plan: Insert an asynchronous write whose datatype conversion blocks
+ *       until the inserting thread releases it.
+ *
+ * Claim: The insert returns, and the write starts on the background
+ *        thread, before it's released.
+ *
+ ********************************************************************/
+
+#include "ttsafe.h"
+
+#ifdef H5_HAVE_THREADSAFE
+
+#define FILENAME	"ttsafe_async.h5"
+#define NUM_THREADS	8
+#define NUM_WRITES	8
+#define DIM		256
+
+void *tts_async_thread(void *);
+
+typedef struct async_data_struct {
+    hid_t file;
+    int index;
+} ttsafe_async_data_t;
+
+void
+tts_async(void)
+{
+    H5TS_thread_t threads[NUM_THREADS];
+    ttsafe_async_data_t thread_data[NUM_THREADS];
+    hid_t   file = H5I_INVALID_HID;
+    herr_t  status;
+    int     i;
+
+    file = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK(file, H5I_INVALID_HID, "H5Fcreate");
+
+    for(i = 0; i < NUM_THREADS; i++) {
+        thread_data[i].file = file;
+        thread_data[i].index = i;
+        threads[i] = H5TS_create_thread(tts_async_thread, NULL, &thread_data[i]);
+    }
+
+    for(i = 0; i < NUM_THREADS; i++)
+        H5TS_wait_for_thread(threads[i]);
+
+    status = H5Fclose(file);
+    CHECK(status, FAIL, "H5Fclose");
+} /* end tts_async() */
+
+void *
+tts_async_thread(void *client_data)
+{
+    ttsafe_async_data_t *thread_data = (ttsafe_async_data_t *)client_data;
+    hid_t   es_id = H5I_INVALID_HID;
+    hid_t   dataset = H5I_INVALID_HID;
+    hid_t   dataspace = H5I_INVALID_HID;
+    hid_t   memspace = H5I_INVALID_HID;
+    hsize_t dim = DIM, start = 0, count;
+    int     wdata[NUM_WRITES][DIM];
+    int     rdata[DIM];
+    size_t  num_failed = 0;
+    char    name[32];
+    herr_t  status;
+    int     i, j;
+
+    es_id = H5EScreate();
+    CHECK(es_id, H5I_INVALID_HID, "H5EScreate");
+    dataspace = H5Screate_simple(1, &dim, NULL);
+    CHECK(dataspace, H5I_INVALID_HID, "H5Screate_simple");
+    HDsnprintf(name, sizeof(name), "dset%d", thread_data->index);
+    dataset = H5Dcreate2(thread_data->file, name, H5T_NATIVE_INT, dataspace,
+                         H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK(dataset, H5I_INVALID_HID, "H5Dcreate2");
+
+    /* Each write covers a shorter prefix of the dataset than the last */
+    for(i = 0; i < NUM_WRITES; i++) {
+        for(j = 0; j < DIM; j++)
+            wdata[i][j] = (thread_data->index * NUM_WRITES + i) * DIM + j;
+        count = (hsize_t)(DIM - i * (DIM / NUM_WRITES));
+        memspace = H5Screate_simple(1, &count, NULL);
+        CHECK(memspace, H5I_INVALID_HID, "H5Screate_simple");
+        status = H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+        CHECK(status, FAIL, "H5Sselect_hyperslab");
+        status = H5Dwrite_async(dataset, H5T_NATIVE_INT, memspace, dataspace, H5P_DEFAULT, wdata[i], es_id);
+        CHECK(status, FAIL, "H5Dwrite_async");
+        status = H5Sclose(memspace);
+        CHECK(status, FAIL, "H5Sclose");
+    }
+    status = H5Dread_async(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata, es_id);
+    CHECK(status, FAIL, "H5Dread_async");
+    status = H5Dclose(dataset);
+    CHECK(status, FAIL, "H5Dclose");
+
+    status = H5ESwait(es_id, &num_failed);
+    CHECK(status, FAIL, "H5ESwait");
+    VERIFY(num_failed, 0, "H5ESwait");
+
+    for(j = 0; j < DIM; j++) {
+        i = MIN(NUM_WRITES - 1, (DIM - 1 - j) / (DIM / NUM_WRITES));
+        if(rdata[j] != wdata[i][j]) {
+            TestErrPrintf("thread %d: element %d is %d, expected %d\n",
+                          thread_data->index, j, rdata[j], wdata[i][j]);
+            break;
+        }
+    }
+
+    status = H5Sclose(dataspace);
+    CHECK(status, FAIL, "H5Sclose");
+    status = H5ESclose(es_id);
+    CHECK(status, FAIL, "H5ESclose");
+    return NULL;
+} /* end tts_async_thread() */
+
+#ifdef H5TP_HAVE_THREADS
+
+#define BLOCK_NAME      "tts_async_block"
+#define BLOCK_TIMEOUT   10      /* Seconds to wait before giving up */
+
+/* Conversion which blocks until the test releases it */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    hbool_t started;            /* Whether the conversion has started */
+    hbool_t released;           /* Whether the test has released it */
+    hbool_t timed_out;          /* Whether it gave up waiting */
+    hbool_t converted;          /* Whether the conversion has finished */
+} ttsafe_async_block_t;
+
+static ttsafe_async_block_t block_g = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, FALSE, FALSE, FALSE, FALSE};
+
+/* Wait on the block's condition until *FLAG is set, or the timeout passes.
+ * The block's mutex must be held.  Returns whether *FLAG was set. */
+static hbool_t
+tts_async_block_wait(const hbool_t *flag)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += BLOCK_TIMEOUT;
+    while(!*flag)
+        if(pthread_cond_timedwait(&block_g.cond, &block_g.mutex, &deadline))
+            break;
+
+    return *flag;
+}
+
+/* Byte-swaps 4-byte integers, once released by the test */
+static herr_t
+tts_async_block_conv(hid_t src_id, hid_t dst_id, H5T_cdata_t *cdata, size_t nelmts,
+    size_t buf_stride, size_t H5_ATTR_UNUSED bkg_stride, void *buf,
+    void H5_ATTR_UNUSED *bkg, hid_t H5_ATTR_UNUSED dxpl)
+{
+    unsigned char *p, tmp;
+    size_t u;
+
+    switch(cdata->command) {
+        case H5T_CONV_INIT:
+            if(4 != H5Tget_size(src_id) || 4 != H5Tget_size(dst_id))
+                return FAIL;
+            cdata->need_bkg = H5T_BKG_NO;
+            break;
+
+        case H5T_CONV_CONV:
+            pthread_mutex_lock(&block_g.mutex);
+            block_g.started = TRUE;
+            pthread_cond_broadcast(&block_g.cond);
+            if(!tts_async_block_wait(&block_g.released))
+                block_g.timed_out = TRUE;
+            pthread_mutex_unlock(&block_g.mutex);
+
+            for(u = 0, p = (unsigned char *)buf; u < nelmts; u++, p += (buf_stride ? buf_stride : 4)) {
+                tmp = p[0]; p[0] = p[3]; p[3] = tmp;
+                tmp = p[1]; p[1] = p[2]; p[2] = tmp;
+            }
+
+            pthread_mutex_lock(&block_g.mutex);
+            block_g.converted = TRUE;
+            pthread_mutex_unlock(&block_g.mutex);
+            break;
+
+        case H5T_CONV_FREE:
+            break;
+
+        default:
+            return FAIL;
+    }
+
+    return SUCCEED;
+}
+
+void
+tts_async_insert(void)
+{
+    hid_t   file = H5I_INVALID_HID;
+    hid_t   es_id = H5I_INVALID_HID;
+    hid_t   dataset = H5I_INVALID_HID;
+    hid_t   dataspace = H5I_INVALID_HID;
+    hid_t   ftype;
+    hsize_t dim = DIM;
+    int     wdata[DIM], rdata[DIM];
+    size_t  num_failed = 0;
+    hbool_t started, converted;
+    herr_t  status;
+    int     i;
+
+    /* Store the data with the other byte order, so the write converts it */
+    ftype = H5Tequal(H5T_NATIVE_INT, H5T_STD_I32LE) > 0 ? H5T_STD_I32BE : H5T_STD_I32LE;
+    status = H5Tregister(H5T_PERS_HARD, BLOCK_NAME, H5T_NATIVE_INT, ftype, tts_async_block_conv);
+    CHECK(status, FAIL, "H5Tregister");
+
+    file = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK(file, H5I_INVALID_HID, "H5Fcreate");
+    dataspace = H5Screate_simple(1, &dim, NULL);
+    CHECK(dataspace, H5I_INVALID_HID, "H5Screate_simple");
+    dataset = H5Dcreate2(file, "blocked", ftype, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK(dataset, H5I_INVALID_HID, "H5Dcreate2");
+    es_id = H5EScreate();
+    CHECK(es_id, H5I_INVALID_HID, "H5EScreate");
+
+    for(i = 0; i < DIM; i++)
+        wdata[i] = i * 3;
+    status = H5Dwrite_async(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata, es_id);
+    CHECK(status, FAIL, "H5Dwrite_async");
+
+    /* The write starts on the background thread, but can't finish until
+     * it's released.  (No API calls here: the write holds the lock.) */
+    pthread_mutex_lock(&block_g.mutex);
+    started = tts_async_block_wait(&block_g.started);
+    converted = block_g.converted;
+    block_g.released = TRUE;
+    pthread_cond_broadcast(&block_g.cond);
+    pthread_mutex_unlock(&block_g.mutex);
+    VERIFY(started, TRUE, "asynchronous write started");
+    VERIFY(converted, FALSE, "asynchronous write finished before H5Dwrite_async returned");
+
+    status = H5ESwait(es_id, &num_failed);
+    CHECK(status, FAIL, "H5ESwait");
+    VERIFY(num_failed, 0, "H5ESwait");
+    VERIFY(block_g.converted, TRUE, "asynchronous write converted data");
+    VERIFY(block_g.timed_out, FALSE, "asynchronous write waited to be released");
+
+    status = H5Dread(dataset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata);
+    CHECK(status, FAIL, "H5Dread");
+    for(i = 0; i < DIM; i++)
+        if(rdata[i] != wdata[i]) {
+            TestErrPrintf("element %d is %d, expected %d\n", i, rdata[i], wdata[i]);
+            break;
+        }
+
+    status = H5ESclose(es_id);
+    CHECK(status, FAIL, "H5ESclose");
+    status = H5Dclose(dataset);
+    CHECK(status, FAIL, "H5Dclose");
+    status = H5Sclose(dataspace);
+    CHECK(status, FAIL, "H5Sclose");
+    status = H5Fclose(file);
+    CHECK(status, FAIL, "H5Fclose");
+    status = H5Tunregister(H5T_PERS_HARD, BLOCK_NAME, H5T_NATIVE_INT, ftype, tts_async_block_conv);
+    CHECK(status, FAIL, "H5Tunregister");
+} /* end tts_async_insert() */
+
+#endif /* H5TP_HAVE_THREADS */
+
+void
+cleanup_async(void)
+{
+    HDunlink(FILENAME);
+}
+
+#endif /*H5_HAVE_THREADSAFE*/
+
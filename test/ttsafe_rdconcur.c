@@ -0,0 +1,378 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/********************************************************************
+ *
+ * Testing for thread safety of chunked reads from read-only files,
+ * which read and decode chunks without the library lock.
+ * -- Threaded program --
+ * ------------------------------------------------------------------
+ *
+ * Plan: Write a file with chunked datasets, filtered, unfiltered
+ *       and with chunks too big for the chunk cache.  Reopen it
+ *       read-only and have several threads read all the datasets two
+ *       chunk rows at a time, in different orders (so that threads read
+ *       the same dataset at once, as well as different ones), while
+ *       another thread keeps opening and closing objects.
+ *
+ * Claim: Every thread reads the data written.  The time taken with 1,
+ *        2, 4 and NUM_THREADS threads is printed with verbose output,
+ *        as a rough measure of how reads scale across threads.
+ *
+ * Plan: Have several threads look an ID up, and take and drop internal
+ *       references to it, as code running without the library lock
+ *       does when it pushes and clears errors, while another thread
+ *       registers and removes enough IDs of the same type to grow its
+ *       hash table many times over.
+ *
+ * Claim: Every lookup finds the ID's object, and the ID's reference
+ *        count ends up where it started.
+ *
+ ********************************************************************/
+
+#include "ttsafe.h"
+
+#ifdef H5_HAVE_THREADSAFE
+
+#define FILENAME	"ttsafe_rdconcur.h5"
+#define NUM_THREADS	8
+#define NUM_DSETS	6
+#define NUM_PASSES	4
+#define DIM0		64
+#define DIM1		4096
+#define CHUNK0		4
+#define READ0		(2 * CHUNK0)
+
+#define NUM_IDS		(256 * 1024)
+
+void *tts_rdconcur_thread(void *);
+void *tts_rdconcur_meta_thread(void *);
+void *tts_id_lookup_thread(void *);
+
+typedef struct rdconcur_data_struct {
+    hid_t file;
+    int index;
+    int nerrors;
+} ttsafe_rdconcur_data_t;
+
+/* Set while the reader threads are running */
+static volatile int rdconcur_running_g;
+
+/* ID looked up by the ID lookup threads, and its object */
+typedef struct id_lookup_data_struct {
+    H5I_type_t type;
+    hid_t id;
+    int nerrors;
+} ttsafe_id_lookup_data_t;
+static int id_lookup_obj_g;
+
+/* Set while the ID lookup threads are running */
+static volatile int id_lookup_running_g;
+
+static int
+rdconcur_value(int dset, int row, int col)
+{
+    /* Compressible, but different in every dataset and row */
+    return (dset * DIM0 + row) * 16 + (col % 97) / 8;
+}
+
+static void
+rdconcur_create(void)
+{
+    hid_t   file, space, dcpl, dset;
+    hsize_t dims[2] = {DIM0, DIM1};
+    hsize_t chunk_dims[2] = {CHUNK0, DIM1};
+    int     *wdata;
+    herr_t  status;
+    int     d, i, j;
+
+    wdata = (int *)HDmalloc(DIM0 * DIM1 * sizeof(int));
+    CHECK_PTR(wdata, "HDmalloc");
+
+    file = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    CHECK(file, H5I_INVALID_HID, "H5Fcreate");
+    space = H5Screate_simple(2, dims, NULL);
+    CHECK(space, H5I_INVALID_HID, "H5Screate_simple");
+
+    for(d = 0; d < NUM_DSETS; d++) {
+        char name[32];
+
+        dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        CHECK(dcpl, H5I_INVALID_HID, "H5Pcreate");
+        status = H5Pset_chunk(dcpl, 2, chunk_dims);
+        CHECK(status, FAIL, "H5Pset_chunk");
+        /* Filter (and compress, if possible) every other dataset */
+        if(d % 2 == 0) {
+            status = H5Pset_shuffle(dcpl);
+            CHECK(status, FAIL, "H5Pset_shuffle");
+#ifdef H5_HAVE_FILTER_DEFLATE
+            status = H5Pset_deflate(dcpl, 6);
+            CHECK(status, FAIL, "H5Pset_deflate");
+#endif /* H5_HAVE_FILTER_DEFLATE */
+            status = H5Pset_fletcher32(dcpl);
+            CHECK(status, FAIL, "H5Pset_fletcher32");
+        }
+
+        for(i = 0; i < DIM0; i++)
+            for(j = 0; j < DIM1; j++)
+                wdata[i * DIM1 + j] = rdconcur_value(d, i, j);
+
+        HDsnprintf(name, sizeof(name), "dset%d", d);
+        dset = H5Dcreate2(file, name, H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        CHECK(dset, H5I_INVALID_HID, "H5Dcreate2");
+        status = H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata);
+        CHECK(status, FAIL, "H5Dwrite");
+        status = H5Dclose(dset);
+        CHECK(status, FAIL, "H5Dclose");
+        status = H5Pclose(dcpl);
+        CHECK(status, FAIL, "H5Pclose");
+    }
+
+    status = H5Sclose(space);
+    CHECK(status, FAIL, "H5Sclose");
+    status = H5Fclose(file);
+    CHECK(status, FAIL, "H5Fclose");
+    HDfree(wdata);
+} /* end rdconcur_create() */
+
+static double
+rdconcur_run(int nthreads)
+{
+    H5TS_thread_t threads[NUM_THREADS + 1];
+    ttsafe_rdconcur_data_t thread_data[NUM_THREADS];
+    hid_t   file;
+    double  start;
+    herr_t  status;
+    int     i;
+
+    file = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    CHECK(file, H5I_INVALID_HID, "H5Fopen");
+
+    rdconcur_running_g = 1;
+    threads[nthreads] = H5TS_create_thread(tts_rdconcur_meta_thread, NULL, &file);
+
+    start = H5_get_time();
+    for(i = 0; i < nthreads; i++) {
+        thread_data[i].file = file;
+        thread_data[i].index = i;
+        thread_data[i].nerrors = 0;
+        threads[i] = H5TS_create_thread(tts_rdconcur_thread, NULL, &thread_data[i]);
+    }
+    for(i = 0; i < nthreads; i++)
+        H5TS_wait_for_thread(threads[i]);
+    start = H5_get_time() - start;
+
+    rdconcur_running_g = 0;
+    H5TS_wait_for_thread(threads[nthreads]);
+
+    for(i = 0; i < nthreads; i++)
+        VERIFY(thread_data[i].nerrors, 0, "thread read errors");
+
+    status = H5Fclose(file);
+    CHECK(status, FAIL, "H5Fclose");
+
+    return start;
+} /* end rdconcur_run() */
+
+void
+tts_rdconcur(void)
+{
+    int nthreads;
+
+    rdconcur_create();
+
+    for(nthreads = 1; nthreads <= NUM_THREADS; nthreads *= 2) {
+        double elapsed = rdconcur_run(nthreads);
+
+        if(VERBOSE_MED)
+            HDprintf("    %d thread(s): %.3f s, %.1f MB/s\n", nthreads, elapsed,
+                (double)nthreads * NUM_PASSES * NUM_DSETS * DIM0 * DIM1 * sizeof(int)
+                    / (elapsed * 1024.0 * 1024.0));
+    }
+} /* end tts_rdconcur() */
+
+void *
+tts_rdconcur_thread(void *client_data)
+{
+    ttsafe_rdconcur_data_t *thread_data = (ttsafe_rdconcur_data_t *)client_data;
+    hid_t   dsets[NUM_DSETS];
+    hid_t   dapl, fspace, mspace;
+    hsize_t dims[2] = {DIM0, DIM1};
+    hsize_t start[2] = {0, 0}, count[2] = {READ0, DIM1};
+    int     rdata[READ0 * DIM1];
+    herr_t  status;
+    int     p, d, i, j, k;
+
+    /* Give the last (unfiltered) dataset a cache too small for its
+     * chunks, so that they're read straight into the application's buffer */
+    for(d = 0; d < NUM_DSETS; d++) {
+        char name[32];
+
+        dapl = H5Pcreate(H5P_DATASET_ACCESS);
+        CHECK(dapl, H5I_INVALID_HID, "H5Pcreate");
+        if(d == NUM_DSETS - 1) {
+            status = H5Pset_chunk_cache(dapl, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, (size_t)1024, H5D_CHUNK_CACHE_W0_DEFAULT);
+            CHECK(status, FAIL, "H5Pset_chunk_cache");
+        }
+        HDsnprintf(name, sizeof(name), "dset%d", d);
+        dsets[d] = H5Dopen2(thread_data->file, name, dapl);
+        CHECK(dsets[d], H5I_INVALID_HID, "H5Dopen2");
+        status = H5Pclose(dapl);
+        CHECK(status, FAIL, "H5Pclose");
+    }
+
+    fspace = H5Screate_simple(2, dims, NULL);
+    CHECK(fspace, H5I_INVALID_HID, "H5Screate_simple");
+    mspace = H5Screate_simple(2, count, NULL);
+    CHECK(mspace, H5I_INVALID_HID, "H5Screate_simple");
+
+    for(p = 0; p < NUM_PASSES; p++)
+        for(k = 0; k < NUM_DSETS * (DIM0 / READ0); k++) {
+            /* Start each thread at a different dataset */
+            d = (k / (DIM0 / READ0) + thread_data->index) % NUM_DSETS;
+            start[0] = (hsize_t)((k % (DIM0 / READ0)) * READ0);
+
+            status = H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+            CHECK(status, FAIL, "H5Sselect_hyperslab");
+            status = H5Dread(dsets[d], H5T_NATIVE_INT, mspace, fspace, H5P_DEFAULT, rdata);
+            CHECK(status, FAIL, "H5Dread");
+
+            for(i = 0; i < READ0; i++)
+                for(j = 0; j < DIM1; j++)
+                    if(rdata[i * DIM1 + j] != rdconcur_value(d, (int)start[0] + i, j)) {
+                        if(thread_data->nerrors++ == 0)
+                            TestErrPrintf("thread %d: dset%d[%d][%d] is %d, expected %d\n",
+                                thread_data->index, d, (int)start[0] + i, j,
+                                rdata[i * DIM1 + j], rdconcur_value(d, (int)start[0] + i, j));
+                        i = READ0;
+                        break;
+                    }
+        }
+
+    status = H5Sclose(mspace);
+    CHECK(status, FAIL, "H5Sclose");
+    status = H5Sclose(fspace);
+    CHECK(status, FAIL, "H5Sclose");
+    for(d = 0; d < NUM_DSETS; d++) {
+        status = H5Dclose(dsets[d]);
+        CHECK(status, FAIL, "H5Dclose");
+    }
+
+    return NULL;
+} /* end tts_rdconcur_thread() */
+
+void *
+tts_rdconcur_meta_thread(void *client_data)
+{
+    hid_t   file = *(hid_t *)client_data;
+    herr_t  status;
+    int     d = 0;
+
+    /* Use the library while the readers have released its lock, opening
+     * and closing the datasets being read */
+    while(rdconcur_running_g) {
+        char name[32];
+        hid_t dset, space;
+
+        HDsnprintf(name, sizeof(name), "dset%d", d);
+        dset = H5Dopen2(file, name, H5P_DEFAULT);
+        CHECK(dset, H5I_INVALID_HID, "H5Dopen2");
+        space = H5Dget_space(dset);
+        CHECK(space, H5I_INVALID_HID, "H5Dget_space");
+        VERIFY(H5Sget_simple_extent_npoints(space), (hssize_t)DIM0 * DIM1, "H5Sget_simple_extent_npoints");
+        status = H5Sclose(space);
+        CHECK(status, FAIL, "H5Sclose");
+        status = H5Dclose(dset);
+        CHECK(status, FAIL, "H5Dclose");
+        d = (d + 1) % NUM_DSETS;
+    }
+
+    return NULL;
+} /* end tts_rdconcur_meta_thread() */
+
+void
+tts_id_lookup(void)
+{
+    H5TS_thread_t threads[NUM_THREADS];
+    ttsafe_id_lookup_data_t thread_data[NUM_THREADS];
+    H5I_type_t type;
+    hid_t   id;
+    hid_t   *ids;
+    herr_t  status;
+    int     i, pass;
+
+    ids = (hid_t *)HDmalloc(NUM_IDS * sizeof(hid_t));
+    CHECK_PTR(ids, "HDmalloc");
+
+    type = H5Iregister_type((size_t)0, 0, NULL);
+    CHECK(type, H5I_BADID, "H5Iregister_type");
+    id = H5Iregister(type, &id_lookup_obj_g);
+    CHECK(id, H5I_INVALID_HID, "H5Iregister");
+
+    id_lookup_running_g = 1;
+    for(i = 0; i < NUM_THREADS; i++) {
+        thread_data[i].type = type;
+        thread_data[i].id = id;
+        thread_data[i].nerrors = 0;
+        threads[i] = H5TS_create_thread(tts_id_lookup_thread, NULL, &thread_data[i]);
+    }
+
+    /* Grow the type's hash table from its smallest size each pass, by
+     * registering IDs, then empty it again */
+    for(pass = 0; pass < 2; pass++) {
+        for(i = 0; i < NUM_IDS; i++) {
+            ids[i] = H5Iregister(type, &ids[i]);
+            CHECK(ids[i], H5I_INVALID_HID, "H5Iregister");
+        }
+        for(i = 0; i < NUM_IDS; i++) {
+            status = H5Idec_ref(ids[i]);
+            VERIFY(status, 0, "H5Idec_ref");
+        }
+    }
+
+    id_lookup_running_g = 0;
+    for(i = 0; i < NUM_THREADS; i++) {
+        H5TS_wait_for_thread(threads[i]);
+        VERIFY(thread_data[i].nerrors, 0, "thread lookup errors");
+    }
+
+    VERIFY(H5Iget_ref(id), 1, "H5Iget_ref");
+    status = H5Idestroy_type(type);
+    CHECK(status, FAIL, "H5Idestroy_type");
+    HDfree(ids);
+} /* end tts_id_lookup() */
+
+void *
+tts_id_lookup_thread(void *client_data)
+{
+    ttsafe_id_lookup_data_t *thread_data = (ttsafe_id_lookup_data_t *)client_data;
+
+    /* (Not holding the library lock, since these aren't API routines) */
+    while(id_lookup_running_g) {
+        if(H5I_object_verify(thread_data->id, thread_data->type) != &id_lookup_obj_g)
+            thread_data->nerrors++;
+        if(H5I_inc_ref(thread_data->id, FALSE) < 2)
+            thread_data->nerrors++;
+        if(H5I_dec_ref(thread_data->id) < 1)
+            thread_data->nerrors++;
+    }
+
+    return NULL;
+} /* end tts_id_lookup_thread() */
+
+void
+cleanup_rdconcur(void)
+{
+    HDunlink(FILENAME);
+}
+
+#endif /*H5_HAVE_THREADSAFE*/
@@ -20,6 +20,11 @@
 
 #include "h5test.h"
 
+#if defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H)
+#include <sys/socket.h>
+#include <netdb.h>
+#endif
+
 #define KB              1024U
 #define FAMILY_NUMBER   4
 #define FAMILY_SIZE     (1*KB)
@@ -58,11 +63,50 @@ const char *FILENAME[] = {
     "stdio_file",        /*7*/
     "windows_file",      /*8*/
     "new_multi_file_v16",/*9*/
+    "vector_io_file",    /*10*/
+    "sec2_direct_file",  /*11*/
+    "mmap_file",         /*12*/
+    "iouring_file",      /*13*/
+    "subfiling_file",    /*14*/
+    "blkcache_file",     /*15*/
+    "http_file",         /*16*/
     NULL
 };
 
 #define LOG_FILENAME "log_vfd_out.log"
 
+#define VECTOR_EOA      (8*KB)
+#define VECTOR_NREQS    7
+
+#define DIRECT_READ_SIZE    (3 * 4 * KB + 100)
+#define DIRECT_READ_NREQS   4
+
+#define MMAP_DSET_NAME  "dset"
+#define MMAP_DSET_DIM   (64 * KB)
+
+#define IOURING_DSET_NAME   "dset"
+#define IOURING_DSET_DIM    (256 * KB)
+
+#define SUBFILING_NSUBFILES     3
+#define SUBFILING_STRIPE_SIZE   (4 * KB)
+#define SUBFILING_NTHREADS      4
+#define SUBFILING_DSET_NAME     "dset"
+#define SUBFILING_DSET_DIM      (40 * KB)
+
+#define BLKCACHE_DIR            "blkcache_dir"
+#define BLKCACHE_BLOCK_SIZE     (4 * KB)
+#define BLKCACHE_META_SIZE      (64 * KB)
+#define BLKCACHE_RAW_SIZE       (256 * KB)
+#define BLKCACHE_DSET_NAME      "dset"
+#define BLKCACHE_DSET_DIM       (40 * KB)
+
+#define HTTP_BLOCK_SIZE         (4 * KB)
+#define HTTP_CACHE_SIZE         (256 * KB)
+#define HTTP_MAX_GAP            (16 * KB)
+#define HTTP_NCONNS             4
+#define HTTP_DSET_NAME          "dset"
+#define HTTP_DSET_DIM           (40 * KB)
+
 #define COMPAT_BASENAME "family_v16_"
 #define MULTI_COMPAT_BASENAME "multi_file_v16"
 
@@ -179,6 +223,138 @@ error:
 } /* end test_sec2() */
 
 
+/*-------------------------------------------------------------------------
+ * Function:    test_sec2_direct_read
+ *
+ * Purpose:     Tests reading a file opened read-only by the SEC2 driver
+ *              with O_DIRECT, using unaligned reads, reads past the end
+ *              of the file and a vector read.  Where O_DIRECT isn't
+ *              supported, the file is read normally and this checks the
+ *              same results.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_sec2_direct_read(void)
+{
+    char        filename[1024];
+    hid_t       fapl_id = -1;                           /* file access property list ID */
+    H5FD_t      *file = NULL;                           /* VFD file struct */
+    unsigned char *wbuf = NULL;                         /* Data written */
+    unsigned char *rbuf = NULL;                         /* Data read back */
+    H5FD_mem_t  types[DIRECT_READ_NREQS];               /* Request memory types */
+    haddr_t     addrs[DIRECT_READ_NREQS] = {4095, 1, 9000, DIRECT_READ_SIZE - 50};
+    size_t      sizes[DIRECT_READ_NREQS] = {2, 5000, 100, 300};
+    void        *rbufs[DIRECT_READ_NREQS];              /* Read buffers */
+    hbool_t     direct_read = TRUE;                     /* Property value */
+    size_t      off;                                    /* Offset in buffer */
+    unsigned    u;                                      /* Local index variable */
+
+    TESTING("SEC2 file driver direct reads");
+
+    if(NULL == (wbuf = (unsigned char *)HDmalloc(DIRECT_READ_SIZE)))
+        TEST_ERROR
+    if(NULL == (rbuf = (unsigned char *)HDmalloc(2 * DIRECT_READ_SIZE)))
+        TEST_ERROR
+    for(u = 0; u < DIRECT_READ_SIZE; u++)
+        wbuf[u] = (unsigned char)(u * 3 + 5);
+
+    /* The property is off for a plain SEC2 list */
+    if((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if(H5Pset_fapl_sec2(fapl_id) < 0)
+        TEST_ERROR
+    if(H5Pget_fapl_sec2_direct_read(fapl_id, &direct_read) < 0)
+        TEST_ERROR
+    if(direct_read)
+        TEST_ERROR
+    h5_fixname(FILENAME[11], fapl_id, filename, sizeof(filename));
+
+    /* Write the file normally */
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, (haddr_t)DIRECT_READ_SIZE) < 0)
+        TEST_ERROR
+    if(H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, (size_t)DIRECT_READ_SIZE, wbuf) < 0)
+        TEST_ERROR
+    if(H5FDclose(file) < 0)
+        TEST_ERROR
+    file = NULL;
+
+    /* Reopen it read-only for direct reads */
+    if(H5Pset_fapl_sec2_direct_read(fapl_id, TRUE) < 0)
+        TEST_ERROR
+    if(H5Pget_fapl_sec2_direct_read(fapl_id, &direct_read) < 0)
+        TEST_ERROR
+    if(!direct_read)
+        TEST_ERROR
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDONLY, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, (haddr_t)(2 * DIRECT_READ_SIZE)) < 0)
+        TEST_ERROR
+
+    /* Unaligned single reads, the last running past the end of the file */
+    for(u = 0; u < DIRECT_READ_NREQS; u++) {
+        HDmemset(rbuf, 0xff, sizes[u]);
+        if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, addrs[u], sizes[u], rbuf) < 0)
+            TEST_ERROR
+        for(off = 0; off < sizes[u]; off++)
+            if(rbuf[off] != (addrs[u] + off < DIRECT_READ_SIZE ? wbuf[addrs[u] + off] : 0))
+                FAIL_PUTS_ERROR("data read doesn't match data written")
+    } /* end for */
+
+    /* The whole file and more, in one read */
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, (size_t)(2 * DIRECT_READ_SIZE), rbuf) < 0)
+        TEST_ERROR
+    if(HDmemcmp(rbuf, wbuf, DIRECT_READ_SIZE))
+        FAIL_PUTS_ERROR("data read doesn't match data written")
+    for(off = DIRECT_READ_SIZE; off < 2 * DIRECT_READ_SIZE; off++)
+        if(rbuf[off])
+            FAIL_PUTS_ERROR("data read past the end of the file isn't zero")
+
+    /* The same requests as a vector read */
+    HDmemset(rbuf, 0xff, 2 * DIRECT_READ_SIZE);
+    for(u = 0, off = 0; u < DIRECT_READ_NREQS; u++) {
+        types[u] = H5FD_MEM_DRAW;
+        rbufs[u] = rbuf + off;
+        off += sizes[u];
+    } /* end for */
+    if(H5FDread_vector(file, H5P_DEFAULT, (size_t)DIRECT_READ_NREQS, types, addrs, sizes, rbufs) < 0)
+        TEST_ERROR
+    for(u = 0; u < DIRECT_READ_NREQS; u++)
+        for(off = 0; off < sizes[u]; off++)
+            if(((unsigned char *)rbufs[u])[off] != (addrs[u] + off < DIRECT_READ_SIZE ? wbuf[addrs[u] + off] : 0))
+                FAIL_PUTS_ERROR("vector data read doesn't match data written")
+
+    if(H5FDclose(file) < 0)
+        TEST_ERROR
+    file = NULL;
+    h5_delete_test_file(FILENAME[11], fapl_id);
+
+    if(H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+
+    HDfree(wbuf);
+    HDfree(rbuf);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl_id);
+    } H5E_END_TRY;
+    HDfree(wbuf);
+    HDfree(rbuf);
+    return -1;
+} /* end test_sec2_direct_read() */
+
+
 /*-------------------------------------------------------------------------
  * Function:    test_core
  *
@@ -1767,6 +1943,190 @@ error:
 
 
 
+/*-------------------------------------------------------------------------
+ * Function:    test_mmap
+ *
+ * Purpose:     Tests the file handle interface for the read-only MMAP
+ *              driver, reading a file written with the SEC2 driver.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_mmap(void)
+{
+#ifdef H5_HAVE_MMAP
+    hid_t       fid = -1;                   /* file ID                      */
+    hid_t       fapl_id = -1;               /* file access property list ID */
+    hid_t       fapl_id_out = -1;           /* from H5Fget_access_plist     */
+    hid_t       dset_id = -1;               /* dataset ID                   */
+    hid_t       space_id = -1;              /* dataspace ID                 */
+    hid_t       driver_id = -1;             /* ID for this VFD              */
+    unsigned long driver_flags = 0;         /* VFD feature flags            */
+    H5FD_t      *file = NULL;               /* VFD file struct              */
+    char        filename[1024];             /* filename                     */
+    void        *os_file_handle = NULL;     /* OS file handle               */
+    hsize_t     dims[1] = {MMAP_DSET_DIM};  /* dataset dimensions           */
+    hsize_t     file_size;                  /* file size                    */
+    int         *wdata = NULL;              /* data written                 */
+    int         *rdata = NULL;              /* data read back               */
+    unsigned char tail[64];                 /* bytes around the end of file */
+    unsigned char check[64];                /* same bytes read with SEC2    */
+    unsigned    u;                          /* local index variable         */
+#endif /* H5_HAVE_MMAP */
+
+    TESTING("MMAP file driver");
+
+#ifndef H5_HAVE_MMAP
+    SKIPPED();
+    return 0;
+#else /* H5_HAVE_MMAP */
+
+    if(NULL == (wdata = (int *)HDmalloc(MMAP_DSET_DIM * sizeof(int))))
+        TEST_ERROR;
+    if(NULL == (rdata = (int *)HDcalloc(MMAP_DSET_DIM, sizeof(int))))
+        TEST_ERROR;
+    for(u = 0; u < MMAP_DSET_DIM; u++)
+        wdata[u] = (int)(u * 3);
+
+    /* Write a file with the SEC2 driver */
+    if((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_sec2(fapl_id) < 0)
+        TEST_ERROR;
+    h5_fixname(FILENAME[12], fapl_id, filename, sizeof(filename));
+
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0)
+        TEST_ERROR;
+    if((space_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dcreate2(fid, MMAP_DSET_NAME, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata) < 0)
+        TEST_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Sclose(space_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Switch to the MMAP driver */
+    if(H5Pset_fapl_mmap(fapl_id) < 0)
+        TEST_ERROR;
+
+    /* Check that the VFD feature flags are correct */
+    if ((driver_id = H5Pget_driver(fapl_id)) < 0)
+        TEST_ERROR
+    if (H5FDdriver_query(driver_id, &driver_flags) < 0)
+        TEST_ERROR
+    if(driver_flags != (H5FD_FEAT_POSIX_COMPAT_HANDLE
+                        | H5FD_FEAT_DEFAULT_VFD_COMPATIBLE
+                        | H5FD_FEAT_CONCURRENT_READ))
+        TEST_ERROR
+
+    /* Files can't be created or opened for writing */
+    H5E_BEGIN_TRY {
+        fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    } H5E_END_TRY;
+    if(fid >= 0)
+        FAIL_PUTS_ERROR("file created with the read-only MMAP driver");
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(filename, H5F_ACC_RDWR, fapl_id);
+    } H5E_END_TRY;
+    if(fid >= 0)
+        FAIL_PUTS_ERROR("file opened for writing with the read-only MMAP driver");
+
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+
+    /* Retrieve the access property list and check the driver */
+    if((fapl_id_out = H5Fget_access_plist(fid)) < 0)
+        TEST_ERROR;
+    if(H5FD_MMAP != H5Pget_driver(fapl_id_out))
+        TEST_ERROR;
+    if(H5Pclose(fapl_id_out) < 0)
+        TEST_ERROR;
+
+    /* Check that we can get an operating-system-specific handle from
+     * the library.
+     */
+    if(H5Fget_vfd_handle(fid, H5P_DEFAULT, &os_file_handle) < 0)
+        TEST_ERROR;
+    if(os_file_handle == NULL)
+        FAIL_PUTS_ERROR("NULL os-specific vfd/file handle was returned from H5Fget_vfd_handle");
+
+    /* Read the data back */
+    if((dset_id = H5Dopen2(fid, MMAP_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, MMAP_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+
+    if(H5Fget_filesize(fid, &file_size) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Reads past the end of the file are filled with zeros */
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT, HADDR_UNDEF)))
+        TEST_ERROR;
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, (haddr_t)(file_size + sizeof(check))) < 0)
+        TEST_ERROR;
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)(file_size - sizeof(check) / 2), sizeof(check), check) < 0)
+        TEST_ERROR;
+    if(H5FDclose(file) < 0)
+        TEST_ERROR;
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDONLY, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR;
+    if(H5FDget_eof(file, H5FD_MEM_DEFAULT) != (haddr_t)file_size)
+        TEST_ERROR;
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, (haddr_t)(file_size + sizeof(tail))) < 0)
+        TEST_ERROR;
+    HDmemset(tail, 0xff, sizeof(tail));
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)(file_size - sizeof(tail) / 2), sizeof(tail), tail) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(tail, check, sizeof(tail)))
+        FAIL_PUTS_ERROR("data read at the end of the file doesn't match SEC2 driver");
+    for(u = sizeof(tail) / 2; u < sizeof(tail); u++)
+        if(tail[u])
+            FAIL_PUTS_ERROR("data read past the end of the file isn't zero");
+    if(H5FDclose(file) < 0)
+        TEST_ERROR;
+    file = NULL;
+
+    h5_delete_test_file(FILENAME[12], fapl_id);
+    if(H5Pclose(fapl_id) < 0)
+        TEST_ERROR;
+
+    HDfree(wdata);
+    HDfree(rdata);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl_id);
+        H5Pclose(fapl_id_out);
+        H5Dclose(dset_id);
+        H5Sclose(space_id);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    HDfree(wdata);
+    HDfree(rdata);
+    return -1;
+#endif /* H5_HAVE_MMAP */
+} /* end test_mmap() */
+
+
 /*-------------------------------------------------------------------------
  * Function:    test_windows
  *
@@ -1889,6 +2249,1530 @@ error:
 
 
 
+/*-------------------------------------------------------------------------
+ * Function:    test_vector_io_driver
+ *
+ * Purpose:     Writes and reads back a vector of requests with
+ *              H5FDwrite_vector and H5FDread_vector on a file opened with
+ *              FAPL, checking the data against a copy in memory.  The
+ *              requests include runs of adjacent requests, requests that
+ *              cross family member boundaries, an empty request, and a
+ *              read past the end of the data written.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_vector_io_driver(hid_t fapl)
+{
+    char        filename[1024];
+    H5FD_t      *file = NULL;                           /* VFD file struct */
+    unsigned char *wbuf = NULL;                         /* Data written */
+    unsigned char *rbuf = NULL;                         /* Data read back */
+    unsigned char *image = NULL;                        /* Expected file contents */
+    H5FD_mem_t  types[VECTOR_NREQS];                    /* Request memory types */
+    haddr_t     waddrs[VECTOR_NREQS] = {100, 300, 1500, 4000, 5000, 2700, 0};
+    size_t      wsizes[VECTOR_NREQS] = {200, 700, 1200, 10, 0, 300, 50};
+    haddr_t     raddrs[VECTOR_NREQS] = {2700, 1500, 7000, 0, 300, 4000, 5000};
+    size_t      rsizes[VECTOR_NREQS] = {300, 1200, 1000, 100, 700, 1000, 0};
+    const void  *wbufs[VECTOR_NREQS];                   /* Write buffers */
+    void        *rbufs[VECTOR_NREQS];                   /* Read buffers */
+    size_t      off;                                    /* Offset in buffer */
+    herr_t      ret;                                    /* Generic return value */
+    unsigned    u;                                      /* Local index variable */
+
+    h5_fixname(FILENAME[10], fapl, filename, sizeof filename);
+
+    if(NULL == (wbuf = (unsigned char *)HDmalloc(VECTOR_EOA)))
+        TEST_ERROR
+    if(NULL == (rbuf = (unsigned char *)HDmalloc(VECTOR_EOA)))
+        TEST_ERROR
+    if(NULL == (image = (unsigned char *)HDcalloc(1, VECTOR_EOA)))
+        TEST_ERROR
+    for(u = 0; u < VECTOR_EOA; u++)
+        wbuf[u] = (unsigned char)(u * 7 + 1);
+
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC, fapl, HADDR_UNDEF)))
+        TEST_ERROR
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, (haddr_t)VECTOR_EOA) < 0)
+        TEST_ERROR
+
+    /* Write the requests, each from its own part of the write buffer */
+    for(u = 0, off = 0; u < VECTOR_NREQS; u++) {
+        types[u] = H5FD_MEM_DRAW;
+        wbufs[u] = wbuf + off;
+        HDmemcpy(image + waddrs[u], wbuf + off, wsizes[u]);
+        off += wsizes[u];
+    } /* end for */
+    if(H5FDwrite_vector(file, H5P_DEFAULT, (size_t)VECTOR_NREQS, types, waddrs, wsizes, wbufs) < 0)
+        TEST_ERROR
+
+    /* Read them back in a different order */
+    HDmemset(rbuf, 0xff, VECTOR_EOA);
+    for(u = 0, off = 0; u < VECTOR_NREQS; u++) {
+        rbufs[u] = rbuf + off;
+        off += rsizes[u];
+    } /* end for */
+    if(H5FDread_vector(file, H5P_DEFAULT, (size_t)VECTOR_NREQS, types, raddrs, rsizes, rbufs) < 0)
+        TEST_ERROR
+    for(u = 0; u < VECTOR_NREQS; u++)
+        if(HDmemcmp(rbufs[u], image + raddrs[u], rsizes[u]))
+            FAIL_PUTS_ERROR("data read doesn't match data written")
+
+    /* Requests past the EOA fail */
+    raddrs[0] = VECTOR_EOA - 10;
+    H5E_BEGIN_TRY {
+        ret = H5FDread_vector(file, H5P_DEFAULT, (size_t)VECTOR_NREQS, types, raddrs, rsizes, rbufs);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        TEST_ERROR
+
+    if(H5FDclose(file) < 0)
+        TEST_ERROR
+    file = NULL;
+    h5_delete_test_file(FILENAME[10], fapl);
+
+    HDfree(wbuf);
+    HDfree(rbuf);
+    HDfree(image);
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+    } H5E_END_TRY;
+    HDfree(wbuf);
+    HDfree(rbuf);
+    HDfree(image);
+    return -1;
+} /* end test_vector_io_driver() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_vector_io
+ *
+ * Purpose:     Tests vector I/O with the drivers that implement it (sec2,
+ *              core and family) and with one that doesn't (stdio), where
+ *              the library falls back to single reads and writes.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_vector_io(void)
+{
+    hid_t       fapl = -1;              /* File access property list */
+
+    TESTING("vector I/O");
+
+    /* sec2 */
+    if((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if(H5Pset_fapl_sec2(fapl) < 0)
+        TEST_ERROR
+    if(test_vector_io_driver(fapl) < 0)
+        TEST_ERROR
+
+    /* core, without a backing store */
+    if(H5Pset_fapl_core(fapl, (size_t)CORE_INCREMENT, FALSE) < 0)
+        TEST_ERROR
+    if(test_vector_io_driver(fapl) < 0)
+        TEST_ERROR
+
+    /* family, with requests crossing member boundaries */
+    if(H5Pset_fapl_family(fapl, (hsize_t)FAMILY_SIZE, H5P_DEFAULT) < 0)
+        TEST_ERROR
+    if(test_vector_io_driver(fapl) < 0)
+        TEST_ERROR
+
+    /* stdio, which has no vector I/O callbacks */
+    if(H5Pset_fapl_stdio(fapl) < 0)
+        TEST_ERROR
+    if(test_vector_io_driver(fapl) < 0)
+        TEST_ERROR
+
+    if(H5Pclose(fapl) < 0)
+        TEST_ERROR
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Pclose(fapl);
+    } H5E_END_TRY;
+    return -1;
+} /* end test_vector_io() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_iouring
+ *
+ * Purpose:     Tests the file handle interface for the IOURING driver,
+ *              and vector I/O with it, with queue depths smaller than the
+ *              number of requests and with and without registered
+ *              buffers.  On kernels without io_uring the driver uses
+ *              pread() and pwrite() instead, and the tests still apply.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_iouring(void)
+{
+#ifdef H5_HAVE_LINUX_IO_URING_H
+    hid_t       fid = -1;                   /* file ID                      */
+    hid_t       fapl_id = -1;               /* file access property list ID */
+    hid_t       fapl_id_out = -1;           /* from H5Fget_access_plist     */
+    hid_t       dset_id = -1;               /* dataset ID                   */
+    hid_t       space_id = -1;              /* dataspace ID                 */
+    hid_t       dcpl_id = -1;               /* dataset creation plist ID    */
+    hid_t       driver_id = -1;             /* ID for this VFD              */
+    unsigned long driver_flags = 0;         /* VFD feature flags            */
+    char        filename[1024];             /* filename                     */
+    void        *os_file_handle = NULL;     /* OS file handle               */
+    hsize_t     dims[1] = {IOURING_DSET_DIM};   /* dataset dimensions       */
+    hsize_t     chunk_dims[1] = {IOURING_DSET_DIM / 64};    /* chunk dimensions */
+    unsigned    queue_depth = 0;            /* queue depth from fapl        */
+    size_t      reg_buf_size = 0;           /* registered buffers from fapl */
+    int         *wdata = NULL;              /* data written                 */
+    int         *rdata = NULL;              /* data read back               */
+    herr_t      ret;                        /* generic return value         */
+    unsigned    u;                          /* local index variable         */
+#endif /* H5_HAVE_LINUX_IO_URING_H */
+
+    TESTING("IOURING file driver");
+
+#ifndef H5_HAVE_LINUX_IO_URING_H
+    SKIPPED();
+    return 0;
+#else /* H5_HAVE_LINUX_IO_URING_H */
+
+    if(NULL == (wdata = (int *)HDmalloc(IOURING_DSET_DIM * sizeof(int))))
+        TEST_ERROR;
+    if(NULL == (rdata = (int *)HDcalloc(IOURING_DSET_DIM, sizeof(int))))
+        TEST_ERROR;
+    for(u = 0; u < IOURING_DSET_DIM; u++)
+        wdata[u] = (int)(u * 5 + 1);
+
+    /* Set property list and file name for IOURING driver */
+    if((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR;
+
+    /* The queue depth is limited */
+    H5E_BEGIN_TRY {
+        ret = H5Pset_fapl_iouring(fapl_id, H5FD_IOURING_QUEUE_DEPTH_MAX + 1, (size_t)0);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        FAIL_PUTS_ERROR("queue depth over the limit accepted");
+
+    /* Zero selects the default queue depth */
+    if(H5Pset_fapl_iouring(fapl_id, 0, (size_t)0) < 0)
+        TEST_ERROR;
+    if(H5Pget_fapl_iouring(fapl_id, &queue_depth, &reg_buf_size) < 0)
+        TEST_ERROR;
+    if(queue_depth != H5FD_IOURING_QUEUE_DEPTH_DEF || reg_buf_size != 0)
+        TEST_ERROR;
+
+    if(H5Pset_fapl_iouring(fapl_id, 8, (size_t)(64 * KB)) < 0)
+        TEST_ERROR;
+    if(H5Pget_fapl_iouring(fapl_id, &queue_depth, &reg_buf_size) < 0)
+        TEST_ERROR;
+    if(queue_depth != 8 || reg_buf_size != 64 * KB)
+        TEST_ERROR;
+    h5_fixname(FILENAME[13], fapl_id, filename, sizeof(filename));
+
+    /* Check that the VFD feature flags are correct */
+    if ((driver_id = H5Pget_driver(fapl_id)) < 0)
+        TEST_ERROR
+    if (H5FDdriver_query(driver_id, &driver_flags) < 0)
+        TEST_ERROR
+    if(!(driver_flags & H5FD_FEAT_AGGREGATE_METADATA))      TEST_ERROR
+    if(!(driver_flags & H5FD_FEAT_ACCUMULATE_METADATA))     TEST_ERROR
+    if(!(driver_flags & H5FD_FEAT_DATA_SIEVE))              TEST_ERROR
+    if(!(driver_flags & H5FD_FEAT_AGGREGATE_SMALLDATA))     TEST_ERROR
+    if(!(driver_flags & H5FD_FEAT_POSIX_COMPAT_HANDLE))     TEST_ERROR
+    if(!(driver_flags & H5FD_FEAT_DEFAULT_VFD_COMPATIBLE))  TEST_ERROR
+
+    /* Write and read back a chunked dataset */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0)
+        TEST_ERROR;
+
+    /* Retrieve the access property list and check the properties */
+    if((fapl_id_out = H5Fget_access_plist(fid)) < 0)
+        TEST_ERROR;
+    if(H5FD_IOURING != H5Pget_driver(fapl_id_out))
+        TEST_ERROR;
+    if(H5Pget_fapl_iouring(fapl_id_out, &queue_depth, &reg_buf_size) < 0)
+        TEST_ERROR;
+    if(queue_depth != 8 || reg_buf_size != 64 * KB)
+        TEST_ERROR;
+    if(H5Pclose(fapl_id_out) < 0)
+        TEST_ERROR;
+
+    /* Check that we can get an operating-system-specific handle from
+     * the library.
+     */
+    if(H5Fget_vfd_handle(fid, H5P_DEFAULT, &os_file_handle) < 0)
+        TEST_ERROR;
+    if(os_file_handle == NULL)
+        FAIL_PUTS_ERROR("NULL os-specific vfd/file handle was returned from H5Fget_vfd_handle");
+
+    if((space_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR;
+    if((dcpl_id = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        TEST_ERROR;
+    if(H5Pset_chunk(dcpl_id, 1, chunk_dims) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dcreate2(fid, IOURING_DSET_NAME, H5T_NATIVE_INT, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata) < 0)
+        TEST_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Pclose(dcpl_id) < 0)
+        TEST_ERROR;
+    if(H5Sclose(space_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, IOURING_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, IOURING_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    h5_delete_test_file(FILENAME[13], fapl_id);
+
+    /* Vector I/O with more requests than queue entries, first without
+     * registered buffers, then with slots large enough for some of the
+     * requests but not others.
+     */
+    if(H5Pset_fapl_iouring(fapl_id, 2, (size_t)0) < 0)
+        TEST_ERROR;
+    if(test_vector_io_driver(fapl_id) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_iouring(fapl_id, 4, (size_t)(4 * KB)) < 0)
+        TEST_ERROR;
+    if(test_vector_io_driver(fapl_id) < 0)
+        TEST_ERROR;
+
+    if(H5Pclose(fapl_id) < 0)
+        TEST_ERROR;
+
+    HDfree(wdata);
+    HDfree(rdata);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Pclose(fapl_id);
+        H5Pclose(fapl_id_out);
+        H5Pclose(dcpl_id);
+        H5Dclose(dset_id);
+        H5Sclose(space_id);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    HDfree(wdata);
+    HDfree(rdata);
+    return -1;
+#endif /* H5_HAVE_LINUX_IO_URING_H */
+} /* end test_iouring() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_subfiling
+ *
+ * Purpose:     Tests the file handle interface for the SUBFILING driver:
+ *              that the file's layout is recorded when it's created and
+ *              used when it's opened again, that the stripes are in the
+ *              right places in the subfiles, and vector I/O with and
+ *              without worker threads.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_subfiling(void)
+{
+    hid_t       fid = -1;                   /* file ID                      */
+    hid_t       fapl_id = -1;               /* file access property list ID */
+    hid_t       fapl_id_out = -1;           /* from H5Fget_access_plist     */
+    hid_t       dset_id = -1;               /* dataset ID                   */
+    hid_t       space_id = -1;              /* dataspace ID                 */
+    hid_t       driver_id = -1;             /* ID for this VFD              */
+    unsigned long driver_flags = 0;         /* VFD feature flags            */
+    H5FD_t      *file = NULL;               /* VFD file struct              */
+    char        filename[1024];             /* filename                     */
+    char        sub_filename[1100];         /* subfile name                 */
+    void        *os_file_handle = NULL;     /* OS file handle               */
+    hsize_t     dims[1] = {SUBFILING_DSET_DIM}; /* dataset dimensions       */
+    unsigned    nsubfiles = 0;              /* # of subfiles from fapl      */
+    hsize_t     stripe_size = 0;            /* stripe size from fapl        */
+    unsigned    nthreads = 0;               /* # of threads from fapl       */
+    haddr_t     eof;                        /* end of file                  */
+    int         *wdata = NULL;              /* data written                 */
+    int         *rdata = NULL;              /* data read back               */
+    unsigned char *image = NULL;            /* address space contents       */
+    unsigned char *stripe = NULL;           /* stripe read from a subfile   */
+    herr_t      ret;                        /* generic return value         */
+    int         sub_fd = -1;                /* subfile descriptor           */
+    h5_posix_io_ret_t nread;                /* bytes read from a subfile    */
+    unsigned    u;                          /* local index variable         */
+
+    TESTING("SUBFILING file driver");
+
+    if(NULL == (wdata = (int *)HDmalloc(SUBFILING_DSET_DIM * sizeof(int))))
+        TEST_ERROR;
+    if(NULL == (rdata = (int *)HDcalloc(SUBFILING_DSET_DIM, sizeof(int))))
+        TEST_ERROR;
+    if(NULL == (stripe = (unsigned char *)HDmalloc(SUBFILING_STRIPE_SIZE)))
+        TEST_ERROR;
+    for(u = 0; u < SUBFILING_DSET_DIM; u++)
+        wdata[u] = (int)(u * 7 + 3);
+
+    /* Set property list and file name for SUBFILING driver */
+    if((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR;
+    H5E_BEGIN_TRY {
+        ret = H5Pset_fapl_subfiling(fapl_id, H5FD_SUBFILING_MAX_SUBFILES + 1, (hsize_t)0, 0);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        FAIL_PUTS_ERROR("too many subfiles accepted");
+    if(H5Pset_fapl_subfiling(fapl_id, 0, (hsize_t)0, 0) < 0)
+        TEST_ERROR;
+    if(H5Pget_fapl_subfiling(fapl_id, &nsubfiles, &stripe_size, &nthreads) < 0)
+        TEST_ERROR;
+    if(nsubfiles != H5FD_SUBFILING_NSUBFILES_DEF || stripe_size != H5FD_SUBFILING_STRIPE_SIZE_DEF || nthreads != 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_subfiling(fapl_id, SUBFILING_NSUBFILES, (hsize_t)SUBFILING_STRIPE_SIZE, SUBFILING_NTHREADS) < 0)
+        TEST_ERROR;
+    h5_fixname(FILENAME[14], fapl_id, filename, sizeof(filename));
+
+    /* Check that the VFD feature flags are correct */
+    if ((driver_id = H5Pget_driver(fapl_id)) < 0)
+        TEST_ERROR
+    if (H5FDdriver_query(driver_id, &driver_flags) < 0)
+        TEST_ERROR
+    if(driver_flags != (H5FD_FEAT_AGGREGATE_METADATA
+                        | H5FD_FEAT_ACCUMULATE_METADATA
+                        | H5FD_FEAT_DATA_SIEVE
+                        | H5FD_FEAT_AGGREGATE_SMALLDATA))
+        TEST_ERROR
+
+    /* Write a dataset spanning many stripes */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0)
+        TEST_ERROR;
+    if(H5Fget_vfd_handle(fid, H5P_DEFAULT, &os_file_handle) < 0)
+        TEST_ERROR;
+    if(os_file_handle == NULL)
+        FAIL_PUTS_ERROR("NULL os-specific vfd/file handle was returned from H5Fget_vfd_handle");
+    if((space_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dcreate2(fid, SUBFILING_DSET_NAME, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata) < 0)
+        TEST_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Sclose(space_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Reopen with a different layout in the properties, and no threads:
+     * the layout the file was created with is used.
+     */
+    if(H5Pset_fapl_subfiling(fapl_id, SUBFILING_NSUBFILES + 2, (hsize_t)(SUBFILING_STRIPE_SIZE * 2), 0) < 0)
+        TEST_ERROR;
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((fapl_id_out = H5Fget_access_plist(fid)) < 0)
+        TEST_ERROR;
+    if(H5FD_SUBFILING != H5Pget_driver(fapl_id_out))
+        TEST_ERROR;
+    if(H5Pget_fapl_subfiling(fapl_id_out, &nsubfiles, &stripe_size, &nthreads) < 0)
+        TEST_ERROR;
+    if(nsubfiles != SUBFILING_NSUBFILES || stripe_size != SUBFILING_STRIPE_SIZE || nthreads != 0)
+        TEST_ERROR;
+    if(H5Pclose(fapl_id_out) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, SUBFILING_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, SUBFILING_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Check that each stripe is where it belongs in the subfiles */
+    if(NULL == (file = H5FDopen(filename, H5F_ACC_RDONLY, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR;
+    eof = H5FDget_eof(file, H5FD_MEM_DEFAULT);
+    if(eof < SUBFILING_DSET_DIM * sizeof(int))
+        TEST_ERROR;
+    if(NULL == (image = (unsigned char *)HDmalloc((size_t)eof)))
+        TEST_ERROR;
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, eof) < 0)
+        TEST_ERROR;
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, (size_t)eof, image) < 0)
+        TEST_ERROR;
+    if(H5FDclose(file) < 0)
+        TEST_ERROR;
+    file = NULL;
+    for(u = 0; (haddr_t)u * SUBFILING_STRIPE_SIZE < eof; u++) {
+        size_t len = (size_t)MIN(SUBFILING_STRIPE_SIZE, eof - (haddr_t)u * SUBFILING_STRIPE_SIZE);
+
+        HDsnprintf(sub_filename, sizeof(sub_filename), H5FD_SUBFILING_NAME_FORMAT, filename, u % SUBFILING_NSUBFILES);
+        if((sub_fd = HDopen(sub_filename, O_RDONLY)) < 0)
+            TEST_ERROR;
+        if(HDlseek(sub_fd, (HDoff_t)((u / SUBFILING_NSUBFILES) * SUBFILING_STRIPE_SIZE), SEEK_SET) < 0)
+            TEST_ERROR;
+        if((nread = HDread(sub_fd, stripe, len)) < 0 || (size_t)nread != len)
+            TEST_ERROR;
+        if(HDclose(sub_fd) < 0)
+            TEST_ERROR;
+        sub_fd = -1;
+        if(HDmemcmp(stripe, image + (size_t)u * SUBFILING_STRIPE_SIZE, len))
+            FAIL_PUTS_ERROR("stripe not in the right place in its subfile");
+    } /* end for */
+
+    h5_delete_test_file(FILENAME[14], fapl_id);
+
+    /* Vector I/O crossing stripes, with small stripes, with and without
+     * worker threads
+     */
+    if(H5Pset_fapl_subfiling(fapl_id, SUBFILING_NSUBFILES, (hsize_t)1000, SUBFILING_NTHREADS) < 0)
+        TEST_ERROR;
+    if(test_vector_io_driver(fapl_id) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_subfiling(fapl_id, SUBFILING_NSUBFILES, (hsize_t)1000, 0) < 0)
+        TEST_ERROR;
+    if(test_vector_io_driver(fapl_id) < 0)
+        TEST_ERROR;
+
+    if(H5Pclose(fapl_id) < 0)
+        TEST_ERROR;
+
+    HDfree(wdata);
+    HDfree(rdata);
+    HDfree(image);
+    HDfree(stripe);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl_id);
+        H5Pclose(fapl_id_out);
+        H5Dclose(dset_id);
+        H5Sclose(space_id);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(sub_fd >= 0)
+        HDclose(sub_fd);
+    HDfree(wdata);
+    HDfree(rdata);
+    HDfree(image);
+    HDfree(stripe);
+    return -1;
+} /* end test_subfiling() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    blkcache_clear_dir
+ *
+ * Purpose:     Removes the files in the block cache directory.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+blkcache_clear_dir(void)
+{
+    DIR         *dir;                       /* cache directory              */
+    struct dirent *ent;                     /* directory entry              */
+    char        path[1024];                 /* cache file name              */
+
+    if(NULL == (dir = HDopendir(BLKCACHE_DIR)))
+        return -1;
+    while(NULL != (ent = HDreaddir(dir)))
+        if(HDstrcmp(ent->d_name, ".") && HDstrcmp(ent->d_name, "..")) {
+            HDsnprintf(path, sizeof(path), "%s/%s", BLKCACHE_DIR, ent->d_name);
+            HDremove(path);
+        } /* end if */
+    HDclosedir(dir);
+
+    return 0;
+} /* end blkcache_clear_dir() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    blkcache_find_block
+ *
+ * Purpose:     Looks for a cache slot holding BLOCK in the block cache
+ *              directory's cached blocks file, and optionally replaces
+ *              the slot's contents with NEW_BLOCK.
+ *
+ * Return:      Success:        The slot number, or -1 if no slot holds
+ *                              the block
+ *              Failure:        -2
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+blkcache_find_block(const unsigned char *block, const unsigned char *new_block)
+{
+    DIR         *dir = NULL;                /* cache directory              */
+    struct dirent *ent;                     /* directory entry              */
+    char        path[1024];                 /* cache file name              */
+    h5_stat_t   sb;                         /* cache file status            */
+    unsigned char *slots = NULL;            /* cache file contents          */
+    size_t      size;                       /* cache file size              */
+    size_t      nslots;                     /* number of slots              */
+    size_t      u;                          /* local index variable         */
+    int         fd = -1;                    /* cache file descriptor        */
+    int         ret_value = -1;             /* return value                 */
+
+    /* Find the cached blocks file */
+    path[0] = '\0';
+    if(NULL == (dir = HDopendir(BLKCACHE_DIR)))
+        goto error;
+    while(NULL != (ent = HDreaddir(dir))) {
+        size_t len = HDstrlen(ent->d_name);
+
+        if(len > 4 && !HDstrcmp(ent->d_name + len - 4, ".blk"))
+            HDsnprintf(path, sizeof(path), "%s/%s", BLKCACHE_DIR, ent->d_name);
+    } /* end while */
+    HDclosedir(dir);
+    dir = NULL;
+    if(!path[0])
+        goto error;
+
+    /* Read it, and look at each slot */
+    if((fd = HDopen(path, O_RDWR)) < 0)
+        goto error;
+    if(HDfstat(fd, &sb) < 0)
+        goto error;
+    size = (size_t)sb.st_size;
+    if(NULL == (slots = (unsigned char *)HDmalloc(size + 1)))
+        goto error;
+    if(HDread(fd, slots, size) != (h5_posix_io_ret_t)size)
+        goto error;
+    nslots = size / BLKCACHE_BLOCK_SIZE;
+    for(u = 0; u < nslots; u++)
+        if(!HDmemcmp(slots + u * BLKCACHE_BLOCK_SIZE, block, BLKCACHE_BLOCK_SIZE)) {
+            ret_value = (int)u;
+            break;
+        } /* end if */
+
+    if(ret_value >= 0 && new_block) {
+        if(HDlseek(fd, (HDoff_t)ret_value * BLKCACHE_BLOCK_SIZE, SEEK_SET) < 0)
+            goto error;
+        if(HDwrite(fd, new_block, BLKCACHE_BLOCK_SIZE) != BLKCACHE_BLOCK_SIZE)
+            goto error;
+    } /* end if */
+
+    if(HDclose(fd) < 0)
+        goto error;
+    HDfree(slots);
+
+    return ret_value;
+
+error:
+    if(dir)
+        HDclosedir(dir);
+    if(fd >= 0)
+        HDclose(fd);
+    HDfree(slots);
+    return -2;
+} /* end blkcache_find_block() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_blkcache
+ *
+ * Purpose:     Tests the file handle interface for the BLKCACHE driver:
+ *              that blocks read are kept in the cache directory and read
+ *              from there when the file is opened again, that writes
+ *              update the cache, that the cache is dropped when the file
+ *              changes behind its back, and that raw data isn't cached
+ *              when its pool has no room.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_blkcache(void)
+{
+    hid_t       fid = -1;                   /* file ID                      */
+    hid_t       fapl_id = -1;               /* file access property list ID */
+    hid_t       fapl_id_out = -1;           /* from H5Fget_access_plist     */
+    hid_t       back_fapl_id = -1;          /* fapl of the file cached      */
+    hid_t       back_fapl_id_out = -1;      /* from H5Pget_fapl_blkcache    */
+    hid_t       sec2_fapl_id = -1;          /* sec2 fapl                    */
+    hid_t       dset_id = -1;               /* dataset ID                   */
+    hid_t       space_id = -1;              /* dataspace ID                 */
+    hid_t       driver_id = -1;             /* ID for this VFD              */
+    unsigned long driver_flags = 0;         /* VFD feature flags            */
+    char        filename[1024];             /* filename                     */
+    char        cache_dir[64];              /* cache directory from fapl    */
+    void        *os_file_handle = NULL;     /* OS file handle               */
+    hsize_t     dims[1] = {BLKCACHE_DSET_DIM}; /* dataset dimensions        */
+    size_t      block_size = 0;             /* block size from fapl         */
+    hsize_t     meta_cache_size = 0;        /* metadata pool size from fapl */
+    hsize_t     raw_cache_size = 0;         /* raw data pool size from fapl */
+    haddr_t     offset;                     /* dataset's address            */
+    size_t      block_off;                  /* offset of a block in dataset */
+    int         *wdata = NULL;              /* data written                 */
+    int         *rdata = NULL;              /* data read back               */
+    unsigned char block[BLKCACHE_BLOCK_SIZE];       /* a block of the data  */
+    unsigned char bad_block[BLKCACHE_BLOCK_SIZE];   /* the block, changed   */
+    herr_t      ret;                        /* generic return value         */
+    int         fd = -1;                    /* file descriptor              */
+    unsigned    u;                          /* local index variable         */
+
+    TESTING("BLKCACHE file driver");
+
+    if(NULL == (wdata = (int *)HDmalloc(BLKCACHE_DSET_DIM * sizeof(int))))
+        TEST_ERROR;
+    if(NULL == (rdata = (int *)HDcalloc(BLKCACHE_DSET_DIM, sizeof(int))))
+        TEST_ERROR;
+    for(u = 0; u < BLKCACHE_DSET_DIM; u++)
+        wdata[u] = (int)(u * 7 + 3);
+
+    /* Start with an empty cache directory */
+    if(HDmkdir(BLKCACHE_DIR, (mode_t)0755) < 0 && errno != EEXIST)
+        TEST_ERROR;
+    if(blkcache_clear_dir() < 0)
+        TEST_ERROR;
+
+    /* Set property list and file name for BLKCACHE driver, caching a
+     * sec2 file
+     */
+    if((back_fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_sec2(back_fapl_id) < 0)
+        TEST_ERROR;
+    if((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR;
+    H5E_BEGIN_TRY {
+        ret = H5Pset_fapl_blkcache(fapl_id, "", (size_t)0, (hsize_t)BLKCACHE_META_SIZE, (hsize_t)BLKCACHE_RAW_SIZE, back_fapl_id);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        FAIL_PUTS_ERROR("empty cache directory name accepted");
+    if(H5Pset_fapl_blkcache(fapl_id, BLKCACHE_DIR, (size_t)0, (hsize_t)BLKCACHE_META_SIZE, (hsize_t)BLKCACHE_RAW_SIZE, back_fapl_id) < 0)
+        TEST_ERROR;
+    if(H5Pget_fapl_blkcache(fapl_id, sizeof(cache_dir), cache_dir, &block_size, &meta_cache_size, &raw_cache_size, &back_fapl_id_out) < 0)
+        TEST_ERROR;
+    if(HDstrcmp(cache_dir, BLKCACHE_DIR) || block_size != H5FD_BLKCACHE_BLOCK_SIZE_DEF
+            || meta_cache_size != BLKCACHE_META_SIZE || raw_cache_size != BLKCACHE_RAW_SIZE)
+        TEST_ERROR;
+    if(H5FD_SEC2 != H5Pget_driver(back_fapl_id_out))
+        TEST_ERROR;
+    if(H5Pclose(back_fapl_id_out) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_blkcache(fapl_id, BLKCACHE_DIR, (size_t)BLKCACHE_BLOCK_SIZE, (hsize_t)BLKCACHE_META_SIZE, (hsize_t)BLKCACHE_RAW_SIZE, back_fapl_id) < 0)
+        TEST_ERROR;
+    h5_fixname(FILENAME[15], fapl_id, filename, sizeof(filename));
+
+    /* Check that the VFD feature flags are correct */
+    if ((driver_id = H5Pget_driver(fapl_id)) < 0)
+        TEST_ERROR
+    if (H5FDdriver_query(driver_id, &driver_flags) < 0)
+        TEST_ERROR
+    if(driver_flags != (H5FD_FEAT_AGGREGATE_METADATA
+                        | H5FD_FEAT_ACCUMULATE_METADATA
+                        | H5FD_FEAT_DATA_SIEVE
+                        | H5FD_FEAT_AGGREGATE_SMALLDATA))
+        TEST_ERROR
+
+    /* Write a dataset spanning many blocks */
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0)
+        TEST_ERROR;
+    if(H5Fget_vfd_handle(fid, H5P_DEFAULT, &os_file_handle) < 0)
+        TEST_ERROR;
+    if(os_file_handle == NULL)
+        FAIL_PUTS_ERROR("NULL os-specific vfd/file handle was returned from H5Fget_vfd_handle");
+    if((space_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dcreate2(fid, BLKCACHE_DSET_NAME, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata) < 0)
+        TEST_ERROR;
+    if(HADDR_UNDEF == (offset = H5Dget_offset(dset_id)))
+        TEST_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Sclose(space_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* The first whole block of the dataset */
+    block_off = (size_t)(((offset + BLKCACHE_BLOCK_SIZE - 1) / BLKCACHE_BLOCK_SIZE) * BLKCACHE_BLOCK_SIZE - offset);
+    HDmemcpy(block, (unsigned char *)wdata + block_off, (size_t)BLKCACHE_BLOCK_SIZE);
+    HDmemcpy(bad_block, block, (size_t)BLKCACHE_BLOCK_SIZE);
+    bad_block[0] ^= 0xff;
+
+    /* Read the dataset, which puts it in the cache */
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((fapl_id_out = H5Fget_access_plist(fid)) < 0)
+        TEST_ERROR;
+    if(H5FD_BLKCACHE != H5Pget_driver(fapl_id_out))
+        TEST_ERROR;
+    if(H5Pget_fapl_blkcache(fapl_id_out, sizeof(cache_dir), cache_dir, &block_size, NULL, NULL, NULL) < 0)
+        TEST_ERROR;
+    if(HDstrcmp(cache_dir, BLKCACHE_DIR) || block_size != BLKCACHE_BLOCK_SIZE)
+        TEST_ERROR;
+    if(H5Pclose(fapl_id_out) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, BLKCACHE_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, BLKCACHE_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Change the block in the cache: opening the file again must read it
+     * from the cache, not from the file
+     */
+    if(blkcache_find_block(block, bad_block) < 0)
+        FAIL_PUTS_ERROR("raw data block not cached");
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, BLKCACHE_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp((unsigned char *)rdata + block_off, bad_block, (size_t)BLKCACHE_BLOCK_SIZE))
+        FAIL_PUTS_ERROR("cached block not used");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Writing the dataset updates the cache and the file */
+    if((fid = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, BLKCACHE_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata) < 0)
+        TEST_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+    if(blkcache_find_block(block, NULL) < 0)
+        FAIL_PUTS_ERROR("cached block not updated");
+    if((sec2_fapl_id = h5_fileaccess()) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_sec2(sec2_fapl_id) < 0)
+        TEST_ERROR;
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, sec2_fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, BLKCACHE_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    HDmemset(rdata, 0, BLKCACHE_DSET_DIM * sizeof(int));
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, BLKCACHE_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Change the block in the cache again, then change the size of the
+     * file: the cache no longer describes the file, so it isn't used
+     */
+    if(blkcache_find_block(block, bad_block) < 0)
+        TEST_ERROR;
+    if((fd = HDopen(filename, O_WRONLY | O_APPEND)) < 0)
+        TEST_ERROR;
+    if(HDwrite(fd, "x", (size_t)1) != 1)
+        TEST_ERROR;
+    if(HDclose(fd) < 0)
+        TEST_ERROR;
+    fd = -1;
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, BLKCACHE_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    HDmemset(rdata, 0, BLKCACHE_DSET_DIM * sizeof(int));
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, BLKCACHE_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("stale cache used");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* With no room for raw data, only metadata is cached */
+    if(blkcache_clear_dir() < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_blkcache(fapl_id, BLKCACHE_DIR, (size_t)BLKCACHE_BLOCK_SIZE, (hsize_t)BLKCACHE_META_SIZE, (hsize_t)0, back_fapl_id) < 0)
+        TEST_ERROR;
+    if((fid = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, BLKCACHE_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    HDmemset(rdata, 0, BLKCACHE_DSET_DIM * sizeof(int));
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, BLKCACHE_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+    if(blkcache_find_block(block, NULL) != -1)
+        FAIL_PUTS_ERROR("raw data cached with no room for it");
+
+    h5_delete_test_file(FILENAME[15], fapl_id);
+
+    /* Vector I/O crossing blocks */
+    if(H5Pset_fapl_blkcache(fapl_id, BLKCACHE_DIR, (size_t)1000, (hsize_t)(8 * KB), (hsize_t)(8 * KB), back_fapl_id) < 0)
+        TEST_ERROR;
+    if(test_vector_io_driver(fapl_id) < 0)
+        TEST_ERROR;
+
+    if(blkcache_clear_dir() < 0)
+        TEST_ERROR;
+    if(HDrmdir(BLKCACHE_DIR) < 0)
+        TEST_ERROR;
+    if(H5Pclose(sec2_fapl_id) < 0)
+        TEST_ERROR;
+    if(H5Pclose(back_fapl_id) < 0)
+        TEST_ERROR;
+    if(H5Pclose(fapl_id) < 0)
+        TEST_ERROR;
+
+    HDfree(wdata);
+    HDfree(rdata);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Pclose(fapl_id);
+        H5Pclose(fapl_id_out);
+        H5Pclose(back_fapl_id);
+        H5Pclose(back_fapl_id_out);
+        H5Pclose(sec2_fapl_id);
+        H5Dclose(dset_id);
+        H5Sclose(space_id);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(fd >= 0)
+        HDclose(fd);
+    HDfree(wdata);
+    HDfree(rdata);
+    return -1;
+} /* end test_blkcache() */
+
+
+#if defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) && defined(H5_HAVE_FORK) && defined(H5_HAVE_WAITPID)
+
+/*-------------------------------------------------------------------------
+ * Function:    http_serve_conn
+ *
+ * Purpose:     Answers the HEAD and GET requests made on a connection to
+ *              the test HTTP server with the contents of IMAGE, until the
+ *              client closes the connection.  GET requests must have a
+ *              Range header.  Paths containing "missing" aren't found.
+ *              One byte is written to COUNT_FD for each request, before
+ *              it's answered.
+ *
+ * Return:      void (the process exits)
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+http_serve_conn(int sock, const unsigned char *image, size_t size, int count_fd)
+{
+    char        req[4096];                  /* request                      */
+    size_t      req_len = 0;                /* bytes of request received    */
+    char        *end;                       /* end of request header        */
+    char        hdr[256];                   /* response header              */
+    ssize_t     n;                          /* bytes received               */
+
+    for(;;) {
+        hbool_t     head;                   /* whether request is HEAD      */
+        char        *range;                 /* Range header                 */
+        unsigned long long first, last;     /* requested range              */
+        const unsigned char *body = NULL;   /* response body                */
+        size_t      body_len = 0;           /* response body length         */
+        size_t      req_hdr_len;            /* length of request header     */
+
+        /* Receive a request header */
+        while(NULL == (end = HDstrstr(req, "\r\n\r\n"))) {
+            if(req_len >= sizeof(req) - 1)
+                HD_exit(1);
+            if((n = recv(sock, req + req_len, sizeof(req) - 1 - req_len, 0)) <= 0)
+                HD_exit(0);
+            req_len += (size_t)n;
+            req[req_len] = '\0';
+        } /* end while */
+        *end = '\0';
+        req_hdr_len = (size_t)(end - req) + 4;
+
+        if(HDwrite(count_fd, "r", (size_t)1) != 1)
+            HD_exit(1);
+
+        head = !HDstrncmp(req, "HEAD ", (size_t)5);
+        if(HDstrstr(req, "missing"))
+            HDsnprintf(hdr, sizeof(hdr), "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        else if(head)
+            HDsnprintf(hdr, sizeof(hdr), "HTTP/1.1 200 OK\r\nContent-Length: %llu\r\n\r\n", (unsigned long long)size);
+        else if(NULL == (range = HDstrstr(req, "Range: bytes=")))
+            HDsnprintf(hdr, sizeof(hdr), "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n");
+        else {
+            first = HDstrtoull(range + 13, &range, 10);
+            last = HDstrtoull(range + 1, NULL, 10);
+            if(first >= size || last < first)
+                HDsnprintf(hdr, sizeof(hdr), "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\n\r\n");
+            else {
+                if(last >= size)
+                    last = size - 1;
+                body = image + first;
+                body_len = (size_t)(last - first + 1);
+                HDsnprintf(hdr, sizeof(hdr), "HTTP/1.1 206 Partial Content\r\nContent-Length: %llu\r\nContent-Range: bytes %llu-%llu/%llu\r\n\r\n",
+                        (unsigned long long)body_len, first, last, (unsigned long long)size);
+            } /* end else */
+        } /* end else */
+
+        if(send(sock, hdr, HDstrlen(hdr), 0) != (ssize_t)HDstrlen(hdr))
+            HD_exit(1);
+        while(body_len > 0) {
+            if((n = send(sock, body, body_len, 0)) <= 0)
+                HD_exit(1);
+            body += n;
+            body_len -= (size_t)n;
+        } /* end while */
+
+        /* Keep any pipelined request */
+        HDmemmove(req, req + req_hdr_len, req_len - req_hdr_len + 1);
+        req_len -= req_hdr_len;
+    } /* end for */
+} /* end http_serve_conn() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    http_start_server
+ *
+ * Purpose:     Starts a small HTTP server in a child process, serving the
+ *              file FILENAME on a port of the local host chosen by the
+ *              system, with a process for each connection.  The port is
+ *              returned in PORT.  The server writes one byte to the pipe
+ *              whose read end is returned in COUNT_FD for each request.
+ *
+ * Return:      Success:        The server's process ID
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static pid_t
+http_start_server(const char *filename, char *port, size_t port_size, int *count_fd)
+{
+    struct addrinfo hints;                  /* address lookup hints         */
+    struct addrinfo *ai = NULL;             /* address to listen on         */
+    struct sockaddr_storage addr;           /* address listened on          */
+    socklen_t   addr_len = (socklen_t)sizeof(addr); /* size of address      */
+    unsigned char *image = NULL;            /* file contents                */
+    h5_stat_t   sb;                         /* file status                  */
+    int         pipe_fds[2] = {-1, -1};     /* request count pipe           */
+    int         sock = -1;                  /* listening socket             */
+    int         fd = -1;                    /* file descriptor              */
+    pid_t       pid;                        /* server process ID            */
+
+    /* Read the file to serve */
+    if((fd = HDopen(filename, O_RDONLY)) < 0)
+        goto error;
+    if(HDfstat(fd, &sb) < 0)
+        goto error;
+    if(NULL == (image = (unsigned char *)HDmalloc((size_t)sb.st_size)))
+        goto error;
+    if(HDread(fd, image, (size_t)sb.st_size) != (h5_posix_io_ret_t)sb.st_size)
+        goto error;
+    HDclose(fd);
+    fd = -1;
+
+    /* Listen on the local host */
+    HDmemset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+    if(0 != getaddrinfo("127.0.0.1", "0", &hints, &ai))
+        goto error;
+    if((sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0)
+        goto error;
+    if(bind(sock, ai->ai_addr, ai->ai_addrlen) < 0)
+        goto error;
+    if(listen(sock, 16) < 0)
+        goto error;
+    if(getsockname(sock, (struct sockaddr *)&addr, &addr_len) < 0)
+        goto error;
+    if(0 != getnameinfo((struct sockaddr *)&addr, addr_len, NULL, 0, port, (socklen_t)port_size, NI_NUMERICSERV))
+        goto error;
+    freeaddrinfo(ai);
+    ai = NULL;
+
+    if(HDpipe(pipe_fds) < 0)
+        goto error;
+    if((pid = HDfork()) < 0)
+        goto error;
+    if(0 == pid) {
+        /* The server: don't leave zombies of finished connections, and
+         * don't outlive a test that failed to stop it
+         */
+        HDsignal(SIGCHLD, SIG_IGN);
+        HDalarm(H5_ALARM_SEC);
+        HDclose(pipe_fds[0]);
+        for(;;) {
+            int conn;                       /* connection socket            */
+
+            if((conn = accept(sock, NULL, NULL)) < 0) {
+                if(EINTR == errno)
+                    continue;
+                HD_exit(1);
+            } /* end if */
+            if(0 == HDfork()) {
+                HDclose(sock);
+                http_serve_conn(conn, image, (size_t)sb.st_size, pipe_fds[1]);
+            } /* end if */
+            HDclose(conn);
+        } /* end for */
+    } /* end if */
+
+    HDclose(sock);
+    HDclose(pipe_fds[1]);
+    if(HDfcntl(pipe_fds[0], F_SETFL, O_NONBLOCK) < 0) {
+        HDkill(pid, SIGTERM);
+        HDwaitpid(pid, NULL, 0);
+        HDclose(pipe_fds[0]);
+        HDfree(image);
+        return -1;
+    } /* end if */
+    *count_fd = pipe_fds[0];
+    HDfree(image);
+
+    return pid;
+
+error:
+    if(ai)
+        freeaddrinfo(ai);
+    if(sock >= 0)
+        HDclose(sock);
+    if(fd >= 0)
+        HDclose(fd);
+    if(pipe_fds[0] >= 0) {
+        HDclose(pipe_fds[0]);
+        HDclose(pipe_fds[1]);
+    } /* end if */
+    HDfree(image);
+    return -1;
+} /* end http_start_server() */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    http_count_requests
+ *
+ * Purpose:     Returns the number of requests the test HTTP server has
+ *              answered since this was last called.
+ *
+ * Return:      The number of requests
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+http_count_requests(int count_fd)
+{
+    char        buf[64];                    /* bytes from the server        */
+    ssize_t     n;                          /* bytes read                   */
+    int         count = 0;                  /* number of requests           */
+
+    while((n = HDread(count_fd, buf, sizeof(buf))) > 0)
+        count += (int)n;
+
+    return count;
+} /* end http_count_requests() */
+
+#endif /* defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) && defined(H5_HAVE_FORK) && defined(H5_HAVE_WAITPID) */
+
+
+/*-------------------------------------------------------------------------
+ * Function:    test_http
+ *
+ * Purpose:     Tests the file handle interface for the HTTP driver,
+ *              against a small HTTP server run in a child process: that
+ *              files can only be opened read-only, that data read is
+ *              cached, that reads of nearby blocks are merged into one
+ *              request, and that reads spread over several connections
+ *              return the right data.
+ *
+ * Return:      Success:        0
+ *              Failure:        -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static herr_t
+test_http(void)
+{
+#if defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) && defined(H5_HAVE_FORK) && defined(H5_HAVE_WAITPID)
+    hid_t       fid = -1;                   /* file ID                      */
+    hid_t       fapl_id = -1;               /* file access property list ID */
+    hid_t       fapl_id_out = -1;           /* from H5Fget_access_plist     */
+    hid_t       sec2_fapl_id = -1;          /* sec2 fapl                    */
+    hid_t       dset_id = -1;               /* dataset ID                   */
+    hid_t       space_id = -1;              /* dataspace ID                 */
+    hid_t       driver_id = -1;             /* ID for this VFD              */
+    H5FD_t      *file = NULL;               /* VFD file struct              */
+    unsigned long driver_flags = 0;         /* VFD feature flags            */
+    char        filename[1024];             /* filename                     */
+    char        url[1100];                  /* URL of file                  */
+    char        port[16];                   /* server port                  */
+    void        *os_file_handle = NULL;     /* OS file handle               */
+    hsize_t     dims[1] = {HTTP_DSET_DIM};  /* dataset dimensions           */
+    size_t      block_size = 0;             /* block size from fapl         */
+    size_t      cache_size = 0;             /* cache size from fapl         */
+    size_t      max_gap = 0;                /* largest gap from fapl        */
+    unsigned    nconns = 0;                 /* connections from fapl        */
+    haddr_t     eof;                        /* size of file                 */
+    int         *wdata = NULL;              /* data written                 */
+    int         *rdata = NULL;              /* data read back               */
+    unsigned char *image = NULL;            /* file contents                */
+    unsigned char *rbuf = NULL;             /* raw data read back           */
+    H5FD_mem_t  types[4];                   /* vector read types            */
+    haddr_t     addrs[4];                   /* vector read addresses        */
+    size_t      sizes[4];                   /* vector read sizes            */
+    void        *bufs[4];                   /* vector read buffers          */
+    herr_t      ret;                        /* generic return value         */
+    pid_t       server = -1;                /* server process ID            */
+    int         count_fd = -1;              /* server request count pipe    */
+    int         fd = -1;                    /* file descriptor              */
+    unsigned    u;                          /* local index variable         */
+#endif /* defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) && defined(H5_HAVE_FORK) && defined(H5_HAVE_WAITPID) */
+
+    TESTING("HTTP file driver");
+
+#if !(defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) && defined(H5_HAVE_FORK) && defined(H5_HAVE_WAITPID))
+    SKIPPED();
+    HDputs("    HTTP driver or test server not supported on this platform");
+    return 0;
+#else
+    if(NULL == (wdata = (int *)HDmalloc(HTTP_DSET_DIM * sizeof(int))))
+        TEST_ERROR;
+    if(NULL == (rdata = (int *)HDcalloc(HTTP_DSET_DIM, sizeof(int))))
+        TEST_ERROR;
+    for(u = 0; u < HTTP_DSET_DIM; u++)
+        wdata[u] = (int)(u * 5 + 1);
+
+    /* Write a file to serve, with the sec2 driver */
+    if((sec2_fapl_id = h5_fileaccess()) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_sec2(sec2_fapl_id) < 0)
+        TEST_ERROR;
+    h5_fixname(FILENAME[16], sec2_fapl_id, filename, sizeof(filename));
+    if((fid = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, sec2_fapl_id)) < 0)
+        TEST_ERROR;
+    if((space_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dcreate2(fid, HTTP_DSET_NAME, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wdata) < 0)
+        TEST_ERROR;
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Sclose(space_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Keep a copy of its contents, and serve it */
+    if((fd = HDopen(filename, O_RDONLY)) < 0)
+        TEST_ERROR;
+    if((eof = (haddr_t)HDlseek(fd, (HDoff_t)0, SEEK_END)) < 4 * HTTP_BLOCK_SIZE)
+        TEST_ERROR;
+    if(NULL == (image = (unsigned char *)HDmalloc((size_t)eof)))
+        TEST_ERROR;
+    if(NULL == (rbuf = (unsigned char *)HDmalloc((size_t)eof + 100)))
+        TEST_ERROR;
+    if(HDlseek(fd, (HDoff_t)0, SEEK_SET) < 0)
+        TEST_ERROR;
+    if(HDread(fd, image, (size_t)eof) != (h5_posix_io_ret_t)eof)
+        TEST_ERROR;
+    if(HDclose(fd) < 0)
+        TEST_ERROR;
+    fd = -1;
+    if((server = http_start_server(filename, port, sizeof(port), &count_fd)) < 0)
+        TEST_ERROR;
+    HDsnprintf(url, sizeof(url), "http://127.0.0.1:%s/%s", port, filename);
+
+    /* Set property list for HTTP driver */
+    if((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR;
+    if(H5Pset_fapl_http(fapl_id, (size_t)0, (size_t)HTTP_CACHE_SIZE, (size_t)HTTP_MAX_GAP, 0) < 0)
+        TEST_ERROR;
+    if(H5Pget_fapl_http(fapl_id, &block_size, &cache_size, &max_gap, &nconns) < 0)
+        TEST_ERROR;
+    if(block_size != H5FD_HTTP_BLOCK_SIZE_DEF || cache_size != HTTP_CACHE_SIZE
+            || max_gap != HTTP_MAX_GAP || nconns != H5FD_HTTP_NCONNS_DEF)
+        TEST_ERROR;
+    H5E_BEGIN_TRY {
+        ret = H5Pset_fapl_http(fapl_id, (size_t)0, (size_t)0, (size_t)0, H5FD_HTTP_MAX_CONNS + 1);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        FAIL_PUTS_ERROR("too many connections accepted");
+    if(H5Pset_fapl_http(fapl_id, (size_t)HTTP_BLOCK_SIZE, (size_t)HTTP_CACHE_SIZE, (size_t)HTTP_MAX_GAP, 1) < 0)
+        TEST_ERROR;
+
+    /* Check that the VFD feature flags are correct */
+    if ((driver_id = H5Pget_driver(fapl_id)) < 0)
+        TEST_ERROR
+    if (H5FDdriver_query(driver_id, &driver_flags) < 0)
+        TEST_ERROR
+    if(driver_flags != (H5FD_FEAT_AGGREGATE_METADATA
+                        | H5FD_FEAT_ACCUMULATE_METADATA
+                        | H5FD_FEAT_DATA_SIEVE
+                        | H5FD_FEAT_AGGREGATE_SMALLDATA))
+        TEST_ERROR
+
+    /* The driver is read-only, and files must exist */
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(url, H5F_ACC_RDWR, fapl_id);
+    } H5E_END_TRY;
+    if(fid >= 0)
+        FAIL_PUTS_ERROR("file opened for writing");
+    H5E_BEGIN_TRY {
+        fid = H5Fcreate(url, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    } H5E_END_TRY;
+    if(fid >= 0)
+        FAIL_PUTS_ERROR("file created");
+    HDsnprintf(url, sizeof(url), "http://127.0.0.1:%s/missing.h5", port);
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(url, H5F_ACC_RDONLY, fapl_id);
+    } H5E_END_TRY;
+    if(fid >= 0)
+        FAIL_PUTS_ERROR("missing file opened");
+    HDsnprintf(url, sizeof(url), "http://127.0.0.1:%s/%s", port, filename);
+
+    /* Read the dataset over one connection */
+    if((fid = H5Fopen(url, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    H5E_BEGIN_TRY {
+        ret = H5Fget_vfd_handle(fid, H5P_DEFAULT, &os_file_handle);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        FAIL_PUTS_ERROR("H5Fget_vfd_handle returned a handle for the HTTP driver");
+    if((fapl_id_out = H5Fget_access_plist(fid)) < 0)
+        TEST_ERROR;
+    if(H5FD_HTTP != H5Pget_driver(fapl_id_out))
+        TEST_ERROR;
+    if(H5Pget_fapl_http(fapl_id_out, &block_size, NULL, NULL, &nconns) < 0)
+        TEST_ERROR;
+    if(block_size != HTTP_BLOCK_SIZE || nconns != 1)
+        TEST_ERROR;
+    if(H5Pclose(fapl_id_out) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, HTTP_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, HTTP_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(0 == http_count_requests(count_fd))
+        FAIL_PUTS_ERROR("no requests made");
+
+    /* Reading it again is satisfied from the block cache */
+    HDmemset(rdata, 0, HTTP_DSET_DIM * sizeof(int));
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, HTTP_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(0 != http_count_requests(count_fd))
+        FAIL_PUTS_ERROR("cached blocks requested again");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* A vector read of small pieces of blocks near each other takes one
+     * request
+     */
+    if(NULL == (file = H5FDopen(url, H5F_ACC_RDONLY, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR;
+    if(H5FDget_eof(file, H5FD_MEM_DEFAULT) != eof)
+        TEST_ERROR;
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, eof + 100) < 0)
+        TEST_ERROR;
+    (void)http_count_requests(count_fd);
+    for(u = 0; u < 4; u++) {
+        types[u] = H5FD_MEM_DRAW;
+        addrs[u] = (haddr_t)((u * 2 + 1) * HTTP_BLOCK_SIZE - 10);
+        sizes[u] = 20;
+        bufs[u] = rbuf + u * 20;
+    } /* end for */
+    if(H5FDread_vector(file, H5P_DEFAULT, (size_t)4, types, addrs, sizes, bufs) < 0)
+        TEST_ERROR;
+    for(u = 0; u < 4; u++)
+        if(HDmemcmp(bufs[u], image + addrs[u], sizes[u]))
+            FAIL_PUTS_ERROR("data read doesn't match file");
+    if(1 != http_count_requests(count_fd))
+        FAIL_PUTS_ERROR("nearby blocks not requested together");
+
+    /* Reading past the end of the file gives zeros */
+    HDmemset(rbuf, 0xff, (size_t)eof + 100);
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, eof - 50, (size_t)150, rbuf) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(rbuf, image + eof - 50, (size_t)50))
+        FAIL_PUTS_ERROR("data read doesn't match file");
+    for(u = 50; u < 150; u++)
+        if(rbuf[u])
+            FAIL_PUTS_ERROR("data read past end of file not zero");
+    if(H5FDclose(file) < 0)
+        TEST_ERROR;
+    file = NULL;
+
+    /* Reads larger than the cache are split over the connections and
+     * aren't cached
+     */
+    if(H5Pset_fapl_http(fapl_id, (size_t)HTTP_BLOCK_SIZE, (size_t)(2 * HTTP_BLOCK_SIZE), (size_t)HTTP_MAX_GAP, HTTP_NCONNS) < 0)
+        TEST_ERROR;
+    if(NULL == (file = H5FDopen(url, H5F_ACC_RDONLY, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR;
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, eof) < 0)
+        TEST_ERROR;
+    (void)http_count_requests(count_fd);
+    HDmemset(rbuf, 0, (size_t)eof);
+    if(H5FDread(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, (size_t)eof, rbuf) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(rbuf, image, (size_t)eof))
+        FAIL_PUTS_ERROR("data read doesn't match file");
+    if(HTTP_NCONNS != http_count_requests(count_fd))
+        FAIL_PUTS_ERROR("large read not split over connections");
+    if(H5FDclose(file) < 0)
+        TEST_ERROR;
+    file = NULL;
+
+    /* Read the dataset over several connections, with a small cache */
+    if((fid = H5Fopen(url, H5F_ACC_RDONLY, fapl_id)) < 0)
+        TEST_ERROR;
+    if((dset_id = H5Dopen2(fid, HTTP_DSET_NAME, H5P_DEFAULT)) < 0)
+        TEST_ERROR;
+    HDmemset(rdata, 0, HTTP_DSET_DIM * sizeof(int));
+    if(H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata) < 0)
+        TEST_ERROR;
+    if(HDmemcmp(wdata, rdata, HTTP_DSET_DIM * sizeof(int)))
+        FAIL_PUTS_ERROR("data read doesn't match data written");
+    if(H5Dclose(dset_id) < 0)
+        TEST_ERROR;
+    if(H5Fclose(fid) < 0)
+        TEST_ERROR;
+
+    /* Writes fail */
+    if(NULL == (file = H5FDopen(url, H5F_ACC_RDONLY, fapl_id, HADDR_UNDEF)))
+        TEST_ERROR;
+    if(H5FDset_eoa(file, H5FD_MEM_DEFAULT, eof) < 0)
+        TEST_ERROR;
+    H5E_BEGIN_TRY {
+        ret = H5FDwrite(file, H5FD_MEM_DRAW, H5P_DEFAULT, (haddr_t)0, (size_t)10, image);
+    } H5E_END_TRY;
+    if(ret >= 0)
+        FAIL_PUTS_ERROR("write succeeded");
+    if(H5FDclose(file) < 0)
+        TEST_ERROR;
+    file = NULL;
+
+    /* Stop the server */
+    if(HDkill(server, SIGTERM) < 0)
+        TEST_ERROR;
+    if(HDwaitpid(server, NULL, 0) < 0)
+        TEST_ERROR;
+    server = -1;
+    HDclose(count_fd);
+    count_fd = -1;
+
+    h5_delete_test_file(FILENAME[16], sec2_fapl_id);
+
+    if(H5Pclose(sec2_fapl_id) < 0)
+        TEST_ERROR;
+    if(H5Pclose(fapl_id) < 0)
+        TEST_ERROR;
+
+    HDfree(wdata);
+    HDfree(rdata);
+    HDfree(image);
+    HDfree(rbuf);
+
+    PASSED();
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if(file)
+            H5FDclose(file);
+        H5Pclose(fapl_id);
+        H5Pclose(fapl_id_out);
+        H5Pclose(sec2_fapl_id);
+        H5Dclose(dset_id);
+        H5Sclose(space_id);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+    if(server > 0) {
+        HDkill(server, SIGTERM);
+        HDwaitpid(server, NULL, 0);
+    } /* end if */
+    if(count_fd >= 0)
+        HDclose(count_fd);
+    if(fd >= 0)
+        HDclose(fd);
+    HDfree(wdata);
+    HDfree(rdata);
+    HDfree(image);
+    HDfree(rbuf);
+    return -1;
+#endif /* !(defined(H5_HAVE_SYS_SOCKET_H) && defined(H5_HAVE_NETDB_H) && defined(H5_HAVE_FORK) && defined(H5_HAVE_WAITPID)) */
+} /* end test_http() */
+
+
 /*-------------------------------------------------------------------------
  * Function:    main
  *
@@ -1912,6 +3796,7 @@ main(void)
     HDprintf("Testing basic Virtual File Driver functionality.\n");
 
     nerrors += test_sec2() < 0           ? 1 : 0;
+    nerrors += test_sec2_direct_read() < 0 ? 1 : 0;
     nerrors += test_core() < 0           ? 1 : 0;
     nerrors += test_direct() < 0         ? 1 : 0;
     nerrors += test_family() < 0         ? 1 : 0;
@@ -1920,7 +3805,13 @@ main(void)
     nerrors += test_multi_compat() < 0   ? 1 : 0;
     nerrors += test_log() < 0            ? 1 : 0;
     nerrors += test_stdio() < 0          ? 1 : 0;
+    nerrors += test_mmap() < 0           ? 1 : 0;
     nerrors += test_windows() < 0        ? 1 : 0;
+    nerrors += test_vector_io() < 0      ? 1 : 0;
+    nerrors += test_iouring() < 0        ? 1 : 0;
+    nerrors += test_subfiling() < 0      ? 1 : 0;
+    nerrors += test_blkcache() < 0       ? 1 : 0;
+    nerrors += test_http() < 0           ? 1 : 0;
 
     if(nerrors) {
         HDprintf("***** %d Virtual File Driver TEST%s FAILED! *****\n",
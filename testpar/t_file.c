@@ -145,32 +145,32 @@ test_page_buffer_access(void)
 
     ret = H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, 1, (hsize_t)0);
     VRFY((ret == 0), "");
-    ret = H5Pset_file_space_page_size(fcpl, sizeof(int)*100);
+    ret = H5Pset_file_space_page_size(fcpl, sizeof(int)*128);
     VRFY((ret == 0), "");
-    ret = H5Pset_page_buffer_size(fapl, sizeof(int)*100000, 0, 0);
+    ret = H5Pset_page_buffer_size(fapl, sizeof(int)*102400, 0, 0);
     VRFY((ret == 0), "");
 
-    /* This should fail because collective metadata writes are not supported with page buffering */
-    H5E_BEGIN_TRY {
-        file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl, fapl);
-    } H5E_END_TRY;
-    VRFY((file_id < 0), "H5Fcreate failed");
+    /* Collective metadata writes update the pages they write */
+    ret = create_file(filename, fcpl, fapl, H5AC_METADATA_WRITE_STRATEGY__DISTRIBUTED);
+    VRFY((ret == 0), "");
+    ret = open_file(filename, fapl, H5AC_METADATA_WRITE_STRATEGY__DISTRIBUTED, sizeof(int)*128, sizeof(int)*102400);
+    VRFY((ret == 0), "");
 
-    /* disable collective metadata writes for page buffering to work */
+    /* Repeat with independent metadata writes */
     ret = H5Pset_coll_metadata_write(fapl, FALSE);
     VRFY((ret >= 0), "");
 
     ret = create_file(filename, fcpl, fapl, H5AC_METADATA_WRITE_STRATEGY__DISTRIBUTED);
     VRFY((ret == 0), "");
-    ret = open_file(filename, fapl, H5AC_METADATA_WRITE_STRATEGY__DISTRIBUTED, sizeof(int)*100, sizeof(int)*100000);
+    ret = open_file(filename, fapl, H5AC_METADATA_WRITE_STRATEGY__DISTRIBUTED, sizeof(int)*128, sizeof(int)*102400);
     VRFY((ret == 0), "");
 
     ret = create_file(filename, fcpl, fapl, H5AC_METADATA_WRITE_STRATEGY__PROCESS_0_ONLY);
     VRFY((ret == 0), "");
-    ret = open_file(filename, fapl, H5AC_METADATA_WRITE_STRATEGY__PROCESS_0_ONLY, sizeof(int)*100, sizeof(int)*100000);
+    ret = open_file(filename, fapl, H5AC_METADATA_WRITE_STRATEGY__PROCESS_0_ONLY, sizeof(int)*128, sizeof(int)*102400);
     VRFY((ret == 0), "");
 
-    ret = H5Pset_file_space_page_size(fcpl, sizeof(int)*100);
+    ret = H5Pset_file_space_page_size(fcpl, sizeof(int)*128);
     VRFY((ret == 0), "");
 
     data = (int *) HDmalloc(sizeof(int)*(size_t)num_elements);
@@ -188,7 +188,7 @@ test_page_buffer_access(void)
 
         ret = H5Pset_page_buffer_size(fapl_self, sizeof(int)*1000, 0, 0);
         VRFY((ret == 0), "");
-        /* collective metadata writes do not work with page buffering */
+        /* use independent metadata writes */
         ret = H5Pset_coll_metadata_write(fapl_self, FALSE);
         VRFY((ret >= 0), "");
 
@@ -295,7 +295,7 @@ test_page_buffer_access(void)
     if(mpi_size > 1) {
         ret = H5Pset_page_buffer_size(fapl, sizeof(int)*1000, 0, 0);
         VRFY((ret == 0), "");
-        /* collective metadata writes do not work with page buffering */
+        /* use independent metadata writes */
         ret = H5Pset_coll_metadata_write(fapl, FALSE);
         VRFY((ret >= 0), "");
 
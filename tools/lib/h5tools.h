@@ -81,6 +81,11 @@
 #define NBIT            "COMPRESSION NBIT"
 #define SCALEOFFSET     "COMPRESSION SCALEOFFSET"
 #define SCALEOFFSET_MINBIT            "MIN BITS"
+#define BITSHUFFLE      "PREPROCESSING BITSHUFFLE"
+#define BITSHUFFLE_BLOCK              "BLOCK_SIZE"
+#define BITSHUFFLE_COMP               "COMPRESSION"
+#define ZSTD            "COMPRESSION ZSTD"
+#define ZSTD_LEVEL      "LEVEL"
 #define STORAGE_LAYOUT  "STORAGE_LAYOUT"
 #define CONTIGUOUS      "CONTIGUOUS"
 #define COMPACT         "COMPACT"
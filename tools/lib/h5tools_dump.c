@@ -3314,6 +3314,19 @@ h5tools_dump_dcpl(FILE *stream, const h5tool_format_t *info,
                         h5tools_str_append(&buffer, "%s %s %s %d %s", SCALEOFFSET, BEGIN, SCALEOFFSET_MINBIT, cd_values[0], END);
                         h5tools_render_element(stream, info, ctx, &buffer, &curr_pos, (size_t)ncols, (hsize_t)0, (hsize_t)0);
                         break;
+                    case H5Z_FILTER_BITSHUFFLE:
+                        if(cd_nelmts > H5Z_BITSHUFFLE_PARM_COMP)
+                            h5tools_str_append(&buffer, "%s %s %s %u %s %s %s", BITSHUFFLE, BEGIN,
+                                    BITSHUFFLE_BLOCK, cd_values[H5Z_BITSHUFFLE_PARM_BLOCK], BITSHUFFLE_COMP,
+                                    cd_values[H5Z_BITSHUFFLE_PARM_COMP] == H5Z_BITSHUFFLE_COMP_LZ4 ? "LZ4" : "NONE", END);
+                        else
+                            h5tools_str_append(&buffer, "%s", BITSHUFFLE);
+                        h5tools_render_element(stream, info, ctx, &buffer, &curr_pos, (size_t)ncols, (hsize_t)0, (hsize_t)0);
+                        break;
+                    case H5Z_FILTER_ZSTD:
+                        h5tools_str_append(&buffer, "%s %s %s %d %s", ZSTD, BEGIN, ZSTD_LEVEL, (int)cd_values[H5Z_ZSTD_PARM_LEVEL], END);
+                        h5tools_render_element(stream, info, ctx, &buffer, &curr_pos, (size_t)ncols, (hsize_t)0, (hsize_t)0);
+                        break;
                     default:
                         h5tools_str_append(&buffer, "%s %s", "USER_DEFINED_FILTER", BEGIN);
                         h5tools_render_element(stream, info, ctx, &buffer, &curr_pos, (size_t)ncols, (hsize_t)0, (hsize_t)0);
@@ -124,6 +124,23 @@ h5tools_canreadf(const char* name,     /* object name, serves also as boolean pr
              */
         case H5Z_FILTER_SCALEOFFSET:
             break;
+            /*-------------------------------------------------------------------------
+             * H5Z_FILTER_BITSHUFFLE
+             *-------------------------------------------------------------------------
+             */
+        case H5Z_FILTER_BITSHUFFLE:
+            break;
+            /*-------------------------------------------------------------------------
+             * H5Z_FILTER_ZSTD       8 , zstandard compression
+             *-------------------------------------------------------------------------
+             */
+        case H5Z_FILTER_ZSTD:
+#ifndef H5_HAVE_FILTER_ZSTD
+            if (name)
+                print_filter_warning(name,"zstd");
+            ret_value = 0;
+#endif
+            break;
         }/*switch*/
     }/*for*/
 
@@ -200,6 +217,15 @@ h5tools_can_encode(H5Z_filter_t filtn)
 
     case H5Z_FILTER_SCALEOFFSET:
             break;
+
+    case H5Z_FILTER_BITSHUFFLE:
+            break;
+
+    case H5Z_FILTER_ZSTD:
+#ifndef H5_HAVE_FILTER_ZSTD
+        HGOTO_DONE(0)
+#endif
+            break;
     }/*switch*/
 
 done:
@@ -625,6 +625,8 @@ static int check_options(pack_opt_t *options) {
                     break;
                 case H5Z_FILTER_SZIP:
                 case H5Z_FILTER_DEFLATE:
+                case H5Z_FILTER_BITSHUFFLE:
+                case H5Z_FILTER_ZSTD:
                     printf(" All with %s, parameter %d\n", get_sfilter(filtn), options->filter_g[k].cd_values[0]);
                     break;
                 default:
@@ -644,7 +646,7 @@ static int check_options(pack_opt_t *options) {
         for (j = 0; j < pack.nfilters; j++) {
             if (options->verbose) {
                 if(pack.filter[j].filtn >= 0) {
-                    if(pack.filter[j].filtn > H5Z_FILTER_SCALEOFFSET)
+                    if(pack.filter[j].filtn > H5Z_FILTER_ZSTD)
                         printf(" <%s> with %s filter %d\n", name, get_sfilter(pack.filter[j].filtn), pack.filter[j].filtn);
                     else
                         printf(" <%s> with %s filter\n", name, get_sfilter(pack.filter[j].filtn));
@@ -864,6 +866,10 @@ static const char* get_sfilter(H5Z_filter_t filtn) {
         return "NBIT";
     else if (filtn == H5Z_FILTER_SCALEOFFSET)
         return "SOFF";
+    else if (filtn == H5Z_FILTER_BITSHUFFLE)
+        return "BSHUF";
+    else if (filtn == H5Z_FILTER_ZSTD)
+        return "ZSTD";
     else
         return "UD";
 }
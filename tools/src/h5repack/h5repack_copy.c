@@ -1341,6 +1341,14 @@ print_dataset_info(hid_t dcpl_id, char *objname, double ratio, int pr)
                 HDstrcat(strfilter, "SCALEOFFSET ");
                 break;
 
+            case H5Z_FILTER_BITSHUFFLE:
+                HDstrcat(strfilter, "BSHUF ");
+                break;
+
+            case H5Z_FILTER_ZSTD:
+                HDstrcat(strfilter, "ZSTD ");
+                break;
+
             default:
                 HDstrcat(strfilter, "UD ");
                 break;
@@ -316,6 +316,8 @@ int apply_filters(const char* name, /* object name from traverse list */
      * H5Z_FILTER_SZIP        4 , szip compression
      * H5Z_FILTER_NBIT        5 , nbit compression
      * H5Z_FILTER_SCALEOFFSET 6 , scaleoffset compression
+     * H5Z_FILTER_BITSHUFFLE  7 , bitshuffle, with lz4 compression
+     * H5Z_FILTER_ZSTD        8 , zstandard compression
      *-------------------------------------------------------------------------
      */
 
@@ -449,6 +451,26 @@ int apply_filters(const char* name, /* object name from traverse list */
                         HGOTO_ERROR(FAIL, H5E_tools_min_id_g, "H5Pset_scaleoffset failed");
                 }
                 break;
+            /*----------- -------------------------------------------------------------
+             * H5Z_FILTER_BITSHUFFLE , bitshuffle, with lz4 compression
+             *-------------------------------------------------------------------------
+             */
+            case H5Z_FILTER_BITSHUFFLE:
+                if (H5Pset_chunk(dcpl_id, obj.chunk.rank, obj.chunk.chunk_lengths) < 0)
+                    HGOTO_ERROR(FAIL, H5E_tools_min_id_g, "H5Pset_chunk failed");
+                if (H5Pset_bitshuffle(dcpl_id, obj.filter[i].cd_values[0], obj.filter[i].cd_values[1]) < 0)
+                    HGOTO_ERROR(FAIL, H5E_tools_min_id_g, "H5Pset_bitshuffle failed");
+                break;
+            /*----------- -------------------------------------------------------------
+             * H5Z_FILTER_ZSTD , zstandard compression
+             *-------------------------------------------------------------------------
+             */
+            case H5Z_FILTER_ZSTD:
+                if (H5Pset_chunk(dcpl_id, obj.chunk.rank, obj.chunk.chunk_lengths) < 0)
+                    HGOTO_ERROR(FAIL, H5E_tools_min_id_g, "H5Pset_chunk failed");
+                if (H5Pset_zstd(dcpl_id, (int)obj.filter[i].cd_values[0], NULL) < 0)
+                    HGOTO_ERROR(FAIL, H5E_tools_min_id_g, "H5Pset_zstd failed");
+                break;
             default:
                 {
                     if (H5Pset_chunk(dcpl_id, obj.chunk.rank, obj.chunk.chunk_lengths) < 0)
@@ -165,6 +165,9 @@ static void usage(const char *prog) {
     PRINTVALSTREAM(rawoutstream, "        FLET, to apply the HDF5 checksum filter\n");
     PRINTVALSTREAM(rawoutstream, "        NBIT, to apply the HDF5 NBIT filter (NBIT compression)\n");
     PRINTVALSTREAM(rawoutstream, "        SOFF, to apply the HDF5 Scale/Offset filter\n");
+    PRINTVALSTREAM(rawoutstream, "        BSHUF, to apply the HDF5 bitshuffle filter\n");
+    PRINTVALSTREAM(rawoutstream, "        BSLZ4, to apply the HDF5 bitshuffle filter with LZ4 compression\n");
+    PRINTVALSTREAM(rawoutstream, "        ZSTD, to apply the HDF5 Zstandard filter (zstd compression)\n");
     PRINTVALSTREAM(rawoutstream, "        UD,   to apply a user defined filter\n");
     PRINTVALSTREAM(rawoutstream, "        NONE, to remove all filters\n");
     PRINTVALSTREAM(rawoutstream, "      <filter parameters> is optional filter parameter information\n");
@@ -176,6 +179,9 @@ static void usage(const char *prog) {
     PRINTVALSTREAM(rawoutstream, "        NBIT (no parameter)\n");
     PRINTVALSTREAM(rawoutstream, "        SOFF=<scale_factor,scale_type> scale_factor is an integer and scale_type\n");
     PRINTVALSTREAM(rawoutstream, "            is either IN or DS\n");
+    PRINTVALSTREAM(rawoutstream, "        BSHUF=<block_size> and BSLZ4=<block_size> (optional) the number of\n");
+    PRINTVALSTREAM(rawoutstream, "            elements bitshuffled together, a multiple of 8\n");
+    PRINTVALSTREAM(rawoutstream, "        ZSTD=<compression level> from 1-22\n");
     PRINTVALSTREAM(rawoutstream, "        UD=<filter_number,filter_flag,cd_value_count,value_1[,value_2,...,value_N]>\n");
     PRINTVALSTREAM(rawoutstream, "            required values for filter_number,filter_flag,cd_value_count,value_1\n");
     PRINTVALSTREAM(rawoutstream, "            optional values for value_2 to value_N\n");
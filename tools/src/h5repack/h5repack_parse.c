@@ -29,6 +29,9 @@
  *  FLET, to apply the HDF5 checksum filter
  *  NBIT, to apply the HDF5 NBIT filter (NBIT compression)
  *  SOFF, to apply the HDF5 scale+offset filter (compression)
+ *  BSHUF, to apply the HDF5 bitshuffle filter
+ *  BSLZ4, to apply the HDF5 bitshuffle filter with LZ4 compression
+ *  ZSTD, to apply the HDF5 Zstandard filter (zstd compression)
  *  UD, to apply a User Defined filter k,m,n1[,…,nm]
  *  NONE, to remove the filter
  *
@@ -390,6 +393,33 @@ obj_list_t* parse_filter(const char *str, unsigned *n_objs, filter_info_t *filt,
                 }
             }
             /*-------------------------------------------------------------------------
+            * H5Z_FILTER_BITSHUFFLE
+            * has the format BSHUF[=<block_size>] or BSLZ4[=<block_size>],
+            * a block size of 0 (or none) picking the default
+            *-------------------------------------------------------------------------
+            */
+            else if (HDstrcmp(scomp, "BSHUF") == 0 || HDstrcmp(scomp, "BSLZ4") == 0) {
+                filt->filtn = H5Z_FILTER_BITSHUFFLE;
+                filt->cd_nelmts = 2;
+                if (no_param)
+                    filt->cd_values[0] = 0;
+                filt->cd_values[1] = HDstrcmp(scomp, "BSLZ4") == 0 ? H5Z_BITSHUFFLE_COMP_LZ4 : H5Z_BITSHUFFLE_COMP_NONE;
+            }
+            /*-------------------------------------------------------------------------
+            * H5Z_FILTER_ZSTD
+            *-------------------------------------------------------------------------
+            */
+            else if (HDstrcmp(scomp, "ZSTD") == 0) {
+                filt->filtn = H5Z_FILTER_ZSTD;
+                filt->cd_nelmts = 1;
+                if (no_param) { /*no more parameters, ZSTD must have parameter */
+                    if (obj_list)
+                        HDfree(obj_list);
+                    error_msg("missing compression parameter in <%s>\n", str);
+                    HDexit(EXIT_FAILURE);
+                }
+            }
+            /*-------------------------------------------------------------------------
             * User Defined Filter
             *-------------------------------------------------------------------------
             */
@@ -455,6 +485,30 @@ obj_list_t* parse_filter(const char *str, unsigned *n_objs, filter_info_t *filt,
             HDexit(EXIT_FAILURE);
         }
         break;
+        /*-------------------------------------------------------------------------
+        * H5Z_FILTER_BITSHUFFLE
+        *-------------------------------------------------------------------------
+        */
+    case H5Z_FILTER_BITSHUFFLE:
+        if ((filt->cd_values[0] % 8) != 0) {
+            if (obj_list)
+                HDfree(obj_list);
+            error_msg("bitshuffle block size is not a multiple of 8 in <%s>\n", str);
+            HDexit(EXIT_FAILURE);
+        }
+        break;
+        /*-------------------------------------------------------------------------
+        * H5Z_FILTER_ZSTD
+        *-------------------------------------------------------------------------
+        */
+    case H5Z_FILTER_ZSTD:
+        if (filt->cd_values[0] < 1 || filt->cd_values[0] > H5Z_ZSTD_MAX_LEVEL) {
+            if (obj_list)
+                HDfree(obj_list);
+            error_msg("invalid compression parameter in <%s>\n", str);
+            HDexit(EXIT_FAILURE);
+        }
+        break;
     default:
         break;
     };
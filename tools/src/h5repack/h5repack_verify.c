@@ -576,9 +576,20 @@ int verify_filters(hid_t pid, hid_t tid, int nfilters, filter_info_t *filter)
                         return 0;
                 break;
 
+            case H5Z_FILTER_BITSHUFFLE:
+                /* 3 private client values are returned by DCPL */
+                if (cd_nelmts != H5Z_BITSHUFFLE_TOTAL_NPARMS && filter[i].cd_nelmts != H5Z_BITSHUFFLE_USER_NPARMS)
+                    return 0;
+
+                /* a block size of 0 picks the default, so only the compression is checked */
+                if (cd_values[H5Z_BITSHUFFLE_PARM_COMP] != filter[i].cd_values[1])
+                    return 0;
+                break;
+
             /* for these filters values must match, no local values set in DCPL */
             case H5Z_FILTER_FLETCHER32:
             case H5Z_FILTER_DEFLATE:
+            case H5Z_FILTER_ZSTD:
 
                 if (cd_nelmts != filter[i].cd_nelmts)
                     return 0;
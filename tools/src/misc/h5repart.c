@@ -19,7 +19,9 @@
  *		split a single file into a family of files, join a family of
  *		files into a single file, or copy one family to another while
  *		changing the size of the family members.  It can also be used
- *		to copy a single file to a single file with holes.
+ *		to copy a single file to a single file with holes, or to fuse
+ *		the subfiles of a file written with the subfiling driver into
+ *		a single file.
  */
 
 /* See H5private.h for how to include system headers */
@@ -55,11 +57,15 @@ usage (const char *progname)
 {
     fprintf(stderr, "usage: %s [-v] [-V] [-[b|m] N[g|m|k]] [-family_to_sec2] SRC DST\n",
 	    progname);
+    fprintf(stderr, "       %s [-v] [-V] [-b N[g|m|k]] -subfiling SRC DST\n",
+	    progname);
     fprintf(stderr, "   -v     Produce verbose output\n");
     fprintf(stderr, "   -V     Print a version number and exit\n");
     fprintf(stderr, "   -b N   The I/O block size, defaults to 1kB\n");
     fprintf(stderr, "   -m N   The destination member size or 1GB\n");
     fprintf(stderr, "   -family_to_sec2   Change file driver from family to sec2\n");
+    fprintf(stderr, "   -subfiling        Fuse the subfiles of SRC, a subfiling driver file,\n"
+                    "                     into the single file DST\n");
     fprintf(stderr, "   SRC    The name of the source file\n");
     fprintf(stderr, "   DST	The name of the destination files\n");
     fprintf(stderr, "Sizes may be suffixed with `g' for GB, `m' for MB or "
@@ -133,6 +139,146 @@ get_size (const char *progname, int *argno, int argc, char *argv[])
     return retval;
 }
 
+
+/*-------------------------------------------------------------------------
+ * Function:	fuse_subfiles
+ *
+ * Purpose:	Copies the address space of a file written with the
+ *		subfiling driver, whose configuration file is SRC_NAME, into
+ *		the single file DST_NAME, in blocks of at most BLK_SIZE
+ *		bytes.  Stripes (or the ends of them) missing from the
+ *		subfiles are holes in DST_NAME.  The result can be opened
+ *		with the default driver.
+ *
+ * Return:	Success:	EXIT_SUCCESS
+ *
+ *		Failure:	Exits with EXIT_FAILURE
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+fuse_subfiles(const char *src_name, const char *dst_name, size_t blk_size,
+    int verbose)
+{
+    FILE	*config;		/*configuration file		*/
+    unsigned long long stripe_ull;	/*stripe size from config	*/
+    unsigned	nsubfiles;		/*number of subfiles		*/
+    off_t	stripe_size;		/*stripe size			*/
+    int		*src=NULL;		/*subfile descriptors		*/
+    off_t	*src_size=NULL;		/*subfile sizes			*/
+    char	*sub_name=NULL;		/*subfile name			*/
+    size_t	sub_name_len;		/*size of subfile name buffer	*/
+    char	*buf=NULL;		/*I/O block buffer		*/
+    int		dst;			/*destination file		*/
+    off_t	dst_size=0;		/*logical size of the file	*/
+    off_t	nstripes, s;		/*stripe counters		*/
+    unsigned	u;			/*counter			*/
+    h5_stat_t	sb;			/*temporary file stat buffer	*/
+
+    /* Read the layout from the configuration file */
+    if (NULL == (config = HDfopen(src_name, "r"))) {
+	HDperror(src_name);
+	HDexit(EXIT_FAILURE);
+    }
+    if (2 != fscanf(config, H5FD_SUBFILING_CONFIG_FORMAT, &stripe_ull, &nsubfiles) ||
+            0 == stripe_ull || 0 == nsubfiles || nsubfiles > H5FD_SUBFILING_MAX_SUBFILES) {
+	fprintf(stderr, "%s: not a subfiling configuration file\n", src_name);
+	HDexit(EXIT_FAILURE);
+    }
+    HDfclose(config);
+    stripe_size = (off_t)stripe_ull;
+    if (verbose) fprintf(stderr, "< %s (%u subfiles, %llu byte stripes)\n",
+            src_name, nsubfiles, stripe_ull);
+
+    /* Open the subfiles.  The logical size is the end of the highest
+     * stripe in any of them. */
+    sub_name_len = HDstrlen(src_name) + 32;
+    if (NULL == (sub_name = (char *)HDmalloc(sub_name_len)) ||
+            NULL == (src = (int *)HDmalloc(nsubfiles * sizeof(int))) ||
+            NULL == (src_size = (off_t *)HDmalloc(nsubfiles * sizeof(off_t))) ||
+            NULL == (buf = (char *)HDmalloc(blk_size)))
+	HDexit(EXIT_FAILURE);
+    for (u = 0; u < nsubfiles; u++) {
+	HDsnprintf(sub_name, sub_name_len, H5FD_SUBFILING_NAME_FORMAT, src_name, u);
+	if ((src[u] = HDopen(sub_name, O_RDONLY)) < 0) {
+	    HDperror(sub_name);
+	    HDexit(EXIT_FAILURE);
+	}
+	if (HDfstat(src[u], &sb) < 0) {
+	    perror("fstat");
+	    HDexit(EXIT_FAILURE);
+	}
+	src_size[u] = sb.st_size;
+	if (src_size[u] > 0) {
+	    off_t last = (src_size[u] - 1) / stripe_size;
+
+	    dst_size = MAX(dst_size, (last * (off_t)nsubfiles + (off_t)u) * stripe_size +
+                    (src_size[u] - last * stripe_size));
+	}
+	if (verbose) fprintf(stderr, "< %s\n", sub_name);
+    }
+
+    if ((dst = HDopen(dst_name, O_RDWR|O_CREAT|O_TRUNC, H5_POSIX_CREATE_MODE_RW)) < 0) {
+	HDperror(dst_name);
+	HDexit(EXIT_FAILURE);
+    }
+    if (verbose) fprintf(stderr, "> %s\n", dst_name);
+
+    /* Copy the stripes in address order */
+    nstripes = (dst_size + stripe_size - 1) / stripe_size;
+    for (s = 0; s < nstripes; s++) {
+	unsigned sub = (unsigned)(s % (off_t)nsubfiles);	/*subfile of stripe	*/
+	off_t	src_offset = (s / (off_t)nsubfiles) * stripe_size;
+	off_t	dst_offset = s * stripe_size;
+	off_t	left = MIN(stripe_size, src_size[sub] - src_offset);
+
+	while (left > 0) {
+	    size_t  n = (size_t)MIN((off_t)blk_size, left);
+	    ssize_t nio;
+
+	    if (HDlseek(src[sub], src_offset, SEEK_SET) < 0 ||
+                    HDlseek(dst, dst_offset, SEEK_SET) < 0) {
+		perror("HDlseek");
+		HDexit(EXIT_FAILURE);
+	    }
+	    if ((nio = HDread(src[sub], buf, n)) < 0) {
+		perror("read");
+		HDexit(EXIT_FAILURE);
+	    } else if ((size_t)nio != n) {
+		fprintf(stderr, "subfile %u: short read\n", sub);
+		HDexit(EXIT_FAILURE);
+	    }
+	    if ((nio = HDwrite(dst, buf, n)) < 0) {
+		perror("write");
+		HDexit(EXIT_FAILURE);
+	    } else if ((size_t)nio != n) {
+		fprintf(stderr, "%s: short write\n", dst_name);
+		HDexit(EXIT_FAILURE);
+	    }
+	    src_offset += (off_t)n;
+	    dst_offset += (off_t)n;
+	    left -= (off_t)n;
+	}
+    }
+
+    /* The file can't end with a hole or hdf5 will think it's been
+     * truncated */
+    if (HDftruncate(dst, dst_size) < 0) {
+	perror("ftruncate");
+	HDexit(EXIT_FAILURE);
+    }
+
+    for (u = 0; u < nsubfiles; u++)
+	HDclose(src[u]);
+    HDclose(dst);
+
+    HDfree(src);
+    HDfree(src_size);
+    HDfree(sub_name);
+    HDfree(buf);
+    return EXIT_SUCCESS;
+}
+
 
 /*-------------------------------------------------------------------------
  * Function:	main
@@ -187,6 +333,7 @@ main (int argc, char *argv[])
     hid_t       file;
     hsize_t     hdsize;                 /*destination logical memb size */
     hbool_t     family_to_sec2=FALSE;   /*change family to sec2 driver? */
+    hbool_t     subfiling=FALSE;        /*fuse subfiles?                */
 
     /*
      * Get the program name from argv[0]. Use only the last component.
@@ -208,6 +355,9 @@ main (int argc, char *argv[])
         } else if (!strcmp (argv[argno], "-family_to_sec2")) {
             family_to_sec2 = TRUE;
             argno++;
+        } else if (!strcmp (argv[argno], "-subfiling")) {
+            subfiling = TRUE;
+            argno++;
         } else if ('b'==argv[argno][1]) {
             blk_size = (size_t)get_size (prog_name, &argno, argc, argv);
         } else if ('m'==argv[argno][1]) {
@@ -217,6 +367,13 @@ main (int argc, char *argv[])
         } /* end if */
     } /* end while */
 
+    /* Fusing subfiles doesn't involve families */
+    if (subfiling) {
+        if (argno + 2 != argc || family_to_sec2)
+            usage (prog_name);
+        return fuse_subfiles (argv[argno], argv[argno + 1], blk_size, verbose);
+    }
+
     /* allocate names */
     if(NULL == (src_name = (char *)HDcalloc((size_t)NAMELEN, sizeof(char))))
         exit(EXIT_FAILURE);
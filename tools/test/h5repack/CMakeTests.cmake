@@ -885,6 +885,9 @@
         out-scale_add.h5repack_soffset.h5
         out-scale_copy.h5repack_soffset.h5
         out-scale_remove.h5repack_soffset.h5
+        out-bitshuffle_add.h5repack_soffset.h5
+        out-bitshuffle_lz4_add.h5repack_layout.h5
+        out-zstd_add.h5repack_layout.h5
         out-meta_short_M.meta_short.h5
         out-meta_short_N.meta_short.h5
         out-meta_long_M.meta_long.h5
@@ -978,6 +981,10 @@
     set (USE_FILTER_SZIP 1)
   endif ()
 
+  if (H5_HAVE_FILTER_ZSTD)
+    set (USE_FILTER_ZSTD 1)
+  endif ()
+
 # copy files (these files have no filters)
   ADD_H5_TEST (fill "TEST" ${FILE0})
   ADD_H5_TEST (objs "TEST" ${FILE1})
@@ -1145,6 +1152,22 @@
   set (arg ${FILE13} -f dset_scaleoffset:NONE)
   ADD_H5_TEST (scale_remove "TEST" ${arg})
 
+# bitshuffle add
+  set (arg ${FILE13} -f dset_none:BSHUF=64)
+  ADD_H5_TEST (bitshuffle_add "TEST" ${arg})
+
+# bitshuffle with lz4 add
+  set (arg ${FILE4} -f BSLZ4 -l CHUNK=20x10)
+  ADD_H5_TEST (bitshuffle_lz4_add "TEST" ${arg})
+
+# zstd add
+  set (arg ${FILE4} -f ZSTD=3 -l CHUNK=20x10)
+  set (TESTTYPE "TEST")
+  if (NOT USE_FILTER_ZSTD)
+    set (TESTTYPE "SKIP")
+  endif ()
+  ADD_H5_TEST (zstd_add ${TESTTYPE} ${arg})
+
 # remove all  filters
   set (arg ${FILE11} -f NONE)
   set (TESTTYPE "TEST")
@@ -38,6 +38,10 @@
       family_file00015.h5
       family_file00016.h5
       family_file00017.h5
+      subfiling_file.h5
+      subfiling_file.h5.subfile.0
+      subfiling_file.h5.subfile.1
+      subfiling_file.h5.subfile.2
   )
 
   foreach (h5_file ${HDF5_REFERENCE_TEST_FILES})
@@ -69,6 +73,7 @@
         scd_family00002.h5
         scd_family00003.h5
         family_to_sec2.h5
+        subfiling_to_sec2.h5
   )
   if (NOT "${last_test}" STREQUAL "")
     set_tests_properties (H5REPART-clearall-objects PROPERTIES DEPENDS ${last_test})
@@ -87,9 +92,13 @@
   add_test (NAME H5REPART-h5repart_sec2 COMMAND $<TARGET_FILE:h5repart> -m 20000 -family_to_sec2 family_file%05d.h5 family_to_sec2.h5)
   set_tests_properties (H5REPART-h5repart_sec2 PROPERTIES DEPENDS H5REPART-clearall-objects)
 
+  # fuse subfiling file into a sec2 file
+  add_test (NAME H5REPART-h5repart_subfiling COMMAND $<TARGET_FILE:h5repart> -subfiling subfiling_file.h5 subfiling_to_sec2.h5)
+  set_tests_properties (H5REPART-h5repart_subfiling PROPERTIES DEPENDS H5REPART-clearall-objects)
+
   # test the output files repartitioned above.
   add_test (NAME H5REPART-h5repart_test COMMAND $<TARGET_FILE:h5repart_test>)
-  set_tests_properties (H5REPART-h5repart_test PROPERTIES DEPENDS "H5REPART-clearall-objects;H5REPART-h5repart_20K;H5REPART-h5repart_5K;H5REPART-h5repart_sec2")
+  set_tests_properties (H5REPART-h5repart_test PROPERTIES DEPENDS "H5REPART-clearall-objects;H5REPART-h5repart_20K;H5REPART-h5repart_5K;H5REPART-h5repart_sec2;H5REPART-h5repart_subfiling")
 
   set (H5_DEP_EXECUTABLES ${H5_DEP_EXECUTABLES}
         h5repart_test
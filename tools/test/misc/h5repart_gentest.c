@@ -25,6 +25,10 @@
 #define FAMILY_SIZE     1024
 #define FILENAME        "family_file%05d.h5"
 
+#define SUBFILING_NSUBFILES     3
+#define SUBFILING_STRIPE_SIZE   1024
+#define SUBFILING_FILENAME      "subfiling_file.h5"
+
 static int buf[FAMILY_NUMBER][FAMILY_SIZE];
 
 int main(void)
@@ -73,18 +77,39 @@ int main(void)
     }
 
 
-    if(H5Sclose(space) < 0) {
-        perror ("H5Sclose");
+    if(H5Dclose(dset) < 0) {
+        perror ("H5Dclose");
         exit (EXIT_FAILURE);
     }
 
-    if(H5Dclose(dset) < 0) {
-        perror ("H5Dclose");
+    if(H5Fclose(file) < 0) {
+        perror ("H5Fclose");
         exit (EXIT_FAILURE);
     }
 
-    if(H5Pclose(fapl) < 0) {
-        perror ("H5Pclose");
+    /* Write the same dataset to a file striped over subfiles */
+    if(H5Pset_fapl_subfiling(fapl, SUBFILING_NSUBFILES, (hsize_t)SUBFILING_STRIPE_SIZE, 0) < 0) {
+        perror ("H5Pset_fapl_subfiling");
+        exit (EXIT_FAILURE);
+    }
+
+    if((file = H5Fcreate(SUBFILING_FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0) {
+        perror("H5Fcreate");
+        exit(EXIT_FAILURE);
+    }
+
+    if((dset = H5Dcreate2(file, dname, H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        perror("H5Dcreate2");
+        exit(EXIT_FAILURE);
+    }
+
+    if(H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) {
+        perror("H5Dwrite");
+        exit(EXIT_FAILURE);
+    }
+
+    if(H5Dclose(dset) < 0) {
+        perror ("H5Dclose");
         exit (EXIT_FAILURE);
     }
 
@@ -93,6 +118,16 @@ int main(void)
         exit (EXIT_FAILURE);
     }
 
+    if(H5Sclose(space) < 0) {
+        perror ("H5Sclose");
+        exit (EXIT_FAILURE);
+    }
+
+    if(H5Pclose(fapl) < 0) {
+        perror ("H5Pclose");
+        exit (EXIT_FAILURE);
+    }
+
     puts(" PASSED"); fflush(stdout);
 
     return 0;
@@ -14,7 +14,8 @@
 /*
  * Purpose:	This program tests family files after being repartitioned
  *              by h5repart.  It simply tries to reopen the files with
- *              correct family driver and member size.
+ *              correct family driver and member size, and checks the
+ *              data in a subfiling file fused into a sec2 file.
  */
 #include "hdf5.h"
 #include "H5private.h"
@@ -23,15 +24,22 @@
 #define FAMILY_H5REPART_SIZE1   20000
 #define FAMILY_H5REPART_SIZE2   (5*KB)
 
+/* Dataset written by h5repart_gentest */
+#define DSET_NAME               "dataset"
+#define DSET_DIM1               4
+#define DSET_DIM2               1024
+
 const char *FILENAME[] = {
     "fst_family%05d.h5",
     "scd_family%05d.h5",
     "family_to_sec2.h5",
+    "subfiling_to_sec2.h5",
     NULL
 };
 
 herr_t test_family_h5repart_opens(void);
 herr_t test_sec2_h5repart_opens(void);
+herr_t test_subfiling_h5repart_opens(void);
 
 
 /*-------------------------------------------------------------------------
@@ -121,6 +129,58 @@ error:
 
 } /* end test_sec2_h5repart_opens() */
 
+
+/*-------------------------------------------------------------------------
+ * Function:    test_subfiling_h5repart_opens
+ *
+ * Purpose:     Tries to open a subfiling file fused into a sec2 file,
+ *              and checks that its dataset has the values written.
+ *
+ * Return:      SUCCEED/FAIL
+ *
+ *-------------------------------------------------------------------------
+ */
+herr_t
+test_subfiling_h5repart_opens(void)
+{
+    hid_t       fid = -1;
+    hid_t       dset = -1;
+    static int  buf[DSET_DIM1][DSET_DIM2];
+    int         i, j;
+
+    /* open the sec2 file */
+    if ((fid = H5Fopen(FILENAME[3], H5F_ACC_RDONLY, H5P_DEFAULT)) < 0)
+        goto error;
+
+    if ((dset = H5Dopen2(fid, DSET_NAME, H5P_DEFAULT)) < 0)
+        goto error;
+
+    if (H5Dread(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+        goto error;
+
+    for (i = 0; i < DSET_DIM1; i++)
+        for (j = 0; j < DSET_DIM2; j++)
+            if (buf[i][j] != i * 10000 + j)
+                goto error;
+
+    if (H5Dclose(dset) < 0)
+        goto error;
+
+    if (H5Fclose(fid) < 0)
+        goto error;
+
+    return SUCCEED;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Dclose(dset);
+        H5Fclose(fid);
+    } H5E_END_TRY;
+
+    return FAIL;
+
+} /* end test_subfiling_h5repart_opens() */
+
 
 /*-------------------------------------------------------------------------
  * Function:    main
@@ -138,6 +198,7 @@ main(void)
 
     nerrors += test_family_h5repart_opens() < 0     ? 1 : 0;
     nerrors += test_sec2_h5repart_opens() < 0       ? 1 : 0;
+    nerrors += test_subfiling_h5repart_opens() < 0  ? 1 : 0;
 
     if (nerrors)
         goto error;
@@ -44,6 +44,8 @@ add_test (
         iopipe.txt.err
         overhead.txt
         overhead.txt.err
+        id_perf.txt
+        id_perf.txt.err
         perf_meta.txt
         perf_meta.txt.err
         zip_perf-h.txt
@@ -121,6 +123,22 @@ else ()
 endif ()
 set_tests_properties (PERFORM_overhead PROPERTIES DEPENDS "PERFORM_h5perform-clearall-objects")
 
+if (HDF5_ENABLE_USING_MEMCHECKER)
+  add_test (NAME PERFORM_id_perf COMMAND $<TARGET_FILE:id_perf> -n 4096 -c 65536)
+else ()
+  add_test (NAME PERFORM_id_perf COMMAND "${CMAKE_COMMAND}"
+      -D "TEST_PROGRAM=$<TARGET_FILE:id_perf>"
+      -D "TEST_ARGS:STRING=-n;4096;-c;65536"
+      -D "TEST_EXPECT=0"
+      -D "TEST_SKIP_COMPARE=TRUE"
+      -D "TEST_OUTPUT=id_perf.txt"
+      #-D "TEST_REFERENCE=id_perf.out"
+      -D "TEST_FOLDER=${PROJECT_BINARY_DIR}"
+      -P "${HDF_RESOURCES_EXT_DIR}/runTest.cmake"
+  )
+endif ()
+set_tests_properties (PERFORM_id_perf PROPERTIES DEPENDS "PERFORM_h5perform-clearall-objects")
+
 if (HDF5_ENABLE_USING_MEMCHECKER)
   add_test (NAME PERFORM_perf_meta COMMAND $<TARGET_FILE:perf_meta>)
 else ()
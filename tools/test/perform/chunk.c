@@ -17,7 +17,9 @@
  *
  * Purpose:	Checks the effect of various I/O request sizes and raw data
  *		cache sizes.  Performance depends on the amount of data read
- *		from disk and we use a filter to get that number.
+ *		from disk and we use a filter to get that number.  Also
+ *		checks how reading filtered chunks scales with the number
+ *		of filter threads.
  */
 
 /* See H5private.h for how to include headers */
@@ -30,6 +32,10 @@
 #   include <stdlib.h>
 #   include <string.h>
 #endif
+#ifdef H5_HAVE_SYS_TIME_H
+#   include <sys/time.h>
+#endif
+#include <time.h>
 
 /* Solaris Studio defines attribute, but for the attributes we need */
 #if !defined(H5_HAVE_ATTRIBUTE) || defined __cplusplus || defined(__SUNPRO_C)
@@ -71,6 +77,12 @@
 /* #define DIAG_W0		0.65F */
 /* #define DIAG_NRDCC		521 */
 
+/* Filter thread scaling test */
+#define FILTER_BUSY	306
+#define TS_DSET		"busy"
+#define TS_ROUNDS	64		/*passes over each chunk per filter call*/
+#define TS_MAX_THREADS	8
+
 static size_t	nio_g;
 static hid_t	fapl_g = -1;
 
@@ -79,6 +91,10 @@ static size_t
 counter (unsigned H5_ATTR_UNUSED flags, size_t cd_nelmts,
 	 const unsigned *cd_values, size_t nbytes,
 	 size_t *buf_size, void **buf);
+static size_t
+busy (unsigned H5_ATTR_UNUSED flags, size_t cd_nelmts,
+      const unsigned *cd_values, size_t nbytes,
+      size_t *buf_size, void **buf);
 
 /* This message derives from H5Z */
 const H5Z_class2_t H5Z_COUNTER[1] = {{
@@ -91,6 +107,16 @@ const H5Z_class2_t H5Z_COUNTER[1] = {{
     counter,			/* The actual filter function	*/
 }};
 
+const H5Z_class2_t H5Z_BUSY[1] = {{
+    H5Z_CLASS_T_VERS,		/* H5Z_class_t version		*/
+    FILTER_BUSY,		/* Filter id number		*/
+    1, 1,			/* Encoding and decoding enabled */
+    "busy",			/* Filter name for debugging	*/
+    NULL,                       /* The "can apply" callback     */
+    NULL,                       /* The "set local" callback     */
+    busy,			/* The actual filter function	*/
+}};
+
 
 /*-------------------------------------------------------------------------
  * Function:	counter
@@ -117,6 +143,60 @@ counter (unsigned H5_ATTR_UNUSED flags, size_t H5_ATTR_UNUSED cd_nelmts,
     return nbytes;
 }
 
+
+/*-------------------------------------------------------------------------
+ * Function:	busy
+ *
+ * Purpose:	Stands in for an expensive codec: scrambles the data with
+ *		TS_ROUNDS passes over it.  The passes cancel out when they
+ *		are applied twice, so the same function decodes.  It has
+ *		no global state, so it can run on several filter threads
+ *		at once.
+ *
+ * Return:	Success:	nbytes
+ *
+ *		Failure:	never fails
+ *
+ *-------------------------------------------------------------------------
+ */
+static size_t
+busy (unsigned H5_ATTR_UNUSED flags, size_t H5_ATTR_UNUSED cd_nelmts,
+      const unsigned H5_ATTR_UNUSED *cd_values, size_t nbytes,
+      size_t H5_ATTR_UNUSED *buf_size, void **buf)
+{
+    unsigned char	*p = (unsigned char *)*buf;
+    unsigned		r;
+    size_t		i;
+
+    for (r=0; r<TS_ROUNDS; r++)
+	for (i=0; i<nbytes; i++)
+	    p[i] ^= (unsigned char)(r*31 + i);
+    return nbytes;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:	now
+ *
+ * Purpose:	Wall clock time, for timing the thread scaling test.
+ *
+ * Return:	Seconds since some fixed point in the past.
+ *
+ *-------------------------------------------------------------------------
+ */
+static double
+now (void)
+{
+#ifdef H5_HAVE_GETTIMEOFDAY
+    struct timeval	tv;
+
+    gettimeofday (&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec/1.0e6;
+#else
+    return (double)time (NULL);
+#endif
+}
+
 
 /*-------------------------------------------------------------------------
  * Function:	create_dataset
@@ -138,9 +218,10 @@ counter (unsigned H5_ATTR_UNUSED flags, size_t H5_ATTR_UNUSED cd_nelmts,
 static void
 create_dataset (void)
 {
-    hid_t	file, space, dcpl, dset;
+    hid_t	file, space, dcpl, dset, dset2;
     hsize_t	size[2];
     signed char	*buf;
+    size_t	i;
 
     /* The file */
     file = H5Fcreate (FILE_NAME, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_g);
@@ -165,7 +246,20 @@ create_dataset (void)
     H5Dwrite(dset, H5T_NATIVE_SCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
     free(buf);
 
+    /* A dataset with an expensive filter, for the thread scaling test */
+    H5Zregister(H5Z_BUSY);
+    H5Premove_filter(dcpl, H5Z_FILTER_ALL);
+    H5Pset_filter(dcpl, FILTER_BUSY, 0, 0, NULL);
+    dset2 = H5Dcreate2(file, TS_DSET, H5T_NATIVE_SCHAR, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    assert(dset2>=0);
+    buf = (signed char *)malloc(SQUARE (DS_SIZE*CH_SIZE));
+    for (i=0; i<SQUARE (DS_SIZE*CH_SIZE); i++)
+	buf[i] = (signed char)(i % 127);
+    H5Dwrite(dset2, H5T_NATIVE_SCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    free(buf);
+
     /* Close */
+    H5Dclose(dset2);
     H5Dclose(dset);
     H5Sclose(space);
     H5Pclose(dcpl);
@@ -321,6 +415,49 @@ test_diag (int op, size_t cache_size, size_t io_size, size_t offset)
     return (double)nio/(double)nio_g;
 }
 
+
+/*-------------------------------------------------------------------------
+ * Function:	test_threads
+ *
+ * Purpose:	Reads the whole "busy" dataset in one request, with the
+ *		filters reversed on NTHREADS filter threads.
+ *
+ * Return:	Elapsed seconds, or a negative value if the data read
+ *		back was wrong.
+ *
+ *-------------------------------------------------------------------------
+ */
+static double
+test_threads (unsigned nthreads)
+{
+    hid_t	fapl, file, dset;
+    signed char	*buf = (signed char *)malloc(SQUARE (DS_SIZE*CH_SIZE));
+    size_t	i;
+    double	start, elapsed;
+
+    fapl = H5Pcopy (fapl_g);
+    H5Pset_filter_nthreads (fapl, nthreads);
+    file = H5Fopen(FILE_NAME, H5F_ACC_RDONLY, fapl);
+    dset = H5Dopen2(file, TS_DSET, H5P_DEFAULT);
+
+    start = now ();
+    H5Dread (dset, H5T_NATIVE_SCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    elapsed = now () - start;
+
+    for (i=0; i<SQUARE (DS_SIZE*CH_SIZE); i++)
+	if (buf[i] != (signed char)(i % 127)) {
+	    elapsed = -1.0F;
+	    break;
+	}
+
+    free (buf);
+    H5Dclose (dset);
+    H5Fclose (file);
+    H5Pclose (fapl);
+
+    return elapsed;
+}
+
 
 /*-------------------------------------------------------------------------
  * Function:	main
@@ -346,6 +483,8 @@ main (void)
     FILE	*f, *d;
     size_t	cache_size;
     double	w0;
+    unsigned	nthreads;
+    double	elapsed, serial = 0.0F;
 
     /*
      * Create a global file access property list.
@@ -540,6 +679,41 @@ main (void)
     fprintf (f, "pause -1\n");
 #endif
 
+#if 1
+    /*
+     * Test how reading filtered chunks scales with the number of filter
+     * threads.  (Speedup is relative to decoding on the calling thread.)
+     */
+    printf("\nTest      %8s %8s %8s\n", "Threads", "Seconds",  "Speedup");
+    printf("--------- -------- -------- --------\n");
+    fprintf (f, "set autoscale\n");
+    fprintf (f, "set xlabel \"%s\"\n", "Filter threads");
+    fprintf (f, "set ylabel \"Speedup\"\n");
+    fprintf (f, "set title \"%d chunks, %d passes per chunk\"\n",
+	     SQUARE (DS_SIZE), TS_ROUNDS);
+    fprintf (f, "set terminal postscript\nset output \"x-threads-rd.ps\"\n");
+    fprintf (f, "plot \"x-threads-rd.dat\" title \"Threads-Read\" with %s\n",
+	     LINESPOINTS);
+    fprintf (f, "set terminal x11\nreplot\n");
+    d = fopen ("x-threads-rd.dat", "w");
+    for (nthreads=1; nthreads<=TS_MAX_THREADS; nthreads*=2) {
+	printf ("Thread-rd %8u", nthreads);
+	fflush (stdout);
+	elapsed = test_threads (nthreads);
+	if (elapsed < 0) {
+	    printf (" wrong data read\n");
+	    continue;
+	}
+	if (1==nthreads)
+	    serial = elapsed;
+	printf (" %8.3f %8.2f\n", elapsed,
+		elapsed>0 ? serial/elapsed : 1.0F);
+	fprintf (d, "%u %g\n", nthreads, elapsed>0 ? serial/elapsed : 1.0F);
+    }
+    fclose (d);
+    fprintf (f, "pause -1\n");
+#endif
+
 
     H5Pclose (fapl_g);
     fclose (f);
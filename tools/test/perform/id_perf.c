@@ -0,0 +1,166 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the root of the source code       *
+ * distribution tree, or in https://support.hdfgroup.org/ftp/HDF5/releases.  *
+ * If you do not have access to either file, you may request a copy from     *
+ * help@hdfgroup.org.                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose:  Measures the per-call cost of looking up, registering and
+ *           releasing IDs as the number of open IDs grows.
+ *
+ *           For each population size, that many dataspace IDs are
+ *           opened.  Then an API call which does little more than look its
+ *           ID up is made on IDs picked at random, and IDs are closed and
+ *           reopened.  The time per call is printed for each size; it
+ *           should stay flat as the number of open IDs grows.
+ */
+
+/* See H5private.h for how to include headers */
+#undef NDEBUG
+#include "hdf5.h"
+#include "H5private.h"
+
+#define DEFAULT_MAX_IDS     (1024 * 1024)
+#define DEFAULT_NCALLS      (1024 * 1024)
+
+/* A small, repeatable random number generator, so that the IDs looked up
+ * don't depend on the system's rand() */
+static unsigned long id_perf_seed_g = 1;
+
+static size_t
+id_perf_random(size_t n)
+{
+    id_perf_seed_g = id_perf_seed_g * 6364136223846793005UL + 1442695040888963407UL;
+
+    return (size_t)((id_perf_seed_g >> 17) % n);
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:  usage
+ *
+ * Purpose:   Prints a usage message.
+ *
+ * Return:    void
+ *
+ *-------------------------------------------------------------------------
+ */
+static void
+usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-n MAX_IDS] [-c NCALLS]\n", prog);
+    fprintf(stderr, "  -n MAX_IDS   Largest number of open IDs to measure (default %d)\n", DEFAULT_MAX_IDS);
+    fprintf(stderr, "  -c NCALLS    Number of calls timed for each size (default %d)\n", DEFAULT_NCALLS);
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:  measure
+ *
+ * Purpose:   Opens NIDS dataspace IDs and times NCALLS lookups and
+ *            NCALLS / 4 close/reopen pairs on them.
+ *
+ * Return:    Success:    0
+ *            Failure:    -1
+ *
+ *-------------------------------------------------------------------------
+ */
+static int
+measure(size_t nids, size_t ncalls)
+{
+    hid_t   *ids = NULL;
+    double  start, lookup_time, reg_time;
+    size_t  u;
+    int     ret_value = -1;
+
+    if(NULL == (ids = (hid_t *)calloc(nids, sizeof(hid_t))))
+        goto error;
+    for(u = 0; u < nids; u++)
+        if((ids[u] = H5Screate(H5S_SCALAR)) < 0)
+            goto error;
+
+    /* Look up IDs at random */
+    start = H5_get_time();
+    for(u = 0; u < ncalls; u++)
+        if(H5Sget_simple_extent_type(ids[id_perf_random(nids)]) != H5S_SCALAR)
+            goto error;
+    lookup_time = H5_get_time() - start;
+
+    /* Release IDs at random and register new ones in their place */
+    start = H5_get_time();
+    for(u = 0; u < ncalls / 4; u++) {
+        size_t v = id_perf_random(nids);
+
+        if(H5Sclose(ids[v]) < 0)
+            goto error;
+        if((ids[v] = H5Screate(H5S_SCALAR)) < 0)
+            goto error;
+    }
+    reg_time = H5_get_time() - start;
+
+    printf("%10lu %16.1f %16.1f\n", (unsigned long)nids,
+        (lookup_time * 1.0e9) / (double)ncalls, (reg_time * 1.0e9) / (double)(ncalls / 4));
+
+    ret_value = 0;
+
+error:
+    if(ids) {
+        for(u = 0; u < nids; u++)
+            if(ids[u] > 0)
+                H5Sclose(ids[u]);
+        free(ids);
+    }
+
+    return ret_value;
+}
+
+
+/*-------------------------------------------------------------------------
+ * Function:  main
+ *
+ * Purpose:   Times ID operations for populations of 16 IDs up to the
+ *            maximum, growing by a factor of 8.
+ *
+ * Return:    Success:    0
+ *            Failure:    1
+ *
+ *-------------------------------------------------------------------------
+ */
+int
+main(int argc, char *argv[])
+{
+    size_t  max_ids = DEFAULT_MAX_IDS;
+    size_t  ncalls = DEFAULT_NCALLS;
+    size_t  nids;
+    int     argno;
+
+    for(argno = 1; argno < argc; argno++) {
+        if(!strcmp(argv[argno], "-n") && argno + 1 < argc)
+            max_ids = (size_t)strtoul(argv[++argno], NULL, 0);
+        else if(!strcmp(argv[argno], "-c") && argno + 1 < argc)
+            ncalls = (size_t)strtoul(argv[++argno], NULL, 0);
+        else {
+            usage(argv[0]);
+            return strcmp(argv[argno], "-h") ? 1 : 0;
+        }
+    }
+    if(max_ids < 1 || ncalls < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("%10s %16s %16s\n", "open IDs", "lookup (ns)", "close+open (ns)");
+    for(nids = 16; nids <= max_ids; nids *= 8)
+        if(measure(nids, ncalls) < 0) {
+            fprintf(stderr, "failed with %lu open IDs\n", (unsigned long)nids);
+            return 1;
+        }
+
+    return 0;
+}
@@ -89,7 +89,7 @@ static herr_t dset_read(int localrank, file_descr *fd, parameters *parms, void *
 static herr_t posix_buffer_read(int local_dim, file_descr *fd, parameters *parms, void *buffer);
 static herr_t do_fopen(parameters *param, char *fname, file_descr *fd /*out*/,
     int flags);
-hid_t set_vfd(parameters *param);
+hid_t set_vfd(parameters *param, int flags);
 static herr_t do_fclose(iotype iot, file_descr *fd);
 static void do_cleanupfile(iotype iot, char *fname);
 
@@ -1080,7 +1080,7 @@ do_fopen(parameters *param, char *fname, file_descr *fd /*out*/, int flags)
 
     case HDF5:
 
-        fapl = set_vfd(param);
+        fapl = set_vfd(param, flags);
 
         if (fapl < 0) {
             fprintf(stderr, "HDF5 Property List Create failed\n");
@@ -1129,7 +1129,7 @@ done:
  */
 
 hid_t
-set_vfd(parameters *param)
+set_vfd(parameters *param, int flags)
 {
     hid_t my_fapl = -1;
     vfdtype  vfd;
@@ -1138,8 +1138,9 @@ set_vfd(parameters *param)
 
     if ((my_fapl=H5Pcreate(H5P_FILE_ACCESS))<0) return -1;
 
-    if (vfd == sec2) {
-        /* Unix read() and write() system calls */
+    if (vfd == sec2 || (vfd == mmap_vfd && (flags & (SIO_CREATE | SIO_WRITE)))) {
+        /* Unix read() and write() system calls (the mmap driver can't
+         * write files) */
         if (H5Pset_fapl_sec2(my_fapl)<0) return -1;
     } else if (vfd == stdio) {
         /* Standard C fread() and fwrite() system calls */
@@ -1192,6 +1193,16 @@ set_vfd(parameters *param)
         /* Linux direct read() and write() system calls.  Set memory boundary, file block size,
          * and copy buffer size to the default values. */
         if (H5Pset_fapl_direct(my_fapl, 1024, 4096, 8*4096)<0) return -1;
+#endif
+    } else if (vfd == mmap_vfd) {
+#ifdef H5_HAVE_MMAP
+        /* Read-only memory-mapped file */
+        if (H5Pset_fapl_mmap(my_fapl)<0) return -1;
+#endif
+    } else if (vfd == iouring) {
+#ifdef H5_HAVE_LINUX_IO_URING_H
+        /* Linux io_uring, with the default queue depth */
+        if (H5Pset_fapl_iouring(my_fapl, 0, (size_t)0)<0) return -1;
 #endif
     } else {
         /* Unknown driver */
@@ -920,6 +920,10 @@ report_parameters(struct options *opts)
             HDfprintf(output, "family\n");
         } else if (opts->vfd==direct) {
             HDfprintf(output, "direct\n");
+        } else if (opts->vfd==mmap_vfd) {
+            HDfprintf(output, "mmap (files written with sec2)\n");
+        } else if (opts->vfd==iouring) {
+            HDfprintf(output, "iouring\n");
         }
     }
 
@@ -1170,6 +1174,10 @@ parse_command_line(int argc, char *argv[])
                 cl_opts->vfd=family;
             } else if (!HDstrcasecmp(opt_arg, "direct")) {
                 cl_opts->vfd=direct;
+            } else if (!HDstrcasecmp(opt_arg, "mmap")) {
+                cl_opts->vfd=mmap_vfd;
+            } else if (!HDstrcasecmp(opt_arg, "iouring")) {
+                cl_opts->vfd=iouring;
             } else {
                 fprintf(stderr, "sio_perf: invalid --api option %s\n",
                                 opt_arg);
@@ -1409,7 +1417,10 @@ usage(const char *prog)
         printf("      the total size of the object increases exponentially.\n");
         printf("\n");
         printf("  VFD  - is an HDF5 file driver specifier. Valid values are:\n");
-        printf("          sec2, stdio, core, split, multi, family, direct\n");
+        printf("          sec2, stdio, core, split, multi, family, direct, mmap,\n");
+        printf("          iouring\n");
+        printf("      The mmap driver is read-only, so with it files are written with sec2\n");
+        printf("      and read back with mmap, for comparison with reads by sec2.\n");
         printf("\n");
         printf("  Dimension access order:\n");
         printf("      Data access starts at the cardinal origin of the dataset using the\n");
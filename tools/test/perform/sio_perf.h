@@ -42,7 +42,9 @@ typedef enum vfdtype_ {
     split,
     multi,
     family,
-    direct
+    direct,
+    mmap_vfd,           /* (not "mmap", which is the system call) */
+    iouring
     /*NUM_TYPES*/
 } vfdtype;
 
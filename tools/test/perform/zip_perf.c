@@ -17,6 +17,10 @@
  *   -f : compress with Z_FILTERED
  *   -h : compress with Z_HUFFMAN_ONLY
  *   -1 to -9 : compression level
+ *
+ * Usage:  zip_perf -S N [-s S] [-b S] [-B S]
+ *   Measures the shuffle filter instead, with N-byte elements.  This
+ *   doesn't need zlib.
  */
 
 /* our header files */
@@ -25,8 +29,8 @@
 #include "h5tools_utils.h"
 
 #ifdef H5_HAVE_FILTER_DEFLATE
-
 #include <zlib.h>
+#endif /* H5_HAVE_FILTER_DEFLATE */
 
 #define ONE_KB              1024
 #define ONE_MB              (ONE_KB * ONE_KB)
@@ -52,20 +56,26 @@
 /* internal variables */
 static const char *prog=NULL;
 static const char *option_prefix=NULL;
-static char *filename=NULL;
 static int compress_percent = 0;
+static int random_test = FALSE;
+static int shuffle_size = 0;
+#ifdef H5_HAVE_FILTER_DEFLATE
+static char *filename=NULL;
 static int compress_level = Z_DEFAULT_COMPRESSION;
-static int output, random_test = FALSE;
+static int output;
 static int report_once_flag;
 static double compression_time;
+#endif /* H5_HAVE_FILTER_DEFLATE */
 
 /* internal functions */
 static void error(const char *fmt, ...);
+#ifdef H5_HAVE_FILTER_DEFLATE
 static void compress_buffer(Bytef *dest, uLongf *destLen, const Bytef *source,
                             uLong sourceLen);
+#endif /* H5_HAVE_FILTER_DEFLATE */
 
 /* commandline options : long and short form */
-static const char *s_opts = "hB:b:c:p:rs:0123456789";
+static const char *s_opts = "hB:b:c:p:rs:S:0123456789";
 static struct long_options l_opts[] = {
     { "help", no_arg, 'h' },
     { "compressability", require_arg, 'c' },
@@ -125,6 +135,12 @@ static struct long_options l_opts[] = {
     { "rand", no_arg, 'r' },
     { "ran", no_arg, 'r' },
     { "ra", no_arg, 'r' },
+    { "shuffle", require_arg, 'S' },
+    { "shuffl", require_arg, 'S' },
+    { "shuff", require_arg, 'S' },
+    { "shuf", require_arg, 'S' },
+    { "shu", require_arg, 'S' },
+    { "sh", require_arg, 'S' },
     { NULL, 0, '\0' }
 };
 
@@ -147,6 +163,7 @@ error(const char *fmt, ...)
     HDexit(EXIT_FAILURE);
 }
 
+#ifdef H5_HAVE_FILTER_DEFLATE
 /*
  * Function:    cleanup
  * Purpose:     Cleanup the output file.
@@ -306,6 +323,7 @@ get_unique_name(void)
     }
     HDstrcat(filename, ZIP_PERF_FILE);
 }
+#endif /* H5_HAVE_FILTER_DEFLATE */
 
 /*
  * Function:    usage
@@ -329,8 +347,11 @@ usage(void)
     HDfprintf(stdout, "     -p D, --prefix=D           The directory prefix to place the file\n");
     HDfprintf(stdout, "     -r, --random-test          Use random data to write to the file\n");
     HDfprintf(stdout, "                                [default: no]\n");
+    HDfprintf(stdout, "     -S N, --shuffle=N          Measure the shuffle filter on N-byte elements,\n");
+    HDfprintf(stdout, "                                with chunks of each buffer size, instead\n");
     HDfprintf(stdout, "\n");
     HDfprintf(stdout, "  D  - a directory which exists\n");
+    HDfprintf(stdout, "  N  - an element size, from 1 to 255 bytes\n");
     HDfprintf(stdout, "  P  - a number between 0 and 100\n");
     HDfprintf(stdout, "  S  - is a size specifier, an integer >=0 followed by a size indicator:\n");
     HDfprintf(stdout, "\n");
@@ -391,6 +412,30 @@ parse_size_directive(const char *size)
     return s;
 }
 
+/*
+ * Function:    print_buf_size
+ * Purpose:     Print the buffer size being measured.
+ * Return:      Nothing
+ */
+static void
+print_buf_size(unsigned long buf_size)
+{
+    HDfprintf(stdout, "Buffer size == ");
+
+    if (buf_size >= ONE_KB && (buf_size % ONE_KB) == 0) {
+        if (buf_size >= ONE_MB && (buf_size % ONE_MB) == 0) {
+            HDfprintf(stdout, "%ldMB", buf_size / ONE_MB);
+        } else {
+            HDfprintf(stdout, "%ldKB", buf_size / ONE_KB);
+        }
+    } else {
+        HDfprintf(stdout, "%ld", buf_size);
+    }
+
+    HDfprintf(stdout, "\n");
+}
+
+#ifdef H5_HAVE_FILTER_DEFLATE
 static void
 fill_with_random_data(Bytef *src, uLongf src_len)
 {
@@ -458,19 +503,7 @@ do_write_test(unsigned long file_size, unsigned long min_buf_size,
         if (random_test)
             fill_with_random_data(src, src_len);
 
-        HDfprintf(stdout, "Buffer size == ");
-
-        if (src_len >= ONE_KB && (src_len % ONE_KB) == 0) {
-            if (src_len >= ONE_MB && (src_len % ONE_MB) == 0) {
-                HDfprintf(stdout, "%ldMB", src_len / ONE_MB);
-            } else {
-                HDfprintf(stdout, "%ldKB", src_len / ONE_KB);
-            }
-        } else {
-            HDfprintf(stdout, "%ld", src_len);
-        }
-
-        HDfprintf(stdout, "\n");
+        print_buf_size(src_len);
 
         /* do uncompressed data write */
         HDgettimeofday(&timer_start, NULL);
@@ -541,6 +574,161 @@ do_write_test(unsigned long file_size, unsigned long min_buf_size,
         HDfree(src);
     }
 }
+#endif /* H5_HAVE_FILTER_DEFLATE */
+
+#define SHUFFLE_TRIALS      3
+
+/*
+ * Function:    time_shuffle_io
+ * Purpose:     Write SRC to, and read it back into DST from, a chunked
+ *              dataset of NELMTS elements of shuffle_size bytes in an
+ *              in-memory file, with or without the shuffle filter.  The
+ *              chunk cache is disabled, so every chunk goes through the
+ *              filter pipeline on the way in and out.
+ * Return:      Nothing; the write and read times are returned in
+ *              WRITE_TIME and READ_TIME.
+ */
+static void
+time_shuffle_io(hsize_t nelmts, hsize_t chunk_nelmts, int shuffle,
+                const unsigned char *src, unsigned char *dst,
+                double *write_time, double *read_time)
+{
+    hid_t fapl, file, type, space, dcpl, dapl, dset;
+    double start;
+
+    if ((fapl = H5Pcreate(H5P_FILE_ACCESS)) < 0 ||
+            H5Pset_fapl_core(fapl, (size_t)ONE_MB, FALSE) < 0)
+        error("can't set up the core file driver");
+    if ((file = H5Fcreate("zip_perf_shuffle.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+        error("can't create the in-memory file");
+    if ((type = H5Tcreate(H5T_OPAQUE, (size_t)shuffle_size)) < 0 ||
+            (space = H5Screate_simple(1, &nelmts, NULL)) < 0)
+        error("can't create the dataset's type and dataspace");
+    if ((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0 ||
+            H5Pset_chunk(dcpl, 1, &chunk_nelmts) < 0 ||
+            (shuffle && H5Pset_shuffle(dcpl) < 0))
+        error("can't set up the dataset creation properties");
+    if ((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0 ||
+            H5Pset_chunk_cache(dapl, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, (size_t)0,
+                               H5D_CHUNK_CACHE_W0_DEFAULT) < 0)
+        error("can't set up the dataset access properties");
+    if ((dset = H5Dcreate2(file, "shuffle", type, space, H5P_DEFAULT, dcpl, dapl)) < 0)
+        error("can't create the dataset");
+
+    start = H5_get_time();
+    if (H5Dwrite(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, src) < 0)
+        error("can't write the dataset");
+    *write_time = H5_get_time() - start;
+
+    start = H5_get_time();
+    if (H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, dst) < 0)
+        error("can't read the dataset");
+    *read_time = H5_get_time() - start;
+
+    H5Dclose(dset);
+    H5Pclose(dapl);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+    H5Tclose(type);
+    H5Fclose(file);
+    H5Pclose(fapl);
+}
+
+/*
+ * Function:    print_filter_throughput
+ * Purpose:     Print the throughput of a filter, from the time taken with
+ *              and without it.
+ * Return:      Nothing
+ */
+static void
+print_filter_throughput(const char *what, unsigned long size,
+                        double filtered_time, double plain_time)
+{
+    if (filtered_time > plain_time)
+        HDfprintf(stdout, "\t%s Throughput: %.2fMB/s\n", what,
+                  MB_PER_SEC(size, filtered_time - plain_time));
+    else
+        HDfprintf(stdout, "\t%s Throughput: too fast to measure\n", what);
+}
+
+/*
+ * Function:    do_shuffle_test
+ * Purpose:     Measure the shuffle filter on FILE_SIZE bytes of data, for
+ *              each chunk size from MIN_BUF_SIZE to MAX_BUF_SIZE.  The
+ *              data is written and read with and without the filter, and
+ *              the difference is put down to shuffling and unshuffling.
+ * Return:      Nothing
+ */
+static void
+do_shuffle_test(unsigned long file_size, unsigned long min_buf_size,
+                unsigned long max_buf_size)
+{
+    unsigned char *src, *dst;
+    unsigned long buf_size, u;
+    unsigned long elmt_size = (unsigned long)shuffle_size;
+    hsize_t nelmts = (hsize_t)(file_size / elmt_size);
+
+    if (nelmts == 0)
+        error("file size (%lu) is smaller than an element", file_size);
+    file_size = (unsigned long)nelmts * elmt_size;
+
+    src = (unsigned char *)HDmalloc(file_size);
+    dst = (unsigned char *)HDmalloc(file_size);
+
+    if (!src || !dst)
+        error("out of memory");
+
+    /* Slowly varying multi-byte values, like most data that's shuffled */
+    for (u = 0; u < file_size; u++)
+        src[u] = (unsigned char)((u / elmt_size) >> ((8 * (u % elmt_size)) % 32));
+
+    for (buf_size = min_buf_size; buf_size <= max_buf_size; buf_size <<= 1) {
+        hsize_t chunk_nelmts = (hsize_t)(buf_size / elmt_size);
+        double write_time[2], read_time[2];
+        int shuffle, trial;
+
+        if (chunk_nelmts == 0)
+            chunk_nelmts = 1;
+        if (chunk_nelmts > nelmts)
+            chunk_nelmts = nelmts;
+
+        print_buf_size(buf_size);
+
+        /* Keep the best of a few runs, as the differences can be small */
+        for (shuffle = 0; shuffle < 2; shuffle++)
+            for (trial = 0; trial < SHUFFLE_TRIALS; trial++) {
+                double wtime, rtime;
+
+                HDmemset(dst, 0, file_size);
+                time_shuffle_io(nelmts, chunk_nelmts, shuffle, src, dst, &wtime, &rtime);
+
+                if (HDmemcmp(src, dst, file_size))
+                    error("data read back doesn't match the data written");
+
+                if (trial == 0 || wtime < write_time[shuffle])
+                    write_time[shuffle] = wtime;
+                if (trial == 0 || rtime < read_time[shuffle])
+                    read_time[shuffle] = rtime;
+            }
+
+        HDfprintf(stdout, "\tUnshuffled Write Throughput: %.2fMB/s\n",
+                  MB_PER_SEC(file_size, write_time[0]));
+        HDfprintf(stdout, "\tShuffled Write Throughput: %.2fMB/s\n",
+                  MB_PER_SEC(file_size, write_time[1]));
+        HDfprintf(stdout, "\tUnshuffled Read Throughput: %.2fMB/s\n",
+                  MB_PER_SEC(file_size, read_time[0]));
+        HDfprintf(stdout, "\tShuffled Read Throughput: %.2fMB/s\n",
+                  MB_PER_SEC(file_size, read_time[1]));
+        print_filter_throughput("Shuffle", file_size, write_time[1], write_time[0]);
+        print_filter_throughput("Unshuffle", file_size, read_time[1], read_time[0]);
+
+        if (buf_size == 0)
+            break;
+    }
+
+    HDfree(dst);
+    HDfree(src);
+}
 
 /*
  * Function:    main
@@ -567,7 +755,9 @@ main(int argc, char **argv)
         case '3': case '4': case '5':
         case '6': case '7': case '8':
         case '9':
+#ifdef H5_HAVE_FILTER_DEFLATE
             compress_level = opt - '0';
+#endif /* H5_HAVE_FILTER_DEFLATE */
             break;
         case 'B':
             max_buf_size = parse_size_directive(opt_arg);
@@ -592,6 +782,13 @@ main(int argc, char **argv)
             break;
         case 's':
             file_size = parse_size_directive(opt_arg);
+            break;
+        case 'S':
+            shuffle_size = (int)HDstrtol(opt_arg, NULL, 10);
+
+            if (shuffle_size < 1 || shuffle_size > 255)
+                error("shuffle element size (%d) must be from 1 to 255", shuffle_size);
+
             break;
         case '?':
             usage();
@@ -611,6 +808,13 @@ main(int argc, char **argv)
 
     HDfprintf(stdout, "Filesize: %ld\n", file_size);
 
+    if (shuffle_size) {
+        HDfprintf(stdout, "Shuffle Element Size: %d\n", shuffle_size);
+        do_shuffle_test(file_size, min_buf_size, max_buf_size);
+        return EXIT_SUCCESS;
+    }
+
+#ifdef H5_HAVE_FILTER_DEFLATE
     if (compress_level == Z_DEFAULT_COMPRESSION)
         HDfprintf(stdout, "Compression Level: 6\n");
     else
@@ -619,24 +823,8 @@ main(int argc, char **argv)
     get_unique_name();
     do_write_test(file_size, min_buf_size, max_buf_size);
     cleanup();
-    return EXIT_SUCCESS;
-}
-
 #else
-
-/*
- * Function:    main
- * Purpose:     Dummy main() function for if HDF5 was configured without
- *              zlib stuff.
- * Return:      EXIT_SUCCESS
- * Programmer:  Bill Wendling, 10. June 2002
- * Modifications:
- */
-int
-main(void)
-{
     HDfprintf(stdout, "No compression IO performance because zlib was not configured\n");
+#endif  /* H5_HAVE_FILTER_DEFLATE */
     return EXIT_SUCCESS;
 }
-
-#endif  /* !H5_HAVE_FILTER_DEFLATE */